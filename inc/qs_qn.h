@@ -92,6 +92,21 @@
 #define _QN_MOBILE_						1
 #endif
 
+// simd (정수 SIMD만, 실수는 qs_math.h의 QM_USE_*)
+#if !defined QM_NO_SIMD && !defined __EMSCRIPTEN__
+#if defined __SSE2__ || defined _M_AMD64 || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define _QN_SSE2_						1
+#include <emmintrin.h>
+#elif defined __aarch64__ || defined _M_ARM64 || defined _M_ARM64EC
+#define _QN_NEON_						1
+#if defined _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+#endif
+
 // c standard specific
 #ifndef INLINE
 #if defined _MSC_VER
@@ -151,6 +166,15 @@
 #define FALLTHROUGH
 #endif
 #endif // FALLTHROUGH
+#ifndef THREADLOCAL
+#if defined _MSC_VER
+#define THREADLOCAL						__declspec(thread)
+#elif defined __GNUC__
+#define THREADLOCAL						__thread
+#else
+#define THREADLOCAL						_Thread_local
+#endif
+#endif // THREADLOCAL
 #ifndef PRAGMA
 #define PRAGMA(x)
 #endif // PRAGMA
@@ -416,19 +440,87 @@ QSAPI const char* qn_p_unknown(int value, bool hex);
 ///	@return 디버거가 붙어 있으면 참
 QSAPI cham qn_p_debugger(void);
 
-/// @brief 심볼을 얻는다
-/// @param name 심볼 이름. 최대 63 글자만 쑬 수 있다
+/// @brief 심볼을 얻는다 (아톰 번호)
+/// @param name 심볼 이름
 ///	@return 심볼 값. 이 값이 0이면 오류이다
 QSAPI nint qn_sym(const char* name);
 
 /// @brief 심볼로 문자열을 얻는다
 /// @param value 심볼
-/// @return 심볼에 해당하는 문자열
+/// @return 심볼에 해당하는 문자열 (아톰)
 QSAPI const char* qn_symstr(nint value);
 
 /// @brief 심볼 디버그 출력
 QSAPI void qn_sym_dbgout(void);
 
+/// @brief 아톰. 한번 넣은 문자열은 런타임이 끝날 때까지 남아 있고, 같은 문자열은 같은 포인터라 포인터로 비교한다
+typedef const char*		QnAtom;
+
+/// @brief 아톰 머리, 아톰 문자열 바로 앞에 있다
+typedef struct QNATOMHEAD
+{
+	size_t				hash;
+	uint				len;
+	uint				id;
+} QnAtomHead;
+
+/// @brief 문자열을 아톰으로 만든다. 이미 있는 아톰은 잠그지 않고 찾는다
+/// @param str 문자열
+/// @return 아톰. str이 NULL이면 NULL
+QSAPI QnAtom qn_atom(const char* str);
+
+/// @brief 길이 만큼 문자열을 아톰으로 만든다
+/// @param str 문자열
+/// @param len 문자열 길이
+/// @return 아톰
+QSAPI QnAtom qn_atomn(const char* str, size_t len);
+
+/// @brief 아톰을 찾기만 한다
+/// @param str 문자열
+/// @return 아톰. 없으면 NULL
+QSAPI QnAtom qn_atom_find(const char* str);
+
+/// @brief 번호로 아톰을 얻는다
+/// @param id 아톰 번호 (1부터)
+/// @return 아톰. 없으면 NULL
+QSAPI QnAtom qn_atom_from_id(uint id);
+
+/// @brief 아톰 갯수
+/// @return 아톰 갯수
+QSAPI size_t qn_atom_count(void);
+
+/// @brief 아톰 머리를 얻는다
+/// @param atom 아톰
+/// @return 아톰 머리
+FINLINE const QnAtomHead* qn_atom_head(QnAtom atom)
+{
+	return (const QnAtomHead*)atom - 1;
+}
+
+/// @brief 아톰 해시, 만들 때 계산해 둔 값
+/// @param atom 아톰
+/// @return 해시 값
+FINLINE size_t qn_atom_hash(QnAtom atom)
+{
+	return qn_atom_head(atom)->hash;
+}
+
+/// @brief 아톰 길이
+/// @param atom 아톰
+/// @return 문자열 길이
+FINLINE size_t qn_atom_len(QnAtom atom)
+{
+	return qn_atom_head(atom)->len;
+}
+
+/// @brief 아톰 번호
+/// @param atom 아톰
+/// @return 아톰 번호 (1부터)
+FINLINE uint qn_atom_id(QnAtom atom)
+{
+	return qn_atom_head(atom)->id;
+}
+
 /// @brief 프로퍼티를 설정한다
 /// @param name 프로퍼티 이름
 /// @param value 프로퍼티 값
@@ -495,6 +587,73 @@ QSAPI int qn_outputs(const char* mesg);
 /// @return 출력한 문자열 길이
 QSAPI int qn_outputf(const char* fmt, ...);
 
+/// @brief 출력을 파일로 돌린다
+/// @param[in] filename 파일 이름, 널이면 다시 콘솔로
+/// @return 성공하면 참
+/// @note 쌓인 비동기 출력은 먼저 쓴다. 다른 스레드가 출력하지 않을 때 불러야 한다
+QSAPI bool qn_output_redirect(const char* filename);
+
+/// @brief 로그 수준
+typedef enum QNLOGLEVEL
+{
+	QNLOG_TRACE,											/// @brief 추적
+	QNLOG_DEBUG,											/// @brief 디버그
+	QNLOG_INFO,												/// @brief 정보
+	QNLOG_WARN,												/// @brief 경고
+	QNLOG_ERROR,											/// @brief 오류
+	QNLOG_FATAL,											/// @brief 치명적 오류
+	QNLOG_OFF,												/// @brief 출력 안함
+} QnLogLevel;
+
+#ifndef QN_LOG_MIN_LEVEL
+#ifdef _DEBUG
+#define QN_LOG_MIN_LEVEL				QNLOG_TRACE												/// @brief 이보다 낮은 qn_log_* 매크로는 컴파일하지 않는다
+#else
+#define QN_LOG_MIN_LEVEL				QNLOG_INFO
+#endif
+#endif
+#define qn_log(level,head,...)			QN_STMT_BEGIN{ if ((level) >= QN_LOG_MIN_LEVEL) qn_logf(level, head, __VA_ARGS__); }QN_STMT_END	/// @brief 수준을 정해서 로그 출력
+#define qn_log_trace(head,...)			qn_log(QNLOG_TRACE, head, __VA_ARGS__)					/// @brief 추적 로그
+#define qn_log_debug(head,...)			qn_log(QNLOG_DEBUG, head, __VA_ARGS__)					/// @brief 디버그 로그
+#define qn_log_info(head,...)			qn_log(QNLOG_INFO, head, __VA_ARGS__)					/// @brief 정보 로그
+#define qn_log_warn(head,...)			qn_log(QNLOG_WARN, head, __VA_ARGS__)					/// @brief 경고 로그
+#define qn_log_error(head,...)			qn_log(QNLOG_ERROR, head, __VA_ARGS__)					/// @brief 오류 로그
+
+/// @brief 수준을 붙여서 로그를 출력한다. 출력할 문자열의 끝에 개행문자가 붙는다
+/// @param[in] level 로그 수준, qn_log_set_level()로 정한 수준보다 낮으면 버린다
+/// @param[in] head 머릿글
+/// @param[in] mesg 메시지
+/// @return 출력한 문자열 길이, 버렸으면 0
+QSAPI int qn_logs(QnLogLevel level, const char* head, const char* mesg);
+
+/// @brief 수준을 붙여서 로그를 포맷 출력한다. 출력할 문자열의 끝에 개행문자가 붙는다
+/// @param[in] level 로그 수준, qn_log_set_level()로 정한 수준보다 낮으면 버린다
+/// @param[in] head 머릿글
+/// @param[in] fmt 문자열 포맷
+/// @param ... 인수
+/// @return 출력한 문자열 길이, 버렸으면 0
+QSAPI int qn_logf(QnLogLevel level, const char* head, const char* fmt, ...);
+
+/// @brief 실행 중에 로그 수준을 정한다 (qn_mesg와 qn_outputs 계열은 거르지 않는다)
+/// @param[in] level 이보다 낮은 로그는 버린다
+QSAPI void qn_log_set_level(QnLogLevel level);
+
+/// @brief 실행 중인 로그 수준을 얻는다
+/// @return 로그 수준
+QSAPI QnLogLevel qn_log_get_level(void);
+
+/// @brief 비동기 출력을 켜거나 끈다
+/// @param[in] enable 켜면 출력은 스레드마다 링 버퍼에 쌓고 내보내는 스레드가 모아서 쓴다
+/// @return 성공하면 참. 스레드를 만들 수 없으면 거짓이고 바로 출력한다
+/// @note 켜면 qn_mesg, qn_outputs 계열과 qn_log 계열이 모두 비동기로 나간다.
+/// 한 스레드에서 낸 출력은 순서가 지켜지지만, 스레드끼리는 섞일 수 있다.
+/// 링이 차면 내보낼 때까지 기다린다. qn_asrt와 qn_halt는 쌓인 걸 먼저 내보내고 바로 쓴다.
+/// 끌 때는 다른 스레드가 출력하지 않아야 한다. 런타임이 내려갈 때 알아서 끈다
+QSAPI bool qn_log_async(bool enable);
+
+/// @brief 쌓인 비동기 출력을 다 쓸 때까지 기다린다
+QSAPI void qn_log_flush(void);
+
 
 //////////////////////////////////////////////////////////////////////////
 // memory
@@ -558,6 +717,7 @@ QSAPI void* qn_memzcpr(const void* src, size_t srcsize, size_t* destsize);
 /// @param[in] srcsize 압축된 메모리의 크기
 /// @param[out] destsize 해제된 크기 (널 가능)
 /// @return 해제된 메모리
+/// @note 해제 크기를 몰라서 버퍼를 늘려가며 다시 푼다. 크기를 기록하는 qn_memcpr()/qn_memucp()를 쓰는게 좋다
 QSAPI void* qn_memzucp(const void* src, size_t srcsize, size_t* destsize);
 
 /// @brief 메모리를 해제한다. 해제 후 메모리 크기를 알아야 쓸 수 있다. 해제된 메모리는 qn_free()로 해제해야 한다
@@ -567,6 +727,62 @@ QSAPI void* qn_memzucp(const void* src, size_t srcsize, size_t* destsize);
 /// @return 해제된 메모리
 QSAPI void* qn_memzucp_s(const void* src, size_t srcsize, size_t destsize);
 
+/// @brief 압축 코덱
+typedef enum QNCODEC
+{
+	QNCODEC_STORE = 0,										/// @brief 압축 안함
+	QNCODEC_DEFLATE = 1,									/// @brief 디플레이트, 작지만 느리다
+	QNCODEC_LZ = 2,											/// @brief LZ4 계열, 크지만 아주 빠르다
+	QNCODEC_MAX_VALUE,
+} QnCodec;
+
+/// @brief 코덱으로 압축했을 때 최대 크기
+/// @param[in] codec 압축 코덱
+/// @param[in] srcsize 원본 크기
+/// @return 압축 버퍼로 잡아야 할 크기
+QSAPI size_t qn_memcpr_bound(QnCodec codec, size_t srcsize);
+
+/// @brief 코덱으로 압축한다. 헤더 없이 압축한 데이터만 쓴다
+/// @param[in] codec 압축 코덱
+/// @param[in] level 압축 레벨 (0이면 기본, 디플레이트는 1~8, LZ는 1~9로 높으면 느리고 작다)
+/// @param[out] dest 출력 버퍼, qn_memcpr_bound() 만큼 있어야 한다
+/// @param[in] src 메모리 원본
+/// @param[in] srcsize 원본 크기
+/// @return 압축한 크기, 실패하면 0
+QSAPI size_t qn_memcpr_raw(QnCodec codec, int level, void* dest, const void* src, size_t srcsize);
+
+/// @brief 헤더 없이 압축한 데이터를 해제한다. 해제 크기를 알아야 한다
+/// @param[in] codec 압축 코덱
+/// @param[out] dest 출력 버퍼
+/// @param[in] destsize 해제된 크기
+/// @param[in] src 압축된 메모리
+/// @param[in] srcsize 압축된 메모리의 크기
+/// @return 정확히 destsize 만큼 해제했으면 참
+QSAPI bool qn_memucp_raw(QnCodec codec, void* dest, size_t destsize, const void* src, size_t srcsize);
+
+/// @brief 코덱으로 압축한다. 코덱과 원래 크기를 앞에 기록하므로 qn_memucp()로 한번에 해제할 수 있다
+/// @param[in] codec 압축 코덱
+/// @param[in] level 압축 레벨 (0이면 기본)
+/// @param[in] src 메모리 원본
+/// @param[in] srcsize 원본 크기
+/// @param[out] destsize 압축한 크기 (널 가능)
+/// @return 압축된 메모리, qn_free()로 해제해야 한다
+/// @note 압축해도 작아지지 않으면 QNCODEC_STORE로 기록한다
+QSAPI void* qn_memcpr(QnCodec codec, int level, const void* src, size_t srcsize, size_t* destsize);
+
+/// @brief qn_memcpr()로 압축한 메모리를 해제한다
+/// @param[in] src 압축된 메모리
+/// @param[in] srcsize 압축된 메모리의 크기
+/// @param[out] destsize 해제된 크기 (널 가능)
+/// @return 해제된 메모리, qn_free()로 해제해야 한다
+QSAPI void* qn_memucp(const void* src, size_t srcsize, size_t* destsize);
+
+/// @brief qn_memcpr()로 압축한 메모리의 해제 크기를 얻는다
+/// @param[in] src 압축된 메모리
+/// @param[in] srcsize 압축된 메모리의 크기
+/// @return 해제 크기, 올바른 데이터가 아니면 0
+QSAPI size_t qn_memucp_size(const void* src, size_t srcsize);
+
 /// @brief 메모리 크기를 사람이 읽을 수 있는 포맷으로(human readable)
 /// @param[in] size 메모리 크기
 /// @param[out] out 읽을 수 있는 크기
@@ -590,6 +806,119 @@ QSAPI char* qn_memdmp(const void* ptr, size_t size, char* outbuf, size_t buflen)
 /// @warning qn_runtime() 호출 이전에 사용하지 않으면 이 기능은 사용할 수 없다
 QSAPI bool qn_memtbl(const QnAllocTable* table);
 
+/// @brief 지금 스레드의 메모리 테이블을 바꾼다. qn_memtbl_pop()으로 되돌린다
+/// @param[in] table 테이블
+/// @return 테이블 값 중에 빈게 있거나 더 넣을 수 없으면 거짓
+/// @note 지금 스레드의 qn_alloc, qn_realloc, qn_free만 이 테이블을 쓴다
+QSAPI bool qn_memtbl_push(const QnAllocTable* table);
+
+/// @brief qn_memtbl_push() 또는 qn_arena_push()로 바꾼 메모리 테이블을 되돌린다
+QSAPI void qn_memtbl_pop(void);
+
+/// @brief 아레나 (덩어리 단위로 밀어내며 할당하고 한꺼번에 해제하는 메모리)
+typedef struct QNARENA QnArena;
+
+/// @brief 아레나 위치 표시, qn_arena_rewind()로 이 위치까지 되돌린다
+typedef struct QNARENAMARK
+{
+	void*				chunk;
+	byte*				ptr;
+} QnArenaMark;
+
+/// @brief 아레나를 만든다
+/// @param[in] chunk_size 덩어리 크기 (0이면 64KB)
+/// @return 만들어진 아레나
+QSAPI QnArena* qn_new_arena(size_t chunk_size);
+
+/// @brief 아레나를 제거한다. 아레나에서 할당한 메모리도 모두 해제된다
+/// @param[in] self 아레나
+QSAPI void qn_delete_arena(QnArena* self);
+
+/// @brief 아레나에서 메모리를 할당한다. 16바이트로 정렬된다
+/// @param[in] self 아레나
+/// @param[in] size 할당할 메모리 크기
+/// @param[in] zero 할당한 메모리를 0으로 초기화 한다
+/// @return 할당한 메모리
+QSAPI void* qn_arena_alloc(QnArena* self, size_t size, bool zero);
+
+/// @brief 아레나에서 재할당한다. 마지막에 할당한 메모리면 그 자리에서 늘리거나 줄인다
+/// @param[in] self 아레나
+/// @param[in] ptr 재할당할 메모리 (이 값이 NULL이면 새로 할당)
+/// @param[in] size 재할당할 메모리 크기
+/// @return 할당한 새로운 메모리
+QSAPI void* qn_arena_realloc(QnArena* self, void* ptr, size_t size);
+
+/// @brief 아레나 메모리를 해제한다. 마지막에 할당한 메모리만 실제로 되돌린다
+/// @param[in] self 아레나
+/// @param[in] ptr 해제할 메모리
+QSAPI void qn_arena_free(QnArena* self, void* ptr);
+
+/// @brief 아레나의 지금 위치를 얻는다
+/// @param[in] self 아레나
+/// @return 위치 표시
+QSAPI QnArenaMark qn_arena_mark(const QnArena* self);
+
+/// @brief 아레나를 표시한 위치로 되돌린다. 그 뒤에 할당한 메모리는 모두 해제된다
+/// @param[in] self 아레나
+/// @param[in] mark qn_arena_mark()로 얻은 위치
+QSAPI void qn_arena_rewind(QnArena* self, QnArenaMark mark);
+
+/// @brief 아레나의 모든 메모리를 해제한다. 덩어리는 다음 할당에 다시 쓴다
+/// @param[in] self 아레나
+QSAPI void qn_arena_reset(QnArena* self);
+
+/// @brief 아레나에서 할당한 크기를 얻는다
+/// @param[in] self 아레나
+/// @return 할당한 크기 (정렬 포함)
+QSAPI size_t qn_arena_size(const QnArena* self);
+
+/// @brief 아레나가 메모리를 갖고 있나 본다
+/// @param[in] self 아레나
+/// @param[in] ptr 메모리
+/// @return 아레나에서 할당한 메모리면 참
+QSAPI bool qn_arena_own(const QnArena* self, const void* ptr);
+
+/// @brief 지금 스레드의 qn_alloc, qn_realloc, qn_free를 아레나로 보낸다. qn_memtbl_pop()으로 되돌린다
+/// @param[in] self 아레나
+/// @return 더 넣을 수 없으면 거짓
+/// @note 아레나 메모리가 아닌 것을 qn_free()하면 원래 메모리 테이블로 해제한다
+/// @warning 아레나 메모리는 qn_memtbl_pop() 다음에 qn_free()로 해제하면 안된다
+QSAPI bool qn_arena_push(QnArena* self);
+
+/// @brief 고정 크기 메모리 풀
+typedef struct QNPOOL QnPool;
+
+/// @brief 고정 크기 메모리 풀을 만든다
+/// @param[in] item_size 항목 크기
+/// @param[in] slab_count 슬랩 당 항목 갯수 (0이면 슬랩이 4KB 정도 되게 정한다)
+/// @param[in] thread_safe 여러 스레드에서 쓸 수 있게 잠금을 쓴다
+/// @return 만들어진 메모리 풀
+QSAPI QnPool* qn_new_pool(size_t item_size, size_t slab_count, bool thread_safe);
+
+/// @brief 메모리 풀을 제거한다. 풀에서 할당한 메모리도 모두 해제된다
+/// @param[in] self 메모리 풀
+QSAPI void qn_delete_pool(QnPool* self);
+
+/// @brief 메모리 풀에서 항목 하나를 할당한다
+/// @param[in] self 메모리 풀
+/// @param[in] zero 할당한 메모리를 0으로 초기화 한다
+/// @return 할당한 메모리
+QSAPI void* qn_pool_alloc(QnPool* self, bool zero);
+
+/// @brief 메모리 풀로 항목을 돌려준다
+/// @param[in] self 메모리 풀
+/// @param[in] ptr qn_pool_alloc()으로 할당한 메모리
+QSAPI void qn_pool_free(QnPool* self, void* ptr);
+
+/// @brief 메모리 풀의 모든 항목을 한꺼번에 돌려준다. 슬랩은 남겨서 다시 쓴다
+/// @param[in] self 메모리 풀
+QSAPI void qn_pool_reset(QnPool* self);
+
+/// @brief 메모리 풀에서 할당한 항목 갯수를 얻는다
+/// @param[in] self 메모리 풀
+/// @return 할당한 항목 갯수
+QSAPI size_t qn_pool_count(const QnPool* self);
+
 #ifdef QS_NO_MEMORY_PROFILE
 /// @brief 메모리를 할당한다
 /// @param[in] size 할당할 메모리 크기
@@ -620,6 +949,25 @@ QSAPI size_t qn_mpf_count(void);
 /// @brief 내부 메모리 관리자의 내용을 디버그로 출력한다
 QSAPI void qn_mpf_dbgout(void);
 
+/// @brief 할당 위치(desc, line) 별 메모리 통계
+typedef struct QNMEMSITE
+{
+	const char*			desc;			/// @brief 설명문 (보통 함수 이름)
+	size_t				line;			/// @brief 줄 번호
+	size_t				size;			/// @brief 지금 할당된 크기
+	size_t				count;			/// @brief 지금 할당된 갯수
+	size_t				peak;			/// @brief 가장 많이 할당됐을 때의 크기
+	size_t				total;			/// @brief 지금까지 할당한 횟수
+} QnMemSite;
+
+/// @brief 할당 위치 별 메모리 통계를 얻는다. 할당이 많은 위치부터 정렬된다
+/// @param[out] sites 통계를 받을 배열 (NULL이면 위치 갯수만 얻는다)
+/// @param[in] max_count sites 배열의 갯수
+/// @return sites가 NULL이면 전체 위치 갯수, 아니면 sites에 채운 갯수
+/// @note 전체 위치를 정렬하려면 먼저 NULL로 갯수를 얻은 다음 그만큼의 배열을 넘긴다
+/// @note 스레드 별로 모아 둔 값을 더하므로 peak는 근사값이다
+QSAPI size_t qn_mpf_snapshot(QnMemSite* sites, size_t max_count);
+
 /// @brief 메모리를 할당한다
 /// @param[in] size 할당할 메모리 크기
 /// @param[in] zero 할당한 메모리를 0으로 초기화 한다
@@ -658,6 +1006,82 @@ QSAPI void qn_mem_free_ptr(void* pptr);
 //////////////////////////////////////////////////////////////////////////
 // hash & sort
 
+/// @brief 아래쪽부터 0인 비트 갯수를 센다
+/// @param[in] value 0이 아닌 값
+/// @return 0인 비트 갯수
+FINLINE uint qn_ctz32(uint value)
+{
+#if defined _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, value);
+	return (uint)index;
+#else
+	return (uint)__builtin_ctz(value);
+#endif
+}
+
+/// @brief 아래쪽부터 0인 비트 갯수를 센다
+/// @param[in] value 0이 아닌 값
+/// @return 0인 비트 갯수
+FINLINE uint qn_ctz64(ullong value)
+{
+#if defined _MSC_VER && defined _QN_64_
+	unsigned long index;
+	_BitScanForward64(&index, value);
+	return (uint)index;
+#elif defined _MSC_VER
+	const uint low = (uint)value;
+	return low != 0 ? qn_ctz32(low) : 32 + qn_ctz32((uint)(value >> 32));
+#else
+	return (uint)__builtin_ctzll(value);
+#endif
+}
+
+/// @brief 위쪽부터 0인 비트 갯수를 센다
+/// @param[in] value 0이 아닌 값
+/// @return 0인 비트 갯수
+FINLINE uint qn_clz64(ullong value)
+{
+#if defined _MSC_VER && defined _QN_64_
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return 63 - (uint)index;
+#elif defined _MSC_VER
+	unsigned long index;
+	const uint high = (uint)(value >> 32);
+	if (high != 0)
+	{
+		_BitScanReverse(&index, high);
+		return 31 - (uint)index;
+	}
+	_BitScanReverse(&index, (uint)value);
+	return 63 - (uint)index;
+#else
+	return (uint)__builtin_clzll(value);
+#endif
+}
+
+/// @brief 해시 값을 골고루 섞는다 (비트가 한쪽에 몰린 정수 키 해시용)
+/// @param[in] hash 해시 값
+/// @return 섞인 해시 값
+FINLINE size_t qn_hash_mix(size_t hash)
+{
+#ifdef _QN_64_
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 33;
+#else
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6BU;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35U;
+	hash ^= hash >> 16;
+#endif
+	return hash;
+}
+
 /// @brief 포인터 해시. 일반적인 size_t 해시를 의미함
 /// @param[in] ptr 입력 변수
 /// @return	해시 값
@@ -680,6 +1104,83 @@ QSAPI size_t qn_hash_func(int prime8, func_t func, const void* data);
 /// @return 해시 값
 QSAPI size_t qn_hash_crc(const byte* data, size_t size);
 
+/// @brief 64비트 해시 (wyhash 계열, 8바이트씩 처리)
+/// @param[in] data 데이터
+/// @param[in] size 데이터 크기
+/// @param[in] seed 시드
+/// @return 해시 값
+QSAPI ullong qn_hash64(const void* data, size_t size, ullong seed);
+
+/// @brief 64비트 해시 (ASCII 대소문자 구별 안함)
+/// @param[in] data 데이터
+/// @param[in] size 데이터 크기
+/// @param[in] seed 시드
+/// @return 해시 값
+/// @note qn_hash64()에 소문자로 바꾼 데이터를 넣은 것과 같다
+QSAPI ullong qn_hash64_fold(const void* data, size_t size, ullong seed);
+
+/// @brief 64비트 해시를 size_t로 줄인다
+FINLINE size_t qn_hash64_size(ullong hash)
+{
+#ifdef _QN_64_
+	return (size_t)hash;
+#else
+	return (size_t)(hash ^ (hash >> 32));
+#endif
+}
+
+/// @brief CRC 종류
+typedef enum QNCRCTYPE
+{
+	QNCRC_32,												/// @brief CRC32 (IEEE 802.3, zlib과 같음)
+	QNCRC_32C,												/// @brief CRC32C (카스타뇰리, SSE4.2 명령과 같음)
+	QNCRC_64,												/// @brief CRC64 (존스, qn_hash_crc와 같음)
+} QnCrcType;
+
+/// @brief 나눠서 계산하는 CRC
+typedef struct QNCRC
+{
+	ullong			value;
+	QnCrcType		type;
+} QnCrc;
+
+/// @brief CRC32를 계산한다. 앞 결과를 crc로 넣으면 이어서 계산한다
+/// @param[in] crc 처음이면 0, 이어서 계산하면 앞서 계산한 값
+/// @param[in] data 데이터
+/// @param[in] size 데이터 크기
+/// @return CRC 값
+QSAPI uint qn_crc32(uint crc, const void* data, size_t size);
+
+/// @brief CRC32C를 계산한다. 앞 결과를 crc로 넣으면 이어서 계산한다
+/// @param[in] crc 처음이면 0, 이어서 계산하면 앞서 계산한 값
+/// @param[in] data 데이터
+/// @param[in] size 데이터 크기
+/// @return CRC 값
+QSAPI uint qn_crc32c(uint crc, const void* data, size_t size);
+
+/// @brief CRC64를 계산한다. 앞 결과를 crc로 넣으면 이어서 계산한다
+/// @param[in] crc 처음이면 0, 이어서 계산하면 앞서 계산한 값
+/// @param[in] data 데이터
+/// @param[in] size 데이터 크기
+/// @return CRC 값
+QSAPI ullong qn_crc64(ullong crc, const void* data, size_t size);
+
+/// @brief 나눠서 계산할 CRC를 준비한다
+/// @param[out] crc CRC 상태
+/// @param[in] type CRC 종류
+QSAPI void qn_crc_init(QnCrc* crc, QnCrcType type);
+
+/// @brief CRC에 데이터를 더한다
+/// @param[in,out] crc CRC 상태
+/// @param[in] data 데이터
+/// @param[in] size 데이터 크기
+QSAPI void qn_crc_update(QnCrc* crc, const void* data, size_t size);
+
+/// @brief 지금까지 더한 데이터의 CRC를 얻는다
+/// @param[in] crc CRC 상태
+/// @return CRC 값 (32비트 CRC는 아래 32비트만 쓴다)
+QSAPI ullong qn_crc_final(const QnCrc* crc);
+
 /// @brief 가까운 소수 얻기. 처리할 수 있는 최소 소수는 QN_MAX_HASH(11), 최대 소수는 QN_MAX_HASH(13845163)
 /// @param[in] value 입력 값
 /// @return 소수 값
@@ -708,6 +1209,289 @@ QSAPI void qn_qsort(void* ptr, size_t count, size_t stride, cmpfunc_t compfunc);
 /// @param[in] context 콜백 함수용 콘텍스트
 QSAPI void qn_qsortc(void* ptr, size_t count, size_t stride, cmpcfunc_t compfunc, void* context);
 
+/// @brief 32비트 정수 기수 정렬 (안정 정렬)
+/// @param[in,out] ptr 정렬할 데이터
+/// @param[in] count 데이터의 갯수
+QSAPI void qn_radix_sort32(uint* ptr, size_t count);
+
+/// @brief 64비트 정수 기수 정렬 (안정 정렬)
+/// @param[in,out] ptr 정렬할 데이터
+/// @param[in] count 데이터의 갯수
+QSAPI void qn_radix_sort64(ullong* ptr, size_t count);
+
+/// @brief 포인터를 주소 순서로 기수 정렬
+/// @param[in,out] ptr 정렬할 포인터 배열
+/// @param[in] count 데이터의 갯수
+QSAPI void qn_radix_sort_ptr(void** ptr, size_t count);
+
+#define QN_SORT_INSERTION				24								/// @brief 이보다 짧으면 삽입 정렬
+#define QN_SORT_NINTHER					128								/// @brief 이보다 길면 9개 중간값으로 피벗
+#define QN_SORT_RUN						32								/// @brief 안정 정렬의 처음 삽입 정렬 길이
+
+/// @brief 기본 비교, LESS(l, r)은 *l < *r 이면 참
+#define qn_sort_less(l,r)				(*(l) < *(r))
+
+/// @brief 타입 정렬 인라인 (패턴 회피 퀵정렬, 안정 병합 정렬)
+///	@param PFX 함수 접두사
+///	@param TYPE 항목 타입
+///	@param LESS 비교, LESS(const TYPE* l, const TYPE* r)은 l이 r보다 앞이면 참
+#define QN_DECLIMPL_SORT(PFX, TYPE, LESS)															\
+	FINLINE void PFX##_swap(TYPE* l, TYPE* r)														\
+	{																								\
+		TYPE t = *l; *l = *r; *r = t;																\
+	}																								\
+	FINLINE void PFX##_sort2(TYPE* a, TYPE* b)														\
+	{																								\
+		if (LESS(b, a)) PFX##_swap(a, b);															\
+	}																								\
+	FINLINE void PFX##_sort3(TYPE* a, TYPE* b, TYPE* c)												\
+	{																								\
+		PFX##_sort2(a, b);																			\
+		PFX##_sort2(b, c);																			\
+		PFX##_sort2(a, b);																			\
+	}																								\
+	/* @brief 삽입 정렬 */																				\
+	INLINE void PFX##_sort_insertion(TYPE* begin, TYPE* end)										\
+	{																								\
+		if (begin == end) return;																	\
+		for (TYPE* cur = begin + 1; cur < end; cur++) {												\
+			if (!LESS(cur, cur - 1)) continue;														\
+			TYPE t = *cur;																			\
+			TYPE* sift = cur;																		\
+			do { *sift = *(sift - 1); sift--; } while (sift != begin && LESS(&t, sift - 1));		\
+			*sift = t;																				\
+		}																							\
+	}																								\
+	/* @brief 보초 없는 삽입 정렬, begin 바로 앞에 모든 값보다 작거나 같은 값이 있어야 한다 */									\
+	INLINE void PFX##_sort_insertion_unguarded(TYPE* begin, TYPE* end)								\
+	{																								\
+		for (TYPE* cur = begin + 1; cur < end; cur++) {												\
+			if (!LESS(cur, cur - 1)) continue;														\
+			TYPE t = *cur;																			\
+			TYPE* sift = cur;																		\
+			do { *sift = *(sift - 1); sift--; } while (LESS(&t, sift - 1));							\
+			*sift = t;																				\
+		}																							\
+	}																								\
+	/* @brief 거의 정렬된 구간만 삽입 정렬, 많이 옮겨야 하면 그만두고 거짓 */												\
+	INLINE bool PFX##_sort_insertion_partial(TYPE* begin, TYPE* end)								\
+	{																								\
+		if (begin == end) return true;																\
+		size_t moved = 0;																			\
+		for (TYPE* cur = begin + 1; cur < end; cur++) {												\
+			if (!LESS(cur, cur - 1)) continue;														\
+			TYPE t = *cur;																			\
+			TYPE* sift = cur;																		\
+			do { *sift = *(sift - 1); sift--; } while (sift != begin && LESS(&t, sift - 1));		\
+			*sift = t;																				\
+			moved += (size_t)(cur - sift);															\
+			if (moved > 8) return false;															\
+		}																							\
+		return true;																				\
+	}																								\
+	/* @brief 힙 정렬, 피벗이 계속 나쁠 때 쓴다 */																\
+	INLINE void PFX##_sort_heap(TYPE* begin, TYPE* end)												\
+	{																								\
+		size_t count = (size_t)(end - begin);														\
+		for (size_t start = count / 2; count > 1;) {												\
+			size_t root;																			\
+			if (start > 0) root = --start;															\
+			else { count--; PFX##_swap(begin, begin + count); root = 0; }							\
+			for (size_t child; (child = root * 2 + 1) < count; root = child) {						\
+				if (child + 1 < count && LESS(begin + child, begin + child + 1)) child++;			\
+				if (!LESS(begin + root, begin + child)) break;										\
+				PFX##_swap(begin + root, begin + child);											\
+			}																						\
+		}																							\
+	}																								\
+	/* @brief 피벗(*begin)보다 작은 값은 왼쪽, 같거나 큰 값은 오른쪽. 피벗 위치 반환 */										\
+	INLINE TYPE* PFX##_sort_partition_right(TYPE* begin, TYPE* end, bool* already)					\
+	{																								\
+		TYPE pivot = *begin;																		\
+		TYPE* first = begin;																		\
+		TYPE* last = end;																			\
+		while (LESS(++first, &pivot)) {}															\
+		if (first - 1 == begin) while (first < last && !LESS(--last, &pivot)) {}					\
+		else while (!LESS(--last, &pivot)) {}														\
+		*already = first >= last;																	\
+		while (first < last) {																		\
+			PFX##_swap(first, last);																\
+			while (LESS(++first, &pivot)) {}														\
+			while (!LESS(--last, &pivot)) {}														\
+		}																							\
+		TYPE* pos = first - 1;																		\
+		*begin = *pos;																				\
+		*pos = pivot;																				\
+		return pos;																					\
+	}																								\
+	/* @brief 피벗(*begin)과 같은 값은 왼쪽, 큰 값은 오른쪽. 같은 값이 많을 때 */											\
+	INLINE TYPE* PFX##_sort_partition_left(TYPE* begin, TYPE* end)									\
+	{																								\
+		TYPE pivot = *begin;																		\
+		TYPE* first = begin;																		\
+		TYPE* last = end;																			\
+		while (LESS(&pivot, --last)) {}																\
+		if (last + 1 == end) while (first < last && !LESS(&pivot, ++first)) {}						\
+		else while (!LESS(&pivot, ++first)) {}														\
+		while (first < last) {																		\
+			PFX##_swap(first, last);																\
+			while (LESS(&pivot, --last)) {}															\
+			while (!LESS(&pivot, ++first)) {}														\
+		}																							\
+		*begin = *last;																				\
+		*last = pivot;																				\
+		return last;																				\
+	}																								\
+	/* @brief 패턴 회피 퀵정렬 본체, 작은 쪽만 재귀 */																\
+	INLINE void PFX##_sort_pdq(TYPE* begin, TYPE* end, int bad, bool leftmost)						\
+	{																								\
+		for (;;) {																					\
+			const size_t size = (size_t)(end - begin);												\
+			if (size < QN_SORT_INSERTION) {															\
+				if (leftmost) PFX##_sort_insertion(begin, end);										\
+				else PFX##_sort_insertion_unguarded(begin, end);									\
+				return;																				\
+			}																						\
+			const size_t half = size / 2;															\
+			if (size > QN_SORT_NINTHER) {															\
+				PFX##_sort3(begin, begin + half, end - 1);											\
+				PFX##_sort3(begin + 1, begin + (half - 1), end - 2);								\
+				PFX##_sort3(begin + 2, begin + (half + 1), end - 3);								\
+				PFX##_sort3(begin + (half - 1), begin + half, begin + (half + 1));					\
+				PFX##_swap(begin, begin + half);													\
+			} else																					\
+				PFX##_sort3(begin + half, begin, end - 1);											\
+			if (!leftmost && !LESS(begin - 1, begin)) {												\
+				begin = PFX##_sort_partition_left(begin, end) + 1;									\
+				continue;																			\
+			}																						\
+			bool already;																			\
+			TYPE* pivot = PFX##_sort_partition_right(begin, end, &already);							\
+			const size_t lsize = (size_t)(pivot - begin), rsize = (size_t)(end - (pivot + 1));		\
+			if (lsize < size / 8 || rsize < size / 8) {												\
+				if (--bad == 0) {																	\
+					PFX##_sort_heap(begin, end);													\
+					return;																			\
+				}																					\
+				if (lsize >= QN_SORT_INSERTION) {													\
+					PFX##_swap(begin, begin + lsize / 4);											\
+					PFX##_swap(pivot - 1, pivot - lsize / 4);										\
+					if (lsize > QN_SORT_NINTHER) {													\
+						PFX##_swap(begin + 1, begin + (lsize / 4 + 1));								\
+						PFX##_swap(begin + 2, begin + (lsize / 4 + 2));								\
+						PFX##_swap(pivot - 2, pivot - (lsize / 4 + 1));								\
+						PFX##_swap(pivot - 3, pivot - (lsize / 4 + 2));								\
+					}																				\
+				}																					\
+				if (rsize >= QN_SORT_INSERTION) {													\
+					PFX##_swap(pivot + 1, pivot + (1 + rsize / 4));									\
+					PFX##_swap(end - 1, end - rsize / 4);											\
+					if (rsize > QN_SORT_NINTHER) {													\
+						PFX##_swap(pivot + 2, pivot + (2 + rsize / 4));								\
+						PFX##_swap(pivot + 3, pivot + (3 + rsize / 4));								\
+						PFX##_swap(end - 2, end - (1 + rsize / 4));									\
+						PFX##_swap(end - 3, end - (2 + rsize / 4));									\
+					}																				\
+				}																					\
+			} else if (already &&																	\
+				PFX##_sort_insertion_partial(begin, pivot) && PFX##_sort_insertion_partial(pivot + 1, end))	\
+				return;																				\
+			if (lsize < rsize) {																	\
+				PFX##_sort_pdq(begin, pivot, bad, leftmost);										\
+				begin = pivot + 1;																	\
+				leftmost = false;																	\
+			} else {																				\
+				PFX##_sort_pdq(pivot + 1, end, bad, false);											\
+				end = pivot;																		\
+			}																						\
+		}																							\
+	}																								\
+	/* @brief 정렬 (불안정, 추가 메모리 없음) */																\
+	INLINE void PFX##_sort(TYPE* ptr, size_t count)													\
+	{																								\
+		if (count < 2) return;																		\
+		int bad = 0;																				\
+		for (size_t n = count; n; n >>= 1) bad++;													\
+		PFX##_sort_pdq(ptr, ptr + count, bad, true);												\
+	}																								\
+	/* @brief 안정 정렬 (병합 정렬, 항목 갯수 만큼 메모리를 할당한다) */													\
+	INLINE void PFX##_sort_stable(TYPE* ptr, size_t count)											\
+	{																								\
+		size_t lo, mid, hi, width;																	\
+		for (lo = 0; lo < count; lo += QN_SORT_RUN)													\
+			PFX##_sort_insertion(ptr + lo, ptr + QN_MIN(lo + QN_SORT_RUN, count));					\
+		if (count <= QN_SORT_RUN) return;															\
+		TYPE* buf = qn_alloc(count, TYPE);															\
+		TYPE* src = ptr;																			\
+		TYPE* dst = buf;																			\
+		for (width = QN_SORT_RUN; width < count; width *= 2) {										\
+			for (lo = 0; lo < count; lo += width * 2) {												\
+				mid = QN_MIN(lo + width, count);													\
+				hi = QN_MIN(lo + width * 2, count);													\
+				if (mid == hi || !LESS(src + mid, src + mid - 1)) {									\
+					memcpy(dst + lo, src + lo, (hi - lo) * sizeof(TYPE));							\
+					continue;																		\
+				}																					\
+				size_t l = lo, r = mid, o = lo;														\
+				while (l < mid && r < hi)															\
+					dst[o++] = LESS(src + r, src + l) ? src[r++] : src[l++];						\
+				while (l < mid) dst[o++] = src[l++];												\
+				while (r < hi) dst[o++] = src[r++];													\
+			}																						\
+			TYPE* t = src; src = dst; dst = t;														\
+		}																							\
+		if (src != ptr)																				\
+			memcpy(ptr, src, count * sizeof(TYPE));													\
+		qn_free(buf);																				\
+	}
+
+/// @brief 정수 키 기수 정렬 인라인 (LSD, 8비트씩, 안정 정렬)
+///	@param PFX 함수 접두사
+///	@param TYPE 항목 타입
+///	@param KEYTYPE 키 타입, 부호 없는 정수 (부호 있는 키는 부호 비트를 뒤집어서 넣는다)
+///	@param KEY 키 얻기, KEY(const TYPE* p)는 KEYTYPE을 반환
+#define QN_DECLIMPL_RADIX_SORT(PFX, TYPE, KEYTYPE, KEY)												\
+	/* @brief 기수 정렬 (항목 갯수 만큼 메모리를 할당한다) */															\
+	INLINE void PFX##_radix_sort(TYPE* ptr, size_t count)											\
+	{																								\
+		size_t i, b;																				\
+		if (count <= QN_SORT_INSERTION) {															\
+			for (i = 1; i < count; i++) {															\
+				TYPE t = ptr[i];																	\
+				const KEYTYPE k = KEY(&t);															\
+				for (b = i; b > 0 && k < KEY(&ptr[b - 1]); b--)										\
+					ptr[b] = ptr[b - 1];															\
+				ptr[b] = t;																			\
+			}																						\
+			return;																					\
+		}																							\
+		size_t hist[sizeof(KEYTYPE)][256];															\
+		memset(hist, 0, sizeof(hist));																\
+		for (i = 0; i < count; i++) {																\
+			const KEYTYPE k = KEY(&ptr[i]);															\
+			for (b = 0; b < sizeof(KEYTYPE); b++)													\
+				hist[b][(k >> (b * 8)) & 0xFF]++;													\
+		}																							\
+		TYPE* buf = qn_alloc(count, TYPE);															\
+		TYPE* src = ptr;																			\
+		TYPE* dst = buf;																			\
+		for (b = 0; b < sizeof(KEYTYPE); b++) {														\
+			size_t* h = hist[b];																	\
+			if (h[(KEY(&src[0]) >> (b * 8)) & 0xFF] == count) continue;								\
+			for (size_t n = 0, s = 0; n < 256; n++) {												\
+				const size_t c = h[n];																\
+				h[n] = s;																			\
+				s += c;																				\
+			}																						\
+			for (i = 0; i < count; i++)																\
+				dst[h[(KEY(&src[i]) >> (b * 8)) & 0xFF]++] = src[i];								\
+			TYPE* t = src; src = dst; dst = t;														\
+		}																							\
+		if (src != ptr)																				\
+			memcpy(ptr, src, count * sizeof(TYPE));													\
+		qn_free(buf);																				\
+	}
+
 
 //////////////////////////////////////////////////////////////////////////
 // random
@@ -928,16 +1712,34 @@ QSAPI size_t qn_strfll(char* dest, size_t pos, size_t end, int ch);
 /// @return 해시 값
 QSAPI size_t qn_strhash(const char* p);
 
+/// @brief 문자열 해시 (길이 지정)
+/// @param[in] p 해시할 문자열
+/// @param[in] len 문자열 길이
+/// @return 해시 값
+QSAPI size_t qn_strnhash(const char* p, size_t len);
+
 /// @brief 문자열 해시 (대소문자 구별 안함)
 /// @param[in] p 해시할 문자열
 /// @return 해시 값
 QSAPI size_t qn_strihash(const char* p);
 
-/// @brief 문자열 해시 (대소문자 구별 안함)
+/// @brief 문자열 해시 (대소문자 구별 안함, 길이 지정)
+/// @param[in] p 해시할 문자열
+/// @param[in] len 문자열 길이
+/// @return 해시 값
+QSAPI size_t qn_strnihash(const char* p, size_t len);
+
+/// @brief 32비트 문자열 해시 (대소문자 구별 안함)
 /// @param[in] p 해시할 문자열
 /// @return 해시 값
 QSAPI uint qn_strshash(const char* p);
 
+/// @brief 32비트 문자열 해시 (대소문자 구별 안함, 길이 지정)
+/// @param[in] p 해시할 문자열
+/// @param[in] len 문자열 길이
+/// @return 해시 값
+QSAPI uint qn_strnshash(const char* p, size_t len);
+
 /// @brief 문자열 해시 (문자열 포인터용)
 /// @param[in] p 해시할 문자열
 /// @return 해시 값
@@ -979,7 +1781,7 @@ QSAPI int qn_strnicmp(const char* p1, const char* p2, size_t len);
 /// @param[in] src 대상 문자열
 /// @param[in] find 찾을 문자열
 /// @param[in] index 찾기 시작할 대상 문자열의 위치
-/// @return 찾으면 찾은 위치를 반환
+/// @return 찾으면 대상 문자열에서 찾은 위치를 반환
 /// @retval -1 찾지 못했을 때
 QSAPI int qn_strfnd(const char* src, const char* find, size_t index);
 
@@ -1016,18 +1818,48 @@ QSAPI bool qn_strieqv(const char* p1, const char* p2);
 /// @retval NULL 못 찾았다
 QSAPI const char* qn_strbrk(const char* p, const char* c);
 
+/// @brief 길이 안에서 문자열에 든 문자를 찾는다 (널을 보지 않는다)
+/// @param[in] p 대상 문자열
+/// @param[in] len 대상 문자열 길이
+/// @param[in] c 찾을 문자 모음
+/// @return 찾을 경우 대상 문자열의 위치 포인터
+/// @retval NULL 못 찾았다
+QSAPI const char* qn_strnbrk(const char* p, size_t len, const char* c);
+
 /// @brief 문자열에서 문자의 위치를 찾는다
 /// @param[in] p 대상 문자열
 /// @param[in] ch 찾을 문자
 /// @return 찾은 위치 포인터 (못 찾으면 NULL)
 QSAPI char* qn_strchr(const char* p, int ch);
 
+/// @brief 길이 안에서 문자의 위치를 찾는다 (널을 보지 않는다)
+/// @param[in] p 대상 문자열
+/// @param[in] len 대상 문자열 길이
+/// @param[in] ch 찾을 문자
+/// @return 찾은 위치 포인터 (못 찾으면 NULL)
+QSAPI char* qn_strnchr(const char* p, size_t len, int ch);
+
 /// @brief 문자열에서 뒤에서부터 문자의 위치를 찾는다
 /// @param[in] p 대상 문자열
 /// @param[in] ch 찾을 문자
 /// @return 찾은 위치 포인터 (못 찾으면 NULL)
 QSAPI char* qn_strrchr(const char* p, int ch);
 
+/// @brief 길이 안에서 뒤에서부터 문자의 위치를 찾는다 (널을 보지 않는다)
+/// @param[in] p 대상 문자열
+/// @param[in] len 대상 문자열 길이
+/// @param[in] ch 찾을 문자
+/// @return 찾은 위치 포인터 (못 찾으면 NULL)
+QSAPI char* qn_strnrchr(const char* p, size_t len, int ch);
+
+/// @brief 길이 안에서 문자열을 찾는다 (널을 보지 않는다)
+/// @param[in] p 대상 문자열
+/// @param[in] len 대상 문자열 길이
+/// @param[in] find 찾을 문자열
+/// @param[in] findlen 찾을 문자열 길이
+/// @return 찾은 위치 포인터 (못 찾으면 NULL, 찾을 길이가 0이면 p)
+QSAPI const char* qn_strnstr(const char* p, size_t len, const char* find, size_t findlen);
+
 /// @brief 문자열 토큰
 /// @param[in,out] p 대상 문자열
 /// @param[in] sep 구분자
@@ -1065,22 +1897,47 @@ QSAPI char* qn_strrtm(char* dest);
 /// @return 대상 문자열 그대로
 QSAPI char* qn_strtrm(char* dest);
 
+/// @brief 길이 안에서 왼쪽/오른쪽 공백을 없앤다 (널을 넣지 않는다)
+/// @param[in,out] dest 대상 문자열
+/// @param[in] len 대상 문자열 길이
+/// @return 남은 길이
+QSAPI size_t qn_strntrm(char* dest, size_t len);
+
 /// @brief 대상 문자열에서 지정한 문자들을 지운다
 /// @param[in,out] p 대상 문자열
 /// @param[in] rmlist 지울 문자 배열
 /// @return 대상 문자열 그대로
 QSAPI char* qn_strrem(char* p, const char* rmlist);
 
+/// @brief 길이 안에서 지정한 문자들을 지운다 (널을 넣지 않는다)
+/// @param[in,out] p 대상 문자열
+/// @param[in] len 대상 문자열 길이
+/// @param[in] rmlist 지울 문자 배열
+/// @return 남은 길이
+QSAPI size_t qn_strnrem(char* p, size_t len, const char* rmlist);
+
 /// @brief 문자열을 대문자로
 /// @param p 대문자로 바꿀 문자열
 /// @return 대상 포인터
 QSAPI char* qn_strupr(char* p);
 
+/// @brief 길이 만큼 문자열을 대문자로
+/// @param p 대문자로 바꿀 문자열
+/// @param len 바꿀 길이
+/// @return 대상 포인터
+QSAPI char* qn_strnupr(char* p, size_t len);
+
 /// @brief 문자열을 소문자로
 /// @param p 소문자로 바꿀 문자열
 /// @return 대상 포인터
 QSAPI char* qn_strlwr(char* p);
 
+/// @brief 길이 만큼 문자열을 소문자로
+/// @param p 소문자로 바꿀 문자열
+/// @param len 바꿀 길이
+/// @return 대상 포인터
+QSAPI char* qn_strnlwr(char* p, size_t len);
+
 /// @brief 문자열을 32비트 정수로
 /// @param p 문자열
 /// @param base 진수
@@ -1095,12 +1952,12 @@ QSAPI llong qn_strtoll(const char* p, uint base);
 
 /// @brief 문자열을 32비트 실수로
 /// @param p 문자열
-/// @return 바꾼 실수값
+/// @return 바꾼 실수값 (가장 가까운 값으로 반올림, inf와 nan도 읽는다)
 QSAPI float qn_strtof(const char* p);
 
 /// @brief 문자열을 64비트 실수로
 /// @param p 문자열
-/// @return 바꾼 실수값
+/// @return 바꾼 실수값 (가장 가까운 값으로 반올림, inf와 nan도 읽는다)
 QSAPI double qn_strtod(const char* p);
 
 /// @brief 32비트 정수를 문자열로 변환
@@ -1119,6 +1976,19 @@ QSAPI int qn_itoa(char* p, int n, uint base, bool upper);
 /// @return 문자열 버퍼가 0이면 필요한 버퍼 크기, 그렇지 않으면 문자열 길이
 QSAPI int qn_lltoa(char* p, llong n, uint base, bool upper);
 
+/// @brief 32비트 실수를 다시 읽으면 같은 값이 되는 가장 짧은 문자열로 변환
+/// @param p 문자열 버퍼 (32바이트 이상, 널이면 길이만 센다)
+/// @param value 32비트 실수
+/// @return 문자열 길이
+QSAPI int qn_ftoa(char* p, float value);
+
+/// @brief 64비트 실수를 다시 읽으면 같은 값이 되는 가장 짧은 문자열로 변환
+/// @param p 문자열 버퍼 (32바이트 이상, 널이면 길이만 센다)
+/// @param value 64비트 실수
+/// @return 문자열 길이
+/// @note 21자리 정수까지와 0.00000x 까지는 그냥 쓰고, 나머지는 1.5e+300 처럼 지수로 쓴다
+QSAPI int qn_dtoa(char* p, double value);
+
 /// @brief 경로를 디렉토리와 파일 이름으로 나눈다
 /// @param p 경로
 /// @param dir 디렉터리 이름이 들어갈 버퍼 (널 가능)
@@ -1184,6 +2054,27 @@ QSAPI int qn_u32ucb(uchar4 c, char* out);
 /// @return utf8문자를 구성하는 문자열의 길이.
 QSAPI int qn_u16ucb(uchar2 high, uchar2 low, char* out);
 
+/// @brief UTF-8 문자열이 올바른지 검사 (RFC 3629, 오버롱/서로게이트/U+10FFFF 넘는 글자는 틀림)
+/// @param[in] src utf8 문자열
+/// @param[in] srclen 문자열 길이 (바이트). 0이면 널까지
+/// @param[out] error_offset 처음 틀린 글자가 시작하는 위치 (바이트), 모두 맞으면 길이 (널 가능)
+/// @return 모두 올바르면 참
+QSAPI bool qn_u8valid(const char* src, size_t srclen, size_t* error_offset);
+
+/// @brief UTF-16 문자열이 올바른지 검사 (짝이 없는 서로게이트는 틀림)
+/// @param[in] src utf16 문자열
+/// @param[in] srclen 문자열 길이. 0이면 널까지
+/// @param[out] error_offset 처음 틀린 곳 위치, 모두 맞으면 길이 (널 가능)
+/// @return 모두 올바르면 참
+QSAPI bool qn_u16valid(const uchar2* src, size_t srclen, size_t* error_offset);
+
+/// @brief UCS-4 문자열이 올바른지 검사 (서로게이트나 U+10FFFF 넘는 글자는 틀림)
+/// @param[in] src ucs4 문자열
+/// @param[in] srclen 문자열 길이. 0이면 널까지
+/// @param[out] error_offset 처음 틀린 곳 위치, 모두 맞으면 길이 (널 가능)
+/// @return 모두 올바르면 참
+QSAPI bool qn_u32valid(const uchar4* src, size_t srclen, size_t* error_offset);
+
 /// @brief 멀티바이트 문자열을 와이드 문자열로 변환
 /// @param[out] outwcs 출력할 와이드 문자열 버퍼 (NULL 가능)
 /// @param[in] outsize 와이드 문자열 버퍼 크기
@@ -1208,16 +2099,16 @@ QSAPI size_t qn_wcstombs(char* outmbs, size_t outsize, const wchar* inwcs, size_
 /// @param[out]	dest (널값이 아니면) 대상 버퍼 (ucs4)
 /// @param[in] destsize 대상 버퍼 크기
 /// @param[in] src 원본 (utf8)
-/// @param[in] srclen 원본 길이. 0으로 지정할 수 있음
-/// @return	변환한 길이 또는 변환에 필요한 길이
+/// @param[in] srclen 원본 길이 (바이트). 0이면 널까지
+/// @return	변환한 길이 또는 변환에 필요한 길이, 원본이 올바르지 않으면 0
 QSAPI size_t qn_u8to32(uchar4* dest, size_t destsize, const char* src, size_t srclen);
 
 /// @brief utf8 -> utf16 대상 버퍼가 널값이면 변환에 필요한 길이를 반환
 /// @param[out]	dest (널값이 아니면) 대상 버퍼 (utf16)
 /// @param[in] destsize 대상 버퍼 크기
 /// @param[in] src 원본 (utf8)
-/// @param[in] srclen 원본 길이. 0으로 지정할 수 있음
-/// @return	변환한 길이 또는 변환에 필요한 길이
+/// @param[in] srclen 원본 길이 (바이트). 0이면 널까지
+/// @return	변환한 길이 또는 변환에 필요한 길이, 원본이 올바르지 않으면 0
 QSAPI size_t qn_u8to16(uchar2* dest, size_t destsize, const char* src, size_t srclen);
 
 /// @brief ucs4 -> utf8 대상 버퍼가 널값이면 변환에 필요한 길이를 반환
@@ -1225,7 +2116,7 @@ QSAPI size_t qn_u8to16(uchar2* dest, size_t destsize, const char* src, size_t sr
 /// @param[in] destsize 대상 버퍼 크기
 /// @param[in] src 원본 (ucs4)
 /// @param[in] srclen 원본 길이. 0으로 지정할 수 있음
-/// @return	변환한 길이 또는 변환에 필요한 길이
+/// @return	변환한 길이 또는 변환에 필요한 길이, 원본이 올바르지 않으면 0
 QSAPI size_t qn_u32to8(char* dest, size_t destsize, const uchar4* src, size_t srclen);
 
 /// @brief utf16 -> utf8 대상 버퍼가 널값이면 변환에 필요한 길이를 반환
@@ -1233,7 +2124,7 @@ QSAPI size_t qn_u32to8(char* dest, size_t destsize, const uchar4* src, size_t sr
 /// @param[in] destsize 대상 버퍼 크기
 /// @param[in] src 원본 (utf16)
 /// @param[in] srclen 원본 길이. 0으로 지정할 수 있음
-/// @return	변환한 길이 또는 변환에 필요한 길이
+/// @return	변환한 길이 또는 변환에 필요한 길이, 원본이 올바르지 않으면 0
 QSAPI size_t qn_u16to8(char* dest, size_t destsize, const uchar2* src, size_t srclen);
 
 /// @brief utf16 -> ucs4 대상 버퍼가 널값이면 변환에 필요한 길이를 반환
@@ -1241,7 +2132,7 @@ QSAPI size_t qn_u16to8(char* dest, size_t destsize, const uchar2* src, size_t sr
 /// @param[in] destsize 대상 버퍼 크기
 /// @param[in] src 원본 (utf16)
 /// @param[in] srclen 원본 길이. 0으로 지정할 수 있음
-/// @return	변환한 길이 또는 변환에 필요한 길이
+/// @return	변환한 길이 또는 변환에 필요한 길이, 원본이 올바르지 않으면 0
 QSAPI size_t qn_u16to32(uchar4* dest, size_t destsize, const uchar2* src, size_t srclen);
 
 /// @brief ucs4 -> utf16 대상 버퍼가 널값이면 변환에 필요한 길이를 반환
@@ -1249,7 +2140,7 @@ QSAPI size_t qn_u16to32(uchar4* dest, size_t destsize, const uchar2* src, size_t
 /// @param[in] destsize 대상 버퍼 크기
 /// @param[in] src 원본 (ucs4)
 /// @param[in] srclen 원본 길이. 0으로 지정할 수 있음
-/// @return	변환한 길이 또는 변환에 필요한 길이
+/// @return	변환한 길이 또는 변환에 필요한 길이, 원본이 올바르지 않으면 0
 QSAPI size_t qn_u32to16(uchar2* dest, size_t destsize, const uchar4* src, size_t srclen);
 
 #ifdef QS_NO_MEMORY_PROFILE
@@ -1435,8 +2326,12 @@ QSAPI uchar4 qn_hangul_josa(uchar4 code, int josa_type);
 
 /// @brief integer type hash
 #define qn_int_type_phash(ptr)		((size_t)*(ptr))
-/// @brief integer type compare
-#define qn_int_type_pcmp(l,r)		(*(l) == *(r))
+/// @brief integer type compare (같으면 0)
+#define qn_int_type_pcmp(l,r)		(*(l) != *(r))
+/// @brief atom hash
+#define qn_atom_phash(ptr)		qn_atom_hash(*(ptr))
+/// @brief atom compare (같으면 0)
+#define qn_atom_pcmp(l,r)		(*(l) != *(r))
 
 
 /// @brief 파랑 문자열 인라인
@@ -1592,15 +2487,15 @@ QSAPI uchar4 qn_hangul_josa(uchar4 code, int josa_type);
 	}																								\
 	FINLINE size_t PFX##_hash(const NAME* bstr)														\
 	{																								\
-		return qn_strhash(bstr->DATA);																\
+		return qn_strnhash(bstr->DATA, bstr->LENGTH);												\
 	}																								\
 	FINLINE size_t PFX##_ihash(const NAME* bstr)													\
 	{																								\
-		return qn_strihash(bstr->DATA);																\
+		return qn_strnihash(bstr->DATA, bstr->LENGTH);												\
 	}																								\
 	FINLINE uint PFX##_shash(const NAME* bstr)														\
 	{																								\
-		return qn_strshash(bstr->DATA);																\
+		return qn_strnshash(bstr->DATA, bstr->LENGTH);												\
 	}																								\
 	FINLINE int PFX##_cmp(const NAME* left, const char* right)										\
 	{																								\
@@ -1636,11 +2531,11 @@ QSAPI uchar4 qn_hangul_josa(uchar4 code, int josa_type);
 	}																								\
 	FINLINE void PFX##_lower(NAME* bstr)															\
 	{																								\
-		qn_strlwr(bstr->DATA);																		\
+		qn_strnlwr(bstr->DATA, bstr->LENGTH);														\
 	}																								\
 	FINLINE void PFX##_upper(NAME* bstr)															\
 	{																								\
-		qn_strupr(bstr->DATA);																		\
+		qn_strnupr(bstr->DATA, bstr->LENGTH);														\
 	}																								\
 	FINLINE void PFX##_ltrim(NAME* bstr)															\
 	{																								\
@@ -1654,8 +2549,8 @@ QSAPI uchar4 qn_hangul_josa(uchar4 code, int josa_type);
 	}																								\
 	FINLINE void PFX##_trim(NAME* bstr)																\
 	{																								\
-		qn_strtrm(bstr->DATA);																		\
-		bstr->LENGTH = strlen(bstr->DATA);															\
+		bstr->LENGTH = qn_strntrm(bstr->DATA, bstr->LENGTH);										\
+		bstr->DATA[bstr->LENGTH] = '\0';															\
 	}																								\
 	FINLINE void PFX##_fmt_va(NAME* bstr, const char* fmt, va_list args)							\
 	{																								\
@@ -1682,12 +2577,14 @@ QSAPI uchar4 qn_hangul_josa(uchar4 code, int josa_type);
 	}																								\
 	FINLINE int PFX##_has_chars(const NAME* bstr, const char* chs)									\
 	{																								\
-		const char* p = qn_strbrk(bstr->DATA, chs);													\
+		const char* p = qn_strnbrk(bstr->DATA, bstr->LENGTH, chs);									\
 		return p != NULL ? (int)(p - bstr->DATA) : -1;												\
 	}																								\
 	FINLINE int PFX##_find_char(const NAME* bstr, size_t nth, char ch)								\
 	{																								\
-		const char* p = qn_strchr(bstr->DATA + nth, ch);											\
+		if (nth >= bstr->LENGTH)																	\
+			return -1;																				\
+		const char* p = qn_strnchr(bstr->DATA + nth, bstr->LENGTH - nth, ch);						\
 		return p != NULL ? (int)(p - bstr->DATA) : -1;												\
 	}																								\
 	typedef NAME NAME##Type
@@ -1766,6 +2663,11 @@ QSAPI uchar4 qn_hangul_josa(uchar4 code, int josa_type);
 	{																								\
 		qn_qsortc(self->DATA, self->COUNT, sizeof(TYPE), func, context);							\
 	}																								\
+	/* @brief 컨테이너 병렬 정렬하기 */																\
+	FINLINE void PFX##_sort_parallel(NAME* self, cmpfunc_t func)									\
+	{																								\
+		qn_parallel_sort(self->DATA, self->COUNT, sizeof(TYPE), func);								\
+	}																								\
 	/* @brief 컨테이너 항목 지우기 */																	\
 	FINLINE void PFX##_remove_nth(NAME* self, size_t nth)											\
 	{																								\
@@ -2095,6 +2997,18 @@ QN_DECL_CTN(QnPtrCtn, pointer_t);
 QN_DECL_ARRAY(QnPtrArray, pointer_t);
 
 
+// 컨테이너 노드를 일반 메모리에서 (리스트, 노드 리스트, 해시, 묶음이 같이 쓴다)
+#define QN_HASH_HEAP_INIT(hash,type)
+#define QN_HASH_HEAP_DISPOSE(hash)
+#define QN_HASH_HEAP_ALLOC(hash,type)	qn_alloc_1(type)
+#define QN_HASH_HEAP_FREE(hash,node)	qn_free(node)
+// 컨테이너 노드를 메모리 풀에서, 컨테이너에 POOL이 있어야 한다
+#define QN_HASH_POOL_INIT(hash,type)	(hash)->POOL = qn_new_pool(sizeof(type), 0, false)
+#define QN_HASH_POOL_DISPOSE(hash)		qn_delete_pool((hash)->POOL)
+#define QN_HASH_POOL_ALLOC(hash,type)	(type*)qn_pool_alloc((hash)->POOL, false)
+#define QN_HASH_POOL_FREE(hash,node)	qn_pool_free((hash)->POOL, node)
+
+
 /// @brief 리스트 인라인
 /// @param NAME 리스트 이름
 /// @param TYPE 데이터 타입
@@ -2113,6 +3027,11 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 /// @param TYPE 데이터 타입
 /// @param PFX 함수 접두사
 #define QN_IMPL_LIST(NAME, TYPE, PFX)																\
+	QN_IMPL_LIST_NODE(NAME, TYPE, QN_HASH_HEAP, PFX)
+
+/// @brief 리스트 함수 (노드 할당 지정)
+///	@param NODE 노드 할당 방식 (QN_HASH_HEAP 또는 QN_HASH_POOL)
+#define QN_IMPL_LIST_NODE(NAME, TYPE, NODE, PFX)													\
 	FINLINE size_t PFX##_count(const NAME *list)													\
 	{																								\
 		return list->COUNT;																			\
@@ -2145,26 +3064,34 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 	{																								\
 		list->HEAD = list->TAIL = NULL;																\
 		list->COUNT = 0;																			\
+		NODE##_INIT(list, NAME##Node);																\
 	}																								\
-	FINLINE void PFX##_dispose(NAME *list)															\
+	FINLINE void inl_##PFX##_free_nodes(NAME *list)													\
 	{																								\
 		for (NAME##Node *node = list->HEAD, *next; node; node = next) {								\
 			next = node->NEXT;																		\
-			qn_free(node);																			\
+			NODE##_FREE(list, node);																\
 		}																							\
 	}																								\
+	FINLINE void PFX##_dispose(NAME *list)															\
+	{																								\
+		inl_##PFX##_free_nodes(list);																\
+		NODE##_DISPOSE(list);																		\
+	}																								\
 	FINLINE void PFX##_dispose_callback(NAME *list, paramfunc2_t func, void* context)				\
 	{																								\
 		for (NAME##Node *node = list->HEAD, *next; node; node = next) {								\
 			next = node->NEXT;																		\
 			func(context, &node->DATA);																\
-			qn_free(node);																			\
+			NODE##_FREE(list, node);																\
 		}																							\
+		NODE##_DISPOSE(list);																		\
 	}																								\
 	FINLINE void PFX##_clear(NAME *list)															\
 	{																								\
-		PFX##_dispose(list);																		\
-		PFX##_init(list);																			\
+		inl_##PFX##_free_nodes(list);																\
+		list->HEAD = list->TAIL = NULL;																\
+		list->COUNT = 0;																			\
 	}																								\
 	FINLINE void PFX##_remove_node(NAME *list, NAME##Node *node)									\
 	{																								\
@@ -2178,7 +3105,7 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 			node->NEXT->PREV = node->PREV;															\
 		else																						\
 			list->TAIL = node->PREV;																\
-		qn_free(node);																				\
+		NODE##_FREE(list, node);																	\
 		list->COUNT--;																				\
 	}																								\
 	FINLINE void PFX##_remove_head(NAME *list)														\
@@ -2191,7 +3118,7 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 	}																								\
 	FINLINE void PFX##_append(NAME *list, TYPE data)												\
 	{																								\
-		NAME##Node *node = qn_alloc_1(NAME##Node);													\
+		NAME##Node *node = NODE##_ALLOC(list, NAME##Node);											\
 		node->DATA = data;																			\
 		node->NEXT = NULL;																			\
 		node->PREV = list->TAIL;																	\
@@ -2204,7 +3131,7 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 	}																								\
 	FINLINE void PFX##_prepend(NAME *list, TYPE data)												\
 	{																								\
-		NAME##Node *node = qn_alloc_1(NAME##Node);													\
+		NAME##Node *node = NODE##_ALLOC(list, NAME##Node);											\
 		node->DATA = data;																			\
 		node->NEXT = list->HEAD;																	\
 		node->PREV = NULL;																			\
@@ -2267,6 +3194,29 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 	QN_DECL_LIST(NAME, TYPE);																		\
 	QN_IMPL_LIST(NAME, TYPE, PFX)
 
+/// @brief 노드를 메모리 풀에서 할당하는 리스트 인라인. 리스트마다 풀을 하나씩 갖는다
+/// @param NAME 리스트 이름
+/// @param TYPE 데이터 타입
+#define QN_DECL_LIST_POOLED(NAME, TYPE)															\
+	typedef struct NAME##Node {																		\
+		struct NAME##Node *NEXT, *PREV;																\
+		TYPE DATA;																					\
+	} NAME##Node;																					\
+	typedef struct NAME {																			\
+		NAME##Node *HEAD, *TAIL;																	\
+		size_t COUNT;																				\
+		QnPool* POOL;																				\
+	} NAME
+
+/// @brief 노드를 메모리 풀에서 할당하는 리스트 함수
+#define QN_IMPL_LIST_POOLED(NAME, TYPE, PFX)														\
+	QN_IMPL_LIST_NODE(NAME, TYPE, QN_HASH_POOL, PFX)
+
+/// @brief 노드를 메모리 풀에서 할당하는 리스트 선언 및 구현
+#define QN_DECLIMPL_LIST_POOLED(NAME, TYPE, PFX)													\
+	QN_DECL_LIST_POOLED(NAME, TYPE);																\
+	QN_IMPL_LIST_POOLED(NAME, TYPE, PFX)
+
 
 /// @brief 노드 리스트 인라인
 /// @param NAME 리스트 이름
@@ -2283,6 +3233,11 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 /// @param NODETYPE 노드 타입
 /// @param PFX 함수 접두사
 #define QN_IMPL_LNODE(NAME, NODETYPE, PFX)															\
+	QN_IMPL_LNODE_NODE(NAME, NODETYPE, QN_HASH_HEAP, PFX)
+
+/// @brief 노드 리스트 함수 (노드 할당 지정)
+///	@param NODE 노드 할당 방식 (QN_HASH_HEAP 또는 QN_HASH_POOL), 리스트가 해제하는 노드에 쓴다
+#define QN_IMPL_LNODE_NODE(NAME, NODETYPE, NODE, PFX)												\
 	FINLINE size_t PFX##_count(const NAME *list)													\
 	{																								\
 		return list->COUNT;																			\
@@ -2307,14 +3262,24 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 	{																								\
 		list->HEAD = list->TAIL = NULL;																\
 		list->COUNT = 0;																			\
+		NODE##_INIT(list, NODETYPE);																\
 	}																								\
-	FINLINE void PFX##_dispose(NAME *list)															\
+	FINLINE NODETYPE* PFX##_new_node(NAME *list)													\
+	{																								\
+		return NODE##_ALLOC(list, NODETYPE);														\
+	}																								\
+	FINLINE void inl_##PFX##_free_nodes(NAME *list)													\
 	{																								\
 		for (NODETYPE *node = list->HEAD, *next; node; node = next) {								\
 			next = node->NEXT;																		\
-			qn_free(node);																			\
+			NODE##_FREE(list, node);																\
 		}																							\
 	}																								\
+	FINLINE void PFX##_dispose(NAME *list)															\
+	{																								\
+		inl_##PFX##_free_nodes(list);																\
+		NODE##_DISPOSE(list);																		\
+	}																								\
 	FINLINE void PFX##_dispose_callback(NAME *list, paramfunc_t func)								\
 	{																								\
 		for (NODETYPE *node = list->HEAD, *next; node; node = next) {								\
@@ -2324,17 +3289,18 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 	}																								\
 	FINLINE void PFX##_reset(NAME *list)															\
 	{																								\
-		PFX##_init(list);																			\
-	}																								\
+		list->HEAD = list->TAIL = NULL;																\
+		list->COUNT = 0;																			\
+	}																								\
 	FINLINE void PFX##_clear(NAME *list)															\
 	{																								\
-		PFX##_dispose(list);																		\
-		PFX##_init(list);																			\
+		inl_##PFX##_free_nodes(list);																\
+		PFX##_reset(list);																			\
 	}																								\
 	FINLINE void PFX##_clear_callback(NAME *list, paramfunc_t func)									\
 	{																								\
 		PFX##_dispose_callback(list, func);															\
-		PFX##_init(list);																			\
+		PFX##_reset(list);																			\
 	}																								\
 	FINLINE void PFX##_remove(NAME *list, NODETYPE *node, bool freenode)							\
 	{																								\
@@ -2349,7 +3315,7 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 		else																						\
 			list->TAIL = node->PREV;																\
 		if (freenode)																				\
-			qn_free(node);																			\
+			NODE##_FREE(list, node);																\
 		list->COUNT--;																				\
 	}																								\
 	FINLINE void PFX##_remove_callback(NAME *list, NODETYPE *node, paramfunc_t func)				\
@@ -2457,6 +3423,26 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 	QN_DECL_LNODE(NAME, NODETYPE);																	\
 	QN_IMPL_LNODE(NAME, NODETYPE, PFX)
 
+/// @brief 노드를 메모리 풀에서 할당하는 노드 리스트 인라인. 노드는 _new_node로 만든다
+/// @param NAME 리스트 이름
+/// @param NODETYPE 노드 타입
+#define QN_DECL_LNODE_POOLED(NAME, NODETYPE)														\
+	/* struct NODETYPE { NODETYPE *PREV, *NEXT; } */												\
+	typedef struct NAME {																			\
+		NODETYPE *HEAD, *TAIL;																		\
+		size_t COUNT;																				\
+		QnPool* POOL;																				\
+	} NAME
+
+/// @brief 노드를 메모리 풀에서 할당하는 노드 리스트 함수
+#define QN_IMPL_LNODE_POOLED(NAME, NODETYPE, PFX)													\
+	QN_IMPL_LNODE_NODE(NAME, NODETYPE, QN_HASH_POOL, PFX)
+
+/// @brief 노드를 메모리 풀에서 할당하는 노드 리스트 선언 및 구현
+#define QN_DECLIMPL_LNODE_POOLED(NAME, NODETYPE, PFX)												\
+	QN_DECL_LNODE_POOLED(NAME, NODETYPE);															\
+	QN_IMPL_LNODE_POOLED(NAME, NODETYPE, PFX)
+
 
 // 해시 공용
 #define QN_IMPL_HASH_COMMON(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)		\
@@ -2604,6 +3590,11 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 ///	@param VALUEFREE 값 해제 함수
 ///	@param PFX 함수 접두사
 #define QN_IMPL_HASH(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)			\
+	QN_IMPL_HASH_NODE(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, QN_HASH_HEAP, PFX)
+
+/// @brief 해시 함수 (노드 할당 지정)
+///	@param NODE 노드 할당 방식 (QN_HASH_HEAP 또는 QN_HASH_POOL)
+#define QN_IMPL_HASH_NODE(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, NODE, PFX)	\
 	QN_IMPL_HASH_COMMON(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)			\
 	FINLINE void PFX##_init(NAME *hash)																\
 	{																								\
@@ -2611,12 +3602,14 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 		hash->BUCKET = QN_MIN_HASH;																	\
 		hash->NODES = qn_alloc_zero(QN_MIN_HASH, NAME##Node*);										\
 		hash->HEAD = hash->TAIL = NULL;																\
+		NODE##_INIT(hash, NAME##Node);																\
 	}																								\
 	FINLINE void PFX##_init_fast(NAME *hash)														\
 	{																								\
 		qn_debug_assert(hash->REVISION == 0 && hash->COUNT == 0 && hash->NODES == NULL, "cannot use _init_fast, use _init");	\
 		hash->BUCKET = QN_MIN_HASH;																	\
 		hash->NODES = qn_alloc_zero(QN_MIN_HASH, NAME##Node*);										\
+		NODE##_INIT(hash, NAME##Node);																\
 	}																								\
 	FINLINE void PFX##_dispose(NAME *hash)															\
 	{																								\
@@ -2624,9 +3617,10 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 			next = node->NEXT;																		\
 			KEYFREE(&node->KEY);																	\
 			VALUEFREE(&node->VALUE);																\
-			qn_free(node);																			\
+			NODE##_FREE(hash, node);																\
 		}																							\
 		qn_free(hash->NODES);																		\
+		NODE##_DISPOSE(hash);																		\
 	}																								\
 	FINLINE NAME##Node* PFX##_node_head(const NAME *hash)											\
 	{																								\
@@ -2666,7 +3660,7 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 			VALUEFREE(&ann->VALUE);																	\
 			return &ann->VALUE;																		\
 		}																							\
-		ann = qn_alloc_1(NAME##Node);																\
+		ann = NODE##_ALLOC(hash, NAME##Node);														\
 		ann->HASH = ah;																				\
 		ann->KEY = *pkey;																			\
 		ann->SIB = NULL;																			\
@@ -2693,7 +3687,7 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 		if (hash->NODES[ebk] == enn) hash->NODES[ebk] = NULL;										\
 		KEYFREE(&enn->KEY);																			\
 		VALUEFREE(&enn->VALUE);																		\
-		qn_free(enn);																				\
+		NODE##_FREE(hash, enn);																		\
 		hash->REVISION++;																			\
 		hash->COUNT--;																				\
 		inl_##PFX##_test_size(hash);																\
@@ -2704,7 +3698,7 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 			next = node->NEXT;																		\
 			KEYFREE(&node->KEY);																	\
 			VALUEFREE(&node->VALUE);																\
-			qn_free(node);																			\
+			NODE##_FREE(hash, node);																\
 		}																							\
 		hash->HEAD = hash->TAIL = NULL;																\
 		hash->REVISION++;																			\
@@ -2736,6 +3730,33 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 	QN_DECL_HASH(NAME, KEYTYPE, VALUETYPE);															\
 	QN_IMPL_HASH(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)
 
+/// @brief 노드를 메모리 풀에서 할당하는 해시 인라인. 해시마다 풀을 하나씩 갖는다
+/// @warning _add로 넣는 노드는 POOL에서 할당해야 한다
+///	@param NAME 해시 이름
+///	@param KEYTYPE 키 타입
+///	@param VALUETYPE 값 타입
+#define QN_DECL_HASH_POOLED(NAME, KEYTYPE, VALUETYPE)												\
+	typedef struct NAME##Node {																		\
+		struct NAME##Node *SIB, *NEXT, *PREV;														\
+		size_t HASH;																				\
+		KEYTYPE KEY;																				\
+		VALUETYPE VALUE;																			\
+	} NAME##Node;																					\
+	typedef struct NAME {																			\
+		size_t COUNT, REVISION, BUCKET;																\
+		NAME##Node **NODES, *HEAD, *TAIL;															\
+		QnPool* POOL;																				\
+	} NAME
+
+/// @brief 노드를 메모리 풀에서 할당하는 해시 함수
+#define QN_IMPL_HASH_POOLED(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)		\
+	QN_IMPL_HASH_NODE(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, QN_HASH_POOL, PFX)
+
+/// @brief 노드를 메모리 풀에서 할당하는 해시 선언 및 구현
+#define QN_DECLIMPL_HASH_POOLED(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)	\
+	QN_DECL_HASH_POOLED(NAME, KEYTYPE, VALUETYPE);													\
+	QN_IMPL_HASH_POOLED(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)
+
 // 키 정수 타입
 #define QN_DECLIMPL_HASH_INT_TYPE(NAME, KEYTYPE, VALUETYPE, VALUEFREE, PFX)							\
 	QN_DECLIMPL_HASH(NAME, KEYTYPE, VALUETYPE, qn_int_type_phash, qn_int_type_pcmp, (void), VALUEFREE, PFX)
@@ -2756,6 +3777,16 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 #define QN_DECLIMPL_HASH_PCHAR_AND_PCHAR(NAME, PFX)													\
 	QN_DECLIMPL_HASH_PCHAR_AND_INT_TYPE(NAME, char*, qn_mem_free_ptr, PFX)
 
+// 키 아톰 (해시는 아톰에 있고 포인터로 비교한다)
+#define QN_DECLIMPL_HASH_ATOM(NAME, VALUETYPE, VALUEFREE, PFX)										\
+	QN_DECLIMPL_HASH(NAME, QnAtom, VALUETYPE, qn_atom_phash, qn_atom_pcmp, (void), VALUEFREE, PFX)
+// 키 아톰 / 값 정수
+#define QN_DECLIMPL_HASH_ATOM_AND_INT_TYPE(NAME, VALUETYPE, PFX)									\
+	QN_DECLIMPL_HASH_ATOM(NAME, VALUETYPE, (void), PFX)
+// 키 아톰 / 값 문자열
+#define QN_DECLIMPL_HASH_ATOM_AND_PCHAR(NAME, PFX)													\
+	QN_DECLIMPL_HASH_ATOM(NAME, char*, qn_mem_free_ptr, PFX)
+
 
 /// @brief 묶음 인라인
 ///	@param NAME 묶음 이름
@@ -2783,18 +3814,25 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 /// @param VALUEFREE 값 해제 함수
 /// @param PFX 함수 접두사
 #define QN_IMPL_MUKUM(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)			\
+	QN_IMPL_MUKUM_NODE(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, QN_HASH_HEAP, PFX)
+
+/// @brief 묶음 함수 (노드 할당 지정)
+///	@param NODE 노드 할당 방식 (QN_HASH_HEAP 또는 QN_HASH_POOL)
+#define QN_IMPL_MUKUM_NODE(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, NODE, PFX)	\
 	QN_IMPL_HASH_COMMON(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)			\
 	FINLINE void PFX##_init(NAME *mukum)															\
 	{																								\
 		mukum->COUNT = mukum->REVISION = 0;															\
 		mukum->BUCKET = QN_MIN_HASH;																\
 		mukum->NODES = qn_alloc_zero(QN_MIN_HASH, NAME##Node*);										\
+		NODE##_INIT(mukum, NAME##Node);																\
 	}																								\
 	FINLINE void PFX##_init_fast(NAME *mukum)														\
 	{																								\
 		qn_debug_assert(mukum->REVISION == 0 && mukum->COUNT == 0 && mukum->NODES == NULL, "cannot use _init_fast, use _init");	\
 		mukum->BUCKET = QN_MIN_HASH;																\
 		mukum->NODES = qn_alloc_zero(QN_MIN_HASH, NAME##Node*);										\
+		NODE##_INIT(mukum, NAME##Node);																\
 	}																								\
 	FINLINE void PFX##_dispose(NAME *mukum)															\
 	{																								\
@@ -2803,10 +3841,11 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 				next = node->SIB;																	\
 				KEYFREE(&node->KEY);																\
 				VALUEFREE(&node->VALUE);															\
-				qn_free(node);																		\
+				NODE##_FREE(mukum, node);															\
 			}																						\
 		}																							\
 		qn_free(mukum->NODES);																		\
+		NODE##_DISPOSE(mukum);																		\
 	}																								\
 	FINLINE bool PFX##_add(NAME* mukum, NAME##Node* node)											\
 	{																								\
@@ -2833,7 +3872,7 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 			VALUEFREE(&ann->VALUE);																	\
 			return &ann->VALUE;																		\
 		}																							\
-		ann = qn_alloc_1(NAME##Node);																\
+		ann = NODE##_ALLOC(mukum, NAME##Node);														\
 		ann->SIB = NULL;																			\
 		ann->HASH = ah;																				\
 		ann->KEY = *pkey;																			\
@@ -2849,9 +3888,9 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 		*en = enn->SIB;																				\
 		const size_t ebk = enn->HASH % mukum->BUCKET;												\
 		if (mukum->NODES[ebk] == enn) mukum->NODES[ebk] = NULL;										\
-		KEYFREE(enn->KEY);																			\
+		KEYFREE(&enn->KEY);																			\
 		VALUEFREE(&enn->VALUE);																		\
-		qn_free(enn);																				\
+		NODE##_FREE(mukum, enn);																	\
 		mukum->REVISION++;																			\
 		mukum->COUNT--;																				\
 		inl_##PFX##_test_size(mukum);																\
@@ -2861,9 +3900,9 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 		for (size_t i = 0; i < mukum->BUCKET; ++i) {												\
 			for (NAME##Node *next = NULL, *node = mukum->NODES[i]; node; node = next) {				\
 				next = node->SIB;																	\
-				KEYFREE(node->KEY);																	\
+				KEYFREE(&node->KEY);																\
 				VALUEFREE(&node->VALUE);															\
-				qn_free(node);																		\
+				NODE##_FREE(mukum, node);															\
 			}																						\
 		}																							\
 		mukum->REVISION++;																			\
@@ -2903,6 +3942,33 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 	QN_DECL_MUKUM(NAME, KEYTYPE, VALUETYPE);														\
 	QN_IMPL_MUKUM(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)
 
+/// @brief 노드를 메모리 풀에서 할당하는 묶음 인라인. 묶음마다 풀을 하나씩 갖는다
+/// @warning _add로 넣는 노드는 POOL에서 할당해야 한다
+///	@param NAME 묶음 이름
+/// @param KEYTYPE 키 타입
+/// @param VALUETYPE 값 타입
+#define QN_DECL_MUKUM_POOLED(NAME, KEYTYPE, VALUETYPE)												\
+	typedef struct NAME##Node {																		\
+		struct NAME##Node *SIB;																		\
+		size_t HASH;																				\
+		KEYTYPE KEY;																				\
+		VALUETYPE VALUE;																			\
+	} NAME##Node;																					\
+	typedef struct NAME {																			\
+		size_t COUNT, REVISION, BUCKET;																\
+		NAME##Node **NODES;																			\
+		QnPool* POOL;																				\
+	} NAME
+
+/// @brief 노드를 메모리 풀에서 할당하는 묶음 함수
+#define QN_IMPL_MUKUM_POOLED(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)	\
+	QN_IMPL_MUKUM_NODE(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, QN_HASH_POOL, PFX)
+
+/// @brief 노드를 메모리 풀에서 할당하는 묶음 선언 및 구현
+#define QN_DECLIMPL_MUKUM_POOLED(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)	\
+	QN_DECL_MUKUM_POOLED(NAME, KEYTYPE, VALUETYPE);													\
+	QN_IMPL_MUKUM_POOLED(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)
+
 // 키 정수 타입
 #define QN_DECLIMPL_MUKUM_INT_TYPE(NAME, KEYTYPE, VALUETYPE, VALUEFREE, PFX)						\
 	QN_DECLIMPL_MUKUM(NAME, KEYTYPE, VALUETYPE, qn_int_type_phash, qn_int_type_pcmp, (void), VALUEFREE, PFX)
@@ -2923,6 +3989,359 @@ QN_DECL_ARRAY(QnPtrArray, pointer_t);
 #define QN_DECLIMPL_MUKUM_PCHAR_AND_PCHAR(NAME, PFX)												\
 	QN_DECLIMPL_MUKUM_PCHAR_AND_INT_TYPE(NAME, char*, qn_mem_free_ptr, PFX)
 
+// 키 아톰 (해시는 아톰에 있고 포인터로 비교한다)
+#define QN_DECLIMPL_MUKUM_ATOM(NAME, VALUETYPE, VALUEFREE, PFX)										\
+	QN_DECLIMPL_MUKUM(NAME, QnAtom, VALUETYPE, qn_atom_phash, qn_atom_pcmp, (void), VALUEFREE, PFX)
+// 키 아톰 / 값 정수
+#define QN_DECLIMPL_MUKUM_ATOM_AND_INT_TYPE(NAME, VALUETYPE, PFX)									\
+	QN_DECLIMPL_MUKUM_ATOM(NAME, VALUETYPE, (void), PFX)
+// 키 아톰 / 값 문자열
+#define QN_DECLIMPL_MUKUM_ATOM_AND_PCHAR(NAME, PFX)													\
+	QN_DECLIMPL_MUKUM_ATOM(NAME, char*, qn_mem_free_ptr, PFX)
+
+
+// 평평 해시 공용. 컨트롤 바이트는 비었으면 0x80, 차 있으면 해시 아래 7비트
+#define QN_FLAT_GROUP					16								/// @brief 평평 해시 한번에 찾는 컨트롤 바이트 갯수
+#define QN_FLAT_EMPTY					0x80							/// @brief 평평 해시 빈 칸
+#define QN_FLAT_MIN						16								/// @brief 평평 해시 최소 용량
+
+/// @brief 평평 해시 컨트롤 바이트 묶음에서 값이 같은 칸을 찾는다
+/// @param[in] ctrl 컨트롤 바이트 (QN_FLAT_GROUP 만큼 읽는다)
+/// @param[in] tag 찾을 값
+/// @return 찾은 칸의 비트 마스크. 칸마다 qn_flat_shift() 만큼 비트를 차지한다
+FINLINE ullong qn_flat_match(const byte* ctrl, byte tag)
+{
+#if defined _QN_SSE2_
+	const __m128i g = _mm_loadu_si128((const __m128i*)ctrl);
+	return (ullong)(uint)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)tag)));
+#elif defined _QN_NEON_
+	const uint8x16_t eq = vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(tag));
+	const uint8x8_t nb = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+	return vget_lane_u64(vreinterpret_u64_u8(nb), 0) & 0x8888888888888888ULL;
+#else
+	ullong bits = 0;
+	for (uint i = 0; i < QN_FLAT_GROUP; i++)
+		bits |= (ullong)(ctrl[i] == tag) << i;
+	return bits;
+#endif
+}
+
+/// @brief qn_flat_match() 결과에서 비트 위치를 칸 번호로 바꾸는 쉬프트
+FINLINE uint qn_flat_shift(void)
+{
+#if defined _QN_NEON_
+	return 2;
+#else
+	return 0;
+#endif
+}
+
+/// @brief 평평 해시 인라인 (오픈 어드레싱, 선형 탐사, 묘비 없는 삭제)
+///	@param NAME 해시 이름
+///	@param KEYTYPE 키 타입
+///	@param VALUETYPE 값 타입
+#define QN_DECL_FLATHASH(NAME, KEYTYPE, VALUETYPE)													\
+	typedef struct NAME##Node {																		\
+		size_t HASH;																				\
+		KEYTYPE KEY;																				\
+		VALUETYPE VALUE;																			\
+	} NAME##Node;																					\
+	typedef struct NAME {																			\
+		size_t COUNT, REVISION, CAPACITY;															\
+		byte* CTRL;																					\
+		NAME##Node* NODES;																			\
+	} NAME
+
+/// @brief 평평 해시 함수
+///	@param NAME 해시 이름
+///	@param KEYTYPE 키 타입
+///	@param VALUETYPE 값 타입
+///	@param KEYHASH 키 해시 함수
+///	@param KEYCMP 키 비교 함수 (같으면 0)
+///	@param KEYFREE 키 해제 함수
+///	@param VALUEFREE 값 해제 함수
+///	@param PFX 함수 접두사
+/// @note 용량은 2의 제곱, 7/8이 차면 두배로 늘린다. 지우면 뒤의 항목을 당겨 오므로 순회 중에 지우면 안된다
+#define QN_IMPL_FLATHASH(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)		\
+	typedef bool(*PFX##_find_t)(void*, KEYTYPE*, void*);											\
+	typedef void(*PFX##_each_t)(void*, KEYTYPE*, void*);											\
+	typedef void(*PFX##_loop_t)(KEYTYPE*, void*);													\
+	FINLINE void inl_##PFX##_ctrl(NAME* hash, size_t index, byte tag)								\
+	{																								\
+		hash->CTRL[index] = tag;																	\
+		if (index < QN_FLAT_GROUP)																	\
+			hash->CTRL[hash->CAPACITY + index] = tag;												\
+	}																								\
+	FINLINE void inl_##PFX##_alloc(NAME* hash, size_t capacity)										\
+	{																								\
+		hash->CAPACITY = capacity;																	\
+		hash->CTRL = qn_alloc(capacity + QN_FLAT_GROUP, byte);										\
+		memset(hash->CTRL, QN_FLAT_EMPTY, capacity + QN_FLAT_GROUP);								\
+		hash->NODES = qn_alloc(capacity, NAME##Node);												\
+	}																								\
+	FINLINE void PFX##_init(NAME* hash)																\
+	{																								\
+		hash->COUNT = hash->REVISION = 0;															\
+		inl_##PFX##_alloc(hash, QN_FLAT_MIN);														\
+	}																								\
+	FINLINE void PFX##_init_fast(NAME* hash)														\
+	{																								\
+		qn_debug_assert(hash->REVISION == 0 && hash->COUNT == 0 && hash->NODES == NULL, "cannot use _init_fast, use _init");	\
+		inl_##PFX##_alloc(hash, QN_FLAT_MIN);														\
+	}																								\
+	FINLINE void PFX##_dispose(NAME* hash)															\
+	{																								\
+		for (size_t i = 0; i < hash->CAPACITY; i++) {												\
+			if (hash->CTRL[i] == QN_FLAT_EMPTY) continue;											\
+			KEYFREE(&hash->NODES[i].KEY);															\
+			VALUEFREE(&hash->NODES[i].VALUE);														\
+		}																							\
+		qn_free(hash->CTRL);																		\
+		qn_free(hash->NODES);																		\
+	}																								\
+	FINLINE size_t PFX##_count(const NAME* hash)													\
+	{																								\
+		return hash->COUNT;																			\
+	}																								\
+	FINLINE size_t PFX##_revision(const NAME* hash)													\
+	{																								\
+		return hash->REVISION;																		\
+	}																								\
+	FINLINE size_t PFX##_capacity(const NAME* hash)													\
+	{																								\
+		return hash->CAPACITY;																		\
+	}																								\
+	FINLINE bool PFX##_is_have(const NAME* hash)													\
+	{																								\
+		return hash->COUNT != 0;																	\
+	}																								\
+	FINLINE bool PFX##_is_empty(const NAME* hash)													\
+	{																								\
+		return hash->COUNT == 0;																	\
+	}																								\
+	FINLINE size_t inl_##PFX##_hash(const KEYTYPE* pkey)											\
+	{																								\
+		return qn_hash_mix(KEYHASH(pkey));															\
+	}																								\
+	/* 찾으면 참. 못 찾으면 *at에 넣을 빈 칸 */														\
+	FINLINE bool inl_##PFX##_look_up(const NAME* hash, const KEYTYPE* pkey, size_t lh, size_t* at)	\
+	{																								\
+		const size_t mask = hash->CAPACITY - 1;														\
+		const byte tag = (byte)(lh & 0x7F);															\
+		const uint shift = qn_flat_shift();															\
+		for (size_t pos = (lh >> 7) & mask;; pos = (pos + QN_FLAT_GROUP) & mask) {					\
+			const byte* group = hash->CTRL + pos;													\
+			ullong bits = qn_flat_match(group, tag);												\
+			const ullong empty = qn_flat_match(group, QN_FLAT_EMPTY);								\
+			if (empty) bits &= (empty & (0 - empty)) - 1;											\
+			for (; bits; bits &= bits - 1) {														\
+				const size_t index = (pos + (qn_ctz64(bits) >> shift)) & mask;						\
+				const NAME##Node* node = &hash->NODES[index];										\
+				if (node->HASH == lh && KEYCMP((const KEYTYPE*)&node->KEY, pkey) == 0) {			\
+					*at = index;																	\
+					return true;																	\
+				}																					\
+			}																						\
+			if (empty) {																			\
+				*at = (pos + (qn_ctz64(empty) >> shift)) & mask;									\
+				return false;																		\
+			}																						\
+		}																							\
+	}																								\
+	FINLINE void inl_##PFX##_rehash(NAME* hash, size_t capacity)									\
+	{																								\
+		byte* old_ctrl = hash->CTRL;																\
+		NAME##Node* old_nodes = hash->NODES;														\
+		const size_t old_capacity = hash->CAPACITY;													\
+		inl_##PFX##_alloc(hash, capacity);															\
+		const size_t mask = capacity - 1;															\
+		const uint shift = qn_flat_shift();															\
+		for (size_t i = 0; i < old_capacity; i++) {													\
+			if (old_ctrl[i] == QN_FLAT_EMPTY) continue;												\
+			const size_t rh = old_nodes[i].HASH;													\
+			size_t pos = (rh >> 7) & mask;															\
+			ullong empty;																			\
+			while ((empty = qn_flat_match(hash->CTRL + pos, QN_FLAT_EMPTY)) == 0)					\
+				pos = (pos + QN_FLAT_GROUP) & mask;													\
+			pos = (pos + (qn_ctz64(empty) >> shift)) & mask;										\
+			inl_##PFX##_ctrl(hash, pos, (byte)(rh & 0x7F));											\
+			hash->NODES[pos] = old_nodes[i];														\
+		}																							\
+		qn_free(old_ctrl);																			\
+		qn_free(old_nodes);																			\
+	}																								\
+	FINLINE void PFX##_reserve(NAME* hash, size_t count)											\
+	{																								\
+		size_t capacity = hash->CAPACITY;															\
+		while (capacity - capacity / 8 < count)														\
+			capacity <<= 1;																			\
+		if (capacity != hash->CAPACITY)																\
+			inl_##PFX##_rehash(hash, capacity);														\
+	}																								\
+	FINLINE VALUETYPE* inl_##PFX##_insert(NAME* hash, KEYTYPE* pkey)								\
+	{																								\
+		const size_t lh = inl_##PFX##_hash((const KEYTYPE*)pkey);									\
+		size_t at;																					\
+		if (inl_##PFX##_look_up(hash, (const KEYTYPE*)pkey, lh, &at)) {								\
+			NAME##Node* node = &hash->NODES[at];													\
+			KEYFREE(pkey);																			\
+			VALUEFREE(&node->VALUE);																\
+			return &node->VALUE;																	\
+		}																							\
+		if (hash->COUNT + 1 > hash->CAPACITY - hash->CAPACITY / 8) {								\
+			inl_##PFX##_rehash(hash, hash->CAPACITY << 1);											\
+			inl_##PFX##_look_up(hash, (const KEYTYPE*)pkey, lh, &at);								\
+		}																							\
+		inl_##PFX##_ctrl(hash, at, (byte)(lh & 0x7F));												\
+		NAME##Node* node = &hash->NODES[at];														\
+		node->HASH = lh;																			\
+		node->KEY = *pkey;																			\
+		hash->REVISION++;																			\
+		hash->COUNT++;																				\
+		return &node->VALUE;																		\
+	}																								\
+	/* 뒤의 항목을 당겨와서 빈 칸을 메꾼다 (묘비 없음) */											\
+	FINLINE void inl_##PFX##_erase_at(NAME* hash, size_t index)										\
+	{																								\
+		const size_t mask = hash->CAPACITY - 1;														\
+		KEYFREE(&hash->NODES[index].KEY);															\
+		VALUEFREE(&hash->NODES[index].VALUE);														\
+		for (size_t next = (index + 1) & mask; hash->CTRL[next] != QN_FLAT_EMPTY; next = (next + 1) & mask) {	\
+			const size_t home = (hash->NODES[next].HASH >> 7) & mask;								\
+			if (((next - home) & mask) < ((next - index) & mask))									\
+				continue;																			\
+			hash->NODES[index] = hash->NODES[next];													\
+			inl_##PFX##_ctrl(hash, index, hash->CTRL[next]);										\
+			index = next;																			\
+		}																							\
+		inl_##PFX##_ctrl(hash, index, QN_FLAT_EMPTY);												\
+		hash->REVISION++;																			\
+		hash->COUNT--;																				\
+	}																								\
+	FINLINE bool PFX##_remove(NAME* hash, const KEYTYPE key)										\
+	{																								\
+		size_t at;																					\
+		if (!inl_##PFX##_look_up(hash, &key, inl_##PFX##_hash(&key), &at))							\
+			return false;																			\
+		inl_##PFX##_erase_at(hash, at);																\
+		return true;																				\
+	}																								\
+	FINLINE bool PFX##_ptr_remove(NAME* hash, const KEYTYPE* pkey)									\
+	{																								\
+		size_t at;																					\
+		if (!inl_##PFX##_look_up(hash, pkey, inl_##PFX##_hash(pkey), &at))							\
+			return false;																			\
+		inl_##PFX##_erase_at(hash, at);																\
+		return true;																				\
+	}																								\
+	FINLINE VALUETYPE* PFX##_get(const NAME* hash, const KEYTYPE key)								\
+	{																								\
+		size_t at;																					\
+		if (!inl_##PFX##_look_up(hash, &key, inl_##PFX##_hash(&key), &at))							\
+			return NULL;																			\
+		return &hash->NODES[at].VALUE;																\
+	}																								\
+	FINLINE VALUETYPE* PFX##_ptr_get(const NAME* hash, const KEYTYPE* pkey)							\
+	{																								\
+		size_t at;																					\
+		if (!inl_##PFX##_look_up(hash, pkey, inl_##PFX##_hash(pkey), &at))							\
+			return NULL;																			\
+		return &hash->NODES[at].VALUE;																\
+	}																								\
+	FINLINE void PFX##_set(NAME* hash, KEYTYPE key, VALUETYPE value)								\
+	{																								\
+		VALUETYPE* sv = inl_##PFX##_insert(hash, &key);												\
+		*sv = value;																				\
+	}																								\
+	FINLINE void PFX##_set_ptr(NAME* hash, KEYTYPE* pkey, VALUETYPE* pvalue)						\
+	{																								\
+		VALUETYPE* sv = inl_##PFX##_insert(hash, pkey);												\
+		*sv = *pvalue;																				\
+	}																								\
+	FINLINE VALUETYPE* PFX##_ins(NAME* hash, KEYTYPE key)											\
+	{																								\
+		return inl_##PFX##_insert(hash, &key);														\
+	}																								\
+	FINLINE VALUETYPE* PFX##_ptr_ins(NAME* hash, KEYTYPE* pkey)										\
+	{																								\
+		return inl_##PFX##_insert(hash, pkey);														\
+	}																								\
+	FINLINE void PFX##_clear(NAME* hash)															\
+	{																								\
+		for (size_t i = 0; i < hash->CAPACITY; i++) {												\
+			if (hash->CTRL[i] == QN_FLAT_EMPTY) continue;											\
+			KEYFREE(&hash->NODES[i].KEY);															\
+			VALUEFREE(&hash->NODES[i].VALUE);														\
+		}																							\
+		memset(hash->CTRL, QN_FLAT_EMPTY, hash->CAPACITY + QN_FLAT_GROUP);							\
+		hash->REVISION++;																			\
+		hash->COUNT = 0;																			\
+	}																								\
+	FINLINE KEYTYPE* PFX##_find_callback(const NAME* hash, PFX##_find_t func, void* context)		\
+	{																								\
+		for (size_t i = 0; i < hash->CAPACITY; i++) {												\
+			if (hash->CTRL[i] == QN_FLAT_EMPTY) continue;											\
+			if (func(context, &hash->NODES[i].KEY, &hash->NODES[i].VALUE))							\
+				return &hash->NODES[i].KEY;															\
+		}																							\
+		return NULL;																				\
+	}																								\
+	FINLINE void PFX##_loop(const NAME* hash, PFX##_loop_t func)									\
+	{																								\
+		for (size_t i = 0; i < hash->CAPACITY; i++) {												\
+			if (hash->CTRL[i] != QN_FLAT_EMPTY)														\
+				func(&hash->NODES[i].KEY, &hash->NODES[i].VALUE);									\
+		}																							\
+	}																								\
+	FINLINE void PFX##_foreach(const NAME* hash, PFX##_each_t func, void* context)					\
+	{																								\
+		for (size_t i = 0; i < hash->CAPACITY; i++) {												\
+			if (hash->CTRL[i] != QN_FLAT_EMPTY)														\
+				func(context, &hash->NODES[i].KEY, &hash->NODES[i].VALUE);							\
+		}																							\
+	}																								\
+	typedef NAME NAME##Type
+
+/// @brief 평평 해시 선언 및 구현
+#define QN_DECLIMPL_FLATHASH(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)	\
+	QN_DECL_FLATHASH(NAME, KEYTYPE, VALUETYPE);														\
+	QN_IMPL_FLATHASH(NAME, KEYTYPE, VALUETYPE, KEYHASH, KEYCMP, KEYFREE, VALUEFREE, PFX)
+
+// 키 정수 타입
+#define QN_DECLIMPL_FLATHASH_INT_TYPE(NAME, KEYTYPE, VALUETYPE, VALUEFREE, PFX)						\
+	QN_DECLIMPL_FLATHASH(NAME, KEYTYPE, VALUETYPE, qn_int_type_phash, qn_int_type_pcmp, (void), VALUEFREE, PFX)
+// 키 정수 / 값 정수
+#define QN_DECLIMPL_FLATHASH_INT_AND_INT_TYPE(NAME, KEYTYPE, VALUETYPE, PFX)						\
+	QN_DECLIMPL_FLATHASH_INT_TYPE(NAME, KEYTYPE, VALUETYPE, (void), PFX)
+// 키 정수 / 값 문자열
+#define QN_DECLIMPL_FLATHASH_INT_TYPE_AND_PCHAR(NAME, KEYTYPE, PFX)									\
+	QN_DECLIMPL_FLATHASH_INT_TYPE(NAME, KEYTYPE, char*, qn_mem_free_ptr, PFX)
+
+// 키 문자열
+#define QN_DECLIMPL_FLATHASH_PCHAR(NAME, VALUETYPE, VALUEFREE, PFX)									\
+	QN_DECLIMPL_FLATHASH(NAME, char*, VALUETYPE, qn_strphash, qn_strpcmp, qn_mem_free_ptr, VALUEFREE, PFX)
+// 키 문자열 / 값 정수
+#define QN_DECLIMPL_FLATHASH_PCHAR_AND_INT_TYPE(NAME, VALUETYPE, PFX)								\
+	QN_DECLIMPL_FLATHASH_PCHAR(NAME, VALUETYPE, (void), PFX)
+// 키 문자열 / 값 문자열
+#define QN_DECLIMPL_FLATHASH_PCHAR_AND_PCHAR(NAME, PFX)												\
+	QN_DECLIMPL_FLATHASH_PCHAR(NAME, char*, qn_mem_free_ptr, PFX)
+
+// 키 아톰 (해시는 아톰에 있고 포인터로 비교한다)
+#define QN_DECLIMPL_FLATHASH_ATOM(NAME, VALUETYPE, VALUEFREE, PFX)									\
+	QN_DECLIMPL_FLATHASH(NAME, QnAtom, VALUETYPE, qn_atom_phash, qn_atom_pcmp, (void), VALUEFREE, PFX)
+// 키 아톰 / 값 정수
+#define QN_DECLIMPL_FLATHASH_ATOM_AND_INT_TYPE(NAME, VALUETYPE, PFX)								\
+	QN_DECLIMPL_FLATHASH_ATOM(NAME, VALUETYPE, (void), PFX)
+// 키 아톰 / 값 문자열
+#define QN_DECLIMPL_FLATHASH_ATOM_AND_PCHAR(NAME, PFX)												\
+	QN_DECLIMPL_FLATHASH_ATOM(NAME, char*, qn_mem_free_ptr, PFX)
+
+/// @brief 평평 해시용 foreach
+#define QN_FLATHASH_FOREACH(hash, node)																\
+	for (size_t flat_iter = 0; flat_iter < (hash).CAPACITY; ++flat_iter)							\
+		if ((hash).CTRL[flat_iter] != QN_FLAT_EMPTY && ((node) = &(hash).NODES[flat_iter], true))
+
 
 //////////////////////////////////////////////////////////////////////////
 // gam
@@ -3027,13 +4446,14 @@ struct QNGAMNODE
 	QnBaseGam			base;
 
 	char				NAME[64];
+	QnAtom				ATOM;
 	size_t				HASH;
 	QnNodeGam*			NEXT;
 	QnNodeGam*			PREV;
 	QnNodeGam*			SIB;
 };
 
-/// @brief 노드 이름 설정
+/// @brief 노드 이름 설정. 아톰은 묶음에 넣을 때 만들고, 그 전까지는 문자열 해시로 찾는다
 /// @param self 노드
 /// @param name 이름
 QSAPI void qn_node_set_name(QnNodeGam* self, const char* name);
@@ -3356,6 +4776,9 @@ typedef enum QNFILEFLAG
 	QNFFT_HFS = QN_BIT(17),									/// @brief HFS 파일
 	QNFFT_MEM = QN_BIT(18),									/// @brief 메모리 파일
 	QNFFT_INDIRECT = QN_BIT(19),							/// @brief 간접 파일
+	QNFFT_VIEW = QN_BIT(20),								/// @brief 메모리 뷰 파일 (데이터를 갖고 있지 않음)
+	QNFFT_CHUNK = QN_BIT(21),								/// @brief 조각 압축 파일 (읽는 만큼만 푼다)
+	QNFFT_BUFFER = QN_BIT(22),								/// @brief 버퍼 스트림 (다른 스트림을 감싼다)
 } QnFileFlag;
 
 /// @brief 파일 속성
@@ -3364,7 +4787,7 @@ typedef enum QNFILEATTR
 	QNFATTR_NONE = 0,										/// @brief 파일이 없음
 	QNFATTR_FILE = QN_BIT(0),								/// @brief 파일
 	QNFATTR_DIR = QN_BIT(1),								/// @brief 디렉토리
-	QNFATTR_LINK = QN_BIT(2),								/// @brief 링크
+	QNFATTR_LINK = QN_BIT(2),								/// @brief 링크 (HFS에서는 다른 파일과 내용을 나눠 쓰는 파일)
 	QNFATTR_CMPR = QN_BIT(3),								/// @brief 압축 (윈도우/HFS만)
 	QNFATTR_ENCR = QN_BIT(4),								/// @brief 암호화 (윈도우/HFS만)
 	QNFATTR_INDIRECT = QN_BIT(5),							/// @brief 간접 파일 (HFS만)
@@ -3411,6 +4834,7 @@ typedef enum QNMOUNTFLAG
 	QNMFT_HFS = QN_BIT(18),									/// @brief HFS 파일 시스템
 	QNMFT_FUSE = QN_BIT(19),									/// @brief FUSE 파일 시스템
 	QNMFT_NORESTORE = QN_BIT(20),							/// @brief 복원하지 않음
+	QNMFT_MAPPED = QN_BIT(21),								/// @brief 메모리 매핑
 } QnMountFlag;
 
 /// @brief 파일 정보
@@ -3538,7 +4962,7 @@ struct QNMOUNT_VTABLE
 	QnFileAttr(*mount_attr)(/*QnMount*/QnGam, const char*);
 	QnStream* (*mount_stream)(/*QnMount*/QnGam, const char*, const char*);
 	QnDir* (*mount_list)(/*QnMount*/QnGam, const char*, const char*);
-	void* (*mount_alloc)(/*QnMount*/QnGam, const char*, int*);
+	void* (*mount_alloc)(/*QnMount*/QnGam, const char*, size_t*);
 };
 
 // 스트림 & 마운트 보조 함수
@@ -3554,9 +4978,17 @@ QSAPI QnFileAttr qn_get_file_attr(QnMount* mount, const char* filename);
 /// @param mount 마운트 (널이면 디스크 파일 시스템)
 /// @param filename 파일이름
 /// @param size 파일의 크기 (널 가능)
-/// @return 파일 데이터
+/// @return 파일 데이터, 2GB가 넘는 파일은 EFBIG으로 실패
+/// @see qn_file_alloc64
 QSAPI void* qn_file_alloc(QnMount* mount, const char* filename, int* size);
 
+/// @brief 파일을 한번에 읽는다, 크기 제한 없음
+/// @param mount 마운트 (널이면 디스크 파일 시스템)
+/// @param filename 파일이름
+/// @param size 파일의 크기 (널 가능)
+/// @return 파일 데이터
+QSAPI void* qn_file_alloc64(QnMount* mount, const char* filename, size_t* size);
+
 /// @brief 텍스트 파일을 한번에 읽는다
 /// @param mount 마운트 (널이면 디스크 파일 시스템)
 /// @param filename 파일이름
@@ -3564,6 +4996,18 @@ QSAPI void* qn_file_alloc(QnMount* mount, const char* filename, int* size);
 /// @param codepage 코드 페이지 (1200=UTF-16LE, 1201=UTF-16BE, 65001=UTF-8, 0=ANSI/시스템로캘 또는 UTF-8)
 QSAPI char* qn_file_alloc_text(QnMount* mount, const char* filename, int* length, int* codepage);
 
+/// @brief 파일을 읽기 전용으로 메모리에 매핑한다 (디스크 파일 시스템만)
+/// @param filename 파일 이름
+/// @param[out] size 매핑한 크기
+/// @return 매핑한 메모리 포인터, 실패하거나 빈 파일이면 널
+/// @warning 반환 값은 qn_file_unmap 함수로 해제해야 한다
+QSAPI const void* qn_file_map(const char* filename, size_t* size);
+
+/// @brief qn_file_map 으로 매핑한 메모리를 해제한다
+/// @param ptr 매핑한 메모리 포인터
+/// @param size 매핑한 크기
+QSAPI void qn_file_unmap(const void* ptr, size_t size);
+
 /// @brief 마운트에서 파일 제거 (디렉토리도 제거	가능
 /// @param mount 마운트 (널이면 디스크 파일 시스템)
 /// @param path 파일 경로
@@ -3614,6 +5058,20 @@ QSAPI int qn_stream_read(QnStream* self, void* buffer, int offset, int size);
 /// @return 쓴 크기
 QSAPI int qn_stream_write(QnStream* self, const void* buffer, int offset, int size);
 
+/// @brief 스트림 읽기, 2GB 넘는 크기도 나눠서 읽는다
+/// @param self 스트림
+/// @param buffer 버퍼
+/// @param size 크기
+/// @return 읽은 크기, 끝에 닿으면 size보다 작다
+QSAPI llong qn_stream_read64(QnStream* self, void* buffer, llong size);
+
+/// @brief 스트림 쓰기, 2GB 넘는 크기도 나눠서 쓴다
+/// @param self 스트림
+/// @param buffer 버퍼
+/// @param size 크기
+/// @return 쓴 크기
+QSAPI llong qn_stream_write64(QnStream* self, const void* buffer, llong size);
+
 /// @brief 스트림 위치 찾기
 /// @param self 스트림
 /// @param offset 오프셋
@@ -3655,6 +5113,30 @@ QSAPI int qn_stream_vprintf(QnStream* self, const char* fmt, va_list va);
 /// @return 쓴 크기
 QSAPI int qn_stream_printf(QnStream* self, const char* fmt, ...);
 
+/// @brief 스트림을 읽지 않고 앞부분을 들여다본다
+/// @param self 스트림
+/// @param buffer 버퍼
+/// @param size 크기 (버퍼 스트림이면 버퍼 크기까지)
+/// @return 들여다본 크기, 실패하면 -1
+/// @note 버퍼 스트림이 아니면 위치를 찾을 수 있어야 한다
+QSAPI int qn_stream_peek(QnStream* self, void* buffer, int size);
+
+/// @brief 구분자가 나올 때까지 읽는다
+/// @param self 스트림
+/// @param buffer 버퍼
+/// @param size 버퍼 크기, 이만큼 읽으면 구분자가 없어도 멈춘다
+/// @param delim 구분자 (읽은 데이터에 들어간다)
+/// @return 읽은 크기, 끝이면 0
+/// @note 버퍼 스트림이 아니면 한 바이트씩 읽는다
+QSAPI int qn_stream_read_until(QnStream* self, void* buffer, int size, int delim);
+
+/// @brief 한줄 읽기, 줄 끝(\n, \r\n)은 빼고 널로 끝낸다
+/// @param self 스트림
+/// @param buffer 버퍼
+/// @param size 버퍼 크기, 줄이 더 길면 나머지는 다음에 읽는다
+/// @return 줄 길이, 끝이면 -1
+QSAPI int qn_stream_read_line(QnStream* self, char* buffer, int size);
+
 /// @brief 스트림 이름 얻기
 /// @param self 스트림
 /// @return 이름
@@ -3695,6 +5177,24 @@ QSAPI QnStream* qn_create_mem_stream_data(const char* name, void* data, size_t s
 /// @return 메모리 포인터
 QSAPI void* qn_mem_stream_get_data(QnStream* self);
 
+/// @brief 외부 메모리를 복사하지 않고 읽기 전용 스트림으로 만든다
+/// @param name 스트림 이름
+/// @param data 데이터 (스트림이 없어질 때까지 유효해야 한다)
+/// @param size 데이터의 크기
+/// @return 만든 뷰 스트림
+/// @note 데이터는 해제하지 않는다. qn_mem_stream_get_data 로 데이터 포인터를 얻을 수 있다
+QSAPI QnStream* qn_create_view_stream(const char* name, const void* data, size_t size);
+
+// 버퍼 스트림
+
+/// @brief 스트림을 버퍼 스트림으로 감싼다
+/// @param stream 감쌀 스트림 (참조를 하나 더 잡는다)
+/// @param buffer_size 버퍼 크기 (0이면 64KB)
+/// @return 만든 버퍼 스트림
+/// @note 읽기는 버퍼 크기만큼 미리 읽고, 쓰기는 모아서 쓴다. 모아둔 쓰기는 flush, seek, 닫을 때 나간다.
+/// 감싼 스트림을 따로 읽고 쓰면 위치가 어긋나므로 버퍼 스트림으로만 다뤄야 한다
+QSAPI QnStream* qn_create_buffered_stream(QnStream* stream, size_t buffer_size);
+
 // 디렉토리
 
 /// @brief 디렉토리 열기
@@ -3722,12 +5222,18 @@ QSAPI void qn_dir_rewind(QnDir* self);
 
 /// @brief 마운트 열기
 /// @param path 마운트 경로
-/// @param mode 모드 (h=HFS, m=메모리, c=만들기, +=읽고 쓰기, f=HFS전용 디렉토리 복구 안함)
+/// @param mode 모드 (h=HFS, m=메모리, c=만들기, +=읽고 쓰기, f=HFS전용 디렉토리 복구 안함, v=HFS전용 메모리 매핑, l=HFS전용 큰 파일)
 /// @return 만든 마운트
 /// @note path를 널 값으로 하여 파일 시스템을 열 때는 실행 파일이 있는 경로를 기준으로 한다
 ///
-/// 모드에서 'f'는 HFS전용으로 open/read에서 디렉토리를 복구하지 않는다. 즉,
-/// 경로를 사용해서 파일을 읽고 열 때 해당 경로로 변경된다.
+/// 모드에서 'f'는 HFS전용으로 디렉토리를 복구하지 않는다. 파일을 읽고 열 때는
+/// 전체 경로 색인에서 바로 찾으므로 현재 디렉토리가 바뀌지 않는다.
+///
+/// 모드에서 'v'는 HFS전용으로 읽기 전용일 때 HFS 파일을 메모리에 매핑한다.
+/// 압축하지 않은 파일을 스트림으로 열면 복사하지 않고 매핑된 메모리를 그대로 보여준다.
+///
+/// 모드에서 'l'은 HFS전용으로 'c'와 함께 쓰면 위치와 크기가 64비트인 HFS를 만든다.
+/// 4GB가 넘는 HFS나 파일을 넣을 때 쓴다. 여는 쪽은 버전을 보고 알아서 읽는다.
 QSAPI QnMount* qn_open_mount(const char* path, const char* mode);
 
 /// @brief 마운트 이름 얻기
@@ -3754,32 +5260,33 @@ QSAPI bool qn_hfs_set_desc(QnMount* mount, const char* desc);
 /// @param mount HFS 마운트
 /// @param filename 파일 이름
 /// @param data 데이터
-/// @param size 크기 (최대 크기는 1.99GB로 2040MB)
-/// @param cmpr 압축 여부
+/// @param size 크기 (최대 크기는 1.99GB로 2040MB, 'l' 모드로 만든 HFS는 제한 없음)
+/// @param codec 압축 코덱 (QNCODEC_STORE면 압축 안함, 자주 읽는 파일은 QNCODEC_LZ. v16 전 HFS는 디플레이트로 넣는다)
 /// @param type 파일 타입
-/// @return 성공했으면 참을 반환
-/// @note EMSCRIPTEN에서는 사용할 수 없다
-QSAPI bool qn_hfs_store_data(QnMount* mount, const char* filename, const void* data, uint size, bool cmpr, QnFileType type);
+/// @return 성공했으면 참을 반환, 32비트 HFS가 4GB를 넘게 되면 EFBIG으로 실패
+/// @note 같은 코덱으로 넣은 같은 내용이 이미 있으면 데이터는 쓰지 않고 QNFATTR_LINK로 가리킨다.
+/// 내용은 128비트 해시로 비교한다. EMSCRIPTEN에서는 사용할 수 없다
+QSAPI bool qn_hfs_store_data(QnMount* mount, const char* filename, const void* data, size_t size, QnCodec codec, QnFileType type);
 
 /// @brief HFS에 스트림을 파일로 저장한다
 /// @param mount HFS 마운트
 /// @param filename 파일 이름
 /// @param stream 스트림
-/// @param cmpr 압축 여부
+/// @param codec 압축 코덱 (QNCODEC_STORE면 압축 안함, 자주 읽는 파일은 QNCODEC_LZ. v16 전 HFS는 디플레이트로 넣는다)
 /// @param type 파일 타입
 /// @return 성공했으면 참을 반환
 /// @note EMSCRIPTEN에서는 사용할 수 없다
-QSAPI bool qn_hfs_store_stream(QnMount* mount, const char* filename, QnStream* stream, bool cmpr, QnFileType type);
+QSAPI bool qn_hfs_store_stream(QnMount* mount, const char* filename, QnStream* stream, QnCodec codec, QnFileType type);
 
 /// @brief HFS에 파일을 파일로 저장한다
 /// @param mount HFS 마운트
 /// @param filename 파일 이름 (널이면 소스 파일 이름을 사용)
 /// @param srcfile 소스 파일 이름
-/// @param cmpr 압축 여부
+/// @param codec 압축 코덱 (QNCODEC_STORE면 압축 안함, 자주 읽는 파일은 QNCODEC_LZ. v16 전 HFS는 디플레이트로 넣는다)
 /// @param type 파일 타입
 /// @return 성공했으면 참을 반환
 /// @note EMSCRIPTEN에서는 사용할 수 없다
-QSAPI bool qn_hfs_store_file(QnMount* mount, const char* filename, const char* srcfile, bool cmpr, QnFileType type);
+QSAPI bool qn_hfs_store_file(QnMount* mount, const char* filename, const char* srcfile, QnCodec codec, QnFileType type);
 
 // HFS 최적화 상태 미리 정의
 struct HFSOPTIMIZEDATA;
@@ -3811,8 +5318,47 @@ typedef struct HFSOPTIMIZEDATA
 /// @param mount HFS 마운트
 /// @param param 최적화 파라미터
 /// @return 성공했으면 참을 반환
-/// @note EMSCRIPTEN에서는 사용할 수 없다
+/// @note 저장된 모양이 같은 파일은 데이터를 한번만 쓴다. EMSCRIPTEN에서는 사용할 수 없다
 QSAPI bool qn_hfs_optimize(QnMount* mount, HfsOptimizeParam* param);
+
+/// @brief HFS 묶음 저장 항목
+typedef struct HFSBATCHITEM
+{
+	const char*			filename;							/// @brief HFS 안의 이름, 디렉토리는 알아서 만든다 (파일이면 널일 때 srcfile)
+	const char*			srcfile;							/// @brief 디스크 파일이나 디렉토리 (디렉토리면 아래를 모두 filename 아래로)
+	const void*			data;								/// @brief 데이터 (널이 아니면 srcfile 대신 넣는다)
+	size_t				size;								/// @brief 데이터 크기
+	QnCodec				codec;								/// @brief 압축 코덱
+	QnFileType			type;								/// @brief 파일 타입
+} HfsBatchItem;
+
+/// @brief HFS 묶음 저장 파라미터
+typedef struct HFSBATCHPARAM
+{
+	char				filename[260];						/// @brief 만들 HFS 파일 이름
+	char				desc[64];							/// @brief HFS에 기록할 설명
+	QnTimeStamp			stamp;								/// @brief 헤더와 모든 항목에 기록할 시간 (0이면 기록 안함)
+	bool				large;								/// @brief 64비트 위치로 만든다, 4GB가 넘을 것 같으면 알아서 켜진다 [반환]
+
+	uint				files;								/// @brief [반환] 넣은 파일 수
+	uint				dirs;								/// @brief [반환] 만든 디렉토리 수
+	uint				links;								/// @brief [반환] 같은 내용이라 데이터를 나눠 쓴 파일 수
+	ullong				size;								/// @brief [반환] 넣은 파일의 원래 크기 합
+	ullong				written;							/// @brief [반환] 만든 HFS 파일 크기
+	double				elapsed;							/// @brief [반환] 걸린 시간 (초)
+	double				mbps;								/// @brief [반환] 원래 크기 기준 처리 속도 (MB/s)
+} HfsBatchParam;
+
+/// @brief 여러 파일을 한번에 새 HFS로 만든다
+/// @param items 저장할 항목
+/// @param count 항목 갯수
+/// @param param 묶음 저장 파라미터
+/// @return 성공했으면 참을 반환. 같은 이름이 있으면 errno가 EEXIST
+/// @note 읽기와 압축은 qn_parallel_for로 나눠 하고, 파일은 앞에서부터 한번에 쓴다.
+/// 경로 순서로 정렬해서 넣기 때문에 같은 입력과 같은 stamp면 바이트까지 같은 파일이 나온다.
+/// 디렉토리를 넣을 때 빈 파일은 건너뛴다. 같은 코덱으로 넣는 같은 내용은 한번만 쓴다.
+/// EMSCRIPTEN에서는 사용할 수 없다
+QSAPI bool qn_hfs_store_batch(const HfsBatchItem* items, size_t count, HfsBatchParam* param);
 #endif
 
 // Fuse
@@ -3822,12 +5368,14 @@ QSAPI bool qn_hfs_optimize(QnMount* mount, HfsOptimizeParam* param);
 /// @param diskfs 디스크 파일 시스템 사용
 /// @param loadall 모든 HFS 마운트 미리 로드
 /// @return 만든 마운트
+/// @note 읽기(스트림 열기, 파일 읽기, 속성 얻기)는 여러 스레드에서 잠금 없이 동시에 할 수 있다
 QSAPI QnMount* qn_create_fuse(const char* path, bool diskfs, bool loadall);
 
 /// @brief 퓨즈에 HFS 추가
 /// @param mount 퓨즈 마운트
 /// @param name HFS 이름
 /// @return 성공했으면 참을 반환. HFS 파일이 없거나 이미 로드 되있으면 거짓을 반환
+/// @note 색인을 복제해서 고친 다음 바꿔 끼우므로 다른 스레드가 읽는 중에 추가해도 된다
 QSAPI bool qn_fuse_add_hfs(QnMount* mount, const char* name);
 
 /// @brief 퓨즈가 HFS를 몇개 갖고 있는지 얻는다
@@ -3845,6 +5393,105 @@ QSAPI bool qn_fuse_get_disk_fs_enabled(QnMount* mount);
 /// @param enabled 사용할지 여부
 QSAPI void qn_fuse_set_disk_fs_enabled(QnMount* mount, bool enabled);
 
+// 비동기 읽기
+
+/// @brief 비동기 읽기 요청, 다 쓰면 qn_unload 로 놓는다
+typedef struct QNASYNCREAD QnAsyncRead;
+
+/// @brief 비동기 읽기 상태
+typedef enum QNASYNCSTATE
+{
+	QNASYNC_WAIT,											/// @brief 순서를 기다리는 중
+	QNASYNC_READ,											/// @brief 읽는 중
+	QNASYNC_DONE,											/// @brief 다 읽었음
+	QNASYNC_FAIL,											/// @brief 실패 (qn_async_error 로 errno를 얻는다)
+	QNASYNC_CANCEL,											/// @brief 취소됨
+} QnAsyncState;
+
+/// @brief 비동기 읽기 완료 콜백, qn_async_update 를 부른 스레드에서 불린다
+typedef void (*QnAsyncFunc)(QnAsyncRead* req, void* data);
+
+/// @brief 비동기 읽기에 쓸 입출력 스레드 갯수를 정한다
+/// @param count 스레드 갯수, 0이면 코어 갯수의 반 (2 ~ 4)
+/// @note 처음 요청하기 전에 불러야 한다. 스레드를 만든 뒤에는 바뀌지 않는다
+QSAPI void qn_async_threads(uint count);
+
+/// @brief 비동기 읽기가 io_uring을 쓰는지 알아본다
+/// @return 리눅스에서 io_uring을 쓸 수 있으면 참
+/// @note 디스크 파일과 압축하지 않은 HFS 파일은 io_uring으로 읽고, 압축 풀기나 io_uring을 못 쓸 때는 입출력 스레드가 읽는다.
+/// QS_NO_IO_URING을 정의하면 입출력 스레드만 쓴다
+QSAPI bool qn_async_uring(void);
+
+/// @brief 파일을 통째로 비동기로 읽는다
+/// @param mount 마운트 (널이면 디스크)
+/// @param filename 파일 이름
+/// @param func 완료 콜백 (널 가능)
+/// @param data 콜백 데이터
+/// @return 읽기 요청, 기다릴 일이 없으면 바로 qn_unload 해도 콜백은 불린다
+/// @note 읽기는 qn_file_alloc64 와 같다. HFS는 입출력 스레드에서 압축까지 풀고,
+/// 디스크, HFS, 퓨즈 모두 마운트를 잡아 두므로 읽는 중에 마운트를 놓아도 된다
+QSAPI QnAsyncRead* qn_async_read(QnMount* mount, const char* filename, QnAsyncFunc func, void* data);
+
+/// @brief 파일의 일부를 비동기로 읽는다
+/// @param mount 마운트 (널이면 디스크)
+/// @param filename 파일 이름
+/// @param offset 읽을 위치
+/// @param size 읽을 크기 (0이면 끝까지), 파일 끝을 넘으면 있는 만큼만 읽는다
+/// @param func 완료 콜백 (널 가능)
+/// @param data 콜백 데이터
+/// @return 읽기 요청
+/// @note 스트림을 열어 읽으므로 조각 압축한 HFS 파일은 필요한 조각만 푼다
+QSAPI QnAsyncRead* qn_async_read_range(QnMount* mount, const char* filename, llong offset, size_t size, QnAsyncFunc func, void* data);
+
+/// @brief 끝난 읽기 요청의 콜백을 부른다. 막히지 않으므로 매 프레임 불러도 된다
+/// @return 부른 콜백 갯수
+/// @note qg_loop 에서 알아서 부른다
+QSAPI int qn_async_update(void);
+
+/// @brief 읽기 요청 상태를 얻는다
+/// @param self 읽기 요청
+/// @return 상태
+QSAPI QnAsyncState qn_async_state(const QnAsyncRead* self);
+
+/// @brief 읽기 요청이 끝났나 확인한다 (성공, 실패, 취소 모두)
+/// @param self 읽기 요청
+/// @return 끝났으면 참
+QSAPI bool qn_async_poll(const QnAsyncRead* self);
+
+/// @brief 읽기 요청이 끝날 때까지 기다린다
+/// @param self 읽기 요청
+/// @return 다 읽었으면 참
+/// @note 콜백은 기다려도 qn_async_update 에서 불린다
+QSAPI bool qn_async_wait(QnAsyncRead* self);
+
+/// @brief 아직 읽기 시작하지 않은 요청을 취소한다
+/// @param self 읽기 요청
+/// @return 취소했으면 참, 이미 읽는 중이거나 끝났으면 거짓
+/// @note 취소해도 콜백은 QNASYNC_CANCEL 상태로 불린다
+QSAPI bool qn_async_cancel(QnAsyncRead* self);
+
+/// @brief 읽은 데이터를 얻는다. 데이터는 요청이 갖고 있다
+/// @param self 읽기 요청
+/// @param size 읽은 크기 (널 가능)
+/// @return 데이터, 다 읽지 않았으면 널
+QSAPI const void* qn_async_data(const QnAsyncRead* self, size_t* size);
+
+/// @brief 읽은 데이터를 가져온다. 가져온 데이터는 qn_free 로 해제한다
+/// @param self 읽기 요청
+/// @param size 읽은 크기 (널 가능)
+/// @return 데이터, 다 읽지 않았거나 이미 가져갔으면 널
+QSAPI void* qn_async_take(QnAsyncRead* self, size_t* size);
+
+/// @brief 실패한 읽기 요청의 errno를 얻는다
+/// @param self 읽기 요청
+/// @return errno, 실패하지 않았으면 0
+QSAPI int qn_async_error(const QnAsyncRead* self);
+
+/// @brief 읽기 요청의 파일 이름을 얻는다
+/// @param self 읽기 요청
+/// @return 파일 이름
+QSAPI const char* qn_async_filename(const QnAsyncRead* self);
+
 
 //////////////////////////////////////////////////////////////////////////
 // thread
@@ -3887,6 +5534,121 @@ QSAPI void qn_spin_leave(QnSpinLock* lock);
 #define QN_UNLOCK(sp)
 #endif
 
+// atomic
+
+/// @brief 원자적으로 값을 읽는다 (acquire)
+/// @param p 읽을 값의 포인터
+/// @return 읽은 값
+FINLINE nint qn_atomic_load(const volatile nint* p)
+{
+#if defined _MSC_VER
+	const nint v = *p;
+#if defined _M_IX86 || defined _M_X64
+	_ReadWriteBarrier();
+#else
+	__dmb(0xB);
+#endif
+	return v;
+#elif defined __GNUC__
+	return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#else
+	return *p;
+#endif
+}
+
+/// @brief 원자적으로 값을 쓴다 (release)
+/// @param p 쓸 값의 포인터
+/// @param v 쓸 값
+FINLINE void qn_atomic_store(volatile nint* p, const nint v)
+{
+#if defined _MSC_VER
+#if defined _M_IX86 || defined _M_X64
+	_ReadWriteBarrier();
+#else
+	__dmb(0xB);
+#endif
+	*p = v;
+#elif defined __GNUC__
+	__atomic_store_n(p, v, __ATOMIC_RELEASE);
+#else
+	*p = v;
+#endif
+}
+
+/// @brief 원자적으로 값을 더한다
+/// @param p 더할 값의 포인터
+/// @param v 더할 값
+/// @return 더하기 전의 값
+FINLINE nint qn_atomic_add(volatile nint* p, const nint v)
+{
+#if defined _MSC_VER && defined _QN_64_
+	return (nint)_InterlockedExchangeAdd64((volatile __int64*)p, (__int64)v);
+#elif defined _MSC_VER
+	return (nint)_InterlockedExchangeAdd((volatile long*)p, (long)v);
+#elif defined __GNUC__
+	return __atomic_fetch_add(p, v, __ATOMIC_ACQ_REL);
+#else
+	const nint prev = *p;
+	*p = prev + v;
+	return prev;
+#endif
+}
+
+/// @brief 원자적으로 값을 바꾼다
+/// @param p 바꿀 값의 포인터
+/// @param v 새 값
+/// @return 바꾸기 전의 값
+FINLINE nint qn_atomic_exchange(volatile nint* p, const nint v)
+{
+#if defined _MSC_VER && defined _QN_64_
+	return (nint)_InterlockedExchange64((volatile __int64*)p, (__int64)v);
+#elif defined _MSC_VER
+	return (nint)_InterlockedExchange((volatile long*)p, (long)v);
+#elif defined __GNUC__
+	return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST);
+#else
+	const nint prev = *p;
+	*p = v;
+	return prev;
+#endif
+}
+
+/// @brief 원자적으로 값이 같으면 바꾼다
+/// @param p 바꿀 값의 포인터
+/// @param expected 비교할 값
+/// @param desired 바꿀 값
+/// @return 바꿨으면 참
+FINLINE bool qn_atomic_cas(volatile nint* p, const nint expected, const nint desired)
+{
+#if defined _MSC_VER && defined _QN_64_
+	return _InterlockedCompareExchange64((volatile __int64*)p, (__int64)desired, (__int64)expected) == (__int64)expected;
+#elif defined _MSC_VER
+	return _InterlockedCompareExchange((volatile long*)p, (long)desired, (long)expected) == (long)expected;
+#elif defined __GNUC__
+	nint e = expected;
+	return __atomic_compare_exchange_n(p, &e, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#else
+	if (*p != expected)
+		return false;
+	*p = desired;
+	return true;
+#endif
+}
+
+/// @brief 메모리 장벽 (seq_cst)
+FINLINE void qn_atomic_fence(void)
+{
+#if defined _MSC_VER && defined _M_X64
+	__faststorefence();
+#elif defined _MSC_VER && defined _M_IX86
+	_mm_mfence();
+#elif defined _MSC_VER
+	__dmb(0xB);
+#elif defined __GNUC__
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
 // tls
 
 /// @brief TLS를 만든다
@@ -4085,6 +5847,111 @@ QSAPI int qn_thread_get_busy(const QnThread* self);
 /// @return 성공하면 참
 QSAPI bool qn_thread_set_busy(QnThread* self, int busy);
 
+// job
+
+/// @brief 작업 시스템 (일꾼 별 작업 덱과 훔치기)
+typedef struct QNJOBSYSTEM QnJobSystem;
+
+/// @brief 작업 콜백
+typedef void (*QnJobFunc)(void* data);
+
+/// @brief 작업 카운터, 넣은 작업이 끝나면 줄어든다. 0으로 초기화해서 쓴다
+typedef struct QNJOBCOUNTER
+{
+	volatile nint		value;
+} QnJobCounter;
+
+/// @brief 작업 시스템을 만든다. 만든 스레드가 메인 스레드가 된다
+/// @param workers 일꾼 스레드 갯수, 음수면 코어 갯수 - 1, 0이면 기다리는 스레드가 모두 처리한다
+/// @param busy 일꾼 스레드 우선 순위 (-2 ~ 2)
+/// @return 만들어진 작업 시스템
+QSAPI QnJobSystem* qn_new_job_system(int workers, int busy);
+
+/// @brief 작업 시스템을 제거한다. 남은 작업은 부른 스레드에서 처리한다
+/// @param self 작업 시스템
+QSAPI void qn_delete_job_system(QnJobSystem* self);
+
+/// @brief 공용 작업 시스템을 얻는다. 병렬 처리도 이걸 쓴다
+/// @return 공용 작업 시스템
+/// @note 처음 부를 때 qn_parallel_threads 에서 정한 갯수로 만든다. 어느 스레드에서 불러도 메인 스레드는 qn_runtime을 부른 스레드
+QSAPI QnJobSystem* qn_job_system(void);
+
+/// @brief 일꾼 스레드 갯수를 얻는다 (메인 스레드 제외)
+/// @param self 작업 시스템
+/// @return 일꾼 스레드 갯수
+QSAPI uint qn_job_system_workers(const QnJobSystem* self);
+
+/// @brief 작업을 넣는다. 일꾼 스레드에서 넣으면 그 일꾼의 덱으로, 아니면 공용 큐로 들어간다
+/// @param self 작업 시스템
+/// @param func 작업 콜백
+/// @param data 콜백 데이터
+/// @param counter 작업 카운터, 필요 없으면 NULL
+QSAPI void qn_job_run(QnJobSystem* self, QnJobFunc func, void* data, QnJobCounter* counter);
+
+/// @brief 메인 스레드에서만 처리할 작업을 넣는다
+/// @param self 작업 시스템
+/// @param func 작업 콜백
+/// @param data 콜백 데이터
+/// @param counter 작업 카운터, 필요 없으면 NULL
+/// @note qn_job_update_main 이나 메인 스레드의 qn_job_wait 에서 처리된다
+QSAPI void qn_job_run_main(QnJobSystem* self, QnJobFunc func, void* data, QnJobCounter* counter);
+
+/// @brief 메인 스레드 전용 작업을 모두 처리한다. 메인 스레드에서 불러야 한다
+/// @param self 작업 시스템
+/// @return 처리한 작업 갯수
+QSAPI int qn_job_update_main(QnJobSystem* self);
+
+/// @brief 카운터가 0이 될 때까지 다른 작업을 도우며 기다린다
+/// @param self 작업 시스템
+/// @param counter 작업 카운터
+QSAPI void qn_job_wait(QnJobSystem* self, QnJobCounter* counter);
+
+/// @brief 카운터의 작업이 모두 끝났나 확인한다
+/// @param counter 작업 카운터
+/// @return 모두 끝났으면 참
+QSAPI bool qn_job_is_done(const QnJobCounter* counter);
+
+// parallel
+
+/// @brief 병렬 처리 콜백, [begin, end) 구간을 처리한다
+typedef void (*QnParallelFunc)(void* context, size_t begin, size_t end);
+
+/// @brief 논리 코어 갯수를 얻는다
+/// @return 코어 갯수 (최소 1)
+QSAPI uint qn_cpu_count(void);
+
+/// @brief 병렬 처리에 쓸 스레드 갯수를 정한다 (부르는 스레드 포함)
+/// @param count 스레드 갯수, 0이면 코어 갯수
+/// @note 갯수가 바뀌면 다음 병렬 처리 때 공용 작업 시스템을 다시 만든다. 이전 시스템은 런타임 내림 때 지운다
+QSAPI void qn_parallel_threads(uint count);
+
+/// @brief 병렬 처리에 쓰는 스레드 갯수를 얻는다 (부르는 스레드 포함)
+/// @return 스레드 갯수
+QSAPI uint qn_parallel_count(void);
+
+/// @brief [0, count) 구간을 grain 단위로 나눠 일꾼 스레드와 함께 처리한다. 다 끝나야 반환한다
+/// @param count 전체 갯수
+/// @param grain 한번에 처리할 갯수, 0이면 스레드 갯수에 맞춰 정한다
+/// @param func 처리 콜백
+/// @param context 콜백 콘텍스트
+/// @note 공용 작업 시스템에서 처리하므로 콜백 안에서 다시 불러도 된다
+QSAPI void qn_parallel_for(size_t count, size_t grain, QnParallelFunc func, void* context);
+
+/// @brief 병렬 정렬 (구간을 나눠 정렬한 다음 병렬로 병합, 안정 정렬은 아님)
+/// @param[in,out] ptr 정렬할 데이터의 포인터
+/// @param[in] count 데이터의 갯수
+/// @param[in] stride 데이터의 폭
+/// @param[in] compfunc 비교 연산 콜백 함수
+QSAPI void qn_parallel_sort(void* ptr, size_t count, size_t stride, cmpfunc_t compfunc);
+
+/// @brief 콘텍스트 입력 받는 병렬 정렬
+/// @param[in,out] ptr 정렬할 데이터의 포인터
+/// @param[in] count 데이터의 갯수
+/// @param[in] stride 데이터의 폭
+/// @param[in] compfunc 비교 연산 콜백 함수
+/// @param[in] context 콜백 함수용 콘텍스트
+QSAPI void qn_parallel_sortc(void* ptr, size_t count, size_t stride, cmpcfunc_t compfunc, void* context);
+
 // module
 
 /// @brief 모듈
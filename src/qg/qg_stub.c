@@ -724,6 +724,8 @@ bool qg_loop(void)
 		qn_timer_update(stub->timer);
 	}
 
+	qn_async_update();
+
 	const float adv = (float)stub->timer->elapsed;
 	stub->elapsed = adv;
 	stub->advance = QN_TMASK(stub->stats, QGSST_PAUSE) == false ? adv : 0.0f;
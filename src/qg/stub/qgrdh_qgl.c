@@ -1588,18 +1588,8 @@ static void qgl_batch_stream_clear(QglBatchStream* self)
 }
 
 // 텍스쳐 소트
-static int qgl_batch_stream_sort_texture(const void* a, const void* b)
-{
-	const QglBatchItem* ia = *(const QglBatchItem* const*)a;
-	const QglBatchItem* ib = *(const QglBatchItem* const*)b;
-#if false
-	return ia->gl_tex == ib->gl_tex ?
-		ia->index - ib->index :
-		(nint)ia->gl_tex - (nint)ib->gl_tex;
-#else
-	return (int)ia->gl_tex - (int)ib->gl_tex;
-#endif
-}
+#define QGL_BATCH_LESS_TEXTURE(a,b)		((*(a))->base.gl_tex < (*(b))->base.gl_tex)
+QN_DECLIMPL_SORT(qgl_batch_ortho, QglBatchItemOrtho*, QGL_BATCH_LESS_TEXTURE);
 
 // 평면 배치 만들기
 static QglBatchStream* qgl_create_batch_ortho(void)
@@ -1623,7 +1613,7 @@ static void qgl_batch_ortho_flush(QglBatchStream* batch)
 
 	// 텍스쳐 소트 및 그리기 설정
 	const size_t count = self->base.index;
-	qn_qsort(self->ptrs, count, sizeof(QglBatchItemOrtho*), qgl_batch_stream_sort_texture);
+	qgl_batch_ortho_sort(self->ptrs, count);
 
 	QglBuffer* vbuffer = self->base.vbuffer[self->base.vindex++];
 	if (self->base.vindex == QN_COUNTOF(self->base.vbuffer))
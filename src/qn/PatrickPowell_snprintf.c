@@ -71,6 +71,7 @@
 * qn version
 *    integer types are referenced from stdint.h
 *    add external output
+*    floating point digits and rounding from qn_num_digits (e, f, g are exact now)
 **************************************************************/
 
 #include "pch.h"
@@ -131,31 +132,6 @@ extern const byte* qn_num_base_table(void);
 extern const char* qn_char_base_table(bool upper);
 #define char_to_int(p)	(int)((p) - '0')
 
-//
-INLINE double pps_pow10(int exp)
-{
-	double result = 1;
-	while (exp > 0)
-	{
-		result *= 10;
-		exp--;
-	}
-	while (exp < 0)
-	{
-		result /= 10;
-		exp++;
-	}
-	return result;
-}
-
-//
-INLINE double pps_round(double value)
-{
-	const ullong intpart = (ullong)value;
-	value = value - (double)intpart;
-	return (double)(value >= 0.5 ? intpart + 1 : intpart);
-}
-
 //
 INLINE bool pps_isnan(const double value)
 {
@@ -169,25 +145,6 @@ INLINE bool pps_isinf(const double value)
 	return value != 0.0 && value + value == value;
 }
 
-//
-INLINE int pps_exponent(const double value)
-{
-	double d = value < 0.0 ? -value : value;
-	int exp = 0;
-	while (d < 1.0 && d > 0.0 && --exp > -99) d *= 10;
-	while (d >= 10.0 && ++exp < 99) d /= 10;
-	return exp;
-}
-
-//
-INLINE ullong pps_intpart(const double value)
-{
-	if (value >= (double)UINT64_MAX)
-		return UINT64_MAX;
-	const ullong res = (ullong)value;
-	return (const double)res <= value ? res : res - 1;
-}
-
 
 //////////////////////////////////////////////////////////////////////////
 // 아스키 버전
@@ -199,34 +156,6 @@ INLINE ullong pps_intpart(const double value)
 #define pps_size_t		pps_int32
 #endif
 
-// 32비트 숫자를 문자열로
-static size_t pps_atoi(uint value, char* buf, size_t size, nuint base, bool caps)
-{
-	const char* table = qn_char_base_table(caps);
-	size_t pos = 0;
-	do
-	{
-		buf[pos++] = table[value % (uint)base];
-		value /= (uint)base;
-	} while (value && pos < size);
-	buf[pos] = '\0';
-	return pos;
-}
-
-// 64비트 숫자를 문자열로
-static size_t pps_atoll(ullong value, char* buf, size_t size, nuint base, bool caps)
-{
-	const char* table = qn_char_base_table(caps);
-	size_t pos = 0;
-	do
-	{
-		buf[pos++] = table[value % base];
-		value /= base;
-	} while (value && pos < size);
-	buf[pos] = '\0';
-	return pos;
-}
-
 // 숫자 분리 (보통 천단위 통화 분리자, 한자 문화권은 만단위가 좋은데)
 static nint pps_quote(nint value, int flags, const LOCALE_TYPE* lc)
 {
@@ -336,6 +265,7 @@ static void pps_int32(PatrickPowellSprintfState* state, int flags, const LOCALE_
 #define MAX_CONVERT_PLACES 40
 	uint uvalue;
 	char convert[MAX_CONVERT_PLACES];
+	const char* digits;
 	char hexprefix;
 	char signvalue;
 	nint place;
@@ -355,7 +285,7 @@ static void pps_int32(PatrickPowellSprintfState* state, int flags, const LOCALE_
 	{
 		if (state->value.i < 0)
 		{
-			uvalue = (uint)-state->value.i;
+			uvalue = 0U - (uint)state->value.i;
 			signvalue = '-';
 		}
 		else
@@ -370,7 +300,8 @@ static void pps_int32(PatrickPowellSprintfState* state, int flags, const LOCALE_
 		}
 	}
 
-	place = (nint)pps_atoi(uvalue, convert, MAX_CONVERT_PLACES - 1, state->base, flags & DP_F_UP);
+	digits = qn_num_utoa(convert + MAX_CONVERT_PLACES, uvalue, (uint)state->base, flags & DP_F_UP);
+	place = convert + MAX_CONVERT_PLACES - digits;
 
 	// '#'이 있을때 접두사 처리
 	if (!((flags & DP_F_NUM) && uvalue != 0))
@@ -430,12 +361,11 @@ static void pps_int32(PatrickPowellSprintfState* state, int flags, const LOCALE_
 	}
 
 	// 숫자
-	while (place > 0)
+	for (nint i = 0; i < place; i++)
 	{
-		--place;
-		state->outch(state, convert[place]);
-
-		if (quote && place > 0 && (place % 3) == 0)
+		state->outch(state, digits[i]);
+		const nint left = place - 1 - i;
+		if (quote && left > 0 && (left % 3) == 0)
 		{
 #if USE_LOCALE_INFO
 			if (!lc->thousands_sep)
@@ -464,6 +394,7 @@ static void pps_int64(PatrickPowellSprintfState* state, int flags, const LOCALE_
 #define MAX_CONVERT_PLACES 80
 	ullong uvalue;
 	char convert[MAX_CONVERT_PLACES];
+	const char* digits;
 	char hexprefix;
 	char signvalue;
 	nint place;
@@ -483,7 +414,7 @@ static void pps_int64(PatrickPowellSprintfState* state, int flags, const LOCALE_
 	{
 		if (state->value.ll < 0)
 		{
-			uvalue = (ullong)-state->value.ll;
+			uvalue = 0ULL - (ullong)state->value.ll;
 			signvalue = '-';
 		}
 		else
@@ -498,7 +429,8 @@ static void pps_int64(PatrickPowellSprintfState* state, int flags, const LOCALE_
 		}
 	}
 
-	place = (nint)pps_atoll(uvalue, convert, MAX_CONVERT_PLACES - 1, state->base, flags & DP_F_UP);
+	digits = qn_num_utoa(convert + MAX_CONVERT_PLACES, uvalue, (uint)state->base, flags & DP_F_UP);
+	place = convert + MAX_CONVERT_PLACES - digits;
 
 	// '#'이 있을때 접두사 처리
 	if (!((flags & DP_F_NUM) && uvalue != 0))
@@ -561,12 +493,11 @@ static void pps_int64(PatrickPowellSprintfState* state, int flags, const LOCALE_
 	}
 
 	// 숫자
-	while (place > 0)
+	for (nint i = 0; i < place; i++)
 	{
-		--place;
-		state->outch(state, convert[place]);
-
-		if (quote && place > 0 && (place % 3) == 0)
+		state->outch(state, digits[i]);
+		const nint left = place - 1 - i;
+		if (quote && left > 0 && (left % 3) == 0)
 		{
 #if USE_LOCALE_INFO
 			if (!lc->thousands_sep)
@@ -590,29 +521,22 @@ static void pps_int64(PatrickPowellSprintfState* state, int flags, const LOCALE_
 }
 
 // 64비트 실수(double)
-// 여기서는, 오직 16자리 정수만 지원. 원래는 9, 19, 38 자리수에 따라 각각 32, 64, 128비트용이 있어야함
+// 숫자는 qn_num_digits에서 반올림까지 끝내서 받고 (가장 짧은 값에서 바로, 안되면 정확한 값으로), 여기서는 모양만 만든다
 static void pps_double(PatrickPowellSprintfState* state, int flags, const LOCALE_TYPE* lc)
 {
-	double fvalue;
-	double uvalue;
-	ullong intpart;
-	ullong fracpart;
-	ullong mask;
-	char iconvert[311];
-	char fconvert[311];
-	char econvert[10];
+	char digits[QN_NUM_DIGITS_SIZE];
+	char econvert[16];
+	const char* epsz;
 	char signvalue;
 	nint iplace;
-	nint fplace;
 	nint eplace;
+	nint prec;
 	nint padlen;
-	nint zleadfrac;
 	nint dotpoint;
 	nint quote;
-	nint etype;
-	int exponent;
-	int omitzeros;
-	nint omitcount;
+	int point;
+	int ndigits;
+	bool etype;
 	const char* psz;
 
 	/*
@@ -622,8 +546,8 @@ static void pps_double(PatrickPowellSprintfState* state, int flags, const LOCALE
 	if (state->vmax < 0)
 		state->vmax = 6;
 
-	fvalue = state->value.d;
-	if (fvalue < 0)
+	const double fvalue = state->value.d;
+	if (signbit(fvalue))
 		signvalue = '-';
 	else if (flags & DP_F_PLUS) // 부호추가 (+/i)
 		signvalue = '+';
@@ -644,131 +568,72 @@ static void pps_double(PatrickPowellSprintfState* state, int flags, const LOCALE
 	{
 		iplace = 0;
 		if (signvalue)
-			iconvert[iplace++] = signvalue;
+			digits[iplace++] = signvalue;
 		while (*psz)
-			iconvert[iplace++] = *psz++;
-		iconvert[iplace] = '\0';
+			digits[iplace++] = *psz++;
+		digits[iplace] = '\0';
 
 		state->vmax = iplace;
-		pps_puts(state, iconvert, iplace, flags);
+		pps_puts(state, digits, iplace, flags);
 		return;
 	}
 
-	// 지수 모양 처리
-	if (flags & (DP_F_E | DP_F_G))
+	// 숫자 만들기
+	prec = state->vmax;
+	if (flags & DP_F_G)
 	{
-		if (flags & DP_F_G)
+		// 유효 숫자로 반올림하고 나서 지수를 보고 모양을 고른다
+		ndigits = qn_num_digits(fvalue, (int)prec, false, digits, &point);
+		const int exponent = point - 1;
+		etype = exponent < -4 || exponent >= prec;
+		prec -= etype ? 1 : 1 + exponent;
+		if (!(flags & DP_F_NUM))
 		{
-			--state->vmax;
-			omitzeros = !(flags & DP_F_NUM);
+			// 끝의 0은 빼고
+			const nint frac = etype ? ndigits - 1 : ndigits - point;
+			prec = QN_MIN(prec, QN_MAX(frac, 0));
 		}
-		else
-			omitzeros = 0;
-		exponent = pps_exponent(fvalue);
-		etype = 1;
 	}
-	else
+	else if (flags & DP_F_E)
 	{
-		exponent = 0;
-		omitzeros = 0;
-		etype = 0;
+		ndigits = qn_num_digits(fvalue, (int)prec + 1, false, digits, &point);
+		etype = true;
 	}
-
-pos_exp_again: // 이 루프는 확실한 반올림 지수를 얻기 위함 -> '%g'
-	if (state->vmax > 16)
-		state->vmax = 16;
-
-	// 정수로 변환
-	uvalue = QN_ABS(fvalue);
-	if (etype)
-		uvalue /= pps_pow10(exponent);
-	intpart = pps_intpart(uvalue);
-	mask = (ullong)pps_pow10((int)state->vmax);  // NOLINT(clang-diagnostic-bad-function-cast)
-	fracpart = (ullong)pps_round((double)mask * (uvalue - (double)intpart));  // NOLINT(clang-diagnostic-bad-function-cast)
-
-	if (fracpart >= mask)
-	{
-		// 예를 들면 uvalue=1.99952, intpart=2, temp=1000 (max=3 이므로)
-		// pps_round(1000*0.99952)=1000. 그리하여, 정수부는 1증가, 실수부는 0으로 함.
-		intpart++;
-		fracpart = 0;
-
-		if (etype && intpart == 10)
-		{
-			intpart = 1;
-			exponent++;
-		}
-	}
-
-	// 정확한 지수를 얻음. '%g'를 위한 지수를 재계산
-	if (etype && (flags & DP_F_G) && (state->vmax + 1) > exponent && exponent >= -4)
+	else
 	{
-		state->vmax -= exponent;
-		etype = 0;
-		goto pos_exp_again;
+		ndigits = qn_num_digits(fvalue, (int)prec, true, digits, &point);
+		etype = false;
 	}
 
+	// 지수 (MSVC는 3자리를 쓰지만 여기서는 2자리부터)
 	if (etype)
 	{
-		char esignvalue;
-		if (exponent < 0)
-		{
-			exponent = -exponent;
-			esignvalue = '-';
-		}
-		else
-			esignvalue = '+';
-
-		eplace = (nint)pps_atoi((uint)exponent, econvert, 2, 10, false);
-
-		if (eplace == 1)
-		{
-			// MSVC는 자리수를 3자리 씀. (001+E)
-			// 여기서는 2자리만. (01+E)
-			econvert[eplace++] = '0';
-		}
-		econvert[eplace++] = esignvalue;
-		econvert[eplace++] = flags & DP_F_UP ? 'E' : 'e';
-		econvert[eplace] = '\0';
+		const int exponent = point - 1;
+		char* end = econvert + QN_COUNTOF(econvert);
+		char* s = qn_num_utoa(end, (ullong)(exponent < 0 ? -exponent : exponent), 10, false);
+		if (end - s < 2)
+			*--s = '0';
+		*--s = exponent < 0 ? '-' : '+';
+		*--s = flags & DP_F_UP ? 'E' : 'e';
+		epsz = s;
+		eplace = end - s;
+		iplace = 1;
 	}
 	else
-		eplace = 0;
-
-	// 정수부 처리
-	iplace = (nint)pps_atoll(intpart, iconvert, 311 - 1, 10, false);
-
-	// 실수부 처리
-	// iplace=1 이면 fracpart==0 임.
-	fplace = fracpart == 0 ? 0 : (nint)pps_atoll(fracpart, fconvert, 311 - 1, 10, false);
-
-	// 지수부 처리
-	zleadfrac = state->vmax - fplace;
-
-	omitcount = 0;
-	if (omitzeros)
 	{
-		if (fplace > 0)
-		{
-			while (omitcount < fplace && fconvert[omitcount] == '0')
-				omitcount++;
-		}
-		else
-		{
-			// 실수부가 0, 걍 무시함
-			omitcount = state->vmax;
-			zleadfrac = 0;
-		}
-		state->vmax -= omitcount;
+		epsz = NULL;
+		eplace = 0;
+		iplace = QN_MAX(point, 1);
 	}
 
 	// 실수부가 0이 아니고, '#' 플래그가 있으면 정수 포인트 출력
-	dotpoint = state->vmax > 0 || (flags & DP_F_NUM);
+	dotpoint = prec > 0 || (flags & DP_F_NUM);
 
 	//
 	quote = pps_quote(iplace, flags, lc);
 
 	// -1은 정수 포인트용, 부호를 출력하면 추가로 -1;
-	padlen = state->vmin - iplace - eplace - state->vmax - quote - (dotpoint ? 1 : 0) - (signvalue ? 1 : 0);
+	padlen = state->vmin - iplace - eplace - prec - quote - (dotpoint ? 1 : 0) - (signvalue ? 1 : 0);
 	if (padlen < 0)
 		padlen = 0;
 	if (flags & DP_F_MINUS)
@@ -801,11 +666,11 @@ pos_exp_again: // 이 루프는 확실한 반올림 지수를 얻기 위함 -> '
 		state->outch(state, signvalue);
 
 	// 정수부 출력
-	while (iplace > 0)
+	for (nint i = 0; i < iplace; i++)
 	{
-		--iplace;
-		state->outch(state, iconvert[iplace]);
-		if (quote && iplace > 0 && (iplace % 3) == 0)
+		state->outch(state, (etype || i < point) && i < ndigits ? digits[i] : '0');
+		const nint left = iplace - 1 - i;
+		if (quote && left > 0 && (left % 3) == 0)
 		{
 #if USE_LOCALE_INFO
 			if (!lc->thousands_sep)
@@ -833,20 +698,16 @@ pos_exp_again: // 이 루프는 확실한 반올림 지수를 얻기 위함 -> '
 #endif
 	}
 
-	// 실수부 앞쪽 패딩
-	while (zleadfrac > 0)
-	{
-		state->outch(state, '0');
-		--zleadfrac;
-	}
-
-	// 실수부
-	while (fplace > omitcount)
-		state->outch(state, fconvert[--fplace]);
+	// 실수부, 숫자가 모자라면 0
+	for (nint i = 0, at = (etype ? 1 : point); i < prec; i++, at++)
+		state->outch(state, at >= 0 && at < ndigits ? digits[at] : '0');
 
 	// 지수값
 	while (eplace > 0)
-		state->outch(state, econvert[--eplace]);
+	{
+		state->outch(state, *epsz++);
+		--eplace;
+	}
 
 	// 남은 패팅
 	while (padlen < 0)
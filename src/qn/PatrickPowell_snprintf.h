@@ -134,5 +134,10 @@ struct PATRICKPOWELL_SNPRINTF_STATE
 	};
 };
 
+// 숫자 변환 (qn_str.c)
+#define QN_NUM_DIGITS_SIZE	800		// qn_num_digits 숫자 버퍼 크기, double의 정확한 숫자는 767자리까지
+extern char* qn_num_utoa(char* end, ullong value, uint base, bool upper);
+extern int qn_num_digits(double value, int count, bool fixed, char* digits, int* point);
+
 //
 extern void dopr(_In_ PatrickPowellSprintfState* state, _In_ const char* format, _In_ va_list args);
@@ -6,6 +6,8 @@
 #include "pch.h"
 #ifdef _QN_UNIX_
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/uio.h>
 #endif
 #ifdef _QN_EMSCRIPTEN_
 #include <emscripten/console.h>
@@ -23,20 +25,27 @@ extern void qn_module_up(void);
 extern void qn_module_down(void);
 extern void qn_thread_up(void);
 extern void qn_thread_down(void);
+extern void qn_crc_up(void);
+extern void qn_str_up(void);
+extern void qn_job_down(void);
+extern void qn_async_down(void);
+extern void qn_stream_down(void);
 
 struct PROPDATA;
-static nint _sym_set(const char* name);
 static void _prop_data_dispose(struct PROPDATA* data);
 static void _prop_set(nint key, const char* value);
+static void _log_down(void);
 
-// 심볼
-typedef struct SYMDATA
+// 아톰 표. 열린 주소 해시로 찾고 번호 배열을 같이 갖는다. 늘릴 때는 새 표를 게시하고
+// 지난 표는 읽는 쪽이 아직 쓸 수 있으므로 아레나에 남겨 두었다가 런타임을 내릴 때 해제한다
+typedef struct ATOMTABLE
 {
-	char			key[64];
-	nint			value;
-} SymData;
-QN_DECLIMPL_MUKUM(SymMukum, char*, SymData, qn_strphash, qn_strpcmp, (void), (void), _sym_mukum);
-QN_DECLIMPL_ARRAY(SymArray, SymMukumNode*, _sym_array);
+	size_t			mask;
+	volatile nint*	slots;				// 아톰, 칸 수는 mask + 1
+	volatile nint*	ids;				// 번호 - 1 순서의 아톰, 칸 수는 (mask + 1) / 2
+} AtomTable;
+#define ATOM_MIN_SLOT	256
+static AtomTable* _atom_table_new(size_t size);
 
 // 프로퍼티
 typedef struct PROPDATA
@@ -67,13 +76,13 @@ static struct RUNTIMEIMPL
 	Closure*		closures;
 	Closure*		preclosures;
 
-	SymMukum		symbols;
-	SymArray		symarray;
+	QnArena*		atoms;
+	AtomTable* volatile	atomtable;
+	size_t			atomcount;
+	QnSpinLock		atomlock;
 	PropMukum		props;
 
 	char			tag[32];
-	char			out_buf[MAX_DEBUG_LENGTH];
-	nint			out_pos;
 
 #ifdef _QN_WINDOWS_
 	HANDLE			fd;
@@ -118,10 +127,15 @@ static void qn_runtime_down(void)
 	}
 	QN_UNLOCK(runtime_impl.lock);
 
-	_sym_mukum_dispose(&runtime_impl.symbols);
-	_sym_array_dispose(&runtime_impl.symarray);
 	_prop_mukum_dispose(&runtime_impl.props);
-
+	runtime_impl.atomtable = NULL;
+	runtime_impl.atomcount = 0;
+	qn_delete_arena(runtime_impl.atoms);
+
+	qn_async_down();
+	qn_job_down();
+	_log_down();
+	qn_stream_down();
 	qn_thread_down();
 	qn_module_down();
 	qn_mpf_down();
@@ -156,16 +170,17 @@ static void qn_runtime_up(void)
 	qn_mpf_up();
 	qn_module_up();
 	qn_thread_up();
+	qn_crc_up();
+	qn_str_up();
 	qn_srand(NULL, 0);
 
-	_sym_mukum_init_fast(&runtime_impl.symbols);
-	_sym_array_init_fast(&runtime_impl.symarray, 32);
+	runtime_impl.atoms = qn_new_arena(0);
+	runtime_impl.atomtable = _atom_table_new(ATOM_MIN_SLOT);
 	_prop_mukum_init_fast(&runtime_impl.props);
 
-	_sym_array_add(&runtime_impl.symarray, NULL);	// 심볼을 1번부터니깐 0을 채워 넣기 위함
-	_prop_set(_sym_set("QSLIB"), qn_version());
+	_prop_set(qn_sym("QSLIB"), qn_version());
 #define MAKE_BUILD_DATIME	__DATE__ " " __TIME__
-	_prop_set(_sym_set("KIM"), MAKE_BUILD_DATIME);
+	_prop_set(qn_sym("KIM"), MAKE_BUILD_DATIME);
 #undef MAKE_BUILD_DATIME
 
 #if defined _LIB || defined _STATIC
@@ -251,86 +266,149 @@ cham qn_p_debugger(void)
 	return runtime_impl.debugger;
 }
 
-//
-static nint _sym_set(const char* name)
+// 아톰 표 만들기, 아레나에서 할당한다
+static AtomTable* _atom_table_new(const size_t size)
 {
-	static nint sym = 1;
+	AtomTable* table = (AtomTable*)qn_arena_alloc(runtime_impl.atoms, sizeof(AtomTable), false);
+	table->mask = size - 1;
+	table->slots = (volatile nint*)qn_arena_alloc(runtime_impl.atoms, sizeof(nint) * size, true);
+	table->ids = (volatile nint*)qn_arena_alloc(runtime_impl.atoms, sizeof(nint) * (size / 2), true);
+	return table;
+}
 
-	SymMukumNode* node = qn_alloc_1(SymMukumNode);
-	node->VALUE.value = sym;
-	qn_strcpy(node->VALUE.key, name);
-	node->KEY = node->VALUE.key;
-	if (!_sym_mukum_add(&runtime_impl.symbols, node))
+// 아톰 찾기, 잠그지 않는다. 칸은 아톰을 다 만든 다음에 게시하므로 보이는 아톰은 다 만들어져 있다
+static QnAtom _atom_look(const AtomTable* table, const char* str, const size_t len, const size_t hash)
+{
+	for (size_t i = hash & table->mask;; i = (i + 1) & table->mask)
 	{
-		qn_free(node);
-		return 0;
+		const QnAtom atom = (QnAtom)qn_atomic_load(&table->slots[i]);
+		if (atom == NULL)
+			return NULL;
+		const QnAtomHead* head = qn_atom_head(atom);
+		if (head->hash == hash && head->len == len && memcmp(atom, str, len) == 0)
+			return atom;
 	}
-	_sym_array_add(&runtime_impl.symarray, node);
-
-	return sym++;
 }
 
-//
-static const char* _sym_get(nint value)
+// 빈 칸에 아톰 넣기
+static void _atom_table_put(AtomTable* table, const QnAtom atom)
 {
-	if ((size_t)value >= _sym_array_count(&runtime_impl.symarray))
-		return NULL;
-	return _sym_array_nth(&runtime_impl.symarray, value)->KEY;
+	size_t i = qn_atom_hash(atom) & table->mask;
+	while (table->slots[i] != 0)
+		i = (i + 1) & table->mask;
+	qn_atomic_store(&table->slots[i], (nint)atom);
 }
 
-//
-nint qn_sym(const char* name)
+// 아톰 표 늘리기, 잠근 상태에서 부른다
+static AtomTable* _atom_table_grow(const AtomTable* table)
 {
-	qn_return_when_fail(runtime_impl.inited, 0);
-	qn_return_when_fail(name != NULL, 0);
-	QN_LOCK(runtime_impl.lock);
-
-	SymData* ret = _sym_mukum_get(&runtime_impl.symbols, name);
-	if (ret != NULL)
+	AtomTable* grow = _atom_table_new((table->mask + 1) * 2);
+	for (size_t i = 0; i < runtime_impl.atomcount; i++)
 	{
-		QN_UNLOCK(runtime_impl.lock);
-		return ret->value;
+		const nint atom = table->ids[i];
+		grow->ids[i] = atom;
+		_atom_table_put(grow, (QnAtom)atom);
 	}
+	qn_atomic_store((volatile nint*)&runtime_impl.atomtable, (nint)grow);
+	return grow;
+}
 
-	size_t len = strlen(name);
-	if (len > 63)
+// 아톰 넣기, 잠그고 다시 찾아본 다음 없으면 만든다
+static QnAtom _atom_add(const char* str, const size_t len, const size_t hash)
+{
+	QN_LOCK(runtime_impl.atomlock);
+	AtomTable* table = runtime_impl.atomtable;
+	QnAtom atom = _atom_look(table, str, len, hash);
+	if (atom == NULL)
 	{
-		QN_UNLOCK(runtime_impl.lock);
-		return 0;
+		if (runtime_impl.atomcount >= (table->mask + 1) / 2)
+			table = _atom_table_grow(table);
+
+		QnAtomHead* head = (QnAtomHead*)qn_arena_alloc(runtime_impl.atoms, sizeof(QnAtomHead) + len + 1, false);
+		head->hash = hash;
+		head->len = (uint)len;
+		head->id = (uint)(runtime_impl.atomcount + 1);
+		char* data = (char*)(head + 1);
+		memcpy(data, str, len);
+		data[len] = '\0';
+		atom = data;
+
+		qn_atomic_store(&table->ids[runtime_impl.atomcount], (nint)atom);
+		_atom_table_put(table, atom);
+		qn_atomic_store((volatile nint*)&runtime_impl.atomcount, (nint)runtime_impl.atomcount + 1);
 	}
+	QN_UNLOCK(runtime_impl.atomlock);
+	return atom;
+}
 
-	const nint value = _sym_set(name);
-	QN_UNLOCK(runtime_impl.lock);
-	return value;
+//
+QnAtom qn_atomn(const char* str, const size_t len)
+{
+	qn_return_when_fail(runtime_impl.inited, NULL);
+	qn_return_when_fail(str != NULL && len < UINT_MAX, NULL);
+	const size_t hash = qn_strnhash(str, len);
+	const AtomTable* table = (const AtomTable*)qn_atomic_load((volatile nint*)&runtime_impl.atomtable);
+	const QnAtom atom = _atom_look(table, str, len, hash);
+	return atom != NULL ? atom : _atom_add(str, len, hash);
 }
 
 //
-const char* qn_symstr(nint value)
+QnAtom qn_atom(const char* str)
+{
+	qn_return_when_fail(str != NULL, NULL);
+	return qn_atomn(str, strlen(str));
+}
+
+//
+QnAtom qn_atom_find(const char* str)
 {
 	qn_return_when_fail(runtime_impl.inited, NULL);
-	QN_LOCK(runtime_impl.lock);
-	const char* ret = _sym_get(value);
-	QN_UNLOCK(runtime_impl.lock);
-	return ret;
+	qn_return_when_fail(str != NULL, NULL);
+	const size_t len = strlen(str);
+	const AtomTable* table = (const AtomTable*)qn_atomic_load((volatile nint*)&runtime_impl.atomtable);
+	return _atom_look(table, str, len, qn_strnhash(str, len));
+}
+
+//
+QnAtom qn_atom_from_id(const uint id)
+{
+	qn_return_when_fail(runtime_impl.inited, NULL);
+	const AtomTable* table = (const AtomTable*)qn_atomic_load((volatile nint*)&runtime_impl.atomtable);
+	qn_return_when_fail(id > 0 && id <= (table->mask + 1) / 2, NULL);
+	return (QnAtom)qn_atomic_load(&table->ids[id - 1]);
+}
+
+//
+size_t qn_atom_count(void)
+{
+	return (size_t)qn_atomic_load((const volatile nint*)&runtime_impl.atomcount);
+}
+
+//
+nint qn_sym(const char* name)
+{
+	const QnAtom atom = qn_atom(name);
+	return atom == NULL ? 0 : (nint)qn_atom_id(atom);
+}
+
+//
+const char* qn_symstr(nint value)
+{
+	qn_return_when_fail(value > 0 && value <= UINT_MAX, NULL);
+	return qn_atom_from_id((uint)value);
 }
 
 //
 void qn_sym_dbgout(void)
 {
 	qn_return_when_fail(runtime_impl.inited,/*void*/);
-	QN_LOCK(runtime_impl.lock);
+	QN_LOCK(runtime_impl.atomlock);
 	qn_mesgf("SYMBOL", " %-8s | %-s", "symbol", "string");
-#if false
-	SymMukumNode* node;
-	QN_MUKUM_FOREACH(runtime_impl.symbols, node)
-		qn_mesgf("SYMBOL", " %-8d | %-s", node->VALUE.value, node->KEY);
-#else
-	size_t i;
-	QN_ARRAY_FOREACH(runtime_impl.symarray, 1, i)
-		qn_mesgf("SYMBOL", " %-8d | %-s", i, _sym_array_nth(&runtime_impl.symarray, i)->KEY);
-#endif
-	qn_mesgf("SYMBOL", "total symbols: %zu", _sym_mukum_count(&runtime_impl.symbols));
-	QN_UNLOCK(runtime_impl.lock);
+	const AtomTable* table = runtime_impl.atomtable;
+	for (size_t i = 0; i < runtime_impl.atomcount; i++)
+		qn_mesgf("SYMBOL", " %-8zu | %-s", i + 1, (const char*)table->ids[i]);
+	qn_mesgf("SYMBOL", "total symbols: %zu", runtime_impl.atomcount);
+	QN_UNLOCK(runtime_impl.atomlock);
 }
 
 // 프로퍼티 데이터 지우기
@@ -385,11 +463,12 @@ void qn_set_prop(const char* name, const char* value)
 //
 const char* qn_get_prop(const char* name)
 {
-	nint key = qn_sym(name);
-	qn_return_when_fail(key != 0, NULL);
+	// 없는 이름으로 아톰을 만들지 않는다
+	const QnAtom atom = qn_atom_find(name);
+	qn_return_when_fail(atom != NULL, NULL);
 
 	QN_LOCK(runtime_impl.lock);
-	const char* ret = _prop_get(key);
+	const char* ret = _prop_get((nint)qn_atom_id(atom));
 	QN_UNLOCK(runtime_impl.lock);
 	return ret;
 }
@@ -422,7 +501,7 @@ void qn_prop_dbgout(void)
 	PropMukumNode* node;
 	QN_MUKUM_FOREACH(runtime_impl.props, node)
 	{
-		const char* name = _sym_get(node->KEY);
+		const char* name = qn_atom_from_id((uint)node->KEY);
 		if (node->VALUE.alloc)
 			qn_strncpy(node->VALUE.intern, node->VALUE.value, QN_COUNTOF(node->VALUE.intern) - 1);
 		qn_mesgf("PROP", " %s = %-s", name, node->VALUE.intern);
@@ -431,107 +510,511 @@ void qn_prop_dbgout(void)
 	QN_UNLOCK(runtime_impl.lock);
 }
 
+// 출력 버퍼, 부른 스레드 스택에 만든다
+typedef struct OUTBUF
+{
+	nint			pos;
+	char			data[MAX_DEBUG_LENGTH];
+} OutBuf;
+
 //
-static void _out_buf_ch(const int ch)
+static void _out_buf_ch(OutBuf* ob, const int ch)
 {
-	if (1 + runtime_impl.out_pos > MAX_DEBUG_LENGTH - 1)
+	if (1 + ob->pos > MAX_DEBUG_LENGTH - 1)
 		return;
-	runtime_impl.out_buf[runtime_impl.out_pos++] = (char)ch;
+	ob->data[ob->pos++] = (char)ch;
 }
 
 //
-static void _out_buf_str(const char* s)
+static void _out_buf_str(OutBuf* ob, const char* s)
 {
 	nint len = (nint)strlen(s);
-	if (len + runtime_impl.out_pos > MAX_DEBUG_LENGTH - 1)
-		len = MAX_DEBUG_LENGTH - runtime_impl.out_pos - 1;
+	if (len + ob->pos > MAX_DEBUG_LENGTH - 1)
+		len = MAX_DEBUG_LENGTH - ob->pos - 1;
 	if (len <= 0)
 		return;
-	memcpy(runtime_impl.out_buf + runtime_impl.out_pos, s, (size_t)len);
-	runtime_impl.out_pos += len;
+	memcpy(ob->data + ob->pos, s, (size_t)len);
+	ob->pos += len;
 }
 
 //
-static void _out_buf_va(const char* fmt, va_list va)
+static void _out_buf_va(OutBuf* ob, const char* fmt, va_list va)
 {
-	const int len = qn_vsnprintf(runtime_impl.out_buf + runtime_impl.out_pos, MAX_DEBUG_LENGTH - (size_t)runtime_impl.out_pos, fmt, va);
+	const int len = qn_vsnprintf(ob->data + ob->pos, MAX_DEBUG_LENGTH - (size_t)ob->pos, fmt, va);
 	if (len > 0)
-		runtime_impl.out_pos += len;
+		ob->pos = QN_MIN(ob->pos + len, MAX_DEBUG_LENGTH - 1);
 }
 
 //
-static void _out_buf_int(const int value)
+static void _out_buf_int(OutBuf* ob, const int value)
 {
-	const int len = qn_itoa(runtime_impl.out_buf + runtime_impl.out_pos, value, 10, true);
-	runtime_impl.out_pos += len;
+	const int len = qn_itoa(ob->data + ob->pos, value, 10, true);
+	ob->pos += len;
 }
 
 //
-static void _out_buf_head(const char* head)
+static void _out_buf_head(OutBuf* ob, const char* head)
 {
 	if (head == NULL)
 		return;
-	_out_buf_ch('[');
-	_out_buf_str(head);
-	_out_buf_str("] ");
+	_out_buf_ch(ob, '[');
+	_out_buf_str(ob, head);
+	_out_buf_str(ob, "] ");
 }
 
-//
-static nint _out_buf_flush(bool debug_output)
+#if defined _QN_WINDOWS_ || defined _QN_ANDROID_
+// 디버거나 안드로이드 로그로 보내기, 널로 끝나야 하니까 잘라서 보낸다
+static void _out_debug_chunk(const char* text, size_t len)
+{
+	char buf[MAX_DEBUG_LENGTH];
+	while (len > 0)
+	{
+		const size_t size = QN_MIN(len, sizeof(buf) - 1);
+		memcpy(buf, text, size);
+		buf[size] = '\0';
+#ifdef _QN_WINDOWS_
+		// 유니코드로 보내야할지 나중에 확인해보자
+		OutputDebugStringA(buf);
+#else
+		__android_log_write(ANDROID_LOG_VERBOSE, runtime_impl.tag, buf);
+#endif
+		text += size;
+		len -= size;
+	}
+}
+#endif
+
+// 바로 쓰기
+static void _out_write(const char* text, size_t len, bool debug_output)
 {
-	qn_return_when_fail(runtime_impl.out_pos > 0, 0);
-	runtime_impl.out_buf[runtime_impl.out_pos] = '\0';
 #ifdef _QN_WINDOWS_
 	if (runtime_impl.fd != NULL)
 	{
 		DWORD wtn;
 		if (runtime_impl.redirect ||
-			WriteConsoleA(runtime_impl.fd, runtime_impl.out_buf, (DWORD)runtime_impl.out_pos, &wtn, NULL) == 0)
-			WriteFile(runtime_impl.fd, runtime_impl.out_buf, (DWORD)runtime_impl.out_pos, &wtn, NULL);
+			WriteConsoleA(runtime_impl.fd, text, (DWORD)len, &wtn, NULL) == 0)
+			WriteFile(runtime_impl.fd, text, (DWORD)len, &wtn, NULL);
 	}
 	if (runtime_impl.debugger && debug_output)
-	{
-		// 유니코드로 보내야할지 나중에 확인해보자
-		OutputDebugStringA(runtime_impl.out_buf);
-	}
+		_out_debug_chunk(text, len);
 #else
 	if (runtime_impl.fd != STDIN_FILENO)
-		write(runtime_impl.fd, runtime_impl.out_buf, (size_t)runtime_impl.out_pos);
+		write(runtime_impl.fd, text, len);
 #ifdef __EMSCRIPTEN__
 	// 콘솔에 두번 나오니깐 한번만 출력하자
 	//if (debug_output)
-	//	emscripten_console_log(runtime_impl.out_buf);
+	//	emscripten_console_log(text);
 #endif
 #ifdef _QN_ANDROID_
 	if (debug_output)
-		__android_log_print(ANDROID_LOG_VERBOSE, runtime_impl.tag, runtime_impl.out_buf);
+		_out_debug_chunk(text, len);
 #endif
 #endif
-	const nint ret = runtime_impl.out_pos;
-	runtime_impl.out_pos = 0;
-	return ret;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// 비동기 로그
+// 스레드마다 링 버퍼에 넣고, 내보내는 스레드가 모아서 한번에 쓴다
+
+#define LOG_RING_SIZE		(64 * 1024)		// 스레드마다 링 크기, 2의 거듭제곱
+#define LOG_BATCH_MAX		64				// 한번에 모아 쓰는 조각 수
+#define LOG_IDLE_WAIT		10				// 할 일이 없을 때 기다리는 시간 (밀리초)
+
+// 로그 링. 쓰는 스레드 하나와 내보내는 스레드 하나만 만지니까 잠그지 않는다
+typedef struct LOGRING
+{
+	struct LOGRING*	next;
+	volatile nint	head;				// 여기까지 넣었다, 쓰는 스레드만 바꾼다
+	volatile nint	tail;				// 여기까지 내보냈다, 내보내는 스레드만 바꾼다
+	bool			alive;				// 쓰는 스레드가 살아 있다
+	char			data[LOG_RING_SIZE];
+} LogRing;
+
+// 모아 쓸 조각
+typedef struct LOGCHUNK
+{
+	const char*		data;
+	size_t			size;
+} LogChunk;
+
+// 로그 구현
+static struct LOGIMPL
+{
+	LogRing*		rings;				// 한번 만든 링은 런타임이 내려갈 때까지 둔다
+	QnThread*		thread;
+	QnMutex*		lock;
+	QnCond*			wake;				// 내보내는 스레드 깨우기
+	QnCond*			idle;				// 한바퀴 다 내보냈다
+	volatile nint	active;				// 비동기로 쓰는 중
+	volatile nint	sleeping;			// 내보내는 스레드가 자려고 한다
+	volatile nint	level;				// 이보다 낮은 로그는 버린다
+	volatile nint	producers;			// 링에 넣고 있는 스레드 수
+	volatile nint	generation;			// 런타임을 내릴 때마다 늘려서 스레드에 남은 링을 버린다
+	bool			quit;
+#ifndef QS_NO_SPINLOCK
+	QnSpinLock		ring_lock;
+#endif
+} log_impl =
+{
+	.level = QNLOG_TRACE,
+};
+
+// 지금 스레드의 링, 세대가 다르면 이미 해제한 링이다
+static THREADLOCAL LogRing* log_ring = NULL;
+static THREADLOCAL nint log_ring_gen = 0;
+
+// 지금 스레드의 링을 얻는다. 없으면 끝난 스레드의 링을 물려받거나 새로 만든다
+static LogRing* _log_ring(void)
+{
+	LogRing* ring = log_ring;
+	const nint gen = qn_atomic_load(&log_impl.generation);
+	if (ring != NULL && log_ring_gen == gen)
+		return ring;
+
+	QN_LOCK(log_impl.ring_lock);
+	for (ring = log_impl.rings; ring; ring = ring->next)
+	{
+		if (ring->alive == false)
+			break;
+	}
+	if (ring == NULL)
+	{
+		ring = qn_alloc_1(LogRing);
+		ring->head = ring->tail = 0;
+		ring->next = log_impl.rings;
+		qn_atomic_store((volatile nint*)&log_impl.rings, (nint)ring);
+	}
+	ring->alive = true;
+	QN_UNLOCK(log_impl.ring_lock);
+
+	log_ring = ring;
+	log_ring_gen = gen;
+	return ring;
+}
+
+// 스레드가 끝날 때 링을 반납한다. 남은 로그는 내보내는 스레드가 마저 쓴다
+void qn_log_thread_exit(void)
+{
+	LogRing* ring = log_ring;
+	qn_return_when_fail(ring != NULL && log_ring_gen == qn_atomic_load(&log_impl.generation),/*void*/);
+	log_ring = NULL;
+
+	QN_LOCK(log_impl.ring_lock);
+	ring->alive = false;
+	QN_UNLOCK(log_impl.ring_lock);
+}
+
+// 내보내는 스레드 깨우기
+static void _log_wake(void)
+{
+	qn_mutex_enter(log_impl.lock);
+	qn_cond_signal(log_impl.wake);
+	qn_mutex_leave(log_impl.lock);
+}
+
+// 링에 넣기 시작, 비동기가 아니면 거짓
+static bool _log_enter(void)
+{
+	qn_atomic_add(&log_impl.producers, 1);
+	qn_atomic_fence();
+	if (qn_atomic_load(&log_impl.active) != 0)
+		return true;
+	qn_atomic_add(&log_impl.producers, -1);
+	return false;
+}
+
+// 링에 넣기 끝
+INLINE void _log_leave(void)
+{
+	qn_atomic_add(&log_impl.producers, -1);
+}
+
+// 링에 넣기, 자리가 없으면 내보낼 때까지 기다린다
+// 기다리는 동안 비동기를 끄면 거짓을 반환하고 부른 쪽이 바로 쓴다
+static bool _log_push(const char* text, size_t size)
+{
+	LogRing* ring = _log_ring();
+	const size_t head = (size_t)ring->head;
+	while (LOG_RING_SIZE - (head - (size_t)qn_atomic_load(&ring->tail)) < size)
+	{
+		if (qn_atomic_load(&log_impl.active) == 0 || log_impl.quit)
+			return false;
+		_log_wake();
+		qn_sleep(0);
+	}
+
+	const size_t at = head & (LOG_RING_SIZE - 1);
+	const size_t first = QN_MIN(size, LOG_RING_SIZE - at);
+	memcpy(ring->data + at, text, first);
+	memcpy(ring->data, text + first, size - first);
+	qn_atomic_store(&ring->head, (nint)(head + size));
+
+	// 자려는 참이면 깨운다. 바쁠 때는 잠그지 않고 넣기만 한다
+	qn_atomic_fence();
+	if (qn_atomic_load(&log_impl.sleeping) != 0)
+		_log_wake();
+	return true;
+}
+
+// 이 스레드 링에 남은 게 다 나갈 때까지 기다린다. 바로 쓰기 전에 불러서 순서를 지킨다
+static void _log_wait_own(void)
+{
+	const LogRing* ring = log_ring;
+	if (ring == NULL || log_ring_gen != qn_atomic_load(&log_impl.generation))
+		return;
+	while (qn_atomic_load(&ring->tail) != ring->head)
+		qn_sleep(0);
+}
+
+// 남은 로그가 있나
+static bool _log_pending(void)
+{
+	for (const LogRing* ring = (LogRing*)qn_atomic_load((volatile nint*)&log_impl.rings); ring; ring = ring->next)
+	{
+		if (qn_atomic_load(&ring->head) != ring->tail)
+			return true;
+	}
+	return false;
+}
+
+// 조각을 한번에 쓴다
+static void _log_write_chunks(const LogChunk* chunks, size_t count)
+{
+#ifdef _QN_UNIX_
+	struct iovec vec[LOG_BATCH_MAX];
+	for (size_t i = 0; i < count; i++)
+	{
+		vec[i].iov_base = (void*)chunks[i].data;
+		vec[i].iov_len = chunks[i].size;
+	}
+	size_t first = 0;
+	while (first < count && runtime_impl.fd != STDIN_FILENO)
+	{
+		ssize_t wtn = writev(runtime_impl.fd, vec + first, (int)(count - first));
+		if (wtn < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		// 덜 썼으면 남은 데서부터
+		while (first < count && (size_t)wtn >= vec[first].iov_len)
+			wtn -= (ssize_t)vec[first++].iov_len;
+		if (first < count)
+		{
+			vec[first].iov_base = (char*)vec[first].iov_base + wtn;
+			vec[first].iov_len -= (size_t)wtn;
+		}
+	}
+#ifdef _QN_ANDROID_
+	for (size_t i = 0; i < count; i++)
+		_out_debug_chunk(chunks[i].data, chunks[i].size);
+#endif
+#else
+	for (size_t i = 0; i < count; i++)
+		_out_write(chunks[i].data, chunks[i].size, true);
+#endif
+}
+
+// 링마다 쌓인 걸 모아서 쓴다. 쓴 바이트 수를 반환
+static size_t _log_drain(void)
+{
+	LogChunk chunks[LOG_BATCH_MAX];
+	LogRing* rings[LOG_BATCH_MAX / 2];
+	size_t heads[LOG_BATCH_MAX / 2];
+	size_t count = 0, n = 0, total = 0;
+	for (LogRing* ring = (LogRing*)qn_atomic_load((volatile nint*)&log_impl.rings); ring && n < QN_COUNTOF(rings); ring = ring->next)
+	{
+		const size_t tail = (size_t)ring->tail;
+		const size_t head = (size_t)qn_atomic_load(&ring->head);
+		if (head == tail)
+			continue;
+		const size_t size = head - tail;
+		const size_t at = tail & (LOG_RING_SIZE - 1);
+		const size_t first = QN_MIN(size, LOG_RING_SIZE - at);
+		chunks[count++] = (LogChunk){ ring->data + at, first };
+		if (size > first)
+			chunks[count++] = (LogChunk){ ring->data, size - first };
+		rings[n] = ring;
+		heads[n++] = head;
+		total += size;
+	}
+	if (n == 0)
+		return 0;
+
+	_log_write_chunks(chunks, count);
+	for (size_t i = 0; i < n; i++)
+		qn_atomic_store(&rings[i]->tail, (nint)heads[i]);
+	return total;
+}
+
+// 내보내는 스레드
+static void* _log_flusher(void* data)
+{
+	QN_DUMMY(data);
+	for (;;)
+	{
+		if (_log_drain() > 0)
+			continue;
+		qn_mutex_enter(log_impl.lock);
+		qn_cond_broadcast(log_impl.idle);
+		if (log_impl.quit)
+		{
+			qn_mutex_leave(log_impl.lock);
+			break;
+		}
+		qn_atomic_exchange(&log_impl.sleeping, 1);
+		if (_log_pending() == false)
+			qn_cond_wait_for(log_impl.wake, log_impl.lock, LOG_IDLE_WAIT);
+		qn_atomic_store(&log_impl.sleeping, 0);
+		qn_mutex_leave(log_impl.lock);
+	}
+	while (_log_drain() > 0)
+		;
+	return NULL;
+}
+
+//
+bool qn_log_async(bool enable)
+{
+	if (enable == (qn_atomic_load(&log_impl.active) != 0))
+		return true;
+
+	if (enable)
+	{
+		if (log_impl.lock == NULL)
+		{
+			log_impl.lock = qn_new_mutex();
+			log_impl.wake = qn_new_cond();
+			log_impl.idle = qn_new_cond();
+		}
+		log_impl.quit = false;
+		log_impl.thread = qn_new_thread("QN LOG", _log_flusher, NULL, 0, 0);
+		if (log_impl.thread == NULL)
+			return false;
+		if (qn_thread_start(log_impl.thread) == false)
+		{
+			qn_delete_thread(log_impl.thread);
+			log_impl.thread = NULL;
+			return false;
+		}
+		qn_atomic_store(&log_impl.active, 1);
+		return true;
+	}
+
+	// 넣던 스레드가 다 넣을 때까지 기다렸다가, 남은 걸 다 쓰고 스레드를 끝낸다
+	qn_atomic_store(&log_impl.active, 0);
+	qn_atomic_fence();
+	while (qn_atomic_load(&log_impl.producers) != 0)
+	{
+		_log_wake();
+		qn_sleep(0);
+	}
+	qn_mutex_enter(log_impl.lock);
+	log_impl.quit = true;
+	qn_cond_signal(log_impl.wake);
+	qn_mutex_leave(log_impl.lock);
+	qn_delete_thread(log_impl.thread);
+	log_impl.thread = NULL;
+	return true;
+}
+
+//
+void qn_log_flush(void)
+{
+	qn_return_when_fail(qn_atomic_load(&log_impl.active) != 0,/*void*/);
+	qn_mutex_enter(log_impl.lock);
+	while (_log_pending())
+	{
+		qn_cond_signal(log_impl.wake);
+		qn_cond_wait_for(log_impl.idle, log_impl.lock, LOG_IDLE_WAIT);
+	}
+	qn_mutex_leave(log_impl.lock);
+}
+
+//
+void qn_log_set_level(QnLogLevel level)
+{
+	qn_atomic_store(&log_impl.level, (nint)level);
+}
+
+//
+QnLogLevel qn_log_get_level(void)
+{
+	return (QnLogLevel)qn_atomic_load(&log_impl.level);
+}
+
+// 런타임 내림에서 부른다
+static void _log_down(void)
+{
+	qn_log_async(false);
+	if (log_impl.lock != NULL)
+	{
+		qn_delete_cond(log_impl.wake);
+		qn_delete_cond(log_impl.idle);
+		qn_delete_mutex(log_impl.lock);
+		log_impl.lock = NULL;
+	}
+	// 다른 스레드에 남은 링은 세대를 바꿔서 다시 쓰지 않게 한다
+	qn_atomic_add(&log_impl.generation, 1);
+	for (LogRing *next, *ring = log_impl.rings; ring; ring = next)
+	{
+		next = ring->next;
+		qn_free(ring);
 	}
+	log_impl.rings = NULL;
+	log_ring = NULL;
+}
+
+// 출력 버퍼 내보내기, 비동기면 링에 넣는다
+static nint _out_buf_flush(OutBuf* ob, bool debug_output)
+{
+	qn_return_when_fail(ob->pos > 0, 0);
+	if (_log_enter())
+	{
+		const bool pushed = _log_push(ob->data, (size_t)ob->pos);
+		_log_leave();
+		if (pushed)
+			return ob->pos;
+	}
+	_log_wait_own();
+	ob->data[ob->pos] = '\0';
+	_out_write(ob->data, (size_t)ob->pos, debug_output);
+	return ob->pos;
+}
+
+// 출력 버퍼 바로 쓰기, 쌓인 로그를 먼저 내보낸다
+static nint _out_buf_write(OutBuf* ob)
+{
+	qn_log_flush();
+	ob->data[ob->pos] = '\0';
+	_out_write(ob->data, (size_t)ob->pos, true);
+	return ob->pos;
+}
 
 //
 int qn_asrt(const char* expr, const char* mesg, const char* filename, const int line)
 {
 	qn_return_when_fail(expr, -1);
-	_out_buf_str("ASSERT FAILED : ");
-	_out_buf_str(" (filename=\"");
-	_out_buf_str(filename);
-	_out_buf_str("\", line=");
-	_out_buf_int(line);
-	_out_buf_str(")\n\t: ");
-	_out_buf_str(expr);
+	OutBuf ob;
+	ob.pos = 0;
+	_out_buf_str(&ob, "ASSERT FAILED : ");
+	_out_buf_str(&ob, " (filename=\"");
+	_out_buf_str(&ob, filename);
+	_out_buf_str(&ob, "\", line=");
+	_out_buf_int(&ob, line);
+	_out_buf_str(&ob, ")\n\t: ");
+	_out_buf_str(&ob, expr);
 	if (mesg == NULL)
-		_out_buf_str(">\n");
+		_out_buf_str(&ob, ">\n");
 	else
 	{
-		_out_buf_str(">\n\t: [");
-		_out_buf_str(mesg);
-		_out_buf_str("]\n");
+		_out_buf_str(&ob, ">\n\t: [");
+		_out_buf_str(&ob, mesg);
+		_out_buf_str(&ob, "]\n");
 	}
-	_out_buf_flush(true);
+	_out_buf_write(&ob);
 
 	return 0;
 }
@@ -539,11 +1022,13 @@ int qn_asrt(const char* expr, const char* mesg, const char* filename, const int
 //
 _Noreturn void qn_halt(const char* head, const char* mesg)
 {
-	_out_buf_str("HALT ");
-	_out_buf_head(head);
-	_out_buf_str(mesg);
-	_out_buf_ch('\n');
-	_out_buf_flush(true);
+	OutBuf ob;
+	ob.pos = 0;
+	_out_buf_str(&ob, "HALT ");
+	_out_buf_head(&ob, head);
+	_out_buf_str(&ob, mesg);
+	_out_buf_ch(&ob, '\n');
+	_out_buf_write(&ob);
 
 	qn_debug_break();
 	abort();
@@ -552,44 +1037,124 @@ _Noreturn void qn_halt(const char* head, const char* mesg)
 //
 int qn_mesg(const char* head, const char* mesg)
 {
-	_out_buf_head(head);
-	_out_buf_str(mesg);
-	_out_buf_ch('\n');
-	const int len = (int)_out_buf_flush(true);
+	OutBuf ob;
+	ob.pos = 0;
+	_out_buf_head(&ob, head);
+	_out_buf_str(&ob, mesg);
+	_out_buf_ch(&ob, '\n');
+	const int len = (int)_out_buf_flush(&ob, true);
 	return len;
 }
 
 //
 int qn_mesgf(const char* head, const char* fmt, ...)
 {
-	_out_buf_head(head);
+	OutBuf ob;
+	ob.pos = 0;
+	_out_buf_head(&ob, head);
 	va_list va;
 	va_start(va, fmt);
-	_out_buf_va(fmt, va);
+	_out_buf_va(&ob, fmt, va);
 	va_end(va);
-	_out_buf_ch('\n');
-	const int len = (int)_out_buf_flush(true);
+	_out_buf_ch(&ob, '\n');
+	const int len = (int)_out_buf_flush(&ob, true);
 	return len;
 }
 
 //
 int qn_outputs(const char* mesg)
 {
-	_out_buf_str(mesg);
-	_out_buf_ch('\n');
-	return (int)_out_buf_flush(false);
+	OutBuf ob;
+	ob.pos = 0;
+	_out_buf_str(&ob, mesg);
+	_out_buf_ch(&ob, '\n');
+	return (int)_out_buf_flush(&ob, false);
 }
 
 //
 int qn_outputf(const char* fmt, ...)
 {
 	qn_return_when_fail(fmt != NULL, -1);
+	OutBuf ob;
+	ob.pos = 0;
+	va_list va;
+	va_start(va, fmt);
+	_out_buf_va(&ob, fmt, va);
+	va_end(va);
+	_out_buf_ch(&ob, '\n');
+	return (int)_out_buf_flush(&ob, false);
+}
+
+//
+bool qn_output_redirect(const char* filename)
+{
+	qn_log_flush();
+#ifdef _QN_WINDOWS_
+	HANDLE fd;
+	if (filename == NULL)
+		fd = GetStdHandle(STD_OUTPUT_HANDLE);
+	else
+	{
+		wchar uni[QN_MAX_PATH];
+		const size_t uni_len = qn_u8to16(uni, QN_MAX_PATH, filename, 0);
+		qn_return_when_fail(uni_len > 0 && uni_len < QN_MAX_PATH - 1, false);
+		fd = CreateFile(uni, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (fd == INVALID_HANDLE_VALUE)
+			return false;
+	}
+	if (runtime_impl.redirect && runtime_impl.fd != NULL)
+		CloseHandle(runtime_impl.fd);
+#else
+	int fd;
+	if (filename == NULL)
+		fd = STDOUT_FILENO;
+	else
+	{
+		fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0)
+			return false;
+	}
+	if (runtime_impl.redirect && runtime_impl.fd >= 3)
+		close(runtime_impl.fd);
+#endif
+	runtime_impl.fd = fd;
+	runtime_impl.redirect = filename != NULL;
+	return true;
+}
+
+// 로그 머릿글
+static void _out_buf_level(OutBuf* ob, QnLogLevel level, const char* head)
+{
+	static const char* names[] = { "TRACE ", "DEBUG ", "INFO ", "WARN ", "ERROR ", "FATAL " };
+	_out_buf_str(ob, names[level]);
+	_out_buf_head(ob, head);
+}
+
+//
+int qn_logs(QnLogLevel level, const char* head, const char* mesg)
+{
+	qn_return_when_fail((uint)level < QNLOG_OFF && (nint)level >= qn_atomic_load(&log_impl.level), 0);
+	OutBuf ob;
+	ob.pos = 0;
+	_out_buf_level(&ob, level, head);
+	_out_buf_str(&ob, mesg);
+	_out_buf_ch(&ob, '\n');
+	return (int)_out_buf_flush(&ob, true);
+}
+
+//
+int qn_logf(QnLogLevel level, const char* head, const char* fmt, ...)
+{
+	qn_return_when_fail((uint)level < QNLOG_OFF && (nint)level >= qn_atomic_load(&log_impl.level), 0);
+	OutBuf ob;
+	ob.pos = 0;
+	_out_buf_level(&ob, level, head);
 	va_list va;
 	va_start(va, fmt);
-	_out_buf_va(fmt, va);
+	_out_buf_va(&ob, fmt, va);
 	va_end(va);
-	_out_buf_ch('\n');
-	return (int)_out_buf_flush(false);
+	_out_buf_ch(&ob, '\n');
+	return (int)_out_buf_flush(&ob, true);
 }
 
 //
@@ -10,10 +10,23 @@
 #include <dirent.h>
 #include <ctype.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #ifdef _QN_FREEBSD_
 #include <sys/sysctl.h>
 #endif
 #endif
+// 리눅스 비동기 읽기는 io_uring, liburing 없이 시스템 호출로 쓴다
+#if defined _QN_LINUX_ && !defined _QN_MOBILE_ && !defined QS_NO_THREAD && !defined QS_NO_IO_URING && defined __has_include
+#if __has_include(<linux/io_uring.h>)
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+#ifdef __NR_io_uring_setup
+#define QN_ASYNC_URING					1
+#endif
+#endif
+#endif
 #include "PatrickPowell_snprintf.h"
 
 #ifdef _DEBUG
@@ -22,6 +35,9 @@
 
 QN_IMPL_BSTR(QnPathStr, QN_MAX_PATH, _path_str);
 
+// 한번에 읽고 쓰는 최대 크기, 운영체제 호출과 스트림 함수가 받는 크기에 맞춘다
+#define QN_FILE_IO_PIECE	((size_t)1 << 30)
+
 // 최대 파일 할당 크기
 static size_t max_file_alloc_size = 128ULL * 1024ULL * 1024ULL;
 
@@ -343,6 +359,12 @@ static void* _internal_file_open(const char* filename, size_t* size)
 		CloseHandle(fd);
 		return NULL;
 	}
+	if ((ullong)li.QuadPart >= SIZE_MAX - 4)
+	{
+		CloseHandle(fd);
+		errno = EFBIG;
+		return NULL;
+	}
 
 	*size = (size_t)li.QuadPart;
 	return (void*)fd;
@@ -356,6 +378,12 @@ static void* _internal_file_open(const char* filename, size_t* size)
 		close(fd);
 		return NULL;
 	}
+	if ((ullong)st.st_size >= SIZE_MAX - 4)
+	{
+		close(fd);
+		errno = EFBIG;
+		return NULL;
+	}
 	*size = (size_t)st.st_size;
 	return (void*)(size_t)fd;
 #endif
@@ -371,19 +399,68 @@ static void _internal_file_close(void* fd)
 #endif
 }
 
-// 파일 읽기
+// 파일 읽기, 한번에 읽을 수 있는 크기가 정해져 있으므로 나눠 읽는다
 static bool _internal_file_read(void* fd, void* buffer, size_t size)
 {
+	byte* ptr = (byte*)buffer;
+	while (size > 0)
+	{
+		const size_t piece = QN_MIN(size, QN_FILE_IO_PIECE);
 #ifdef _QN_WINDOWS_
-	DWORD dw;
-	if (ReadFile((HANDLE)fd, buffer, (DWORD)size, &dw, NULL) == false || size != (size_t)dw)
-		return false;
-	return true;
+		DWORD dw;
+		if (ReadFile((HANDLE)fd, ptr, (DWORD)piece, &dw, NULL) == FALSE || dw == 0)
+			return false;
+		const size_t n = (size_t)dw;
 #else
-	ssize_t n = read((int)(size_t)fd, buffer, size);
-	if (n < 0 || (size_t)n != size)
-		return false;
+		const ssize_t n = read((int)(size_t)fd, ptr, piece);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+#endif
+		ptr += n;
+		size -= (size_t)n;
+	}
 	return true;
+}
+
+// 파일 위치를 옮기지 않고 지정한 곳에서 읽기, 여러 스레드가 같은 핸들로 읽어도 된다
+static llong _internal_file_read_at(nint fd, void* buffer, size_t size, llong offset)
+{
+#ifdef _QN_WINDOWS_
+	size_t total = 0;
+	while (total < size)
+	{
+		const ullong at = (ullong)offset + total;
+		OVERLAPPED ov = { .Offset = (DWORD)at, .OffsetHigh = (DWORD)(at >> 32) };
+		DWORD dw;
+		if (ReadFile((HANDLE)fd, (byte*)buffer + total, (DWORD)QN_MIN(size - total, QN_FILE_IO_PIECE), &dw, &ov) == FALSE)
+		{
+			if (GetLastError() == ERROR_HANDLE_EOF)
+				break;
+			return -1;
+		}
+		if (dw == 0)
+			break;
+		total += dw;
+	}
+	return (llong)total;
+#else
+	size_t total = 0;
+	while (total < size)
+	{
+		const ssize_t n = pread((int)fd, (byte*)buffer + total, QN_MIN(size - total, QN_FILE_IO_PIECE), (off_t)(offset + (llong)total));
+		if (n < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		if (n == 0)
+			break;
+		total += (size_t)n;
+	}
+	return (llong)total;
 #endif
 }
 
@@ -434,7 +511,7 @@ QnFileAttr qn_get_file_attr(QnMount* mount, const char* filename)
 }
 
 //
-void* qn_file_alloc(QnMount* mount, const char* filename, int* size)
+void* qn_file_alloc64(QnMount* mount, const char* filename, size_t* size)
 {
 	qn_return_when_fail(filename != NULL, NULL);
 	if (mount != NULL)
@@ -454,10 +531,27 @@ void* qn_file_alloc(QnMount* mount, const char* filename, int* size)
 
 	_internal_file_close(fd);
 	if (size != NULL)
-		*size = (int)len;
+		*size = len;
 	return buffer;
 }
 
+//
+void* qn_file_alloc(QnMount* mount, const char* filename, int* size)
+{
+	size_t len;
+	void* data = qn_file_alloc64(mount, filename, &len);
+	if (data != NULL && len > INT_MAX)
+	{
+		// int로 크기를 알려줄 수 없다
+		qn_free(data);
+		errno = EFBIG;
+		return NULL;
+	}
+	if (size != NULL)
+		*size = data == NULL ? 0 : (int)len;
+	return data;
+}
+
 //
 char* qn_file_alloc_text(QnMount* mount, const char* filename, int* length, int* codepage)
 {
@@ -524,6 +618,45 @@ char* qn_file_alloc_text(QnMount* mount, const char* filename, int* length, int*
 	return data;
 }
 
+//
+const void* qn_file_map(const char* filename, size_t* size)
+{
+	qn_return_when_fail(filename != NULL && size != NULL, NULL);
+
+	size_t len;
+	void* fd = _internal_file_open(filename, &len);
+	if (fd == NULL)
+		return NULL;
+
+#ifdef _QN_WINDOWS_
+	// 매핑 핸들은 뷰가 참조하므로 바로 닫아도 된다
+	HANDLE mapping = CreateFileMapping((HANDLE)fd, NULL, PAGE_READONLY, 0, 0, NULL);
+	void* ptr = mapping == NULL ? NULL : MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (mapping != NULL)
+		CloseHandle(mapping);
+#else
+	void* ptr = mmap(NULL, len, PROT_READ, MAP_PRIVATE, (int)(size_t)fd, 0);
+	if (ptr == MAP_FAILED)
+		ptr = NULL;
+#endif
+	_internal_file_close(fd);
+
+	*size = ptr == NULL ? 0 : len;
+	return ptr;
+}
+
+//
+void qn_file_unmap(const void* ptr, const size_t size)
+{
+	qn_return_when_fail(ptr != NULL,/*void*/);
+#ifdef _QN_WINDOWS_
+	QN_DUMMY(size);
+	UnmapViewOfFile(ptr);
+#else
+	munmap((void*)ptr, size);
+#endif
+}
+
 //
 bool qn_remove_file(QnMount* mount, const char* path)
 {
@@ -578,6 +711,42 @@ typedef struct MEMSTREAM
 	size_t				loc;
 } MemStream;
 
+// 작은 스트림 개체 풀, 메모리/뷰/간접 스트림은 자주 열고 닫으니 일반 할당자를 거치지 않는다
+static QnPool* stream_pool = NULL;
+#define STREAM_POOL_ITEM	sizeof(MemStream)
+
+//
+static void* _stream_pool_alloc(void)
+{
+	QnPool* pool = (QnPool*)qn_atomic_load((volatile nint*)&stream_pool);
+	if (pool == NULL)
+	{
+		// 처음 쓰는 스레드 둘이 겹치면 하나만 남긴다
+		pool = qn_new_pool(STREAM_POOL_ITEM, 0, true);
+		if (qn_atomic_cas((volatile nint*)&stream_pool, 0, (nint)pool) == false)
+		{
+			qn_delete_pool(pool);
+			pool = (QnPool*)qn_atomic_load((volatile nint*)&stream_pool);
+		}
+	}
+	return qn_pool_alloc(pool, false);
+}
+
+//
+static void _stream_pool_free(void* ptr)
+{
+	qn_pool_free(stream_pool, ptr);
+}
+
+// 런타임 내림에서 부른다. 아직 안 닫은 스트림이 있으면 풀은 그대로 둔다
+void qn_stream_down(void)
+{
+	if (stream_pool == NULL || qn_pool_count(stream_pool) != 0)
+		return;
+	qn_delete_pool(stream_pool);
+	stream_pool = NULL;
+}
+
 //
 static int _mem_stream_read(QnGam g, void* buffer, const int offset, const int size)
 {
@@ -672,7 +841,7 @@ static void _mem_stream_dispose(QnGam g)
 	qn_unload(self->base.mount);
 	qn_free(data);
 	qn_free(self->base.name);
-	qn_free(self);
+	_stream_pool_free(self);
 }
 
 // 메모리 스트림 복제
@@ -712,7 +881,7 @@ static QnStream* _mem_stream_init(MemStream* self, QnMount* mount, const char* n
 // 메모리 스트림 만들기
 QnStream* qn_create_mem_stream(const char* name, size_t initial_capacity)
 {
-	MemStream* self = qn_alloc_1(MemStream);
+	MemStream* self = (MemStream*)_stream_pool_alloc();
 
 	byte* data;
 	if (initial_capacity == 0)
@@ -729,14 +898,14 @@ QnStream* qn_create_mem_stream(const char* name, size_t initial_capacity)
 // 메모리 스트림 외부 데이터로 만들기
 QnStream* qn_create_mem_stream_data(const char* name, void* data, size_t size)
 {
-	MemStream* self = qn_alloc_1(MemStream);
+	MemStream* self = (MemStream*)_stream_pool_alloc();
 	return _mem_stream_init(self, NULL, name, data, size, size, QNFF_READ | QNFF_WRITE | QNFF_SEEK | QNFFT_MEM);
 }
 
 // HFS용 스트림 만들기
 QnStream* _create_mem_stream_hfs(QnMount* mount, const char* name, void* data, size_t size)
 {
-	MemStream* self = qn_alloc_1(MemStream);
+	MemStream* self = (MemStream*)_stream_pool_alloc();
 	return _mem_stream_init(self, mount, name, data, size, size, QNFF_READ | QNFF_SEEK | QNFFT_MEM | QNFFT_HFS);
 }
 
@@ -746,6 +915,56 @@ void* qn_mem_stream_get_data(QnStream* self)
 	return QN_TMASK(self->flags, QNFFT_MEM) ? qn_get_gam_pointer(self) : NULL;
 }
 
+//
+static int _view_stream_write(QnGam g, const void* buffer, const int offset, const int size)
+{
+	QN_DUMMY(g); QN_DUMMY(buffer); QN_DUMMY(offset); QN_DUMMY(size);
+	qn_mesgb("ViewStream", "write not supported");
+	return -1;
+}
+
+// 뷰 스트림 닫기, 데이터는 빌려온 것이라 해제하지 않는다
+static void _view_stream_dispose(QnGam g)
+{
+	MemStream* self = qn_cast_type(g, MemStream);
+	qn_unload(self->base.mount);
+	qn_free(self->base.name);
+	_stream_pool_free(self);
+}
+
+// 뷰 스트림 만들기 공용, 마운트가 있으면 마운트가 데이터를 갖고 있다
+static QnStream* _view_stream_init(QnMount* mount, const char* name, const void* data, size_t size, QnFileFlag flags)
+{
+	MemStream* self = (MemStream*)_stream_pool_alloc();
+	self->base.mount = qn_load(mount);
+	self->base.name = qn_strdup(name);
+	self->base.flags = flags;
+	self->capa = size;
+	self->size = size;
+	self->loc = 0;
+	qn_set_gam_desc(self, (void*)data);
+
+	static const struct QNSTREAM_VTABLE _view_stream_vt =
+	{
+		.base.name = "ViewStream",
+		.base.dispose = _view_stream_dispose,
+		.stream_read = _mem_stream_read,
+		.stream_write = _view_stream_write,
+		.stream_seek = _mem_stream_seek,
+		.stream_tell = _mem_stream_tell,
+		.stream_size = _mem_stream_size,
+		.stream_flush = _mem_stream_flush,
+		.stream_dup = _mem_stream_dup,
+	};
+	return qn_gam_init(self, _view_stream_vt);
+}
+
+// 뷰 스트림 만들기
+QnStream* qn_create_view_stream(const char* name, const void* data, size_t size)
+{
+	return _view_stream_init(NULL, name, data, size, QNFF_READ | QNFF_SEEK | QNFFT_MEM | QNFFT_VIEW);
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 // 파일 스트림
@@ -864,7 +1083,7 @@ static void _file_stream_access_parse(const char* mode, QnFileAccess* acs, QnFil
 						*flags = QNFF_WRITE | QNFF_SEEK;
 						break;
 					case '+':
-						acs->mode |= O_RDWR;
+						acs->mode = (acs->mode & ~O_ACCMODE) | O_RDWR;
 						*flags = QNFF_READ | QNFF_WRITE | QNFF_SEEK;
 						break;
 					case 't':
@@ -919,6 +1138,8 @@ static void _file_stream_access_parse(const char* mode, QnFileAccess* acs, QnFil
 
 	if (acs->access == 0)
 		acs->access = QN_TMASK(acs->mode, O_CREAT) ? (S_IRUSR | S_IWUSR) | S_IRGRP | S_IROTH : S_IRUSR | S_IRGRP | S_IROTH;
+	else if (QN_TMASK(acs->mode, O_CREAT))
+		acs->access |= S_IRUSR | S_IWUSR;	// 만든 파일을 다시 열 수 있게
 #endif
 }
 
@@ -1099,9 +1320,9 @@ static QnStream* _file_stream_dup(QnGam g)
 // 파일 스트림 열기
 static QnStream* _file_stream_open(QnMount* mount, const char* filename, const char* mode)
 {
+	char path[QN_MAX_PATH];		// 아래에서 이름을 복사할 때까지 살아 있어야 한다
 	if (mount != NULL)
 	{
-		char path[QN_MAX_PATH];
 		filename = _file_stream_get_real_path(path, mount, filename);
 		qn_return_when_fail(filename, NULL);
 	}
@@ -1162,39 +1383,25 @@ typedef struct INDIRECTSTREAM
 {
 	QnStream			base;
 	llong				offset;
-	size_t				loc;
-	size_t				size;
+	ullong				loc;
+	ullong				size;
 } IndirectStream;
+static_assert(sizeof(IndirectStream) <= STREAM_POOL_ITEM, "IndirectStream must fit in stream pool item");
 
 //
 static int _indirect_stream_read(QnGam g, void* buffer, const int offset, const int size)
 {
 	IndirectStream* self = qn_cast_type(g, IndirectStream);
-	byte* ptr = (byte*)buffer + offset;
-	int ret;
-
-#ifdef _QN_WINDOWS_
-	HANDLE fd = qn_get_gam_handle(self);
-	const LARGE_INTEGER cli = { .QuadPart = self->offset + self->loc };
-	SetFilePointerEx(fd, cli, NULL, FILE_BEGIN);
-
-	DWORD dw;
-	if (ReadFile(fd, ptr, size, &dw, NULL) == FALSE)
-		return -1;
-	ret = (int)dw;
-#else
-	int fd = qn_get_gam_desc_int(self);
-	lseek(fd, (off_t)(self->offset + self->loc), SEEK_SET);
+	const size_t n = (size_t)QN_MIN((ullong)size, self->size - self->loc);
+	if (n == 0)
+		return 0;
 
-	ret = read(fd, ptr, (size_t)size);
+	// 복제한 핸들도 파일 위치는 공유하므로 위치 지정 읽기를 한다
+	const llong ret = _internal_file_read_at(qn_get_gam_desc(self, nint), (byte*)buffer + offset, n, self->offset + (llong)self->loc);
 	if (ret < 0)
 		return -1;
-#endif
-
-	self->loc += ret;
-	if (self->loc > self->size)
-		self->loc = self->size;
-	return ret;
+	self->loc += (ullong)ret;
+	return (int)ret;
 }
 
 //
@@ -1224,7 +1431,9 @@ static llong _indirect_stream_seek(QnGam g, const llong offset, const QnSeek org
 		default:
 			return -1;
 	}
-	self->loc = (size_t)loc <= self->size ? (size_t)loc : self->size;
+	if (loc < 0)
+		loc = 0;
+	self->loc = (ullong)loc <= self->size ? (ullong)loc : self->size;
 	return (llong)self->loc;
 }
 
@@ -1264,7 +1473,7 @@ static void _indirect_stream_dispose(QnGam g)
 #endif
 	qn_unload(self->base.mount);
 	qn_free(self->base.name);
-	qn_free(self);
+	_stream_pool_free(self);
 }
 
 //
@@ -1292,7 +1501,7 @@ static QnStream* _indirect_stream_dup(QnGam g)
 	if (fd == -1)
 		return NULL;
 
-	IndirectStream* self = qn_alloc(1, IndirectStream);
+	IndirectStream* self = (IndirectStream*)_stream_pool_alloc();
 	self->base.mount = qn_load(source->base.mount);
 	self->base.name = qn_strdup(source->base.name);
 	self->base.flags = source->base.flags;
@@ -1305,12 +1514,12 @@ static QnStream* _indirect_stream_dup(QnGam g)
 }
 
 // 간접 스트림 열기
-static QnStream* _indirect_stream_open(QnMount* hfs, const char* filename, llong offset, size_t size)
+static QnStream* _indirect_stream_open(QnMount* hfs, const char* filename, llong offset, ullong size)
 {
 	FileStream* stream = qn_get_gam_desc(hfs, FileStream*);
 	nint fd = _file_handle_dup(qn_get_gam_desc(stream, nint));
 
-	IndirectStream* self = qn_alloc(1, IndirectStream);
+	IndirectStream* self = (IndirectStream*)_stream_pool_alloc();
 	self->base.mount = qn_load(hfs);
 	self->base.name = qn_strdup(filename);
 	self->base.flags = QNFF_READ | QNFF_SEEK | QNFFT_INDIRECT;
@@ -1323,6 +1532,292 @@ static QnStream* _indirect_stream_open(QnMount* hfs, const char* filename, llong
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+// 버퍼 스트림, 다른 스트림을 감싸서 읽기는 미리 읽고 쓰기는 모아서 쓴다
+
+#define BUF_STREAM_DEFAULT	(64 * 1024)
+#define BUF_STREAM_MIN		64
+
+//
+typedef struct BUFSTREAM
+{
+	QnStream			base;
+	QnStream*			stream;				// 감싼 스트림
+	byte*				buffer;
+	size_t				capa;
+	size_t				rpos;				// 읽기 버퍼에서 읽을 위치
+	size_t				rlen;				// 읽기 버퍼에 있는 데이터 길이
+	size_t				wlen;				// 쓰기 버퍼에 모은 길이
+	llong				loc;				// 바깥에서 보는 위치
+} BufStream;
+
+// 원래 스트림 부르기
+#define _buf_inner_vt(self)		qn_cast_vtable((self)->stream, QNSTREAM)
+
+// 모아둔 쓰기를 내보낸다
+static bool _buf_stream_flush_write(BufStream* self)
+{
+	size_t done = 0;
+	while (done < self->wlen)
+	{
+		const int ret = _buf_inner_vt(self)->stream_write(self->stream, self->buffer, (int)done, (int)(self->wlen - done));
+		if (ret <= 0)
+		{
+			// 못 쓴 건 남겨둔다
+			memmove(self->buffer, self->buffer + done, self->wlen - done);
+			self->wlen -= done;
+			return false;
+		}
+		done += (size_t)ret;
+	}
+	self->wlen = 0;
+	return true;
+}
+
+// 미리 읽어둔 걸 버린다, 원래 스트림 위치를 바깥 위치로 되돌린다
+static void _buf_stream_drop_read(BufStream* self)
+{
+	const size_t remain = self->rlen - self->rpos;
+	if (remain > 0 && QN_TMASK(self->stream->flags, QNFF_SEEK))
+		_buf_inner_vt(self)->stream_seek(self->stream, -(llong)remain, QNSEEK_CUR);
+	self->rpos = self->rlen = 0;
+}
+
+// 읽기 버퍼 채우기, 남은 건 앞으로 옮기고 뒤를 채운다
+static size_t _buf_stream_fill(BufStream* self)
+{
+	if (self->wlen > 0 && _buf_stream_flush_write(self) == false)
+		return self->rlen - self->rpos;
+	if (self->rpos > 0)
+	{
+		memmove(self->buffer, self->buffer + self->rpos, self->rlen - self->rpos);
+		self->rlen -= self->rpos;
+		self->rpos = 0;
+	}
+	const int ret = _buf_inner_vt(self)->stream_read(self->stream, self->buffer, (int)self->rlen, (int)(self->capa - self->rlen));
+	if (ret > 0)
+		self->rlen += (size_t)ret;
+	return self->rlen - self->rpos;
+}
+
+//
+static int _buf_stream_read(QnGam g, void* buffer, const int offset, const int size)
+{
+	BufStream* self = qn_cast_type(g, BufStream);
+	byte* dest = (byte*)buffer + offset;
+	size_t want = (size_t)size, total = 0;
+	while (want > 0)
+	{
+		size_t avail = self->rlen - self->rpos;
+		if (avail == 0)
+		{
+			if (want >= self->capa)
+			{
+				// 크게 읽을 때는 버퍼를 거치지 않는다
+				if (self->wlen > 0 && _buf_stream_flush_write(self) == false)
+					break;
+				self->rpos = self->rlen = 0;
+				const int ret = _buf_inner_vt(self)->stream_read(self->stream, dest, (int)total, (int)want);
+				if (ret <= 0)
+					break;
+				total += (size_t)ret;
+				want -= (size_t)ret;
+				continue;
+			}
+			avail = _buf_stream_fill(self);
+			if (avail == 0)
+				break;
+		}
+		const size_t n = QN_MIN(avail, want);
+		memcpy(dest + total, self->buffer + self->rpos, n);
+		self->rpos += n;
+		total += n;
+		want -= n;
+	}
+	self->loc += (llong)total;
+	return (int)total;
+}
+
+//
+static int _buf_stream_write(QnGam g, const void* buffer, const int offset, const int size)
+{
+	BufStream* self = qn_cast_type(g, BufStream);
+	if (self->rlen > 0)
+		_buf_stream_drop_read(self);
+
+	const byte* src = (const byte*)buffer + offset;
+	if (self->wlen + (size_t)size > self->capa && _buf_stream_flush_write(self) == false)
+		return -1;
+	if ((size_t)size >= self->capa)
+	{
+		// 버퍼보다 크면 바로 쓴다
+		const int ret = _buf_inner_vt(self)->stream_write(self->stream, src, 0, size);
+		if (ret > 0)
+			self->loc += ret;
+		return ret;
+	}
+	memcpy(self->buffer + self->wlen, src, (size_t)size);
+	self->wlen += (size_t)size;
+	self->loc += size;
+	return size;
+}
+
+//
+static llong _buf_stream_seek(QnGam g, const llong offset, const QnSeek org)
+{
+	BufStream* self = qn_cast_type(g, BufStream);
+	if (self->wlen > 0 && _buf_stream_flush_write(self) == false)
+		return -1;
+
+	llong target;
+	switch ((int)org)
+	{
+		case QNSEEK_BEGIN:
+			target = offset;
+			break;
+		case QNSEEK_CUR:
+			target = self->loc + offset;
+			break;
+		case QNSEEK_END:
+		{
+			_buf_stream_drop_read(self);
+			const llong ret = _buf_inner_vt(self)->stream_seek(self->stream, offset, QNSEEK_END);
+			if (ret >= 0)
+				self->loc = ret;
+			return ret;
+		}
+		default:
+			return -1;
+	}
+
+	// 읽기 버퍼 안이면 위치만 옮긴다
+	const llong begin = self->loc - (llong)self->rpos;
+	if (self->rlen > 0 && target >= begin && target <= begin + (llong)self->rlen)
+	{
+		self->rpos = (size_t)(target - begin);
+		self->loc = target;
+		return target;
+	}
+
+	self->rpos = self->rlen = 0;
+	const llong ret = _buf_inner_vt(self)->stream_seek(self->stream, target, QNSEEK_BEGIN);
+	if (ret >= 0)
+		self->loc = ret;
+	return ret;
+}
+
+//
+static llong _buf_stream_tell(QnGam g)
+{
+	BufStream* self = qn_cast_type(g, BufStream);
+	return self->loc;
+}
+
+//
+static llong _buf_stream_size(QnGam g)
+{
+	BufStream* self = qn_cast_type(g, BufStream);
+	if (self->wlen > 0)
+		_buf_stream_flush_write(self);
+	return _buf_inner_vt(self)->stream_size(self->stream);
+}
+
+//
+static bool _buf_stream_flush(QnGam g)
+{
+	BufStream* self = qn_cast_type(g, BufStream);
+	if (self->wlen > 0 && _buf_stream_flush_write(self) == false)
+		return false;
+	return _buf_inner_vt(self)->stream_flush(self->stream);
+}
+
+// 닫기, 모아둔 건 쓰고 닫는다
+static void _buf_stream_dispose(QnGam g)
+{
+	BufStream* self = qn_cast_type(g, BufStream);
+	if (self->wlen > 0)
+		_buf_stream_flush_write(self);
+	_buf_stream_drop_read(self);
+	qn_unload(self->stream);
+	qn_unload(self->base.mount);
+	qn_free(self->base.name);
+	qn_free(self->buffer);
+	qn_free(self);
+}
+
+// 복제, 원래 스트림을 복제해서 새 버퍼로 감싼다
+static QnStream* _buf_stream_dup(QnGam g)
+{
+	BufStream* self = qn_cast_type(g, BufStream);
+	if (self->wlen > 0)
+		_buf_stream_flush_write(self);
+	QnStream* dup = _buf_inner_vt(self)->stream_dup(self->stream);
+	qn_return_when_fail(dup != NULL, NULL);
+	QnStream* stream = qn_create_buffered_stream(dup, self->capa);
+	qn_unload(dup);
+	return stream;
+}
+
+// 버퍼 스트림 만들기
+QnStream* qn_create_buffered_stream(QnStream* stream, size_t buffer_size)
+{
+	qn_return_when_fail(stream != NULL, NULL);
+
+	BufStream* self = qn_alloc_zero_1(BufStream);
+	self->base.mount = qn_load(stream->mount);
+	self->base.name = qn_strdup(stream->name);
+	// 종류 비트는 감싼 스트림 것이라 가져오지 않는다
+	self->base.flags = (stream->flags & (QNFF_READ | QNFF_WRITE | QNFF_SEEK | QNFF_APPEND | QNFF_TEXT | QNFF_BINARY)) | QNFFT_BUFFER;
+	self->stream = qn_load(stream);
+	self->capa = buffer_size == 0 ? BUF_STREAM_DEFAULT : QN_MAX(buffer_size, BUF_STREAM_MIN);
+	self->capa = QN_MIN(self->capa, (size_t)INT_MAX);
+	self->buffer = qn_alloc(self->capa, byte);
+	self->loc = QN_TMASK(stream->flags, QNFF_SEEK) ? qn_cast_vtable(stream, QNSTREAM)->stream_tell(stream) : 0;
+
+	static const struct QNSTREAM_VTABLE _buf_stream_vt =
+	{
+		.base.name = "BufferedStream",
+		.base.dispose = _buf_stream_dispose,
+		.stream_read = _buf_stream_read,
+		.stream_write = _buf_stream_write,
+		.stream_seek = _buf_stream_seek,
+		.stream_tell = _buf_stream_tell,
+		.stream_size = _buf_stream_size,
+		.stream_flush = _buf_stream_flush,
+		.stream_dup = _buf_stream_dup,
+	};
+	return qn_gam_init(self, _buf_stream_vt);
+}
+
+// 버퍼 스트림에서 구분자까지 찾아 복사한다. 복사한 길이, 찾았으면 found가 참
+static int _buf_stream_scan(BufStream* self, byte* dest, int size, int delim, bool* found)
+{
+	int total = 0;
+	*found = false;
+	while (total < size)
+	{
+		size_t avail = self->rlen - self->rpos;
+		if (avail == 0 && (avail = _buf_stream_fill(self)) == 0)
+			break;
+		const byte* src = self->buffer + self->rpos;
+		size_t n = QN_MIN(avail, (size_t)(size - total));
+		const byte* hit = (const byte*)memchr(src, delim, n);
+		if (hit != NULL)
+			n = (size_t)(hit - src) + 1;
+		memcpy(dest + total, src, n);
+		self->rpos += n;
+		self->loc += (llong)n;
+		total += (int)n;
+		if (hit != NULL)
+		{
+			*found = true;
+			break;
+		}
+	}
+	return total;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 // 디스크 파일 리스트
 
@@ -1691,7 +2186,7 @@ static QnStream* _disk_fs_stream(QnGam g, const char* filename, const char* mode
 }
 
 //
-static void* _disk_fs_alloc(QnGam g, const char* filename, int* size)
+static void* _disk_fs_alloc(QnGam g, const char* filename, size_t* size)
 {
 	const QnMount* self = qn_cast_type(g, QnMount);
 	char real[QN_MAX_PATH];
@@ -1710,7 +2205,7 @@ static void* _disk_fs_alloc(QnGam g, const char* filename, int* size)
 
 	_internal_file_close(fd);
 	if (size != NULL)
-		*size = (int)len;
+		*size = len;
 	return buffer;
 }
 
@@ -1782,27 +2277,32 @@ static QnMount* _create_diskfs(char* path)
 // HFS
 
 #define HFS_HEADER		QN_FOURCC('H', 'F', 'S', '\0')
-#define HFS_VERSION		14
+#define HFS_VERSION		16
+#define HFS_VERSION_LARGE	17		// 위치와 크기가 64비트, 4GB 넘는 HFS와 파일
+#define HFS_VERSION_V15	15			// 중앙 색인이 없는 버전, 열 때 색인을 만든다
+#define HFS_VERSION_V14	14			// 이름 해시가 다른 옛날 버전, 읽고 쓸 수 있다
+#define HFS_VERSION_OK(v)	((v) >= HFS_VERSION_V14 && (v) <= HFS_VERSION_LARGE)
+// 중앙 색인은 닫을 때 파일 끝에 다시 쓴다. 열 때 읽은 색인 자리부터 덧붙이고 새 색인으로 덮어쓰므로
+// 고칠 때마다 옛 색인이 죽은 공간으로 쌓이지 않는다. 새 색인이 짧으면 옛 파일 끝까지 0으로 채운다
+#define HFS_INDEX		QN_FOURCC('H', 'F', 'S', 'I')
 
 #define HFSAT_ROOT		sizeof(HfsHeader)
 #define HFSAT_ROOT_STC	QN_OFFSETOF(HfsHeader, stc)
 #define HFSAT_ROOT_STW	QN_OFFSETOF(HfsHeader, stw)
 #define HFSAT_ROOT_REV 	QN_OFFSETOF(HfsHeader, revision)
 #define HFSAT_ROOT_DESC	QN_OFFSETOF(HfsHeader, desc)
-#define HFSAT_TYPE		QN_OFFSETOF(HfsSource, type)
-#define HFSAT_ATTR		QN_OFFSETOF(HfsSource, attr)
-#define HFSAT_SIZE		QN_OFFSETOF(HfsSource, size)
-#define HFSAT_CMPR		QN_OFFSETOF(HfsSource, cmpr)
-#define HFSAT_SOURCE	QN_OFFSETOF(HfsSource, source)
-#define HFSAT_EXT		QN_OFFSETOF(HfsFile, ext)
-#define HFSAT_LEN		QN_OFFSETOF(HfsFile, len)
-#define HFSAT_HASH		QN_OFFSETOF(HfsFile, hash)
-#define HFSAT_SUBP		QN_OFFSETOF(HfsFile, subp)
 #define HFSAT_NEXT		QN_OFFSETOF(HfsFile, next)
-#define HFSAT_STZ		QN_OFFSETOF(HfsFile, stc)
+#define HFSAT_NEXT32	QN_OFFSETOF(HfsFile32, next)
 
 #define HFS_MAX_NAME	260
 
+// 압축 코덱은 속성 바이트의 위쪽 두 비트에 둔다, 0이면 예전처럼 디플레이트
+#define HFS_CODEC_SHIFT	6
+#define HFS_CODEC_MASK	0xC0
+#define HFS_CODEC_LZ	1
+#define HFS_CODEC_CHUNK	2				// 조각 압축, 실제 코덱은 조각 헤더에 있다
+#define HFS_ATTR(a)		((QnFileAttr)((a) & ~HFS_CODEC_MASK))
+
 // HFS 헤더
 typedef struct HFSHEADER
 {
@@ -1815,27 +2315,50 @@ typedef struct HFSHEADER
 	char				desc[64];			// 설명
 } HfsHeader;
 
-// HFS 파일 소스
+// HFS 파일 소스, v17 디스크 형식과 같고 옛날 형식은 읽고 쓸 때 바꾼다
 typedef struct HFSSOURCE
 {
 	byte 				attr;				// 속성
 	byte				type;				// 타입
 	ushort				len;				// 파일 이름 길이
-	uint				size;				// 원래 크기
-	uint				cmpr;				// 압축된 크기
-	uint				seek;				// 파일 위치
+	uint				notuse;				// 사용하지 않음
+	ullong				size;				// 원래 크기
+	ullong				cmpr;				// 압축된 크기
+	ullong				seek;				// 파일 위치
 } HfsSource;
 
-// HFS 파일
+// HFS 파일, v17 디스크 형식과 같다
 typedef struct HFSFILE
 {
 	HfsSource			source;
 	QnDateTime			stc;				// 만든 타임스탬프
 	uint				hash;				// 파일 이름 해시
 	uint				zzzz;				// 메타 데이터
+	ullong				subp;				// 디렉토리 위치
+	ullong				next;				// 다음 파일 위치
+} HfsFile;
+
+// HFS 파일 소스 (v16까지의 32비트 디스크 형식)
+typedef struct HFSSOURCE32
+{
+	byte 				attr;				// 속성
+	byte				type;				// 타입
+	ushort				len;				// 파일 이름 길이
+	uint				size;				// 원래 크기
+	uint				cmpr;				// 압축된 크기
+	uint				seek;				// 파일 위치
+} HfsSource32;
+
+// HFS 파일 (v16까지의 32비트 디스크 형식)
+typedef struct HFSFILE32
+{
+	HfsSource32			source;
+	QnDateTime			stc;				// 만든 타임스탬프
+	uint				hash;				// 파일 이름 해시
+	uint				zzzz;				// 메타 데이터
 	uint				subp;				// 디렉토리 위치
 	uint				next;				// 다음 파일 위치
-} HfsFile;
+} HfsFile32;
 
 // HFS 파일 정보
 typedef struct HFSINFO
@@ -1845,6 +2368,71 @@ typedef struct HFSINFO
 } HfsInfo;
 QN_DECLIMPL_ARRAY(HfsInfoArray, HfsInfo, _hfs_infos);
 
+// 조각 압축, 큰 파일은 64KB 조각마다 따로 압축해서 읽는 만큼만 푼다
+#define HFS_CHUNK			QN_FOURCC('H', 'F', 'S', 'C')
+#define HFS_CHUNK_SHIFT		16
+#define HFS_CHUNK_SIZE		(1U << HFS_CHUNK_SHIFT)
+#define HFS_CHUNK_THRESHOLD	(4 * HFS_CHUNK_SIZE)	// 이보다 크면 조각으로 압축
+#define HFS_CHUNK_CACHE		2					// 스트림이 들고 있는 푼 조각 수
+
+#define HFS_CHUNK_WIDE		QN_BIT(0)			// 위치 표가 64비트
+#define HFS_CHUNK_LIMIT		0xFFFFFFFFULL		// 32비트 위치 표로 가리킬 수 있는 크기
+
+// 조각 압축 헤더, 뒤에 조각 위치 표(count + 1개)와 조각 데이터가 온다
+// 조각의 압축 크기가 원래 크기와 같으면 압축하지 않은 조각이다
+typedef struct HFSCHUNKHEADER
+{
+	uint				header;				// HFS_CHUNK
+	byte				codec;				// 조각 코덱
+	byte				shift;				// 조각 크기 = 1 << shift
+	ushort				flags;				// HFS_CHUNK_WIDE면 위치 표가 ullong
+	uint				count;				// 조각 갯수
+} HfsChunkHeader;
+
+// HFS 중앙 색인 꼬리 (v16), 파일 맨 끝에 있다
+// 색인 항목은 HfsSource32 + ushort 경로 길이 + 경로이고, 경로 순서로 정렬되어 있다
+typedef struct HFSINDEXTAIL
+{
+	uint				index;				// 색인 시작 위치
+	uint				count;				// 항목 갯수
+	uint				crc;				// 색인 CRC32
+	uint				header;				// HFS_INDEX
+} HfsIndexTail;
+
+// HFS 중앙 색인 꼬리 (v17), 색인 항목은 HfsSource + ushort 경로 길이 + 경로
+typedef struct HFSINDEXTAIL64
+{
+	ullong				index;				// 색인 시작 위치
+	uint				count;				// 항목 갯수
+	uint				crc;				// 색인 CRC32
+	uint				notuse;				// 사용하지 않음
+	uint				header;				// HFS_INDEX
+} HfsIndexTail64;
+
+// 전체 경로 해시, 대소문자 구별 안함
+static size_t _hfs_index_key_hash(const char** key)
+{
+	return qn_strihash(*key);
+}
+
+// 전체 경로 비교, 대소문자 구별 안함
+static int _hfs_index_key_cmp(const char** left, const char** right)
+{
+	return qn_stricmp(*left, *right);
+}
+
+// 전체 경로 색인, 키는 "/디렉토리/파일" 꼴이고 값의 seek는 파일 헤더 위치 (링크는 데이터 위치)
+QN_DECLIMPL_FLATHASH(HfsIndex, char*, HfsSource, _hfs_index_key_hash, _hfs_index_key_cmp, qn_mem_free_ptr, (void), _hfs_index);
+
+// 같은 내용을 한번만 쓰려고 기억하는 몸통
+// 키는 내용 해시와 코덱을 섞은 것이고, 확인용 해시와 크기까지 같아야 같은 내용으로 본다
+typedef struct HFSBODY
+{
+	ullong				check;				// 확인용 두번째 해시
+	HfsSource			source;				// 링크 모양 소스, seek가 데이터 위치
+} HfsBody;
+QN_DECLIMPL_FLATHASH_INT_TYPE(HfsBodies, ullong, HfsBody, (void), _hfs_bodies);
+
 //
 typedef struct HFSDIR
 {
@@ -1859,6 +2447,19 @@ typedef struct HFS
 	HfsHeader			header;
 	HfsInfoArray		infos;
 	uint				touch;
+
+	HfsIndex			index;				// 전체 경로 색인
+	llong				index_tail;			// 읽어온 색인 꼬리의 헤더 위치, 없으면 0
+	llong				append;				// 덧붙일 위치, 읽어온 색인 자리부터 시작. 0이면 파일 끝
+	bool				large;				// 64비트 형식 (v17)
+
+	const byte*			map;				// 메모리 매핑 ('v' 모드)
+	size_t				map_size;
+
+	HfsBodies			bodies;				// 넣은 내용의 몸통, 처음 넣을 때 만든다
+	HfsSource*			olds;				// 열 때 있던 파일을 크기 순서로, 같은 크기가 들어오면 그때 해시한다
+	size_t				old_count;
+	bool				dedup;				// bodies와 olds를 만들었다
 } Hfs;
 
 // 경로 분리
@@ -1869,12 +2470,145 @@ static void _hfs_split_path(const char* path, QnPathStr* dir, QnPathStr* file)
 	_path_str_intern(file);
 }
 
-// 파일 헤더
-static bool _hfs_write_file_header(QnStream* stream, HfsFile* file, const char* name, size_t name_len, uint hash)
+// 이름 해시
+static uint _hfs_hash(const Hfs* self, const char* name, size_t name_len)
+{
+	if (self->header.version != HFS_VERSION_V14)
+		return qn_strnshash(name, name_len);
+	// 옛날 해시, 256 글자까지만 본다
+	uint h = (uint)tolower(*name);
+	if (!h)
+		return 0;
+	uint c;
+	for (c = 0, name++; *name && c < 256; name++, c++)
+		h = (h << 5) - h + (uint)tolower(*name);
+	h = (h << 5) - h + c;
+	return h;
+}
+
+// 디스크 레코드 크기
+INLINE size_t _hfs_record_size(bool large)
+{
+	return large ? sizeof(HfsFile) : sizeof(HfsFile32);
+}
+
+// 파일 데이터 위치, 레코드와 이름 바로 뒤. 링크는 seek가 나눠 쓰는 데이터 위치
+INLINE llong _hfs_source_offset(const HfsSource* source, bool large)
+{
+	if (QN_TMASK(source->attr, QNFATTR_LINK))
+		return (llong)source->seek;
+	return (llong)(source->seek + _hfs_record_size(large) + source->len);
+}
+
+// 레코드로 소스 만들기. 링크 레코드는 subp에 데이터 위치가 있다
+INLINE HfsSource _hfs_record_source(const HfsFile* file, ullong at)
+{
+	HfsSource source = file->source;
+	source.seek = QN_TMASK(source.attr, QNFATTR_DIR) == false && QN_TMASK(source.attr, QNFATTR_LINK) ? file->subp : at;
+	return source;
+}
+
+// 32비트 소스를 64비트로
+static void _hfs_source_from32(HfsSource* dest, const HfsSource32* src)
+{
+	*dest = (HfsSource)
+	{
+		.attr = src->attr,
+		.type = src->type,
+		.len = src->len,
+		.size = src->size,
+		.cmpr = src->cmpr,
+		.seek = src->seek,
+	};
+}
+
+// 64비트 소스를 32비트로, 넘치면 거짓
+static bool _hfs_source_to32(HfsSource32* dest, const HfsSource* src)
+{
+	*dest = (HfsSource32)
+	{
+		.attr = src->attr,
+		.type = src->type,
+		.len = src->len,
+		.size = (uint)src->size,
+		.cmpr = (uint)src->cmpr,
+		.seek = (uint)src->seek,
+	};
+	return src->size <= UINT_MAX && src->cmpr <= UINT_MAX && src->seek <= UINT_MAX;
+}
+
+// 레코드 읽기, 옛날 형식은 64비트로 바꾼다
+static bool _hfs_read_record(QnStream* stream, bool large, HfsFile* file)
+{
+	if (large)
+		return qn_stream_read(stream, file, 0, sizeof(HfsFile)) == sizeof(HfsFile);
+
+	HfsFile32 rec;
+	if (qn_stream_read(stream, &rec, 0, sizeof(HfsFile32)) != sizeof(HfsFile32))
+		return false;
+	_hfs_source_from32(&file->source, &rec.source);
+	file->stc = rec.stc;
+	file->hash = rec.hash;
+	file->zzzz = rec.zzzz;
+	file->subp = rec.subp;
+	file->next = rec.next;
+	return true;
+}
+
+// 레코드를 디스크 형식으로 바꾼다. 크기를 반환하고 32비트 형식에 안 맞으면 0
+static size_t _hfs_pack_record(bool large, const HfsFile* file, void* dest)
 {
-	file->hash = hash == 0 ? qn_strshash(name) : hash;
-	file->source.len = (ushort)(name_len == 0 ? strlen(name) : name_len);
-	if (qn_stream_write(stream, file, 0, sizeof(HfsFile)) != sizeof(HfsFile) ||
+	if (large)
+	{
+		memcpy(dest, file, sizeof(HfsFile));
+		return sizeof(HfsFile);
+	}
+
+	HfsFile32 rec =
+	{
+		.stc = file->stc,
+		.hash = file->hash,
+		.zzzz = file->zzzz,
+		.subp = (uint)file->subp,
+		.next = (uint)file->next,
+	};
+	if (_hfs_source_to32(&rec.source, &file->source) == false || file->subp > UINT_MAX || file->next > UINT_MAX)
+		return 0;
+	memcpy(dest, &rec, sizeof(HfsFile32));
+	return sizeof(HfsFile32);
+}
+
+// 다음 파일 위치 고치기
+static bool _hfs_write_next(QnStream* stream, bool large, ullong at, ullong next)
+{
+	if (large)
+	{
+		const llong pos = (llong)(at + HFSAT_NEXT);
+		return qn_stream_seek(stream, pos, QNSEEK_BEGIN) == pos &&
+			qn_stream_write(stream, &next, 0, sizeof(ullong)) == sizeof(ullong);
+	}
+	const uint next32 = (uint)next;
+	const llong pos = (llong)(at + HFSAT_NEXT32);
+	return next <= UINT_MAX && qn_stream_seek(stream, pos, QNSEEK_BEGIN) == pos &&
+		qn_stream_write(stream, &next32, 0, sizeof(uint)) == sizeof(uint);
+}
+
+// 파일 헤더, 해시가 0이면 새 버전 해시로 만든다
+static bool _hfs_write_file_header(QnStream* stream, bool large, HfsFile* file, const char* name, size_t name_len, uint hash)
+{
+	if (name_len == 0)
+		name_len = strlen(name);
+	file->hash = hash == 0 ? qn_strnshash(name, name_len) : hash;
+	file->source.len = (ushort)name_len;
+
+	byte rec[sizeof(HfsFile)];
+	const size_t size = _hfs_pack_record(large, file, rec);
+	if (size == 0)
+	{
+		errno = EFBIG;
+		return false;
+	}
+	if (qn_stream_write(stream, rec, 0, (int)size) != (int)size ||
 		qn_stream_write(stream, name, 0, (int)name_len) != (int)name_len)
 		return false;
 	return true;
@@ -1882,7 +2616,7 @@ static bool _hfs_write_file_header(QnStream* stream, HfsFile* file, const char*
 
 // 디렉토리
 //static ushort _hfs_write_directory(QnStream* st, const char* name, size_t name_len, uint next, uint meta, QnTimeStamp stc)
-static ushort _hfs_write_directory(QnStream* stream, const char* name, size_t name_len, uint hash, QnTimeStamp stc, uint subp, uint next)
+static ushort _hfs_write_directory(QnStream* stream, bool large, const char* name, size_t name_len, uint hash, QnTimeStamp stc, ullong subp, ullong next)
 {
 	if (stc == 0)
 		stc = qn_now();
@@ -1897,7 +2631,7 @@ static ushort _hfs_write_directory(QnStream* stream, const char* name, size_t na
 		.subp = subp,
 		.next = next,
 	};
-	return _hfs_write_file_header(stream, &info, name, name_len, hash);
+	return _hfs_write_file_header(stream, large, &info, name, name_len, hash);
 }
 
 // 디렉토리 이름 만들기
@@ -1927,9 +2661,9 @@ static void _hfs_make_directory_name(QnPathStr* dir, const char* name)
 }
 
 // 디렉토리 찾기
-static bool _hfs_find_directory(QnStream* stream, HfsInfo* info, const char* name, size_t name_len, uint hash)
+static bool _hfs_find_directory(QnStream* stream, bool large, HfsInfo* info, const char* name, size_t name_len, uint hash)
 {
-	while (qn_stream_read(stream, info, 0, sizeof(HfsFile)) == sizeof(HfsFile))
+	while (_hfs_read_record(stream, large, &info->file))
 	{
 		if (info->file.source.attr == QNFATTR_DIR && info->file.hash == hash && info->file.source.len == name_len)
 		{
@@ -1938,7 +2672,7 @@ static bool _hfs_find_directory(QnStream* stream, HfsInfo* info, const char* nam
 		}
 		if (info->file.next == 0)
 			break;
-		if (qn_stream_seek(stream, info->file.next, QNSEEK_BEGIN) != info->file.next)
+		if (qn_stream_seek(stream, (llong)info->file.next, QNSEEK_BEGIN) != (llong)info->file.next)
 			break;
 	}
 	return false;
@@ -1955,7 +2689,7 @@ static bool _hfs_chdir(QnGam g, const char* directory)
 	if (_hfs_infos_is_have(&self->infos))
 	{
 		const HfsInfo* info = _hfs_infos_ptr_nth(&self->infos, 0);
-		qn_stream_seek(stream, info->file.source.seek, QNSEEK_BEGIN);
+		qn_stream_seek(stream, (llong)info->file.source.seek, QNSEEK_BEGIN);
 	}
 
 	QnPathStr tmp;
@@ -1970,10 +2704,10 @@ static bool _hfs_chdir(QnGam g, const char* directory)
 	char* stk = NULL;
 	for (const char* tok = qn_strtok(tmp.DATA, "\\/\x0\n\r\t", &stk); tok; tok = qn_strtok(NULL, "\\/\x0\n\r\t", &stk))
 	{
-		const uint hash = qn_strshash(tok);
-		if (_hfs_find_directory(stream, &info, tok, strlen(tok), hash) == false)
+		const uint hash = _hfs_hash(self, tok, strlen(tok));
+		if (_hfs_find_directory(stream, self->large, &info, tok, strlen(tok), hash) == false)
 			return false;
-		qn_stream_seek(stream, info.file.subp, QNSEEK_BEGIN);
+		qn_stream_seek(stream, (llong)info.file.subp, QNSEEK_BEGIN);
 		_hfs_make_directory_name(&self->base.path, tok);
 	}
 #ifdef HFS_DEBUG_TRACE
@@ -1983,22 +2717,23 @@ static bool _hfs_chdir(QnGam g, const char* directory)
 #endif
 
 	_hfs_infos_clear(&self->infos);
-	for (uint srt = (uint)qn_stream_tell(stream); srt; srt = info.file.next)
+	for (ullong srt = (ullong)qn_stream_tell(stream); srt; srt = info.file.next)
 	{
-		if (qn_stream_read(stream, &info, 0, sizeof(HfsFile)) != sizeof(HfsFile) ||
+		if (_hfs_read_record(stream, self->large, &info.file) == false ||
+			info.file.source.len >= HFS_MAX_NAME ||
 			qn_stream_read(stream, info.name, 0, info.file.source.len) != info.file.source.len)
 			return false;
 		info.name[info.file.source.len] = '\0';
 
-		qn_stream_seek(stream, info.file.next, QNSEEK_BEGIN);
+		qn_stream_seek(stream, (llong)info.file.next, QNSEEK_BEGIN);
 		info.file.source.seek = srt;
 		_hfs_infos_add(&self->infos, info);
 
 #ifdef HFS_DEBUG_TRACE
 		if (info.file.source.type == QNFTYPE_DIR)
-			qn_outputf("\t\t %04X | %4d | [%s] <%d>", info.file.source.attr, info.file.source.type, info.name, info.file.subp);
+			qn_outputf("\t\t %04X | %4d | [%s] <%llu>", info.file.source.attr, info.file.source.type, info.name, info.file.subp);
 		else
-			qn_outputf("\t\t %04X | %4d | %s <%d>", info.file.source.attr, info.file.source.type, info.name, info.file.source.seek);
+			qn_outputf("\t\t %04X | %4d | %s <%llu>", info.file.source.attr, info.file.source.type, info.name, info.file.source.seek);
 		fc++;
 #endif
 	}
@@ -2030,6 +2765,325 @@ static void _hfs_restore_dir(Hfs* self, const QnPathStr* save)
 		_hfs_chdir(self, save->DATA);
 }
 
+// 전체 경로 만들기, 현재 디렉토리에서 "."과 ".."을 풀어 "/디렉토리/파일" 꼴로 만든다
+static bool _hfs_full_path(const Hfs* self, const char* path, QnPathStr* full)
+{
+	if (path[0] == '/' || path[0] == '\\')
+		_path_str_set_char(full, '/');
+	else
+		_path_str_set_bstr(full, &self->base.path);
+
+	const char* p = path;
+	while (*p != '\0')
+	{
+		const char* s = p;
+		while (*p != '\0' && *p != '/' && *p != '\\')
+			p++;
+		const size_t len = (size_t)(p - s);
+		if (*p != '\0')
+			p++;
+		if (len == 0 || (len == 1 && s[0] == '.'))
+			continue;
+		if (len == 2 && s[0] == '.' && s[1] == '.')
+		{
+			// 루트의 부모는 루트
+			if (full->LENGTH > 1)
+			{
+				size_t n = full->LENGTH - 1;
+				while (n > 0 && full->DATA[n - 1] != '/')
+					n--;
+				_path_str_trunc(full, n);
+			}
+			continue;
+		}
+		if (full->LENGTH + len + 1 >= QN_MAX_PATH - 1)
+			return false;
+		_path_str_add_len(full, s, len);
+		_path_str_add_char(full, '/');
+	}
+
+	if (full->LENGTH > 1)
+		_path_str_trunc(full, full->LENGTH - 1);
+	return true;
+}
+
+// 색인에서 찾기, 루트는 항목이 없으므로 널 (full로 확인)
+static const HfsSource* _hfs_find(const Hfs* self, const char* path, QnPathStr* full)
+{
+	if (strlen(path) >= QN_MAX_PATH - 1 || _hfs_full_path(self, path, full) == false)
+	{
+		errno = ENAMETOOLONG;
+		return NULL;
+	}
+	const HfsSource* source = _hfs_index_get(&self->index, full->DATA);
+	if (source == NULL)
+		errno = ENOENT;
+	return source;
+}
+
+// 색인에서 경로와 그 아래 항목을 모두 뺀다
+static void _hfs_index_drop(Hfs* self, const char* path)
+{
+	_hfs_index_remove(&self->index, (char*)path);
+
+	const size_t len = strlen(path);
+	char** keys = qn_alloc(_hfs_index_count(&self->index) + 1, char*);
+	size_t count = 0;
+	HfsIndexNode* node;
+	QN_FLATHASH_FOREACH(self->index, node)
+	{
+		if (qn_strnicmp(node->KEY, path, len) == 0 && node->KEY[len] == '/')
+			keys[count++] = node->KEY;
+	}
+	for (size_t i = 0; i < count; i++)
+		_hfs_index_remove(&self->index, keys[i]);
+	qn_free(keys);
+}
+
+// 디렉토리를 따라가며 색인 만들기
+static bool _hfs_index_scan(Hfs* self, QnStream* stream, ullong at, QnPathStr* path, size_t* budget)
+{
+	const size_t len = path->LENGTH;
+	HfsInfo info;
+	for (ullong srt = at; srt != 0; srt = info.file.next)
+	{
+		// 고리가 있으면 끝나지 않으니 레코드 갯수 만큼만
+		if (*budget == 0)
+			return false;
+		(*budget)--;
+
+		if (qn_stream_seek(stream, (llong)srt, QNSEEK_BEGIN) != (llong)srt ||
+			_hfs_read_record(stream, self->large, &info.file) == false ||
+			info.file.source.len >= HFS_MAX_NAME ||
+			qn_stream_read(stream, info.name, 0, info.file.source.len) != info.file.source.len)
+			return false;
+		info.name[info.file.source.len] = '\0';
+		if ((info.name[0] == '.' && (info.name[1] == '\0' || (info.name[1] == '.' && info.name[2] == '\0'))) ||
+			len + info.file.source.len + 1 >= QN_MAX_PATH - 1)
+			continue;
+
+		_path_str_add_len(path, info.name, info.file.source.len);
+		_hfs_index_set(&self->index, qn_strdup(path->DATA), _hfs_record_source(&info.file, srt));
+		if (QN_TMASK(info.file.source.attr, QNFATTR_DIR))
+		{
+			_path_str_add_char(path, '/');
+			if (_hfs_index_scan(self, stream, info.file.subp, path, budget) == false)
+				return false;
+		}
+		_path_str_trunc(path, len);
+	}
+	return true;
+}
+
+// 색인 항목 하나의 소스 크기
+INLINE size_t _hfs_index_source_size(bool large)
+{
+	return large ? sizeof(HfsSource) : sizeof(HfsSource32);
+}
+
+// 색인 꼬리 읽기 (v16, v17), 없거나 깨졌으면 거짓
+static bool _hfs_index_load(Hfs* self, QnStream* stream)
+{
+	if (self->header.version < HFS_VERSION)
+		return false;
+
+	// 꼬리 모양은 달라도 헤더는 맨 끝
+	HfsIndexTail64 tail;
+	const size_t tail_size = self->large ? sizeof(HfsIndexTail64) : sizeof(HfsIndexTail);
+	const llong at = qn_stream_size(stream) - (llong)tail_size;
+	if (at < (llong)HFSAT_ROOT || qn_stream_seek(stream, at, QNSEEK_BEGIN) != at)
+		return false;
+	if (self->large)
+	{
+		if (qn_stream_read(stream, &tail, 0, sizeof(HfsIndexTail64)) != sizeof(HfsIndexTail64))
+			return false;
+	}
+	else
+	{
+		HfsIndexTail tail32;
+		if (qn_stream_read(stream, &tail32, 0, sizeof(HfsIndexTail)) != sizeof(HfsIndexTail))
+			return false;
+		tail = (HfsIndexTail64){ .index = tail32.index, .count = tail32.count, .crc = tail32.crc, .header = tail32.header };
+	}
+	if (tail.header != HFS_INDEX || tail.index < HFSAT_ROOT || tail.index > (ullong)at)
+		return false;
+
+	const size_t size = (size_t)((ullong)at - tail.index);
+	const size_t source_size = _hfs_index_source_size(self->large);
+	byte* data = qn_alloc(size + 1, byte);
+	bool ok = qn_stream_seek(stream, (llong)tail.index, QNSEEK_BEGIN) == (llong)tail.index &&
+		qn_stream_read64(stream, data, (llong)size) == (llong)size &&
+		qn_crc32(0, data, size) == tail.crc;
+	if (ok)
+	{
+		_hfs_index_reserve(&self->index, tail.count);
+		char path[QN_MAX_PATH];
+		const byte* ptr = data;
+		const byte* end = data + size;
+		for (uint i = 0; i < tail.count; i++)
+		{
+			HfsSource source;
+			ushort len;
+			if ((size_t)(end - ptr) < source_size + sizeof(ushort))
+			{
+				ok = false;
+				break;
+			}
+			if (self->large)
+				memcpy(&source, ptr, sizeof(HfsSource));
+			else
+			{
+				HfsSource32 source32;
+				memcpy(&source32, ptr, sizeof(HfsSource32));
+				_hfs_source_from32(&source, &source32);
+			}
+			memcpy(&len, ptr + source_size, sizeof(ushort));
+			ptr += source_size + sizeof(ushort);
+			if (len == 0 || len >= QN_MAX_PATH || (size_t)(end - ptr) < len)
+			{
+				ok = false;
+				break;
+			}
+			memcpy(path, ptr, len);
+			path[len] = '\0';
+			ptr += len;
+			_hfs_index_set(&self->index, qn_strdup(path), source);
+		}
+	}
+	qn_free(data);
+
+	if (ok == false)
+	{
+		_hfs_index_clear(&self->index);
+		return false;
+	}
+	self->index_tail = at + (llong)(tail_size - sizeof(uint));
+	self->append = (llong)tail.index;
+	return true;
+}
+
+// 색인 읽기, 색인이 없는 옛날 버전이나 깨진 파일은 디렉토리를 따라가며 만든다
+static void _hfs_index_open(Hfs* self, QnStream* stream)
+{
+	_hfs_index_init(&self->index);
+	if (_hfs_index_load(self, stream))
+		return;
+
+	QnPathStr path;
+	_path_str_set_char(&path, '/');
+	size_t budget = (size_t)(qn_stream_size(stream) / (llong)_hfs_record_size(self->large)) + 1;
+	if (_hfs_index_scan(self, stream, HFSAT_ROOT, &path, &budget) == false)
+		qn_mesgb("Hfs", "broken directory chain, index is partial");
+}
+
+// 색인 항목 정렬
+static int _hfs_index_node_cmp(const void* left, const void* right)
+{
+	const HfsIndexNode* l = *(const HfsIndexNode* const*)left;
+	const HfsIndexNode* r = *(const HfsIndexNode* const*)right;
+	return qn_stricmp(l->KEY, r->KEY);
+}
+
+// 색인을 쓴다 (v16, v17), at이 0이면 파일 끝에 쓰고 아니면 그 자리부터 지금 파일 끝까지 덮어쓴다
+static bool _hfs_index_save(HfsIndex* index, QnStream* stream, bool large, llong at)
+{
+	const size_t count = _hfs_index_count(index);
+	const size_t source_size = _hfs_index_source_size(large);
+	HfsIndexNode** nodes = qn_alloc(count + 1, HfsIndexNode*);
+	size_t n = 0, size = 0;
+	HfsIndexNode* node;
+	QN_FLATHASH_FOREACH(*index, node)
+	{
+		nodes[n++] = node;
+		size += source_size + sizeof(ushort) + strlen(node->KEY);
+	}
+	qn_qsort(nodes, n, sizeof(HfsIndexNode*), _hfs_index_node_cmp);
+
+	// 꼬리가 파일 맨 끝에 와야 하므로 옛 색인보다 짧으면 색인 뒤를 0으로 채운다. 읽을 때는 항목만 본다
+	const size_t tail_size = large ? sizeof(HfsIndexTail64) : sizeof(HfsIndexTail);
+	size_t pad = 0;
+	if (at > 0)
+	{
+		const llong end = qn_stream_size(stream);
+		if (end > at + (llong)(size + tail_size))
+			pad = (size_t)(end - at - (llong)(size + tail_size));
+	}
+	else
+		at = qn_stream_seek(stream, 0, QNSEEK_END);
+
+	// 한번에 쓰려고 버퍼에 모은다
+	bool ok = true;
+	byte* data = qn_alloc(size + pad + 1, byte);
+	byte* ptr = data;
+	for (size_t i = 0; i < n; i++)
+	{
+		const ushort len = (ushort)strlen(nodes[i]->KEY);
+		if (large)
+			memcpy(ptr, &nodes[i]->VALUE, sizeof(HfsSource));
+		else
+		{
+			HfsSource32 source32;
+			ok = _hfs_source_to32(&source32, &nodes[i]->VALUE) && ok;
+			memcpy(ptr, &source32, sizeof(HfsSource32));
+		}
+		memcpy(ptr + source_size, &len, sizeof(ushort));
+		memcpy(ptr + source_size + sizeof(ushort), nodes[i]->KEY, len);
+		ptr += source_size + sizeof(ushort) + len;
+	}
+	qn_free(nodes);
+	memset(ptr, 0, pad);
+	size += pad;
+
+	const uint crc = qn_crc32(0, data, size);
+	ok = ok && at > 0 && qn_stream_seek(stream, at, QNSEEK_BEGIN) == at;
+	if (large)
+	{
+		const HfsIndexTail64 tail = { .index = (ullong)at, .count = (uint)n, .crc = crc, .header = HFS_INDEX };
+		ok = ok &&
+			qn_stream_write64(stream, data, (llong)size) == (llong)size &&
+			qn_stream_write(stream, &tail, 0, sizeof(HfsIndexTail64)) == sizeof(HfsIndexTail64);
+	}
+	else
+	{
+		const HfsIndexTail tail = { .index = (uint)at, .count = (uint)n, .crc = crc, .header = HFS_INDEX };
+		ok = ok && at + (llong)size < (llong)0xFFFFFFFF &&
+			qn_stream_write(stream, data, 0, (int)size) == (int)size &&
+			qn_stream_write(stream, &tail, 0, sizeof(HfsIndexTail)) == sizeof(HfsIndexTail);
+	}
+	qn_free(data);
+	return ok;
+}
+
+// 바뀜 표시. 처음 바뀔 때 읽어온 색인 꼬리를 지워서, 닫기 전에 죽더라도 옛 색인을 믿지 않게 한다
+static void _hfs_touch(Hfs* self)
+{
+	if (self->touch++ == 0 && self->index_tail > 0)
+	{
+		QnStream* stream = qn_get_gam_desc(self, QnStream*);
+		const llong at = self->index_tail;
+		const uint zero = 0;
+		if (qn_stream_seek(stream, at, QNSEEK_BEGIN) == at)
+			qn_stream_write(stream, &zero, 0, sizeof(uint));
+		self->index_tail = 0;
+	}
+}
+
+// 덧붙일 자리로 간다. 읽어온 색인이 있으면 그 자리부터 덮어쓰므로 먼저 바뀜 표시로 옛 꼬리를 지운다
+static llong _hfs_append_seek(Hfs* self, QnStream* stream)
+{
+	if (self->append == 0)
+		return qn_stream_seek(stream, 0, QNSEEK_END);
+	_hfs_touch(self);
+	return qn_stream_seek(stream, self->append, QNSEEK_BEGIN);
+}
+
+// 덧붙이기를 마쳤다. 다음에 덧붙일 위치를 기억한다
+static void _hfs_append_done(Hfs* self, QnStream* stream)
+{
+	if (self->append != 0)
+		self->append = qn_stream_tell(stream);
+}
+
 //
 static bool _hfs_mkdir(QnGam g, const char* directory)
 {
@@ -2049,61 +3103,71 @@ static bool _hfs_mkdir(QnGam g, const char* directory)
 	Hfs* self = qn_cast_type(g, Hfs);
 	QnStream* stream = qn_get_gam_desc(self, QnStream*);
 
-	QnPathStr dir, name, save;
+	QnPathStr dir, name, save, full;
 	_hfs_split_path(directory, &dir, &name);
 	if (name.LENGTH >= HFS_MAX_NAME)
 	{
 		errno = ENAMETOOLONG;
 		return false;
 	}
-	if (_hfs_save_dir(self, &dir, &save) == false)
+	if (_hfs_find(self, directory, &full) == NULL && errno == ENAMETOOLONG)
+		return false;
+	if (_hfs_index_get(&self->index, full.DATA) != NULL || full.LENGTH == 1)
 	{
-		errno = ENOENT;
+		errno = EEXIST;
 		return false;
 	}
-
-	const uint hash = _path_str_shash(&name);
-	size_t i;
-	QN_CTNR_FOREACH(self->infos, 1, i)	// 0번은 현재 디렉토리
+	if (_hfs_save_dir(self, &dir, &save) == false)
 	{
-		const HfsInfo* info = _hfs_infos_ptr_nth(&self->infos, i);
-		if (hash == info->file.hash && name.LENGTH == info->file.source.len && _path_str_icmp(&name, info->name) == 0)
-		{
-			// UNDONE: 옛날 주석에 의하면 패스 잡는 방법이 틀혔다고 함
-			_hfs_restore_dir(self, &save);
-			errno = EEXIST;
-			return false;
-		}
+		errno = ENOENT;
+		return false;
 	}
 
-	if (qn_stream_seek(stream, 0, QNSEEK_END) == 0)
+	const uint hash = _hfs_hash(self, name.DATA, name.LENGTH);
+	if (_hfs_append_seek(self, stream) <= 0)
 	{
 		_hfs_restore_dir(self, &save);
 		return false;
 	}
 
 	// 디렉토리 만들고 "." 추가
-	const uint next = (uint)qn_stream_tell(stream);
-	const uint subp = (uint)(next + sizeof(HfsFile) + name.LENGTH);
+	const size_t record = _hfs_record_size(self->large);
+	const ullong next = (ullong)qn_stream_tell(stream);
+	const ullong subp = next + record + name.LENGTH;
 	const QnTimeStamp stc = qn_now();
-	_hfs_write_directory(stream, name.DATA, name.LENGTH, hash, stc, subp, 0);
-	_hfs_write_directory(stream, ".", 1, 0, stc, subp, (uint)(subp + sizeof(HfsFile) + 1));
+	if (self->large == false && subp + record * 2 + 3 > UINT_MAX)
+	{
+		_hfs_restore_dir(self, &save);
+		errno = EFBIG;
+		return false;
+	}
+	_hfs_write_directory(stream, self->large, name.DATA, name.LENGTH, hash, stc, subp, 0);
+	_hfs_write_directory(stream, self->large, ".", 1, _hfs_hash(self, ".", 1), stc, subp, subp + record + 1);
 
 	// ".." 디렉토리
 	const HfsInfo* parent = _hfs_infos_ptr_nth(&self->infos, 0);
-	_hfs_write_directory(stream, "..", 2, 0, parent->file.stc.stamp, parent->file.source.seek, 0);
+	_hfs_write_directory(stream, self->large, "..", 2, _hfs_hash(self, "..", 2), parent->file.stc.stamp, parent->file.source.seek, 0);
+	_hfs_append_done(self, stream);
 
 	// 지금꺼 갱신
 	const HfsInfo* last = _hfs_infos_ptr_inv(&self->infos, 0);
-	qn_stream_seek(stream, HFSAT_NEXT + last->file.source.seek, QNSEEK_BEGIN);
-	qn_stream_write(stream, &next, 0, (int)sizeof(uint));
+	_hfs_write_next(stream, self->large, last->file.source.seek, next);
+
+	const HfsSource source =
+	{
+		.attr = QNFATTR_DIR,
+		.type = QNFTYPE_DIR,
+		.len = (ushort)name.LENGTH,
+		.seek = next,
+	};
+	_hfs_index_set(&self->index, qn_strdup(full.DATA), source);
 
 	//
 	if (_path_str_is_empty(&save))
 		_path_str_set_char(&save, '.');
 	_hfs_restore_dir(self, &save);
 
-	self->touch++;
+	_hfs_touch(self);
 	return true;
 }
 
@@ -2137,7 +3201,7 @@ static bool _hfs_remove(QnGam g, const char* path)
 		return false;
 	}
 
-	const uint hash = _path_str_shash(&name);
+	const uint hash = _hfs_hash(self, name.DATA, name.LENGTH);
 	const HfsInfo* found = NULL;
 	size_t i;
 	QN_CTNR_FOREACH(self->infos, 1, i)	// 0번은 현재 디렉토리
@@ -2155,10 +3219,8 @@ static bool _hfs_remove(QnGam g, const char* path)
 		return false;
 	}
 
-	const uint next = found->file.next;
 	const HfsInfo* prev = _hfs_infos_ptr_nth(&self->infos, i - 1);
-	if (qn_stream_seek(stream, HFSAT_NEXT + prev->file.source.seek, QNSEEK_BEGIN) <= 0 ||
-		qn_stream_write(stream, &next, 0, sizeof(uint)) != sizeof(uint))
+	if (_hfs_write_next(stream, self->large, prev->file.source.seek, found->file.next) == false)
 	{
 		_hfs_restore_dir(self, &save);
 		return false;
@@ -2167,205 +3229,581 @@ static bool _hfs_remove(QnGam g, const char* path)
 	_hfs_infos_remove_nth(&self->infos, i);
 	_hfs_restore_dir(self, &save);
 
-	self->touch++;
+	QnPathStr full;
+	if (_hfs_full_path(self, path, &full))
+		_hfs_index_drop(self, full.DATA);
+
+	_hfs_touch(self);
 	return true;
 }
 
-// 소스로 읽기
-static void* _hfs_source_read(Hfs* hfs, HfsSource* source)
+// 소스의 압축 코덱
+INLINE QnCodec _hfs_source_codec(const HfsSource* source)
 {
-	QnStream* stream = qn_get_gam_desc(hfs, QnStream*);
-	if (qn_stream_seek(stream, (llong)(source->seek + sizeof(HfsFile) + source->len), QNSEEK_BEGIN) < 0)
-		return NULL;
+	if (QN_TMASK(source->attr, QNFATTR_CMPR) == false)
+		return QNCODEC_STORE;
+	return (source->attr >> HFS_CODEC_SHIFT) == HFS_CODEC_LZ ? QNCODEC_LZ : QNCODEC_DEFLATE;
+}
 
-	byte* data;
-	if (QN_TMASK(source->attr, QNFATTR_CMPR))
+// 조각 압축한 소스인가
+INLINE bool _hfs_source_chunked(const HfsSource* source)
+{
+	return QN_TMASK(source->attr, QNFATTR_CMPR) && (source->attr >> HFS_CODEC_SHIFT) == HFS_CODEC_CHUNK;
+}
+
+// 조각 위치 표 항목 크기
+INLINE size_t _hfs_chunk_entry(const HfsChunkHeader* header)
+{
+	return QN_TMASK(header->flags, HFS_CHUNK_WIDE) ? sizeof(ullong) : sizeof(uint);
+}
+
+// 조각 위치 표 읽기
+INLINE ullong _hfs_chunk_offset(const HfsChunkHeader* header, const byte* table, size_t index)
+{
+	if (QN_TMASK(header->flags, HFS_CHUNK_WIDE))
 	{
-		// 압축
-		byte* cmpr = qn_alloc(source->cmpr, byte);
-		if (qn_stream_read(stream, cmpr, 0, (int)source->cmpr) != (int)source->cmpr)
-		{
-			qn_free(cmpr);
-			return NULL;
-		}
-		data = qn_memzucp_s(cmpr, source->cmpr, source->size);
-		qn_free(cmpr);
+		ullong offset;
+		memcpy(&offset, table + index * sizeof(ullong), sizeof(ullong));
+		return offset;
 	}
+	uint offset;
+	memcpy(&offset, table + index * sizeof(uint), sizeof(uint));
+	return offset;
+}
+
+// 조각 위치 표 쓰기
+INLINE void _hfs_chunk_set_offset(const HfsChunkHeader* header, byte* table, size_t index, ullong offset)
+{
+	if (QN_TMASK(header->flags, HFS_CHUNK_WIDE))
+		memcpy(table + index * sizeof(ullong), &offset, sizeof(ullong));
 	else
 	{
-		// 압축 아님
-		data = qn_alloc(source->size + 4, byte);
-		if (qn_stream_read(stream, data, 0, (int)source->size) != (int)source->size)
-		{
-			qn_free(data);
-			data = NULL;
-		}
+		const uint offset32 = (uint)offset;
+		memcpy(table + index * sizeof(uint), &offset32, sizeof(uint));
 	}
-	return data;
 }
 
-// 소스로 열기
-static QnStream* _hfs_source_open(Hfs* hfs, HfsSource* source, const char* filename)
+// 조각 헤더 검사, 위치 표까지의 크기를 반환하고 틀리면 0
+static size_t _hfs_chunk_check(const HfsSource* source, const HfsChunkHeader* header)
 {
-	QnStream* stream;
-	if (QN_TMASK(source->attr, QNFATTR_CMPR) || QN_TMASK(source->attr, QNFATTR_INDIRECT) == false)
+	if (header->header != HFS_CHUNK || header->codec >= QNCODEC_MAX_VALUE || header->shift < 10 || header->shift > 24 ||
+		(header->flags & ~HFS_CHUNK_WIDE) != 0)
+		return 0;
+	const ullong chunk = 1ULL << header->shift;
+	if (header->count != (source->size + chunk - 1) / chunk)
+		return 0;
+	const ullong table = sizeof(HfsChunkHeader) + _hfs_chunk_entry(header) * ((ullong)header->count + 1);
+	return table <= source->cmpr ? (size_t)table : 0;
+}
+
+// 조각 원래 크기
+INLINE size_t _hfs_chunk_size(const HfsSource* source, const HfsChunkHeader* header, const uint index)
+{
+	const ullong begin = (ullong)index << header->shift;
+	return (size_t)QN_MIN(1ULL << header->shift, source->size - begin);
+}
+
+// 조각 하나 풀기
+static bool _hfs_chunk_decode(QnCodec codec, void* dest, size_t size, const void* src, size_t srcsize)
+{
+	if (srcsize == size)
 	{
-		void* data = _hfs_source_read(hfs, source);
-		stream = data == NULL ? NULL : _create_mem_stream_hfs(qn_cast_type(hfs, QnMount), filename, data, source->size);
+		// 압축 안한 조각
+		memcpy(dest, src, size);
+		return true;
 	}
-	else
+	return qn_memucp_raw(codec, dest, size, src, srcsize);
+}
+
+// 조각 압축 전체 풀기
+static bool _hfs_chunk_decode_all(const HfsSource* source, byte* dest, const byte* cmpr)
+{
+	HfsChunkHeader header;
+	memcpy(&header, cmpr, sizeof(HfsChunkHeader));
+	const size_t table = _hfs_chunk_check(source, &header);
+	if (table == 0)
+		return false;
+
+	const byte* data = cmpr + table;
+	const byte* offsets = cmpr + sizeof(HfsChunkHeader);
+	const ullong data_size = source->cmpr - table;
+	ullong begin = _hfs_chunk_offset(&header, offsets, 0);
+	for (uint i = 0; i < header.count; i++)
 	{
-		llong offset = source->seek + sizeof(HfsFile) + source->len;
-		stream = _indirect_stream_open(qn_cast_type(hfs, QnMount), filename, offset, source->size);
+		const ullong end = _hfs_chunk_offset(&header, offsets, (size_t)i + 1);
+		const size_t size = _hfs_chunk_size(source, &header, i);
+		if (begin > end || end > data_size ||
+			_hfs_chunk_decode((QnCodec)header.codec, dest + ((size_t)i << header.shift), size, data + begin, (size_t)(end - begin)) == false)
+			return false;
+		begin = end;
 	}
-	return stream;
+	return true;
 }
 
-// 파일 읽기
-static void* _hfs_alloc(QnGam g, const char* filename, int* size)
+// 조각 압축 만들기, 압축이 안되는 조각은 그대로 넣는다
+static void* _hfs_chunk_encode(QnCodec codec, const byte* data, size_t size, size_t* sizecmpr)
 {
-	if (strlen(filename) >= QN_MAX_PATH - 1)
+	const uint count = (uint)((size + HFS_CHUNK_SIZE - 1) >> HFS_CHUNK_SHIFT);
+	const size_t bound = QN_MAX(qn_memcpr_bound(codec, HFS_CHUNK_SIZE), HFS_CHUNK_SIZE);
+	// 압축 데이터가 4GB를 넘을 수 있으면 위치 표를 64비트로
+	const bool wide = (ullong)count * bound > HFS_CHUNK_LIMIT;
+	const HfsChunkHeader header =
 	{
-		errno = ENAMETOOLONG;
-		return NULL;
+		.header = HFS_CHUNK,
+		.codec = (byte)codec,
+		.shift = HFS_CHUNK_SHIFT,
+		.flags = wide ? HFS_CHUNK_WIDE : 0,
+		.count = count,
+	};
+	const size_t table = sizeof(HfsChunkHeader) + _hfs_chunk_entry(&header) * ((size_t)count + 1);
+	byte* buffer = qn_alloc(table + (size_t)count * bound, byte);
+
+	memcpy(buffer, &header, sizeof(HfsChunkHeader));
+	byte* offsets = buffer + sizeof(HfsChunkHeader);
+	byte* out = buffer + table;
+	size_t pos = 0;
+	for (uint i = 0; i < count; i++)
+	{
+		const byte* src = data + ((size_t)i << HFS_CHUNK_SHIFT);
+		const size_t len = QN_MIN((size_t)HFS_CHUNK_SIZE, size - ((size_t)i << HFS_CHUNK_SHIFT));
+		size_t n = qn_memcpr_raw(codec, 0, out + pos, src, len);
+		if (n == 0 || n >= len)
+		{
+			memcpy(out + pos, src, len);
+			n = len;
+		}
+		_hfs_chunk_set_offset(&header, offsets, i, pos);
+		pos += n;
 	}
+	_hfs_chunk_set_offset(&header, offsets, count, pos);
 
-	Hfs* self = qn_cast_type(g, Hfs);
+	*sizecmpr = table + pos;
+	return buffer;
+}
 
-	QnPathStr dir, name, keep, *save = QN_TMASK(self->base.flags, QNMFT_NORESTORE) ? NULL : &keep;
-	_hfs_split_path(filename, &dir, &name);
-	if (_path_str_is_empty(&name) || name.DATA[0] == '.')
+// 압축된 소스 해제, 크기를 알고 있으니 한번에 푼다
+static void* _hfs_source_decode(const HfsSource* source, const void* cmpr)
+{
+	byte* data = qn_alloc((size_t)source->size + 4, byte);
+	const bool ok = _hfs_source_chunked(source) ?
+		_hfs_chunk_decode_all(source, data, cmpr) :
+		qn_memucp_raw(_hfs_source_codec(source), data, (size_t)source->size, cmpr, (size_t)source->cmpr);
+	if (ok == false)
 	{
-		errno = EINVAL;
+		qn_free(data);
 		return NULL;
 	}
-	if (_hfs_save_dir(self, &dir, save) == false)
+	return data;
+}
+
+// 매핑된 소스 데이터, 매핑이 없거나 범위를 넘으면 널
+static const byte* _hfs_source_view(const Hfs* hfs, const HfsSource* source)
+{
+	if (hfs->map == NULL)
+		return NULL;
+	const ullong offset = (ullong)_hfs_source_offset(source, hfs->large);
+	const ullong size = QN_TMASK(source->attr, QNFATTR_CMPR) ? source->cmpr : source->size;
+	if (offset > hfs->map_size || size > hfs->map_size - offset)
+		return NULL;
+	return hfs->map + offset;
+}
+
+// 스트림 위치를 건드리지 않고 읽기, 읽기만 한다면 여러 스레드에서 불러도 된다
+static bool _hfs_read_at(Hfs* hfs, void* buffer, size_t size, llong offset)
+{
+	QnStream* stream = qn_get_gam_desc(hfs, QnStream*);
+	if (QN_TMASK(stream->flags, QNFFT_FILE))
+		return _internal_file_read_at(qn_get_gam_desc(stream, nint), buffer, size, offset) == (llong)size;
+	if (QN_TMASK(stream->flags, QNFFT_MEM))
 	{
-		errno = ENOENT;
+		const byte* data = qn_mem_stream_get_data(stream);
+		const llong total = qn_stream_size(stream);
+		if (offset < 0 || offset > total || (llong)size > total - offset)
+			return false;
+		memcpy(buffer, data + offset, size);
+		return true;
+	}
+	// 그 밖의 스트림은 옮겨서 읽는다
+	if (qn_stream_seek(stream, offset, QNSEEK_BEGIN) < 0)
+		return false;
+	return qn_stream_read64(stream, buffer, (llong)size) == (llong)size;
+}
+
+// 소스로 읽기, 압축 풀기는 부른 스레드에서 한다
+static void* _hfs_source_read(Hfs* hfs, const HfsSource* source)
+{
+	if (source->size >= SIZE_MAX - 4 || source->cmpr >= SIZE_MAX)
+	{
+		// 32비트에서는 4GB 넘는 파일을 한번에 읽을 수 없다
+		errno = EFBIG;
 		return NULL;
 	}
 
-	const uint hash = _path_str_shash(&name);
-	HfsInfo* found = NULL;
-	size_t i;
-	QN_CTNR_FOREACH(self->infos, 1, i)	// 0번은 현재 디렉토리
+	const byte* view = _hfs_source_view(hfs, source);
+	if (view != NULL)
 	{
-		HfsInfo* info = _hfs_infos_ptr_nth(&self->infos, i);
-		if (hash == info->file.hash && name.LENGTH == info->file.source.len && _path_str_icmp(&name, info->name) == 0)
+		// 매핑에서 바로 읽는다
+		if (QN_TMASK(source->attr, QNFATTR_CMPR))
+			return _hfs_source_decode(source, view);
+		byte* data = qn_alloc((size_t)source->size + 4, byte);
+		memcpy(data, view, (size_t)source->size);
+		return data;
+	}
+
+	const llong offset = _hfs_source_offset(source, hfs->large);
+	byte* data;
+	if (QN_TMASK(source->attr, QNFATTR_CMPR))
+	{
+		// 압축
+		byte* cmpr = qn_alloc((size_t)source->cmpr, byte);
+		if (_hfs_read_at(hfs, cmpr, (size_t)source->cmpr, offset) == false)
 		{
-			found = info;
-			break;
+			qn_free(cmpr);
+			return NULL;
 		}
+		data = _hfs_source_decode(source, cmpr);
+		qn_free(cmpr);
 	}
-	if (found == NULL)
+	else
 	{
-		_hfs_restore_dir(self, save);
-		errno = ENOENT;
-		return NULL;
+		// 압축 아님
+		data = qn_alloc((size_t)source->size + 4, byte);
+		if (_hfs_read_at(hfs, data, (size_t)source->size, offset) == false)
+		{
+			qn_free(data);
+			data = NULL;
+		}
 	}
+	return data;
+}
 
-	void* data = _hfs_source_read(self, &found->file.source);
-	if (size)
-		*size = (int)found->file.source.size;
+//////////////////////////////////////////////////////////////////////////
+// 조각 스트림, 조각 압축한 HFS 파일을 읽는 만큼만 푼다
 
-	_hfs_restore_dir(self, save);
-	return data;
+// 푼 조각
+typedef struct CHUNKSLOT
+{
+	uint				index;				// 조각 번호, UINT_MAX면 비어 있음
+	byte*				data;
+} ChunkSlot;
+
+//
+typedef struct CHUNKSTREAM
+{
+	QnStream			base;
+	HfsSource			source;
+	HfsChunkHeader		header;
+	llong				offset;				// 조각 데이터 시작 위치
+	ullong*				table;				// 조각 위치 표
+	byte*				cmpr;				// 압축 조각 읽기 버퍼
+	ullong				loc;
+	ChunkSlot			cache[HFS_CHUNK_CACHE];	// 앞쪽이 최근에 쓴 것
+} ChunkStream;
+
+// 조각 얻기, 캐시에 없으면 읽어서 푼다
+static const byte* _chunk_stream_block(ChunkStream* self, const uint index)
+{
+	ChunkSlot slot;
+	int i;
+	for (i = 0; i < HFS_CHUNK_CACHE - 1; i++)
+		if (self->cache[i].index == index)
+			break;
+	slot = self->cache[i];
+	if (slot.index != index)
+	{
+		// 제일 오래된 슬롯에 푼다
+		Hfs* hfs = qn_cast_type(self->base.mount, Hfs);
+		const ullong begin = self->table[index], end = self->table[index + 1];
+		const size_t cmpr_size = (size_t)(end - begin);
+		const size_t size = _hfs_chunk_size(&self->source, &self->header, index);
+		const llong offset = self->offset + (llong)begin;
+		const byte* src;
+		if (hfs->map != NULL && (ullong)offset + cmpr_size <= hfs->map_size)
+			src = hfs->map + offset;
+		else if (_hfs_read_at(hfs, self->cmpr, cmpr_size, offset))
+			src = self->cmpr;
+		else
+			return NULL;
+		if (slot.data == NULL)
+			slot.data = qn_alloc((size_t)1 << self->header.shift, byte);
+		slot.index = UINT_MAX;
+		if (_hfs_chunk_decode((QnCodec)self->header.codec, slot.data, size, src, cmpr_size))
+			slot.index = index;
+	}
+	// 앞으로 옮긴다
+	for (; i > 0; i--)
+		self->cache[i] = self->cache[i - 1];
+	self->cache[0] = slot;
+	return slot.index == index ? slot.data : NULL;
 }
 
-// 파일 열기
-static QnStream* _hfs_stream(QnGam g, const char* filename, const char* mode)
+//
+static int _chunk_stream_read(QnGam g, void* buffer, const int offset, const int size)
 {
-	if (strlen(filename) >= QN_MAX_PATH - 1)
+	ChunkStream* self = qn_cast_type(g, ChunkStream);
+	byte* ptr = (byte*)buffer + offset;
+	const size_t total = (size_t)QN_MIN((ullong)size, self->source.size - self->loc);
+	const ullong mask = (1ULL << self->header.shift) - 1;
+	size_t done = 0;
+	while (done < total)
 	{
-		errno = ENAMETOOLONG;
-		return NULL;
+		const uint index = (uint)(self->loc >> self->header.shift);
+		const byte* block = _chunk_stream_block(self, index);
+		if (block == NULL)
+			return done > 0 ? (int)done : -1;
+		const size_t within = (size_t)(self->loc & mask);
+		const size_t n = QN_MIN(_hfs_chunk_size(&self->source, &self->header, index) - within, total - done);
+		memcpy(ptr + done, block + within, n);
+		self->loc += n;
+		done += n;
 	}
-	if (mode)
+	return (int)done;
+}
+
+//
+static int _chunk_stream_write(QnGam g, const void* buffer, const int offset, const int size)
+{
+	QN_DUMMY(g); QN_DUMMY(buffer); QN_DUMMY(offset); QN_DUMMY(size);
+	qn_mesgb("ChunkStream", "write not supported");
+	return -1;
+}
+
+//
+static llong _chunk_stream_seek(QnGam g, const llong offset, const QnSeek org)
+{
+	ChunkStream* self = qn_cast_type(g, ChunkStream);
+	llong loc;
+	switch ((int)org)
 	{
-		for (const char* p = mode; *p; p++)
-		{
-			if (*p == 'w' || *p == 'a' || *p == '+')
-			{
-				qn_mesgfb("Hfs", "file write mode is not supported: %s (%s)", filename, mode);
-				errno = EACCES;
-				return NULL;
-			}
-		}
+		case QNSEEK_BEGIN:
+			loc = offset;
+			break;
+		case QNSEEK_CUR:
+			loc = (llong)self->loc + offset;
+			break;
+		case QNSEEK_END:
+			loc = (llong)self->source.size + offset;
+			break;
+		default:
+			return -1;
 	}
+	if (loc < 0)
+		loc = 0;
+	self->loc = (ullong)loc <= self->source.size ? (ullong)loc : self->source.size;
+	return (llong)self->loc;
+}
 
-	Hfs* self = qn_cast_type(g, Hfs);
+//
+static llong _chunk_stream_tell(QnGam g)
+{
+	ChunkStream* self = qn_cast_type(g, ChunkStream);
+	return (llong)self->loc;
+}
 
-	QnPathStr dir, name, keep, *save = QN_TMASK(self->base.flags, QNMFT_NORESTORE) ? NULL : &keep;
-	_hfs_split_path(filename, &dir, &name);
-	if (_path_str_is_empty(&name) || name.DATA[0] == '.')
+//
+static llong _chunk_stream_size(QnGam g)
+{
+	ChunkStream* self = qn_cast_type(g, ChunkStream);
+	return (llong)self->source.size;
+}
+
+//
+static bool _chunk_stream_flush(QnGam g)
+{
+	QN_DUMMY(g);
+	return true;
+}
+
+//
+static void _chunk_stream_dispose(QnGam g)
+{
+	ChunkStream* self = qn_cast_type(g, ChunkStream);
+	for (int i = 0; i < HFS_CHUNK_CACHE; i++)
+		qn_free(self->cache[i].data);
+	qn_free(self->cmpr);
+	qn_free(self->table);
+	qn_unload(self->base.mount);
+	qn_free(self->base.name);
+	qn_free(self);
+}
+
+//
+static QnStream* _chunk_stream_dup(QnGam g);
+
+//
+static const struct QNSTREAM_VTABLE _chunk_stream_vt =
+{
+	.base.name = "ChunkStream",
+	.base.dispose = _chunk_stream_dispose,
+	.stream_read = _chunk_stream_read,
+	.stream_write = _chunk_stream_write,
+	.stream_seek = _chunk_stream_seek,
+	.stream_tell = _chunk_stream_tell,
+	.stream_size = _chunk_stream_size,
+	.stream_flush = _chunk_stream_flush,
+	.stream_dup = _chunk_stream_dup,
+};
+
+// 조각 스트림 만들기, 위치 표는 가져온다
+static QnStream* _chunk_stream_init(Hfs* hfs, const char* filename, const HfsSource* source, const HfsChunkHeader* header, llong offset, ullong* table)
+{
+	ChunkStream* self = qn_alloc_zero_1(ChunkStream);
+	self->base.mount = qn_load(hfs);
+	self->base.name = qn_strdup(filename);
+	self->base.flags = QNFF_READ | QNFF_SEEK | QNFFT_HFS | QNFFT_CHUNK;
+	self->source = *source;
+	self->header = *header;
+	self->offset = offset;
+	self->table = table;
+	if (hfs->map == NULL)
+		self->cmpr = qn_alloc((size_t)1 << header->shift, byte);
+	for (int i = 0; i < HFS_CHUNK_CACHE; i++)
+		self->cache[i].index = UINT_MAX;
+	return qn_gam_init(self, _chunk_stream_vt);
+}
+
+// 조각 스트림 복제
+static QnStream* _chunk_stream_dup(QnGam g)
+{
+	ChunkStream* source = qn_cast_type(g, ChunkStream);
+	ullong* table = qn_memdup(source->table, sizeof(ullong) * ((size_t)source->header.count + 1));
+	Hfs* hfs = qn_cast_type(source->base.mount, Hfs);
+	return _chunk_stream_init(hfs, source->base.name, &source->source, &source->header, source->offset, table);
+}
+
+// 조각 스트림 열기, 헤더와 위치 표만 읽는다
+static QnStream* _chunk_stream_open(Hfs* hfs, const HfsSource* source, const char* filename)
+{
+	const llong offset = _hfs_source_offset(source, hfs->large);
+	HfsChunkHeader header;
+	if (_hfs_read_at(hfs, &header, sizeof(HfsChunkHeader), offset) == false)
+		return NULL;
+	const size_t table_size = _hfs_chunk_check(source, &header);
+	if (table_size == 0)
+		return NULL;
+
+	// 위치 표는 64비트로 펴서 들고 있는다
+	const size_t count = (size_t)header.count + 1;
+	const size_t raw_size = table_size - sizeof(HfsChunkHeader);
+	ullong* table = qn_alloc(count, ullong);
+	if (_hfs_read_at(hfs, table, raw_size, offset + (llong)sizeof(HfsChunkHeader)) == false)
 	{
-		errno = EINVAL;
+		qn_free(table);
 		return NULL;
 	}
-	if (_hfs_save_dir(self, &dir, save) == false)
+	if (QN_TMASK(header.flags, HFS_CHUNK_WIDE) == false)
 	{
-		errno = ENOENT;
-		return NULL;
+		// 32비트 표는 뒤에서부터 편다
+		const uint* narrow = (const uint*)table;
+		for (size_t i = count; i > 0; i--)
+			table[i - 1] = narrow[i - 1];
 	}
-
-	const uint hash = _path_str_shash(&name);
-	HfsInfo* found = NULL;
-	size_t i;
-	QN_CTNR_FOREACH(self->infos, 1, i)	// 0번은 현재 디렉토리
+	// 위치 표 검사, 읽을 때는 믿고 쓴다
+	const ullong data_size = source->cmpr - table_size;
+	for (size_t i = 0; i < count; i++)
 	{
-		HfsInfo* info = _hfs_infos_ptr_nth(&self->infos, i);
-		if (hash == info->file.hash && name.LENGTH == info->file.source.len && _path_str_icmp(&name, info->name) == 0)
+		if (table[i] > data_size || (i > 0 && (table[i] < table[i - 1] ||
+			table[i] - table[i - 1] > _hfs_chunk_size(source, &header, (uint)(i - 1)))))
 		{
-			found = info;
-			break;
+			qn_free(table);
+			return NULL;
 		}
 	}
-	if (found == NULL)
+	return _chunk_stream_init(hfs, filename, source, &header, offset + (llong)table_size, table);
+}
+
+// 소스로 열기
+static QnStream* _hfs_source_open(Hfs* hfs, const HfsSource* source, const char* filename)
+{
+	QnStream* stream;
+	const byte* view = QN_TMASK(source->attr, QNFATTR_CMPR) ? NULL : _hfs_source_view(hfs, source);
+	if (_hfs_source_chunked(source))
 	{
-		_hfs_restore_dir(self, save);
-		errno = ENOENT;
-		return NULL;
+		// 조각 압축은 읽을 때 푼다
+		stream = _chunk_stream_open(hfs, source, filename);
+	}
+	else if (view != NULL)
+	{
+		// 압축 안한건 복사하지 않고 매핑을 보여준다
+		stream = _view_stream_init(qn_cast_type(hfs, QnMount), filename, view, (size_t)source->size,
+			QNFF_READ | QNFF_SEEK | QNFFT_MEM | QNFFT_HFS | QNFFT_VIEW);
+	}
+	else if (QN_TMASK(source->attr, QNFATTR_CMPR) || QN_TMASK(source->attr, QNFATTR_INDIRECT) == false)
+	{
+		void* data = _hfs_source_read(hfs, source);
+		stream = data == NULL ? NULL : _create_mem_stream_hfs(qn_cast_type(hfs, QnMount), filename, data, (size_t)source->size);
+	}
+	else
+	{
+		const llong offset = (llong)_hfs_source_offset(source, hfs->large);
+		stream = _indirect_stream_open(qn_cast_type(hfs, QnMount), filename, offset, source->size);
 	}
-
-	QnStream* stream = _hfs_source_open(self, &found->file.source, filename);
-	_hfs_restore_dir(self, save);
 	return stream;
 }
 
-// 파일 있나
-static QnFileAttr _hfs_attr(QnGam g, const char* path)
+// 파일 읽기
+static void* _hfs_alloc(QnGam g, const char* filename, size_t* size)
 {
-	if (strlen(path) >= QN_MAX_PATH - 1)
+	Hfs* self = qn_cast_type(g, Hfs);
+	QnPathStr full;
+	const HfsSource* source = _hfs_find(self, filename, &full);
+	if (source == NULL)
+		return NULL;
+	if (QN_TMASK(source->attr, QNFATTR_DIR))
 	{
-		errno = ENAMETOOLONG;
-		return QNFATTR_NONE;
+		errno = EISDIR;
+		return NULL;
 	}
 
-	Hfs* self = qn_cast_type(g, Hfs);
+	void* data = _hfs_source_read(self, source);
+	if (data != NULL && size != NULL)
+		*size = (size_t)source->size;
+	return data;
+}
 
-	QnPathStr dir, name, keep, *save = QN_TMASK(self->base.flags, QNMFT_NORESTORE) ? NULL : &keep;
-	_hfs_split_path(path, &dir, &name);
-	if (_hfs_save_dir(self, &dir, save) == false)
+// 파일 열기
+static QnStream* _hfs_stream(QnGam g, const char* filename, const char* mode)
+{
+	if (strlen(filename) >= QN_MAX_PATH - 1)
 	{
-		errno = ENOENT;
-		return QNFATTR_NONE;
+		errno = ENAMETOOLONG;
+		return NULL;
 	}
-
-	const uint hash = _path_str_shash(&name);
-	QnFileAttr attr = QNFATTR_NONE;
-	size_t i;
-	QN_CTNR_FOREACH(self->infos, 1, i)	// 0번은 현재 디렉토리
+	if (mode)
 	{
-		const HfsInfo* info = _hfs_infos_ptr_nth(&self->infos, i);
-		if (hash == info->file.hash && name.LENGTH == info->file.source.len && _path_str_icmp(&name, info->name) == 0)
+		for (const char* p = mode; *p; p++)
 		{
-			attr = info->file.source.attr;
-			break;
+			if (*p == 'w' || *p == 'a' || *p == '+')
+			{
+				qn_mesgfb("Hfs", "file write mode is not supported: %s (%s)", filename, mode);
+				errno = EACCES;
+				return NULL;
+			}
 		}
 	}
 
-	_hfs_restore_dir(self, save);
-	return attr;
+	Hfs* self = qn_cast_type(g, Hfs);
+	QnPathStr full;
+	const HfsSource* source = _hfs_find(self, filename, &full);
+	if (source == NULL)
+		return NULL;
+	if (QN_TMASK(source->attr, QNFATTR_DIR))
+	{
+		errno = EISDIR;
+		return NULL;
+	}
+	return _hfs_source_open(self, source, filename);
+}
+
+// 파일 있나
+static QnFileAttr _hfs_attr(QnGam g, const char* path)
+{
+	const Hfs* self = qn_cast_type(g, Hfs);
+	QnPathStr full;
+	const HfsSource* source = _hfs_find(self, path, &full);
+	if (source != NULL)
+		return HFS_ATTR(source->attr);
+	return errno != ENAMETOOLONG && full.LENGTH == 1 ? QNFATTR_DIR : QNFATTR_NONE;
 }
 
 //
@@ -2392,10 +3830,10 @@ static bool _hfs_list_read_info(QnGam g, QnFileInfo* ret)
 	if (info == NULL)
 		return false;
 
-	ret->attr = info->file.source.attr;
+	ret->attr = HFS_ATTR(info->file.source.attr);
 	ret->len = info->file.source.len;
-	ret->size = info->file.source.size;
-	ret->cmpr = info->file.source.cmpr;
+	ret->size = (llong)info->file.source.size;
+	ret->cmpr = (llong)info->file.source.cmpr;
 	ret->stc = info->file.stc.stamp;
 	ret->stw = info->file.stc.stamp;
 	ret->name = info->name;
@@ -2469,14 +3907,14 @@ static QnDir* _hfs_list(_In_ QnGam g, const char* directory, const char* mask)
 	return qn_gam_init(self, _hfs_list_vt);
 }
 
-// HFS 만들기
-static bool _hfs_create_file(_In_ QnStream* stream, char* desc)
+// HFS 만들기, large면 64비트 위치를 쓰는 버전으로 만든다
+static bool _hfs_create_file(_In_ QnStream* stream, char* desc, bool large)
 {
 	QnDateTime dt = { qn_now() };
 	HfsHeader header =
 	{
 		.header = HFS_HEADER,
-		.version = HFS_VERSION,
+		.version = large ? HFS_VERSION_LARGE : HFS_VERSION,
 		.notuse = 0,
 		.stc = dt,
 		.stw = dt,
@@ -2515,12 +3953,12 @@ static bool _hfs_create_file(_In_ QnStream* stream, char* desc)
 	if (qn_stream_write(stream, &header, 0, sizeof(HfsHeader)) != sizeof(HfsHeader))
 		return false;
 
-	_hfs_write_directory(stream, ".", 1, 0, 0, HFSAT_ROOT, 0);
+	_hfs_write_directory(stream, large, ".", 1, 0, 0, HFSAT_ROOT, 0);
 	return true;
 }
 
 // HFS 열기
-static QnStream* _hfs_open_file(const char* filename, bool can_write, bool use_mem, bool is_create, HfsHeader* hdr)
+static QnStream* _hfs_open_file(const char* filename, bool can_write, bool use_mem, bool is_create, bool large, HfsHeader* hdr)
 {
 	QnStream* stream;
 
@@ -2533,7 +3971,7 @@ static QnStream* _hfs_open_file(const char* filename, bool can_write, bool use_m
 			stream = qn_create_mem_stream(filename, 1024);
 			qn_return_when_fail(stream != NULL, NULL);
 
-			_hfs_create_file(stream, NULL);
+			_hfs_create_file(stream, NULL, large);
 			_mem_stream_seek(stream, 0, QNSEEK_BEGIN);
 		}
 		else
@@ -2543,7 +3981,7 @@ static QnStream* _hfs_open_file(const char* filename, bool can_write, bool use_m
 			qn_return_when_fail(filestream != NULL, NULL);
 
 			if (_file_stream_read(filestream, hdr, 0, sizeof(HfsHeader)) != sizeof(HfsHeader) ||
-				hdr->header != HFS_HEADER || hdr->version != HFS_VERSION)
+				hdr->header != HFS_HEADER || HFS_VERSION_OK(hdr->version) == false)
 			{
 				qn_unload(filestream);
 				return NULL;
@@ -2593,14 +4031,14 @@ static QnStream* _hfs_open_file(const char* filename, bool can_write, bool use_m
 		{
 			stream = _file_stream_open(NULL, filename, "wb+@R");
 			qn_return_when_fail(stream != NULL, NULL);
-			_hfs_create_file(stream, NULL);
+			_hfs_create_file(stream, NULL, large);
 			_file_stream_flush(stream);
 			_file_stream_seek(stream, 0, QNSEEK_BEGIN);
 		}
 	}
 
 	if (qn_stream_read(stream, hdr, 0, sizeof(HfsHeader)) != sizeof(HfsHeader) ||
-		hdr->header != HFS_HEADER || hdr->version != HFS_VERSION)
+		hdr->header != HFS_HEADER || HFS_VERSION_OK(hdr->version) == false)
 	{
 		qn_unload(stream);
 		return NULL;
@@ -2623,10 +4061,20 @@ static void _hfs_dispose(QnGam g)
 		self->header.stw.stamp = qn_now();
 		qn_stream_seek(stream, HFSAT_ROOT_STW, QNSEEK_BEGIN);
 		qn_stream_write(stream, &self->header.stw, 0, sizeof(QnDateTime));
+		if (self->header.version >= HFS_VERSION)
+			_hfs_index_save(&self->index, stream, self->large, self->append);
 	}
 
+	_hfs_index_dispose(&self->index);
 	_hfs_infos_dispose(&self->infos);
+	if (self->dedup)
+	{
+		_hfs_bodies_dispose(&self->bodies);
+		qn_free(self->olds);
+	}
 	qn_unload(stream);
+	if (self->map != NULL)
+		qn_file_unmap(self->map, self->map_size);
 	qn_free(self->base.name);
 	qn_free(self);
 }
@@ -2634,7 +4082,7 @@ static void _hfs_dispose(QnGam g)
 // 진짜 만들기
 static QnMount* _create_hfs(const char* filename, const char* mode)
 {
-	bool can_write = false, use_mem = false, is_create = false, no_restore = false;
+	bool can_write = false, use_mem = false, is_create = false, no_restore = false, use_map = false, large = false;
 	if (mode != NULL)
 	{
 		for (const char* p = mode; *p != '\0'; p++)
@@ -2653,17 +4101,22 @@ static QnMount* _create_hfs(const char* filename, const char* mode)
 			}
 			else if (*p == 'f')
 				no_restore = true;
+			else if (*p == 'v')
+				use_map = true;
+			else if (*p == 'l')
+				large = true;
 			else if (*p == '+')
 				can_write = true;
 		}
 	}
 
 	HfsHeader hdr;
-	QnStream* stream = _hfs_open_file(filename, can_write, use_mem, is_create, &hdr);
+	QnStream* stream = _hfs_open_file(filename, can_write, use_mem, is_create, large, &hdr);
 	qn_return_when_fail(stream != NULL, NULL);
 
 	Hfs* self = qn_alloc_zero_1(Hfs);
 	self->header = hdr;
+	self->large = hdr.version == HFS_VERSION_LARGE;
 	self->base.name = qn_strdup(filename);
 	self->base.name_len = filename == NULL ? 0 : strlen(filename);
 	self->base.flags = QNMF_READ | QNMFT_HFS;
@@ -2673,7 +4126,15 @@ static QnMount* _create_hfs(const char* filename, const char* mode)
 		self->base.flags |= QNMF_WRITE;
 	if (no_restore)
 		self->base.flags |= QNMFT_NORESTORE;
+	if (use_map && can_write == false && use_mem == false)
+	{
+		// 쓰지 않을 때만 매핑한다. 실패하면 스트림으로 읽는다
+		self->map = (const byte*)qn_file_map(filename, &self->map_size);
+		if (self->map != NULL)
+			self->base.flags |= QNMFT_MAPPED;
+	}
 	qn_set_gam_desc(self, stream);
+	_hfs_index_open(self, stream);
 	_hfs_chdir(qn_cast_type(self, QnMount), "/");
 
 	static const struct QNMOUNT_VTABLE _hfs_vt =
@@ -2699,20 +4160,191 @@ bool qn_hfs_set_desc(QnMount* mount, const char* desc)
 	qn_return_when_fail((mount->flags & (QNMF_WRITE | QNMFT_HFS)) == (QNMF_WRITE | QNMFT_HFS), false);
 	Hfs* self = qn_cast_type(mount, Hfs);
 	qn_strncpy(self->header.desc, desc, QN_COUNTOF(self->header.desc) - 1);
-	self->touch++;
+	_hfs_touch(self);
 	return true;
 }
 
-// 버퍼 넣기 메인
-static bool _hfs_store_buffer(Hfs* self, const char* filename, const void* data, uint size, bool cmpr, QnFileType type)
+// 넣을 데이터 압축, 압축하지 않고 그대로 넣을 거면 널을 반환
+// 압축하면 속성에 압축과 코덱 비트를 더한다. chunk가 거짓이면 커도 통째로 압축한다 (v16 전 HFS)
+static void* _hfs_store_encode(QnCodec codec, const void* data, size_t size, bool chunk, size_t* sizecmpr, byte* attr)
 {
-	QnPathStr dir, name, save;
+	*sizecmpr = 0;
+	if (codec == QNCODEC_STORE || size == 0)
+		return NULL;
+
+	chunk = chunk && size > HFS_CHUNK_THRESHOLD;
+	void* bufcmpr;
+	if (chunk)
+		bufcmpr = _hfs_chunk_encode(codec, data, size, sizecmpr);
+	else
+	{
+		bufcmpr = qn_alloc(qn_memcpr_bound(codec, size), byte);
+		*sizecmpr = qn_memcpr_raw(codec, 0, bufcmpr, data, size);
+	}
+	// 압축 크기가 96% 이상이면 그냥 넣는다 (예컨데 압축파일)
+	const double d = (double)size * 0.96;
+	if (*sizecmpr == 0 || (double)*sizecmpr >= d)
+	{
+		qn_free(bufcmpr);
+		*sizecmpr = 0;
+		return NULL;
+	}
+
+	*attr |= QNFATTR_CMPR;
+	if (chunk)
+		*attr |= HFS_CODEC_CHUNK << HFS_CODEC_SHIFT;
+	else if (codec == QNCODEC_LZ)
+		*attr |= HFS_CODEC_LZ << HFS_CODEC_SHIFT;
+	return bufcmpr;
+}
+
+#define HFS_BODY_SEED		0x48465342ULL			// 'HFSB'
+#define HFS_BODY_CHECK		0x9E3779B97F4A7C15ULL
+
+// 몸통 해시, kind로 코덱을 섞어서 같은 내용이라도 다르게 넣은 건 따로 본다
+// 해시는 찾는 키로만 쓰고, 링크하기 전에 _hfs_body_same()으로 바이트를 비교한다
+static ullong _hfs_body_hash(const void* data, size_t size, uint kind, ullong* check)
+{
+	*check = qn_hash64(data, size, HFS_BODY_CHECK ^ size);
+	return qn_hash64(data, size, HFS_BODY_SEED) ^ ((ullong)kind * HFS_BODY_CHECK);
+}
+
+// 같은 몸통 찾기
+static const HfsBody* _hfs_body_find(const HfsBodies* bodies, ullong key, ullong check, ullong size)
+{
+	const HfsBody* body = _hfs_bodies_get(bodies, key);
+	return body != NULL && body->check == check && body->source.size == size ? body : NULL;
+}
+
+// 찾은 몸통이 정말 같은지 바이트로 비교한다. 해시가 우연히 겹쳐도 다른 파일을 가리키지 않게
+// stored가 참이면 저장된 모양 그대로, 아니면 풀어서 비교한다
+static bool _hfs_body_same(Hfs* self, const HfsBody* body, const void* data, size_t size, bool stored)
+{
+	void* read;
+	if (stored)
+	{
+		const ullong len = QN_TMASK(body->source.attr, QNFATTR_CMPR) ? body->source.cmpr : body->source.size;
+		if (len != size)
+			return false;
+		read = qn_alloc(size, byte);
+		if (_hfs_read_at(self, read, size, _hfs_source_offset(&body->source, self->large)) == false)
+		{
+			qn_free(read);
+			return false;
+		}
+	}
+	else
+	{
+		read = _hfs_source_read(self, &body->source);
+		if (read == NULL)
+			return false;
+	}
+	const bool same = memcmp(read, data, size) == 0;
+	qn_free(read);
+	return same;
+}
+
+// 몸통 기억하기, 키가 겹치면 먼저 것을 둔다
+static void _hfs_body_add(HfsBodies* bodies, ullong key, ullong check, const HfsSource* source, bool large)
+{
+	if (_hfs_bodies_get(bodies, key) != NULL)
+		return;
+	HfsBody body = { .check = check, .source = *source };
+	body.source.seek = (ullong)_hfs_source_offset(source, large);
+	body.source.attr |= QNFATTR_LINK;
+	_hfs_bodies_set(bodies, key, body);
+}
+
+// 옛 파일 크기 비교
+static int _hfs_old_cmp(const void* left, const void* right)
+{
+	const ullong l = ((const HfsSource*)left)->size, r = ((const HfsSource*)right)->size;
+	return l < r ? -1 : l > r ? 1 : 0;
+}
+
+// 처음 넣을 때 한번, 열 때 있던 파일을 크기 순서로 모아둔다
+static void _hfs_dedup_prepare(Hfs* self)
+{
+	if (self->dedup)
+		return;
+	self->dedup = true;
+	_hfs_bodies_init(&self->bodies);
+	self->olds = qn_alloc(_hfs_index_count(&self->index) + 1, HfsSource);
+	self->old_count = 0;
+	HfsIndexNode* node;
+	QN_FLATHASH_FOREACH(self->index, node)
+	{
+		if (QN_TMASK(node->VALUE.attr, QNFATTR_DIR) == false && node->VALUE.size > 0)
+			self->olds[self->old_count++] = node->VALUE;
+	}
+	qn_qsort(self->olds, self->old_count, sizeof(HfsSource), _hfs_old_cmp);
+}
+
+// 들어 있는 파일의 코덱, 조각 압축은 조각 헤더를 본다
+static QnCodec _hfs_stored_codec(Hfs* self, const HfsSource* source)
+{
+	if (_hfs_source_chunked(source) == false)
+		return _hfs_source_codec(source);
+	HfsChunkHeader header;
+	if (_hfs_read_at(self, &header, sizeof(HfsChunkHeader), _hfs_source_offset(source, self->large)) == false ||
+		header.header != HFS_CHUNK || header.codec >= QNCODEC_MAX_VALUE)
+		return QNCODEC_MAX_VALUE;
+	return (QnCodec)header.codec;
+}
+
+// 크기가 같은 옛 파일을 해시해서 몸통에 넣는다. 파일마다 한번만 읽는다
+static void _hfs_dedup_olds(Hfs* self, ullong size)
+{
+	size_t lo = 0, hi = self->old_count;
+	while (lo < hi)
+	{
+		const size_t mid = (lo + hi) / 2;
+		if (self->olds[mid].size < size)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	for (; lo < self->old_count && self->olds[lo].size == size; lo++)
+	{
+		HfsSource* old = &self->olds[lo];
+		if (old->attr == 0)
+			continue;
+		const QnCodec codec = _hfs_stored_codec(self, old);
+		void* data = codec < QNCODEC_MAX_VALUE ? _hfs_source_read(self, old) : NULL;
+		if (data != NULL)
+		{
+			ullong check;
+			const ullong key = _hfs_body_hash(data, (size_t)size, (uint)codec, &check);
+			_hfs_body_add(&self->bodies, key, check, old, self->large);
+			qn_free(data);
+		}
+		old->attr = 0;	// 다 했다
+	}
+}
+
+// 파일 하나로 넣을 수 있는 최대 크기, 32비트 HFS는 1.99GB(2040MB)까지
+INLINE size_t _hfs_store_limit(const Hfs* self)
+{
+	return self->large ? SIZE_MAX / 2 : (size_t)(2040U * 1024U * 1024U);
+}
+
+// 버퍼 넣기 메인
+static bool _hfs_store_buffer(Hfs* self, const char* filename, const void* data, size_t size, QnCodec codec, QnFileType type)
+{
+	QnPathStr dir, name, save, full;
 	_hfs_split_path(filename, &dir, &name);
 	if (name.LENGTH >= HFS_MAX_NAME)
 	{
 		errno = ENAMETOOLONG;
 		return false;
 	}
+	if (_hfs_find(self, filename, &full) != NULL)
+	{
+		errno = EEXIST;
+		return false;
+	}
+	if (errno == ENAMETOOLONG)
+		return false;
 	if (_hfs_save_dir(self, &dir, &save) == false)
 	{
 		errno = ENOENT;
@@ -2720,101 +4352,99 @@ static bool _hfs_store_buffer(Hfs* self, const char* filename, const void* data,
 	}
 
 	//
-	const uint hash = _path_str_shash(&name);
-	size_t i;
-	QN_CTNR_FOREACH(self->infos, 1, i)	// 0번은 현재 디렉토리
+	const uint hash = _hfs_hash(self, name.DATA, name.LENGTH);
+
+	// v16 전 HFS는 코덱 비트를 모르고 압축이면 모두 통째로 디플레이트로 푼다
+	const bool legacy = self->header.version < HFS_VERSION;
+	if (legacy && codec != QNCODEC_STORE)
+		codec = QNCODEC_DEFLATE;
+
+	// 같은 코덱으로 넣은 같은 내용이 있으면 몸통은 쓰지 않고 링크로 넣는다
+	// 링크는 v16부터라서 옛날 HFS에는 언제나 몸통을 쓴다
+	ullong body_key = 0, body_check = 0;
+	const HfsBody* shared = NULL;
+	const bool dedup = legacy == false && size > 0;
+	if (dedup)
 	{
-		const HfsInfo* info = _hfs_infos_ptr_nth(&self->infos, i);
-		if (hash == info->file.hash && name.LENGTH == info->file.source.len && _path_str_icmp(&name, info->name) == 0)
-		{
-			_hfs_restore_dir(self, &save);
-			errno = EEXIST;
-			return false;
-		}
+		_hfs_dedup_prepare(self);
+		_hfs_dedup_olds(self, size);
+		body_key = _hfs_body_hash(data, size, (uint)codec, &body_check);
+		shared = _hfs_body_find(&self->bodies, body_key, body_check, size);
+		if (shared != NULL && _hfs_body_same(self, shared, data, size, false) == false)
+			shared = NULL;
 	}
 
 	//
-	void* bufcmpr = NULL;
 	size_t sizecmpr = 0;
-	if (cmpr)
+	byte attr = QNFATTR_FILE;
+	void* bufcmpr = NULL;
+	if (shared != NULL)
 	{
-		bufcmpr = qn_memzcpr(data, size, &sizecmpr);
-		if (bufcmpr == NULL)
-		{
-			sizecmpr = 0;
-			cmpr = false;
-		}
-		else
-		{
-			// 압축 크기가 96% 이상이면 그냥 넣는다 (예컨데 압축파일)
-			const double d = size * 0.96;
-			if ((double)sizecmpr >= d)
-			{
-				qn_free(bufcmpr);
-				sizecmpr = 0;
-				cmpr = false;
-			}
-		}
+		attr = shared->source.attr;
+		sizecmpr = (size_t)shared->source.cmpr;
 	}
+	else
+		bufcmpr = _hfs_store_encode(codec, data, size, legacy == false, &sizecmpr, &attr);
 
 	//
 	QnStream* stream = qn_get_gam_desc(self, QnStream*);
-	qn_stream_seek(stream, 0, QNSEEK_END);
-	const uint next = (uint)qn_stream_tell(stream);
+	_hfs_append_seek(self, stream);
+	const ullong next = (ullong)qn_stream_tell(stream);
+	const size_t body_size = shared != NULL ? 0 : bufcmpr != NULL ? sizecmpr : size;
+	if (self->large == false && next + _hfs_record_size(false) + name.LENGTH + body_size > UINT_MAX)
+	{
+		// 32비트 위치로는 못 넣는다. 'l' 모드로 만든 HFS를 써야 한다
+		qn_free(bufcmpr);
+		_hfs_restore_dir(self, &save);
+		errno = EFBIG;
+		return false;
+	}
 
 	HfsInfo file =
 	{
-		.file.source.attr = QNFATTR_FILE,
+		.file.source.attr = attr,
 		.file.source.type = (byte)type,
 		.file.source.size = size,
-		.file.source.cmpr = 0,
+		.file.source.cmpr = sizecmpr,
 		.file.source.seek = 0,
 		.file.stc.stamp = qn_now(),
-		.file.subp = 0,
+		.file.subp = shared != NULL ? shared->source.seek : 0,
 		.file.next = 0,
 		// len, hash는 _hfs_write_file_header()에서 채워진다
 	};
 
-	bool isok = false;
-	if (cmpr)
-	{
-		file.file.source.attr |= QNFATTR_CMPR;
-		file.file.source.cmpr = (uint)sizecmpr;
-		if (_hfs_write_file_header(stream, &file.file, name.DATA, name.LENGTH, hash) &&
-			qn_stream_write(stream, bufcmpr, 0, (int)sizecmpr) == (int)sizecmpr)
-			isok = true;
-		qn_free(bufcmpr);
-	}
-	else
-	{
-		if (_hfs_write_file_header(stream, &file.file, name.DATA, name.LENGTH, hash) &&
-			qn_stream_write(stream, data, 0, (int)size) == (int)size)
-			isok = true;
-	}
+	const void* body = bufcmpr != NULL ? bufcmpr : data;
+	const bool isok = _hfs_write_file_header(stream, self->large, &file.file, name.DATA, name.LENGTH, hash) &&
+		qn_stream_write64(stream, body, (llong)body_size) == (llong)body_size;
+	qn_free(bufcmpr);
 	if (isok == false)
 	{
 		_hfs_restore_dir(self, &save);
 		return false;
 	}
+	_hfs_append_done(self, stream);
 
 	// 지금꺼 갱신
 	HfsInfo* last = _hfs_infos_ptr_inv(&self->infos, 0);
 	last->file.next = next;
-	qn_stream_seek(stream, HFSAT_NEXT + last->file.source.seek, QNSEEK_BEGIN);
-	qn_stream_write(stream, &next, 0, (int)sizeof(uint));
+	_hfs_write_next(stream, self->large, last->file.source.seek, next);
 
 	file.file.source.seek = next;
 	qn_strcpy(file.name, name.DATA);
 	_hfs_infos_add(&self->infos, file);
+	const HfsSource source = _hfs_record_source(&file.file, next);
+	_hfs_index_set(&self->index, qn_strdup(full.DATA), source);
+	if (dedup && shared == NULL)
+		_hfs_body_add(&self->bodies, body_key, body_check, &source, self->large);
 
 	//
 	_hfs_restore_dir(self, &save);
-	self->touch++;
+	_hfs_touch(self);
 	return true;
 }
 
 // 버퍼 넣기
-bool qn_hfs_store_data(QnMount* mount, const char* filename, const void* data, uint size, bool cmpr, QnFileType type)
+bool qn_hfs_store_data(QnMount* mount, const char* filename, const void* data, size_t size, QnCodec codec, QnFileType type)
 {
 	if ((mount->flags & (QNMF_WRITE | QNMFT_HFS)) != (QNMF_WRITE | QNMFT_HFS))
 	{
@@ -2831,18 +4461,18 @@ bool qn_hfs_store_data(QnMount* mount, const char* filename, const void* data, u
 		errno = ENAMETOOLONG;
 		return false;
 	}
-	if (size == 0 || size > (2040U * 1024U * 1024U))	// 1.99GB(2040MB) 이상은 안된다
+	Hfs* self = qn_cast_type(mount, Hfs);
+	if (size == 0 || size > _hfs_store_limit(self))
 	{
 		errno = EINVAL;
 		return false;
 	}
 
-	Hfs* self = qn_cast_type(mount, Hfs);
-	return _hfs_store_buffer(self, filename, data, size, cmpr, type);
+	return _hfs_store_buffer(self, filename, data, size, codec, type);
 }
 
 //
-bool qn_hfs_store_stream(QnMount* mount, const char* filename, QnStream* stream, bool cmpr, QnFileType type)
+bool qn_hfs_store_stream(QnMount* mount, const char* filename, QnStream* stream, QnCodec codec, QnFileType type)
 {
 	if ((mount->flags & (QNMF_WRITE | QNMFT_HFS)) != (QNMF_WRITE | QNMFT_HFS))
 	{
@@ -2860,28 +4490,28 @@ bool qn_hfs_store_stream(QnMount* mount, const char* filename, QnStream* stream,
 		return false;
 	}
 
-	const int size = (int)qn_stream_size(stream);
-	if (size == 0 || (uint)size > (2040U * 1024U * 1024U))	// 1.99GB(2040MB) 이상은 안된다
+	Hfs* self = qn_cast_type(mount, Hfs);
+	const llong size = qn_stream_size(stream);
+	if (size <= 0 || (ullong)size > _hfs_store_limit(self))
 	{
 		errno = EINVAL;
 		return false;
 	}
 
-	void *data = qn_alloc(size, byte);
-	if (qn_stream_seek(stream, 0, QNSEEK_BEGIN) < 0 || qn_stream_read(stream, data, 0, size) != size)
+	void *data = qn_alloc((size_t)size, byte);
+	if (qn_stream_seek(stream, 0, QNSEEK_BEGIN) < 0 || qn_stream_read64(stream, data, size) != size)
 	{
 		qn_free(data);
 		return false;
 	}
 
-	Hfs* self = qn_cast_type(mount, Hfs);
-	const bool ret = _hfs_store_buffer(self, filename, data, size, cmpr, type);
+	const bool ret = _hfs_store_buffer(self, filename, data, (size_t)size, codec, type);
 	qn_free(data);
 	return ret;
 }
 
 //
-bool qn_hfs_store_file(QnMount* mount, const char* filename, const char* srcfile, bool cmpr, QnFileType type)
+bool qn_hfs_store_file(QnMount* mount, const char* filename, const char* srcfile, QnCodec codec, QnFileType type)
 {
 	if ((mount->flags & (QNMF_WRITE | QNMFT_HFS)) != (QNMF_WRITE | QNMFT_HFS))
 	{
@@ -2918,39 +4548,45 @@ bool qn_hfs_store_file(QnMount* mount, const char* filename, const char* srcfile
 	if (stream == NULL)
 		return false;
 
-	const int size = (int)qn_stream_size(stream);
-	if (size == 0 || (uint)size > (2040U * 1024U * 1024U))	// 1.99GB(2040MB) 이상은 안된다
+	Hfs* self = qn_cast_type(mount, Hfs);
+	const llong size = qn_stream_size(stream);
+	if (size <= 0 || (ullong)size > _hfs_store_limit(self))
 	{
 		qn_unload(stream);
 		errno = EINVAL;
 		return false;
 	}
 
-	void *data = qn_alloc(size, byte);
-	if (qn_stream_read(stream, data, 0, size) != size)
+	void *data = qn_alloc((size_t)size, byte);
+	if (qn_stream_read64(stream, data, size) != size)
 	{
 		qn_free(data);
 		qn_unload(stream);
 		return false;
 	}
 
-	Hfs* self = qn_cast_type(mount, Hfs);
-	const bool ret = _hfs_store_buffer(self, filename, data, size, cmpr, type);
+	const bool ret = _hfs_store_buffer(self, filename, data, (size_t)size, codec, type);
 	qn_free(data);
 	qn_unload(stream);
 	return ret;
 }
 
 // 최적화용 파일 읽기
-static void* _hfs_optimize_read(Hfs* hfs, HfsSource* source, uint* ret_size)
+static void* _hfs_optimize_read(Hfs* hfs, HfsSource* source, size_t* ret_size)
 {
 	QnStream* stream = qn_get_gam_desc(hfs, QnStream*);
-	if (qn_stream_seek(stream, (llong)(source->seek + sizeof(HfsFile) + source->len), QNSEEK_BEGIN) < 0)
+	if (qn_stream_seek(stream, (llong)_hfs_source_offset(source, hfs->large), QNSEEK_BEGIN) < 0)
 		return NULL;
 
-	uint size = QN_TMASK(source->attr, QNFATTR_CMPR) ? source->cmpr : source->size;
+	const ullong stored = QN_TMASK(source->attr, QNFATTR_CMPR) ? source->cmpr : source->size;
+	if (stored > SIZE_MAX / 2)
+	{
+		errno = EFBIG;
+		return NULL;
+	}
+	const size_t size = (size_t)stored;
 	byte* data = qn_alloc(size, byte);
-	if (qn_stream_read(stream, data, 0, (int)size) != (int)size)
+	if (qn_stream_read64(stream, data, (llong)size) != (llong)size)
 	{
 		qn_free(data);
 		return NULL;
@@ -2973,6 +4609,7 @@ static bool _hfs_optimize_process(HfsOptimizeData* od)
 	{
 		char path[QN_MAX_PATH];
 		qn_strncpy(path, input->base.path.DATA, input->base.path.LENGTH - 1);
+		path[input->base.path.LENGTH - 1] = '\0';
 		qn_divpath(path, NULL, od->name);
 		od->size = 0;
 		od->count++;
@@ -3012,8 +4649,9 @@ static bool _hfs_optimize_process(HfsOptimizeData* od)
 				param->callback(param->userdata, od);
 			}
 
-			uint size;
-			void* data = _hfs_optimize_read(input, &info->file.source, &size);
+			size_t size;
+			HfsSource source = _hfs_record_source(&info->file, info->file.source.seek);
+			void* data = _hfs_optimize_read(input, &source, &size);
 			if (data == NULL)
 			{
 				_hfs_infos_dispose(&infos);
@@ -3022,13 +4660,28 @@ static bool _hfs_optimize_process(HfsOptimizeData* od)
 
 			QnStream* stream = qn_get_gam_desc(output, QnStream*);
 			qn_stream_seek(stream, 0, QNSEEK_END);
-			const uint next = (uint)qn_stream_tell(stream);
+			const ullong next = (ullong)qn_stream_tell(stream);
 
 			HfsInfo file;
 			memcpy(&file.file, &info->file, sizeof(HfsFile));
+			file.file.source.attr &= (byte)~QNFATTR_LINK;
+			file.file.subp = 0;
+
+			// 저장된 모양 그대로 비교해서 같은 몸통은 한번만 쓴다
+			ullong check;
+			const ullong key = _hfs_body_hash(data, size, 0x100 | file.file.source.attr, &check);
+			const HfsBody* shared = _hfs_body_find(&output->bodies, key, check, file.file.source.size);
+			if (shared != NULL && _hfs_body_same(output, shared, data, size, true) == false)
+				shared = NULL;
+			if (shared != NULL)
+			{
+				file.file.source.attr = shared->source.attr;
+				file.file.subp = shared->source.seek;
+				size = 0;
+			}
 
-			if (_hfs_write_file_header(stream, &file.file, info->name, info->file.source.len, info->file.hash) == false ||
-				qn_stream_write(stream, data, 0, size) != (int)size)
+			if (_hfs_write_file_header(stream, output->large, &file.file, info->name, info->file.source.len, 0) == false ||
+				qn_stream_write64(stream, data, (llong)size) != (llong)size)
 			{
 				qn_free(data);
 				_hfs_infos_dispose(&infos);
@@ -3038,12 +4691,19 @@ static bool _hfs_optimize_process(HfsOptimizeData* od)
 
 			HfsInfo* last = _hfs_infos_ptr_inv(&output->infos, 0);
 			last->file.next = next;
-			qn_stream_seek(stream, HFSAT_NEXT + last->file.source.seek, QNSEEK_BEGIN);
-			qn_stream_write(stream, &next, 0, (int)sizeof(uint));
+			_hfs_write_next(stream, output->large, last->file.source.seek, next);
 
 			file.file.source.seek = next;
 			qn_strcpy(file.name, info->name);
 			_hfs_infos_add(&output->infos, file);
+
+			source = _hfs_record_source(&file.file, next);
+			if (shared == NULL)
+				_hfs_body_add(&output->bodies, key, check, &source, output->large);
+			QnPathStr full;
+			if (_hfs_full_path(output, info->name, &full))
+				_hfs_index_set(&output->index, qn_strdup(full.DATA), source);
+			_hfs_touch(output);
 		}
 	}
 
@@ -3057,11 +4717,12 @@ bool qn_hfs_optimize(QnMount* mount, HfsOptimizeParam* param)
 	qn_return_when_fail(QN_TMASK(mount->flags, QNMFT_HFS), false);
 	qn_return_when_fail(param != NULL, false);
 
-	Hfs* outhfs = qn_cast_type(_create_hfs(param->filename, "c"), Hfs);
+	Hfs* outhfs = qn_cast_type(_create_hfs(param->filename, qn_cast_type(mount, Hfs)->large ? "cl" : "c"), Hfs);
 	qn_return_when_fail(outhfs != NULL, false);
 
 	if (param->desc[0] != '\0')
 		qn_hfs_set_desc(qn_cast_type(outhfs, QnMount), param->desc);
+	_hfs_dedup_prepare(outhfs);
 
 	HfsOptimizeData od =
 	{
@@ -3083,533 +4744,2388 @@ bool qn_hfs_optimize(QnMount* mount, HfsOptimizeParam* param)
 	qn_unload(outhfs);
 	return ret;
 }
-#endif
-
 
 //////////////////////////////////////////////////////////////////////////
-// 만들기!
+// 묶음 저장, 압축은 병렬로 하고 쓰기는 앞에서부터 한번에 한다
+// 파일을 디렉토리 순서대로 먼저 쓰고, 디렉토리 레코드와 색인은 맨 뒤에, 헤더는 마지막에 쓴다
+
+#define HFS_BATCH_WINDOW	(64 * 1024 * 1024)		// 한번에 읽고 압축할 원래 크기
+#define HFS_BATCH_BUFFER	(1024 * 1024)			// 쓰기 버퍼
+#define HFS_BATCH_MAX_SIZE	(SIZE_MAX / 2)			// 파일 하나 최대 크기, 메모리에 올릴 수 있어야 한다
+
+// 묶음 항목
+typedef struct HFSBATCHENTRY
+{
+	char*				path;				// 전체 경로 ("/디렉토리/파일"), 디렉토리 항목이면 디렉토리 경로
+	size_t				dir_len;			// 경로에서 디렉토리 부분 길이
+	char*				srcfile;			// 읽을 디스크 파일 (널이면 data)
+	const void*			data;
+	size_t				size;				// 원래 크기
+	QnCodec				codec;
+	byte				type;
+	bool				is_dir;				// 디렉토리만 만드는 항목
+	byte				attr;				// 압축하고 난 속성
+	uint				dir;				// 들어있는 디렉토리 번호
+	byte*				buffer;				// 읽은 디스크 파일
+	void*				cmpr;				// 압축한 데이터, 널이면 그대로 쓴다
+	size_t				cmpr_size;
+	ullong				hash;				// 내용 해시 (코덱을 섞는다)
+	ullong				check;				// 확인용 해시
+	size_t				link;				// 같은 내용인 앞 항목 번호, 없으면 SIZE_MAX
+	ullong				body;				// 쓴 데이터 위치
+} HfsBatchEntry;
+QN_DECLIMPL_ARRAY(HfsBatchEntryArray, HfsBatchEntry, _hfs_batch_entries);
+
+// 내용 해시로 처음 나온 항목 번호를 찾는다
+QN_DECLIMPL_FLATHASH_INT_TYPE(HfsBatchBodies, ullong, size_t, (void), _hfs_batch_bodies);
+
+// 묶음 디렉토리, 0번은 루트이고 앞 순회 순서로 만들어진다
+typedef struct HFSBATCHDIR
+{
+	const char*			path;				// 전체 경로 (항목 경로를 가리킨다)
+	size_t				path_len;
+	size_t				name_len;			// 경로 끝의 이름 길이
+	uint				parent;
+	uint				child;				// 첫 하위 디렉토리, 없으면 0
+	uint				last;				// 마지막 하위 디렉토리
+	uint				sibling;			// 다음 형제 디렉토리, 없으면 0
+	size_t				file_first;			// 첫 파일 항목 번호
+	size_t				file_count;			// 파일 항목 갯수
+	ullong				entry;				// 부모 목록에 있는 디렉토리 레코드 위치
+	ullong				dot;				// "." 레코드 위치
+	ullong				files;				// 첫 파일 레코드 위치, 없으면 0
+} HfsBatchDir;
+QN_DECLIMPL_ARRAY(HfsBatchDirArray, HfsBatchDir, _hfs_batch_dirs);
+
+// 묶음 저장 상태
+typedef struct HFSBATCH
+{
+	HfsBatchEntryArray	entries;
+	HfsBatchDirArray	dirs;
+	HfsIndex			index;
+	HfsBatchBodies		bodies;
+	size_t				first;				// 압축하는 구간 시작 항목
+	volatile nint		fails;				// 읽기 실패 갯수
+
+	QnStream*			stream;
+	byte*				buffer;				// 쓰기 버퍼
+	size_t				buffer_len;
+	llong				pos;				// 다음에 쓸 위치
+	bool				failed;				// 쓰기 실패
+	bool				large;				// 64비트 위치로 쓴다
+	QnTimeStamp			stamp;
+} HfsBatch;
+
+// 경로를 "/디렉토리/파일" 꼴로 합친다. 루트면 길이가 0
+static bool _hfs_batch_path(char* dest, size_t* len, const char* dir, const char* name)
+{
+	const char* parts[2] = { dir, name };
+	size_t n = 0;
+	for (size_t p = 0; p < QN_COUNTOF(parts); p++)
+	{
+		if (parts[p] == NULL)
+			continue;
+		for (const char* s = parts[p]; *s != '\0';)
+		{
+			if (*s == '/' || *s == '\\')
+			{
+				s++;
+				continue;
+			}
+			const char* e = s;
+			while (*e != '\0' && *e != '/' && *e != '\\')
+				e++;
+			const size_t l = (size_t)(e - s);
+			if (s[0] == '.' && (l == 1 || (l == 2 && s[1] == '.')))
+			{
+				errno = EINVAL;
+				return false;
+			}
+			if (l >= HFS_MAX_NAME || n + l + 1 >= QN_MAX_PATH - 1)
+			{
+				errno = ENAMETOOLONG;
+				return false;
+			}
+			dest[n++] = '/';
+			memcpy(dest + n, s, l);
+			n += l;
+			s = e;
+		}
+	}
+	dest[n] = '\0';
+	*len = n;
+	return true;
+}
 
-//
-QnMount* qn_open_mount(const char* path, const char* mode)
+// 항목 추가
+static bool _hfs_batch_add(HfsBatch* batch, const HfsBatchItem* item, const char* dir, const char* name, const char* srcfile, size_t size, bool is_dir)
 {
-	char* tmppath;
-	bool hfs;
-
-	if (mode != NULL)
-		hfs = qn_strchr(mode, 'h') != NULL;
-	else
+	char path[QN_MAX_PATH];
+	size_t len;
+	if (_hfs_batch_path(path, &len, dir, name) == false)
+		return false;
+	if (len == 0)
 	{
-		mode = "";
-		hfs = false;
+		// 루트는 늘 있다
+		if (is_dir)
+			return true;
+		errno = EINVAL;
+		return false;
 	}
 
-	if (path == NULL)
+	const HfsBatchEntry entry =
 	{
-		// 파일 이름이 없을 때
-		if (hfs)
-			return _create_hfs(NULL, mode);
-		// HFS가 아니라면 현재 기본 경로를 연다
-#if false
-		tmppath = qn_basepath();
-#else
-		tmppath = qn_getcwd(NULL);
-#endif
-		return _create_diskfs(tmppath);
+		.path = qn_strdup(path),
+		.dir_len = is_dir ? len : (size_t)(strrchr(path, '/') - path),
+		.srcfile = srcfile != NULL ? qn_strdup(srcfile) : NULL,
+		.data = srcfile != NULL ? NULL : item->data,
+		.size = size,
+		.codec = item->codec,
+		.type = (byte)item->type,
+		.is_dir = is_dir,
+		.link = SIZE_MAX,
+	};
+	_hfs_batch_entries_add(&batch->entries, entry);
+	return true;
 }
 
-	const QnFileAttr attr = qn_get_file_attr(NULL, path);
-	if (QN_TMASK(attr, QNFATTR_DIR))
+// 디스크 디렉토리를 따라가며 항목 추가, 빈 파일은 건너뛴다
+static bool _hfs_batch_add_tree(HfsBatch* batch, const HfsBatchItem* item, QnMount* mount, const char* sub)
+{
+	QnDir* dir = qn_open_dir(mount, sub, NULL);
+	if (dir == NULL)
 	{
-		// 디렉토리가 있으면 디렉토리를 연다
-		if (hfs)
-			return NULL;
-		tmppath = qn_strdup(path);
-		return _create_diskfs(tmppath);
+		errno = ENOENT;
+		return false;
 	}
-	if (attr != QNFATTR_NONE)
+
+	bool ok = true;
+	QnFileInfo fi;
+	while (ok && qn_dir_read_info(dir, &fi))
 	{
-		// 파일이 있으면 HFS로 열어본다
-		return hfs ? _create_hfs(path, mode) : NULL;
+		if (fi.name[0] == '.' && (fi.name[1] == '\0' || (fi.name[1] == '.' && fi.name[2] == '\0')))
+			continue;
+		char* rel = qn_strdupcat(sub, fi.name, NULL);
+		if (QN_TMASK(fi.attr, QNFATTR_DIR))
+		{
+			char* next = qn_strdupcat(rel, "/", NULL);
+			ok = _hfs_batch_add(batch, item, item->filename, rel, NULL, 0, true) &&
+				_hfs_batch_add_tree(batch, item, mount, next);
+			qn_free(next);
+		}
+		else if (fi.size > (llong)HFS_BATCH_MAX_SIZE)
+		{
+			errno = EINVAL;
+			ok = false;
+		}
+		else if (fi.size > 0)
+		{
+			char* src = qn_strdupcat(item->srcfile, "/", rel, NULL);
+			ok = _hfs_batch_add(batch, item, item->filename, rel, src, (size_t)fi.size, false);
+			qn_free(src);
+		}
+		qn_free(rel);
 	}
+	qn_unload(dir);
+	return ok;
+}
 
-	// 파일이 없네
-	if (hfs)
-		return _create_hfs(path, mode);
+// 항목 하나 펼치기
+static bool _hfs_batch_add_item(HfsBatch* batch, const HfsBatchItem* item)
+{
+	if (item->data != NULL)
+	{
+		if (item->size == 0 || item->size > HFS_BATCH_MAX_SIZE)
+		{
+			errno = EINVAL;
+			return false;
+		}
+		return _hfs_batch_add(batch, item, item->filename, NULL, NULL, item->size, false);
+	}
+	if (item->srcfile == NULL || *item->srcfile == '\0')
+		return _hfs_batch_add(batch, item, item->filename, NULL, NULL, 0, true);
 
-	// HFS가 아니라면 디렉토리를 만든다
-	if (qn_strchr(mode, 'c') != NULL)
+	const QnFileAttr attr = qn_get_file_attr(NULL, item->srcfile);
+	if (attr == QNFATTR_NONE)
 	{
-		if (_internal_mkdir(path) == false)
-			return NULL;
-		tmppath = qn_strdup(path);
-		return _create_diskfs(tmppath);
+		errno = ENOENT;
+		return false;
+	}
+	if (QN_TMASK(attr, QNFATTR_DIR))
+	{
+		QnMount* mount = qn_open_mount(item->srcfile, NULL);
+		if (mount == NULL)
+		{
+			errno = ENOENT;
+			return false;
+		}
+		const bool ok = _hfs_batch_add(batch, item, item->filename, NULL, NULL, 0, true) &&
+			_hfs_batch_add_tree(batch, item, mount, "");
+		qn_unload(mount);
+		return ok;
 	}
 
-	return NULL;
+	size_t size;
+	void* fd = _internal_file_open(item->srcfile, &size);
+	if (fd == NULL)
+	{
+		errno = EINVAL;
+		return false;
+	}
+	_internal_file_close(fd);
+	if (size > HFS_BATCH_MAX_SIZE)
+	{
+		errno = EINVAL;
+		return false;
+	}
+	return _hfs_batch_add(batch, item, item->filename != NULL ? item->filename : item->srcfile, NULL,
+		item->srcfile, size, false);
 }
 
-
-//////////////////////////////////////////////////////////////////////////
-// 퓨즈
-
-// 퓨즈 소스
-typedef struct FUSESOURCE
+// 디렉토리 경로 비교, 대소문자 구별 안하고 '/'를 가장 앞으로 쳐서 하위 디렉토리가 바로 뒤에 이어지게 한다
+static int _hfs_batch_path_cmp(const char* left, size_t left_len, const char* right, size_t right_len)
 {
-	Hfs*			hfs;
-	HfsSource		source;
-	char			name[260];
-} FuseSource;
+	const size_t len = QN_MIN(left_len, right_len);
+	for (size_t i = 0; i < len; i++)
+	{
+		const int l = left[i] == '/' ? 0 : tolower((byte)left[i]);
+		const int r = right[i] == '/' ? 0 : tolower((byte)right[i]);
+		if (l != r)
+			return l - r;
+	}
+	return left_len < right_len ? -1 : left_len > right_len ? 1 : 0;
+}
 
-// Hfs 언로드
-INLINE void _hfs_unload_ptr(Hfs** hfs)
+// 항목 정렬, 디렉토리 순서 다음에 디렉토리 항목이 먼저고 그 다음은 이름 순서
+static int _hfs_batch_entry_cmp(const void* left, const void* right)
 {
-	qn_unload(*hfs);
+	const HfsBatchEntry* l = (const HfsBatchEntry*)left;
+	const HfsBatchEntry* r = (const HfsBatchEntry*)right;
+	int n = _hfs_batch_path_cmp(l->path, l->dir_len, r->path, r->dir_len);
+	if (n != 0)
+		return n;
+	if (l->is_dir != r->is_dir)
+		return l->is_dir ? -1 : 1;
+	n = qn_stricmp(l->path + l->dir_len, r->path + r->dir_len);
+	return n != 0 ? n : strcmp(l->path, r->path);
 }
 
-// 파일 소스 해시
-QN_DECLIMPL_MUKUM(FsMukum, char*, FuseSource, qn_strphash, qn_strpcmp, (void), (void), _fs_mukum);
-// 마운트 해시
-QN_DECLIMPL_MUKUM(HfsMukum, char*, Hfs*, qn_strphash, qn_strpcmp, (void), _hfs_unload_ptr, _hfs_mukum);
-
-// 퓨즈
-typedef struct FUSE
+// 디렉토리에 이 이름 파일이 있나 (파일 항목은 이름 순서로 정렬되어 있다)
+static bool _hfs_batch_has_file(const HfsBatch* batch, const HfsBatchDir* dir, const char* name)
 {
-	QnMount				base;
-
-	HfsMukum			hfss;
-	FsMukum				fss;
-	QnSpinLock			lock;
-	bool				diskfs;
-} Fuse;
+	size_t lo = dir->file_first, hi = dir->file_first + dir->file_count;
+	while (lo < hi)
+	{
+		const size_t mid = lo + (hi - lo) / 2;
+		const HfsBatchEntry* e = _hfs_batch_entries_ptr_nth(&batch->entries, mid);
+		const int n = qn_stricmp(e->path + e->dir_len + 1, name);
+		if (n == 0)
+			return true;
+		if (n < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return false;
+}
 
-//
-static QnStream* _fuse_stream(QnGam g, const char* filename, const char* mode)
+// 정렬된 항목을 따라가며 디렉토리를 만든다. 같은 이름이 있으면 실패
+static bool _hfs_batch_make_dirs(HfsBatch* batch)
 {
-	Fuse* self = qn_cast_type(g, Fuse);
-	QnStream* stream;
-	QN_LOCK(self->lock);
-	if (self->diskfs)
+	const HfsBatchDir root = { .path = "", .parent = 0 };
+	_hfs_batch_dirs_add(&batch->dirs, root);
+
+	uint stack[QN_MAX_PATH / 2 + 1];
+	size_t depth = 0;
+	stack[0] = 0;
+	for (size_t i = 0; i < batch->entries.COUNT; i++)
 	{
-		stream = _file_stream_open(qn_cast_type(self, QnMount), filename, mode);
-		if (stream != NULL)
+		HfsBatchEntry* e = _hfs_batch_entries_ptr_nth(&batch->entries, i);
+		size_t level = 0;
+		for (size_t at = 0; at < e->dir_len;)
 		{
-			QN_UNLOCK(self->lock);
-			return stream;
+			const char* name = e->path + at + 1;
+			size_t len = 0;
+			while (at + 1 + len < e->dir_len && name[len] != '/')
+				len++;
+			at += len + 1;
+
+			if (level < depth)
+			{
+				const HfsBatchDir* d = _hfs_batch_dirs_ptr_nth(&batch->dirs, stack[level + 1]);
+				if (d->name_len == len && qn_strnicmp(d->path + d->path_len - len, name, len) == 0)
+				{
+					level++;
+					continue;
+				}
+			}
+
+			// 새 디렉토리, 부모에 같은 이름 파일이 있으면 안된다
+			char tmp[HFS_MAX_NAME];
+			memcpy(tmp, name, len);
+			tmp[len] = '\0';
+			const uint parent = stack[level];
+			if (_hfs_batch_has_file(batch, _hfs_batch_dirs_ptr_nth(&batch->dirs, parent), tmp))
+			{
+				errno = EEXIST;
+				return false;
+			}
+			const uint index = (uint)batch->dirs.COUNT;
+			const HfsBatchDir dir = { .path = e->path, .path_len = at, .name_len = len, .parent = parent };
+			_hfs_batch_dirs_add(&batch->dirs, dir);
+			HfsBatchDir* p = _hfs_batch_dirs_ptr_nth(&batch->dirs, parent);
+			if (p->child == 0)
+				p->child = index;
+			else
+				_hfs_batch_dirs_ptr_nth(&batch->dirs, p->last)->sibling = index;
+			p->last = index;
+			stack[++level] = index;
+			depth = level;
+		}
+		depth = level;
+		e->dir = stack[level];
+		if (e->is_dir)
+			continue;
+
+		HfsBatchDir* d = _hfs_batch_dirs_ptr_nth(&batch->dirs, e->dir);
+		if (d->file_count == 0)
+			d->file_first = i;
+		else
+		{
+			const HfsBatchEntry* prev = _hfs_batch_entries_ptr_nth(&batch->entries, i - 1);
+			if (qn_stricmp(prev->path + prev->dir_len, e->path + e->dir_len) == 0)
+			{
+				errno = EEXIST;
+				return false;
+			}
 		}
+		d->file_count++;
 	}
+	return true;
+}
 
-	FuseSource* pfs = _fs_mukum_get(&self->fss, filename);
-	stream = pfs == NULL ? NULL : _hfs_source_open(pfs->hfs, &pfs->source, pfs->name);
-	QN_UNLOCK(self->lock);
-	return stream;
+// 32비트 위치로 모자랄지, 압축 안한 크기로 어림하니 넉넉하다
+static bool _hfs_batch_need_large(const HfsBatch* batch)
+{
+	ullong total = sizeof(HfsHeader) + HFS_BATCH_BUFFER;	// 색인 몫까지 넉넉히
+	for (size_t i = 0; i < batch->entries.COUNT; i++)
+	{
+		const HfsBatchEntry* e = _hfs_batch_entries_ptr_nth(&batch->entries, i);
+		total += sizeof(HfsFile) * 3 + strlen(e->path) + e->size;
+	}
+	return total >= UINT_MAX;
 }
 
-//
-static void* _fuse_alloc(QnGam g, const char* filename, int* size)
+// 읽고 해시하기, 일꾼 스레드에서 돈다
+static void _hfs_batch_read(void* context, size_t begin, size_t end)
 {
-	Fuse* self = qn_cast_type(g, Fuse);
-	void* data;
-	QN_LOCK(self->lock);
-	if (self->diskfs)
+	HfsBatch* batch = (HfsBatch*)context;
+	for (size_t i = begin; i < end; i++)
 	{
-		data = _disk_fs_alloc(self, filename, size);
-		if (data != NULL)
+		HfsBatchEntry* e = _hfs_batch_entries_ptr_nth(&batch->entries, batch->first + i);
+		if (e->is_dir)
+			continue;
+		const void* data = e->data;
+		if (e->srcfile != NULL)
 		{
-			QN_UNLOCK(self->lock);
-			return data;
+			size_t size;
+			e->buffer = qn_file_alloc64(NULL, e->srcfile, &size);
+			if (e->buffer == NULL || size != e->size)
+			{
+				// 모은 다음 크기가 바뀌면 위치 계산이 틀어진다
+				qn_free(e->buffer);
+				e->buffer = NULL;
+				qn_atomic_add(&batch->fails, 1);
+				continue;
+			}
+			data = e->buffer;
 		}
+		e->hash = _hfs_body_hash(data, e->size, (uint)e->codec, &e->check);
 	}
+}
 
-	FuseSource* pfs = _fs_mukum_get(&self->fss, filename);
-	if (pfs == NULL)
-		data = NULL;
-	else
+// 해시가 같은 앞 항목과 바이트로 비교한다. 앞 구간에서 쓰고 놓은 항목은 원본 파일을 다시 읽는다
+static bool _hfs_batch_same(const HfsBatchEntry* o, const void* data)
+{
+	const void* prev = o->buffer != NULL ? o->buffer : o->srcfile == NULL ? o->data : NULL;
+	if (prev != NULL)
+		return memcmp(prev, data, o->size) == 0;
+	size_t size;
+	void* read = qn_file_alloc64(NULL, o->srcfile, &size);
+	const bool same = read != NULL && size == o->size && memcmp(read, data, size) == 0;
+	qn_free(read);
+	return same;
+}
+
+// 같은 내용은 처음 나온 항목에 잇는다. 순서대로 보니까 결과는 늘 같다
+static void _hfs_batch_dedup(HfsBatch* batch, size_t first, size_t last)
+{
+	for (size_t i = first; i < last; i++)
 	{
-		data = _hfs_source_read(pfs->hfs, &pfs->source);
-		if (data != NULL)
-			*size = pfs->source.size;
+		HfsBatchEntry* e = _hfs_batch_entries_ptr_nth(&batch->entries, i);
+		if (e->is_dir || e->size == 0)
+			continue;
+		const size_t* found = _hfs_batch_bodies_get(&batch->bodies, e->hash);
+		if (found == NULL)
+		{
+			_hfs_batch_bodies_set(&batch->bodies, e->hash, i);
+			continue;
+		}
+		const HfsBatchEntry* o = _hfs_batch_entries_ptr_nth(&batch->entries, *found);
+		if (o->check != e->check || o->size != e->size || o->codec != e->codec ||
+			_hfs_batch_same(o, e->buffer != NULL ? e->buffer : e->data) == false)
+			continue;
+		e->link = *found;
+		qn_free(e->buffer);
+		e->buffer = NULL;
 	}
-	QN_UNLOCK(self->lock);
-	return data;
 }
 
-//
-static QnFileAttr _fuse_attr(QnGam g, const char* path)
+// 압축하기, 일꾼 스레드에서 돈다
+static void _hfs_batch_compress(void* context, size_t begin, size_t end)
 {
-	Fuse* self = qn_cast_type(g, Fuse);
-	QnFileAttr attr;
-	QN_LOCK(self->lock);
-	if (self->diskfs)
+	HfsBatch* batch = (HfsBatch*)context;
+	for (size_t i = begin; i < end; i++)
 	{
-		attr = _disk_fs_attr(self, path);
-		if (attr != QNFATTR_NONE)
+		HfsBatchEntry* e = _hfs_batch_entries_ptr_nth(&batch->entries, batch->first + i);
+		if (e->is_dir || e->link != SIZE_MAX)
+			continue;
+		const void* data = e->buffer != NULL ? e->buffer : e->data;
+		e->attr = QNFATTR_FILE;
+		e->cmpr = _hfs_store_encode(e->codec, data, e->size, true, &e->cmpr_size, &e->attr);
+		if (e->cmpr != NULL)
 		{
-			QN_UNLOCK(self->lock);
-			return attr;
+			// 압축했으면 읽은 건 필요 없다
+			qn_free(e->buffer);
+			e->buffer = NULL;
 		}
 	}
-	FuseSource* pfs = _fs_mukum_get(&self->fss, path);
-	attr = pfs != NULL ? pfs->source.attr : QNFATTR_NONE;
-	QN_UNLOCK(self->lock);
-	return attr;
 }
 
-//
-static bool _fuse_remove(QnGam g, const char* path)
+// 쓰기 버퍼 비우기
+static void _hfs_batch_flush(HfsBatch* batch)
 {
-	Fuse* self = qn_cast_type(g, Fuse);
-	QN_LOCK(self->lock);
-	if (self->diskfs)
+	if (batch->buffer_len > 0 &&
+		qn_stream_write(batch->stream, batch->buffer, 0, (int)batch->buffer_len) != (int)batch->buffer_len)
+		batch->failed = true;
+	batch->buffer_len = 0;
+}
+
+// 버퍼에 모아서 쓰기
+static void _hfs_batch_write(HfsBatch* batch, const void* data, size_t size)
+{
+	if (batch->buffer_len + size > HFS_BATCH_BUFFER)
+		_hfs_batch_flush(batch);
+	if (size >= HFS_BATCH_BUFFER)
 	{
-		if (_disk_fs_remove(self, path))
+		if (qn_stream_write64(batch->stream, data, (llong)size) != (llong)size)
+			batch->failed = true;
+	}
+	else
+	{
+		memcpy(batch->buffer + batch->buffer_len, data, size);
+		batch->buffer_len += size;
+	}
+	batch->pos += (llong)size;
+}
+
+// 레코드 쓰기, 32비트로 안 들어가면 실패
+static void _hfs_batch_write_record(HfsBatch* batch, const HfsFile* file)
+{
+	byte rec[sizeof(HfsFile)];
+	const size_t size = _hfs_pack_record(batch->large, file, rec);
+	if (size == 0)
+		batch->failed = true;
+	else
+		_hfs_batch_write(batch, rec, size);
+}
+
+// 디렉토리 레코드 쓰기, 크기와 위치는 0으로 채워서 같은 입력이면 같은 결과가 나오게 한다
+static void _hfs_batch_write_directory(HfsBatch* batch, const char* name, size_t name_len, ullong subp, ullong next)
+{
+	const HfsFile file =
+	{
+		.source.attr = QNFATTR_DIR,
+		.source.type = QNFTYPE_DIR,
+		.source.len = (ushort)name_len,
+		.stc.stamp = batch->stamp,
+		.hash = qn_strnshash(name, name_len),
+		.subp = subp,
+		.next = next,
+	};
+	_hfs_batch_write_record(batch, &file);
+	_hfs_batch_write(batch, name, name_len);
+}
+
+// 압축해둔 파일 항목 쓰기
+static void _hfs_batch_write_file(HfsBatch* batch, size_t nth)
+{
+	HfsBatchEntry* e = _hfs_batch_entries_ptr_nth(&batch->entries, nth);
+	HfsBatchDir* d = _hfs_batch_dirs_ptr_nth(&batch->dirs, e->dir);
+	const char* name = e->path + e->dir_len + 1;
+	const size_t name_len = strlen(name);
+	const void* body = e->cmpr != NULL ? e->cmpr : e->buffer != NULL ? e->buffer : e->data;
+	size_t body_size = e->cmpr != NULL ? e->cmpr_size : e->size;
+
+	const ullong at = (ullong)batch->pos;
+	e->body = at + _hfs_record_size(batch->large) + name_len;
+	if (e->link != SIZE_MAX)
+	{
+		// 앞에 쓴 데이터를 가리키는 링크
+		const HfsBatchEntry* o = _hfs_batch_entries_ptr_nth(&batch->entries, e->link);
+		e->attr = o->attr | QNFATTR_LINK;
+		e->cmpr_size = o->cmpr_size;
+		e->body = o->body;
+		body_size = 0;
+	}
+	const ullong next = at + _hfs_record_size(batch->large) + name_len + body_size;
+	if (d->files == 0)
+		d->files = at;
+	const bool last = nth + 1 == d->file_first + d->file_count;
+	const HfsFile file =
+	{
+		.source.attr = e->attr,
+		.source.type = e->type,
+		.source.len = (ushort)name_len,
+		.source.size = e->size,
+		.source.cmpr = e->cmpr_size,
+		.stc.stamp = batch->stamp,
+		.hash = qn_strnshash(name, name_len),
+		.subp = e->link != SIZE_MAX ? e->body : 0,
+		.next = last ? 0 : next,
+	};
+	_hfs_batch_write_record(batch, &file);
+	_hfs_batch_write(batch, name, name_len);
+	_hfs_batch_write(batch, body, body_size);
+
+	_hfs_index_set(&batch->index, qn_strdup(e->path), _hfs_record_source(&file, at));
+
+	qn_free(e->cmpr);
+	qn_free(e->buffer);
+	e->cmpr = NULL;
+	e->buffer = NULL;
+}
+
+// 디렉토리 레코드를 파일 뒤에 몰아서 쓴다. 루트 "."는 헤더 뒤에 따로 쓴다
+static void _hfs_batch_write_dirs(HfsBatch* batch)
+{
+	// 위치 먼저 정하고
+	const size_t rs = _hfs_record_size(batch->large);
+	ullong pos = (ullong)batch->pos;
+	for (size_t i = 0; i < batch->dirs.COUNT; i++)
+	{
+		HfsBatchDir* d = _hfs_batch_dirs_ptr_nth(&batch->dirs, i);
+		if (i == 0)
+			d->dot = HFSAT_ROOT;
+		else
 		{
-			QN_UNLOCK(self->lock);
-			return true;
+			d->dot = pos;
+			pos += rs * 2 + 3;
+		}
+		for (uint c = d->child; c != 0;)
+		{
+			HfsBatchDir* child = _hfs_batch_dirs_ptr_nth(&batch->dirs, c);
+			child->entry = pos;
+			pos += rs + child->name_len;
+			c = child->sibling;
 		}
 	}
 
-	bool ret;
-	FuseSource* pfs = _fs_mukum_get(&self->fss, path);
-	if (pfs == NULL)
-		ret = false;
-	else
+	// 그 다음 쓴다. 목록은 ".", "..", 하위 디렉토리, 파일 순서
+	for (size_t i = 0; i < batch->dirs.COUNT; i++)
 	{
-		_hfs_remove(pfs->hfs, path);
-		ret = _fs_mukum_remove(&self->fss, path);
+		const HfsBatchDir* d = _hfs_batch_dirs_ptr_nth(&batch->dirs, i);
+		if (i != 0)
+		{
+			const HfsBatchDir* parent = _hfs_batch_dirs_ptr_nth(&batch->dirs, d->parent);
+			const ullong head = d->child != 0 ? _hfs_batch_dirs_ptr_nth(&batch->dirs, d->child)->entry : d->files;
+			_hfs_batch_write_directory(batch, ".", 1, d->dot, d->dot + rs + 1);
+			_hfs_batch_write_directory(batch, "..", 2, parent->dot, head);
+		}
+		for (uint c = d->child; c != 0;)
+		{
+			const HfsBatchDir* child = _hfs_batch_dirs_ptr_nth(&batch->dirs, c);
+			const ullong next = child->sibling != 0 ? _hfs_batch_dirs_ptr_nth(&batch->dirs, child->sibling)->entry : d->files;
+			_hfs_batch_write_directory(batch, child->path + child->path_len - child->name_len, child->name_len, child->dot, next);
+
+			const HfsSource source =
+			{
+				.attr = QNFATTR_DIR,
+				.type = QNFTYPE_DIR,
+				.len = (ushort)child->name_len,
+				.seek = child->entry,
+			};
+			char* key = qn_alloc(child->path_len + 1, char);
+			memcpy(key, child->path, child->path_len);
+			key[child->path_len] = '\0';
+			_hfs_index_set(&batch->index, key, source);
+			c = child->sibling;
+		}
 	}
-	QN_UNLOCK(self->lock);
-	return ret;
 }
 
-//
-static void _fuse_dispose(QnGam g)
+// 헤더와 루트 "."는 다 쓰고 나서
+static bool _hfs_batch_write_header(HfsBatch* batch, const HfsBatchParam* param)
 {
-	Fuse* self = qn_cast_type(g, Fuse);
+	HfsHeader header;
+	memset(&header, 0, sizeof(HfsHeader));		// 구조체 빈 공간까지 0으로
+	header.header = HFS_HEADER;
+	header.version = batch->large ? HFS_VERSION_LARGE : HFS_VERSION;
+	header.stc.stamp = batch->stamp;
+	header.stw.stamp = batch->stamp;
+	qn_strncpy(header.desc, param->desc, QN_COUNTOF(header.desc) - 1);
 
-	_fs_mukum_dispose(&self->fss);
-	_hfs_mukum_dispose(&self->hfss);
-	qn_free(self->base.name);
-	qn_free(self);
+	const HfsBatchDir* root = _hfs_batch_dirs_ptr_nth(&batch->dirs, 0);
+	const ullong head = root->child != 0 ? _hfs_batch_dirs_ptr_nth(&batch->dirs, root->child)->entry : root->files;
+	if (qn_stream_seek(batch->stream, 0, QNSEEK_BEGIN) != 0)
+		return false;
+	batch->pos = 0;
+	_hfs_batch_write(batch, &header, sizeof(HfsHeader));
+	_hfs_batch_write_directory(batch, ".", 1, HFSAT_ROOT, head);
+	_hfs_batch_flush(batch);
+	return batch->failed == false;
 }
 
-// HFS 분석
-static void _fuse_parse_hfs(Fuse* self, Hfs* hfs, const char* dir)
+// 묶음 정리
+static void _hfs_batch_dispose(HfsBatch* batch)
 {
-	HfsInfoArray infos;
-	_hfs_infos_init_copy(&infos, &hfs->infos);
+	for (size_t i = 0; i < batch->entries.COUNT; i++)
+	{
+		HfsBatchEntry* e = _hfs_batch_entries_ptr_nth(&batch->entries, i);
+		qn_free(e->path);
+		qn_free(e->srcfile);
+		qn_free(e->buffer);
+		qn_free(e->cmpr);
+	}
+	_hfs_batch_entries_dispose(&batch->entries);
+	_hfs_batch_dirs_dispose(&batch->dirs);
+	_hfs_index_dispose(&batch->index);
+	_hfs_batch_bodies_dispose(&batch->bodies);
+	qn_free(batch->buffer);
+	qn_unload(batch->stream);
+}
 
-	QnPathStr bs;
-	_path_str_set(&bs, dir);
-	size_t bpos = _path_str_len(&bs);
+// 파일을 구간마다 병렬로 압축하고 순서대로 쓴다
+static bool _hfs_batch_process(HfsBatch* batch, HfsBatchParam* param)
+{
+	// 헤더와 루트 "." 자리
+	static const byte zero[sizeof(HfsHeader) + sizeof(HfsFile) + 1] = { 0 };
+	_hfs_batch_write(batch, zero, sizeof(HfsHeader) + _hfs_record_size(batch->large) + 1);
 
-	size_t i;
-	QN_ARRAY_FOREACH(infos, 1, i)	// 0번은 현재 디렉토리
+	const size_t count = batch->entries.COUNT;
+	for (size_t first = 0; first < count;)
 	{
-		HfsInfo* info = _hfs_infos_ptr_nth(&infos, i);
-		if (info->name[0] == '.')
-			continue;
+		size_t last = first, bytes = 0;
+		while (last < count && (last == first || bytes + _hfs_batch_entries_nth(&batch->entries, last).size <= HFS_BATCH_WINDOW))
+			bytes += _hfs_batch_entries_nth(&batch->entries, last++).size;
 
-		_path_str_add(&bs, info->name);
-		if (QN_TMASK(info->file.source.attr, QNFATTR_DIR))
+		batch->first = first;
+		qn_parallel_for(last - first, 1, _hfs_batch_read, batch);
+		if (batch->fails != 0)
 		{
-			_path_str_add_char(&bs, '/');
-			_hfs_chdir(hfs, bs.DATA);
-			_fuse_parse_hfs(self, hfs, bs.DATA);
-			_hfs_chdir(hfs, "..");
+			errno = EIO;
+			return false;
 		}
-		else
+		_hfs_batch_dedup(batch, first, last);
+		qn_parallel_for(last - first, 1, _hfs_batch_compress, batch);
+
+		for (; first < last; first++)
 		{
-			FsMukumNode* node = qn_alloc_1(FsMukumNode);
-			node->VALUE.hfs = hfs;
-			node->VALUE.source = info->file.source;
-			qn_strcpy(node->VALUE.name, bs.DATA);
-			node->KEY = node->VALUE.name;
-			if (!_fs_mukum_add(&self->fss, node))
-				qn_free(node);
+			const HfsBatchEntry* e = _hfs_batch_entries_ptr_nth(&batch->entries, first);
+			if (e->is_dir)
+				continue;
+			param->files++;
+			param->size += e->size;
+			if (e->link != SIZE_MAX)
+				param->links++;
+			_hfs_batch_write_file(batch, first);
+		}
+		if (batch->failed || (batch->large == false && batch->pos >= (llong)0xFFFFFFFF))
+		{
+			errno = batch->failed ? EIO : EFBIG;
+			return false;
 		}
-		_path_str_trunc(&bs, bpos);
 	}
 
-	_hfs_infos_dispose(&infos);
+	_hfs_batch_write_dirs(batch);
+	_hfs_batch_flush(batch);
+	param->dirs = (uint)batch->dirs.COUNT - 1;
+	if (batch->failed || _hfs_index_save(&batch->index, batch->stream, batch->large, 0) == false)
+	{
+		errno = batch->failed ? EIO : EFBIG;
+		return false;
+	}
+	return _hfs_batch_write_header(batch, param);
 }
 
-// HFS 추가
-static bool _fuse_add_hfs(Fuse* self, const char* name)
+//
+bool qn_hfs_store_batch(const HfsBatchItem* items, size_t count, HfsBatchParam* param)
 {
-	Hfs** phfs = _hfs_mukum_get(&self->hfss, name);
-	qn_return_when_fail(phfs == NULL, false);
+	qn_return_when_fail(param != NULL && param->filename[0] != '\0', false);
+	qn_return_when_fail(items != NULL || count == 0, false);
 
-	Hfs* hfs = (Hfs*)_create_hfs(name, "f");
-	if (hfs == NULL)
-		return false;
-	_hfs_mukum_set(&self->hfss, hfs->base.name, hfs);
-	_fuse_parse_hfs(self, hfs, "/");
-	return true;
+	param->files = param->dirs = param->links = 0;
+	param->size = param->written = 0;
+	param->elapsed = param->mbps = 0.0;
+	const double start = qn_elapsed();
+
+	HfsBatch batch = { .stamp = param->stamp };
+	_hfs_batch_entries_init(&batch.entries, count);
+	_hfs_batch_dirs_init(&batch.dirs, 0);
+	_hfs_index_init(&batch.index);
+	_hfs_batch_bodies_init(&batch.bodies);
+
+	bool ok = true;
+	for (size_t i = 0; ok && i < count; i++)
+		ok = _hfs_batch_add_item(&batch, &items[i]);
+	if (ok)
+	{
+		// 순서를 정해두면 같은 입력에서 같은 파일이 나온다
+		_hfs_batch_entries_sort(&batch.entries, _hfs_batch_entry_cmp);
+		ok = _hfs_batch_make_dirs(&batch);
+		batch.large = param->large || _hfs_batch_need_large(&batch);
+		param->large = batch.large;
+	}
+	if (ok)
+	{
+		batch.stream = _file_stream_open(NULL, param->filename, "wb@R");
+		ok = batch.stream != NULL;
+	}
+	if (ok)
+	{
+		batch.buffer = qn_alloc(HFS_BATCH_BUFFER, byte);
+		ok = _hfs_batch_process(&batch, param);
+		if (ok)
+			param->written = (ullong)qn_stream_size(batch.stream);
+	}
+	_hfs_batch_dispose(&batch);
+
+	param->elapsed = qn_elapsed() - start;
+	if (param->elapsed > 0.0)
+		param->mbps = (double)param->size / param->elapsed / (1024.0 * 1024.0);
+	return ok;
+}
+#endif
+
+
+//////////////////////////////////////////////////////////////////////////
+// 만들기!
+
+//
+QnMount* qn_open_mount(const char* path, const char* mode)
+{
+	char* tmppath;
+	bool hfs;
+
+	if (mode != NULL)
+		hfs = qn_strchr(mode, 'h') != NULL;
+	else
+	{
+		mode = "";
+		hfs = false;
+	}
+
+	if (path == NULL)
+	{
+		// 파일 이름이 없을 때
+		if (hfs)
+			return _create_hfs(NULL, mode);
+		// HFS가 아니라면 현재 기본 경로를 연다
+#if false
+		tmppath = qn_basepath();
+#else
+		tmppath = qn_getcwd(NULL);
+#endif
+		return _create_diskfs(tmppath);
+}
+
+	const QnFileAttr attr = qn_get_file_attr(NULL, path);
+	if (QN_TMASK(attr, QNFATTR_DIR))
+	{
+		// 디렉토리가 있으면 디렉토리를 연다
+		if (hfs)
+			return NULL;
+		tmppath = qn_strdup(path);
+		return _create_diskfs(tmppath);
+	}
+	if (attr != QNFATTR_NONE)
+	{
+		// 파일이 있으면 HFS로 열어본다
+		return hfs ? _create_hfs(path, mode) : NULL;
+	}
+
+	// 파일이 없네
+	if (hfs)
+		return _create_hfs(path, mode);
+
+	// HFS가 아니라면 디렉토리를 만든다
+	if (qn_strchr(mode, 'c') != NULL)
+	{
+		if (_internal_mkdir(path) == false)
+			return NULL;
+		tmppath = qn_strdup(path);
+		return _create_diskfs(tmppath);
+	}
+
+	return NULL;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// 퓨즈
+
+// 퓨즈 소스
+typedef struct FUSESOURCE
+{
+	Hfs*			hfs;
+	HfsSource		source;
+	char			name[HFS_MAX_NAME];
+} FuseSource;
+
+// Hfs 언로드
+INLINE void _hfs_unload_ptr(Hfs** hfs)
+{
+	qn_unload(*hfs);
+}
+
+// 파일 소스 해시
+QN_DECLIMPL_MUKUM(FsMukum, char*, FuseSource, qn_strphash, qn_strpcmp, (void), (void), _fs_mukum);
+// 마운트 해시
+QN_DECLIMPL_MUKUM(HfsMukum, char*, Hfs*, qn_strphash, qn_strpcmp, (void), _hfs_unload_ptr, _hfs_mukum);
+
+// 퓨즈 색인, 한번 게시하면 바꾸지 않는다
+typedef struct FUSEINDEX FuseIndex;
+struct FUSEINDEX
+{
+	FsMukum				fss;
+	FuseIndex*			prev;			// 물러난 색인 목록
+};
+
+// 퓨즈
+typedef struct FUSE
+{
+	QnMount				base;
+
+	HfsMukum			hfss;
+	FuseIndex* volatile	index;
+	FuseIndex*			retired;		// 읽는 쪽이 아직 쓰고 있을 수 있는 지난 색인, 읽는 쪽이 없을 때 해제
+	volatile nint		readers;		// 색인을 쓰고 있는 읽는 쪽 수
+	QnSpinLock			lock;
+	bool				diskfs;
+} Fuse;
+
+// 색인 만들기
+static FuseIndex* _fuse_index_new(void)
+{
+	FuseIndex* index = qn_alloc_zero_1(FuseIndex);
+	_fs_mukum_init_fast(&index->fss);
+	return index;
+}
+
+// 색인 복제, 바꿀 때는 복제한 것을 고쳐서 게시한다
+static FuseIndex* _fuse_index_clone(const FuseIndex* source)
+{
+	FuseIndex* index = _fuse_index_new();
+	FsMukumNode* node;
+	QN_MUKUM_FOREACH(source->fss, node)
+	{
+		FsMukumNode* fs = qn_alloc_1(FsMukumNode);
+		fs->VALUE = node->VALUE;
+		fs->KEY = fs->VALUE.name;
+		_fs_mukum_add(&index->fss, fs);
+	}
+	return index;
+}
+
+// 색인 지우기, 지난 색인까지 모두
+static void _fuse_index_delete(FuseIndex* index)
+{
+	while (index != NULL)
+	{
+		FuseIndex* prev = index->prev;
+		_fs_mukum_dispose(&index->fss);
+		qn_free(index);
+		index = prev;
+	}
+}
+
+// 물러난 색인 해제, 잠근 상태에서 부른다
+// 읽는 쪽이 하나도 없으면 지난 색인을 잡고 있는 쪽도 없다. 새로 들어오는 쪽은 지금 색인만 본다
+static void _fuse_index_reclaim(Fuse* self)
+{
+	if (self->retired == NULL)
+		return;
+	qn_atomic_fence();
+	if (qn_atomic_load(&self->readers) != 0)
+		return;
+	_fuse_index_delete(self->retired);
+	qn_atomic_store((volatile nint*)&self->retired, 0);
+}
+
+// 읽기 시작, 잠그지 않고 지금 색인을 얻는다. 다 쓰면 _fuse_index_leave를 불러야 한다
+INLINE const FuseIndex* _fuse_index_enter(Fuse* self)
+{
+	qn_atomic_add(&self->readers, 1);
+	qn_atomic_fence();
+	return (const FuseIndex*)qn_atomic_load((volatile nint*)&self->index);
+}
+
+// 읽기 끝, 마지막으로 나가는 쪽이 물러난 색인을 치운다
+INLINE void _fuse_index_leave(Fuse* self)
+{
+	if (qn_atomic_add(&self->readers, -1) == 1 && qn_atomic_load((volatile nint*)&self->retired) != 0 &&
+		qn_spin_try(&self->lock))
+	{
+		_fuse_index_reclaim(self);
+		qn_spin_leave(&self->lock);
+	}
+}
+
+// 색인 게시, 잠근 상태에서 부른다. 지난 색인은 물러난 목록으로
+static void _fuse_index_publish(Fuse* self, FuseIndex* index)
+{
+	FuseIndex* old = self->index;
+	qn_atomic_store((volatile nint*)&self->index, (nint)index);
+	old->prev = self->retired;
+	qn_atomic_store((volatile nint*)&self->retired, (nint)old);
+	_fuse_index_reclaim(self);
+}
+
+//
+static QnStream* _fuse_stream(QnGam g, const char* filename, const char* mode)
+{
+	Fuse* self = qn_cast_type(g, Fuse);
+	if (self->diskfs)
+	{
+		QnStream* stream = _file_stream_open(qn_cast_type(self, QnMount), filename, mode);
+		if (stream != NULL)
+			return stream;
+	}
+
+	const FuseIndex* index = _fuse_index_enter(self);
+	const FuseSource* pfs = _fs_mukum_get(&index->fss, filename);
+	QnStream* stream = pfs == NULL ? NULL : _hfs_source_open(pfs->hfs, &pfs->source, pfs->name);
+	_fuse_index_leave(self);
+	return stream;
+}
+
+//
+static void* _fuse_alloc(QnGam g, const char* filename, size_t* size)
+{
+	Fuse* self = qn_cast_type(g, Fuse);
+	if (self->diskfs)
+	{
+		void* data = _disk_fs_alloc(self, filename, size);
+		if (data != NULL)
+			return data;
+	}
+
+	const FuseIndex* index = _fuse_index_enter(self);
+	const FuseSource* pfs = _fs_mukum_get(&index->fss, filename);
+	void* data = pfs == NULL ? NULL : _hfs_source_read(pfs->hfs, &pfs->source);
+	if (data != NULL && size != NULL)
+		*size = (size_t)pfs->source.size;
+	_fuse_index_leave(self);
+	return data;
+}
+
+//
+static QnFileAttr _fuse_attr(QnGam g, const char* path)
+{
+	Fuse* self = qn_cast_type(g, Fuse);
+	if (self->diskfs)
+	{
+		const QnFileAttr attr = _disk_fs_attr(self, path);
+		if (attr != QNFATTR_NONE)
+			return attr;
+	}
+	const FuseIndex* index = _fuse_index_enter(self);
+	const FuseSource* pfs = _fs_mukum_get(&index->fss, path);
+	const QnFileAttr attr = pfs != NULL ? HFS_ATTR(pfs->source.attr) : QNFATTR_NONE;
+	_fuse_index_leave(self);
+	return attr;
+}
+
+//
+static bool _fuse_remove(QnGam g, const char* path)
+{
+	Fuse* self = qn_cast_type(g, Fuse);
+	QN_LOCK(self->lock);
+	if (self->diskfs)
+	{
+		if (_disk_fs_remove(self, path))
+		{
+			QN_UNLOCK(self->lock);
+			return true;
+		}
+	}
+
+	// 잠근 동안은 색인이 바뀌지 않는다
+	bool ret = false;
+	const FuseSource* pfs = _fs_mukum_get(&self->index->fss, path);
+	if (pfs != NULL && _hfs_remove(pfs->hfs, path))
+	{
+		FuseIndex* index = _fuse_index_clone(self->index);
+		_fs_mukum_remove(&index->fss, path);
+		_fuse_index_publish(self, index);
+		ret = true;
+	}
+	QN_UNLOCK(self->lock);
+	return ret;
+}
+
+//
+static void _fuse_dispose(QnGam g)
+{
+	Fuse* self = qn_cast_type(g, Fuse);
+
+	_fuse_index_delete(self->retired);
+	_fuse_index_delete(self->index);
+	_hfs_mukum_dispose(&self->hfss);
+	qn_free(self->base.name);
+	qn_free(self);
+}
+
+// HFS 분석, 전체 경로 색인을 그대로 옮긴다
+static void _fuse_parse_hfs(FuseIndex* index, Hfs* hfs)
+{
+	HfsIndexNode* node;
+	QN_FLATHASH_FOREACH(hfs->index, node)
+	{
+		if (QN_TMASK(node->VALUE.attr, QNFATTR_DIR) || strlen(node->KEY) >= HFS_MAX_NAME)
+			continue;
+		FsMukumNode* fs = qn_alloc_1(FsMukumNode);
+		fs->VALUE.hfs = hfs;
+		fs->VALUE.source = node->VALUE;
+		qn_strcpy(fs->VALUE.name, node->KEY);
+		fs->KEY = fs->VALUE.name;
+		if (!_fs_mukum_add(&index->fss, fs))
+			qn_free(fs);
+	}
+}
+
+// HFS 추가, 색인은 아직 게시하지 않은 것
+static bool _fuse_add_hfs(Fuse* self, FuseIndex* index, const char* name)
+{
+	Hfs** phfs = _hfs_mukum_get(&self->hfss, name);
+	qn_return_when_fail(phfs == NULL, false);
+
+	Hfs* hfs = (Hfs*)_create_hfs(name, "fv");
+	if (hfs == NULL)
+		return false;
+	_hfs_mukum_set(&self->hfss, hfs->base.name, hfs);
+	_fuse_parse_hfs(index, hfs);
+	return true;
+}
+
+//
+bool qn_fuse_add_hfs(QnMount* mount, const char* name)
+{
+	qn_return_when_fail(QN_TMASK(mount->flags, QNMFT_FUSE), false);
+
+	Fuse* self = qn_cast_type(mount, Fuse);
+	QN_LOCK(self->lock);
+	FuseIndex* index = _fuse_index_clone(self->index);
+	const bool ret = _fuse_add_hfs(self, index, name);
+	if (ret)
+		_fuse_index_publish(self, index);
+	else
+		_fuse_index_delete(index);
+	QN_UNLOCK(self->lock);
+	return ret;
+}
+
+//
+int qn_fuse_get_hfs_count(QnMount* mount)
+{
+	qn_return_when_fail(QN_TMASK(mount->flags, QNMFT_FUSE), -1);
+	Fuse* self = qn_cast_type(mount, Fuse);
+	return (int)_hfs_mukum_count(&self->hfss);
+}
+
+//
+bool qn_fuse_get_disk_fs_enabled(QnMount* mount)
+{
+	qn_return_when_fail(QN_TMASK(mount->flags, QNMFT_FUSE), false);
+	Fuse* self = qn_cast_type(mount, Fuse);
+	return self->diskfs;
+}
+
+//
+void qn_fuse_set_disk_fs_enabled(QnMount* mount, bool enabled)
+{
+	qn_return_when_fail(QN_TMASK(mount->flags, QNMFT_FUSE), );
+	Fuse* self = qn_cast_type(mount, Fuse);
+	self->diskfs = enabled;
+}
+
+// 디스크 파일 시스템 마운트 만들기, path에 대한 오류처리는 하고 왔을 것이다
+QnMount* qn_create_fuse(const char* path, bool diskfs, bool loadall)
+{
+	Fuse* self = qn_alloc_zero_1(Fuse);
+
+	if (path == NULL)
+	{
+		char* cwd = qn_getcwd(NULL);
+#ifdef _QN_WINDOWS_
+		self->base.name = qn_strdupcat(cwd, "\\", NULL);
+#else
+		self->base.name = qn_strdupcat(cwd, "/", NULL);
+#endif
+		self->base.name_len = strlen(self->base.name);
+		qn_free(cwd);
+	}
+	else
+	{
+		const size_t len = strlen(path);
+		if (path[len - 1] == '/' || path[len - 1] == '\\')
+		{
+			self->base.name = qn_strdup(path);
+			self->base.name_len = len;
+		}
+		else
+		{
+#ifdef _QN_WINDOWS_
+			self->base.name = qn_strdupcat(path, "\\", NULL);
+#else
+			self->base.name = qn_strdupcat(path, "/", NULL);
+#endif
+			self->base.name_len = len + 1;
+		}
+		}
+
+	_hfs_mukum_init_fast(&self->hfss);
+	self->index = _fuse_index_new();
+	_path_str_set_len(&self->base.path, self->base.name, self->base.name_len);
+	self->base.flags = QNMFT_DISKFS | QNMFT_FUSE;
+	self->diskfs = diskfs;
+
+	//
+	static const struct QNMOUNT_VTABLE _fuse_vt =
+	{
+		.base.name = "DiskFS",
+		.base.dispose = _fuse_dispose,
+		.mount_cwd = _mount_cwd,
+		.mount_chdir = _disk_fs_chdir,
+		.mount_mkdir = _disk_fs_mkdir,
+		.mount_remove = _fuse_remove,
+		.mount_attr = _fuse_attr,
+		.mount_stream = _fuse_stream,
+		.mount_list = _disk_fs_list,
+		.mount_alloc = _fuse_alloc,
+	};
+	qn_gam_init(self, _fuse_vt);
+
+	if (loadall)
+	{
+		// 모든 파일을 읽어들인다
+		QnDir* dir = _disk_fs_list(self, "", "*.hfs");
+		if (dir != NULL)
+		{
+			for (;;)
+			{
+				const char* filename = _disk_list_read(dir);
+				if (filename == NULL)
+					break;
+				if (_fuse_add_hfs(self, self->index, filename) == false)
+					qn_mesgfb("Fuse", "Failed to load HFS file: %s (check opened by other program)", filename);
+			}
+			qn_unload(dir);
+		}
+	}
+
+	return qn_cast_type(self, QnMount);
+	}
+
+
+//////////////////////////////////////////////////////////////////////////
+// 스트림 실체
+
+//
+QnStream* qn_open_stream(QnMount* mount, const char* filename, const char* mode)
+{
+	qn_return_when_fail(filename != NULL, NULL);
+	if (mount != NULL)
+		return qn_cast_vtable(mount, QNMOUNT)->mount_stream(mount, filename, mode);
+	return _file_stream_open(NULL, filename, mode);
+}
+
+//
+int qn_stream_read(QnStream* self, void* buffer, int offset, int size)
+{
+	qn_return_when_fail(buffer != NULL, -1);
+	qn_return_when_fail(size >= 0, 0);
+	return qn_cast_vtable(self, QNSTREAM)->stream_read(self, buffer, offset, size);
+}
+
+//
+int qn_stream_write(QnStream* self, const void* buffer, int offset, int size)
+{
+	qn_return_when_fail(buffer != NULL, -1);
+	qn_return_when_fail(size >= 0, 0);
+	return qn_cast_vtable(self, QNSTREAM)->stream_write(self, buffer, offset, size);
+}
+
+//
+llong qn_stream_read64(QnStream* self, void* buffer, llong size)
+{
+	qn_return_when_fail(buffer != NULL, -1);
+	qn_return_when_fail(size >= 0, 0);
+	byte* ptr = (byte*)buffer;
+	llong total = 0;
+	while (total < size)
+	{
+		const int piece = (int)QN_MIN(size - total, (llong)QN_FILE_IO_PIECE);
+		const int ret = qn_cast_vtable(self, QNSTREAM)->stream_read(self, ptr + total, 0, piece);
+		if (ret < 0)
+			return total == 0 ? -1 : total;
+		if (ret == 0)
+			break;
+		total += ret;
+	}
+	return total;
+}
+
+//
+llong qn_stream_write64(QnStream* self, const void* buffer, llong size)
+{
+	qn_return_when_fail(buffer != NULL, -1);
+	qn_return_when_fail(size >= 0, 0);
+	const byte* ptr = (const byte*)buffer;
+	llong total = 0;
+	while (total < size)
+	{
+		const int piece = (int)QN_MIN(size - total, (llong)QN_FILE_IO_PIECE);
+		const int ret = qn_cast_vtable(self, QNSTREAM)->stream_write(self, ptr + total, 0, piece);
+		if (ret <= 0)
+			return total == 0 ? -1 : total;
+		total += ret;
+	}
+	return total;
+}
+
+//
+llong qn_stream_seek(QnStream* self, const llong offset, const QnSeek org)
+{
+	return qn_cast_vtable(self, QNSTREAM)->stream_seek(self, offset, org);
+}
+
+//
+llong qn_stream_tell(QnStream* self)
+{
+	return qn_cast_vtable(self, QNSTREAM)->stream_tell(self);
+}
+
+//
+llong qn_stream_size(QnStream* self)
+{
+	return qn_cast_vtable(self, QNSTREAM)->stream_size(self);
+}
+
+//
+bool qn_stream_flush(QnStream* self)
+{
+	return qn_cast_vtable(self, QNSTREAM)->stream_flush(self);
+}
+
+//
+QnStream* qn_stream_dup(QnStream* self)
+{
+	return qn_cast_vtable(self, QNSTREAM)->stream_dup(self);
+}
+
+//
+int qn_stream_peek(QnStream* self, void* buffer, int size)
+{
+	qn_return_when_fail(buffer != NULL, -1);
+	qn_return_when_fail(size >= 0, 0);
+	if (QN_TMASK(self->flags, QNFFT_BUFFER))
+	{
+		BufStream* bs = qn_cast_type(self, BufStream);
+		size_t avail = bs->rlen - bs->rpos;
+		if (avail < (size_t)size)
+			avail = _buf_stream_fill(bs);
+		const size_t n = QN_MIN(avail, (size_t)size);
+		memcpy(buffer, bs->buffer + bs->rpos, n);
+		return (int)n;
+	}
+
+	// 버퍼가 없으면 읽고 되돌아간다
+	qn_return_when_fail(QN_TMASK(self->flags, QNFF_SEEK), -1);
+	const struct QNSTREAM_VTABLE* vt = qn_cast_vtable(self, QNSTREAM);
+	const llong pos = vt->stream_tell(self);
+	const int ret = vt->stream_read(self, buffer, 0, size);
+	vt->stream_seek(self, pos, QNSEEK_BEGIN);
+	return ret;
+}
+
+//
+int qn_stream_read_until(QnStream* self, void* buffer, int size, int delim)
+{
+	qn_return_when_fail(buffer != NULL, -1);
+	qn_return_when_fail(size > 0, 0);
+	if (QN_TMASK(self->flags, QNFFT_BUFFER))
+	{
+		bool found;
+		return _buf_stream_scan(qn_cast_type(self, BufStream), (byte*)buffer, size, delim, &found);
+	}
+
+	// 버퍼가 없으면 한 바이트씩
+	const struct QNSTREAM_VTABLE* vt = qn_cast_vtable(self, QNSTREAM);
+	byte* dest = (byte*)buffer;
+	int total = 0;
+	while (total < size)
+	{
+		const int ret = vt->stream_read(self, dest, total, 1);
+		if (ret <= 0)
+			return total == 0 ? ret : total;
+		if (dest[total++] == (byte)delim)
+			break;
+	}
+	return total;
+}
+
+//
+int qn_stream_read_line(QnStream* self, char* buffer, int size)
+{
+	qn_return_when_fail(buffer != NULL, -1);
+	qn_return_when_fail(size > 1, -1);
+	const int ret = qn_stream_read_until(self, buffer, size - 1, '\n');
+	if (ret <= 0)
+	{
+		buffer[0] = '\0';
+		return -1;
+	}
+	int len = ret;
+	if (buffer[len - 1] == '\n')
+	{
+		len--;
+		if (len > 0 && buffer[len - 1] == '\r')
+			len--;
+	}
+	buffer[len] = '\0';
+	return len;
+}
+
+// printf용 버퍼
+typedef struct STREAMPRINTFBUFFER
+{
+	QnStream* stream;
+	char buffer[8 * 1024];
+	size_t loc;
+} StreamPrintfBuffer;
+
+// 정리
+static void _stream_printf_finish(PatrickPowellSprintfState* state)
+{
+	StreamPrintfBuffer* buffer = (StreamPrintfBuffer*)state->ptr;
+	if (buffer->loc > 0)
+	{
+		QnStream* stream = buffer->stream;
+		qn_cast_vtable(stream, QNSTREAM)->stream_write(stream, buffer->buffer, 0, (int)buffer->loc);
+	}
+	qn_free(buffer);
+}
+
+// 한글자씩 쓰기
+static void _stream_printf_outch(PatrickPowellSprintfState* state, int ch)
+{
+	StreamPrintfBuffer* buffer = (StreamPrintfBuffer*)state->ptr;
+	qn_debug_verify(buffer->loc <= QN_COUNTOF(buffer->buffer));
+	if (buffer->loc >= QN_COUNTOF(buffer->buffer))
+	{
+		QnStream* stream = buffer->stream;
+		qn_cast_vtable(stream, QNSTREAM)->stream_write(stream, buffer->buffer, 0, (int)QN_COUNTOF(buffer->buffer));
+		buffer->loc = 0;
+	}
+	buffer->buffer[buffer->loc++] = (char)ch;
+	state->currlen++;
+}
+
+//
+int qn_stream_vprintf(QnStream* self, const char* fmt, va_list va)
+{
+	qn_return_when_fail(fmt, 0);
+
+	// 짧으면 스택에 만들어서 한번에 쓴다
+	char sz[512];
+	va_list vq;
+	va_copy(vq, va);
+	const int len = qn_vsnprintf(sz, sizeof(sz), fmt, vq);
+	va_end(vq);
+	if (len >= 0 && len < (int)sizeof(sz))
+	{
+		if (len > 0)
+			qn_cast_vtable(self, QNSTREAM)->stream_write(self, sz, 0, len);
+		return len;
+	}
+
+	PatrickPowellSprintfState state =
+	{
+		_stream_printf_outch,
+		_stream_printf_finish,
+	};
+	StreamPrintfBuffer* buffer = qn_alloc_1(StreamPrintfBuffer);
+	buffer->stream = self;
+	buffer->loc = 0;
+	state.ptr = buffer;
+	dopr(&state, fmt, va);
+	return (int)state.currlen;
+}
+
+//
+int qn_stream_printf(QnStream* self, const char* fmt, ...)
+{
+	va_list va;
+	va_start(va, fmt);
+	const int ret = qn_stream_vprintf(self, fmt, va);
+	va_end(va);
+	return ret;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// 파일 리스트
+
+//
+QnDir* qn_open_dir(QnMount* mount, const char* directory, const char* mask)
+{
+	if (directory == NULL)
+		directory = ".";
+	return qn_cast_vtable(mount, QNMOUNT)->mount_list(mount, directory, mask);
+}
+
+//
+const char* qn_dir_read(QnDir* self)
+{
+	return qn_cast_vtable(self, QNDIR)->dir_read(self);
+}
+
+//
+bool qn_dir_read_info(QnDir* self, QnFileInfo* info)
+{
+	qn_return_when_fail(info, false);
+	return qn_cast_vtable(self, QNDIR)->dir_read_info(self, info);
+}
+
+//
+void qn_dir_rewind(QnDir* self)
+{
+	qn_cast_vtable(self, QNDIR)->dir_rewind(self);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// 비동기 읽기, 입출력 스레드(리눅스는 되면 io_uring)가 읽고 완료 콜백은 qn_async_update 에서 부른다
+
+#define ASYNC_THREAD_MAX	8
+
+// 읽기 요청
+struct QNASYNCREAD
+{
+	QnBaseGam			base;
+
+	QnMount*			mount;
+	char*				filename;
+	llong				offset;			// 음수면 통째로 읽는다
+	size_t				want;
+	QnAsyncFunc			func;
+	void*				data;
+
+	byte*				buffer;
+	size_t				size;
+	int					error;
+	volatile nint		state;
+
+	QnAsyncRead*		next;			// 대기 큐와 완료 큐
+
+#ifdef QN_ASYNC_URING
+	int					fd;				// io_uring으로 읽을 파일
+	bool				own_fd;			// 고리로 읽으려고 연 파일, 끝날 때 닫는다
+	int					fixed;			// 등록 버퍼 번호, 음수면 버퍼로 바로 읽는다
+	llong				at;				// 파일에서 읽을 위치
+	size_t				done;			// 읽은 크기
+#endif
+};
+
+#ifdef QN_ASYNC_URING
+#define ASYNC_RING_ENTRIES	64					// 고리 크기, 하나는 깨우기 읽기가 쓴다
+#define ASYNC_FIXED_COUNT	16					// 등록 버퍼 갯수
+#define ASYNC_FIXED_SIZE	(64 * 1024)			// 등록 버퍼 크기, 이보다 작은 읽기는 등록 버퍼로 읽고 옮긴다
+#define ASYNC_WAKE_DATA		0					// 깨우기 읽기의 user_data, 요청 포인터는 0이 아니다
+
+// io_uring 고리, 제출과 완료 모두 고리 스레드 하나만 만진다
+typedef struct ASYNCRING
+{
+	int					fd;
+	int					wake;			// 넣는 쪽이 고리 스레드를 깨우는 eventfd
+	ullong				wake_value;
+	bool				wake_armed;		// 깨우기 읽기를 넣어 두었다
+	bool				broken;			// 커널이 읽기를 못하면 입출력 스레드로 돌린다
+	QnThread*			thread;
+
+	uint*				sq_head;
+	uint*				sq_tail;
+	uint*				sq_array;
+	uint				sq_mask;
+	struct io_uring_sqe* sqes;
+	uint*				cq_head;
+	uint*				cq_tail;
+	uint				cq_mask;
+	struct io_uring_cqe* cqes;
+
+	void*				sq_ptr;
+	size_t				sq_size;
+	void*				cq_ptr;
+	size_t				cq_size;
+	size_t				sqes_size;
+
+	byte*				fixed;			// 등록 버퍼, 등록을 못했으면 널
+	uint				fixed_free;		// 빈 등록 버퍼 비트
+	uint				inflight;		// 넣고 아직 안 끝난 읽기, 깨우기 읽기는 빼고
+
+	QnAsyncRead*		wait_head;		// 고리에 넣기를 기다리는 요청, async_impl.lock으로 지킨다
+	QnAsyncRead*		wait_tail;
+} AsyncRing;
+#endif
+
+// 비동기 읽기 상태
+static struct ASYNCIMPL
+{
+	QnSpinLock			init_lock;
+	volatile nint		ready;
+	uint				want;			// 스레드 갯수, 0이면 알아서
+
+	QnMutex*			lock;
+	QnCond*				work;			// 요청이 들어왔다
+	QnCond*				done;			// 요청이 끝났다
+	QnThread*			threads[ASYNC_THREAD_MAX];
+	uint				count;
+	bool				quit;
+
+	QnAsyncRead*		wait_head;
+	QnAsyncRead*		wait_tail;
+	QnAsyncRead*		done_head;
+	QnAsyncRead*		done_tail;
+
+#ifdef QN_ASYNC_URING
+	AsyncRing			ring;
+	bool				uring;			// 고리 스레드가 돌고 있다
+#endif
+} async_impl = { 0, };
+
+//
+static void _async_queue_push(QnAsyncRead** head, QnAsyncRead** tail, QnAsyncRead* req)
+{
+	req->next = NULL;
+	if (*tail != NULL)
+		(*tail)->next = req;
+	else
+		*head = req;
+	*tail = req;
+}
+
+//
+static QnAsyncRead* _async_queue_pop(QnAsyncRead** head, QnAsyncRead** tail)
+{
+	QnAsyncRead* req = *head;
+	if (req != NULL)
+	{
+		*head = req->next;
+		if (*head == NULL)
+			*tail = NULL;
+	}
+	return req;
+}
+
+// 실제로 읽는다. 입출력 스레드에서 잠금 없이 부른다
+static void _async_process(QnAsyncRead* self)
+{
+	errno = 0;
+	if (self->offset < 0)
+		self->buffer = (byte*)qn_file_alloc64(self->mount, self->filename, &self->size);
+	else
+	{
+		QnStream* stream = qn_open_stream(self->mount, self->filename, NULL);
+		if (stream != NULL)
+		{
+			const llong total = qn_stream_size(stream);
+			const llong left = total > self->offset ? total - self->offset : 0;
+			const size_t size = self->want == 0 || (ullong)left < (ullong)self->want ? (size_t)left : self->want;
+			self->buffer = qn_alloc(size + 4, byte);
+			if (size > 0 && (qn_stream_seek(stream, self->offset, QNSEEK_BEGIN) != self->offset ||
+				(self->size = (size_t)qn_stream_read64(stream, self->buffer, size)) != size))
+			{
+				qn_free(self->buffer);
+				self->buffer = NULL;
+				if (errno == 0)
+					errno = EIO;
+			}
+			qn_unload(stream);
+		}
+	}
+	self->error = self->buffer == NULL ? (errno != 0 ? errno : ENOENT) : 0;
+}
+
+// 잠근 채로 부른다. 콜백이 있으면 완료 큐로, 없으면 놓는다
+static void _async_finish(QnAsyncRead* self, const QnAsyncState state)
+{
+	qn_atomic_store(&self->state, state);
+	if (self->func != NULL)
+		_async_queue_push(&async_impl.done_head, &async_impl.done_tail, self);
+	else
+		qn_unload(self);
+	qn_cond_broadcast(async_impl.done);
+}
+
+// 입출력 스레드
+static void* _async_worker(void* data)
+{
+	QN_DUMMY(data);
+	qn_mutex_enter(async_impl.lock);
+	for (;;)
+	{
+		while (async_impl.wait_head == NULL && async_impl.quit == false)
+			qn_cond_wait(async_impl.work, async_impl.lock);
+		if (async_impl.quit)
+			break;
+		QnAsyncRead* req = _async_queue_pop(&async_impl.wait_head, &async_impl.wait_tail);
+		if (qn_atomic_load(&req->state) == QNASYNC_CANCEL)
+		{
+			_async_finish(req, QNASYNC_CANCEL);
+			continue;
+		}
+		qn_atomic_store(&req->state, QNASYNC_READ);
+		qn_mutex_leave(async_impl.lock);
+
+		_async_process(req);
+
+		qn_mutex_enter(async_impl.lock);
+		_async_finish(req, req->buffer != NULL ? QNASYNC_DONE : QNASYNC_FAIL);
+	}
+	qn_mutex_leave(async_impl.lock);
+	return NULL;
+}
+
+#ifdef QN_ASYNC_URING
+//
+static int _uring_setup(uint entries, struct io_uring_params* params)
+{
+	return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+//
+static int _uring_enter(int fd, uint submit, uint wait, uint flags)
+{
+	return (int)syscall(__NR_io_uring_enter, fd, submit, wait, flags, NULL, 0);
+}
+
+//
+static int _uring_register(int fd, uint opcode, const void* arg, uint count)
+{
+	return (int)syscall(__NR_io_uring_register, fd, opcode, arg, count);
+}
+
+// 고리 닫기, 만들다 실패했을 때도 부른다
+static void _async_ring_close(AsyncRing* ring)
+{
+	if (ring->fixed != NULL)
+		munmap(ring->fixed, (size_t)ASYNC_FIXED_COUNT * ASYNC_FIXED_SIZE);
+	if (ring->sqes != NULL)
+		munmap(ring->sqes, ring->sqes_size);
+	if (ring->cq_ptr != NULL && ring->cq_ptr != ring->sq_ptr)
+		munmap(ring->cq_ptr, ring->cq_size);
+	if (ring->sq_ptr != NULL)
+		munmap(ring->sq_ptr, ring->sq_size);
+	if (ring->wake >= 0)
+		close(ring->wake);
+	if (ring->fd >= 0)
+		close(ring->fd);
+	memset(ring, 0, sizeof(AsyncRing));
+	ring->fd = ring->wake = -1;
+}
+
+// 고리 만들기, 커널이 안되거나 막혀 있으면 거짓
+static bool _async_ring_open(AsyncRing* ring)
+{
+	memset(ring, 0, sizeof(AsyncRing));
+	ring->wake = -1;
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	ring->fd = _uring_setup(ASYNC_RING_ENTRIES, &params);
+	if (ring->fd < 0)
+	{
+		ring->fd = -1;
+		return false;
+	}
+
+	// 제출 고리와 완료 고리, 커널이 되면 한번에 매핑한다
+	ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(uint);
+	ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	const bool single = QN_TMASK(params.features, IORING_FEAT_SINGLE_MMAP);
+	if (single)
+		ring->sq_size = ring->cq_size = QN_MAX(ring->sq_size, ring->cq_size);
+	void* ptr = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	if (ptr == MAP_FAILED)
+	{
+		_async_ring_close(ring);
+		return false;
+	}
+	ring->sq_ptr = ptr;
+	if (single)
+		ring->cq_ptr = ptr;
+	else
+	{
+		ptr = mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+		if (ptr == MAP_FAILED)
+		{
+			_async_ring_close(ring);
+			return false;
+		}
+		ring->cq_ptr = ptr;
+	}
+	ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	ptr = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if (ptr == MAP_FAILED)
+	{
+		_async_ring_close(ring);
+		return false;
+	}
+	ring->sqes = (struct io_uring_sqe*)ptr;
+
+	byte* sq = (byte*)ring->sq_ptr;
+	ring->sq_head = (uint*)(sq + params.sq_off.head);
+	ring->sq_tail = (uint*)(sq + params.sq_off.tail);
+	ring->sq_array = (uint*)(sq + params.sq_off.array);
+	ring->sq_mask = *(uint*)(sq + params.sq_off.ring_mask);
+	byte* cq = (byte*)ring->cq_ptr;
+	ring->cq_head = (uint*)(cq + params.cq_off.head);
+	ring->cq_tail = (uint*)(cq + params.cq_off.tail);
+	ring->cq_mask = *(uint*)(cq + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+	ring->wake = eventfd(0, EFD_CLOEXEC);
+	if (ring->wake < 0)
+	{
+		_async_ring_close(ring);
+		return false;
+	}
+
+	// 작은 읽기용 등록 버퍼, 잠금 한도에 걸려 등록을 못하면 모두 바로 읽는다
+	ptr = mmap(NULL, (size_t)ASYNC_FIXED_COUNT * ASYNC_FIXED_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ptr != MAP_FAILED)
+	{
+		struct iovec iov[ASYNC_FIXED_COUNT];
+		for (int i = 0; i < ASYNC_FIXED_COUNT; i++)
+		{
+			iov[i].iov_base = (byte*)ptr + (size_t)i * ASYNC_FIXED_SIZE;
+			iov[i].iov_len = ASYNC_FIXED_SIZE;
+		}
+		if (_uring_register(ring->fd, IORING_REGISTER_BUFFERS, iov, ASYNC_FIXED_COUNT) == 0)
+		{
+			ring->fixed = (byte*)ptr;
+			ring->fixed_free = (1U << ASYNC_FIXED_COUNT) - 1;
+		}
+		else
+			munmap(ptr, (size_t)ASYNC_FIXED_COUNT * ASYNC_FIXED_SIZE);
+	}
+	return true;
+}
+
+// 빈 제출 항목
+static struct io_uring_sqe* _async_ring_sqe(AsyncRing* ring)
+{
+	const uint tail = *ring->sq_tail;
+	const uint index = tail & ring->sq_mask;
+	struct io_uring_sqe* sqe = &ring->sqes[index];
+	memset(sqe, 0, sizeof(struct io_uring_sqe));
+	ring->sq_array[index] = index;
+	return sqe;
+}
+
+// 채운 제출 항목을 커널에 보인다
+INLINE void _async_ring_push(AsyncRing* ring)
+{
+	__atomic_store_n(ring->sq_tail, *ring->sq_tail + 1, __ATOMIC_RELEASE);
+}
+
+// 깨우기 읽기, eventfd가 읽히면 기다리던 고리 스레드가 깬다
+static void _async_ring_prep_wake(AsyncRing* ring)
+{
+	struct io_uring_sqe* sqe = _async_ring_sqe(ring);
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = ring->wake;
+	sqe->addr = (ullong)(nuint)&ring->wake_value;
+	sqe->len = sizeof(ring->wake_value);
+	sqe->user_data = ASYNC_WAKE_DATA;
+	_async_ring_push(ring);
+	ring->wake_armed = true;
+}
+
+// 요청 읽기, 남은 크기가 작으면 등록 버퍼로 읽는다
+static void _async_ring_prep_read(AsyncRing* ring, QnAsyncRead* req)
+{
+	const size_t left = QN_MIN(req->size - req->done, QN_FILE_IO_PIECE);
+	if (req->fixed < 0 && left <= ASYNC_FIXED_SIZE && ring->fixed_free != 0)
+	{
+		req->fixed = (int)qn_ctz32(ring->fixed_free);
+		ring->fixed_free &= ~(1U << req->fixed);
+	}
+
+	struct io_uring_sqe* sqe = _async_ring_sqe(ring);
+	sqe->fd = req->fd;
+	sqe->off = (ullong)(req->at + (llong)req->done);
+	sqe->len = (uint)left;
+	sqe->user_data = (ullong)(nuint)req;
+	if (req->fixed >= 0)
+	{
+		sqe->opcode = IORING_OP_READ_FIXED;
+		sqe->addr = (ullong)(nuint)(ring->fixed + (size_t)req->fixed * ASYNC_FIXED_SIZE);
+		sqe->buf_index = (ushort)req->fixed;
+	}
+	else
+	{
+		sqe->opcode = IORING_OP_READ;
+		sqe->addr = (ullong)(nuint)(req->buffer + req->done);
+	}
+	_async_ring_push(ring);
+	ring->inflight++;
+}
+
+// 압축하지 않은 HFS 항목의 파일과 위치, 아카이브가 먼저 닫혀도 되게 파일을 복제한다
+static bool _async_ring_source(const Hfs* hfs, const HfsSource* source, int* fd, llong* at, llong* total)
+{
+	if (QN_TMASK(source->attr, QNFATTR_DIR | QNFATTR_CMPR))
+		return false;
+	QnStream* stream = qn_get_gam_desc(hfs, QnStream*);
+	if (QN_TMASK(stream->flags, QNFFT_FILE) == false)
+		return false;
+	*fd = (int)_file_handle_dup(qn_get_gam_desc(stream, nint));
+	*at = _hfs_source_offset(source, hfs->large);
+	*total = (llong)source->size;
+	return *fd >= 0;
+}
+
+// 고리로 읽을 수 있으면 파일과 위치를 정하고 버퍼를 만든다
+// 디스크 파일과 압축하지 않은 HFS 항목만, 나머지는 입출력 스레드가 읽는다
+static bool _async_ring_locate(QnAsyncRead* self)
+{
+	QnMount* mount = self->mount;
+	int fd = -1;
+	llong at = 0, total = 0;
+	if (mount == NULL || (mount->flags & (QNMFT_DISKFS | QNMFT_FUSE)) == QNMFT_DISKFS)
+	{
+		char real[QN_MAX_PATH];
+		const char* path = mount == NULL ? self->filename : _file_stream_get_real_path(real, mount, self->filename);
+		if (path == NULL || (fd = open(path, O_RDONLY | O_CLOEXEC)) < 0)
+			return false;
+		struct stat st;
+		if (fstat(fd, &st) < 0 || S_ISREG(st.st_mode) == false)
+		{
+			close(fd);
+			return false;
+		}
+		total = (llong)st.st_size;
+	}
+	else if (QN_TMASK(mount->flags, QNMFT_FUSE))
+	{
+		// 디스크를 먼저 보는 퓨즈는 입출력 스레드가 찾는다
+		Fuse* fuse = qn_cast_type(mount, Fuse);
+		if (fuse->diskfs)
+			return false;
+		const FuseIndex* index = _fuse_index_enter(fuse);
+		const FuseSource* pfs = _fs_mukum_get(&index->fss, self->filename);
+		const bool ok = pfs != NULL && _async_ring_source(pfs->hfs, &pfs->source, &fd, &at, &total);
+		_fuse_index_leave(fuse);
+		if (ok == false)
+			return false;
+	}
+	else if (QN_TMASK(mount->flags, QNMFT_HFS) && QN_TMASK(mount->flags, QNMF_WRITE) == false)
+	{
+		const Hfs* hfs = qn_cast_type(mount, Hfs);
+		QnPathStr full;
+		const HfsSource* source = _hfs_find(hfs, self->filename, &full);
+		if (source == NULL || _async_ring_source(hfs, source, &fd, &at, &total) == false)
+			return false;
+	}
+	else
+		return false;
+
+	// 빈 파일이나 너무 큰 파일은 입출력 스레드가 똑같이 처리하게
+	size_t size;
+	if (self->offset < 0)
+		size = total > 0 && (ullong)total < SIZE_MAX - 4 ? (size_t)total : 0;
+	else
+	{
+		const llong left = total > self->offset ? total - self->offset : 0;
+		size = self->want == 0 || (ullong)left < (ullong)self->want ? (size_t)left : self->want;
+		at += self->offset;
+	}
+	if (size == 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	self->fd = fd;
+	self->own_fd = true;
+	self->fixed = -1;
+	self->at = at;
+	self->done = 0;
+	self->size = size;
+	self->buffer = qn_alloc(size + 4, byte);
+	return true;
+}
+// 고리에서 끝난 요청 정리, error가 0이 아니면 실패
+static void _async_ring_finish(AsyncRing* ring, QnAsyncRead* req, int error)
+{
+	if (req->fixed >= 0)
+	{
+		ring->fixed_free |= 1U << req->fixed;
+		req->fixed = -1;
+	}
+	if (req->own_fd)
+	{
+		close(req->fd);
+		req->own_fd = false;
+	}
+	if (error != 0)
+	{
+		qn_free(req->buffer);
+		req->buffer = NULL;
+		req->size = 0;
+		req->error = error;
+	}
+	qn_mutex_enter(async_impl.lock);
+	_async_finish(req, error == 0 ? QNASYNC_DONE : QNASYNC_FAIL);
+	qn_mutex_leave(async_impl.lock);
 }
 
-//
-bool qn_fuse_add_hfs(QnMount* mount, const char* name)
+// 고리에서 못 읽는 요청은 입출력 스레드로 넘긴다
+static void _async_ring_fallback(AsyncRing* ring, QnAsyncRead* req)
 {
-	qn_return_when_fail(QN_TMASK(mount->flags, QNMFT_FUSE), false);
+	if (req->fixed >= 0)
+	{
+		ring->fixed_free |= 1U << req->fixed;
+		req->fixed = -1;
+	}
+	if (req->own_fd)
+	{
+		close(req->fd);
+		req->own_fd = false;
+	}
+	qn_free(req->buffer);
+	req->buffer = NULL;
+	req->size = 0;
 
-	Fuse* self = qn_cast_type(mount, Fuse);
-	QN_LOCK(self->lock);
-	bool ret = _fuse_add_hfs(self, name);
-	QN_UNLOCK(self->lock);
-	return ret;
+	if (async_impl.count == 0)
+	{
+		_async_process(req);
+		qn_mutex_enter(async_impl.lock);
+		_async_finish(req, req->buffer != NULL ? QNASYNC_DONE : QNASYNC_FAIL);
+		qn_mutex_leave(async_impl.lock);
+		return;
+	}
+	qn_mutex_enter(async_impl.lock);
+	qn_atomic_store(&req->state, QNASYNC_WAIT);
+	_async_queue_push(&async_impl.wait_head, &async_impl.wait_tail, req);
+	qn_cond_signal(async_impl.work);
+	qn_mutex_leave(async_impl.lock);
 }
 
-//
-int qn_fuse_get_hfs_count(QnMount* mount)
+// 완료 하나 처리, 덜 읽었으면 나머지를 다시 넣는다
+static void _async_ring_complete(AsyncRing* ring, QnAsyncRead* req, int res)
 {
-	qn_return_when_fail(QN_TMASK(mount->flags, QNMFT_FUSE), -1);
-	Fuse* self = qn_cast_type(mount, Fuse);
-	return (int)_hfs_mukum_count(&self->hfss);
-}
+	if (res > 0)
+	{
+		if (req->fixed >= 0)
+			memcpy(req->buffer + req->done, ring->fixed + (size_t)req->fixed * ASYNC_FIXED_SIZE, (size_t)res);
+		req->done += (size_t)res;
+		if (req->done >= req->size)
+		{
+			_async_ring_finish(ring, req, 0);
+			return;
+		}
+	}
+	else if (res == -EINVAL || res == -EOPNOTSUPP || res == -EFAULT)
+	{
+		// 이 커널은 IORING_OP_READ나 등록 버퍼를 모른다
+		ring->broken = true;
+		_async_ring_fallback(ring, req);
+		return;
+	}
+	else if (res != -EINTR && res != -EAGAIN)
+	{
+		// 0이면 읽는 사이 파일이 줄었다
+		_async_ring_finish(ring, req, res == 0 ? EIO : -res);
+		return;
+	}
 
-//
-bool qn_fuse_get_disk_fs_enabled(QnMount* mount)
-{
-	qn_return_when_fail(QN_TMASK(mount->flags, QNMFT_FUSE), false);
-	Fuse* self = qn_cast_type(mount, Fuse);
-	return self->diskfs;
+	qn_mutex_enter(async_impl.lock);
+	_async_queue_push(&ring->wait_head, &ring->wait_tail, req);
+	qn_mutex_leave(async_impl.lock);
 }
 
-//
-void qn_fuse_set_disk_fs_enabled(QnMount* mount, bool enabled)
+// 완료 고리 비우기
+static void _async_ring_reap(AsyncRing* ring)
 {
-	qn_return_when_fail(QN_TMASK(mount->flags, QNMFT_FUSE), );
-	Fuse* self = qn_cast_type(mount, Fuse);
-	self->diskfs = enabled;
+	uint head = *ring->cq_head;
+	const uint tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+	for (; head != tail; head++)
+	{
+		const struct io_uring_cqe* cqe = &ring->cqes[head & ring->cq_mask];
+		const ullong user = cqe->user_data;
+		const int res = cqe->res;
+		__atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+		if (user == ASYNC_WAKE_DATA)
+		{
+			ring->wake_armed = false;
+			continue;
+		}
+		ring->inflight--;
+		_async_ring_complete(ring, (QnAsyncRead*)(nuint)user, res);
+	}
 }
 
-// 디스크 파일 시스템 마운트 만들기, path에 대한 오류처리는 하고 왔을 것이다
-QnMount* qn_create_fuse(const char* path, bool diskfs, bool loadall)
+// 고리 스레드, 기다리는 요청을 모아서 한번에 넣고 끝난 것을 받는다
+static void* _async_ring_worker(void* data)
 {
-	Fuse* self = qn_alloc_zero_1(Fuse);
-
-	if (path == NULL)
-	{
-		char* cwd = qn_getcwd(NULL);
-#ifdef _QN_WINDOWS_
-		self->base.name = qn_strdupcat(cwd, "\\", NULL);
-#else
-		self->base.name = qn_strdupcat(cwd, "/", NULL);
-#endif
-		self->base.name_len = strlen(self->base.name);
-		qn_free(cwd);
-	}
-	else
+	QN_DUMMY(data);
+	AsyncRing* ring = &async_impl.ring;
+	for (;;)
 	{
-		const size_t len = strlen(path);
-		if (path[len - 1] == '/' || path[len - 1] == '\\')
+		uint submit = 0;
+		if (ring->wake_armed == false)
 		{
-			self->base.name = qn_strdup(path);
-			self->base.name_len = len;
+			_async_ring_prep_wake(ring);
+			submit++;
 		}
-		else
+
+		// 넣을 만큼만 꺼낸다
+		QnAsyncRead* head = NULL;
+		QnAsyncRead* tail = NULL;
+		uint room = ASYNC_RING_ENTRIES - 1 - ring->inflight;
+		qn_mutex_enter(async_impl.lock);
+		const bool quit = async_impl.quit;
+		while (quit == false && room > 0 && ring->wait_head != NULL)
 		{
-#ifdef _QN_WINDOWS_
-			self->base.name = qn_strdupcat(path, "\\", NULL);
-#else
-			self->base.name = qn_strdupcat(path, "/", NULL);
-#endif
-			self->base.name_len = len + 1;
+			QnAsyncRead* req = _async_queue_pop(&ring->wait_head, &ring->wait_tail);
+			if (qn_atomic_load(&req->state) == QNASYNC_CANCEL)
+			{
+				_async_finish(req, QNASYNC_CANCEL);
+				continue;
+			}
+			qn_atomic_store(&req->state, QNASYNC_READ);
+			_async_queue_push(&head, &tail, req);
+			room--;
 		}
+		qn_mutex_leave(async_impl.lock);
+
+		// 처음 넣는 요청은 파일을 열어 위치를 정한다. 메인 스레드가 열기를 기다리지 않게 여기서 연다
+		for (QnAsyncRead* req; (req = _async_queue_pop(&head, &tail)) != NULL;)
+		{
+			if (req->buffer == NULL && _async_ring_locate(req) == false)
+			{
+				_async_ring_fallback(ring, req);
+				continue;
+			}
+			_async_ring_prep_read(ring, req);
+			submit++;
 		}
+		if (quit && ring->inflight == 0)
+			break;
 
-	_hfs_mukum_init_fast(&self->hfss);
-	_fs_mukum_init_fast(&self->fss);
-	_path_str_set_len(&self->base.path, self->base.name, self->base.name_len);
-	self->base.flags = QNMFT_DISKFS | QNMFT_FUSE;
-	self->diskfs = diskfs;
+		// 넣기와 기다리기를 시스템 호출 한번에
+		if (_uring_enter(ring->fd, submit, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR && errno != EBUSY)
+		{
+			qn_mesgf("AsyncRead", "io_uring_enter failed: %d", errno);
+			qn_sleep(1);
+		}
+		_async_ring_reap(ring);
+	}
+	return NULL;
+}
 
-	//
-	static const struct QNMOUNT_VTABLE _fuse_vt =
-	{
-		.base.name = "DiskFS",
-		.base.dispose = _fuse_dispose,
-		.mount_cwd = _mount_cwd,
-		.mount_chdir = _disk_fs_chdir,
-		.mount_mkdir = _disk_fs_mkdir,
-		.mount_remove = _fuse_remove,
-		.mount_attr = _fuse_attr,
-		.mount_stream = _fuse_stream,
-		.mount_list = _disk_fs_list,
-		.mount_alloc = _fuse_alloc,
-	};
-	qn_gam_init(self, _fuse_vt);
+// 고리 스레드 깨우기
+static void _async_ring_wake(AsyncRing* ring)
+{
+	const ullong one = 1;
+	while (write(ring->wake, &one, sizeof(one)) < 0 && errno == EINTR) {}
+}
 
-	if (loadall)
+#endif
+
+// 처음 요청할 때 스레드를 만든다
+static void _async_init(void)
+{
+	if (qn_atomic_load(&async_impl.ready) != 0)
+		return;
+	QN_LOCK(async_impl.init_lock);
+	if (async_impl.ready == 0)
 	{
-		// 모든 파일을 읽어들인다
-		QnDir* dir = _disk_fs_list(self, "", "*.hfs");
-		if (dir != NULL)
+		async_impl.lock = qn_new_mutex();
+		async_impl.work = qn_new_cond();
+		async_impl.done = qn_new_cond();
+		const uint cpu = qn_cpu_count() / 2;
+		const uint want = async_impl.want != 0 ? async_impl.want : QN_CLAMP(cpu, 2, 4);
+		for (uint i = 0; i < QN_MIN(want, ASYNC_THREAD_MAX); i++)
 		{
-			for (;;)
+			char name[32];
+			qn_snprintf(name, QN_COUNTOF(name), "QN ASYNC %u", i);
+			QnThread* thread = qn_new_thread(name, _async_worker, NULL, 0, 0);
+			if (thread == NULL)
+				break;
+			if (qn_thread_start(thread) == false)
 			{
-				const char* filename = _disk_list_read(dir);
-				if (filename == NULL)
-					break;
-				if (_fuse_add_hfs(self, filename) == false)
-					qn_mesgfb("Fuse", "Failed to load HFS file: %s (check opened by other program)", filename);
+				qn_delete_thread(thread);
+				break;
+			}
+			async_impl.threads[async_impl.count++] = thread;
+		}
+#ifdef QN_ASYNC_URING
+		// 고리를 못 만들면 입출력 스레드만 쓴다
+		if (_async_ring_open(&async_impl.ring))
+		{
+			QnThread* thread = qn_new_thread("QN ASYNC URING", _async_ring_worker, NULL, 0, 0);
+			if (thread != NULL && qn_thread_start(thread))
+			{
+				async_impl.ring.thread = thread;
+				async_impl.uring = true;
+			}
+			else
+			{
+				qn_delete_thread(thread);
+				_async_ring_close(&async_impl.ring);
 			}
-			qn_unload(dir);
 		}
+#endif
+		qn_atomic_store(&async_impl.ready, 1);
 	}
+	QN_UNLOCK(async_impl.init_lock);
+}
 
-	return qn_cast_type(self, QnMount);
-	}
+// 런타임 내림에서 부른다. 남은 요청은 콜백 없이 버린다
+void qn_async_down(void)
+{
+	if (async_impl.ready == 0)
+		return;
 
+	qn_mutex_enter(async_impl.lock);
+	async_impl.quit = true;
+	qn_cond_broadcast(async_impl.work);
+	qn_mutex_leave(async_impl.lock);
+#ifdef QN_ASYNC_URING
+	// 고리 스레드는 넣은 읽기가 모두 끝나야 나온다
+	if (async_impl.uring)
+	{
+		_async_ring_wake(&async_impl.ring);
+		qn_delete_thread(async_impl.ring.thread);
+		for (QnAsyncRead* req; (req = _async_queue_pop(&async_impl.ring.wait_head, &async_impl.ring.wait_tail)) != NULL;)
+		{
+			qn_atomic_store(&req->state, QNASYNC_CANCEL);
+			qn_unload(req);
+		}
+		_async_ring_close(&async_impl.ring);
+	}
+#endif
+	for (uint i = 0; i < async_impl.count; i++)
+		qn_delete_thread(async_impl.threads[i]);
 
-//////////////////////////////////////////////////////////////////////////
-// 스트림 실체
+	for (QnAsyncRead* req; (req = _async_queue_pop(&async_impl.wait_head, &async_impl.wait_tail)) != NULL;)
+	{
+		qn_atomic_store(&req->state, QNASYNC_CANCEL);
+		qn_unload(req);
+	}
+	for (QnAsyncRead* req; (req = _async_queue_pop(&async_impl.done_head, &async_impl.done_tail)) != NULL;)
+		qn_unload(req);
 
-//
-QnStream* qn_open_stream(QnMount* mount, const char* filename, const char* mode)
-{
-	qn_return_when_fail(filename != NULL, NULL);
-	if (mount != NULL)
-		return qn_cast_vtable(mount, QNMOUNT)->mount_stream(mount, filename, mode);
-	return _file_stream_open(NULL, filename, mode);
+	qn_delete_cond(async_impl.done);
+	qn_delete_cond(async_impl.work);
+	qn_delete_mutex(async_impl.lock);
+	const uint want = async_impl.want;
+	memset(&async_impl, 0, sizeof(async_impl));
+	async_impl.want = want;
 }
 
 //
-int qn_stream_read(QnStream* self, void* buffer, int offset, int size)
+void qn_async_threads(const uint count)
 {
-	qn_return_when_fail(buffer != NULL, -1);
-	qn_return_when_fail(size >= 0, 0);
-	return qn_cast_vtable(self, QNSTREAM)->stream_read(self, buffer, offset, size);
+	async_impl.want = count;
 }
 
 //
-int qn_stream_write(QnStream* self, const void* buffer, int offset, int size)
+bool qn_async_uring(void)
 {
-	qn_return_when_fail(buffer != NULL, -1);
-	qn_return_when_fail(size >= 0, 0);
-	return qn_cast_vtable(self, QNSTREAM)->stream_write(self, buffer, offset, size);
+#ifdef QN_ASYNC_URING
+	_async_init();
+	return async_impl.uring && async_impl.ring.broken == false;
+#else
+	return false;
+#endif
 }
 
 //
-llong qn_stream_seek(QnStream* self, const llong offset, const QnSeek org)
+static void _async_dispose(QnGam g)
 {
-	return qn_cast_vtable(self, QNSTREAM)->stream_seek(self, offset, org);
+	QnAsyncRead* self = qn_cast_type(g, QnAsyncRead);
+#ifdef QN_ASYNC_URING
+	if (self->own_fd)
+		close(self->fd);
+#endif
+	qn_unload(self->mount);
+	qn_free(self->filename);
+	qn_free(self->buffer);
+	qn_free(self);
 }
 
-//
-llong qn_stream_tell(QnStream* self)
+// 요청을 만들어 넣는다
+static QnAsyncRead* _async_submit(QnMount* mount, const char* filename, const llong offset, const size_t size, const QnAsyncFunc func, void* data)
 {
-	return qn_cast_vtable(self, QNSTREAM)->stream_tell(self);
+	QnAsyncRead* self = qn_alloc_zero_1(QnAsyncRead);
+	self->mount = qn_load(mount);
+	self->filename = qn_strdup(filename);
+	self->offset = offset;
+	self->want = size;
+	self->func = func;
+	self->data = data;
+	static const QnVtableGam _async_vt =
+	{
+		"AsyncRead",
+		_async_dispose,
+	};
+	qn_gam_init(self, _async_vt);
+	qn_load(self);		// 끝날 때까지 입출력 쪽이 하나 잡는다
+
+	_async_init();
+#ifdef QN_ASYNC_URING
+	if (async_impl.uring && async_impl.ring.broken == false)
+	{
+		qn_mutex_enter(async_impl.lock);
+		_async_queue_push(&async_impl.ring.wait_head, &async_impl.ring.wait_tail, self);
+		qn_mutex_leave(async_impl.lock);
+		_async_ring_wake(&async_impl.ring);
+		return self;
+	}
+#endif
+	if (async_impl.count == 0)
+	{
+		// 스레드가 없으면 그 자리에서 읽는다
+		_async_process(self);
+		qn_mutex_enter(async_impl.lock);
+		_async_finish(self, self->buffer != NULL ? QNASYNC_DONE : QNASYNC_FAIL);
+		qn_mutex_leave(async_impl.lock);
+		return self;
+	}
+
+	qn_mutex_enter(async_impl.lock);
+	_async_queue_push(&async_impl.wait_head, &async_impl.wait_tail, self);
+	qn_cond_signal(async_impl.work);
+	qn_mutex_leave(async_impl.lock);
+	return self;
 }
 
 //
-llong qn_stream_size(QnStream* self)
+QnAsyncRead* qn_async_read(QnMount* mount, const char* filename, QnAsyncFunc func, void* data)
 {
-	return qn_cast_vtable(self, QNSTREAM)->stream_size(self);
+	qn_return_when_fail(filename != NULL, NULL);
+	return _async_submit(mount, filename, -1, 0, func, data);
 }
 
 //
-bool qn_stream_flush(QnStream* self)
+QnAsyncRead* qn_async_read_range(QnMount* mount, const char* filename, const llong offset, const size_t size, QnAsyncFunc func, void* data)
 {
-	return qn_cast_vtable(self, QNSTREAM)->stream_flush(self);
+	qn_return_when_fail(filename != NULL && offset >= 0, NULL);
+	return _async_submit(mount, filename, offset, size, func, data);
 }
 
 //
-QnStream* qn_stream_dup(QnStream* self)
+int qn_async_update(void)
 {
-	return qn_cast_vtable(self, QNSTREAM)->stream_dup(self);
-}
+	if (qn_atomic_load(&async_impl.ready) == 0)
+		return 0;
 
-// printf용 버퍼
-typedef struct STREAMPRINTFBUFFER
-{
-	QnStream* stream;
-	char buffer[8 * 1024];
-	size_t loc;
-} StreamPrintfBuffer;
+	// 한번에 떼어 내고 잠금 밖에서 콜백을 부른다
+	qn_mutex_enter(async_impl.lock);
+	QnAsyncRead* node = async_impl.done_head;
+	async_impl.done_head = async_impl.done_tail = NULL;
+	qn_mutex_leave(async_impl.lock);
 
-// 정리
-static void _stream_printf_finish(PatrickPowellSprintfState* state)
-{
-	StreamPrintfBuffer* buffer = (StreamPrintfBuffer*)state->ptr;
-	if (buffer->loc > 0)
+	int count = 0;
+	for (QnAsyncRead* next; node != NULL; node = next, count++)
 	{
-		QnStream* stream = buffer->stream;
-		qn_cast_vtable(stream, QNSTREAM)->stream_write(stream, buffer->buffer, 0, (int)buffer->loc);
+		next = node->next;
+		node->func(node, node->data);
+		qn_unload(node);
 	}
-	qn_free(buffer);
+	return count;
 }
 
-// 한글자씩 쓰기
-static void _stream_printf_outch(PatrickPowellSprintfState* state, int ch)
+//
+QnAsyncState qn_async_state(const QnAsyncRead* self)
 {
-	StreamPrintfBuffer* buffer = (StreamPrintfBuffer*)state->ptr;
-	qn_debug_verify(buffer->loc <= QN_COUNTOF(buffer->buffer));
-	if (buffer->loc >= QN_COUNTOF(buffer->buffer))
-	{
-		QnStream* stream = buffer->stream;
-		qn_cast_vtable(stream, QNSTREAM)->stream_write(stream, buffer->buffer, 0, (int)QN_COUNTOF(buffer->buffer));
-		buffer->loc = 0;
-	}
-	buffer->buffer[buffer->loc++] = (char)ch;
-	state->currlen++;
+	return (QnAsyncState)qn_atomic_load((volatile nint*)&self->state);
 }
 
 //
-int qn_stream_vprintf(QnStream* self, const char* fmt, va_list va)
+bool qn_async_poll(const QnAsyncRead* self)
 {
-	qn_return_when_fail(fmt, 0);
+	return qn_async_state(self) >= QNASYNC_DONE;
+}
 
-	PatrickPowellSprintfState state =
+//
+bool qn_async_wait(QnAsyncRead* self)
+{
+	if (qn_async_poll(self) == false)
 	{
-		_stream_printf_outch,
-		_stream_printf_finish,
-	};
-	StreamPrintfBuffer* buffer = qn_alloc_1(StreamPrintfBuffer);
-	buffer->stream = self;
-	buffer->loc = 0;
-	state.ptr = buffer;
-	dopr(&state, fmt, va);
-	return (int)state.currlen;
+		qn_mutex_enter(async_impl.lock);
+		while (qn_async_poll(self) == false)
+			qn_cond_wait(async_impl.done, async_impl.lock);
+		qn_mutex_leave(async_impl.lock);
+	}
+	return qn_async_state(self) == QNASYNC_DONE;
 }
 
 //
-int qn_stream_printf(QnStream* self, const char* fmt, ...)
+bool qn_async_cancel(QnAsyncRead* self)
 {
-	va_list va;
-	va_start(va, fmt);
-	const int ret = qn_stream_vprintf(self, fmt, va);
-	va_end(va);
-	return ret;
+	qn_mutex_enter(async_impl.lock);
+	const bool ok = qn_atomic_cas(&self->state, QNASYNC_WAIT, QNASYNC_CANCEL);
+	if (ok)
+		qn_cond_broadcast(async_impl.done);
+	qn_mutex_leave(async_impl.lock);
+	return ok;
 }
 
-
-//////////////////////////////////////////////////////////////////////////
-// 파일 리스트
-
 //
-QnDir* qn_open_dir(QnMount* mount, const char* directory, const char* mask)
+const void* qn_async_data(const QnAsyncRead* self, size_t* size)
 {
-	if (directory == NULL)
-		directory = ".";
-	return qn_cast_vtable(mount, QNMOUNT)->mount_list(mount, directory, mask);
+	if (qn_async_state(self) != QNASYNC_DONE)
+		return NULL;
+	if (size != NULL)
+		*size = self->size;
+	return self->buffer;
 }
 
 //
-const char* qn_dir_read(QnDir* self)
+void* qn_async_take(QnAsyncRead* self, size_t* size)
 {
-	return qn_cast_vtable(self, QNDIR)->dir_read(self);
+	if (qn_async_state(self) != QNASYNC_DONE)
+		return NULL;
+	byte* buffer = self->buffer;
+	self->buffer = NULL;
+	if (size != NULL)
+		*size = buffer != NULL ? self->size : 0;
+	return buffer;
 }
 
 //
-bool qn_dir_read_info(QnDir* self, QnFileInfo* info)
+int qn_async_error(const QnAsyncRead* self)
 {
-	qn_return_when_fail(info, false);
-	return qn_cast_vtable(self, QNDIR)->dir_read_info(self, info);
+	return qn_async_state(self) == QNASYNC_FAIL ? self->error : 0;
 }
 
 //
-void qn_dir_rewind(QnDir* self)
+const char* qn_async_filename(const QnAsyncRead* self)
 {
-	qn_cast_vtable(self, QNDIR)->dir_rewind(self);
+	return self->filename;
 }
@@ -21,7 +21,7 @@ QnGam qn_sc_init(QnGam g, const void* vt)
 QnGam qn_sc_load(QnGam g)
 {
 	QnBaseGam* base = qn_cast_type(g, QnBaseGam);
-	base->ref++;
+	qn_atomic_add(&base->ref, 1);		// 여러 스레드에서 같은 마운트를 열 수 있다
 	return g;
 }
 
@@ -29,7 +29,7 @@ QnGam qn_sc_load(QnGam g)
 QnGam qn_sc_unload(QnGam g)
 {
 	QnBaseGam* base = qn_cast_type(g, QnBaseGam);
-	const volatile int ref = (int)--base->ref;
+	const nint ref = qn_atomic_add(&base->ref, -1) - 1;
 	if (ref != 0)
 	{
 		qn_debug_assert(ref > 0, "invalid reference value!");
@@ -72,13 +72,16 @@ void qn_node_set_name(QnNodeGam* self, const char* name)
 	if (name)
 	{
 		qn_strncpy(self->NAME, name, QN_COUNTOF(self->NAME) - 1);
+		// 아톰은 묶음에 넣을 때 만든다. 이름만 바꾸는 노드까지 아톰으로 남기지 않는다
+		self->ATOM = NULL;
 		self->HASH = qn_strhash(self->NAME);
 	}
 	else
 	{
 		size_t i = qn_p_index();
 		qn_snprintf(self->NAME, QN_COUNTOF(self->NAME), "node_%zu", i);
-		// 이름 없는 노드는 관리하지 않으므로 해시가 없다
+		// 이름 없는 노드는 관리하지 않으므로 아톰과 해시가 없다
+		self->ATOM = NULL;
 		self->HASH = 0;
 	}
 }
@@ -180,15 +183,23 @@ void qn_node_mukum_clear(QnNodeMukum* mukum)
 	qg_internal_node_mukum_test_size(mukum);
 }
 
-/// @brief 해시 룩업
-static QnNodeGam** qg_internal_node_mukum_lookup(const QnNodeMukum* mukum, size_t hash, const char* name)
+/// @brief 해시 룩업, 둘 다 아톰이면 포인터로, 아니면 문자열로 비교한다
+static QnNodeGam** qg_internal_node_mukum_lookup(const QnNodeMukum* mukum, size_t hash, QnAtom atom, const char* name)
 {
 	QnNodeGam** pnode = &mukum->NODES[hash % mukum->BUCKET];
 	QnNodeGam* node;
 	while ((node = *pnode) != NULL)
 	{
-		if (node->HASH == hash && qn_streqv(node->NAME, name))
-			break;
+		if (node->HASH == hash)
+		{
+			if (atom != NULL && node->ATOM != NULL)
+			{
+				if (node->ATOM == atom)
+					break;
+			}
+			else if (qn_streqv(node->NAME, name))
+				break;
+		}
 		pnode = &node->SIB;
 	}
 	qn_debug_assert(pnode != NULL, "invalid node lookup");
@@ -199,7 +210,10 @@ static QnNodeGam** qg_internal_node_mukum_lookup(const QnNodeMukum* mukum, size_
 static void qg_internal_node_mukum_input(QnNodeMukum* mukum, QnNodeGam* item, bool replace)
 {
 	qn_return_on_ok(item->HASH == 0, /*void*/);
-	QnNodeGam** pnode = qg_internal_node_mukum_lookup(mukum, item->HASH, item->NAME);
+	// 묶음에 들어가는 이름만 아톰으로 만든다. 런타임 전이라 못 만들면 문자열로 비교한다
+	if (item->ATOM == NULL)
+		item->ATOM = qn_atom(item->NAME);
+	QnNodeGam** pnode = qg_internal_node_mukum_lookup(mukum, item->HASH, item->ATOM, item->NAME);
 	QnNodeGam* node = *pnode;
 	if (node)
 	{
@@ -275,21 +289,27 @@ static void qg_internal_node_mukum_unlink(QnNodeMukum* mukum, QnNodeGam** pnode)
 }
 
 /// @brief 노드 제거, 실제로 노드를 제거한다!
-static bool qg_internal_node_mukum_erase(QnNodeMukum* mukum, size_t hash, const char* name)
+static bool qg_internal_node_mukum_erase(QnNodeMukum* mukum, const char* name)
 {
-	QnNodeGam** pnode = qg_internal_node_mukum_lookup(mukum, hash, name);
-	if (*pnode == NULL)
+	const QnAtom atom = qn_atom_find(name);
+	const size_t hash = atom != NULL ? qn_atom_hash(atom) : qn_strhash(name);
+	QnNodeGam** pnode = qg_internal_node_mukum_lookup(mukum, hash, atom, name);
+	QnNodeGam* node = *pnode;
+	if (node == NULL)
 		return false;
+	// 링크를 풀면 *pnode는 다음 형제가 된다
 	qg_internal_node_mukum_unlink(mukum, pnode);
-	qn_unloadu(*pnode);
+	qn_unloadu(node);
 	return true;
 }
 
 /// @brief 노드 얻기, 참조 처리 하지 않는다!
 void* qn_node_mukum_get(const QnNodeMukum* mukum, const char* name)
 {
-	const size_t hash = qn_strhash(name);
-	QnNodeGam** pnode = qg_internal_node_mukum_lookup(mukum, hash, name);
+	// 아톰이 있으면 해시를 다시 계산하지 않는다
+	const QnAtom atom = qn_atom_find(name);
+	const size_t hash = atom != NULL ? qn_atom_hash(atom) : qn_strhash(name);
+	QnNodeGam** pnode = qg_internal_node_mukum_lookup(mukum, hash, atom, name);
 	return *pnode;
 }
 
@@ -308,8 +328,7 @@ void qn_node_mukum_set(QnNodeMukum* mukum, QnNodeGam* node)
 /// @brief 노드 제거, 실제 노드를 제거한다!
 void qn_node_mukum_remove(QnNodeMukum* mukum, const char* name)
 {
-	const size_t hash = qn_strhash(name);
-	qg_internal_node_mukum_erase(mukum, hash, name);
+	qg_internal_node_mukum_erase(mukum, name);
 	qg_internal_node_mukum_test_size(mukum);
 }
 
@@ -317,7 +336,12 @@ void qn_node_mukum_remove(QnNodeMukum* mukum, const char* name)
 void qn_node_mukum_unlink(QnNodeMukum* mukum, QnNodeGam* node)
 {
 	qn_return_on_ok(node->HASH == 0, /*void*/);
-	qg_internal_node_mukum_unlink(mukum, &node);
+	// 형제 사슬에서 노드를 가리키는 자리를 찾아야 사슬이 끊기지 않는다
+	QnNodeGam** pnode = &mukum->NODES[node->HASH % mukum->BUCKET];
+	while (*pnode != NULL && *pnode != node)
+		pnode = &(*pnode)->SIB;
+	qn_return_when_fail(*pnode == node, /*void*/);
+	qg_internal_node_mukum_unlink(mukum, pnode);
 }
 
 /// @brief 찾기
@@ -152,8 +152,9 @@ typedef struct MEMBLOCK
 	const char*			desc;
 
 	size_t				index;
-#ifdef _QN_64_
-	size_t				align64;
+	struct MEMSITE*		site;
+#ifndef _QN_64_
+	size_t				align32[3];
 #endif
 
 	size_t				block;
@@ -168,6 +169,83 @@ static_assert(sizeof(MemBlock) % MEMORY_BLOCK_SIZE == 0, "MemBlock size is not a
 #define _memhdr(ptr)			(((MemBlock*)(ptr))-1)
 #define _memptr(block)			(void*)(((MemBlock*)(block))+1)
 #define _memsize(size)			(((sizeof(MemBlock)+(size))+MEMORY_GAP+MEMORY_BLOCK_SIZE-1)&(size_t)~(MEMORY_BLOCK_SIZE-1))
+#define _memclass(block)		(((block)/MEMORY_BLOCK_SIZE)-1)
+
+#define MEMORY_CACHE_CLASS		(MAX_MPF_CACHE_BLOCK/MEMORY_BLOCK_SIZE)
+#define MEMORY_SHARD			64
+#define MEMORY_SITE_BUCKET		256
+#define MEMORY_SITE_CACHE		64
+#define MEMORY_SITE_FLUSH		256
+#define MEMORY_SITE_FLUSH_SIZE	(64 * 1024)
+
+// 할당 위치 통계, desc와 line이 키
+typedef struct MEMSITE
+{
+	const char*			desc;
+	size_t				line;
+	size_t				hash;
+	size_t				snap;
+
+	volatile nint		size;
+	volatile nint		peak;
+	volatile nint		total;
+	volatile nint		freed;
+
+	struct MEMSITE*		next;
+} MemSite;
+
+// 스레드 별 할당 위치 통계 변화량, 모아 두었다가 전역 통계로 보낸다
+typedef struct MEMSITESLOT
+{
+	MemSite* volatile	site;
+	volatile nint		size;
+	volatile nint		high;
+	volatile nint		total;
+	volatile nint		freed;
+} MemSiteSlot;
+
+// 블럭 등록소 조각, 블럭 주소로 나눈다
+typedef struct MEMSHARD
+{
+	MemBlock*			frst;
+#ifndef QS_NO_SPINLOCK
+	QnSpinLock			lock;
+#endif
+} MemShard;
+
+// 매거진, 해제된 블럭을 next로 이어둔다
+typedef struct MEMMAGAZINE
+{
+	MemBlock*			head;
+	size_t				count;
+} MemMagazine;
+
+// 스레드 캐시, 스레드 별 통계와 크기 별 매거진
+// 통계는 그 스레드만 쓰고 다른 스레드는 읽기만 하므로 잠그지 않는다
+// 다른 스레드에서 해제한 블럭은 해제한 스레드에서 빼므로 스레드 하나의 값은 음수가 될 수 있다
+typedef struct MEMCACHE
+{
+	size_t				index;
+	volatile nint		count;
+	volatile nint		block_size;
+
+	MemMagazine			loaded[MEMORY_CACHE_CLASS];
+	MemMagazine			prev[MEMORY_CACHE_CLASS];
+	MemSiteSlot			sites[MEMORY_SITE_CACHE];
+
+	struct MEMCACHE*	next;
+	bool				alive;
+} MemCache;
+
+// 매거진 저장소, 가득 찬 매거진의 머리 블럭을 prev로 잇는다
+typedef struct MEMDEPOT
+{
+	MemBlock*			head;
+	size_t				count;
+#ifndef QS_NO_SPINLOCK
+	QnSpinLock			lock;
+#endif
+} MemDepot;
 
 static void* qn_mpf_alloc(size_t size, bool zero, const char* desc, size_t line);
 static void* qn_mpf_realloc(void* ptr, size_t size, const char* desc, size_t line);
@@ -184,11 +262,14 @@ static struct MEMIMPL
 #endif
 
 #ifndef QS_NO_MEMORY_PROFILE
-	MemBlock*		frst;
-	MemBlock*		last;
-	size_t			index;
-	size_t			count;
-	size_t			block_size;
+	MemCache*		caches;
+	MemDepot		depot[MEMORY_CACHE_CLASS];
+	MemShard		shards[MEMORY_SHARD];
+	MemSite*		sites[MEMORY_SITE_BUCKET];
+	size_t			site_count;
+#ifndef QS_NO_SPINLOCK
+	QnSpinLock		site_lock;
+#endif
 
 #ifndef QS_NO_SPINLOCK
 	QnSpinLock		lock;
@@ -204,6 +285,11 @@ static struct MEMIMPL
 #endif
 };
 
+#ifndef QS_NO_MEMORY_PROFILE
+// 지금 스레드의 캐시
+static THREADLOCAL MemCache* mem_cache = NULL;
+#endif
+
 //
 void qn_mpf_up(void)
 {
@@ -215,40 +301,117 @@ void qn_mpf_up(void)
 }
 
 #ifndef QS_NO_MEMORY_PROFILE
+// 시스템에서 0으로 채운 메모리를 얻는다 (캐시와 통계용)
+FINLINE void* qn_mpf_sys_zalloc(const size_t size)
+{
+#ifdef _QN_WINDOWS_
+	return HeapAlloc(mem_impl.heap, HEAP_ZERO_MEMORY, size);
+#else
+	return calloc(1, size);
+#endif
+}
+
+// 블럭을 시스템에 돌려준다
+FINLINE void qn_mpf_sys_free(void* ptr)
+{
+#ifdef _QN_WINDOWS_
+	HeapFree(mem_impl.heap, 0, ptr);
+#else
+	free(ptr);
+#endif
+}
+
+// 매거진의 블럭을 모두 시스템에 돌려준다
+static void qn_mpf_magazine_free(MemMagazine* mag)
+{
+	for (MemBlock* next, *node = mag->head; node; node = next)
+	{
+		next = node->next;
+		qn_mpf_sys_free(node);
+	}
+	mag->head = NULL;
+	mag->count = 0;
+}
+
 //
 static void qn_mpf_clear(void)
 {
-	if (mem_impl.count == 0 && mem_impl.frst == NULL && mem_impl.last == NULL)
-		return;
-
-	qn_mesgf("MEMORY PROFILER", "found %d allocation(s)", mem_impl.count);
+	size_t count = 0;
+	for (size_t i = 0; i < MEMORY_SHARD; i++)
+	{
+		for (const MemBlock* node = mem_impl.shards[i].frst; node; node = node->next)
+			count++;
+	}
 
-	size_t sum = 0;
-	for (MemBlock* next = NULL, *node = mem_impl.frst; node; node = next)
+	if (count > 0)
 	{
-		if (node->line)
-			qn_mesgf("MEMORY PROFILER", "\t%s(%Lu) : %Lu(%Lu) : %p", node->desc, node->line, node->size, node->block, _memptr(node));
-		else
-			qn_mesgf("MEMORY PROFILER", "\t%Lu(%Lu) : %p", node->size, node->block, _memptr(node));
-		qn_memdmp(_memptr(node), QN_MIN(32, node->size), mem_impl.dbg_buf, QN_COUNTOF(mem_impl.dbg_buf) - 1);
-		qn_mesgf("MEMORY PROFILER", "\t\t{%s}", mem_impl.dbg_buf);
+		qn_mesgf("MEMORY PROFILER", "found %d allocation(s)", count);
 
-		next = node->next;
-		sum += node->block;
+		size_t sum = 0;
+		for (size_t i = 0; i < MEMORY_SHARD; i++)
+		{
+			MemShard* shard = &mem_impl.shards[i];
+			for (MemBlock* next = NULL, *node = shard->frst; node; node = next)
+			{
+				if (node->line)
+					qn_mesgf("MEMORY PROFILER", "\t%s(%Lu) : %Lu(%Lu) : %p", node->desc, node->line, node->size, node->block, _memptr(node));
+				else
+					qn_mesgf("MEMORY PROFILER", "\t%Lu(%Lu) : %p", node->size, node->block, _memptr(node));
+				qn_memdmp(_memptr(node), QN_MIN(32, node->size), mem_impl.dbg_buf, QN_COUNTOF(mem_impl.dbg_buf) - 1);
+				qn_mesgf("MEMORY PROFILER", "\t\t{%s}", mem_impl.dbg_buf);
+
+				next = node->next;
+				sum += node->block;
+				qn_mpf_sys_free(node);
+			}
+			shard->frst = NULL;
+		}
 
-#ifdef _QN_WINDOWS_
-		HeapFree(mem_impl.heap, 0, node);
-#else
-		free(node);
-#endif
+		double size;
+		const char usage = qn_memhrb(sum, &size);
+		if (usage == ' ')
+			qn_mesgfb("MEMORY PROFILER", "total block size: %Lu bytes", sum);
+		else
+			qn_mesgfb("MEMORY PROFILER", "total block size: %.2f %cbytes", size, usage);
 	}
 
-	double size;
-	const char usage = qn_memhrb(sum, &size);
-	if (usage == ' ')
-		qn_mesgfb("MEMORY PROFILER", "total block size: %Lu bytes", sum);
-	else
-		qn_mesgfb("MEMORY PROFILER", "total block size: %.2f %cbytes", size, usage);
+	// 캐시와 저장소에 남은 블럭 정리
+	for (MemCache* next, *cache = mem_impl.caches; cache; cache = next)
+	{
+		next = cache->next;
+		for (size_t i = 0; i < MEMORY_CACHE_CLASS; i++)
+		{
+			qn_mpf_magazine_free(&cache->loaded[i]);
+			qn_mpf_magazine_free(&cache->prev[i]);
+		}
+		qn_mpf_sys_free(cache);
+	}
+	for (size_t i = 0; i < MEMORY_CACHE_CLASS; i++)
+	{
+		MemDepot* depot = &mem_impl.depot[i];
+		for (MemBlock* prev, *head = depot->head; head; head = prev)
+		{
+			prev = head->prev;
+			MemMagazine mag = { head, head->size };
+			qn_mpf_magazine_free(&mag);
+		}
+		depot->head = NULL;
+		depot->count = 0;
+	}
+	mem_impl.caches = NULL;
+	mem_cache = NULL;
+
+	// 할당 위치 통계 정리
+	for (size_t i = 0; i < MEMORY_SITE_BUCKET; i++)
+	{
+		for (MemSite* next, *site = mem_impl.sites[i]; site; site = next)
+		{
+			next = site->next;
+			qn_mpf_sys_free(site);
+		}
+		mem_impl.sites[i] = NULL;
+	}
+	mem_impl.site_count = 0;
 }
 #endif
 
@@ -376,82 +539,419 @@ static void qn_internal_free(void* ptr)
 //
 size_t qn_mpf_size(void)
 {
-	return mem_impl.block_size;
+	nint size = 0;
+	QN_LOCK(mem_impl.lock);
+	for (MemCache* cache = mem_impl.caches; cache; cache = cache->next)
+		size += qn_atomic_load(&cache->block_size);
+	QN_UNLOCK(mem_impl.lock);
+	return (size_t)size;
 }
 
 //
 size_t qn_mpf_count(void)
 {
-	return mem_impl.count;
+	nint count = 0;
+	QN_LOCK(mem_impl.lock);
+	for (MemCache* cache = mem_impl.caches; cache; cache = cache->next)
+		count += qn_atomic_load(&cache->count);
+	QN_UNLOCK(mem_impl.lock);
+	return (size_t)count;
 }
 
 //
 void qn_mpf_dbgout(void)
 {
-	if (mem_impl.count == 0 && mem_impl.frst == NULL && mem_impl.last == NULL)
+	const size_t count = qn_mpf_count();
+	if (count == 0)
 		return;
 
-	qn_mesgf("MEMORY PROFILER", "found %d allocation(s)", mem_impl.count);
+	qn_mesgf("MEMORY PROFILER", "found %d allocation(s)", count);
 	qn_mesgf("MEMORY PROFILER", " %-8s | %-8s | %-8s | %-s", "no", "size", "block", "desc");
 
-	QN_LOCK(mem_impl.lock);
 	size_t sum = 0, cnt = 1;
-	for (MemBlock* next, *node = mem_impl.frst; node; node = next, cnt++)
+	for (size_t i = 0; i < MEMORY_SHARD; i++)
 	{
-		if (node->line)
-		{
-			qn_mesgf("MEMORY PROFILER", " %-8d | %-8zu | % -8zu | \"%s:%d\"",
-				cnt, node->size, node->block, node->desc, (int)node->line);
-		}
-		else
+		MemShard* shard = &mem_impl.shards[i];
+		QN_LOCK(shard->lock);
+		for (MemBlock* next, *node = shard->frst; node; node = next, cnt++)
 		{
-			qn_memdmp(_memptr(node), QN_MIN(32, node->size), mem_impl.dbg_buf, QN_COUNTOF(mem_impl.dbg_buf) - 1);
-			qn_mesgf("MEMORY PROFILER", " %-8d | %-8zu | % -8zu | <%s>",
-				cnt, node->size, node->block, mem_impl.dbg_buf);
+			if (node->line)
+			{
+				qn_mesgf("MEMORY PROFILER", " %-8d | %-8zu | % -8zu | \"%s:%d\"",
+					cnt, node->size, node->block, node->desc, (int)node->line);
+			}
+			else
+			{
+				qn_memdmp(_memptr(node), QN_MIN(32, node->size), mem_impl.dbg_buf, QN_COUNTOF(mem_impl.dbg_buf) - 1);
+				qn_mesgf("MEMORY PROFILER", " %-8d | %-8zu | % -8zu | <%s>",
+					cnt, node->size, node->block, mem_impl.dbg_buf);
+			}
+			next = node->next;
+			sum += node->block;
 		}
-		next = node->next;
-		sum += node->block;
+		QN_UNLOCK(shard->lock);
 	}
-	QN_UNLOCK(mem_impl.lock);
 
 	double size;
 	const char usage = qn_memhrb(sum, &size);
 	qn_mesgf("MEMORY PROFILER", "block size: %.3g%cbytes", size, usage);
 }
 
+// 스냅샷 정렬 (크기가 큰 순서, 같으면 할당 횟수가 많은 순서)
+static int qn_mpf_snapshot_cmp(const void* left, const void* right)
+{
+	const QnMemSite* l = (const QnMemSite*)left;
+	const QnMemSite* r = (const QnMemSite*)right;
+	if (l->size != r->size)
+		return l->size < r->size ? 1 : -1;
+	if (l->total != r->total)
+		return l->total < r->total ? 1 : -1;
+	return 0;
+}
+
 //
-static void qn_mpf_node_link(MemBlock* node)
+size_t qn_mpf_snapshot(QnMemSite* sites, const size_t max_count)
 {
+	QN_LOCK(mem_impl.site_lock);
+	if (sites == NULL || max_count == 0)
+	{
+		const size_t count = mem_impl.site_count;
+		QN_UNLOCK(mem_impl.site_lock);
+		return count;
+	}
+
+	// 전역 통계
+	size_t count = 0;
+	for (size_t i = 0; i < MEMORY_SITE_BUCKET; i++)
+	{
+		for (MemSite* site = mem_impl.sites[i]; site; site = site->next)
+		{
+			if (count >= max_count)
+			{
+				site->snap = 0;
+				continue;
+			}
+			QnMemSite* ps = &sites[count++];
+			ps->desc = site->desc;
+			ps->line = site->line;
+			ps->size = (size_t)qn_atomic_load(&site->size);
+			ps->peak = (size_t)qn_atomic_load(&site->peak);
+			ps->total = (size_t)qn_atomic_load(&site->total);
+			ps->count = ps->total - (size_t)qn_atomic_load(&site->freed);
+			site->snap = count;
+		}
+	}
+
+	// 스레드에 모여 있는 변화량
 	QN_LOCK(mem_impl.lock);
-	if (mem_impl.frst)
-		mem_impl.frst->prev = node;
+	for (MemCache* cache = mem_impl.caches; cache; cache = cache->next)
+	{
+		for (size_t i = 0; i < MEMORY_SITE_CACHE; i++)
+		{
+			MemSiteSlot* slot = &cache->sites[i];
+			const MemSite* site = slot->site;
+			if (site == NULL || site->snap == 0)
+				continue;
+			QnMemSite* ps = &sites[site->snap - 1];
+			const nint total = qn_atomic_load(&slot->total);
+			const size_t high = ps->size + (size_t)qn_atomic_load(&slot->high);
+			if (ps->peak < high)
+				ps->peak = high;
+			ps->size += (size_t)qn_atomic_load(&slot->size);
+			ps->total += (size_t)total;
+			ps->count += (size_t)(total - qn_atomic_load(&slot->freed));
+		}
+	}
+	QN_UNLOCK(mem_impl.lock);
+	QN_UNLOCK(mem_impl.site_lock);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (sites[i].peak < sites[i].size)
+			sites[i].peak = sites[i].size;
+	}
+	qn_qsort(sites, count, sizeof(QnMemSite), qn_mpf_snapshot_cmp);
+	return count;
+}
+
+// 지금 스레드의 캐시를 얻는다. 없으면 끝난 스레드의 캐시를 물려받거나 새로 만든다
+static MemCache* qn_mpf_cache(void)
+{
+	MemCache* cache = mem_cache;
+	if (cache != NULL)
+		return cache;
+
+	QN_LOCK(mem_impl.lock);
+	for (cache = mem_impl.caches; cache; cache = cache->next)
+	{
+		if (cache->alive == false)
+			break;
+	}
+	if (cache == NULL)
+	{
+		cache = (MemCache*)qn_mpf_sys_zalloc(sizeof(MemCache));
+		if (cache == NULL)
+		{
+			QN_UNLOCK(mem_impl.lock);
+			qn_halt("MEMORY PROFILER", "cannot allocate thread cache");
+		}
+		cache->next = mem_impl.caches;
+		mem_impl.caches = cache;
+	}
+	cache->alive = true;
+	QN_UNLOCK(mem_impl.lock);
+
+	mem_cache = cache;
+	return cache;
+}
+
+// 버킷에서 할당 위치 찾기
+static MemSite* qn_mpf_site_find(MemSite* site, const char* desc, const size_t line)
+{
+	for (; site; site = site->next)
+	{
+		if (site->desc == desc && site->line == line)
+			break;
+	}
+	return site;
+}
+
+// 할당 위치 통계를 찾는다. 스레드 캐시에 없으면 전역 테이블에서 찾거나 만든다
+// 버킷은 앞에 붙이기만 하고 정리 전에는 빼지 않으므로 머리만 원자적으로 읽으면 잠그지 않고 찾을 수 있다
+static MemSite* qn_mpf_site(MemCache* cache, const char* desc, const size_t line)
+{
+	size_t hash = ((size_t)(nuint)desc >> 3) + line * 31;
+	hash ^= hash >> 11;
+
+	MemSite* site = cache->sites[hash % MEMORY_SITE_CACHE].site;
+	if (site != NULL && site->desc == desc && site->line == line)
+		return site;
+
+	MemSite** bucket = &mem_impl.sites[hash % MEMORY_SITE_BUCKET];
+	MemSite* head = (MemSite*)qn_atomic_load((volatile nint*)bucket);
+	site = qn_mpf_site_find(head, desc, line);
+	if (site != NULL)
+		return site;
+
+	// 넣을 때만 잠그고, 그 사이 다른 스레드가 넣었을 수 있으니 새로 붙은 것만 다시 본다
+	QN_LOCK(mem_impl.site_lock);
+	for (site = *bucket; site != head; site = site->next)
+	{
+		if (site->desc == desc && site->line == line)
+			break;
+	}
+	if (site == head)
+	{
+		site = (MemSite*)qn_mpf_sys_zalloc(sizeof(MemSite));
+		if (site == NULL)
+		{
+			QN_UNLOCK(mem_impl.site_lock);
+			qn_halt("MEMORY PROFILER", "cannot allocate allocation site");
+		}
+		site->desc = desc;
+		site->line = line;
+		site->hash = hash;
+		site->next = *bucket;
+		qn_atomic_store((volatile nint*)bucket, (nint)site);
+		mem_impl.site_count++;
+	}
+	QN_UNLOCK(mem_impl.site_lock);
+	return site;
+}
+
+// 스레드에 모인 변화량을 전역 통계로 보낸다
+static void qn_mpf_site_flush(MemSiteSlot* slot)
+{
+	MemSite* site = slot->site;
+	if (site == NULL)
+		return;
+
+	const nint size = slot->size, high = slot->high, total = slot->total, freed = slot->freed;
+	qn_atomic_store(&slot->size, 0);
+	qn_atomic_store(&slot->high, 0);
+	qn_atomic_store(&slot->total, 0);
+	qn_atomic_store(&slot->freed, 0);
+
+	if (total != 0)
+		qn_atomic_add(&site->total, total);
+	if (freed != 0)
+		qn_atomic_add(&site->freed, freed);
+	const nint now = qn_atomic_add(&site->size, size) + high;
+	for (nint peak = qn_atomic_load(&site->peak); now > peak; peak = qn_atomic_load(&site->peak))
+	{
+		if (qn_atomic_cas(&site->peak, peak, now))
+			break;
+	}
+}
+
+// 할당 위치 통계에 블럭 크기를 반영한다. 값은 스레드에 모았다가 가끔 전역 통계로 보낸다
+static void qn_mpf_site_count(MemCache* cache, MemSite* site, const nint size, const nint total, const nint freed)
+{
+	MemSiteSlot* slot = &cache->sites[site->hash % MEMORY_SITE_CACHE];
+	if (slot->site != site)
+	{
+		qn_mpf_site_flush(slot);
+		slot->site = site;
+	}
+
+	qn_atomic_store(&slot->size, slot->size + size);
+	if (slot->size > slot->high)
+		qn_atomic_store(&slot->high, slot->size);
+	qn_atomic_store(&slot->total, slot->total + total);
+	qn_atomic_store(&slot->freed, slot->freed + freed);
+	if (slot->total + slot->freed >= MEMORY_SITE_FLUSH ||
+		slot->size >= MEMORY_SITE_FLUSH_SIZE || slot->size <= -MEMORY_SITE_FLUSH_SIZE)
+		qn_mpf_site_flush(slot);
+}
+
+// 매거진을 저장소에 넣는다. 저장소가 꽉 찼으면 시스템에 돌려준다
+static void qn_mpf_depot_push(const size_t cls, MemMagazine* mag)
+{
+	if (mag->count == 0)
+		return;
+
+	MemDepot* depot = &mem_impl.depot[cls];
+	QN_LOCK(depot->lock);
+	if (depot->count < MAX_MPF_DEPOT)
+	{
+		mag->head->prev = depot->head;
+		mag->head->size = mag->count;
+		depot->head = mag->head;
+		depot->count++;
+		QN_UNLOCK(depot->lock);
+		mag->head = NULL;
+		mag->count = 0;
+	}
 	else
-		mem_impl.last = node;
-	node->next = mem_impl.frst;
-	node->prev = NULL;
+	{
+		QN_UNLOCK(depot->lock);
+		qn_mpf_magazine_free(mag);
+	}
+}
 
-	mem_impl.frst = node;
-	mem_impl.count++;
-	mem_impl.index++;
-	mem_impl.block_size += node->block;
+// 저장소에서 매거진 하나를 꺼낸다
+static bool qn_mpf_depot_pop(const size_t cls, MemMagazine* mag)
+{
+	MemDepot* depot = &mem_impl.depot[cls];
+	QN_LOCK(depot->lock);
+	MemBlock* head = depot->head;
+	if (head == NULL)
+	{
+		QN_UNLOCK(depot->lock);
+		return false;
+	}
+	depot->head = head->prev;
+	depot->count--;
+	QN_UNLOCK(depot->lock);
+
+	mag->head = head;
+	mag->count = head->size;
+	return true;
+}
+
+// 캐시에서 블럭을 꺼낸다
+static MemBlock* qn_mpf_cache_take(MemCache* cache, const size_t block)
+{
+	const size_t cls = _memclass(block);
+	MemMagazine* mag = &cache->loaded[cls];
+	if (mag->count == 0)
+	{
+		MemMagazine* prev = &cache->prev[cls];
+		if (prev->count > 0)
+		{
+			const MemMagazine tmp = *mag;
+			*mag = *prev;
+			*prev = tmp;
+		}
+		else if (qn_mpf_depot_pop(cls, mag) == false)
+			return NULL;
+	}
+
+	MemBlock* node = mag->head;
+	mag->head = node->next;
+	mag->count--;
+	return node;
+}
+
+// 캐시에 블럭을 넣는다. 매거진이 꽉 차면 이전 매거진을 저장소로 보낸다
+static void qn_mpf_cache_give(MemCache* cache, MemBlock* node)
+{
+	const size_t cls = _memclass(node->block);
+	MemMagazine* mag = &cache->loaded[cls];
+	if (mag->count >= MAX_MPF_MAGAZINE)
+	{
+		MemMagazine* prev = &cache->prev[cls];
+		qn_mpf_depot_push(cls, prev);
+		*prev = *mag;
+		mag->head = NULL;
+		mag->count = 0;
+	}
+
+	node->next = mag->head;
+	mag->head = node;
+	mag->count++;
+}
+
+// 스레드가 끝날 때 캐시를 반납한다
+void qn_mpf_thread_exit(void)
+{
+	MemCache* cache = mem_cache;
+	qn_return_when_fail(cache != NULL,/*void*/);
+
+	for (size_t i = 0; i < MEMORY_CACHE_CLASS; i++)
+	{
+		qn_mpf_depot_push(i, &cache->loaded[i]);
+		qn_mpf_depot_push(i, &cache->prev[i]);
+	}
+	for (size_t i = 0; i < MEMORY_SITE_CACHE; i++)
+		qn_mpf_site_flush(&cache->sites[i]);
+	mem_cache = NULL;
+
+	QN_LOCK(mem_impl.lock);
+	cache->alive = false;
 	QN_UNLOCK(mem_impl.lock);
 }
 
+// 블럭 등록소 조각 번호
+#define _memshard(node)			(((((nuint)(node))>>6)^(((nuint)(node))>>14))&(MEMORY_SHARD-1))
+
 //
-static void qn_mpf_node_unlink(const MemBlock* node)
+static void qn_mpf_node_link(MemCache* cache, MemBlock* node)
 {
-	QN_LOCK(mem_impl.lock);
+	node->index = cache->index++;
+
+	MemShard* shard = &mem_impl.shards[_memshard(node)];
+	QN_LOCK(shard->lock);
+	if (shard->frst)
+		shard->frst->prev = node;
+	node->next = shard->frst;
+	node->prev = NULL;
+	shard->frst = node;
+	QN_UNLOCK(shard->lock);
+
+	qn_atomic_store(&cache->count, cache->count + 1);
+	qn_atomic_store(&cache->block_size, cache->block_size + (nint)node->block);
+
+	qn_mpf_site_count(cache, node->site, (nint)node->size, 1, 0);
+}
+
+//
+static void qn_mpf_node_unlink(MemCache* cache, const MemBlock* node)
+{
+	MemShard* shard = &mem_impl.shards[_memshard(node)];
+	QN_LOCK(shard->lock);
 	if (node->next)
 		node->next->prev = node->prev;
-	else
-		mem_impl.last = node->prev;
 	if (node->prev)
 		node->prev->next = node->next;
 	else
-		mem_impl.frst = node->next;
-	mem_impl.count--;
-	mem_impl.block_size -= node->block;
-	QN_UNLOCK(mem_impl.lock);
+		shard->frst = node->next;
+	QN_UNLOCK(shard->lock);
+
+	qn_atomic_store(&cache->count, cache->count - 1);
+	qn_atomic_store(&cache->block_size, cache->block_size - (nint)node->block);
+
+	qn_mpf_site_count(cache, node->site, -(nint)node->size, 0, 1);
 }
 
 //
@@ -494,19 +994,29 @@ static void* qn_mpf_alloc(size_t size, bool zero, const char* desc, size_t line)
 	qn_return_when_fail(size > 0, NULL);
 
 	size_t block = _memsize(size);
-	MemBlock* node;
-#ifdef _QN_WINDOWS_
-	__try
+	MemCache* cache = qn_mpf_cache();
+	MemBlock* node = block <= MAX_MPF_CACHE_BLOCK ? qn_mpf_cache_take(cache, block) : NULL;
+	if (node != NULL)
 	{
-		node = (MemBlock*)HeapAlloc(mem_impl.heap, zero ? HEAP_ZERO_MEMORY : 0, block);
+		// 캐시에서 꺼낸 블럭
+		if (zero)
+			memset(_memptr(node), 0, block - sizeof(MemBlock));
 	}
-	__except (qn_mpf_windows_exception(_exception_code(), desc, line, size, block))
+	else
 	{
-		node = NULL;
-	}
+#ifdef _QN_WINDOWS_
+		__try
+		{
+			node = (MemBlock*)HeapAlloc(mem_impl.heap, zero ? HEAP_ZERO_MEMORY : 0, block);
+		}
+		__except (qn_mpf_windows_exception(_exception_code(), desc, line, size, block))
+		{
+			node = NULL;
+		}
 #else
-	node = (MemBlock*)(zero ? calloc(block, 1) : malloc(block));
+		node = (MemBlock*)(zero ? calloc(block, 1) : malloc(block));
 #endif
+	}
 	if (node == NULL)
 		qn_mpf_out_of_memory(desc, line, size, block);
 	else
@@ -514,10 +1024,10 @@ static void* qn_mpf_alloc(size_t size, bool zero, const char* desc, size_t line)
 		node->sign = MEMORY_SIGN_HEAD;
 		node->desc = desc;
 		node->line = (uint)line;
-		node->index = mem_impl.index;
 		node->size = size;
 		node->block = block;
-		qn_mpf_node_link(node);
+		node->site = qn_mpf_site(cache, desc, line);
+		qn_mpf_node_link(cache, node);
 	}
 	return _memptr(node);
 }
@@ -548,12 +1058,14 @@ static void* qn_mpf_realloc(void* ptr, size_t size, const char* desc, size_t lin
 	if (block <= node->block)
 	{
 		// 블락이 같으면 그냥 써. 근데 이럴일이 없을껄
+		qn_mpf_site_count(qn_mpf_cache(), node->site, (nint)size - (nint)node->size, 0, 0);
 		node->size = size;
 		return ptr;
 	}
 
 	// 재할당 하거나 새 메모리
-	qn_mpf_node_unlink(node);
+	MemCache* cache = qn_mpf_cache();
+	qn_mpf_node_unlink(cache, node);
 
 #if _QN_WINDOWS_
 	__try
@@ -575,7 +1087,8 @@ static void* qn_mpf_realloc(void* ptr, size_t size, const char* desc, size_t lin
 		node->line = (uint)line;
 		node->size = size;
 		node->block = block;
-		qn_mpf_node_link(node);
+		node->site = qn_mpf_site(cache, desc, line);
+		qn_mpf_node_link(cache, node);
 	}
 	return _memptr(node);
 }
@@ -599,13 +1112,13 @@ static void qn_mpf_free(void* ptr)
 	}
 
 	node->sign = MEMORY_SIGN_FREE;
-	qn_mpf_node_unlink(node);
+	MemCache* cache = qn_mpf_cache();
+	qn_mpf_node_unlink(cache, node);
 
-#if _QN_WINDOWS_
-	HeapFree(mem_impl.heap, 0, node);
-#else
-	free(node);
-#endif
+	if (node->block <= MAX_MPF_CACHE_BLOCK)
+		qn_mpf_cache_give(cache, node);
+	else
+		qn_mpf_sys_free(node);
 }
 #endif
 
@@ -613,12 +1126,43 @@ static void qn_mpf_free(void* ptr)
 //////////////////////////////////////////////////////////////////////////
 // 테이블 기반 메모리
 
+// 스레드 별 메모리 테이블 스택
+typedef struct MEMROUTE
+{
+	const QnAllocTable*	table;
+	QnArena*			arena;
+} MemRoute;
+
+static THREADLOCAL MemRoute mem_routes[MAX_MEMTBL_STACK];
+static THREADLOCAL size_t mem_route_count = 0;
+static THREADLOCAL const QnAllocTable* mem_route_table = NULL;
+static THREADLOCAL QnArena* mem_route_arena = NULL;
+
+// 지금 스레드의 메모리 테이블
+FINLINE const QnAllocTable* qn_mem_table(void)
+{
+	const QnAllocTable* table = mem_route_table;
+	return table != NULL ? table : &mem_impl.table;
+}
+
+// 스레드 메모리 테이블을 넣는다
+static bool qn_mem_route_push(const QnAllocTable* table, QnArena* arena)
+{
+	qn_return_when_fail(mem_route_count < MAX_MEMTBL_STACK, false);
+	MemRoute* route = &mem_routes[mem_route_count++];
+	route->table = table;
+	route->arena = arena;
+	mem_route_table = table;
+	mem_route_arena = arena;
+	return true;
+}
+
 //
 bool qn_memtbl(const QnAllocTable* table)
 {
 	if (
 #ifndef QS_NO_MEMORY_PROFILE
-		mem_impl.index != 0 ||
+		mem_impl.caches != NULL ||
 #endif
 		table == NULL ||
 		table->_alloc == NULL ||
@@ -629,10 +1173,39 @@ bool qn_memtbl(const QnAllocTable* table)
 	return true;
 }
 
+//
+bool qn_memtbl_push(const QnAllocTable* table)
+{
+	if (table == NULL ||
+		table->_alloc == NULL ||
+		table->_realloc == NULL ||
+		table->_free == NULL)
+		return false;
+	return qn_mem_route_push(table, NULL);
+}
+
+//
+void qn_memtbl_pop(void)
+{
+	qn_return_when_fail(mem_route_count > 0, /*void*/);
+	mem_route_count--;
+	if (mem_route_count == 0)
+	{
+		mem_route_table = NULL;
+		mem_route_arena = NULL;
+	}
+	else
+	{
+		const MemRoute* route = &mem_routes[mem_route_count - 1];
+		mem_route_table = route->table;
+		mem_route_arena = route->arena;
+	}
+}
+
 //
 void qn_mem_free(void* ptr)
 {
-	mem_impl.table._free(ptr);
+	qn_mem_table()->_free(ptr);
 }
 
 //
@@ -640,20 +1213,20 @@ void qn_mem_free_ptr(void* pptr)
 {
 	void** ptr = (void**)pptr;
 	if (ptr != NULL)
-		mem_impl.table._free(*ptr);
+		qn_mem_table()->_free(*ptr);
 }
 
 #ifdef QS_NO_MEMORY_PROFILE
 //
 void* qn_a_alloc(const size_t size, const bool zero)
 {
-	return mem_impl.table._alloc(size, zero);
+	return qn_mem_table()->_alloc(size, zero);
 }
 
 //
 void* qn_a_realloc(void* ptr, const size_t size)
 {
-	return mem_impl.table._realloc(ptr, size);
+	return qn_mem_table()->_realloc(ptr, size);
 }
 
 //
@@ -675,13 +1248,13 @@ void* qn_a_mem_dup(const void* ptr, size_t size_or_zero_if_psz)
 //
 void* qn_a_i_alloc(const size_t size, const bool zero, const char* desc, const size_t line)
 {
-	return mem_impl.table._alloc(size, zero, desc, line);
+	return qn_mem_table()->_alloc(size, zero, desc, line);
 }
 
 //
 void* qn_a_i_realloc(void* ptr, const size_t size, const char* desc, const size_t line)
 {
-	return mem_impl.table._realloc(ptr, size, desc, line);
+	return qn_mem_table()->_realloc(ptr, size, desc, line);
 }
 
 //
@@ -700,3 +1273,402 @@ void* qn_a_i_mem_dup(const void* ptr, size_t size_or_zero_if_psz, const char* de
 	return d;
 }
 #endif
+
+
+//////////////////////////////////////////////////////////////////////////
+// 아레나
+
+#define ARENA_ALIGN				16
+#define ARENA_CHUNK_SIZE		(64 * 1024)
+
+// 아레나 덩어리, 데이터는 바로 뒤에 붙는다
+typedef struct ARENACHUNK
+{
+	struct ARENACHUNK*	prev;
+	size_t				size;
+	size_t				base;
+	size_t				dummy;
+} ArenaChunk;
+static_assert(sizeof(ArenaChunk) % ARENA_ALIGN == 0, "ArenaChunk size is not aligned!");
+
+// 아레나
+struct QNARENA
+{
+	ArenaChunk*			chunk;
+	byte*				ptr;
+	byte*				end;
+	byte*				last;
+
+	ArenaChunk*			spare;
+	size_t				chunk_size;
+};
+
+#define ARENA_CHUNK_DATA(c)		((byte*)(c) + sizeof(ArenaChunk))
+#define ARENA_CHUNK_END(c)		(ARENA_CHUNK_DATA(c) + (c)->size)
+
+// 아레나 덩어리와 구조체는 전역 메모리 테이블에서 가져온다
+#ifdef QS_NO_MEMORY_PROFILE
+#define ARENA_SYS_ALLOC(size)	mem_impl.table._alloc(size, false)
+#else
+#define ARENA_SYS_ALLOC(size)	mem_impl.table._alloc(size, false, __FUNCTION__, __LINE__)
+#endif
+#define ARENA_SYS_FREE(ptr)		mem_impl.table._free(ptr)
+
+//
+QnArena* qn_new_arena(size_t chunk_size)
+{
+	QnArena* self = (QnArena*)ARENA_SYS_ALLOC(sizeof(QnArena));
+	qn_zero_1(self);
+	self->chunk_size = chunk_size == 0 ? ARENA_CHUNK_SIZE : QN_ALIGN(chunk_size, ARENA_ALIGN);
+	return self;
+}
+
+// 덩어리 목록을 해제한다
+static void qn_arena_free_chunks(ArenaChunk* chunk)
+{
+	for (ArenaChunk* prev; chunk; chunk = prev)
+	{
+		prev = chunk->prev;
+		ARENA_SYS_FREE(chunk);
+	}
+}
+
+//
+void qn_delete_arena(QnArena* self)
+{
+	qn_return_when_fail(self != NULL, /*void*/);
+	qn_arena_free_chunks(self->chunk);
+	qn_arena_free_chunks(self->spare);
+	ARENA_SYS_FREE(self);
+}
+
+// 새 덩어리로 넘어간다. 남은 덩어리가 있으면 다시 쓴다
+static void qn_arena_grow(QnArena* self, const size_t size)
+{
+	ArenaChunk* chunk = NULL;
+	for (ArenaChunk** pp = &self->spare; *pp; pp = &(*pp)->prev)
+	{
+		if ((*pp)->size >= size)
+		{
+			chunk = *pp;
+			*pp = chunk->prev;
+			break;
+		}
+	}
+	if (chunk == NULL)
+	{
+		const size_t chunk_size = QN_MAX(self->chunk_size, size);
+		chunk = (ArenaChunk*)ARENA_SYS_ALLOC(sizeof(ArenaChunk) + chunk_size);
+		chunk->size = chunk_size;
+	}
+	chunk->base = self->chunk == NULL ? 0 : self->chunk->base + (size_t)(self->ptr - ARENA_CHUNK_DATA(self->chunk));
+	chunk->prev = self->chunk;
+	self->chunk = chunk;
+	self->ptr = ARENA_CHUNK_DATA(chunk);
+	self->end = ARENA_CHUNK_END(chunk);
+}
+
+//
+void* qn_arena_alloc(QnArena* self, size_t size, const bool zero)
+{
+	size = QN_ALIGN(size == 0 ? 1 : size, ARENA_ALIGN);
+	if ((size_t)(self->end - self->ptr) < size)
+		qn_arena_grow(self, size);
+	byte* ptr = self->ptr;
+	self->ptr += size;
+	self->last = ptr;
+	if (zero)
+		memset(ptr, 0, size);
+	return ptr;
+}
+
+// 메모리가 든 덩어리를 찾는다
+static const ArenaChunk* qn_arena_find(const QnArena* self, const void* ptr)
+{
+	for (const ArenaChunk* chunk = self->chunk; chunk; chunk = chunk->prev)
+	{
+		if ((const byte*)ptr >= ARENA_CHUNK_DATA(chunk) && (const byte*)ptr < ARENA_CHUNK_END(chunk))
+			return chunk;
+	}
+	return NULL;
+}
+
+//
+void* qn_arena_realloc(QnArena* self, void* ptr, const size_t size)
+{
+	if (ptr == NULL)
+		return qn_arena_alloc(self, size, false);
+	const size_t aligned = QN_ALIGN(size == 0 ? 1 : size, ARENA_ALIGN);
+	if (ptr == self->last && (size_t)(self->end - (byte*)ptr) >= aligned)
+	{
+		// 마지막 할당이면 그 자리에서
+		self->ptr = (byte*)ptr + aligned;
+		return ptr;
+	}
+
+	// 원래 크기는 모르지만 덩어리 끝(지금 덩어리면 할당 위치)까지는 읽을 수 있다
+	const ArenaChunk* chunk = qn_arena_find(self, ptr);
+	qn_return_when_fail(chunk != NULL, NULL);
+	const byte* limit = chunk == self->chunk ? self->ptr : ARENA_CHUNK_END(chunk);
+	const size_t avail = (size_t)(limit - (byte*)ptr);
+	void* newptr = qn_arena_alloc(self, size, false);
+	memcpy(newptr, ptr, QN_MIN(avail, size));
+	return newptr;
+}
+
+//
+void qn_arena_free(QnArena* self, void* ptr)
+{
+	if (ptr != NULL && ptr == self->last)
+	{
+		self->ptr = self->last;
+		self->last = NULL;
+	}
+}
+
+//
+QnArenaMark qn_arena_mark(const QnArena* self)
+{
+	return (QnArenaMark) { self->chunk, self->ptr };
+}
+
+//
+void qn_arena_rewind(QnArena* self, const QnArenaMark mark)
+{
+	while (self->chunk != NULL && self->chunk != mark.chunk)
+	{
+		ArenaChunk* chunk = self->chunk;
+		self->chunk = chunk->prev;
+		chunk->prev = self->spare;
+		self->spare = chunk;
+	}
+	if (self->chunk == NULL)
+	{
+		self->ptr = self->end = NULL;
+	}
+	else
+	{
+		self->ptr = mark.ptr;
+		self->end = ARENA_CHUNK_END(self->chunk);
+	}
+	self->last = NULL;
+}
+
+//
+void qn_arena_reset(QnArena* self)
+{
+	qn_arena_rewind(self, (QnArenaMark) { NULL, NULL });
+}
+
+//
+size_t qn_arena_size(const QnArena* self)
+{
+	if (self->chunk == NULL)
+		return 0;
+	return self->chunk->base + (size_t)(self->ptr - ARENA_CHUNK_DATA(self->chunk));
+}
+
+//
+bool qn_arena_own(const QnArena* self, const void* ptr)
+{
+	if (self->chunk != NULL && (const byte*)ptr >= ARENA_CHUNK_DATA(self->chunk) && (const byte*)ptr < self->ptr)
+		return true;
+	return qn_arena_find(self, ptr) != NULL;
+}
+
+// 아레나 테이블, 지금 스레드의 아레나로 보낸다
+#ifdef QS_NO_MEMORY_PROFILE
+static void* qn_arena_table_alloc(const size_t size, const bool zero)
+#else
+static void* qn_arena_table_alloc(const size_t size, const bool zero, const char* desc, const size_t line)
+#endif
+{
+#ifndef QS_NO_MEMORY_PROFILE
+	QN_DUMMY(desc);
+	QN_DUMMY(line);
+#endif
+	return qn_arena_alloc(mem_route_arena, size, zero);
+}
+
+#ifdef QS_NO_MEMORY_PROFILE
+static void* qn_arena_table_realloc(void* ptr, const size_t size)
+#else
+static void* qn_arena_table_realloc(void* ptr, const size_t size, const char* desc, const size_t line)
+#endif
+{
+#ifndef QS_NO_MEMORY_PROFILE
+	QN_DUMMY(desc);
+	QN_DUMMY(line);
+#endif
+	QnArena* arena = mem_route_arena;
+	if (ptr == NULL || qn_arena_own(arena, ptr))
+		return qn_arena_realloc(arena, ptr, size);
+#ifdef QS_NO_MEMORY_PROFILE
+	return mem_impl.table._realloc(ptr, size);
+#else
+	return mem_impl.table._realloc(ptr, size, desc, line);
+#endif
+}
+
+static void qn_arena_table_free(void* ptr)
+{
+	if (ptr == NULL)
+		return;
+	QnArena* arena = mem_route_arena;
+	if (qn_arena_own(arena, ptr))
+		qn_arena_free(arena, ptr);
+	else
+		mem_impl.table._free(ptr);
+}
+
+static const QnAllocTable arena_table = { qn_arena_table_alloc, qn_arena_table_realloc, qn_arena_table_free, };
+
+//
+bool qn_arena_push(QnArena* self)
+{
+	qn_return_when_fail(self != NULL, false);
+	return qn_mem_route_push(&arena_table, self);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// 메모리 풀
+
+#define POOL_ALIGN				16
+#define POOL_SLAB_SIZE			4096
+
+// 슬랩, 항목은 바로 뒤에 붙는다
+typedef struct POOLSLAB
+{
+	struct POOLSLAB*	next;
+	size_t				dummy;
+} PoolSlab;
+static_assert(sizeof(PoolSlab) % POOL_ALIGN == 0, "PoolSlab size is not aligned!");
+
+// 해제된 항목
+typedef struct POOLITEM
+{
+	struct POOLITEM*	next;
+} PoolItem;
+
+// 메모리 풀
+struct QNPOOL
+{
+	PoolItem*			frst;
+	byte*				ptr;
+	byte*				end;
+	PoolSlab*			slab;
+
+	size_t				item_size;
+	size_t				slab_count;
+	size_t				count;
+
+	bool				thread_safe;
+#ifndef QS_NO_SPINLOCK
+	QnSpinLock			lock;
+#endif
+};
+
+//
+QnPool* qn_new_pool(const size_t item_size, const size_t slab_count, const bool thread_safe)
+{
+	qn_return_when_fail(item_size > 0, NULL);
+	QnPool* self = (QnPool*)ARENA_SYS_ALLOC(sizeof(QnPool));
+	qn_zero_1(self);
+	self->item_size = QN_ALIGN(QN_MAX(item_size, sizeof(PoolItem)), POOL_ALIGN);
+	self->slab_count = slab_count != 0 ? slab_count : QN_MAX((POOL_SLAB_SIZE - sizeof(PoolSlab)) / self->item_size, 8);
+	self->thread_safe = thread_safe;
+	return self;
+}
+
+//
+void qn_delete_pool(QnPool* self)
+{
+	qn_return_when_fail(self != NULL, /*void*/);
+	for (PoolSlab* next, *slab = self->slab; slab; slab = next)
+	{
+		next = slab->next;
+		ARENA_SYS_FREE(slab);
+	}
+	ARENA_SYS_FREE(self);
+}
+
+// 잠금을 쓰는 풀만 잠근다
+#define POOL_LOCK(pool)			QN_STMT_BEGIN{ if ((pool)->thread_safe) { QN_LOCK((pool)->lock); } }QN_STMT_END
+#define POOL_UNLOCK(pool)		QN_STMT_BEGIN{ if ((pool)->thread_safe) { QN_UNLOCK((pool)->lock); } }QN_STMT_END
+
+//
+void* qn_pool_alloc(QnPool* self, const bool zero)
+{
+	void* ptr;
+	POOL_LOCK(self);
+	if (self->frst != NULL)
+	{
+		ptr = self->frst;
+		self->frst = self->frst->next;
+	}
+	else
+	{
+		if (self->ptr == self->end)
+		{
+			// 남은 슬랩이 없으면 새로
+			PoolSlab* slab = (PoolSlab*)ARENA_SYS_ALLOC(sizeof(PoolSlab) + self->item_size * self->slab_count);
+			slab->next = self->slab;
+			self->slab = slab;
+			self->ptr = (byte*)slab + sizeof(PoolSlab);
+			self->end = self->ptr + self->item_size * self->slab_count;
+		}
+		ptr = self->ptr;
+		self->ptr += self->item_size;
+	}
+	self->count++;
+	POOL_UNLOCK(self);
+	if (zero)
+		memset(ptr, 0, self->item_size);
+	return ptr;
+}
+
+//
+void qn_pool_free(QnPool* self, void* ptr)
+{
+	qn_return_when_fail(ptr != NULL, /*void*/);
+	PoolItem* item = (PoolItem*)ptr;
+	POOL_LOCK(self);
+	item->next = self->frst;
+	self->frst = item;
+	self->count--;
+	POOL_UNLOCK(self);
+}
+
+//
+void qn_pool_reset(QnPool* self)
+{
+	POOL_LOCK(self);
+	// 첫 슬랩은 밀어내기로, 나머지 슬랩은 해제 목록으로
+	self->frst = NULL;
+	self->ptr = self->end = NULL;
+	for (PoolSlab* slab = self->slab; slab; slab = slab->next)
+	{
+		byte* data = (byte*)slab + sizeof(PoolSlab);
+		if (slab == self->slab)
+		{
+			self->ptr = data;
+			self->end = data + self->item_size * self->slab_count;
+			continue;
+		}
+		for (size_t i = 0; i < self->slab_count; i++)
+		{
+			PoolItem* item = (PoolItem*)(data + i * self->item_size);
+			item->next = self->frst;
+			self->frst = item;
+		}
+	}
+	self->count = 0;
+	POOL_UNLOCK(self);
+}
+
+//
+size_t qn_pool_count(const QnPool* self)
+{
+	return self->count;
+}
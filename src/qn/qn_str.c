@@ -83,7 +83,7 @@ void* qn_memzucp(const void* src, const size_t srcsize, /*NULLABLE*/size_t* dest
 		size *= 2;
 		p = qn_realloc(p, size, byte);
 		ret = sinflate(p, size, src, (int)srcsize);
-	} while (ret == size);
+	} while (ret < 0);	// 출력이 모자라면 -1
 
 	if (destsize)
 		*destsize = ret;
@@ -107,6 +107,419 @@ void* qn_memzucp_s(const void* src, const size_t srcsize, const size_t destsize)
 	return p;
 }
 
+// LZ 코덱, LZ4 블럭 형식을 따른다
+#define LZ_MIN_MATCH		4
+#define LZ_LAST_LITERALS	5				// 마지막 5바이트는 언제나 리터럴
+#define LZ_MF_LIMIT			12				// 끝에서 12바이트 안에서는 일치를 찾지 않는다
+#define LZ_MAX_DISTANCE		65535
+#define LZ_HASH_LOG			16
+#define LZ_CHAIN_MASK		0xFFFF
+
+//
+FINLINE uint _lz_read32(const byte* p)
+{
+	uint v;
+	memcpy(&v, p, sizeof(uint));
+	return v;
+}
+
+//
+FINLINE uint _lz_hash(const byte* p)
+{
+	return (_lz_read32(p) * 2654435761U) >> (32 - LZ_HASH_LOG);
+}
+
+// 일치 길이, 8바이트씩 비교
+FINLINE size_t _lz_count(const byte* p, const byte* m, const byte* limit)
+{
+	const byte* start = p;
+	while (p + sizeof(ullong) <= limit)
+	{
+		ullong a, b;
+		memcpy(&a, p, sizeof(ullong));
+		memcpy(&b, m, sizeof(ullong));
+		if (a != b)
+			return (size_t)(p - start) + (qn_ctz64(a ^ b) >> 3);
+		p += sizeof(ullong);
+		m += sizeof(ullong);
+	}
+	while (p < limit && *p == *m)
+		p++, m++;
+	return (size_t)(p - start);
+}
+
+// 길이 덧붙이기, 15 이상이면 255 단위로 이어 붙인다
+FINLINE byte* _lz_put_length(byte* op, size_t length)
+{
+	for (; length >= 255; length -= 255)
+		*op++ = 255;
+	*op++ = (byte)length;
+	return op;
+}
+
+// 리터럴 쓰기, 토큰 위치를 반환
+static byte* _lz_put_literals(byte* op, byte** token, const byte* anchor, const size_t length)
+{
+	*token = op++;
+	if (length >= 15)
+	{
+		**token = 15 << 4;
+		op = _lz_put_length(op, length - 15);
+	}
+	else
+		**token = (byte)(length << 4);
+	memcpy(op, anchor, length);
+	return op + length;
+}
+
+// 시퀀스 하나 쓰기
+static byte* _lz_put_sequence(byte* op, const byte* anchor, const byte* ip, const size_t offset, const size_t length)
+{
+	byte* token;
+	op = _lz_put_literals(op, &token, anchor, (size_t)(ip - anchor));
+	*op++ = (byte)(offset & 0xFF);
+	*op++ = (byte)(offset >> 8);
+	const size_t ml = length - LZ_MIN_MATCH;
+	if (ml >= 15)
+	{
+		*token |= 15;
+		op = _lz_put_length(op, ml - 15);
+	}
+	else
+		*token |= (byte)ml;
+	return op;
+}
+
+// 체인에 위치 넣기, 체인에는 같은 해시를 가진 앞 위치까지의 거리를 둔다
+FINLINE void _lz_chain_insert(uint* head, ushort* chain, const byte* src, const size_t pos)
+{
+	const uint h = _lz_hash(src + pos);
+	const size_t prev = head[h];
+	const size_t delta = prev == 0 ? 0 : pos - (prev - 1);
+	chain[pos & LZ_CHAIN_MASK] = (ushort)(delta > LZ_MAX_DISTANCE ? 0 : delta);
+	head[h] = (uint)pos + 1;
+}
+
+// 체인을 따라가며 제일 긴 일치 찾기
+static size_t _lz_chain_find(const uint* head, const ushort* chain, const byte* src, const byte* ip, const byte* limit, int depth, const byte** match)
+{
+	const size_t pos = (size_t)(ip - src);
+	const uint cur = _lz_read32(ip);
+	size_t best = 0;
+	size_t cand = head[_lz_hash(ip)];
+	if (cand == 0)
+		return 0;
+	cand--;
+	while (depth-- > 0 && pos - cand <= LZ_MAX_DISTANCE)
+	{
+		const byte* m = src + cand;
+		if (_lz_read32(m) == cur && m[best] == ip[best])
+		{
+			const size_t len = LZ_MIN_MATCH + _lz_count(ip + LZ_MIN_MATCH, m + LZ_MIN_MATCH, limit);
+			if (len > best)
+			{
+				best = len;
+				*match = m;
+			}
+		}
+		const ushort delta = chain[cand & LZ_CHAIN_MASK];
+		if (delta == 0 || delta > cand)
+			break;
+		cand -= delta;
+	}
+	return best;
+}
+
+// LZ 압축, 레벨 5까지는 해시 하나만 보고 6부터는 체인을 따라간다
+static size_t _lz_compress(byte* dest, const byte* src, const size_t size, const int level)
+{
+	byte* op = dest;
+	const byte* ip = src;
+	const byte* anchor = src;
+	const byte* const iend = src + size;
+
+	if (size > LZ_MF_LIMIT)
+	{
+		const byte* const mflimit = iend - LZ_MF_LIMIT;
+		const byte* const matchlimit = iend - LZ_LAST_LITERALS;
+		const int depth = level >= 6 ? 1 << (level - 2) : 0;
+		const uint skip = level >= 6 ? 0 : 3 + (uint)QN_CLAMP(level, 1, 5);
+		uint* head = qn_alloc_zero(1 << LZ_HASH_LOG, uint);			// 위치 + 1, 0이면 비어 있음
+		ushort* chain = depth > 0 ? qn_alloc(LZ_CHAIN_MASK + 1, ushort) : NULL;
+		size_t inserted = 0;
+
+		while (ip < mflimit)
+		{
+			const byte* match = NULL;
+			size_t len = 0;
+			if (depth == 0)
+			{
+				// 빠른 쪽, 못 찾을수록 건너뛰는 폭을 늘린다
+				size_t attempts = (size_t)1 << skip;
+				while (ip < mflimit)
+				{
+					const uint h = _lz_hash(ip);
+					const size_t ref = head[h];
+					head[h] = (uint)(ip - src) + 1;
+					if (ref != 0)
+					{
+						const byte* m = src + ref - 1;
+						if ((size_t)(ip - m) <= LZ_MAX_DISTANCE && _lz_read32(m) == _lz_read32(ip))
+						{
+							match = m;
+							len = LZ_MIN_MATCH + _lz_count(ip + LZ_MIN_MATCH, m + LZ_MIN_MATCH, matchlimit);
+							break;
+						}
+					}
+					ip += attempts++ >> skip;
+				}
+			}
+			else
+			{
+				// 체인 쪽, 압축 안되는 구간은 조금씩 건너뛴다
+				while (ip < mflimit)
+				{
+					for (; inserted < (size_t)(ip - src); inserted++)
+						_lz_chain_insert(head, chain, src, inserted);
+					len = _lz_chain_find(head, chain, src, ip, matchlimit, depth, &match);
+					if (len >= LZ_MIN_MATCH)
+						break;
+					ip += 1 + ((size_t)(ip - anchor) >> 8);
+				}
+			}
+			if (match == NULL || ip >= mflimit)
+				break;
+
+			// 뒤로 늘리기
+			while (ip > anchor && match > src && ip[-1] == match[-1])
+				ip--, match--, len++;
+
+			op = _lz_put_sequence(op, anchor, ip, (size_t)(ip - match), len);
+			ip += len;
+			anchor = ip;
+			if (depth == 0 && ip < mflimit)
+				head[_lz_hash(ip - 2)] = (uint)(ip - 2 - src) + 1;
+		}
+
+		qn_free(head);
+		qn_free(chain);
+	}
+
+	// 남은 리터럴
+	byte* token;
+	op = _lz_put_literals(op, &token, anchor, (size_t)(iend - anchor));
+	return (size_t)(op - dest);
+}
+
+// LZ 해제, 범위를 넘는 입력은 모두 실패로 처리한다
+static bool _lz_decompress(byte* dest, const size_t destsize, const byte* src, const size_t srcsize)
+{
+	const byte* ip = src;
+	const byte* const iend = src + srcsize;
+	byte* op = dest;
+	byte* const oend = dest + destsize;
+
+	for (;;)
+	{
+		if (ip >= iend)
+			return false;
+		const uint token = *ip++;
+
+		// 리터럴
+		size_t lit = token >> 4;
+		if (lit == 15)
+		{
+			byte b;
+			do
+			{
+				if (ip >= iend)
+					return false;
+				b = *ip++;
+				lit += b;
+			} while (b == 255);
+		}
+		if (lit > (size_t)(iend - ip) || lit > (size_t)(oend - op))
+			return false;
+		if (lit <= 16 && iend - ip >= 16 && oend - op >= 16)
+			memcpy(op, ip, 16);
+		else
+			memcpy(op, ip, lit);
+		op += lit;
+		ip += lit;
+		if (ip == iend)
+			return op == oend;
+
+		// 일치
+		if (iend - ip < 2)
+			return false;
+		const size_t offset = (size_t)ip[0] | (size_t)ip[1] << 8;
+		ip += 2;
+		if (offset == 0 || offset > (size_t)(op - dest))
+			return false;
+		size_t len = token & 15;
+		if (len == 15)
+		{
+			byte b;
+			do
+			{
+				if (ip >= iend)
+					return false;
+				b = *ip++;
+				len += b;
+			} while (b == 255);
+		}
+		len += LZ_MIN_MATCH;
+		if (len > (size_t)(oend - op))
+			return false;
+
+		const byte* match = op - offset;
+		if (offset >= 16 && (size_t)(oend - op) >= len + 16)
+		{
+			// 겹치지 않으니 16바이트씩 넘치게 복사
+			byte* const end = op + len;
+			do
+			{
+				memcpy(op, match, 16);
+				op += 16;
+				match += 16;
+			} while (op < end);
+			op = end;
+		}
+		else
+		{
+			// 겹치면 한 바이트씩
+			for (size_t i = 0; i < len; i++)
+				op[i] = match[i];
+			op += len;
+		}
+	}
+}
+
+//
+size_t qn_memcpr_bound(const QnCodec codec, const size_t srcsize)
+{
+	switch (codec)
+	{
+		case QNCODEC_DEFLATE:
+			return (size_t)sdefl_bound((int)srcsize);
+		case QNCODEC_LZ:
+			return srcsize + srcsize / 255 + 16;
+		default:
+			return srcsize;
+	}
+}
+
+//
+size_t qn_memcpr_raw(const QnCodec codec, const int level, void* dest, const void* src, const size_t srcsize)
+{
+	qn_return_when_fail(dest != NULL && src != NULL, 0);
+	switch (codec)
+	{
+		case QNCODEC_STORE:
+			memcpy(dest, src, srcsize);
+			return srcsize;
+		case QNCODEC_DEFLATE:
+		{
+			qn_return_when_fail(srcsize <= INT_MAX, 0);
+			struct sdefl* s = qn_alloc_zero_1(struct sdefl);
+			const int lvl = level <= 0 ? SDEFL_LVL_DEF : QN_MIN(level, SDEFL_LVL_MAX);
+			const int ret = sdeflate(s, dest, src, (int)srcsize, lvl);
+			qn_free(s);
+			return ret < 0 ? 0 : (size_t)ret;
+		}
+		case QNCODEC_LZ:
+			return _lz_compress(dest, src, srcsize, level <= 0 ? 3 : level);
+		default:
+			return 0;
+	}
+}
+
+//
+bool qn_memucp_raw(const QnCodec codec, void* dest, const size_t destsize, const void* src, const size_t srcsize)
+{
+	qn_return_when_fail(dest != NULL && src != NULL, false);
+	switch (codec)
+	{
+		case QNCODEC_STORE:
+			if (srcsize != destsize)
+				return false;
+			memcpy(dest, src, srcsize);
+			return true;
+		case QNCODEC_DEFLATE:
+			qn_return_when_fail(srcsize <= INT_MAX && destsize <= INT_MAX, false);
+			return sinflate(dest, (int)destsize, src, (int)srcsize) == (int)destsize;
+		case QNCODEC_LZ:
+			return _lz_decompress(dest, destsize, src, srcsize);
+		default:
+			return false;
+	}
+}
+
+// qn_memcpr 헤더, 'Q' 'Z' 코덱 0 다음 원래 크기를 64비트 리틀 엔디언으로
+#define MEMCPR_HEADER_SIZE	12
+
+//
+void* qn_memcpr(const QnCodec codec, const int level, const void* src, const size_t srcsize, /*NULLABLE*/size_t* destsize)
+{
+	qn_return_when_fail(src != NULL, NULL);
+	qn_return_when_fail(srcsize > 0, NULL);
+	qn_return_when_fail((uint)codec < QNCODEC_MAX_VALUE, NULL);
+
+	const size_t bound = QN_MAX(qn_memcpr_bound(codec, srcsize), srcsize);
+	byte* p = qn_alloc(MEMCPR_HEADER_SIZE + bound, byte);
+	QnCodec used = codec;
+	size_t size = qn_memcpr_raw(codec, level, p + MEMCPR_HEADER_SIZE, src, srcsize);
+	if (size == 0 || size >= srcsize)
+	{
+		// 작아지지 않으면 그냥 넣는다
+		used = QNCODEC_STORE;
+		size = srcsize;
+		memcpy(p + MEMCPR_HEADER_SIZE, src, srcsize);
+	}
+
+	p[0] = 'Q';
+	p[1] = 'Z';
+	p[2] = (byte)used;
+	p[3] = 0;
+	for (int i = 0; i < 8; i++)
+		p[4 + i] = (byte)((ullong)srcsize >> (i * 8));
+
+	if (destsize)
+		*destsize = MEMCPR_HEADER_SIZE + size;
+	return p;
+}
+
+//
+size_t qn_memucp_size(const void* src, const size_t srcsize)
+{
+	qn_return_when_fail(src != NULL, 0);
+	const byte* p = (const byte*)src;
+	if (srcsize < MEMCPR_HEADER_SIZE || p[0] != 'Q' || p[1] != 'Z' || p[2] >= QNCODEC_MAX_VALUE || p[3] != 0)
+		return 0;
+	ullong size = 0;
+	for (int i = 0; i < 8; i++)
+		size |= (ullong)p[4 + i] << (i * 8);
+	return (size_t)size;
+}
+
+//
+void* qn_memucp(const void* src, const size_t srcsize, /*NULLABLE*/size_t* destsize)
+{
+	const size_t size = qn_memucp_size(src, srcsize);
+	qn_return_when_fail(size > 0, NULL);
+
+	const byte* p = (const byte*)src;
+	byte* data = qn_alloc(size + 4, byte);
+	if (qn_memucp_raw((QnCodec)p[2], data, size, p + MEMCPR_HEADER_SIZE, srcsize - MEMCPR_HEADER_SIZE) == false)
+	{
+		qn_free(data);
+		return NULL;
+	}
+	if (destsize)
+		*destsize = size;
+	return data;
+}
+
 //
 char qn_memhrb(const size_t size, double* out)
 {
@@ -190,107 +603,2333 @@ const char* qn_char_base_table(bool upper)
 
 
 //////////////////////////////////////////////////////////////////////////
-// 아스키/멀티바이트 버전
-
-// DOPR 정리 공용
-static void printf_finish(PatrickPowellSprintfState* state)
+// 숫자 변환
+// 정수는 두 자리씩 표로, 실수 출력은 Schubfach (가장 짧은 왕복 값), 실수 읽기는 Eisel-Lemire
+// 둘 다 안되는 드문 경우만 큰 정수 계산이나 CRT로 넘어간다
+
+// 10진수 두 자리 표
+static const char num_digit2_table[201] =
+	"00010203040506070809" "10111213141516171819" "20212223242526272829" "30313233343536373839" "40414243444546474849"
+	"50515253545556575859" "60616263646566676869" "70717273747576777879" "80818283848586878889" "90919293949596979899";
+
+// 5^q를 [2^127, 2^128) 범위로 맞추고 아래를 버린 128비트 값 (위, 아래), q = NUM_POW5_MIN ~ NUM_POW5_MAX
+// 읽기(Eisel-Lemire)는 -342 ~ 308, 쓰기(Schubfach)는 -292 ~ 324를 쓴다
+#define NUM_POW5_MIN		(-342)
+#define NUM_POW5_MAX		324
+static const ullong num_pow5_table[NUM_POW5_MAX - NUM_POW5_MIN + 1][2] =
 {
-	if (state->maxlen > 0)
-		state->buf[state->currlen < state->maxlen - 1 ? state->currlen : state->maxlen - 1] = '\0';
+	{ 0xEEF453D6923BD65AULL, 0x113FAA2906A13B3FULL },
+	{ 0x9558B4661B6565F8ULL, 0x4AC7CA59A424C507ULL },
+	{ 0xBAAEE17FA23EBF76ULL, 0x5D79BCF00D2DF649ULL },
+	{ 0xE95A99DF8ACE6F53ULL, 0xF4D82C2C107973DCULL },
+	{ 0x91D8A02BB6C10594ULL, 0x79071B9B8A4BE869ULL },
+	{ 0xB64EC836A47146F9ULL, 0x9748E2826CDEE284ULL },
+	{ 0xE3E27A444D8D98B7ULL, 0xFD1B1B2308169B25ULL },
+	{ 0x8E6D8C6AB0787F72ULL, 0xFE30F0F5E50E20F7ULL },
+	{ 0xB208EF855C969F4FULL, 0xBDBD2D335E51A935ULL },
+	{ 0xDE8B2B66B3BC4723ULL, 0xAD2C788035E61382ULL },
+	{ 0x8B16FB203055AC76ULL, 0x4C3BCB5021AFCC31ULL },
+	{ 0xADDCB9E83C6B1793ULL, 0xDF4ABE242A1BBF3DULL },
+	{ 0xD953E8624B85DD78ULL, 0xD71D6DAD34A2AF0DULL },
+	{ 0x87D4713D6F33AA6BULL, 0x8672648C40E5AD68ULL },
+	{ 0xA9C98D8CCB009506ULL, 0x680EFDAF511F18C2ULL },
+	{ 0xD43BF0EFFDC0BA48ULL, 0x0212BD1B2566DEF2ULL },
+	{ 0x84A57695FE98746DULL, 0x014BB630F7604B57ULL },
+	{ 0xA5CED43B7E3E9188ULL, 0x419EA3BD35385E2DULL },
+	{ 0xCF42894A5DCE35EAULL, 0x52064CAC828675B9ULL },
+	{ 0x818995CE7AA0E1B2ULL, 0x7343EFEBD1940993ULL },
+	{ 0xA1EBFB4219491A1FULL, 0x1014EBE6C5F90BF8ULL },
+	{ 0xCA66FA129F9B60A6ULL, 0xD41A26E077774EF6ULL },
+	{ 0xFD00B897478238D0ULL, 0x8920B098955522B4ULL },
+	{ 0x9E20735E8CB16382ULL, 0x55B46E5F5D5535B0ULL },
+	{ 0xC5A890362FDDBC62ULL, 0xEB2189F734AA831DULL },
+	{ 0xF712B443BBD52B7BULL, 0xA5E9EC7501D523E4ULL },
+	{ 0x9A6BB0AA55653B2DULL, 0x47B233C92125366EULL },
+	{ 0xC1069CD4EABE89F8ULL, 0x999EC0BB696E840AULL },
+	{ 0xF148440A256E2C76ULL, 0xC00670EA43CA250DULL },
+	{ 0x96CD2A865764DBCAULL, 0x380406926A5E5728ULL },
+	{ 0xBC807527ED3E12BCULL, 0xC605083704F5ECF2ULL },
+	{ 0xEBA09271E88D976BULL, 0xF7864A44C633682EULL },
+	{ 0x93445B8731587EA3ULL, 0x7AB3EE6AFBE0211DULL },
+	{ 0xB8157268FDAE9E4CULL, 0x5960EA05BAD82964ULL },
+	{ 0xE61ACF033D1A45DFULL, 0x6FB92487298E33BDULL },
+	{ 0x8FD0C16206306BABULL, 0xA5D3B6D479F8E056ULL },
+	{ 0xB3C4F1BA87BC8696ULL, 0x8F48A4899877186CULL },
+	{ 0xE0B62E2929ABA83CULL, 0x331ACDABFE94DE87ULL },
+	{ 0x8C71DCD9BA0B4925ULL, 0x9FF0C08B7F1D0B14ULL },
+	{ 0xAF8E5410288E1B6FULL, 0x07ECF0AE5EE44DD9ULL },
+	{ 0xDB71E91432B1A24AULL, 0xC9E82CD9F69D6150ULL },
+	{ 0x892731AC9FAF056EULL, 0xBE311C083A225CD2ULL },
+	{ 0xAB70FE17C79AC6CAULL, 0x6DBD630A48AAF406ULL },
+	{ 0xD64D3D9DB981787DULL, 0x092CBBCCDAD5B108ULL },
+	{ 0x85F0468293F0EB4EULL, 0x25BBF56008C58EA5ULL },
+	{ 0xA76C582338ED2621ULL, 0xAF2AF2B80AF6F24EULL },
+	{ 0xD1476E2C07286FAAULL, 0x1AF5AF660DB4AEE1ULL },
+	{ 0x82CCA4DB847945CAULL, 0x50D98D9FC890ED4DULL },
+	{ 0xA37FCE126597973CULL, 0xE50FF107BAB528A0ULL },
+	{ 0xCC5FC196FEFD7D0CULL, 0x1E53ED49A96272C8ULL },
+	{ 0xFF77B1FCBEBCDC4FULL, 0x25E8E89C13BB0F7AULL },
+	{ 0x9FAACF3DF73609B1ULL, 0x77B191618C54E9ACULL },
+	{ 0xC795830D75038C1DULL, 0xD59DF5B9EF6A2417ULL },
+	{ 0xF97AE3D0D2446F25ULL, 0x4B0573286B44AD1DULL },
+	{ 0x9BECCE62836AC577ULL, 0x4EE367F9430AEC32ULL },
+	{ 0xC2E801FB244576D5ULL, 0x229C41F793CDA73FULL },
+	{ 0xF3A20279ED56D48AULL, 0x6B43527578C1110FULL },
+	{ 0x9845418C345644D6ULL, 0x830A13896B78AAA9ULL },
+	{ 0xBE5691EF416BD60CULL, 0x23CC986BC656D553ULL },
+	{ 0xEDEC366B11C6CB8FULL, 0x2CBFBE86B7EC8AA8ULL },
+	{ 0x94B3A202EB1C3F39ULL, 0x7BF7D71432F3D6A9ULL },
+	{ 0xB9E08A83A5E34F07ULL, 0xDAF5CCD93FB0CC53ULL },
+	{ 0xE858AD248F5C22C9ULL, 0xD1B3400F8F9CFF68ULL },
+	{ 0x91376C36D99995BEULL, 0x23100809B9C21FA1ULL },
+	{ 0xB58547448FFFFB2DULL, 0xABD40A0C2832A78AULL },
+	{ 0xE2E69915B3FFF9F9ULL, 0x16C90C8F323F516CULL },
+	{ 0x8DD01FAD907FFC3BULL, 0xAE3DA7D97F6792E3ULL },
+	{ 0xB1442798F49FFB4AULL, 0x99CD11CFDF41779CULL },
+	{ 0xDD95317F31C7FA1DULL, 0x40405643D711D583ULL },
+	{ 0x8A7D3EEF7F1CFC52ULL, 0x482835EA666B2572ULL },
+	{ 0xAD1C8EAB5EE43B66ULL, 0xDA3243650005EECFULL },
+	{ 0xD863B256369D4A40ULL, 0x90BED43E40076A82ULL },
+	{ 0x873E4F75E2224E68ULL, 0x5A7744A6E804A291ULL },
+	{ 0xA90DE3535AAAE202ULL, 0x711515D0A205CB36ULL },
+	{ 0xD3515C2831559A83ULL, 0x0D5A5B44CA873E03ULL },
+	{ 0x8412D9991ED58091ULL, 0xE858790AFE9486C2ULL },
+	{ 0xA5178FFF668AE0B6ULL, 0x626E974DBE39A872ULL },
+	{ 0xCE5D73FF402D98E3ULL, 0xFB0A3D212DC8128FULL },
+	{ 0x80FA687F881C7F8EULL, 0x7CE66634BC9D0B99ULL },
+	{ 0xA139029F6A239F72ULL, 0x1C1FFFC1EBC44E80ULL },
+	{ 0xC987434744AC874EULL, 0xA327FFB266B56220ULL },
+	{ 0xFBE9141915D7A922ULL, 0x4BF1FF9F0062BAA8ULL },
+	{ 0x9D71AC8FADA6C9B5ULL, 0x6F773FC3603DB4A9ULL },
+	{ 0xC4CE17B399107C22ULL, 0xCB550FB4384D21D3ULL },
+	{ 0xF6019DA07F549B2BULL, 0x7E2A53A146606A48ULL },
+	{ 0x99C102844F94E0FBULL, 0x2EDA7444CBFC426DULL },
+	{ 0xC0314325637A1939ULL, 0xFA911155FEFB5308ULL },
+	{ 0xF03D93EEBC589F88ULL, 0x793555AB7EBA27CAULL },
+	{ 0x96267C7535B763B5ULL, 0x4BC1558B2F3458DEULL },
+	{ 0xBBB01B9283253CA2ULL, 0x9EB1AAEDFB016F16ULL },
+	{ 0xEA9C227723EE8BCBULL, 0x465E15A979C1CADCULL },
+	{ 0x92A1958A7675175FULL, 0x0BFACD89EC191EC9ULL },
+	{ 0xB749FAED14125D36ULL, 0xCEF980EC671F667BULL },
+	{ 0xE51C79A85916F484ULL, 0x82B7E12780E7401AULL },
+	{ 0x8F31CC0937AE58D2ULL, 0xD1B2ECB8B0908810ULL },
+	{ 0xB2FE3F0B8599EF07ULL, 0x861FA7E6DCB4AA15ULL },
+	{ 0xDFBDCECE67006AC9ULL, 0x67A791E093E1D49AULL },
+	{ 0x8BD6A141006042BDULL, 0xE0C8BB2C5C6D24E0ULL },
+	{ 0xAECC49914078536DULL, 0x58FAE9F773886E18ULL },
+	{ 0xDA7F5BF590966848ULL, 0xAF39A475506A899EULL },
+	{ 0x888F99797A5E012DULL, 0x6D8406C952429603ULL },
+	{ 0xAAB37FD7D8F58178ULL, 0xC8E5087BA6D33B83ULL },
+	{ 0xD5605FCDCF32E1D6ULL, 0xFB1E4A9A90880A64ULL },
+	{ 0x855C3BE0A17FCD26ULL, 0x5CF2EEA09A55067FULL },
+	{ 0xA6B34AD8C9DFC06FULL, 0xF42FAA48C0EA481EULL },
+	{ 0xD0601D8EFC57B08BULL, 0xF13B94DAF124DA26ULL },
+	{ 0x823C12795DB6CE57ULL, 0x76C53D08D6B70858ULL },
+	{ 0xA2CB1717B52481EDULL, 0x54768C4B0C64CA6EULL },
+	{ 0xCB7DDCDDA26DA268ULL, 0xA9942F5DCF7DFD09ULL },
+	{ 0xFE5D54150B090B02ULL, 0xD3F93B35435D7C4CULL },
+	{ 0x9EFA548D26E5A6E1ULL, 0xC47BC5014A1A6DAFULL },
+	{ 0xC6B8E9B0709F109AULL, 0x359AB6419CA1091BULL },
+	{ 0xF867241C8CC6D4C0ULL, 0xC30163D203C94B62ULL },
+	{ 0x9B407691D7FC44F8ULL, 0x79E0DE63425DCF1DULL },
+	{ 0xC21094364DFB5636ULL, 0x985915FC12F542E4ULL },
+	{ 0xF294B943E17A2BC4ULL, 0x3E6F5B7B17B2939DULL },
+	{ 0x979CF3CA6CEC5B5AULL, 0xA705992CEECF9C42ULL },
+	{ 0xBD8430BD08277231ULL, 0x50C6FF782A838353ULL },
+	{ 0xECE53CEC4A314EBDULL, 0xA4F8BF5635246428ULL },
+	{ 0x940F4613AE5ED136ULL, 0x871B7795E136BE99ULL },
+	{ 0xB913179899F68584ULL, 0x28E2557B59846E3FULL },
+	{ 0xE757DD7EC07426E5ULL, 0x331AEADA2FE589CFULL },
+	{ 0x9096EA6F3848984FULL, 0x3FF0D2C85DEF7621ULL },
+	{ 0xB4BCA50B065ABE63ULL, 0x0FED077A756B53A9ULL },
+	{ 0xE1EBCE4DC7F16DFBULL, 0xD3E8495912C62894ULL },
+	{ 0x8D3360F09CF6E4BDULL, 0x64712DD7ABBBD95CULL },
+	{ 0xB080392CC4349DECULL, 0xBD8D794D96AACFB3ULL },
+	{ 0xDCA04777F541C567ULL, 0xECF0D7A0FC5583A0ULL },
+	{ 0x89E42CAAF9491B60ULL, 0xF41686C49DB57244ULL },
+	{ 0xAC5D37D5B79B6239ULL, 0x311C2875C522CED5ULL },
+	{ 0xD77485CB25823AC7ULL, 0x7D633293366B828BULL },
+	{ 0x86A8D39EF77164BCULL, 0xAE5DFF9C02033197ULL },
+	{ 0xA8530886B54DBDEBULL, 0xD9F57F830283FDFCULL },
+	{ 0xD267CAA862A12D66ULL, 0xD072DF63C324FD7BULL },
+	{ 0x8380DEA93DA4BC60ULL, 0x4247CB9E59F71E6DULL },
+	{ 0xA46116538D0DEB78ULL, 0x52D9BE85F074E608ULL },
+	{ 0xCD795BE870516656ULL, 0x67902E276C921F8BULL },
+	{ 0x806BD9714632DFF6ULL, 0x00BA1CD8A3DB53B6ULL },
+	{ 0xA086CFCD97BF97F3ULL, 0x80E8A40ECCD228A4ULL },
+	{ 0xC8A883C0FDAF7DF0ULL, 0x6122CD128006B2CDULL },
+	{ 0xFAD2A4B13D1B5D6CULL, 0x796B805720085F81ULL },
+	{ 0x9CC3A6EEC6311A63ULL, 0xCBE3303674053BB0ULL },
+	{ 0xC3F490AA77BD60FCULL, 0xBEDBFC4411068A9CULL },
+	{ 0xF4F1B4D515ACB93BULL, 0xEE92FB5515482D44ULL },
+	{ 0x991711052D8BF3C5ULL, 0x751BDD152D4D1C4AULL },
+	{ 0xBF5CD54678EEF0B6ULL, 0xD262D45A78A0635DULL },
+	{ 0xEF340A98172AACE4ULL, 0x86FB897116C87C34ULL },
+	{ 0x9580869F0E7AAC0EULL, 0xD45D35E6AE3D4DA0ULL },
+	{ 0xBAE0A846D2195712ULL, 0x8974836059CCA109ULL },
+	{ 0xE998D258869FACD7ULL, 0x2BD1A438703FC94BULL },
+	{ 0x91FF83775423CC06ULL, 0x7B6306A34627DDCFULL },
+	{ 0xB67F6455292CBF08ULL, 0x1A3BC84C17B1D542ULL },
+	{ 0xE41F3D6A7377EECAULL, 0x20CABA5F1D9E4A93ULL },
+	{ 0x8E938662882AF53EULL, 0x547EB47B7282EE9CULL },
+	{ 0xB23867FB2A35B28DULL, 0xE99E619A4F23AA43ULL },
+	{ 0xDEC681F9F4C31F31ULL, 0x6405FA00E2EC94D4ULL },
+	{ 0x8B3C113C38F9F37EULL, 0xDE83BC408DD3DD04ULL },
+	{ 0xAE0B158B4738705EULL, 0x9624AB50B148D445ULL },
+	{ 0xD98DDAEE19068C76ULL, 0x3BADD624DD9B0957ULL },
+	{ 0x87F8A8D4CFA417C9ULL, 0xE54CA5D70A80E5D6ULL },
+	{ 0xA9F6D30A038D1DBCULL, 0x5E9FCF4CCD211F4CULL },
+	{ 0xD47487CC8470652BULL, 0x7647C3200069671FULL },
+	{ 0x84C8D4DFD2C63F3BULL, 0x29ECD9F40041E073ULL },
+	{ 0xA5FB0A17C777CF09ULL, 0xF468107100525890ULL },
+	{ 0xCF79CC9DB955C2CCULL, 0x7182148D4066EEB4ULL },
+	{ 0x81AC1FE293D599BFULL, 0xC6F14CD848405530ULL },
+	{ 0xA21727DB38CB002FULL, 0xB8ADA00E5A506A7CULL },
+	{ 0xCA9CF1D206FDC03BULL, 0xA6D90811F0E4851CULL },
+	{ 0xFD442E4688BD304AULL, 0x908F4A166D1DA663ULL },
+	{ 0x9E4A9CEC15763E2EULL, 0x9A598E4E043287FEULL },
+	{ 0xC5DD44271AD3CDBAULL, 0x40EFF1E1853F29FDULL },
+	{ 0xF7549530E188C128ULL, 0xD12BEE59E68EF47CULL },
+	{ 0x9A94DD3E8CF578B9ULL, 0x82BB74F8301958CEULL },
+	{ 0xC13A148E3032D6E7ULL, 0xE36A52363C1FAF01ULL },
+	{ 0xF18899B1BC3F8CA1ULL, 0xDC44E6C3CB279AC1ULL },
+	{ 0x96F5600F15A7B7E5ULL, 0x29AB103A5EF8C0B9ULL },
+	{ 0xBCB2B812DB11A5DEULL, 0x7415D448F6B6F0E7ULL },
+	{ 0xEBDF661791D60F56ULL, 0x111B495B3464AD21ULL },
+	{ 0x936B9FCEBB25C995ULL, 0xCAB10DD900BEEC34ULL },
+	{ 0xB84687C269EF3BFBULL, 0x3D5D514F40EEA742ULL },
+	{ 0xE65829B3046B0AFAULL, 0x0CB4A5A3112A5112ULL },
+	{ 0x8FF71A0FE2C2E6DCULL, 0x47F0E785EABA72ABULL },
+	{ 0xB3F4E093DB73A093ULL, 0x59ED216765690F56ULL },
+	{ 0xE0F218B8D25088B8ULL, 0x306869C13EC3532CULL },
+	{ 0x8C974F7383725573ULL, 0x1E414218C73A13FBULL },
+	{ 0xAFBD2350644EEACFULL, 0xE5D1929EF90898FAULL },
+	{ 0xDBAC6C247D62A583ULL, 0xDF45F746B74ABF39ULL },
+	{ 0x894BC396CE5DA772ULL, 0x6B8BBA8C328EB783ULL },
+	{ 0xAB9EB47C81F5114FULL, 0x066EA92F3F326564ULL },
+	{ 0xD686619BA27255A2ULL, 0xC80A537B0EFEFEBDULL },
+	{ 0x8613FD0145877585ULL, 0xBD06742CE95F5F36ULL },
+	{ 0xA798FC4196E952E7ULL, 0x2C48113823B73704ULL },
+	{ 0xD17F3B51FCA3A7A0ULL, 0xF75A15862CA504C5ULL },
+	{ 0x82EF85133DE648C4ULL, 0x9A984D73DBE722FBULL },
+	{ 0xA3AB66580D5FDAF5ULL, 0xC13E60D0D2E0EBBAULL },
+	{ 0xCC963FEE10B7D1B3ULL, 0x318DF905079926A8ULL },
+	{ 0xFFBBCFE994E5C61FULL, 0xFDF17746497F7052ULL },
+	{ 0x9FD561F1FD0F9BD3ULL, 0xFEB6EA8BEDEFA633ULL },
+	{ 0xC7CABA6E7C5382C8ULL, 0xFE64A52EE96B8FC0ULL },
+	{ 0xF9BD690A1B68637BULL, 0x3DFDCE7AA3C673B0ULL },
+	{ 0x9C1661A651213E2DULL, 0x06BEA10CA65C084EULL },
+	{ 0xC31BFA0FE5698DB8ULL, 0x486E494FCFF30A62ULL },
+	{ 0xF3E2F893DEC3F126ULL, 0x5A89DBA3C3EFCCFAULL },
+	{ 0x986DDB5C6B3A76B7ULL, 0xF89629465A75E01CULL },
+	{ 0xBE89523386091465ULL, 0xF6BBB397F1135823ULL },
+	{ 0xEE2BA6C0678B597FULL, 0x746AA07DED582E2CULL },
+	{ 0x94DB483840B717EFULL, 0xA8C2A44EB4571CDCULL },
+	{ 0xBA121A4650E4DDEBULL, 0x92F34D62616CE413ULL },
+	{ 0xE896A0D7E51E1566ULL, 0x77B020BAF9C81D17ULL },
+	{ 0x915E2486EF32CD60ULL, 0x0ACE1474DC1D122EULL },
+	{ 0xB5B5ADA8AAFF80B8ULL, 0x0D819992132456BAULL },
+	{ 0xE3231912D5BF60E6ULL, 0x10E1FFF697ED6C69ULL },
+	{ 0x8DF5EFABC5979C8FULL, 0xCA8D3FFA1EF463C1ULL },
+	{ 0xB1736B96B6FD83B3ULL, 0xBD308FF8A6B17CB2ULL },
+	{ 0xDDD0467C64BCE4A0ULL, 0xAC7CB3F6D05DDBDEULL },
+	{ 0x8AA22C0DBEF60EE4ULL, 0x6BCDF07A423AA96BULL },
+	{ 0xAD4AB7112EB3929DULL, 0x86C16C98D2C953C6ULL },
+	{ 0xD89D64D57A607744ULL, 0xE871C7BF077BA8B7ULL },
+	{ 0x87625F056C7C4A8BULL, 0x11471CD764AD4972ULL },
+	{ 0xA93AF6C6C79B5D2DULL, 0xD598E40D3DD89BCFULL },
+	{ 0xD389B47879823479ULL, 0x4AFF1D108D4EC2C3ULL },
+	{ 0x843610CB4BF160CBULL, 0xCEDF722A585139BAULL },
+	{ 0xA54394FE1EEDB8FEULL, 0xC2974EB4EE658828ULL },
+	{ 0xCE947A3DA6A9273EULL, 0x733D226229FEEA32ULL },
+	{ 0x811CCC668829B887ULL, 0x0806357D5A3F525FULL },
+	{ 0xA163FF802A3426A8ULL, 0xCA07C2DCB0CF26F7ULL },
+	{ 0xC9BCFF6034C13052ULL, 0xFC89B393DD02F0B5ULL },
+	{ 0xFC2C3F3841F17C67ULL, 0xBBAC2078D443ACE2ULL },
+	{ 0x9D9BA7832936EDC0ULL, 0xD54B944B84AA4C0DULL },
+	{ 0xC5029163F384A931ULL, 0x0A9E795E65D4DF11ULL },
+	{ 0xF64335BCF065D37DULL, 0x4D4617B5FF4A16D5ULL },
+	{ 0x99EA0196163FA42EULL, 0x504BCED1BF8E4E45ULL },
+	{ 0xC06481FB9BCF8D39ULL, 0xE45EC2862F71E1D6ULL },
+	{ 0xF07DA27A82C37088ULL, 0x5D767327BB4E5A4CULL },
+	{ 0x964E858C91BA2655ULL, 0x3A6A07F8D510F86FULL },
+	{ 0xBBE226EFB628AFEAULL, 0x890489F70A55368BULL },
+	{ 0xEADAB0ABA3B2DBE5ULL, 0x2B45AC74CCEA842EULL },
+	{ 0x92C8AE6B464FC96FULL, 0x3B0B8BC90012929DULL },
+	{ 0xB77ADA0617E3BBCBULL, 0x09CE6EBB40173744ULL },
+	{ 0xE55990879DDCAABDULL, 0xCC420A6A101D0515ULL },
+	{ 0x8F57FA54C2A9EAB6ULL, 0x9FA946824A12232DULL },
+	{ 0xB32DF8E9F3546564ULL, 0x47939822DC96ABF9ULL },
+	{ 0xDFF9772470297EBDULL, 0x59787E2B93BC56F7ULL },
+	{ 0x8BFBEA76C619EF36ULL, 0x57EB4EDB3C55B65AULL },
+	{ 0xAEFAE51477A06B03ULL, 0xEDE622920B6B23F1ULL },
+	{ 0xDAB99E59958885C4ULL, 0xE95FAB368E45ECEDULL },
+	{ 0x88B402F7FD75539BULL, 0x11DBCB0218EBB414ULL },
+	{ 0xAAE103B5FCD2A881ULL, 0xD652BDC29F26A119ULL },
+	{ 0xD59944A37C0752A2ULL, 0x4BE76D3346F0495FULL },
+	{ 0x857FCAE62D8493A5ULL, 0x6F70A4400C562DDBULL },
+	{ 0xA6DFBD9FB8E5B88EULL, 0xCB4CCD500F6BB952ULL },
+	{ 0xD097AD07A71F26B2ULL, 0x7E2000A41346A7A7ULL },
+	{ 0x825ECC24C873782FULL, 0x8ED400668C0C28C8ULL },
+	{ 0xA2F67F2DFA90563BULL, 0x728900802F0F32FAULL },
+	{ 0xCBB41EF979346BCAULL, 0x4F2B40A03AD2FFB9ULL },
+	{ 0xFEA126B7D78186BCULL, 0xE2F610C84987BFA8ULL },
+	{ 0x9F24B832E6B0F436ULL, 0x0DD9CA7D2DF4D7C9ULL },
+	{ 0xC6EDE63FA05D3143ULL, 0x91503D1C79720DBBULL },
+	{ 0xF8A95FCF88747D94ULL, 0x75A44C6397CE912AULL },
+	{ 0x9B69DBE1B548CE7CULL, 0xC986AFBE3EE11ABAULL },
+	{ 0xC24452DA229B021BULL, 0xFBE85BADCE996168ULL },
+	{ 0xF2D56790AB41C2A2ULL, 0xFAE27299423FB9C3ULL },
+	{ 0x97C560BA6B0919A5ULL, 0xDCCD879FC967D41AULL },
+	{ 0xBDB6B8E905CB600FULL, 0x5400E987BBC1C920ULL },
+	{ 0xED246723473E3813ULL, 0x290123E9AAB23B68ULL },
+	{ 0x9436C0760C86E30BULL, 0xF9A0B6720AAF6521ULL },
+	{ 0xB94470938FA89BCEULL, 0xF808E40E8D5B3E69ULL },
+	{ 0xE7958CB87392C2C2ULL, 0xB60B1D1230B20E04ULL },
+	{ 0x90BD77F3483BB9B9ULL, 0xB1C6F22B5E6F48C2ULL },
+	{ 0xB4ECD5F01A4AA828ULL, 0x1E38AEB6360B1AF3ULL },
+	{ 0xE2280B6C20DD5232ULL, 0x25C6DA63C38DE1B0ULL },
+	{ 0x8D590723948A535FULL, 0x579C487E5A38AD0EULL },
+	{ 0xB0AF48EC79ACE837ULL, 0x2D835A9DF0C6D851ULL },
+	{ 0xDCDB1B2798182244ULL, 0xF8E431456CF88E65ULL },
+	{ 0x8A08F0F8BF0F156BULL, 0x1B8E9ECB641B58FFULL },
+	{ 0xAC8B2D36EED2DAC5ULL, 0xE272467E3D222F3FULL },
+	{ 0xD7ADF884AA879177ULL, 0x5B0ED81DCC6ABB0FULL },
+	{ 0x86CCBB52EA94BAEAULL, 0x98E947129FC2B4E9ULL },
+	{ 0xA87FEA27A539E9A5ULL, 0x3F2398D747B36224ULL },
+	{ 0xD29FE4B18E88640EULL, 0x8EEC7F0D19A03AADULL },
+	{ 0x83A3EEEEF9153E89ULL, 0x1953CF68300424ACULL },
+	{ 0xA48CEAAAB75A8E2BULL, 0x5FA8C3423C052DD7ULL },
+	{ 0xCDB02555653131B6ULL, 0x3792F412CB06794DULL },
+	{ 0x808E17555F3EBF11ULL, 0xE2BBD88BBEE40BD0ULL },
+	{ 0xA0B19D2AB70E6ED6ULL, 0x5B6ACEAEAE9D0EC4ULL },
+	{ 0xC8DE047564D20A8BULL, 0xF245825A5A445275ULL },
+	{ 0xFB158592BE068D2EULL, 0xEED6E2F0F0D56712ULL },
+	{ 0x9CED737BB6C4183DULL, 0x55464DD69685606BULL },
+	{ 0xC428D05AA4751E4CULL, 0xAA97E14C3C26B886ULL },
+	{ 0xF53304714D9265DFULL, 0xD53DD99F4B3066A8ULL },
+	{ 0x993FE2C6D07B7FABULL, 0xE546A8038EFE4029ULL },
+	{ 0xBF8FDB78849A5F96ULL, 0xDE98520472BDD033ULL },
+	{ 0xEF73D256A5C0F77CULL, 0x963E66858F6D4440ULL },
+	{ 0x95A8637627989AADULL, 0xDDE7001379A44AA8ULL },
+	{ 0xBB127C53B17EC159ULL, 0x5560C018580D5D52ULL },
+	{ 0xE9D71B689DDE71AFULL, 0xAAB8F01E6E10B4A6ULL },
+	{ 0x9226712162AB070DULL, 0xCAB3961304CA70E8ULL },
+	{ 0xB6B00D69BB55C8D1ULL, 0x3D607B97C5FD0D22ULL },
+	{ 0xE45C10C42A2B3B05ULL, 0x8CB89A7DB77C506AULL },
+	{ 0x8EB98A7A9A5B04E3ULL, 0x77F3608E92ADB242ULL },
+	{ 0xB267ED1940F1C61CULL, 0x55F038B237591ED3ULL },
+	{ 0xDF01E85F912E37A3ULL, 0x6B6C46DEC52F6688ULL },
+	{ 0x8B61313BBABCE2C6ULL, 0x2323AC4B3B3DA015ULL },
+	{ 0xAE397D8AA96C1B77ULL, 0xABEC975E0A0D081AULL },
+	{ 0xD9C7DCED53C72255ULL, 0x96E7BD358C904A21ULL },
+	{ 0x881CEA14545C7575ULL, 0x7E50D64177DA2E54ULL },
+	{ 0xAA242499697392D2ULL, 0xDDE50BD1D5D0B9E9ULL },
+	{ 0xD4AD2DBFC3D07787ULL, 0x955E4EC64B44E864ULL },
+	{ 0x84EC3C97DA624AB4ULL, 0xBD5AF13BEF0B113EULL },
+	{ 0xA6274BBDD0FADD61ULL, 0xECB1AD8AEACDD58EULL },
+	{ 0xCFB11EAD453994BAULL, 0x67DE18EDA5814AF2ULL },
+	{ 0x81CEB32C4B43FCF4ULL, 0x80EACF948770CED7ULL },
+	{ 0xA2425FF75E14FC31ULL, 0xA1258379A94D028DULL },
+	{ 0xCAD2F7F5359A3B3EULL, 0x096EE45813A04330ULL },
+	{ 0xFD87B5F28300CA0DULL, 0x8BCA9D6E188853FCULL },
+	{ 0x9E74D1B791E07E48ULL, 0x775EA264CF55347DULL },
+	{ 0xC612062576589DDAULL, 0x95364AFE032A819DULL },
+	{ 0xF79687AED3EEC551ULL, 0x3A83DDBD83F52204ULL },
+	{ 0x9ABE14CD44753B52ULL, 0xC4926A9672793542ULL },
+	{ 0xC16D9A0095928A27ULL, 0x75B7053C0F178293ULL },
+	{ 0xF1C90080BAF72CB1ULL, 0x5324C68B12DD6338ULL },
+	{ 0x971DA05074DA7BEEULL, 0xD3F6FC16EBCA5E03ULL },
+	{ 0xBCE5086492111AEAULL, 0x88F4BB1CA6BCF584ULL },
+	{ 0xEC1E4A7DB69561A5ULL, 0x2B31E9E3D06C32E5ULL },
+	{ 0x9392EE8E921D5D07ULL, 0x3AFF322E62439FCFULL },
+	{ 0xB877AA3236A4B449ULL, 0x09BEFEB9FAD487C2ULL },
+	{ 0xE69594BEC44DE15BULL, 0x4C2EBE687989A9B3ULL },
+	{ 0x901D7CF73AB0ACD9ULL, 0x0F9D37014BF60A10ULL },
+	{ 0xB424DC35095CD80FULL, 0x538484C19EF38C94ULL },
+	{ 0xE12E13424BB40E13ULL, 0x2865A5F206B06FB9ULL },
+	{ 0x8CBCCC096F5088CBULL, 0xF93F87B7442E45D3ULL },
+	{ 0xAFEBFF0BCB24AAFEULL, 0xF78F69A51539D748ULL },
+	{ 0xDBE6FECEBDEDD5BEULL, 0xB573440E5A884D1BULL },
+	{ 0x89705F4136B4A597ULL, 0x31680A88F8953030ULL },
+	{ 0xABCC77118461CEFCULL, 0xFDC20D2B36BA7C3DULL },
+	{ 0xD6BF94D5E57A42BCULL, 0x3D32907604691B4CULL },
+	{ 0x8637BD05AF6C69B5ULL, 0xA63F9A49C2C1B10FULL },
+	{ 0xA7C5AC471B478423ULL, 0x0FCF80DC33721D53ULL },
+	{ 0xD1B71758E219652BULL, 0xD3C36113404EA4A8ULL },
+	{ 0x83126E978D4FDF3BULL, 0x645A1CAC083126E9ULL },
+	{ 0xA3D70A3D70A3D70AULL, 0x3D70A3D70A3D70A3ULL },
+	{ 0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCCULL },
+	{ 0x8000000000000000ULL, 0x0000000000000000ULL },
+	{ 0xA000000000000000ULL, 0x0000000000000000ULL },
+	{ 0xC800000000000000ULL, 0x0000000000000000ULL },
+	{ 0xFA00000000000000ULL, 0x0000000000000000ULL },
+	{ 0x9C40000000000000ULL, 0x0000000000000000ULL },
+	{ 0xC350000000000000ULL, 0x0000000000000000ULL },
+	{ 0xF424000000000000ULL, 0x0000000000000000ULL },
+	{ 0x9896800000000000ULL, 0x0000000000000000ULL },
+	{ 0xBEBC200000000000ULL, 0x0000000000000000ULL },
+	{ 0xEE6B280000000000ULL, 0x0000000000000000ULL },
+	{ 0x9502F90000000000ULL, 0x0000000000000000ULL },
+	{ 0xBA43B74000000000ULL, 0x0000000000000000ULL },
+	{ 0xE8D4A51000000000ULL, 0x0000000000000000ULL },
+	{ 0x9184E72A00000000ULL, 0x0000000000000000ULL },
+	{ 0xB5E620F480000000ULL, 0x0000000000000000ULL },
+	{ 0xE35FA931A0000000ULL, 0x0000000000000000ULL },
+	{ 0x8E1BC9BF04000000ULL, 0x0000000000000000ULL },
+	{ 0xB1A2BC2EC5000000ULL, 0x0000000000000000ULL },
+	{ 0xDE0B6B3A76400000ULL, 0x0000000000000000ULL },
+	{ 0x8AC7230489E80000ULL, 0x0000000000000000ULL },
+	{ 0xAD78EBC5AC620000ULL, 0x0000000000000000ULL },
+	{ 0xD8D726B7177A8000ULL, 0x0000000000000000ULL },
+	{ 0x878678326EAC9000ULL, 0x0000000000000000ULL },
+	{ 0xA968163F0A57B400ULL, 0x0000000000000000ULL },
+	{ 0xD3C21BCECCEDA100ULL, 0x0000000000000000ULL },
+	{ 0x84595161401484A0ULL, 0x0000000000000000ULL },
+	{ 0xA56FA5B99019A5C8ULL, 0x0000000000000000ULL },
+	{ 0xCECB8F27F4200F3AULL, 0x0000000000000000ULL },
+	{ 0x813F3978F8940984ULL, 0x4000000000000000ULL },
+	{ 0xA18F07D736B90BE5ULL, 0x5000000000000000ULL },
+	{ 0xC9F2C9CD04674EDEULL, 0xA400000000000000ULL },
+	{ 0xFC6F7C4045812296ULL, 0x4D00000000000000ULL },
+	{ 0x9DC5ADA82B70B59DULL, 0xF020000000000000ULL },
+	{ 0xC5371912364CE305ULL, 0x6C28000000000000ULL },
+	{ 0xF684DF56C3E01BC6ULL, 0xC732000000000000ULL },
+	{ 0x9A130B963A6C115CULL, 0x3C7F400000000000ULL },
+	{ 0xC097CE7BC90715B3ULL, 0x4B9F100000000000ULL },
+	{ 0xF0BDC21ABB48DB20ULL, 0x1E86D40000000000ULL },
+	{ 0x96769950B50D88F4ULL, 0x1314448000000000ULL },
+	{ 0xBC143FA4E250EB31ULL, 0x17D955A000000000ULL },
+	{ 0xEB194F8E1AE525FDULL, 0x5DCFAB0800000000ULL },
+	{ 0x92EFD1B8D0CF37BEULL, 0x5AA1CAE500000000ULL },
+	{ 0xB7ABC627050305ADULL, 0xF14A3D9E40000000ULL },
+	{ 0xE596B7B0C643C719ULL, 0x6D9CCD05D0000000ULL },
+	{ 0x8F7E32CE7BEA5C6FULL, 0xE4820023A2000000ULL },
+	{ 0xB35DBF821AE4F38BULL, 0xDDA2802C8A800000ULL },
+	{ 0xE0352F62A19E306EULL, 0xD50B2037AD200000ULL },
+	{ 0x8C213D9DA502DE45ULL, 0x4526F422CC340000ULL },
+	{ 0xAF298D050E4395D6ULL, 0x9670B12B7F410000ULL },
+	{ 0xDAF3F04651D47B4CULL, 0x3C0CDD765F114000ULL },
+	{ 0x88D8762BF324CD0FULL, 0xA5880A69FB6AC800ULL },
+	{ 0xAB0E93B6EFEE0053ULL, 0x8EEA0D047A457A00ULL },
+	{ 0xD5D238A4ABE98068ULL, 0x72A4904598D6D880ULL },
+	{ 0x85A36366EB71F041ULL, 0x47A6DA2B7F864750ULL },
+	{ 0xA70C3C40A64E6C51ULL, 0x999090B65F67D924ULL },
+	{ 0xD0CF4B50CFE20765ULL, 0xFFF4B4E3F741CF6DULL },
+	{ 0x82818F1281ED449FULL, 0xBFF8F10E7A8921A4ULL },
+	{ 0xA321F2D7226895C7ULL, 0xAFF72D52192B6A0DULL },
+	{ 0xCBEA6F8CEB02BB39ULL, 0x9BF4F8A69F764490ULL },
+	{ 0xFEE50B7025C36A08ULL, 0x02F236D04753D5B4ULL },
+	{ 0x9F4F2726179A2245ULL, 0x01D762422C946590ULL },
+	{ 0xC722F0EF9D80AAD6ULL, 0x424D3AD2B7B97EF5ULL },
+	{ 0xF8EBAD2B84E0D58BULL, 0xD2E0898765A7DEB2ULL },
+	{ 0x9B934C3B330C8577ULL, 0x63CC55F49F88EB2FULL },
+	{ 0xC2781F49FFCFA6D5ULL, 0x3CBF6B71C76B25FBULL },
+	{ 0xF316271C7FC3908AULL, 0x8BEF464E3945EF7AULL },
+	{ 0x97EDD871CFDA3A56ULL, 0x97758BF0E3CBB5ACULL },
+	{ 0xBDE94E8E43D0C8ECULL, 0x3D52EEED1CBEA317ULL },
+	{ 0xED63A231D4C4FB27ULL, 0x4CA7AAA863EE4BDDULL },
+	{ 0x945E455F24FB1CF8ULL, 0x8FE8CAA93E74EF6AULL },
+	{ 0xB975D6B6EE39E436ULL, 0xB3E2FD538E122B44ULL },
+	{ 0xE7D34C64A9C85D44ULL, 0x60DBBCA87196B616ULL },
+	{ 0x90E40FBEEA1D3A4AULL, 0xBC8955E946FE31CDULL },
+	{ 0xB51D13AEA4A488DDULL, 0x6BABAB6398BDBE41ULL },
+	{ 0xE264589A4DCDAB14ULL, 0xC696963C7EED2DD1ULL },
+	{ 0x8D7EB76070A08AECULL, 0xFC1E1DE5CF543CA2ULL },
+	{ 0xB0DE65388CC8ADA8ULL, 0x3B25A55F43294BCBULL },
+	{ 0xDD15FE86AFFAD912ULL, 0x49EF0EB713F39EBEULL },
+	{ 0x8A2DBF142DFCC7ABULL, 0x6E3569326C784337ULL },
+	{ 0xACB92ED9397BF996ULL, 0x49C2C37F07965404ULL },
+	{ 0xD7E77A8F87DAF7FBULL, 0xDC33745EC97BE906ULL },
+	{ 0x86F0AC99B4E8DAFDULL, 0x69A028BB3DED71A3ULL },
+	{ 0xA8ACD7C0222311BCULL, 0xC40832EA0D68CE0CULL },
+	{ 0xD2D80DB02AABD62BULL, 0xF50A3FA490C30190ULL },
+	{ 0x83C7088E1AAB65DBULL, 0x792667C6DA79E0FAULL },
+	{ 0xA4B8CAB1A1563F52ULL, 0x577001B891185938ULL },
+	{ 0xCDE6FD5E09ABCF26ULL, 0xED4C0226B55E6F86ULL },
+	{ 0x80B05E5AC60B6178ULL, 0x544F8158315B05B4ULL },
+	{ 0xA0DC75F1778E39D6ULL, 0x696361AE3DB1C721ULL },
+	{ 0xC913936DD571C84CULL, 0x03BC3A19CD1E38E9ULL },
+	{ 0xFB5878494ACE3A5FULL, 0x04AB48A04065C723ULL },
+	{ 0x9D174B2DCEC0E47BULL, 0x62EB0D64283F9C76ULL },
+	{ 0xC45D1DF942711D9AULL, 0x3BA5D0BD324F8394ULL },
+	{ 0xF5746577930D6500ULL, 0xCA8F44EC7EE36479ULL },
+	{ 0x9968BF6ABBE85F20ULL, 0x7E998B13CF4E1ECBULL },
+	{ 0xBFC2EF456AE276E8ULL, 0x9E3FEDD8C321A67EULL },
+	{ 0xEFB3AB16C59B14A2ULL, 0xC5CFE94EF3EA101EULL },
+	{ 0x95D04AEE3B80ECE5ULL, 0xBBA1F1D158724A12ULL },
+	{ 0xBB445DA9CA61281FULL, 0x2A8A6E45AE8EDC97ULL },
+	{ 0xEA1575143CF97226ULL, 0xF52D09D71A3293BDULL },
+	{ 0x924D692CA61BE758ULL, 0x593C2626705F9C56ULL },
+	{ 0xB6E0C377CFA2E12EULL, 0x6F8B2FB00C77836CULL },
+	{ 0xE498F455C38B997AULL, 0x0B6DFB9C0F956447ULL },
+	{ 0x8EDF98B59A373FECULL, 0x4724BD4189BD5EACULL },
+	{ 0xB2977EE300C50FE7ULL, 0x58EDEC91EC2CB657ULL },
+	{ 0xDF3D5E9BC0F653E1ULL, 0x2F2967B66737E3EDULL },
+	{ 0x8B865B215899F46CULL, 0xBD79E0D20082EE74ULL },
+	{ 0xAE67F1E9AEC07187ULL, 0xECD8590680A3AA11ULL },
+	{ 0xDA01EE641A708DE9ULL, 0xE80E6F4820CC9495ULL },
+	{ 0x884134FE908658B2ULL, 0x3109058D147FDCDDULL },
+	{ 0xAA51823E34A7EEDEULL, 0xBD4B46F0599FD415ULL },
+	{ 0xD4E5E2CDC1D1EA96ULL, 0x6C9E18AC7007C91AULL },
+	{ 0x850FADC09923329EULL, 0x03E2CF6BC604DDB0ULL },
+	{ 0xA6539930BF6BFF45ULL, 0x84DB8346B786151CULL },
+	{ 0xCFE87F7CEF46FF16ULL, 0xE612641865679A63ULL },
+	{ 0x81F14FAE158C5F6EULL, 0x4FCB7E8F3F60C07EULL },
+	{ 0xA26DA3999AEF7749ULL, 0xE3BE5E330F38F09DULL },
+	{ 0xCB090C8001AB551CULL, 0x5CADF5BFD3072CC5ULL },
+	{ 0xFDCB4FA002162A63ULL, 0x73D9732FC7C8F7F6ULL },
+	{ 0x9E9F11C4014DDA7EULL, 0x2867E7FDDCDD9AFAULL },
+	{ 0xC646D63501A1511DULL, 0xB281E1FD541501B8ULL },
+	{ 0xF7D88BC24209A565ULL, 0x1F225A7CA91A4226ULL },
+	{ 0x9AE757596946075FULL, 0x3375788DE9B06958ULL },
+	{ 0xC1A12D2FC3978937ULL, 0x0052D6B1641C83AEULL },
+	{ 0xF209787BB47D6B84ULL, 0xC0678C5DBD23A49AULL },
+	{ 0x9745EB4D50CE6332ULL, 0xF840B7BA963646E0ULL },
+	{ 0xBD176620A501FBFFULL, 0xB650E5A93BC3D898ULL },
+	{ 0xEC5D3FA8CE427AFFULL, 0xA3E51F138AB4CEBEULL },
+	{ 0x93BA47C980E98CDFULL, 0xC66F336C36B10137ULL },
+	{ 0xB8A8D9BBE123F017ULL, 0xB80B0047445D4184ULL },
+	{ 0xE6D3102AD96CEC1DULL, 0xA60DC059157491E5ULL },
+	{ 0x9043EA1AC7E41392ULL, 0x87C89837AD68DB2FULL },
+	{ 0xB454E4A179DD1877ULL, 0x29BABE4598C311FBULL },
+	{ 0xE16A1DC9D8545E94ULL, 0xF4296DD6FEF3D67AULL },
+	{ 0x8CE2529E2734BB1DULL, 0x1899E4A65F58660CULL },
+	{ 0xB01AE745B101E9E4ULL, 0x5EC05DCFF72E7F8FULL },
+	{ 0xDC21A1171D42645DULL, 0x76707543F4FA1F73ULL },
+	{ 0x899504AE72497EBAULL, 0x6A06494A791C53A8ULL },
+	{ 0xABFA45DA0EDBDE69ULL, 0x0487DB9D17636892ULL },
+	{ 0xD6F8D7509292D603ULL, 0x45A9D2845D3C42B6ULL },
+	{ 0x865B86925B9BC5C2ULL, 0x0B8A2392BA45A9B2ULL },
+	{ 0xA7F26836F282B732ULL, 0x8E6CAC7768D7141EULL },
+	{ 0xD1EF0244AF2364FFULL, 0x3207D795430CD926ULL },
+	{ 0x8335616AED761F1FULL, 0x7F44E6BD49E807B8ULL },
+	{ 0xA402B9C5A8D3A6E7ULL, 0x5F16206C9C6209A6ULL },
+	{ 0xCD036837130890A1ULL, 0x36DBA887C37A8C0FULL },
+	{ 0x802221226BE55A64ULL, 0xC2494954DA2C9789ULL },
+	{ 0xA02AA96B06DEB0FDULL, 0xF2DB9BAA10B7BD6CULL },
+	{ 0xC83553C5C8965D3DULL, 0x6F92829494E5ACC7ULL },
+	{ 0xFA42A8B73ABBF48CULL, 0xCB772339BA1F17F9ULL },
+	{ 0x9C69A97284B578D7ULL, 0xFF2A760414536EFBULL },
+	{ 0xC38413CF25E2D70DULL, 0xFEF5138519684ABAULL },
+	{ 0xF46518C2EF5B8CD1ULL, 0x7EB258665FC25D69ULL },
+	{ 0x98BF2F79D5993802ULL, 0xEF2F773FFBD97A61ULL },
+	{ 0xBEEEFB584AFF8603ULL, 0xAAFB550FFACFD8FAULL },
+	{ 0xEEAABA2E5DBF6784ULL, 0x95BA2A53F983CF38ULL },
+	{ 0x952AB45CFA97A0B2ULL, 0xDD945A747BF26183ULL },
+	{ 0xBA756174393D88DFULL, 0x94F971119AEEF9E4ULL },
+	{ 0xE912B9D1478CEB17ULL, 0x7A37CD5601AAB85DULL },
+	{ 0x91ABB422CCB812EEULL, 0xAC62E055C10AB33AULL },
+	{ 0xB616A12B7FE617AAULL, 0x577B986B314D6009ULL },
+	{ 0xE39C49765FDF9D94ULL, 0xED5A7E85FDA0B80BULL },
+	{ 0x8E41ADE9FBEBC27DULL, 0x14588F13BE847307ULL },
+	{ 0xB1D219647AE6B31CULL, 0x596EB2D8AE258FC8ULL },
+	{ 0xDE469FBD99A05FE3ULL, 0x6FCA5F8ED9AEF3BBULL },
+	{ 0x8AEC23D680043BEEULL, 0x25DE7BB9480D5854ULL },
+	{ 0xADA72CCC20054AE9ULL, 0xAF561AA79A10AE6AULL },
+	{ 0xD910F7FF28069DA4ULL, 0x1B2BA1518094DA04ULL },
+	{ 0x87AA9AFF79042286ULL, 0x90FB44D2F05D0842ULL },
+	{ 0xA99541BF57452B28ULL, 0x353A1607AC744A53ULL },
+	{ 0xD3FA922F2D1675F2ULL, 0x42889B8997915CE8ULL },
+	{ 0x847C9B5D7C2E09B7ULL, 0x69956135FEBADA11ULL },
+	{ 0xA59BC234DB398C25ULL, 0x43FAB9837E699095ULL },
+	{ 0xCF02B2C21207EF2EULL, 0x94F967E45E03F4BBULL },
+	{ 0x8161AFB94B44F57DULL, 0x1D1BE0EEBAC278F5ULL },
+	{ 0xA1BA1BA79E1632DCULL, 0x6462D92A69731732ULL },
+	{ 0xCA28A291859BBF93ULL, 0x7D7B8F7503CFDCFEULL },
+	{ 0xFCB2CB35E702AF78ULL, 0x5CDA735244C3D43EULL },
+	{ 0x9DEFBF01B061ADABULL, 0x3A0888136AFA64A7ULL },
+	{ 0xC56BAEC21C7A1916ULL, 0x088AAA1845B8FDD0ULL },
+	{ 0xF6C69A72A3989F5BULL, 0x8AAD549E57273D45ULL },
+	{ 0x9A3C2087A63F6399ULL, 0x36AC54E2F678864BULL },
+	{ 0xC0CB28A98FCF3C7FULL, 0x84576A1BB416A7DDULL },
+	{ 0xF0FDF2D3F3C30B9FULL, 0x656D44A2A11C51D5ULL },
+	{ 0x969EB7C47859E743ULL, 0x9F644AE5A4B1B325ULL },
+	{ 0xBC4665B596706114ULL, 0x873D5D9F0DDE1FEEULL },
+	{ 0xEB57FF22FC0C7959ULL, 0xA90CB506D155A7EAULL },
+	{ 0x9316FF75DD87CBD8ULL, 0x09A7F12442D588F2ULL },
+	{ 0xB7DCBF5354E9BECEULL, 0x0C11ED6D538AEB2FULL },
+	{ 0xE5D3EF282A242E81ULL, 0x8F1668C8A86DA5FAULL },
+	{ 0x8FA475791A569D10ULL, 0xF96E017D694487BCULL },
+	{ 0xB38D92D760EC4455ULL, 0x37C981DCC395A9ACULL },
+	{ 0xE070F78D3927556AULL, 0x85BBE253F47B1417ULL },
+	{ 0x8C469AB843B89562ULL, 0x93956D7478CCEC8EULL },
+	{ 0xAF58416654A6BABBULL, 0x387AC8D1970027B2ULL },
+	{ 0xDB2E51BFE9D0696AULL, 0x06997B05FCC0319EULL },
+	{ 0x88FCF317F22241E2ULL, 0x441FECE3BDF81F03ULL },
+	{ 0xAB3C2FDDEEAAD25AULL, 0xD527E81CAD7626C3ULL },
+	{ 0xD60B3BD56A5586F1ULL, 0x8A71E223D8D3B074ULL },
+	{ 0x85C7056562757456ULL, 0xF6872D5667844E49ULL },
+	{ 0xA738C6BEBB12D16CULL, 0xB428F8AC016561DBULL },
+	{ 0xD106F86E69D785C7ULL, 0xE13336D701BEBA52ULL },
+	{ 0x82A45B450226B39CULL, 0xECC0024661173473ULL },
+	{ 0xA34D721642B06084ULL, 0x27F002D7F95D0190ULL },
+	{ 0xCC20CE9BD35C78A5ULL, 0x31EC038DF7B441F4ULL },
+	{ 0xFF290242C83396CEULL, 0x7E67047175A15271ULL },
+	{ 0x9F79A169BD203E41ULL, 0x0F0062C6E984D386ULL },
+	{ 0xC75809C42C684DD1ULL, 0x52C07B78A3E60868ULL },
+	{ 0xF92E0C3537826145ULL, 0xA7709A56CCDF8A82ULL },
+	{ 0x9BBCC7A142B17CCBULL, 0x88A66076400BB691ULL },
+	{ 0xC2ABF989935DDBFEULL, 0x6ACFF893D00EA435ULL },
+	{ 0xF356F7EBF83552FEULL, 0x0583F6B8C4124D43ULL },
+	{ 0x98165AF37B2153DEULL, 0xC3727A337A8B704AULL },
+	{ 0xBE1BF1B059E9A8D6ULL, 0x744F18C0592E4C5CULL },
+	{ 0xEDA2EE1C7064130CULL, 0x1162DEF06F79DF73ULL },
+	{ 0x9485D4D1C63E8BE7ULL, 0x8ADDCB5645AC2BA8ULL },
+	{ 0xB9A74A0637CE2EE1ULL, 0x6D953E2BD7173692ULL },
+	{ 0xE8111C87C5C1BA99ULL, 0xC8FA8DB6CCDD0437ULL },
+	{ 0x910AB1D4DB9914A0ULL, 0x1D9C9892400A22A2ULL },
+	{ 0xB54D5E4A127F59C8ULL, 0x2503BEB6D00CAB4BULL },
+	{ 0xE2A0B5DC971F303AULL, 0x2E44AE64840FD61DULL },
+	{ 0x8DA471A9DE737E24ULL, 0x5CEAECFED289E5D2ULL },
+	{ 0xB10D8E1456105DADULL, 0x7425A83E872C5F47ULL },
+	{ 0xDD50F1996B947518ULL, 0xD12F124E28F77719ULL },
+	{ 0x8A5296FFE33CC92FULL, 0x82BD6B70D99AAA6FULL },
+	{ 0xACE73CBFDC0BFB7BULL, 0x636CC64D1001550BULL },
+	{ 0xD8210BEFD30EFA5AULL, 0x3C47F7E05401AA4EULL },
+	{ 0x8714A775E3E95C78ULL, 0x65ACFAEC34810A71ULL },
+	{ 0xA8D9D1535CE3B396ULL, 0x7F1839A741A14D0DULL },
+	{ 0xD31045A8341CA07CULL, 0x1EDE48111209A050ULL },
+	{ 0x83EA2B892091E44DULL, 0x934AED0AAB460432ULL },
+	{ 0xA4E4B66B68B65D60ULL, 0xF81DA84D5617853FULL },
+	{ 0xCE1DE40642E3F4B9ULL, 0x36251260AB9D668EULL },
+	{ 0x80D2AE83E9CE78F3ULL, 0xC1D72B7C6B426019ULL },
+	{ 0xA1075A24E4421730ULL, 0xB24CF65B8612F81FULL },
+	{ 0xC94930AE1D529CFCULL, 0xDEE033F26797B627ULL },
+	{ 0xFB9B7CD9A4A7443CULL, 0x169840EF017DA3B1ULL },
+	{ 0x9D412E0806E88AA5ULL, 0x8E1F289560EE864EULL },
+	{ 0xC491798A08A2AD4EULL, 0xF1A6F2BAB92A27E2ULL },
+	{ 0xF5B5D7EC8ACB58A2ULL, 0xAE10AF696774B1DBULL },
+	{ 0x9991A6F3D6BF1765ULL, 0xACCA6DA1E0A8EF29ULL },
+	{ 0xBFF610B0CC6EDD3FULL, 0x17FD090A58D32AF3ULL },
+	{ 0xEFF394DCFF8A948EULL, 0xDDFC4B4CEF07F5B0ULL },
+	{ 0x95F83D0A1FB69CD9ULL, 0x4ABDAF101564F98EULL },
+	{ 0xBB764C4CA7A4440FULL, 0x9D6D1AD41ABE37F1ULL },
+	{ 0xEA53DF5FD18D5513ULL, 0x84C86189216DC5EDULL },
+	{ 0x92746B9BE2F8552CULL, 0x32FD3CF5B4E49BB4ULL },
+	{ 0xB7118682DBB66A77ULL, 0x3FBC8C33221DC2A1ULL },
+	{ 0xE4D5E82392A40515ULL, 0x0FABAF3FEAA5334AULL },
+	{ 0x8F05B1163BA6832DULL, 0x29CB4D87F2A7400EULL },
+	{ 0xB2C71D5BCA9023F8ULL, 0x743E20E9EF511012ULL },
+	{ 0xDF78E4B2BD342CF6ULL, 0x914DA9246B255416ULL },
+	{ 0x8BAB8EEFB6409C1AULL, 0x1AD089B6C2F7548EULL },
+	{ 0xAE9672ABA3D0C320ULL, 0xA184AC2473B529B1ULL },
+	{ 0xDA3C0F568CC4F3E8ULL, 0xC9E5D72D90A2741EULL },
+	{ 0x8865899617FB1871ULL, 0x7E2FA67C7A658892ULL },
+	{ 0xAA7EEBFB9DF9DE8DULL, 0xDDBB901B98FEEAB7ULL },
+	{ 0xD51EA6FA85785631ULL, 0x552A74227F3EA565ULL },
+	{ 0x8533285C936B35DEULL, 0xD53A88958F87275FULL },
+	{ 0xA67FF273B8460356ULL, 0x8A892ABAF368F137ULL },
+	{ 0xD01FEF10A657842CULL, 0x2D2B7569B0432D85ULL },
+	{ 0x8213F56A67F6B29BULL, 0x9C3B29620E29FC73ULL },
+	{ 0xA298F2C501F45F42ULL, 0x8349F3BA91B47B8FULL },
+	{ 0xCB3F2F7642717713ULL, 0x241C70A936219A73ULL },
+	{ 0xFE0EFB53D30DD4D7ULL, 0xED238CD383AA0110ULL },
+	{ 0x9EC95D1463E8A506ULL, 0xF4363804324A40AAULL },
+	{ 0xC67BB4597CE2CE48ULL, 0xB143C6053EDCD0D5ULL },
+	{ 0xF81AA16FDC1B81DAULL, 0xDD94B7868E94050AULL },
+	{ 0x9B10A4E5E9913128ULL, 0xCA7CF2B4191C8326ULL },
+	{ 0xC1D4CE1F63F57D72ULL, 0xFD1C2F611F63A3F0ULL },
+	{ 0xF24A01A73CF2DCCFULL, 0xBC633B39673C8CECULL },
+	{ 0x976E41088617CA01ULL, 0xD5BE0503E085D813ULL },
+	{ 0xBD49D14AA79DBC82ULL, 0x4B2D8644D8A74E18ULL },
+	{ 0xEC9C459D51852BA2ULL, 0xDDF8E7D60ED1219EULL },
+	{ 0x93E1AB8252F33B45ULL, 0xCABB90E5C942B503ULL },
+	{ 0xB8DA1662E7B00A17ULL, 0x3D6A751F3B936243ULL },
+	{ 0xE7109BFBA19C0C9DULL, 0x0CC512670A783AD4ULL },
+	{ 0x906A617D450187E2ULL, 0x27FB2B80668B24C5ULL },
+	{ 0xB484F9DC9641E9DAULL, 0xB1F9F660802DEDF6ULL },
+	{ 0xE1A63853BBD26451ULL, 0x5E7873F8A0396973ULL },
+	{ 0x8D07E33455637EB2ULL, 0xDB0B487B6423E1E8ULL },
+	{ 0xB049DC016ABC5E5FULL, 0x91CE1A9A3D2CDA62ULL },
+	{ 0xDC5C5301C56B75F7ULL, 0x7641A140CC7810FBULL },
+	{ 0x89B9B3E11B6329BAULL, 0xA9E904C87FCB0A9DULL },
+	{ 0xAC2820D9623BF429ULL, 0x546345FA9FBDCD44ULL },
+	{ 0xD732290FBACAF133ULL, 0xA97C177947AD4095ULL },
+	{ 0x867F59A9D4BED6C0ULL, 0x49ED8EABCCCC485DULL },
+	{ 0xA81F301449EE8C70ULL, 0x5C68F256BFFF5A74ULL },
+	{ 0xD226FC195C6A2F8CULL, 0x73832EEC6FFF3111ULL },
+	{ 0x83585D8FD9C25DB7ULL, 0xC831FD53C5FF7EABULL },
+	{ 0xA42E74F3D032F525ULL, 0xBA3E7CA8B77F5E55ULL },
+	{ 0xCD3A1230C43FB26FULL, 0x28CE1BD2E55F35EBULL },
+	{ 0x80444B5E7AA7CF85ULL, 0x7980D163CF5B81B3ULL },
+	{ 0xA0555E361951C366ULL, 0xD7E105BCC332621FULL },
+	{ 0xC86AB5C39FA63440ULL, 0x8DD9472BF3FEFAA7ULL },
+	{ 0xFA856334878FC150ULL, 0xB14F98F6F0FEB951ULL },
+	{ 0x9C935E00D4B9D8D2ULL, 0x6ED1BF9A569F33D3ULL },
+	{ 0xC3B8358109E84F07ULL, 0x0A862F80EC4700C8ULL },
+	{ 0xF4A642E14C6262C8ULL, 0xCD27BB612758C0FAULL },
+	{ 0x98E7E9CCCFBD7DBDULL, 0x8038D51CB897789CULL },
+	{ 0xBF21E44003ACDD2CULL, 0xE0470A63E6BD56C3ULL },
+	{ 0xEEEA5D5004981478ULL, 0x1858CCFCE06CAC74ULL },
+	{ 0x95527A5202DF0CCBULL, 0x0F37801E0C43EBC8ULL },
+	{ 0xBAA718E68396CFFDULL, 0xD30560258F54E6BAULL },
+	{ 0xE950DF20247C83FDULL, 0x47C6B82EF32A2069ULL },
+	{ 0x91D28B7416CDD27EULL, 0x4CDC331D57FA5441ULL },
+	{ 0xB6472E511C81471DULL, 0xE0133FE4ADF8E952ULL },
+	{ 0xE3D8F9E563A198E5ULL, 0x58180FDDD97723A6ULL },
+	{ 0x8E679C2F5E44FF8FULL, 0x570F09EAA7EA7648ULL },
+	{ 0xB201833B35D63F73ULL, 0x2CD2CC6551E513DAULL },
+	{ 0xDE81E40A034BCF4FULL, 0xF8077F7EA65E58D1ULL },
+	{ 0x8B112E86420F6191ULL, 0xFB04AFAF27FAF782ULL },
+	{ 0xADD57A27D29339F6ULL, 0x79C5DB9AF1F9B563ULL },
+	{ 0xD94AD8B1C7380874ULL, 0x18375281AE7822BCULL },
+	{ 0x87CEC76F1C830548ULL, 0x8F2293910D0B15B5ULL },
+	{ 0xA9C2794AE3A3C69AULL, 0xB2EB3875504DDB22ULL },
+	{ 0xD433179D9C8CB841ULL, 0x5FA60692A46151EBULL },
+	{ 0x849FEEC281D7F328ULL, 0xDBC7C41BA6BCD333ULL },
+	{ 0xA5C7EA73224DEFF3ULL, 0x12B9B522906C0800ULL },
+	{ 0xCF39E50FEAE16BEFULL, 0xD768226B34870A00ULL },
+	{ 0x81842F29F2CCE375ULL, 0xE6A1158300D46640ULL },
+	{ 0xA1E53AF46F801C53ULL, 0x60495AE3C1097FD0ULL },
+	{ 0xCA5E89B18B602368ULL, 0x385BB19CB14BDFC4ULL },
+	{ 0xFCF62C1DEE382C42ULL, 0x46729E03DD9ED7B5ULL },
+	{ 0x9E19DB92B4E31BA9ULL, 0x6C07A2C26A8346D1ULL },
+};
+
+// 64x64 -> 128 곱하기, 아래를 반환하고 위는 hi로
+FINLINE ullong _num_mul128(const ullong a, const ullong b, ullong* hi)
+{
+#if defined __SIZEOF_INT128__
+	const __uint128_t r = (__uint128_t)a * b;
+	*hi = (ullong)(r >> 64);
+	return (ullong)r;
+#elif defined _MSC_VER && (defined _M_X64 || defined _M_AMD64)
+	return _umul128(a, b, hi);
+#elif defined _MSC_VER && (defined _M_ARM64 || defined _M_ARM64EC)
+	*hi = __umulh(a, b);
+	return a * b;
+#else
+	const ullong ha = a >> 32, hb = b >> 32, la = (uint)a, lb = (uint)b;
+	const ullong rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	const ullong t = rl + (rm0 << 32);
+	ullong c = t < rl;
+	const ullong lo = t + (rm1 << 32);
+	c += lo < t;
+	*hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+	return lo;
+#endif
 }
 
-// DOPR 고정 문자열 버전
-static void printf_outch(PatrickPowellSprintfState* state, int ch)
+// floor(log10(2^e))
+FINLINE int _num_log10_pow2(const int e)
 {
-	if (state->currlen < state->maxlen)
-		state->buf[state->currlen] = (char)ch;
-	state->currlen++;
+	return (e * 1262611) >> 22;
 }
 
-// DOPR 할당 문자열 버전
-static void printf_alloc_outch(PatrickPowellSprintfState* state, int ch)
+// floor(log2(10^e))
+FINLINE int _num_log2_pow10(const int e)
 {
-	if (state->currlen >= state->maxlen)
-	{
-		state->maxlen = state->currlen + 256;
-#ifdef QS_NO_MEMORY_PROFILE
-		state->buf = (char*)qn_a_realloc(state->buf, state->maxlen);
-#else
-		state->buf = (char*)qn_a_i_realloc(state->buf, state->maxlen, state->desc, state->line);
-#endif
-	}
-	state->buf[state->currlen] = (char)ch;
-	state->currlen++;
+	return (e * 1741647) >> 19;
 }
 
-#ifdef QS_NO_MEMORY_PROFILE
-//
-static int qn_a_printf(char** out, const char* fmt, va_list va)
+// 부호 없는 정수를 end 앞쪽으로 채운다. 10진수는 두 자리씩, 2의 거듭제곱 진수는 비트로. 첫 글자 위치를 반환
+char* qn_num_utoa(char* end, ullong value, const uint base, const bool upper)
 {
-	PatrickPowellSprintfState state =
+	if (base == 10)
 	{
-		printf_alloc_outch,
-		printf_finish,
-	};
-	dopr(&state, fmt, va);
-	*out = state.buf;
-	return (int)state.currlen;
+		while (value > 0xFFFFFFFFULL)
+		{
+			const uint r = (uint)(value % 100);
+			value /= 100;
+			end -= 2;
+			memcpy(end, num_digit2_table + r * 2, 2);
+		}
+		uint v = (uint)value;
+		while (v >= 100)
+		{
+			const uint r = v % 100;
+			v /= 100;
+			end -= 2;
+			memcpy(end, num_digit2_table + r * 2, 2);
+		}
+		if (v >= 10)
+		{
+			end -= 2;
+			memcpy(end, num_digit2_table + v * 2, 2);
+		}
+		else
+			*--end = (char)('0' + v);
+		return end;
+	}
+	const char* table = qn_char_base_table(upper);
+	if ((base & (base - 1)) == 0)
+	{
+		const uint shift = qn_ctz32(base);
+		do
+		{
+			*--end = table[value & (base - 1)];
+			value >>= shift;
+		} while (value);
+		return end;
+	}
+	do
+	{
+		*--end = table[value % base];
+		value /= base;
+	} while (value);
+	return end;
 }
 
-//
-int qn_a_vsprintf(char** out, const char* fmt, va_list va)
+// Schubfach 곱하기, 버린 쪽에 뭐가 있으면 홀수로 만든다
+FINLINE ullong _num_round_odd64(const ullong g_hi, const ullong g_lo, const ullong cp)
 {
-	if (out == NULL)
-		return qn_vsnprintf(NULL, 0, fmt, va);
-	qn_return_when_fail(fmt != NULL, -1);
-	return qn_a_printf(out, fmt, va);
+	ullong x1, y1;
+	_num_mul128(g_lo, cp, &x1);
+	const ullong y0 = _num_mul128(g_hi, cp, &y1);
+	const ullong z = y0 + x1;
+	y1 += z < y0;
+	return y1 | (z > 1);
 }
 
-//
-char* qn_a_vpsprintf(const char* fmt, va_list va)
+// Schubfach 곱하기, 32비트 용
+FINLINE uint _num_round_odd32(const ullong g, const uint cp)
 {
-	qn_return_when_fail(fmt != NULL, NULL);
-	char* buf;
-	qn_a_printf(&buf, fmt, va);
-	return buf;
+	ullong hi;
+	const ullong lo = _num_mul128(g, cp, &hi);
+	return (uint)hi | ((uint)(lo >> 32) > 1);
 }
 
-//
-int qn_a_sprintf(char** out, const char* fmt, ...)
+// double의 가장 짧은 10진수, 값 = 반환값 * 10^exp (bits는 부호 없는 유한값, 0 아님)
+static ullong _num_shortest64(const ullong bits, int* exp)
 {
-	va_list va;
-	va_start(va, fmt);
-	const int ret = qn_a_vsprintf(out, fmt, va);
-	va_end(va);
-	return ret;
+	const ullong fraction = bits & ((1ULL << 52) - 1);
+	const uint biased = (uint)(bits >> 52);
+	ullong c;
+	int q;
+	if (biased != 0)
+	{
+		c = (1ULL << 52) | fraction;
+		q = (int)biased - 1075;
+		if (q <= 0 && q > -53 && (c & ((1ULL << -q) - 1)) == 0)
+		{
+			// 작은 정수
+			*exp = 0;
+			return c >> -q;
+		}
+	}
+	else
+	{
+		c = fraction;
+		q = -1074;
+	}
+
+	const bool even = (c & 1) == 0;
+	const bool closer = fraction == 0 && biased > 1;	// 아래 경계가 더 가깝다
+	const ullong cbl = 4 * c - 2 + closer;
+	const ullong cb = 4 * c;
+	const ullong cbr = 4 * c + 2;
+	const int k = closer ? (q * 1262611 - 524031) >> 22 : _num_log10_pow2(q);
+	const int h = q + _num_log2_pow10(-k) + 1;
+	const ullong* pow5 = num_pow5_table[-k - NUM_POW5_MIN];
+	const ullong g_lo = pow5[1] + 1;
+	const ullong g_hi = pow5[0] + (g_lo == 0);
+	const ullong vbl = _num_round_odd64(g_hi, g_lo, cbl << h);
+	const ullong vb = _num_round_odd64(g_hi, g_lo, cb << h);
+	const ullong vbr = _num_round_odd64(g_hi, g_lo, cbr << h);
+	const ullong lower = vbl + !even;
+	const ullong upper = vbr - !even;
+
+	const ullong s = vb / 4;
+	if (s >= 10)
+	{
+		const ullong sp = s / 10;
+		const bool up_inside = lower <= 40 * sp;
+		const bool wp_inside = 40 * sp + 40 <= upper;
+		if (up_inside != wp_inside)
+		{
+			*exp = k + 1;
+			return sp + wp_inside;
+		}
+	}
+	*exp = k;
+	const bool u_inside = lower <= 4 * s;
+	const bool w_inside = 4 * s + 4 <= upper;
+	if (u_inside != w_inside)
+		return s + w_inside;
+	const ullong mid = 4 * s + 2;
+	return s + (vb > mid || (vb == mid && (s & 1) != 0));
 }
 
-//
-char* qn_a_psprintf(const char* fmt, ...)
+// float의 가장 짧은 10진수, 값 = 반환값 * 10^exp (bits는 부호 없는 유한값, 0 아님)
+static uint _num_shortest32(const uint bits, int* exp)
 {
-	va_list va;
-	va_start(va, fmt);
-	char* buf;
-	qn_a_printf(&buf, fmt, va);
-	va_end(va);
-	return buf;
+	const uint fraction = bits & ((1U << 23) - 1);
+	const uint biased = bits >> 23;
+	uint c;
+	int q;
+	if (biased != 0)
+	{
+		c = (1U << 23) | fraction;
+		q = (int)biased - 150;
+		if (q <= 0 && q > -24 && (c & ((1U << -q) - 1)) == 0)
+		{
+			*exp = 0;
+			return c >> -q;
+		}
+	}
+	else
+	{
+		c = fraction;
+		q = -149;
+	}
+
+	const bool even = (c & 1) == 0;
+	const bool closer = fraction == 0 && biased > 1;
+	const uint cbl = 4 * c - 2 + closer;
+	const uint cb = 4 * c;
+	const uint cbr = 4 * c + 2;
+	const int k = closer ? (q * 1262611 - 524031) >> 22 : _num_log10_pow2(q);
+	const int h = q + _num_log2_pow10(-k) + 1;
+	const ullong g = num_pow5_table[-k - NUM_POW5_MIN][0] + 1;
+	const uint vbl = _num_round_odd32(g, cbl << h);
+	const uint vb = _num_round_odd32(g, cb << h);
+	const uint vbr = _num_round_odd32(g, cbr << h);
+	const uint lower = vbl + !even;
+	const uint upper = vbr - !even;
+
+	const uint s = vb / 4;
+	if (s >= 10)
+	{
+		const uint sp = s / 10;
+		const bool up_inside = lower <= 40 * sp;
+		const bool wp_inside = 40 * sp + 40 <= upper;
+		if (up_inside != wp_inside)
+		{
+			*exp = k + 1;
+			return sp + wp_inside;
+		}
+	}
+	*exp = k;
+	const bool u_inside = lower <= 4 * s;
+	const bool w_inside = 4 * s + 4 <= upper;
+	if (u_inside != w_inside)
+		return s + w_inside;
+	const uint mid = 4 * s + 2;
+	return s + (vb > mid || (vb == mid && (s & 1) != 0));
 }
 
-//
-char* qn_a_str_dup(const char* p)
+// 정수를 숫자 열로, 끝의 0은 빼고 소수점 위치(point)를 더한다
+static int _num_put_digits(char* digits, const ullong value, const int exp, int* point)
 {
-	qn_return_when_fail(p != NULL, NULL);
-	const size_t len = strlen(p) + 1;
-	char* d = (char*)qn_a_alloc(len, false);
-	qn_strcpy(d, p);
-	return d;
+	char conv[24];
+	char* end = conv + QN_COUNTOF(conv);
+	const char* s = qn_num_utoa(end, value, 10, false);
+	int n = (int)(end - s);
+	*point = n + exp;
+	while (n > 1 && s[n - 1] == '0')
+		n--;
+	memcpy(digits, s, (size_t)n);
+	return n;
 }
 
-//
-char* qn_a_str_dup_cat(const char* p, ...)
+// double을 큰 정수로 계산해서 정확한 숫자 열을 모두 만든다 (느린 길)
+static int _num_exact64(const ullong bits, char* digits, int* point)
 {
-	va_list va, vq;
-	va_start(va, p);
+	const uint biased = (uint)(bits >> 52);
+	const ullong mantissa = biased != 0 ? (1ULL << 52) | (bits & ((1ULL << 52) - 1)) : bits;
+	const int e = biased != 0 ? (int)biased - 1075 : -1074;
+
+	// 2^e는 그대로 밀고, 2^-e는 5^-e를 곱해서 10^-e로 나눈 것으로 본다
+	uint big[82] = { (uint)mantissa, (uint)(mantissa >> 32) };
+	int len = big[1] != 0 ? 2 : 1;
+	if (e > 0)
+	{
+		const int words = e / 32, shift = e % 32;
+		for (int i = len - 1; i >= 0; i--)
+		{
+			const ullong v = (ullong)big[i] << shift;
+			big[i + words + 1] |= (uint)(v >> 32);
+			big[i + words] = (uint)v;
+		}
+		for (int i = 0; i < words; i++)
+			big[i] = 0;
+		len += words + 1;
+	}
+	else if (e < 0)
+	{
+		for (int n = -e; n > 0; n -= 13)
+		{
+			static const uint pow5[] = { 1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625, 48828125, 244140625, 1220703125 };
+			const ullong mul = pow5[n < 13 ? n : 13];
+			ullong carry = 0;
+			for (int i = 0; i < len; i++)
+			{
+				const ullong v = big[i] * mul + carry;
+				big[i] = (uint)v;
+				carry = v >> 32;
+			}
+			if (carry)
+				big[len++] = (uint)carry;
+		}
+	}
+	while (len > 0 && big[len - 1] == 0)
+		len--;
+
+	// 10^9씩 나눠서 뒤에서부터 채운다
+	char conv[QN_NUM_DIGITS_SIZE];
+	char* end = conv + QN_COUNTOF(conv);
+	char* s = end;
+	while (len > 0)
+	{
+		ullong r = 0;
+		for (int i = len - 1; i >= 0; i--)
+		{
+			const ullong v = (r << 32) | big[i];
+			big[i] = (uint)(v / 1000000000);
+			r = v % 1000000000;
+		}
+		while (len > 0 && big[len - 1] == 0)
+			len--;
+		if (len > 0)
+		{
+			for (int i = 0; i < 9; i++, r /= 10)
+				*--s = (char)('0' + r % 10);
+		}
+		else
+			s = qn_num_utoa(s, r, 10, false);
+	}
+
+	int n = (int)(end - s);
+	*point = n + (e < 0 ? e : 0);
+	while (n > 1 && s[n - 1] == '0')
+		n--;
+	memcpy(digits, s, (size_t)n);
+	return n;
+}
+
+// 숫자 열을 keep 자리에서 반올림 (짝수로), 0이 되면 "0"
+static int _num_round_digits(char* digits, int n, const int keep, int* point)
+{
+	if (keep >= n)
+		return n;
+	bool up = false;
+	if (keep >= 0)
+	{
+		const char d = digits[keep];
+		if (d != '5')
+			up = d > '5';
+		else
+			up = n > keep + 1 || (keep > 0 && ((digits[keep - 1] - '0') & 1) != 0);
+	}
+	n = keep;
+	if (up)
+	{
+		int i = keep - 1;
+		while (i >= 0 && digits[i] == '9')
+			i--;
+		if (i < 0)
+		{
+			digits[0] = '1';
+			(*point)++;
+			return 1;
+		}
+		digits[i]++;
+		n = i + 1;
+	}
+	while (n > 0 && digits[n - 1] == '0')
+		n--;
+	if (n <= 0)
+	{
+		digits[0] = '0';
+		*point = 1;
+		return 1;
+	}
+	return n;
+}
+
+// 실수를 10진수 숫자 열로 (부호는 보지 않는다). 값 = 0.digits * 10^point
+// count가 음수면 가장 짧은 왕복 값, fixed면 소수점 아래 count 자리, 아니면 유효 숫자 count 자리로 반올림
+// digits는 QN_NUM_DIGITS_SIZE 바이트, 끝의 0은 빼고 숫자 수를 반환. 0은 "0"에 point 1
+int qn_num_digits(const double value, const int count, const bool fixed, char* digits, int* point)
+{
+	ullong bits;
+	memcpy(&bits, &value, sizeof(ullong));
+	bits &= ~(1ULL << 63);
+	if (bits == 0)
+	{
+		digits[0] = '0';
+		*point = 1;
+		return 1;
+	}
+
+	int exp;
+	const ullong shortest = _num_shortest64(bits, &exp);
+	int n = _num_put_digits(digits, shortest, exp, point);
+	if (count < 0)
+		return n;
+
+	// 가장 짧은 값에서 바로 자를 수 있는지 본다
+	// 더 짧거나 같은 자리에서 자르면 원래 값과의 사이에 반올림 경계가 들어올 수 없다. 딱 중간(5)만 따로 본다
+	// 자릿수가 모자라서 채워야 하면 15자리까지만 0으로 채워도 된다
+	const int keep = fixed ? *point + count : count;
+	if (keep < n)
+	{
+		if (keep != n - 1 || digits[keep] != '5')
+			return _num_round_digits(digits, n, keep, point);
+	}
+	else if (keep <= 15 && bits >= (1ULL << 52))
+		return n;
+
+	n = _num_exact64(bits, digits, point);
+	return _num_round_digits(digits, n, fixed ? *point + count : count, point);
+}
+
+// 숫자 열을 보통 글자로, 21자리 정수까지와 소수점 아래 6자리 안쪽은 그냥, 나머지는 지수로
+static int _num_layout(char* p, const char* digits, const int n, const int point)
+{
+	char* s = p;
+	if (point > 0 && point <= 21)
+	{
+		if (n <= point)
+		{
+			memcpy(s, digits, (size_t)n);
+			s += n;
+			for (int i = n; i < point; i++)
+				*s++ = '0';
+		}
+		else
+		{
+			memcpy(s, digits, (size_t)point);
+			s += point;
+			*s++ = '.';
+			memcpy(s, digits + point, (size_t)(n - point));
+			s += n - point;
+		}
+	}
+	else if (point <= 0 && point > -6)
+	{
+		*s++ = '0';
+		*s++ = '.';
+		for (int i = point; i < 0; i++)
+			*s++ = '0';
+		memcpy(s, digits, (size_t)n);
+		s += n;
+	}
+	else
+	{
+		*s++ = digits[0];
+		if (n > 1)
+		{
+			*s++ = '.';
+			memcpy(s, digits + 1, (size_t)(n - 1));
+			s += n - 1;
+		}
+		*s++ = 'e';
+		int e = point - 1;
+		if (e < 0)
+		{
+			*s++ = '-';
+			e = -e;
+		}
+		else
+			*s++ = '+';
+		char conv[8];
+		char* end = conv + QN_COUNTOF(conv);
+		const char* c = qn_num_utoa(end, (ullong)e, 10, false);
+		memcpy(s, c, (size_t)(end - c));
+		s += end - c;
+	}
+	*s = '\0';
+	return (int)(s - p);
+}
+
+// 무한대와 NaN
+static int _num_special(char* p, const bool negative, const bool nan)
+{
+	char* s = p;
+	if (negative && nan == false)
+		*s++ = '-';
+	memcpy(s, nan ? "nan" : "inf", 4);
+	return (int)(s - p) + 3;
+}
+
+// Eisel-Lemire, w * 10^q를 바로 반올림한 비트. 판단이 안서면 false
+// mbits는 가수 비트 수(52, 23), bias는 지수 바이어스(1023, 127)
+static bool _num_lemire(ullong w, const int q, const int mbits, const int bias, ullong* bits)
+{
+	const int inf_power = bias * 2 + 1;
+	if (w == 0 || q < (mbits == 52 ? -342 : -65))
+	{
+		*bits = 0;
+		return true;
+	}
+	if (q > (mbits == 52 ? 308 : 38))
+	{
+		*bits = (ullong)inf_power << mbits;
+		return true;
+	}
+
+	const int lz = (int)qn_clz64(w);
+	w <<= lz;
+	// 음수 지수 -27 ~ -1은 올림 값을 쓴다
+	const ullong* pow5 = num_pow5_table[q - NUM_POW5_MIN];
+	const ullong p_lo = pow5[1] + (q >= -27 && q < 0);
+	const ullong p_hi = pow5[0] + (p_lo < pow5[1]);
+	ullong hi;
+	ullong lo = _num_mul128(w, p_hi, &hi);
+	const ullong precision_mask = 0xFFFFFFFFFFFFFFFFULL >> (mbits + 3);
+	if ((hi & precision_mask) == precision_mask)
+	{
+		ullong hi2;
+		_num_mul128(w, p_lo, &hi2);
+		lo += hi2;
+		hi += lo < hi2;
+		if (lo == 0xFFFFFFFFFFFFFFFFULL && (q < -27 || q > 55))
+			return false;
+	}
+
+	const int upper_bit = (int)(hi >> 63);
+	const int shift = upper_bit + 64 - mbits - 3;
+	ullong mantissa = hi >> shift;
+	int power2 = ((q * (152170 + 65536)) >> 16) + 63 + upper_bit - lz + bias;
+	if (power2 <= 0)
+	{
+		// 비정규 수
+		if (-power2 + 1 >= 64)
+		{
+			*bits = 0;
+			return true;
+		}
+		mantissa >>= -power2 + 1;
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		power2 = mantissa < (1ULL << mbits) ? 0 : 1;
+		*bits = ((ullong)power2 << mbits) | (mantissa & ((1ULL << mbits) - 1));
+		return true;
+	}
+	// 딱 중간이면 짝수로
+	if (lo <= 1 && q >= (mbits == 52 ? -4 : -17) && q <= (mbits == 52 ? 23 : 10) && (mantissa & 3) == 1 &&
+		(mantissa << shift) == hi)
+		mantissa &= ~1ULL;
+	mantissa += mantissa & 1;
+	mantissa >>= 1;
+	if (mantissa >= (2ULL << mbits))
+	{
+		mantissa = 1ULL << mbits;
+		power2++;
+	}
+	mantissa &= ~(1ULL << mbits);
+	if (power2 >= inf_power)
+	{
+		power2 = inf_power;
+		mantissa = 0;
+	}
+	*bits = ((ullong)power2 << mbits) | mantissa;
+	return true;
+}
+
+// 10진수 실수 글자를 나눠 읽은 것
+typedef struct NUMTEXT
+{
+	ullong			w;				// 앞쪽 19자리
+	int				q;				// 10의 지수
+	bool			negative;
+	bool			many;			// 19자리 뒤에 0이 아닌 숫자가 더 있다
+	const char*		first;			// 숫자 시작
+	const char*		last;			// 숫자 끝 (지수 앞)
+	int				exp;			// 적힌 지수
+} NumText;
+
+// 실수 글자 나눠 읽기, 숫자가 없으면 false
+static bool _num_scan(const char* p, NumText* t)
+{
+	while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t') ++p;
+	t->negative = *p == '-';
+	if (*p == '+' || *p == '-')
+		p++;
+	t->first = p;
+
+	ullong w = 0;
+	int count = 0, drop = 0, frac = 0;
+	bool any = false, many = false;
+	while (*p == '0')
+	{
+		p++;
+		any = true;
+	}
+	for (uint d; (d = (uint)(*p - '0')) < 10; p++)
+	{
+		any = true;
+		if (count < 19)
+		{
+			w = w * 10 + d;
+			count++;
+		}
+		else
+		{
+			drop++;
+			many |= d != 0;
+		}
+	}
+	if (*p == '.')
+	{
+		p++;
+		if (count == 0)
+		{
+			while (*p == '0')
+			{
+				p++;
+				frac++;
+				any = true;
+			}
+		}
+		for (uint d; (d = (uint)(*p - '0')) < 10; p++)
+		{
+			any = true;
+			if (count < 19)
+			{
+				w = w * 10 + d;
+				count++;
+				frac++;
+			}
+			else
+				many |= d != 0;
+		}
+	}
+	if (any == false)
+		return false;
+	t->last = p;
+
+	int exp = 0;
+	if (*p == 'e' || *p == 'E')
+	{
+		const char* s = p + 1;
+		const bool negative = *s == '-';
+		if (*s == '+' || *s == '-')
+			s++;
+		for (uint d; (d = (uint)(*s - '0')) < 10; s++)
+		{
+			if (exp < 100000)
+				exp = exp * 10 + (int)d;
+		}
+		if (s > p + 1 && (uint)(s[-1] - '0') < 10)
+			exp = negative ? -exp : exp;
+		else
+			exp = 0;
+	}
+	t->w = w;
+	t->q = exp + drop - frac;
+	t->many = many;
+	t->exp = exp;
+	return true;
+}
+
+// 숫자가 없을 때 무한대와 NaN
+static bool _num_scan_special(const NumText* t, double* value)
+{
+	if (qn_strnicmp(t->first, "inf", 3) == 0)
+		*value = t->negative ? -HUGE_VAL : HUGE_VAL;
+	else if (qn_strnicmp(t->first, "nan", 3) == 0)
+		*value = t->negative ? -NAN : NAN;
+	else
+		return false;
+	return true;
+}
+
+// 느린 길, 숫자만 모아서 지수를 붙인 다음 CRT에게 (소수점이 없으니 로캘을 타지 않는다)
+static double _num_scan_slow(const NumText* t, const bool single)
+{
+	char buf[800];
+	int len = 0, exp = t->exp;
+	bool seen_dot = false, nonzero = false;
+	for (const char* s = t->first; s < t->last; s++)
+	{
+		if (*s == '.')
+		{
+			seen_dot = true;
+			continue;
+		}
+		if (seen_dot)
+			exp--;
+		if (len == 0 && *s == '0')
+			continue;
+		if (len < 760)
+			buf[len++] = *s;
+		else
+		{
+			// 뒤쪽은 0인지 아닌지만 남긴다
+			exp++;
+			nonzero |= *s != '0';
+		}
+	}
+	if (nonzero)
+	{
+		buf[len++] = '1';
+		exp--;
+	}
+	if (len == 0)
+		buf[len++] = '0';
+	buf[len++] = 'e';
+	len += qn_itoa(buf + len, exp, 10, false);
+	buf[len] = '\0';
+	return single ? (double)strtof(buf, NULL) : strtod(buf, NULL);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// 문자열 SIMD
+// x86은 SSE2가 기본이고 SSSE3/AVX2는 런타임에 고른다 (CRC와 같은 방식). ARM은 NEON, 나머지는 8바이트 SWAR
+
+#if defined _QN_SSE2_ && (defined _M_AMD64 || defined _M_X64 || defined __x86_64__ || defined _M_IX86 || defined __i386__)
+#define STR_X86				1
+#if defined _MSC_VER
+#include <intrin.h>
+#define STR_SSSE3
+#define STR_AVX2
+#else
+#include <immintrin.h>
+#define STR_SSSE3			__attribute__((target("ssse3")))
+#define STR_AVX2			__attribute__((target("avx2")))
+#endif
+#endif
+#if defined _QN_SSE2_ || defined _QN_NEON_
+#define STR_SIMD			1
+#endif
+
+// 문자열 구현
+static struct STRIMPL
+{
+	volatile bool	inited;
+	bool			ssse3;
+	bool			avx2;
+
+#if defined STR_X86 || defined _QN_NEON_
+	// UTF-8 글자 넷 풀기. 글자 끝 바이트 마스크 12비트 -> 모양과 먹는 바이트 (0이면 못함), 모양마다 셔플
+	ushort			u8_shape[4096];
+	byte			u8_shuf[81][16];
+	// UTF-16 넷을 UTF-8로. 레인마다 1바이트, 2바이트 이하 마스크 -> 모으는 셔플과 쓰는 바이트
+	byte			u16_shuf[256][16];
+	byte			u16_used[256];
+#endif
+} str_impl;
+
+#if defined STR_X86 || defined _QN_NEON_
+static void _utf_make_tables(void);
+#endif
+
+// 문자열 올림, 런타임에서 부르지만 먼저 쓰면 그때 만든다
+void qn_str_up(void)
+{
+	if (str_impl.inited)
+		return;
+
+#if defined STR_X86
+#if defined _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	str_impl.ssse3 = (info[2] & (1 << 9)) != 0;
+	const bool avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+	__cpuidex(info, 7, 0);
+	str_impl.avx2 = avx && (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	str_impl.ssse3 = __builtin_cpu_supports("ssse3") != 0;
+	str_impl.avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+	if (str_impl.ssse3)
+		_utf_make_tables();
+#elif defined _QN_NEON_
+	_utf_make_tables();
+#endif
+
+	qn_atomic_fence();
+	str_impl.inited = true;
+}
+
+#if defined _MSC_VER
+#define STR_NOASAN			__declspec(no_sanitize_address)
+#elif defined __GNUC__
+#define STR_NOASAN			__attribute__((no_sanitize_address))
+#else
+#define STR_NOASAN
+#endif
+
+// 페이지를 넘지 않으면 n바이트를 더 읽어도 된다
+#define STR_PAGE_SAFE(p,n)	(((uintptr_t)(p) & 4095) <= 4096 - (n))
+
+#define STR_ONES			0x0101010101010101ULL
+#define STR_LOWS			0x7F7F7F7F7F7F7F7FULL
+#define STR_HIGHS			0x8080808080808080ULL
+
+// 올리지 않았으면 올림
+FINLINE void _str_check_up(void)
+{
+	if (str_impl.inited == false)
+		qn_str_up();
+}
+
+// ASCII 소문자로
+FINLINE int _str_lower(const int c)
+{
+	return (uint)(c - 'A') < 26 ? c | 0x20 : c;
+}
+
+// SWAR 8바이트 읽기
+FINLINE ullong _str_swar_load(const void* p)
+{
+	ullong x;
+	memcpy(&x, p, sizeof(x));
+	return x;
+}
+
+// SWAR, 0인 바이트 자리에 0x80 (정확하게)
+FINLINE ullong _str_swar_zero(const ullong x)
+{
+	return ~(((x & STR_LOWS) + STR_LOWS) | x | STR_LOWS);
+}
+
+// SWAR, lo부터 26글자 안에 드는 바이트 자리에 0x80
+FINLINE ullong _str_swar_alpha(const ullong x, const byte lo)
+{
+	const ullong l = x & STR_LOWS;
+	const ullong a = l + STR_ONES * (byte)(0x80 - lo);
+	const ullong z = l + STR_ONES * (byte)(0x80 - lo - 26);
+	return (a ^ z) & ~x & STR_HIGHS;
+}
+
+#if defined _QN_SSE2_
+// lo부터 26글자 안에 드는 바이트의 대소문자를 뒤집는다
+FINLINE __m128i _str_case_sse2(const __m128i v, const byte lo)
+{
+	const __m128i t = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - lo)));
+	const __m128i m = _mm_cmplt_epi8(t, _mm_set1_epi8((char)(0x80 + 26)));
+	return _mm_xor_si128(v, _mm_and_si128(m, _mm_set1_epi8(0x20)));
+}
+
+// 공백 (\t \n \v \f \r 그리고 스페이스)
+FINLINE __m128i _str_space_sse2(const __m128i v)
+{
+	const __m128i t = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - '\t')));
+	return _mm_or_si128(_mm_cmplt_epi8(t, _mm_set1_epi8((char)(0x80 + 5))), _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+}
+#elif defined _QN_NEON_
+// 바이트 마스크를 니블 마스크로 (바이트마다 4비트)
+FINLINE ullong _str_neon_bits(const uint8x16_t m)
+{
+	return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+}
+
+//
+FINLINE uint8x16_t _str_case_neon(const uint8x16_t v, const byte lo)
+{
+	const uint8x16_t m = vcltq_u8(vsubq_u8(v, vdupq_n_u8(lo)), vdupq_n_u8(26));
+	return veorq_u8(v, vandq_u8(m, vdupq_n_u8(0x20)));
+}
+
+//
+FINLINE uint8x16_t _str_space_neon(const uint8x16_t v)
+{
+	return vorrq_u8(vcleq_u8(vsubq_u8(v, vdupq_n_u8('\t')), vdupq_n_u8(4)), vceqq_u8(v, vdupq_n_u8(' ')));
+}
+#endif
+
+#if defined STR_X86
+// 대소문자 뒤집기
+STR_AVX2 static size_t _str_case_avx2(byte* p, const size_t len, const byte lo)
+{
+	const __m256i add = _mm256_set1_epi8((char)(0x80 - lo)), lim = _mm256_set1_epi8((char)(0x80 + 26)), flip = _mm256_set1_epi8(0x20);
+	size_t i = 0;
+	for (; i + 32 <= len; i += 32)
+	{
+		const __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+		const __m256i m = _mm256_cmpgt_epi8(lim, _mm256_add_epi8(v, add));
+		_mm256_storeu_si256((__m256i*)(p + i), _mm256_xor_si256(v, _mm256_and_si256(m, flip)));
+	}
+	return i;
+}
+
+// 대소문자 무시 비교, 틀린 글자나 널 위치 또는 본 길이 (len은 페이지를 넘지 않는다)
+// 앞에 이미 맞춰 본 바이트가 있으면 (before) 끝 블럭은 뒤로 물려서 겹쳐 읽는다
+STR_AVX2 STR_NOASAN static size_t _str_icmp_avx2(const byte* p1, const byte* p2, const size_t len, const size_t before)
+{
+	const __m256i add = _mm256_set1_epi8((char)(0x80 - 'A')), lim = _mm256_set1_epi8((char)(0x80 + 26));
+	const __m256i flip = _mm256_set1_epi8(0x20), z = _mm256_setzero_si256();
+	ptrdiff_t k = 0;
+	for (;;)
+	{
+		if (k + 32 > (ptrdiff_t)len)
+		{
+			if (k == (ptrdiff_t)len || before + len < 32)
+				return (size_t)k;
+			k = (ptrdiff_t)len - 32;
+		}
+		const __m256i a = _mm256_loadu_si256((const __m256i*)(p1 + k));
+		const __m256i b = _mm256_loadu_si256((const __m256i*)(p2 + k));
+		const __m256i la = _mm256_xor_si256(a, _mm256_and_si256(_mm256_cmpgt_epi8(lim, _mm256_add_epi8(a, add)), flip));
+		const __m256i lb = _mm256_xor_si256(b, _mm256_and_si256(_mm256_cmpgt_epi8(lim, _mm256_add_epi8(b, add)), flip));
+		const uint m = ~(uint)_mm256_movemask_epi8(_mm256_cmpeq_epi8(la, lb)) | (uint)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, z));
+		if (m)
+			return (size_t)(k + (ptrdiff_t)qn_ctz32(m));
+		k += 32;
+	}
+}
+
+// 뒤에서 문자 찾기, 못 찾으면 남은 길이를 돌려준다
+STR_AVX2 static const byte* _str_nrchr_avx2(const byte* p, size_t* plen, const byte ch)
+{
+	const __m256i c = _mm256_set1_epi8((char)ch);
+	size_t len = *plen;
+	for (; len >= 32; len -= 32)
+	{
+		const uint m = (uint)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + len - 32)), c));
+		if (m)
+			return p + len - 32 + (63 - qn_clz64(m));
+	}
+	*plen = len;
+	return NULL;
+}
+
+// 널까지 문자 찾기
+STR_AVX2 STR_NOASAN static const char* _str_chr_avx2(const char* p, const byte ch)
+{
+	const __m256i c = _mm256_set1_epi8((char)ch), z = _mm256_setzero_si256();
+	const size_t off = (uintptr_t)p & 31;
+	const __m256i* a = (const __m256i*)(p - off);
+	__m256i v = _mm256_load_si256(a);
+	uint m = (uint)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, c), _mm256_cmpeq_epi8(v, z))) >> off;
+	if (m)
+		return p + qn_ctz32(m);
+	for (;;)
+	{
+		v = _mm256_load_si256(++a);
+		m = (uint)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, c), _mm256_cmpeq_epi8(v, z)));
+		if (m)
+			return (const char*)a + qn_ctz32(m);
+	}
+}
+
+// 문자열 찾기, 첫 바이트와 끝 바이트가 같이 맞는 자리만 가운데를 비교한다
+STR_AVX2 static const byte* _str_nstr_avx2(const byte* h, const size_t last, const byte* n, const size_t nlen, size_t* pi)
+{
+	const __m256i f = _mm256_set1_epi8((char)n[0]), l = _mm256_set1_epi8((char)n[nlen - 1]);
+	size_t i = 0;
+	for (; i + 32 <= last + 1; i += 32)
+	{
+		const __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(h + i)), f);
+		const __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(h + i + nlen - 1)), l);
+		for (uint m = (uint)_mm256_movemask_epi8(_mm256_and_si256(a, b)); m; m &= m - 1)
+		{
+			const byte* s = h + i + qn_ctz32(m);
+			if (memcmp(s + 1, n + 1, nlen - 2) == 0)
+				return s;
+		}
+	}
+	*pi = i;
+	return NULL;
+}
+#endif
+
+// 널까지 문자 찾기, 문자나 널 위치
+STR_NOASAN static const char* _str_chr(const char* p, const byte ch)
+{
+#if defined STR_X86
+	if (str_impl.avx2)
+		return _str_chr_avx2(p, ch);
+#endif
+#if defined _QN_SSE2_
+	const __m128i c = _mm_set1_epi8((char)ch), z = _mm_setzero_si128();
+	const size_t off = (uintptr_t)p & 15;
+	const __m128i* a = (const __m128i*)(p - off);
+	__m128i v = _mm_load_si128(a);
+	uint m = (uint)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, c), _mm_cmpeq_epi8(v, z))) >> off;
+	if (m)
+		return p + qn_ctz32(m);
+	for (;;)
+	{
+		v = _mm_load_si128(++a);
+		m = (uint)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, c), _mm_cmpeq_epi8(v, z)));
+		if (m)
+			return (const char*)a + qn_ctz32(m);
+	}
+#elif defined _QN_NEON_
+	const uint8x16_t c = vdupq_n_u8(ch);
+	const size_t off = (uintptr_t)p & 15;
+	const byte* a = (const byte*)(p - off);
+	uint8x16_t v = vld1q_u8(a);
+	ullong m = _str_neon_bits(vorrq_u8(vceqq_u8(v, c), vceqzq_u8(v))) >> (off * 4);
+	if (m)
+		return p + (qn_ctz64(m) >> 2);
+	for (;;)
+	{
+		a += 16;
+		v = vld1q_u8(a);
+		m = _str_neon_bits(vorrq_u8(vceqq_u8(v, c), vceqzq_u8(v)));
+		if (m)
+			return (const char*)a + (qn_ctz64(m) >> 2);
+	}
+#else
+	const ullong c = STR_ONES * ch;
+	const size_t off = (uintptr_t)p & 7;
+	const byte* a = (const byte*)(p - off);
+	ullong x = _str_swar_load(a);
+	ullong m = (_str_swar_zero(x) | _str_swar_zero(x ^ c)) >> (off * 8);
+	if (m)
+		return p + (qn_ctz64(m) >> 3);
+	for (;;)
+	{
+		a += 8;
+		x = _str_swar_load(a);
+		m = _str_swar_zero(x) | _str_swar_zero(x ^ c);
+		if (m)
+			return (const char*)a + (qn_ctz64(m) >> 3);
+	}
+#endif
+}
+
+// 길이 안에서 뒤에서부터 문자 찾기
+static const byte* _str_nrchr(const byte* p, size_t len, const byte ch)
+{
+#if defined STR_X86
+	if (str_impl.avx2)
+	{
+		const byte* r = _str_nrchr_avx2(p, &len, ch);
+		if (r)
+			return r;
+	}
+#endif
+#if defined _QN_SSE2_
+	const __m128i c = _mm_set1_epi8((char)ch);
+	for (; len >= 16; len -= 16)
+	{
+		const uint m = (uint)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + len - 16)), c));
+		if (m)
+			return p + len - 16 + (63 - qn_clz64(m));
+	}
+#elif defined _QN_NEON_
+	const uint8x16_t c = vdupq_n_u8(ch);
+	for (; len >= 16; len -= 16)
+	{
+		const ullong m = _str_neon_bits(vceqq_u8(vld1q_u8(p + len - 16), c));
+		if (m)
+			return p + len - 16 + ((63 - qn_clz64(m)) >> 2);
+	}
+#else
+	const ullong c = STR_ONES * ch;
+	for (; len >= 8; len -= 8)
+	{
+		const ullong m = _str_swar_zero(_str_swar_load(p + len - 8) ^ c);
+		if (m)
+			return p + len - 8 + ((63 - qn_clz64(m)) >> 3);
+	}
+#endif
+	while (len--)
+	{
+		if (p[len] == ch)
+			return p + len;
+	}
+	return NULL;
+}
+
+// 길이 안에서 문자열 찾기 (nlen은 2 이상, hlen 이하)
+static const byte* _str_nstr(const byte* h, const size_t hlen, const byte* n, const size_t nlen)
+{
+	const size_t last = hlen - nlen;
+	size_t i = 0;
+#if defined STR_X86
+	if (str_impl.avx2)
+	{
+		const byte* r = _str_nstr_avx2(h, last, n, nlen, &i);
+		if (r)
+			return r;
+	}
+#endif
+#if defined _QN_SSE2_
+	const __m128i f = _mm_set1_epi8((char)n[0]), l = _mm_set1_epi8((char)n[nlen - 1]);
+	for (; i + 16 <= last + 1; i += 16)
+	{
+		const __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(h + i)), f);
+		const __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(h + i + nlen - 1)), l);
+		for (uint m = (uint)_mm_movemask_epi8(_mm_and_si128(a, b)); m; m &= m - 1)
+		{
+			const byte* s = h + i + qn_ctz32(m);
+			if (memcmp(s + 1, n + 1, nlen - 2) == 0)
+				return s;
+		}
+	}
+#elif defined _QN_NEON_
+	const uint8x16_t f = vdupq_n_u8(n[0]), l = vdupq_n_u8(n[nlen - 1]);
+	for (; i + 16 <= last + 1; i += 16)
+	{
+		const uint8x16_t a = vceqq_u8(vld1q_u8(h + i), f);
+		const uint8x16_t b = vceqq_u8(vld1q_u8(h + i + nlen - 1), l);
+		for (ullong m = _str_neon_bits(vandq_u8(a, b)) & 0x1111111111111111ULL; m; m &= m - 1)
+		{
+			const byte* s = h + i + (qn_ctz64(m) >> 2);
+			if (memcmp(s + 1, n + 1, nlen - 2) == 0)
+				return s;
+		}
+	}
+#endif
+	// 나머지는 첫 바이트를 memchr로
+	while (i <= last)
+	{
+		const byte* s = (const byte*)memchr(h + i, n[0], last - i + 1);
+		if (s == NULL)
+			break;
+		if (memcmp(s + 1, n + 1, nlen - 1) == 0)
+			return s;
+		i = (size_t)(s - h) + 1;
+	}
+	return NULL;
+}
+
+// 대소문자 뒤집기, lo가 'a'면 대문자로 'A'면 소문자로
+static void _str_case(byte* p, const size_t len, const byte lo)
+{
+	size_t i = 0;
+#if defined STR_X86
+	if (str_impl.avx2)
+		i = _str_case_avx2(p, len, lo);
+#endif
+#if defined _QN_SSE2_
+	for (; i + 16 <= len; i += 16)
+		_mm_storeu_si128((__m128i*)(p + i), _str_case_sse2(_mm_loadu_si128((const __m128i*)(p + i)), lo));
+#elif defined _QN_NEON_
+	for (; i + 16 <= len; i += 16)
+		vst1q_u8(p + i, _str_case_neon(vld1q_u8(p + i), lo));
+#else
+	for (; i + 8 <= len; i += 8)
+	{
+		const ullong x = _str_swar_load(p + i);
+		const ullong y = x ^ (_str_swar_alpha(x, lo) >> 2);
+		memcpy(p + i, &y, sizeof(y));
+	}
+#endif
+	for (; i < len; i++)
+	{
+		if ((byte)(p[i] - lo) < 26)
+			p[i] ^= 0x20;
+	}
+}
+
+// 대소문자 무시 비교, len까지나 널까지. 두 쪽 모두 페이지를 넘지 않는 만큼씩 벡터로 보고
+// 페이지 끝에 남는 바이트는 이미 본 바이트와 겹쳐 읽는다. 틀린 글자나 널은 한 글자로 판단
+STR_NOASAN static int _str_icmp(const byte* p1, const byte* p2, const size_t len)
+{
+	size_t i = 0;
+	while (i < len)
+	{
+		const size_t s1 = 4096 - ((uintptr_t)(p1 + i) & 4095), s2 = 4096 - ((uintptr_t)(p2 + i) & 4095);
+		size_t span = s1 < s2 ? s1 : s2;
+		if (span > len - i)
+			span = len - i;
+#if defined STR_X86
+		if (str_impl.avx2)
+			i += _str_icmp_avx2(p1 + i, p2 + i, span, i);
+		else
+#endif
+		{
+#if defined _QN_SSE2_ || defined _QN_NEON_
+			const byte* a1 = p1 + i;
+			const byte* a2 = p2 + i;
+			ptrdiff_t k = 0;
+			for (;;)
+			{
+				if (k + 16 > (ptrdiff_t)span)
+				{
+					if (k == (ptrdiff_t)span || i + span < 16)
+						break;
+					k = (ptrdiff_t)span - 16;
+				}
+#if defined _QN_SSE2_
+				const __m128i a = _mm_loadu_si128((const __m128i*)(a1 + k));
+				const __m128i b = _mm_loadu_si128((const __m128i*)(a2 + k));
+				const __m128i eq = _mm_cmpeq_epi8(_str_case_sse2(a, 'A'), _str_case_sse2(b, 'A'));
+				const uint m = ((uint)_mm_movemask_epi8(eq) ^ 0xFFFF) | (uint)_mm_movemask_epi8(_mm_cmpeq_epi8(a, _mm_setzero_si128()));
+				if (m)
+				{
+					k += qn_ctz32(m);
+					break;
+				}
+#else
+				const uint8x16_t a = vld1q_u8(a1 + k), b = vld1q_u8(a2 + k);
+				const uint8x16_t eq = vceqq_u8(_str_case_neon(a, 'A'), _str_case_neon(b, 'A'));
+				const ullong m = _str_neon_bits(vorrq_u8(vmvnq_u8(eq), vceqzq_u8(a)));
+				if (m)
+				{
+					k += qn_ctz64(m) >> 2;
+					break;
+				}
+#endif
+				k += 16;
+			}
+			i += (size_t)k;
+#else
+			size_t k = 0;
+			for (; k + 8 <= span; k += 8)
+			{
+				const ullong a = _str_swar_load(p1 + i + k), b = _str_swar_load(p2 + i + k);
+				const ullong fa = a | (_str_swar_alpha(a, 'A') >> 2), fb = b | (_str_swar_alpha(b, 'A') >> 2);
+				const ullong m = (_str_swar_zero(fa ^ fb) ^ STR_HIGHS) | _str_swar_zero(a);
+				if (m)
+				{
+					k += qn_ctz64(m) >> 3;
+					break;
+				}
+			}
+			i += k;
+#endif
+		}
+		if (i >= len)
+			break;
+		const int f = _str_lower(p1[i]), l = _str_lower(p2[i]);
+		if (f != l || f == 0)
+			return f - l;
+		i++;
+	}
+	return 0;
+}
+
+// 공백 판단
+FINLINE bool _str_is_space(const byte b)
+{
+	return b == ' ' || (uint)(b - '\t') < 5;
+}
+
+// 앞쪽 공백 길이
+static size_t _str_space_head(const byte* p, const size_t len)
+{
+	size_t i = 0;
+#if defined _QN_SSE2_
+	for (; i + 16 <= len; i += 16)
+	{
+		const uint m = (uint)_mm_movemask_epi8(_str_space_sse2(_mm_loadu_si128((const __m128i*)(p + i)))) ^ 0xFFFF;
+		if (m)
+			return i + qn_ctz32(m);
+	}
+#elif defined _QN_NEON_
+	for (; i + 16 <= len; i += 16)
+	{
+		const ullong m = ~_str_neon_bits(_str_space_neon(vld1q_u8(p + i)));
+		if (m)
+			return i + (qn_ctz64(m) >> 2);
+	}
+#endif
+	while (i < len && _str_is_space(p[i]))
+		i++;
+	return i;
+}
+
+// 뒤쪽 공백 길이
+static size_t _str_space_tail(const byte* p, const size_t len)
+{
+	size_t n = len;
+#if defined _QN_SSE2_
+	for (; n >= 16; n -= 16)
+	{
+		const uint m = (uint)_mm_movemask_epi8(_str_space_sse2(_mm_loadu_si128((const __m128i*)(p + n - 16)))) ^ 0xFFFF;
+		if (m)
+			return len - (n - 16 + (63 - qn_clz64(m))) - 1;
+	}
+#elif defined _QN_NEON_
+	for (; n >= 16; n -= 16)
+	{
+		const ullong m = ~_str_neon_bits(_str_space_neon(vld1q_u8(p + n - 16)));
+		if (m)
+			return len - (n - 16 + ((63 - qn_clz64(m)) >> 2)) - 1;
+	}
+#endif
+	while (n > 0 && _str_is_space(p[n - 1]))
+		n--;
+	return len - n;
+}
+
+// 문자 집합. 글자가 적으면 글자마다 비교하고, 많으면 아래 니블 -> 위 니블 비트 표 (lo는 위 니블 0~7, hi는 8~15)
+// 적은 글자는 8바이트 하나에 넣고 남는 자리는 첫 글자로 채운다 (4개 이하면 4개만 본다). 표는 x86에서 SSSE3가 있어야 쓴다
+#define STR_SET_FEW			8
+
+typedef struct STRSET
+{
+	uint			count;
+	ullong			chars;
+	byte			lo[16];
+	byte			hi[16];
+	uint			map[8];
+} StrSet;
+
+// 표 집합 만들기
+static void _str_set_table(StrSet* set, const char* c, const bool nul)
+{
+	set->count = UINT_MAX;
+	memset(set->lo, 0, sizeof(set->lo) + sizeof(set->hi) + sizeof(set->map));
+	for (const byte* s = (const byte*)c;; s++)
+	{
+		const byte b = *s;
+		if (b == 0 && nul == false)
+			break;
+		(b & 0x80 ? set->hi : set->lo)[b & 15] |= (byte)(1 << ((b >> 4) & 7));
+		set->map[b >> 5] |= 1U << (b & 31);
+		if (b == 0)
+			break;
+	}
+}
+
+// 문자 집합 만들기, nul이면 널도 넣는다
+FINLINE void _str_set_init(StrSet* set, const char* c, const bool nul)
+{
+	ullong w = 0;
+	uint n = 0;
+	for (; n < STR_SET_FEW && c[n]; n++)
+		w |= (ullong)(byte)c[n] << (n * 8);
+	if (c[n] != '\0' || n + nul > STR_SET_FEW)
+	{
+		_str_set_table(set, c, nul);
+		return;
+	}
+	n += nul;
+	set->count = n == 0 ? 0 : n <= 4 ? 4 : STR_SET_FEW;
+	// 널은 이미 0으로 들어 있다
+	const ullong used = n < STR_SET_FEW ? (1ULL << (n * 8)) - 1 : ~0ULL;
+	set->chars = (w & used) | (STR_ONES * (w & 0xFF) & ~used);
+}
+
+//
+FINLINE bool _str_set_has(const StrSet* set, const byte b)
+{
+	if (set->count > STR_SET_FEW)
+		return (set->map[b >> 5] & (1U << (b & 31))) != 0;
+	return set->count != 0 && _str_swar_zero(set->chars ^ (STR_ONES * b)) != 0;
+}
+
+#if defined _QN_SSE2_
+// 몇 글자 집합의 글자마다 채운 벡터
+FINLINE void _str_few_sse2_init(__m128i* cv, const ullong* chars)
+{
+	const __m128i x = _mm_loadl_epi64((const __m128i*)chars);
+	const __m128i y = _mm_unpacklo_epi8(x, x);
+	const __m128i lo = _mm_unpacklo_epi16(y, y), hi = _mm_unpackhi_epi16(y, y);
+	cv[0] = _mm_shuffle_epi32(lo, 0x00);
+	cv[1] = _mm_shuffle_epi32(lo, 0x55);
+	cv[2] = _mm_shuffle_epi32(lo, 0xAA);
+	cv[3] = _mm_shuffle_epi32(lo, 0xFF);
+	cv[4] = _mm_shuffle_epi32(hi, 0x00);
+	cv[5] = _mm_shuffle_epi32(hi, 0x55);
+	cv[6] = _mm_shuffle_epi32(hi, 0xAA);
+	cv[7] = _mm_shuffle_epi32(hi, 0xFF);
+}
+
+// 몇 글자 집합, 글자마다 비교
+FINLINE uint _str_few_sse2(const __m128i v, const __m128i* cv, const uint count)
+{
+	__m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, cv[0]), _mm_cmpeq_epi8(v, cv[1])),
+		_mm_or_si128(_mm_cmpeq_epi8(v, cv[2]), _mm_cmpeq_epi8(v, cv[3])));
+	if (count > 4)
+	{
+		m = _mm_or_si128(m, _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, cv[4]), _mm_cmpeq_epi8(v, cv[5])),
+			_mm_or_si128(_mm_cmpeq_epi8(v, cv[6]), _mm_cmpeq_epi8(v, cv[7]))));
+	}
+	return (uint)_mm_movemask_epi8(m);
+}
+
+// 길이 안에서 몇 글자 집합 찾기, 찾은 위치나 남은 꼬리 시작
+static size_t _str_nbrk_sse2(const byte* p, const size_t len, const StrSet* set)
+{
+	__m128i cv[STR_SET_FEW];
+	_str_few_sse2_init(cv, &set->chars);
+	size_t i = 0;
+	for (; i + 16 <= len; i += 16)
+	{
+		const uint m = _str_few_sse2(_mm_loadu_si128((const __m128i*)(p + i)), cv, set->count);
+		if (m)
+			return i + qn_ctz32(m);
+	}
+	return i;
+}
+
+// 널까지 몇 글자 집합 찾기 (집합에 널이 있어야 한다). 정렬해서 읽으므로 페이지를 넘지 않는다
+STR_NOASAN static const char* _str_brk_sse2(const char* p, const StrSet* set)
+{
+	__m128i cv[STR_SET_FEW];
+	_str_few_sse2_init(cv, &set->chars);
+	const size_t off = (uintptr_t)p & 15;
+	const __m128i* a = (const __m128i*)(p - off);
+	uint m = _str_few_sse2(_mm_load_si128(a), cv, set->count) >> off;
+	if (m)
+		return p + qn_ctz32(m);
+	for (;;)
+	{
+		m = _str_few_sse2(_mm_load_si128(++a), cv, set->count);
+		if (m)
+			return (const char*)a + qn_ctz32(m);
+	}
+}
+#endif
+
+#if defined STR_X86
+// 표 집합에 드는 바이트. pshufb는 인덱스 위 비트가 서면 0이라 lo, hi 표가 저절로 갈린다
+STR_SSSE3 FINLINE uint _str_set_ssse3(const __m128i v, const __m128i lo, const __m128i hi)
+{
+	const __m128i idx = _mm_and_si128(v, _mm_set1_epi8((char)0x8F));
+	const __m128i sel = _mm_or_si128(_mm_shuffle_epi8(lo, idx), _mm_shuffle_epi8(hi, _mm_xor_si128(idx, _mm_set1_epi8((char)0x80))));
+	const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+	const __m128i bit = _mm_shuffle_epi8(bits, _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F)));
+	return (uint)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(sel, bit), bit));
+}
+
+// 길이 안에서 표 집합 찾기
+STR_SSSE3 static size_t _str_nbrk_ssse3(const byte* p, const size_t len, const StrSet* set)
+{
+	const __m128i lo = _mm_loadu_si128((const __m128i*)set->lo), hi = _mm_loadu_si128((const __m128i*)set->hi);
+	size_t i = 0;
+	for (; i + 16 <= len; i += 16)
+	{
+		const uint m = _str_set_ssse3(_mm_loadu_si128((const __m128i*)(p + i)), lo, hi);
+		if (m)
+			return i + qn_ctz32(m);
+	}
+	return i;
+}
+
+// 널까지 표 집합 찾기
+STR_SSSE3 STR_NOASAN static const char* _str_brk_ssse3(const char* p, const StrSet* set)
+{
+	const __m128i lo = _mm_loadu_si128((const __m128i*)set->lo), hi = _mm_loadu_si128((const __m128i*)set->hi);
+	const size_t off = (uintptr_t)p & 15;
+	const __m128i* a = (const __m128i*)(p - off);
+	uint m = _str_set_ssse3(_mm_load_si128(a), lo, hi) >> off;
+	if (m)
+		return p + qn_ctz32(m);
+	for (;;)
+	{
+		m = _str_set_ssse3(_mm_load_si128(++a), lo, hi);
+		if (m)
+			return (const char*)a + qn_ctz32(m);
+	}
+}
+#elif defined _QN_NEON_
+// 집합에 드는 바이트, 글자가 적으면 글자마다 비교하고 많으면 표. tbl은 인덱스가 16을 넘으면 0이라 lo, hi 표가 저절로 갈린다
+FINLINE ullong _str_set_neon(const uint8x16_t v, const StrSet* set, const uint8x16_t lo, const uint8x16_t hi)
+{
+	if (set->count <= STR_SET_FEW)
+	{
+		uint8x16_t m = vceqq_u8(v, vdupq_n_u8((byte)set->chars));
+		for (uint k = 1; k < set->count; k++)
+			m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8((byte)(set->chars >> (k * 8)))));
+		return _str_neon_bits(m);
+	}
+	static const byte bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+	const uint8x16_t idx = vandq_u8(v, vdupq_n_u8(0x8F));
+	const uint8x16_t sel = vorrq_u8(vqtbl1q_u8(lo, idx), vqtbl1q_u8(hi, veorq_u8(idx, vdupq_n_u8(0x80))));
+	return _str_neon_bits(vtstq_u8(sel, vqtbl1q_u8(vld1q_u8(bits), vshrq_n_u8(v, 4))));
+}
+#else
+// 몇 글자 집합, 글자마다 0인 바이트 찾기
+FINLINE ullong _str_few_swar(const ullong x, const ullong* cw, const uint count)
+{
+	ullong m = _str_swar_zero(x ^ cw[0]);
+	for (uint k = 1; k < count; k++)
+		m |= _str_swar_zero(x ^ cw[k]);
+	return m;
+}
+#endif
+
+// 길이 안에서 집합 찾기
+static const byte* _str_nbrk(const byte* p, const size_t len, const StrSet* set)
+{
+	size_t i = 0;
+	if (set->count == 0)
+		return NULL;
+#if defined STR_X86
+	if (set->count <= STR_SET_FEW)
+		i = _str_nbrk_sse2(p, len, set);
+	else if (str_impl.ssse3)
+		i = _str_nbrk_ssse3(p, len, set);
+#elif defined _QN_NEON_
+	const uint8x16_t lo = vld1q_u8(set->lo), hi = vld1q_u8(set->hi);
+	for (; i + 16 <= len; i += 16)
+	{
+		const ullong m = _str_set_neon(vld1q_u8(p + i), set, lo, hi);
+		if (m)
+			return p + i + (qn_ctz64(m) >> 2);
+	}
+#else
+	if (set->count <= STR_SET_FEW)
+	{
+		ullong cw[STR_SET_FEW];
+		for (uint k = 0; k < STR_SET_FEW; k++)
+			cw[k] = STR_ONES * (byte)(set->chars >> (k * 8));
+		for (; i + 8 <= len; i += 8)
+		{
+			const ullong m = _str_few_swar(_str_swar_load(p + i), cw, set->count);
+			if (m)
+				return p + i + (qn_ctz64(m) >> 3);
+		}
+	}
+#endif
+	for (; i < len; i++)
+	{
+		if (_str_set_has(set, p[i]))
+			return p + i;
+	}
+	return NULL;
+}
+
+// 널까지 집합 찾기, 집합에 드는 문자나 널 위치 (집합에 널이 있어야 한다)
+STR_NOASAN static const char* _str_brk(const char* p, const StrSet* set)
+{
+#if defined STR_X86
+	if (set->count <= STR_SET_FEW)
+		return _str_brk_sse2(p, set);
+	if (str_impl.ssse3)
+		return _str_brk_ssse3(p, set);
+#elif defined _QN_NEON_
+	const uint8x16_t lo = vld1q_u8(set->lo), hi = vld1q_u8(set->hi);
+	const size_t off = (uintptr_t)p & 15;
+	const byte* a = (const byte*)(p - off);
+	ullong m = _str_set_neon(vld1q_u8(a), set, lo, hi) >> (off * 4);
+	if (m)
+		return p + (qn_ctz64(m) >> 2);
+	for (;;)
+	{
+		a += 16;
+		m = _str_set_neon(vld1q_u8(a), set, lo, hi);
+		if (m)
+			return (const char*)a + (qn_ctz64(m) >> 2);
+	}
+#else
+	if (set->count <= STR_SET_FEW)
+	{
+		ullong cw[STR_SET_FEW];
+		for (uint k = 0; k < STR_SET_FEW; k++)
+			cw[k] = STR_ONES * (byte)(set->chars >> (k * 8));
+		const size_t off = (uintptr_t)p & 7;
+		const byte* a = (const byte*)(p - off);
+		ullong m = _str_few_swar(_str_swar_load(a), cw, set->count) >> (off * 8);
+		if (m)
+			return p + (qn_ctz64(m) >> 3);
+		for (;;)
+		{
+			a += 8;
+			m = _str_few_swar(_str_swar_load(a), cw, set->count);
+			if (m)
+				return (const char*)a + (qn_ctz64(m) >> 3);
+		}
+	}
+#endif
+	while (!_str_set_has(set, (byte)*p))
+		p++;
+	return p;
+}
+
+// 집합에 드는 문자를 지우고 남은 길이, 지울 문자 사이는 통째로 옮긴다
+static size_t _str_nrem(byte* p, const size_t len, const StrSet* set)
+{
+	size_t i = 0, o = 0;
+	while (i < len)
+	{
+		const byte* s = _str_nbrk(p + i, len - i, set);
+		const size_t n = s ? (size_t)(s - p) - i : len - i;
+		if (o != i)
+			memmove(p + o, p + i, n);
+		o += n;
+		i += n + 1;
+	}
+	return o;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 아스키/멀티바이트 버전
+
+// DOPR 정리 공용
+static void printf_finish(PatrickPowellSprintfState* state)
+{
+	if (state->maxlen > 0)
+		state->buf[state->currlen < state->maxlen - 1 ? state->currlen : state->maxlen - 1] = '\0';
+}
+
+// DOPR 고정 문자열 버전
+static void printf_outch(PatrickPowellSprintfState* state, int ch)
+{
+	if (state->currlen < state->maxlen)
+		state->buf[state->currlen] = (char)ch;
+	state->currlen++;
+}
+
+// DOPR 할당 문자열 버전
+static void printf_alloc_outch(PatrickPowellSprintfState* state, int ch)
+{
+	if (state->currlen >= state->maxlen)
+	{
+		state->maxlen = state->currlen + 256;
+#ifdef QS_NO_MEMORY_PROFILE
+		state->buf = (char*)qn_a_realloc(state->buf, state->maxlen);
+#else
+		state->buf = (char*)qn_a_i_realloc(state->buf, state->maxlen, state->desc, state->line);
+#endif
+	}
+	state->buf[state->currlen] = (char)ch;
+	state->currlen++;
+}
+
+#ifdef QS_NO_MEMORY_PROFILE
+//
+static int qn_a_printf(char** out, const char* fmt, va_list va)
+{
+	PatrickPowellSprintfState state =
+	{
+		printf_alloc_outch,
+		printf_finish,
+	};
+	dopr(&state, fmt, va);
+	*out = state.buf;
+	return (int)state.currlen;
+}
+
+//
+int qn_a_vsprintf(char** out, const char* fmt, va_list va)
+{
+	if (out == NULL)
+		return qn_vsnprintf(NULL, 0, fmt, va);
+	qn_return_when_fail(fmt != NULL, -1);
+	return qn_a_printf(out, fmt, va);
+}
+
+//
+char* qn_a_vpsprintf(const char* fmt, va_list va)
+{
+	qn_return_when_fail(fmt != NULL, NULL);
+	char* buf;
+	qn_a_printf(&buf, fmt, va);
+	return buf;
+}
+
+//
+int qn_a_sprintf(char** out, const char* fmt, ...)
+{
+	va_list va;
+	va_start(va, fmt);
+	const int ret = qn_a_vsprintf(out, fmt, va);
+	va_end(va);
+	return ret;
+}
+
+//
+char* qn_a_psprintf(const char* fmt, ...)
+{
+	va_list va;
+	va_start(va, fmt);
+	char* buf;
+	qn_a_printf(&buf, fmt, va);
+	va_end(va);
+	return buf;
+}
+
+//
+char* qn_a_str_dup(const char* p)
+{
+	qn_return_when_fail(p != NULL, NULL);
+	const size_t len = strlen(p) + 1;
+	char* d = (char*)qn_a_alloc(len, false);
+	qn_strcpy(d, p);
+	return d;
+}
+
+//
+char* qn_a_str_dup_cat(const char* p, ...)
+{
+	va_list va, vq;
+	va_start(va, p);
 	va_copy(vq, va);
 
 	size_t size = strlen(p) + 1;
@@ -540,45 +3179,38 @@ size_t qn_strfll(char* dest, const size_t pos, const size_t end, const int ch)
 //
 size_t qn_strhash(const char* p)
 {
-	const char* sz = p;
-	size_t h = (size_t)*sz++;
-	if (!h)
-		return 0;
-	size_t c;
-	for (c = 0; *sz && c < 256; sz++, c++)
-		h = (h << 5) - h + (size_t)*sz;
-	h = (h << 5) - h + c;
-	return h;
+	return qn_hash64_size(qn_hash64(p, strlen(p), 0));
+}
+
+//
+size_t qn_strnhash(const char* p, const size_t len)
+{
+	return qn_hash64_size(qn_hash64(p, len, 0));
 }
 
 //
 size_t qn_strihash(const char* p)
 {
-	const char* sz = p;
-	size_t h = (size_t)tolower(*sz);
-	if (!h)
-		return 0;
-	size_t c;
-	sz++;
-	for (c = 0; *sz && c < 256; sz++, c++)
-		h = (h << 5) - h + (size_t)tolower(*sz);
-	h = (h << 5) - h + c;
-	return h;
+	return qn_hash64_size(qn_hash64_fold(p, strlen(p), 0));
+}
+
+//
+size_t qn_strnihash(const char* p, const size_t len)
+{
+	return qn_hash64_size(qn_hash64_fold(p, len, 0));
 }
 
 //
 uint qn_strshash(const char* p)
 {
-	const char* sz = p;
-	uint h = (uint)tolower(*sz);
-	if (!h)
-		return 0;
-	uint c;
-	sz++;
-	for (c = 0; *sz && c < 256; sz++, c++)
-		h = (h << 5) - h + (uint)tolower(*sz);
-	h = (h << 5) - h + c;
-	return h;
+	return qn_strnshash(p, strlen(p));
+}
+
+//
+uint qn_strnshash(const char* p, const size_t len)
+{
+	const ullong h = qn_hash64_fold(p, len, 0);
+	return (uint)(h ^ (h >> 32));
 }
 
 //
@@ -616,21 +3248,7 @@ int qn_strncmp(const char* p1, const char* p2, size_t len)
 //
 int qn_stricmp(const char* p1, const char* p2)
 {
-#ifdef _MSC_VER
-	return _stricmp(p1, p2);
-#elif defined __GNUC__
-	return strcasecmp(p1, p2);
-#else
-	int	f, l;
-	do
-	{
-		f = (unsigned char)(*(p1++));
-		l = (unsigned char)(*(p2++));
-		if (f >= 'A' && f <= 'Z')	f -= 'A' - 'a';
-		if (l >= 'A' && l <= 'Z')	l -= 'A' - 'a';
-	} while (f && (f == l));
-	return (f - l);
-#endif
+	return _str_icmp((const byte*)p1, (const byte*)p2, (size_t)-1);
 }
 
 //
@@ -642,44 +3260,17 @@ int qn_strpcmp(const char** p1, const char** p2)
 //
 int qn_strnicmp(const char* p1, const char* p2, size_t len)
 {
-#ifdef _MSC_VER
-	return _strnicmp(p1, p2, len);
-#elif defined __GNUC__
-	return strncasecmp(p1, p2, len);
-#else
-	int	f, l;
-	while (len && *p1 && *p2)
-	{
-		--len;
-		f = (unsigned char)(*p1);
-		l = (unsigned char)(*p2);
-		if (f >= 'A' && f <= 'Z')	f -= 'A' - 'a';
-		if (l >= 'A' && l <= 'Z')	l -= 'A' - 'a';
-		if (f != l) return (f - l);
-		++p1;
-		++p2;
-	}
-	return (len) ? (int)(p1 - p2) : 0;
-#endif
+	return _str_icmp((const byte*)p1, (const byte*)p2, len);
 }
 
 //
 int qn_strfnd(const char* src, const char* find, const size_t index)
-{
-	const char* p = src + index;
-	while (*p)
-	{
-		const char* s1 = p;
-		const char* s2 = find;
-		while (*s1 && *s2 && !(*s1 - *s2))
-		{
-			++s1;
-			++s2;
-		}
-		if (!*s2)
-			return (int)(src + index - p);
-	}
-	return -1;
+{
+	const size_t len = strlen(src);
+	if (index > len)
+		return -1;
+	const char* p = qn_strnstr(src + index, len - index, find, strlen(find));
+	return p ? (int)(p - src) : -1;
 }
 
 //
@@ -769,50 +3360,61 @@ bool qn_strieqv(const char* p1, const char* p2)
 //
 const char* qn_strbrk(const char* p, const char* c)
 {
-#if defined _MSC_VER || defined __GNUC__
-	return strpbrk(p, c);
-#else
-	// microsoft c library 13.10
-	const char* str = p;
-	const char* ctn = c;
-	int map[32] = { 0, };
-	while (*ctn)
-	{
-		map[*ctn >> 3] |= 1 << (*ctn & 7);
-		ctn++;
-	}
-	while (*str)
-	{
-		if (map[*str >> 3] & (1 << (*str & 7)))
-			return str;
-		str++;
-	}
-	return NULL;
-#endif
+	_str_check_up();
+	StrSet set;
+	_str_set_init(&set, c, true);
+	const char* r = _str_brk(p, &set);
+	return *r ? r : NULL;
+}
+
+//
+const char* qn_strnbrk(const char* p, size_t len, const char* c)
+{
+	_str_check_up();
+	StrSet set;
+	_str_set_init(&set, c, false);
+	return (const char*)_str_nbrk((const byte*)p, len, &set);
 }
 
 //
 char* qn_strchr(const char* p, int ch)
 {
-#if defined _MSC_VER || defined __GNUC__
-	return strchr(p, ch);
-#else
-	while (*p && *p != (char)ch) p++;
-	return (*p == (char)ch) ? (char*)p : NULL;
-#endif
+	_str_check_up();
+	const char* r = _str_chr(p, (byte)ch);
+	return *r == (char)ch ? (char*)r : NULL;
+}
+
+//
+char* qn_strnchr(const char* p, size_t len, int ch)
+{
+	return (char*)memchr(p, ch, len);
 }
 
 //
 char* qn_strrchr(const char* p, int ch)
 {
-#if defined _MSC_VER || defined __GNUC__
-	return strrchr(p, ch);
-#else
-	char* s = (char*)p;
-	while (*s++);
-	while (--s != p && *s != (char)ch);
-	return (*s == (char)ch) ? (char*)s : NULL;
-#endif
+	// 널도 찾을 수 있게 널까지 넣는다
+	return qn_strnrchr(p, strlen(p) + 1, ch);
+}
+
+//
+char* qn_strnrchr(const char* p, size_t len, int ch)
+{
+	_str_check_up();
+	return (char*)_str_nrchr((const byte*)p, len, (byte)ch);
+}
+
+//
+const char* qn_strnstr(const char* p, size_t len, const char* find, size_t findlen)
+{
+	if (findlen == 0)
+		return p;
+	if (findlen > len)
+		return NULL;
+	if (findlen == 1)
+		return (const char*)memchr(p, *find, len);
+	_str_check_up();
+	return (const char*)_str_nstr((const byte*)p, len, (const byte*)find, findlen);
 }
 
 //
@@ -888,76 +3490,79 @@ char* qn_strmid(char* dest, const char* src, const size_t pos, const size_t len)
 //
 char* qn_strltm(char* dest)
 {
-	char* s;
-	for (s = dest; *s && isspace(*s); s++) {}
-	if (dest != s)
-		memmove(dest, s, strlen(s) + 1);
+	const size_t len = strlen(dest);
+	const size_t head = _str_space_head((const byte*)dest, len);
+	if (head)
+		memmove(dest, dest + head, len - head + 1);
 	return dest;
 }
 
 //
 char* qn_strrtm(char* dest)
 {
-	size_t len = strlen(dest);
-	while (len--)
-	{
-		if (!isspace(dest[len]))
-			break;
-		dest[len] = '\0';
-	}
+	const size_t len = strlen(dest);
+	dest[len - _str_space_tail((const byte*)dest, len)] = '\0';
 	return dest;
 }
 
 //
 char* qn_strtrm(char* dest)
 {
-	return qn_strrtm(qn_strltm(dest));
+	dest[qn_strntrm(dest, strlen(dest))] = '\0';
+	return dest;
+}
+
+//
+size_t qn_strntrm(char* dest, size_t len)
+{
+	const size_t head = _str_space_head((const byte*)dest, len);
+	const size_t size = len - head - _str_space_tail((const byte*)dest + head, len - head);
+	if (head && size)
+		memmove(dest, dest + head, size);
+	return size;
 }
 
 //
 char* qn_strrem(char* p, const char* rmlist)
 {
-	const char* p1 = p;
-	char* p2 = p;
-	while (*p1)
-	{
-		const char* ps = (const char*)rmlist;
-		bool b = false;
-		while (*ps)
-		{
-			if (*p1 == *ps)
-			{
-				b = true;
-				break;
-			}
-			++ps;
-		}
-		if (!b)
-		{
-			*p2 = *p1;
-			++p2;
-		}
-		++p1;
-	}
-	*p2 = '\0';
+	p[qn_strnrem(p, strlen(p), rmlist)] = '\0';
 	return p;
 }
 
+//
+size_t qn_strnrem(char* p, size_t len, const char* rmlist)
+{
+	_str_check_up();
+	StrSet set;
+	_str_set_init(&set, rmlist, false);
+	return _str_nrem((byte*)p, len, &set);
+}
+
 //
 char* qn_strupr(char* p)
 {
-	for (char* s = p; *s; ++s)
-		if ((*s >= 'a') && (*s <= 'z'))
-			*s -= 'a' - 'A';
+	return qn_strnupr(p, strlen(p));
+}
+
+//
+char* qn_strnupr(char* p, size_t len)
+{
+	_str_check_up();
+	_str_case((byte*)p, len, 'a');
 	return p;
 }
 
 //
 char* qn_strlwr(char* p)
 {
-	for (char* s = p; *s; ++s)
-		if ((*s >= 'A') && (*s <= 'Z'))
-			*s += 'a' - 'A';
+	return qn_strnlwr(p, strlen(p));
+}
+
+//
+char* qn_strnlwr(char* p, size_t len)
+{
+	_str_check_up();
+	_str_case((byte*)p, len, 'A');
 	return p;
 }
 
@@ -1011,174 +3616,165 @@ llong qn_strtoll(const char* p, const uint base)
 	return sign * (llong)v;
 }
 
+// 정확한 곱하기 나누기로 끝나는 10의 거듭제곱
+static const double num_pow10_table[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+static const float num_pow10f_table[] =
+{
+	1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+};
+
 //
 float qn_strtof(const char* p)
 {
-	float f = 0.0f;
-	int rsign = 1;
-	int e = 0;
-	int ch;
-	while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t') ++p;
-	if (*p == '+')
-		p++;
-	else if (*p == '-')
-	{
-		rsign = -1;
-		p++;
-	}
-	while ((ch = (int)*p++) != '\0' && isdigit(ch))
-		f = f * 10.0f + (float)(ch - '0');
-	if (ch == '.')
-	{
-		while ((ch = (int)*p++) != '\0' && isdigit(ch))
-		{
-			f = f * 10.0f + (float)(ch - '0');
-			e--;
-		}
-	}
-	if (ch == 'e' || ch == 'E')
+	qn_return_when_fail(p != NULL, 0.0f);
+	NumText t;
+	if (_num_scan(p, &t) == false)
 	{
-		int sign = 1;
-		int n = 0;
-		ch = (int)*p++;
-		if (ch == '+')
-			ch = (int)*p++;
-		else if (ch == '-')
-		{
-			ch = (int)*p++;
-			sign = -1;
-		}
-		while (isdigit(ch))
-		{
-			n = n * 10 + (ch - '0');
-			ch = (int)*p++;
-		}
-		e += n * sign;
+		double special;
+		return _num_scan_special(&t, &special) ? (float)special : 0.0f;
 	}
-	while (e > 0)
+	float value;
+	ullong bits, check;
+	if (t.many == false && t.w <= (1ULL << 24) && t.q >= -10 && t.q <= 10)
 	{
-		f *= 10.0f;
-		e--;
+		value = (float)t.w;
+		value = t.q < 0 ? value / num_pow10f_table[-t.q] : value * num_pow10f_table[t.q];
 	}
-	while (e < 0)
+	else if (_num_lemire(t.w, t.q, 23, 127, &bits) &&
+		(t.many == false || (_num_lemire(t.w + 1, t.q, 23, 127, &check) && check == bits)))
 	{
-		f *= 0.1f;
-		e++;
+		const uint u = (uint)bits;
+		memcpy(&value, &u, sizeof(float));
 	}
-	return rsign < 0 ? -f : f;
+	else
+		value = (float)_num_scan_slow(&t, true);
+	return t.negative ? -value : value;
 }
 
 //
 double qn_strtod(const char* p)
 {
-	double d = 0.0;
-	int rsign = 1;
-	int e = 0;
-	int ch;
-	while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t') ++p;
-	if (*p == '+')
-		p++;
-	else if (*p == '-')
+	qn_return_when_fail(p != NULL, 0.0);
+	NumText t;
+	double value;
+	if (_num_scan(p, &t) == false)
+		return _num_scan_special(&t, &value) ? value : 0.0;
+	ullong bits, check;
+	if (t.many == false && t.w <= (1ULL << 53) && t.q >= -22 && t.q <= 22)
 	{
-		rsign = -1;
-		p++;
+		value = (double)t.w;
+		value = t.q < 0 ? value / num_pow10_table[-t.q] : value * num_pow10_table[t.q];
 	}
-	while ((ch = (int)*p++) != '\0' && isdigit(ch))
-		d = d * 10.0 + (ch - '0');
-	if (ch == '.')
+	else if (_num_lemire(t.w, t.q, 52, 1023, &bits) &&
+		(t.many == false || (_num_lemire(t.w + 1, t.q, 52, 1023, &check) && check == bits)))
+		memcpy(&value, &bits, sizeof(double));
+	else
+		value = _num_scan_slow(&t, false);
+	return t.negative ? -value : value;
+}
+
+//
+int qn_itoa(char* p, const int n, const uint base, bool upper)
+{
+	qn_return_when_fail(base >= 2 && base <= 32, -1);
+	char conv[40];
+	char* end = conv + QN_COUNTOF(conv);
+	char* s;
+	if (n >= 0 || base != 10)
+		s = qn_num_utoa(end, (uint)n, base, upper);
+	else
 	{
-		while ((ch = (int)*p++) != '\0' && isdigit(ch))
-		{
-			d = d * 10.0 + (ch - '0');
-			e--;
-		}
+		s = qn_num_utoa(end, 0U - (uint)n, base, upper);
+		*--s = '-';
 	}
-	if (ch == 'e' || ch == 'E')
+	const int len = (int)(end - s);
+	if (p != NULL)
 	{
-		int sign = 1;
-		int n = 0;
-		ch = (int)*p++;
-		if (ch == '+')
-			ch = (int)*p++;
-		else if (ch == '-')
-		{
-			ch = (int)*p++;
-			sign = -1;
-		}
-		while (isdigit(ch))
-		{
-			n = n * 10 + (ch - '0');
-			ch = (int)*p++;
-		}
-		e += n * sign;
+		memcpy(p, s, (size_t)len);
+		p[len] = '\0';
 	}
-	while (e > 0)
+	return len;
+}
+
+//
+int qn_lltoa(char* p, const llong n, const uint base, bool upper)
+{
+	qn_return_when_fail(base >= 2 && base <= 32, -1);
+	char conv[72];
+	char* end = conv + QN_COUNTOF(conv);
+	char* s;
+	if (n >= 0 || base != 10)
+		s = qn_num_utoa(end, (ullong)n, base, upper);
+	else
 	{
-		d *= 10.0;
-		e--;
+		s = qn_num_utoa(end, 0ULL - (ullong)n, base, upper);
+		*--s = '-';
 	}
-	while (e < 0)
+	const int len = (int)(end - s);
+	if (p != NULL)
 	{
-		d *= 0.1;
-		e++;
+		memcpy(p, s, (size_t)len);
+		p[len] = '\0';
 	}
-	return rsign < 0 ? -d : d;
+	return len;
 }
 
 //
-int qn_itoa(char* p, const int n, const uint base, bool upper)
+int qn_ftoa(char* p, const float value)
 {
-	qn_return_when_fail(base <= 32, -1);
-	const char* table = qn_char_base_table(upper);
 	char conv[32];
-	int place = 0;
-	uint uvalue;
-	if (n >= 0 || base != 10)
-		uvalue = (uint)n;
-	else
+	char* s = p != NULL ? p : conv;
+	uint bits;
+	memcpy(&bits, &value, sizeof(uint));
+	const bool negative = (bits >> 31) != 0;
+	bits &= ~(1U << 31);
+	if (bits >= 0x7F800000U)
+		return _num_special(s, negative, bits != 0x7F800000U);
+	char* d = s;
+	if (negative)
+		*d++ = '-';
+	if (bits == 0)
 	{
-		conv[place++] = '-';
-		uvalue = (uint)-n;
+		*d++ = '0';
+		*d = '\0';
+		return (int)(d - s);
 	}
-	do
-	{
-		conv[place++] = table[uvalue % base];
-		uvalue = uvalue / base;
-	} while (uvalue && place < (int)QN_COUNTOF(conv));
-	if (place == (int)QN_COUNTOF(conv))
-		place--;
-	conv[place] = '\0';
-	if (p != NULL)
-		qn_strcpy(p, conv);
-	return place;
+	int exp, point;
+	const uint shortest = _num_shortest32(bits, &exp);
+	char digits[16];
+	const int n = _num_put_digits(digits, shortest, exp, &point);
+	return (int)(d - s) + _num_layout(d, digits, n, point);
 }
 
 //
-int qn_lltoa(char* p, const llong n, const uint base, bool upper)
+int qn_dtoa(char* p, const double value)
 {
-	qn_return_when_fail(base <= 32, -1);
-	const char* table = qn_char_base_table(upper);
-	char conv[64];
-	int place = 0;
-	ullong uvalue;
-	if (n >= 0 || base != 10)
-		uvalue = (ullong)n;
-	else
+	char conv[32];
+	char* s = p != NULL ? p : conv;
+	ullong bits;
+	memcpy(&bits, &value, sizeof(ullong));
+	const bool negative = (bits >> 63) != 0;
+	bits &= ~(1ULL << 63);
+	if (bits >= 0x7FF0000000000000ULL)
+		return _num_special(s, negative, bits != 0x7FF0000000000000ULL);
+	char* d = s;
+	if (negative)
+		*d++ = '-';
+	if (bits == 0)
 	{
-		conv[place++] = '-';
-		uvalue = (ullong)-n;
+		*d++ = '0';
+		*d = '\0';
+		return (int)(d - s);
 	}
-	do
-	{
-		conv[place++] = table[uvalue % base];
-		uvalue = uvalue / base;
-	} while (uvalue && place < (int)QN_COUNTOF(conv));
-	if (place == (int)QN_COUNTOF(conv))
-		place--;
-	conv[place] = '\0';
-	if (p != NULL)
-		qn_strcpy(p, conv);
-	return place;
+	int exp, point;
+	const ullong shortest = _num_shortest64(bits, &exp);
+	char digits[24];
+	const int n = _num_put_digits(digits, shortest, exp, &point);
+	return (int)(d - s) + _num_layout(d, digits, n, point);
 }
 
 //
@@ -1195,7 +3791,11 @@ void qn_divpath(const char* p, char* dir, char* filename)
 	if (sep)
 	{
 		if (dir)
-			qn_strncpy(dir, p, sep - p + 1);
+		{
+			const size_t len = (size_t)(sep - p + 1);
+			memcpy(dir, p, len);
+			dir[len] = '\0';
+		}
 		if (filename)
 			qn_strcpy(filename, sep + 1);
 	}
@@ -1495,68 +4095,540 @@ size_t qn_u8lcpy(char* dest, const char* src, size_t len)
 	return len;
 }
 
-//
-int qn_u32ucb(uchar4 c, char* out)
+//
+int qn_u32ucb(uchar4 c, char* out)
+{
+	uchar4 first;
+	int len;
+
+	if (c < 0x80)
+	{
+		first = 0;
+		len = 1;
+	}
+	else if (c < 0x800)
+	{
+		first = 0xc0;
+		len = 2;
+	}
+	else if (c < 0x10000)
+	{
+		first = 0xe0;
+		len = 3;
+	}
+	else if (c < 0x200000)
+	{
+		first = 0xf0;
+		len = 4;
+	}
+	else if (c < 0x4000000)
+	{
+		first = 0xf8;
+		len = 5;
+	}
+	else
+	{
+		first = 0xfc;
+		len = 6;
+	}
+
+	if (out)
+	{
+		out[len] = '\0';
+		for (int i = len - 1; i > 0; --i)
+		{
+			out[i] = (char)((c & 0x3f) | 0x80);
+			c >>= 6;
+		}
+		out[0] = (char)(c | first);
+	}
+
+	return len;
+}
+
+// utf16 서로게이트를 ucs4로 바꿈
+static uchar4 _utf16_surrogate(const uchar2 h, const uchar2 l)
+{
+	return (((uchar4)h - 0xD800) * 0x0400 + (uchar4)l - 0xDC00 + 0x010000);
+}
+
+//
+int qn_u16ucb(const uchar2 high, const uchar2 low, char* out)
+{
+	const uchar4 ucs4 = _utf16_surrogate(high, low);
+	return qn_u32ucb(ucs4, out);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// 유니코드 검사
+// UTF-8 검사는 Keiser-Lemire 룩업 방식 (simdutf), x86은 SSSE3/AVX2를 런타임에 고르고 ARM은 NEON
+// 벡터에서 오류가 나오면 그 블럭에 걸친 글자부터 스칼라로 다시 보고 정확한 위치를 찾는다
+// 변환은 검사가 끝난 입력만 다루므로 ASCII 블럭은 벡터로 넓히거나 좁히고 나머지는 글자 단위
+
+#if defined STR_X86 || defined _QN_NEON_
+// 변환 셔플 표 만들기
+static void _utf_make_tables(void)
+{
+	for (uint mask = 0; mask < 4096; mask++)
+	{
+		byte shuf[16];
+		uint pos = 0, shape = 0, mul = 1, k;
+		for (k = 0; k < 4; k++)
+		{
+			uint end = pos;
+			while (end < 12 && (mask & (1U << end)) == 0)
+				end++;
+			const uint n = end - pos + 1;
+			if (end >= 12 || n > 3)
+				break;
+			// 레인에는 끝 바이트부터 거꾸로
+			shuf[k * 4 + 0] = (byte)end;
+			shuf[k * 4 + 1] = n >= 2 ? (byte)(end - 1) : 0x80;
+			shuf[k * 4 + 2] = n >= 3 ? (byte)(end - 2) : 0x80;
+			shuf[k * 4 + 3] = 0x80;
+			shape += (n - 1) * mul;
+			mul *= 3;
+			pos = end + 1;
+		}
+		if (k < 4)
+		{
+			str_impl.u8_shape[mask] = 0;
+			continue;
+		}
+		// 먹는 바이트를 같이 넣어 두면 다음 위치가 표 한번에 나온다
+		str_impl.u8_shape[mask] = (ushort)(shape | (pos << 8));
+		memcpy(str_impl.u8_shuf[shape], shuf, 16);
+	}
+
+	for (uint mask = 0; mask < 256; mask++)
+	{
+		byte* shuf = str_impl.u16_shuf[mask];
+		uint n = 0;
+		for (uint k = 0; k < 4; k++)
+		{
+			const uint len = (mask & (1U << k)) ? 1 : (mask & (16U << k)) ? 2 : 3;
+			for (uint b = 0; b < len; b++)
+				shuf[n++] = (byte)(k * 4 + b);
+		}
+		str_impl.u16_used[mask] = (byte)n;
+		for (; n < 16; n++)
+			shuf[n] = 0x80;
+	}
+}
+#endif
+
+// 널까지 길이, len이 0이 아니면 len 안에서 널까지
+static size_t _utf8_nlen(const char* s, const size_t len)
+{
+	if (len == 0)
+		return strlen(s);
+	const char* z = (const char*)memchr(s, '\0', len);
+	return z ? (size_t)(z - s) : len;
+}
+
+//
+static size_t _utf16_nlen(const uchar2* s, const size_t len)
+{
+	size_t n = 0;
+#if defined _QN_SSE2_
+	// 길이를 주었으면 그 안은 읽어도 되므로 8개씩 널을 찾는다
+	if (len != 0)
+	{
+		for (; n + 8 <= len; n += 8)
+		{
+			const __m128i v = _mm_loadu_si128((const __m128i*)(s + n));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi16(v, _mm_setzero_si128())) != 0)
+				break;
+		}
+	}
+#elif defined _QN_NEON_
+	if (len != 0)
+	{
+		for (; n + 8 <= len; n += 8)
+		{
+			if (vminvq_u16(vld1q_u16(s + n)) == 0)
+				break;
+		}
+	}
+#endif
+	for (; (len == 0 || n < len) && s[n]; n++) {}
+	return n;
+}
+
+//
+static size_t _utf32_nlen(const uchar4* s, const size_t len)
+{
+	size_t n;
+	for (n = 0; (len == 0 || n < len) && s[n]; n++) {}
+	return n;
+}
+
+// 스칼라 UTF-8 검사. 틀린 글자가 시작하는 위치, 다 맞으면 len
+static size_t _utf8_check_scalar(const byte* s, const size_t len)
+{
+	size_t i = 0;
+	while (i < len)
+	{
+		if (i + 8 <= len)
+		{
+			ullong v;
+			memcpy(&v, s + i, 8);
+			if ((v & 0x8080808080808080ULL) == 0)
+			{
+				i += 8;
+				continue;
+			}
+		}
+
+		const byte c = s[i];
+		if (c < 0x80)
+		{
+			i++;
+			continue;
+		}
+		if (c < 0xC2)
+			return i;		// 연속 바이트로 시작하거나 2바이트 오버롱
+		if (c < 0xE0)
+		{
+			if (i + 1 >= len || (s[i + 1] & 0xC0) != 0x80)
+				return i;
+			i += 2;
+		}
+		else if (c < 0xF0)
+		{
+			// E0은 A0부터 (오버롱), ED는 9F까지 (서로게이트)
+			const byte lo = c == 0xE0 ? 0xA0 : 0x80;
+			const byte hi = c == 0xED ? 0x9F : 0xBF;
+			if (i + 2 >= len || s[i + 1] < lo || s[i + 1] > hi || (s[i + 2] & 0xC0) != 0x80)
+				return i;
+			i += 3;
+		}
+		else if (c < 0xF5)
+		{
+			// F0은 90부터 (오버롱), F4는 8F까지 (U+10FFFF)
+			const byte lo = c == 0xF0 ? 0x90 : 0x80;
+			const byte hi = c == 0xF4 ? 0x8F : 0xBF;
+			if (i + 3 >= len || s[i + 1] < lo || s[i + 1] > hi || (s[i + 2] & 0xC0) != 0x80 || (s[i + 3] & 0xC0) != 0x80)
+				return i;
+			i += 4;
+		}
+		else
+			return i;
+	}
+	return len;
+}
+
+#if defined STR_X86 || defined _QN_NEON_
+// 룩업 비트. 앞 바이트 위 니블, 앞 바이트 아래 니블, 지금 바이트 위 니블 세 표를 AND해서 남는 비트가 오류
+#define U8_TOO_SHORT		(1 << 0)		// 리드 다음에 연속 바이트가 없음
+#define U8_TOO_LONG			(1 << 1)		// ASCII 다음에 연속 바이트
+#define U8_OVERLONG_3		(1 << 2)
+#define U8_TOO_LARGE		(1 << 3)
+#define U8_SURROGATE		(1 << 4)
+#define U8_OVERLONG_2		(1 << 5)
+#define U8_TOO_LARGE_1000	(1 << 6)
+#define U8_OVERLONG_4		(1 << 6)
+#define U8_TWO_CONTS		(1 << 7)		// 연속 바이트 둘, 3/4바이트 글자면 따로 지운다
+#define U8_CARRY			(U8_TOO_SHORT | U8_TOO_LONG | U8_TWO_CONTS)
+
+static const byte utf8_lookup_table[3][16] =
 {
-	uchar4 first;
-	int len;
-
-	if (c < 0x80)
+	// 앞 바이트 위 니블
 	{
-		first = 0;
-		len = 1;
-	}
-	else if (c < 0x800)
+		U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG,
+		U8_TWO_CONTS, U8_TWO_CONTS, U8_TWO_CONTS, U8_TWO_CONTS,
+		U8_TOO_SHORT | U8_OVERLONG_2,
+		U8_TOO_SHORT,
+		U8_TOO_SHORT | U8_OVERLONG_3 | U8_SURROGATE,
+		U8_TOO_SHORT | U8_TOO_LARGE | U8_TOO_LARGE_1000 | U8_OVERLONG_4,
+	},
+	// 앞 바이트 아래 니블
 	{
-		first = 0xc0;
-		len = 2;
-	}
-	else if (c < 0x10000)
+		U8_CARRY | U8_OVERLONG_3 | U8_OVERLONG_2 | U8_OVERLONG_4,
+		U8_CARRY | U8_OVERLONG_2,
+		U8_CARRY,
+		U8_CARRY,
+		U8_CARRY | U8_TOO_LARGE,
+		U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+		U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+		U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+		U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+		U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+		U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+		U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+		U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+		U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000 | U8_SURROGATE,
+		U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+		U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+	},
+	// 지금 바이트 위 니블
 	{
-		first = 0xe0;
-		len = 3;
+		U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+		U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_OVERLONG_3 | U8_TOO_LARGE_1000 | U8_OVERLONG_4,
+		U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_OVERLONG_3 | U8_TOO_LARGE,
+		U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_SURROGATE | U8_TOO_LARGE,
+		U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_SURROGATE | U8_TOO_LARGE,
+		U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+	},
+};
+
+// 블럭 끝에서 끝나지 않은 글자 찾기 (포화 뺄셈), 16바이트 블럭은 뒤쪽 절반을 쓴다
+static const byte utf8_incomplete_table[32] =
+{
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1,
+};
+#endif
+
+#if defined STR_X86
+// SSSE3, 16바이트씩. 오류가 없는 블럭까지의 길이를 반환
+STR_SSSE3 static size_t _utf8_check_ssse3(const byte* s, const size_t len)
+{
+	const __m128i t1h = _mm_loadu_si128((const __m128i*)utf8_lookup_table[0]);
+	const __m128i t1l = _mm_loadu_si128((const __m128i*)utf8_lookup_table[1]);
+	const __m128i t2h = _mm_loadu_si128((const __m128i*)utf8_lookup_table[2]);
+	const __m128i incomplete = _mm_loadu_si128((const __m128i*)(utf8_incomplete_table + 16));
+	const __m128i nibble = _mm_set1_epi8(0x0F);
+	const __m128i third = _mm_set1_epi8((char)(0xE0 - 0x80));
+	const __m128i fourth = _mm_set1_epi8((char)(0xF0 - 0x80));
+	const __m128i high = _mm_set1_epi8((char)0x80);
+	const __m128i zero = _mm_setzero_si128();
+	__m128i prev = zero, prev_incomplete = zero;
+
+	size_t i = 0;
+	for (; i + 16 <= len; i += 16)
+	{
+		const __m128i in = _mm_loadu_si128((const __m128i*)(s + i));
+		__m128i err;
+		if (_mm_movemask_epi8(in) == 0)
+		{
+			// ASCII 블럭은 앞 블럭이 끝났는지만 본다
+			err = prev_incomplete;
+			prev_incomplete = zero;
+		}
+		else
+		{
+			const __m128i prev1 = _mm_alignr_epi8(in, prev, 15);
+			const __m128i b1h = _mm_shuffle_epi8(t1h, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+			const __m128i b1l = _mm_shuffle_epi8(t1l, _mm_and_si128(prev1, nibble));
+			const __m128i b2h = _mm_shuffle_epi8(t2h, _mm_and_si128(_mm_srli_epi16(in, 4), nibble));
+			const __m128i sc = _mm_and_si128(_mm_and_si128(b1h, b1l), b2h);
+			const __m128i prev2 = _mm_alignr_epi8(in, prev, 14);
+			const __m128i prev3 = _mm_alignr_epi8(in, prev, 13);
+			const __m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, third), _mm_subs_epu8(prev3, fourth));
+			err = _mm_xor_si128(_mm_and_si128(must23, high), sc);
+			prev_incomplete = _mm_subs_epu8(in, incomplete);
+		}
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(err, zero)) != 0xFFFF)
+			break;
+		prev = in;
 	}
-	else if (c < 0x200000)
+	return i;
+}
+
+// AVX2, 32바이트씩
+STR_AVX2 static size_t _utf8_check_avx2(const byte* s, const size_t len)
+{
+	const __m256i t1h = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)utf8_lookup_table[0]));
+	const __m256i t1l = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)utf8_lookup_table[1]));
+	const __m256i t2h = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)utf8_lookup_table[2]));
+	const __m256i incomplete = _mm256_loadu_si256((const __m256i*)utf8_incomplete_table);
+	const __m256i nibble = _mm256_set1_epi8(0x0F);
+	const __m256i third = _mm256_set1_epi8((char)(0xE0 - 0x80));
+	const __m256i fourth = _mm256_set1_epi8((char)(0xF0 - 0x80));
+	const __m256i high = _mm256_set1_epi8((char)0x80);
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i prev = zero, prev_incomplete = zero;
+
+	size_t i = 0;
+	for (; i + 32 <= len; i += 32)
 	{
-		first = 0xf0;
-		len = 4;
+		const __m256i in = _mm256_loadu_si256((const __m256i*)(s + i));
+		__m256i err;
+		if (_mm256_movemask_epi8(in) == 0)
+		{
+			err = prev_incomplete;
+			prev_incomplete = zero;
+		}
+		else
+		{
+			// 레인을 건너는 alignr이 없으므로 앞 블럭 위 레인과 지금 블럭 아래 레인을 먼저 붙인다
+			const __m256i cross = _mm256_permute2x128_si256(prev, in, 0x21);
+			const __m256i prev1 = _mm256_alignr_epi8(in, cross, 15);
+			const __m256i b1h = _mm256_shuffle_epi8(t1h, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+			const __m256i b1l = _mm256_shuffle_epi8(t1l, _mm256_and_si256(prev1, nibble));
+			const __m256i b2h = _mm256_shuffle_epi8(t2h, _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble));
+			const __m256i sc = _mm256_and_si256(_mm256_and_si256(b1h, b1l), b2h);
+			const __m256i prev2 = _mm256_alignr_epi8(in, cross, 14);
+			const __m256i prev3 = _mm256_alignr_epi8(in, cross, 13);
+			const __m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, third), _mm256_subs_epu8(prev3, fourth));
+			err = _mm256_xor_si256(_mm256_and_si256(must23, high), sc);
+			prev_incomplete = _mm256_subs_epu8(in, incomplete);
+		}
+		if (!_mm256_testz_si256(err, err))
+			break;
+		prev = in;
 	}
-	else if (c < 0x4000000)
+	return i;
+}
+#elif defined _QN_NEON_
+// NEON, 16바이트씩
+static size_t _utf8_check_neon(const byte* s, const size_t len)
+{
+	const uint8x16_t t1h = vld1q_u8(utf8_lookup_table[0]);
+	const uint8x16_t t1l = vld1q_u8(utf8_lookup_table[1]);
+	const uint8x16_t t2h = vld1q_u8(utf8_lookup_table[2]);
+	const uint8x16_t incomplete = vld1q_u8(utf8_incomplete_table + 16);
+	const uint8x16_t nibble = vdupq_n_u8(0x0F);
+	const uint8x16_t third = vdupq_n_u8(0xE0 - 0x80);
+	const uint8x16_t fourth = vdupq_n_u8(0xF0 - 0x80);
+	const uint8x16_t high = vdupq_n_u8(0x80);
+	const uint8x16_t zero = vdupq_n_u8(0);
+	uint8x16_t prev = zero, prev_incomplete = zero;
+
+	size_t i = 0;
+	for (; i + 16 <= len; i += 16)
 	{
-		first = 0xf8;
-		len = 5;
+		const uint8x16_t in = vld1q_u8(s + i);
+		uint8x16_t err;
+		if (vmaxvq_u8(in) < 0x80)
+		{
+			err = prev_incomplete;
+			prev_incomplete = zero;
+		}
+		else
+		{
+			const uint8x16_t prev1 = vextq_u8(prev, in, 15);
+			const uint8x16_t b1h = vqtbl1q_u8(t1h, vshrq_n_u8(prev1, 4));
+			const uint8x16_t b1l = vqtbl1q_u8(t1l, vandq_u8(prev1, nibble));
+			const uint8x16_t b2h = vqtbl1q_u8(t2h, vshrq_n_u8(in, 4));
+			const uint8x16_t sc = vandq_u8(vandq_u8(b1h, b1l), b2h);
+			const uint8x16_t prev2 = vextq_u8(prev, in, 14);
+			const uint8x16_t prev3 = vextq_u8(prev, in, 13);
+			const uint8x16_t must23 = vorrq_u8(vqsubq_u8(prev2, third), vqsubq_u8(prev3, fourth));
+			err = veorq_u8(vandq_u8(must23, high), sc);
+			prev_incomplete = vqsubq_u8(in, incomplete);
+		}
+		if (vmaxvq_u8(err) != 0)
+			break;
+		prev = in;
 	}
-	else
+	return i;
+}
+#endif
+
+// UTF-8 검사. 틀린 글자가 시작하는 위치, 다 맞으면 len
+static size_t _utf8_check(const byte* s, const size_t len)
+{
+	size_t at = 0;
+#if defined STR_X86
+	if (str_impl.inited == false)
+		qn_str_up();
+	if (str_impl.avx2)
+		at = _utf8_check_avx2(s, len);
+	else if (str_impl.ssse3)
+		at = _utf8_check_ssse3(s, len);
+#elif defined _QN_NEON_
+	at = _utf8_check_neon(s, len);
+#endif
+	// 벡터가 멈춘 블럭에 걸친 글자의 첫 바이트로 돌아가서 나머지는 스칼라로
+	size_t pos = at;
+	for (size_t n = 1; n <= 3 && n <= at; n++)
 	{
-		first = 0xfc;
-		len = 6;
+		if ((s[at - n] & 0xC0) != 0x80)
+		{
+			pos = at - n;
+			break;
+		}
 	}
+	return pos + _utf8_check_scalar(s + pos, len - pos);
+}
 
-	if (out)
+// UTF-16 검사. 짝이 안 맞는 서로게이트 위치, 다 맞으면 len
+static size_t _utf16_check(const uchar2* s, const size_t len)
+{
+	size_t i = 0;
+	while (i < len)
 	{
-		out[len] = '\0';
-		for (int i = len - 1; i > 0; --i)
+#if defined _QN_SSE2_
+		if (i + 8 <= len)
 		{
-			out[i] = (char)((c & 0x3f) | 0x80);
-			c >>= 6;
+			const __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+			const __m128i sur = _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16((short)0xF800)), _mm_set1_epi16((short)0xD800));
+			if (_mm_movemask_epi8(sur) == 0)
+			{
+				i += 8;
+				continue;
+			}
 		}
-		out[0] = (char)(c | first);
+#elif defined _QN_NEON_
+		if (i + 8 <= len)
+		{
+			const uint16x8_t v = vld1q_u16(s + i);
+			if (vmaxvq_u16(vceqq_u16(vandq_u16(v, vdupq_n_u16(0xF800)), vdupq_n_u16(0xD800))) == 0)
+			{
+				i += 8;
+				continue;
+			}
+		}
+#endif
+		const uchar2 c = s[i];
+		if ((c & 0xF800) != 0xD800)
+			i++;
+		else if (c < 0xDC00 && i + 1 < len && (s[i + 1] & 0xFC00) == 0xDC00)
+			i += 2;
+		else
+			return i;
 	}
+	return len;
+}
 
+// UCS-4 검사. 서로게이트거나 U+10FFFF 넘는 글자 위치, 다 맞으면 len
+static size_t _utf32_check(const uchar4* s, const size_t len)
+{
+	for (size_t i = 0; i < len; i++)
+	{
+		const uchar4 c = s[i];
+		if (c >= 0x110000 || (c & 0xFFFFF800) == 0xD800)
+			return i;
+	}
 	return len;
 }
 
-// utf16 서로게이트를 ucs4로 바꿈
-static uchar4 _utf16_surrogate(const uchar2 h, const uchar2 l)
+//
+bool qn_u8valid(const char* src, const size_t srclen, size_t* error_offset)
 {
-	return (((uchar4)h - 0xD800) * 0x0400 + (uchar4)l - 0xDC00 + 0x010000);
+	qn_return_when_fail(src, false);
+	const size_t len = srclen == 0 ? strlen(src) : srclen;
+	const size_t at = _utf8_check((const byte*)src, len);
+	if (error_offset)
+		*error_offset = at;
+	return at == len;
 }
 
 //
-int qn_u16ucb(const uchar2 high, const uchar2 low, char* out)
+bool qn_u16valid(const uchar2* src, size_t srclen, size_t* error_offset)
 {
-	const uchar4 ucs4 = _utf16_surrogate(high, low);
-	return qn_u32ucb(ucs4, out);
+	qn_return_when_fail(src, false);
+	if (srclen == 0)
+		srclen = _utf16_nlen(src, 0);
+	const size_t at = _utf16_check(src, srclen);
+	if (error_offset)
+		*error_offset = at;
+	return at == srclen;
+}
+
+//
+bool qn_u32valid(const uchar4* src, size_t srclen, size_t* error_offset)
+{
+	qn_return_when_fail(src, false);
+	if (srclen == 0)
+		srclen = _utf32_nlen(src, 0);
+	const size_t at = _utf32_check(src, srclen);
+	if (error_offset)
+		*error_offset = at;
+	return at == srclen;
 }
 
 
@@ -1595,538 +4667,864 @@ size_t qn_wcstombs(char* outmbs, const size_t outsize, const wchar* inwcs, const
 #endif
 }
 
-//
-size_t qn_u8to32(uchar4* dest, const size_t destsize, const char* src, const size_t srclen)
+// 검사한 UTF-8에서 글자 하나
+FINLINE uchar4 _utf8_take(const byte* s, size_t* pi)
 {
-	qn_return_when_fail(src, 0);
+	const size_t i = *pi;
+	const uchar4 c = s[i];
+	if (c < 0x80)
+	{
+		*pi = i + 1;
+		return c;
+	}
+	if (c < 0xE0)
+	{
+		*pi = i + 2;
+		return ((c & 0x1F) << 6) | (s[i + 1] & 0x3F);
+	}
+	if (c < 0xF0)
+	{
+		*pi = i + 3;
+		return ((c & 0x0F) << 12) | ((uchar4)(s[i + 1] & 0x3F) << 6) | (s[i + 2] & 0x3F);
+	}
+	*pi = i + 4;
+	return ((c & 0x07) << 18) | ((uchar4)(s[i + 1] & 0x3F) << 12) | ((uchar4)(s[i + 2] & 0x3F) << 6) | (s[i + 3] & 0x3F);
+}
 
-	if (dest == NULL || destsize == 0)
+// 글자 하나를 UTF-8로. 자리가 모자라면 거짓
+FINLINE bool _utf8_put(char* d, const size_t dsize, size_t* po, const uchar4 c)
+{
+	size_t o = *po;
+	if (c < 0x80)
+	{
+		if (o + 1 > dsize)
+			return false;
+		d[o++] = (char)c;
+	}
+	else if (c < 0x800)
+	{
+		if (o + 2 > dsize)
+			return false;
+		d[o++] = (char)(0xC0 | (c >> 6));
+		d[o++] = (char)(0x80 | (c & 0x3F));
+	}
+	else if (c < 0x10000)
+	{
+		if (o + 3 > dsize)
+			return false;
+		d[o++] = (char)(0xE0 | (c >> 12));
+		d[o++] = (char)(0x80 | ((c >> 6) & 0x3F));
+		d[o++] = (char)(0x80 | (c & 0x3F));
+	}
+	else
+	{
+		if (o + 4 > dsize)
+			return false;
+		d[o++] = (char)(0xF0 | (c >> 18));
+		d[o++] = (char)(0x80 | ((c >> 12) & 0x3F));
+		d[o++] = (char)(0x80 | ((c >> 6) & 0x3F));
+		d[o++] = (char)(0x80 | (c & 0x3F));
+	}
+	*po = o;
+	return true;
+}
+
+// 글자 하나를 UTF-16으로. 자리가 모자라면 거짓
+FINLINE bool _utf16_put(uchar2* d, const size_t dsize, size_t* po, const uchar4 c)
+{
+	size_t o = *po;
+	if (c < 0x10000)
 	{
-		// utf-8 -> ucs-4의 길이는.... 그냥 utf-8의 길이.
-		return qn_u8len(src);
+		if (o + 1 > dsize)
+			return false;
+		d[o++] = (uchar2)c;
 	}
 	else
 	{
-		const size_t slen = srclen == 0 ? qn_u8len(src) : srclen;
-		const size_t size = QN_MIN(destsize - 1, slen);
+		if (o + 2 > dsize)
+			return false;
+		d[o++] = (uchar2)(((c - 0x10000) >> 10) + 0xD800);
+		d[o++] = (uchar2)(((c - 0x10000) & 0x3FF) + 0xDC00);
+	}
+	*po = o;
+	return true;
+}
+
+#if defined STR_SIMD
+#if defined _QN_NEON_
+// NEON에는 movemask가 없으니 비트를 더해서 만든다
+FINLINE uint _utf_neon_mask16(const uint8x16_t m)
+{
+	static const byte bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+	const uint8x16_t t = vandq_u8(m, vld1q_u8(bits));
+	return (uint)vaddv_u8(vget_low_u8(t)) | ((uint)vaddv_u8(vget_high_u8(t)) << 8);
+}
+#endif
+
+// 16바이트를 UTF-16으로 넓혀 넣고 앞쪽 ASCII 갯수를 반환. 대상은 늘 16칸을 쓴다
+FINLINE size_t _utf8_ascii_to16(uchar2* d, const byte* s)
+{
+#if defined _QN_SSE2_
+	const __m128i v = _mm_loadu_si128((const __m128i*)s);
+	const __m128i z = _mm_setzero_si128();
+	_mm_storeu_si128((__m128i*)d, _mm_unpacklo_epi8(v, z));
+	_mm_storeu_si128((__m128i*)(d + 8), _mm_unpackhi_epi8(v, z));
+	const uint mask = (uint)_mm_movemask_epi8(v);
+#else
+	const uint8x16_t v = vld1q_u8(s);
+	vst1q_u16(d, vmovl_u8(vget_low_u8(v)));
+	vst1q_u16(d + 8, vmovl_high_u8(v));
+	const uint mask = vmaxvq_u8(v) < 0x80 ? 0 : _utf_neon_mask16(vcgeq_u8(v, vdupq_n_u8(0x80)));
+#endif
+	return mask == 0 ? 16 : qn_ctz32(mask);
+}
+
+// 16바이트를 UCS-4로 넓혀 넣고 앞쪽 ASCII 갯수를 반환
+FINLINE size_t _utf8_ascii_to32(uchar4* d, const byte* s)
+{
+#if defined _QN_SSE2_
+	const __m128i v = _mm_loadu_si128((const __m128i*)s);
+	const __m128i z = _mm_setzero_si128();
+	const __m128i lo = _mm_unpacklo_epi8(v, z), hi = _mm_unpackhi_epi8(v, z);
+	_mm_storeu_si128((__m128i*)d, _mm_unpacklo_epi16(lo, z));
+	_mm_storeu_si128((__m128i*)(d + 4), _mm_unpackhi_epi16(lo, z));
+	_mm_storeu_si128((__m128i*)(d + 8), _mm_unpacklo_epi16(hi, z));
+	_mm_storeu_si128((__m128i*)(d + 12), _mm_unpackhi_epi16(hi, z));
+	const uint mask = (uint)_mm_movemask_epi8(v);
+#else
+	const uint8x16_t v = vld1q_u8(s);
+	const uint16x8_t lo = vmovl_u8(vget_low_u8(v)), hi = vmovl_high_u8(v);
+	vst1q_u32(d, vmovl_u16(vget_low_u16(lo)));
+	vst1q_u32(d + 4, vmovl_high_u16(lo));
+	vst1q_u32(d + 8, vmovl_u16(vget_low_u16(hi)));
+	vst1q_u32(d + 12, vmovl_high_u16(hi));
+	const uint mask = vmaxvq_u8(v) < 0x80 ? 0 : _utf_neon_mask16(vcgeq_u8(v, vdupq_n_u8(0x80)));
+#endif
+	return mask == 0 ? 16 : qn_ctz32(mask);
+}
+
+// UTF-16 16개를 바이트로 좁혀 넣고 앞쪽 ASCII 갯수를 반환
+FINLINE size_t _utf16_ascii_to8(char* d, const uchar2* s)
+{
+#if defined _QN_SSE2_
+	const __m128i a = _mm_loadu_si128((const __m128i*)s);
+	const __m128i b = _mm_loadu_si128((const __m128i*)(s + 8));
+	const __m128i m = _mm_set1_epi16((short)0xFF80), z = _mm_setzero_si128();
+	_mm_storeu_si128((__m128i*)d, _mm_packus_epi16(a, b));
+	const __m128i ascii = _mm_packs_epi16(_mm_cmpeq_epi16(_mm_and_si128(a, m), z), _mm_cmpeq_epi16(_mm_and_si128(b, m), z));
+	const uint mask = (uint)_mm_movemask_epi8(ascii) ^ 0xFFFF;
+#else
+	const uint16x8_t a = vld1q_u16(s), b = vld1q_u16(s + 8);
+	vst1q_u8((byte*)d, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+	const uint16x8_t lim = vdupq_n_u16(0x80);
+	const uint mask = vmaxvq_u16(vorrq_u16(a, b)) < 0x80 ? 0 :
+		_utf_neon_mask16(vcombine_u8(vmovn_u16(vcgeq_u16(a, lim)), vmovn_u16(vcgeq_u16(b, lim))));
+#endif
+	return mask == 0 ? 16 : qn_ctz32(mask);
+}
+
+// 서로게이트 없는 UTF-16 8개를 UCS-4로 넓힘
+FINLINE bool _utf16_bmp_to32(uchar4* d, const uchar2* s)
+{
+#if defined _QN_SSE2_
+	const __m128i v = _mm_loadu_si128((const __m128i*)s);
+	const __m128i sur = _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16((short)0xF800)), _mm_set1_epi16((short)0xD800));
+	if (_mm_movemask_epi8(sur) != 0)
+		return false;
+	const __m128i z = _mm_setzero_si128();
+	_mm_storeu_si128((__m128i*)d, _mm_unpacklo_epi16(v, z));
+	_mm_storeu_si128((__m128i*)(d + 4), _mm_unpackhi_epi16(v, z));
+#else
+	const uint16x8_t v = vld1q_u16(s);
+	if (vmaxvq_u16(vceqq_u16(vandq_u16(v, vdupq_n_u16(0xF800)), vdupq_n_u16(0xD800))) != 0)
+		return false;
+	vst1q_u32(d, vmovl_u16(vget_low_u16(v)));
+	vst1q_u32(d + 4, vmovl_high_u16(v));
+#endif
+	return true;
+}
+
+// U+FFFF 아래 UCS-4 8개를 UTF-16으로 좁힘 (검사를 거쳤으므로 서로게이트는 없다)
+FINLINE bool _utf32_bmp_to16(uchar2* d, const uchar4* s)
+{
+#if defined _QN_SSE2_
+	__m128i a = _mm_loadu_si128((const __m128i*)s);
+	__m128i b = _mm_loadu_si128((const __m128i*)(s + 4));
+	const __m128i z = _mm_setzero_si128();
+	if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(_mm_or_si128(a, b), 16), z)) != 0xFFFF)
+		return false;
+	// packs는 부호 포화라서 아래 16비트를 부호 확장해 두고 묶는다
+	a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+	b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+	_mm_storeu_si128((__m128i*)d, _mm_packs_epi32(a, b));
+#else
+	const uint32x4_t a = vld1q_u32(s), b = vld1q_u32(s + 4);
+	if (vmaxvq_u32(vorrq_u32(a, b)) >= 0x10000)
+		return false;
+	vst1q_u16(d, vcombine_u16(vmovn_u32(a), vmovn_u32(b)));
+#endif
+	return true;
+}
+
+// ASCII UCS-4 16개를 UTF-8로 좁힘
+FINLINE bool _utf32_ascii_to8(char* d, const uchar4* s)
+{
+#if defined _QN_SSE2_
+	const __m128i a = _mm_loadu_si128((const __m128i*)s);
+	const __m128i b = _mm_loadu_si128((const __m128i*)(s + 4));
+	const __m128i c = _mm_loadu_si128((const __m128i*)(s + 8));
+	const __m128i e = _mm_loadu_si128((const __m128i*)(s + 12));
+	const __m128i t = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, e)), _mm_set1_epi32(~0x7F));
+	if (_mm_movemask_epi8(_mm_cmpeq_epi32(t, _mm_setzero_si128())) != 0xFFFF)
+		return false;
+	_mm_storeu_si128((__m128i*)d, _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, e)));
+#else
+	const uint32x4_t a = vld1q_u32(s), b = vld1q_u32(s + 4), c = vld1q_u32(s + 8), e = vld1q_u32(s + 12);
+	if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, e))) >= 0x80)
+		return false;
+	const uint16x8_t lo = vcombine_u16(vmovn_u32(a), vmovn_u32(b)), hi = vcombine_u16(vmovn_u32(c), vmovn_u32(e));
+	vst1q_u8((byte*)d, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+#endif
+	return true;
+}
+#endif
+
+// 검사한 UTF-8에서 글자 수, surrogate가 참이면 UTF-16 길이 (4바이트 글자는 둘)
+static size_t _utf8_count(const byte* s, const size_t len, const bool surrogate)
+{
+	size_t cnt = 0, i = 0;
+#if defined STR_SIMD
+	// 바이트 단위로 세다가 넘치기 전에 더한다. 바이트마다 최대 2씩 늘어난다
+	while (i + 16 <= len)
+	{
+		const size_t end = i + QN_MIN((len - i) & ~(size_t)15, 16 * 127);
+#if defined _QN_SSE2_
+		const __m128i lead = _mm_set1_epi8(-65), four = _mm_set1_epi8((char)0xF0);
+		__m128i acc = _mm_setzero_si128();
+		for (; i < end; i += 16)
+		{
+			// 부호 있는 비교로 연속 바이트(0x80~0xBF)가 아닌 것, 부호 없는 최대값으로 0xF0 이상
+			const __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+			acc = _mm_sub_epi8(acc, _mm_cmpgt_epi8(v, lead));
+			if (surrogate)
+				acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(_mm_max_epu8(v, four), v));
+		}
+		const __m128i sum = _mm_sad_epu8(acc, _mm_setzero_si128());
+		cnt += (size_t)_mm_cvtsi128_si32(sum) + (size_t)_mm_extract_epi16(sum, 4);
+#else
+		const int8x16_t lead = vdupq_n_s8(-65);
+		const uint8x16_t four = vdupq_n_u8(0xF0);
+		uint8x16_t acc = vdupq_n_u8(0);
+		for (; i < end; i += 16)
+		{
+			const uint8x16_t v = vld1q_u8(s + i);
+			acc = vsubq_u8(acc, vcgtq_s8(vreinterpretq_s8_u8(v), lead));
+			if (surrogate)
+				acc = vsubq_u8(acc, vcgeq_u8(v, four));
+		}
+		cnt += vaddlvq_u8(acc);
+#endif
+	}
+#endif
+	for (; i < len; i++)
+	{
+		// 연속 바이트가 아니면 글자 하나
+		cnt += (s[i] & 0xC0) != 0x80;
+		if (surrogate)
+			cnt += s[i] >= 0xF0;
+	}
+	return cnt;
+}
+
+// 검사한 UTF-16을 UTF-8로 바꿀 때 길이
+static size_t _utf16_count8(const uchar2* s, const size_t len)
+{
+	size_t cnt = 0, i = 0;
+#if defined STR_SIMD
+	// 한 칸에 3을 두고 U+0080, U+0800 아래면 하나씩, 서로게이트 한 쪽도 하나 뺀다
+#if defined _QN_SSE2_
+	const __m128i m80 = _mm_set1_epi16((short)0xFF80), m800 = _mm_set1_epi16((short)0xF800), msur = _mm_set1_epi16((short)0xD800);
+	const __m128i three = _mm_set1_epi16(3), ones = _mm_set1_epi16(1), z = _mm_setzero_si128();
+	__m128i acc = z;
+	for (; i + 8 <= len; i += 8)
+	{
+		const __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+		const __m128i hi = _mm_and_si128(v, m800);
+		__m128i t = _mm_add_epi16(three, _mm_cmpeq_epi16(_mm_and_si128(v, m80), z));
+		t = _mm_add_epi16(t, _mm_cmpeq_epi16(hi, z));
+		t = _mm_add_epi16(t, _mm_cmpeq_epi16(hi, msur));
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(t, ones));
+	}
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+	cnt = (size_t)(uint)_mm_cvtsi128_si32(acc);
+#else
+	const uint16x8_t m80 = vdupq_n_u16(0xFF80), m800 = vdupq_n_u16(0xF800), msur = vdupq_n_u16(0xD800);
+	const uint16x8_t three = vdupq_n_u16(3), z = vdupq_n_u16(0);
+	uint32x4_t acc = vdupq_n_u32(0);
+	for (; i + 8 <= len; i += 8)
+	{
+		const uint16x8_t v = vld1q_u16(s + i);
+		const uint16x8_t hi = vandq_u16(v, m800);
+		uint16x8_t t = vaddq_u16(three, vceqq_u16(vandq_u16(v, m80), z));
+		t = vaddq_u16(t, vceqq_u16(hi, z));
+		t = vaddq_u16(t, vceqq_u16(hi, msur));
+		acc = vpadalq_u16(acc, t);
+	}
+	cnt = vaddvq_u32(acc);
+#endif
+#endif
+	for (; i < len; i++)
+	{
+		const uchar2 c = s[i];
+		cnt += c < 0x80 ? 1 : c < 0x800 || (c & 0xF800) == 0xD800 ? 2 : 3;
+	}
+	return cnt;
+}
+
+#if defined STR_X86
+// SSSE3, UTF-8 글자 넷을 UCS-4 넷으로. 먹은 바이트, 못하면 0 (4바이트 글자가 끼었을 때)
+STR_SSSE3 FINLINE size_t _utf8_decode4_ssse3(const byte* s, __m128i* out)
+{
+	const __m128i v = _mm_loadu_si128((const __m128i*)s);
+	const __m128i cont = _mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8((char)0xC0)), _mm_set1_epi8((char)0x80));
+	const uint ends = ~((uint)_mm_movemask_epi8(cont) >> 1) & 0xFFF;
+	const uint shape = str_impl.u8_shape[ends];
+	if (shape == 0)
+		return 0;
+	// 레인마다 끝 바이트부터 거꾸로 세 바이트, 위에서부터 4/6/7비트씩 모은다
+	const __m128i x = _mm_shuffle_epi8(v, _mm_loadu_si128((const __m128i*)str_impl.u8_shuf[shape & 0xFF]));
+	const __m128i a = _mm_and_si128(x, _mm_set1_epi32(0x7F));
+	const __m128i b = _mm_and_si128(_mm_srli_epi32(x, 2), _mm_set1_epi32(0xFC0));
+	const __m128i c = _mm_and_si128(_mm_srli_epi32(x, 4), _mm_set1_epi32(0xF000));
+	*out = _mm_or_si128(_mm_or_si128(a, b), c);
+	return shape >> 8;
+}
+
+// SSSE3, 서로게이트 없는 UTF-16 넷을 UTF-8로. 16바이트를 쓰고 쓴 길이를 반환
+STR_SSSE3 FINLINE size_t _utf16_encode4_ssse3(const uchar2* s, char* d)
+{
+	const __m128i u = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)s), _mm_setzero_si128());
+	const __m128i m3f = _mm_set1_epi32(0x3F), m80 = _mm_set1_epi32(0x80);
+	const __m128i tail = _mm_or_si128(_mm_and_si128(u, m3f), m80);
+	const __m128i mid = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(u, 6), m3f), m80);
+	const __m128i two = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(u, 6), _mm_set1_epi32(0xC0)), _mm_slli_epi32(tail, 8));
+	const __m128i three = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(u, 12), _mm_set1_epi32(0xE0)),
+		_mm_or_si128(_mm_slli_epi32(mid, 8), _mm_slli_epi32(tail, 16)));
+	const __m128i m1 = _mm_cmplt_epi32(u, m80);
+	const __m128i m2 = _mm_cmplt_epi32(u, _mm_set1_epi32(0x800));
+	const __m128i r = _mm_or_si128(_mm_and_si128(m1, u), _mm_andnot_si128(m1, _mm_or_si128(_mm_and_si128(m2, two), _mm_andnot_si128(m2, three))));
+	const uint shape = (uint)_mm_movemask_ps(_mm_castsi128_ps(m1)) | ((uint)_mm_movemask_ps(_mm_castsi128_ps(m2)) << 4);
+	_mm_storeu_si128((__m128i*)d, _mm_shuffle_epi8(r, _mm_loadu_si128((const __m128i*)str_impl.u16_shuf[shape])));
+	return str_impl.u16_used[shape];
+}
 
-		const char* t;
-		size_t i;
-		for (t = src, i = 0; i < size; i++)
+// SSSE3 UTF-8 -> UTF-16 본체. 끝 부분은 부른 쪽에서 한다
+STR_SSSE3 static void _utf8_to16_ssse3(uchar2* d, const size_t dsize, const byte* s, const size_t len, size_t* pi, size_t* po)
+{
+	const __m128i pack = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+	size_t i = *pi, o = *po;
+	while (i + 16 <= len && o + 16 <= dsize)
+	{
+		const size_t a = _utf8_ascii_to16(d + o, s + i);
+		if (a)
+		{
+			i += a;
+			o += a;
+			continue;
+		}
+		__m128i r;
+		const size_t n = _utf8_decode4_ssse3(s + i, &r);
+		if (n)
 		{
-			dest[i] = qn_u8cbn(t);
-			t = qn_u8nch(t);
+			_mm_storel_epi64((__m128i*)(d + o), _mm_shuffle_epi8(r, pack));
+			i += n;
+			o += 4;
 		}
+		else
+			_utf16_put(d, SIZE_MAX, &o, _utf8_take(s, &i));
+	}
+	*pi = i;
+	*po = o;
+}
 
-		dest[i] = (uchar4)'\0';
+// SSSE3 UTF-8 -> UCS-4 본체
+STR_SSSE3 static void _utf8_to32_ssse3(uchar4* d, const size_t dsize, const byte* s, const size_t len, size_t* pi, size_t* po)
+{
+	size_t i = *pi, o = *po;
+	while (i + 16 <= len && o + 16 <= dsize)
+	{
+		const size_t a = _utf8_ascii_to32(d + o, s + i);
+		if (a)
+		{
+			i += a;
+			o += a;
+			continue;
+		}
+		__m128i r;
+		const size_t n = _utf8_decode4_ssse3(s + i, &r);
+		if (n)
+		{
+			_mm_storeu_si128((__m128i*)(d + o), r);
+			i += n;
+			o += 4;
+		}
+		else
+			d[o++] = _utf8_take(s, &i);
+	}
+	*pi = i;
+	*po = o;
+}
 
-		return size;
+// SSSE3 UTF-16 -> UTF-8 본체
+STR_SSSE3 static void _utf16_to8_ssse3(char* d, const size_t dsize, const uchar2* s, const size_t len, size_t* pi, size_t* po)
+{
+	const __m128i m = _mm_set1_epi16((short)0xF800), sur = _mm_set1_epi16((short)0xD800);
+	size_t i = *pi, o = *po;
+	while (i + 16 <= len && o + 16 <= dsize)
+	{
+		const size_t a = _utf16_ascii_to8(d + o, s + i);
+		if (a)
+		{
+			i += a;
+			o += a;
+			continue;
+		}
+		const __m128i v = _mm_loadl_epi64((const __m128i*)(s + i));
+		if ((_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, m), sur)) & 0xFF) == 0)
+		{
+			o += _utf16_encode4_ssse3(s + i, d + o);
+			i += 4;
+		}
+		else if ((s[i] & 0xF800) == 0xD800)
+		{
+			_utf8_put(d, SIZE_MAX, &o, _utf16_surrogate(s[i], s[i + 1]));
+			i += 2;
+		}
+		else
+			_utf8_put(d, SIZE_MAX, &o, s[i++]);
 	}
+	*pi = i;
+	*po = o;
+}
+#elif defined _QN_NEON_
+// NEON, UTF-8 글자 넷을 UCS-4 넷으로
+FINLINE size_t _utf8_decode4_neon(const byte* s, uint32x4_t* out)
+{
+	const uint8x16_t v = vld1q_u8(s);
+	const uint8x16_t cont = vceqq_u8(vandq_u8(v, vdupq_n_u8(0xC0)), vdupq_n_u8(0x80));
+	const uint ends = ~(_utf_neon_mask16(cont) >> 1) & 0xFFF;
+	const uint shape = str_impl.u8_shape[ends];
+	if (shape == 0)
+		return 0;
+	const uint32x4_t x = vreinterpretq_u32_u8(vqtbl1q_u8(v, vld1q_u8(str_impl.u8_shuf[shape & 0xFF])));
+	const uint32x4_t a = vandq_u32(x, vdupq_n_u32(0x7F));
+	const uint32x4_t b = vandq_u32(vshrq_n_u32(x, 2), vdupq_n_u32(0xFC0));
+	const uint32x4_t c = vandq_u32(vshrq_n_u32(x, 4), vdupq_n_u32(0xF000));
+	*out = vorrq_u32(vorrq_u32(a, b), c);
+	return shape >> 8;
 }
 
-//
-size_t qn_u8to16(uchar2* dest, const size_t destsize, const char* src, const size_t srclen)
+// NEON, 서로게이트 없는 UTF-16 넷을 UTF-8로
+FINLINE size_t _utf16_encode4_neon(const uchar2* s, char* d)
 {
-	qn_return_when_fail(src, 0);
+	static const uint lanes[4] = { 1, 2, 4, 8 };
+	const uint32x4_t u = vmovl_u16(vld1_u16(s));
+	const uint32x4_t m3f = vdupq_n_u32(0x3F), m80 = vdupq_n_u32(0x80);
+	const uint32x4_t tail = vorrq_u32(vandq_u32(u, m3f), m80);
+	const uint32x4_t mid = vorrq_u32(vandq_u32(vshrq_n_u32(u, 6), m3f), m80);
+	const uint32x4_t two = vorrq_u32(vorrq_u32(vshrq_n_u32(u, 6), vdupq_n_u32(0xC0)), vshlq_n_u32(tail, 8));
+	const uint32x4_t three = vorrq_u32(vorrq_u32(vshrq_n_u32(u, 12), vdupq_n_u32(0xE0)),
+		vorrq_u32(vshlq_n_u32(mid, 8), vshlq_n_u32(tail, 16)));
+	const uint32x4_t m1 = vcltq_u32(u, m80);
+	const uint32x4_t m2 = vcltq_u32(u, vdupq_n_u32(0x800));
+	const uint32x4_t r = vbslq_u32(m1, u, vbslq_u32(m2, two, three));
+	const uint32x4_t bits = vld1q_u32(lanes);
+	const uint shape = vaddvq_u32(vandq_u32(m1, bits)) | (vaddvq_u32(vandq_u32(m2, bits)) << 4);
+	vst1q_u8((byte*)d, vqtbl1q_u8(vreinterpretq_u8_u32(r), vld1q_u8(str_impl.u16_shuf[shape])));
+	return str_impl.u16_used[shape];
+}
+#endif
+
+#if defined STR_SIMD
+// UTF-8 -> UTF-16 본체. SSE2만 있으면 ASCII 블럭만 벡터로
+static void _utf8_to16_bulk(uchar2* d, const size_t dsize, const byte* s, const size_t len, size_t* pi, size_t* po)
+{
+#if defined STR_X86
+	if (str_impl.ssse3)
+	{
+		_utf8_to16_ssse3(d, dsize, s, len, pi, po);
+		return;
+	}
+#endif
+	size_t i = *pi, o = *po;
+	while (i + 16 <= len && o + 16 <= dsize)
+	{
+		const size_t a = _utf8_ascii_to16(d + o, s + i);
+		if (a)
+		{
+			i += a;
+			o += a;
+			continue;
+		}
+#if defined _QN_NEON_
+		uint32x4_t r;
+		const size_t n = _utf8_decode4_neon(s + i, &r);
+		if (n)
+		{
+			vst1_u16(d + o, vmovn_u32(r));
+			i += n;
+			o += 4;
+			continue;
+		}
+#endif
+		_utf16_put(d, SIZE_MAX, &o, _utf8_take(s, &i));
+	}
+	*pi = i;
+	*po = o;
+}
 
-	if (dest == NULL || destsize == 0)
+// UTF-8 -> UCS-4 본체
+static void _utf8_to32_bulk(uchar4* d, const size_t dsize, const byte* s, const size_t len, size_t* pi, size_t* po)
+{
+#if defined STR_X86
+	if (str_impl.ssse3)
 	{
-		// utf-8 -> ucs-4의 길이는.... 그냥 utf-8의 길이.
-		// 다만 서로게이트 문제는 어떻게 하나... 일단 이걸로 하고 나중에 고치자
-		// .... 서로게이트 문제 원래 발생 안한다 [2024-01-12 kim]
-		return qn_u8len(src);
+		_utf8_to32_ssse3(d, dsize, s, len, pi, po);
+		return;
 	}
-	else
+#endif
+	size_t i = *pi, o = *po;
+	while (i + 16 <= len && o + 16 <= dsize)
 	{
-		const size_t slen = srclen == 0 ? qn_u8len(src) : srclen;
-		const size_t size = QN_MIN(destsize - 1, slen);
-
-		const char* t;
-		size_t i;
-		for (t = src, i = 0; i < size;)
+		const size_t a = _utf8_ascii_to32(d + o, s + i);
+		if (a)
 		{
-			const uchar4 ch = qn_u8cbn(t);
-
-			if (ch < 0x010000)
-				dest[i++] = (uchar2)ch;
-			else
-			{
-				dest[i++] = (uchar2)((ch - 0x010000) / 0x0400 + 0xD800);
-				dest[i++] = (uchar2)((ch - 0x010000) % 0x0400 + 0xDC00);
-			}
-
-			t = qn_u8nch(t);
+			i += a;
+			o += a;
+			continue;
 		}
-
-		dest[i] = (uchar2)'\0';
-
-		return size;
+#if defined _QN_NEON_
+		uint32x4_t r;
+		const size_t n = _utf8_decode4_neon(s + i, &r);
+		if (n)
+		{
+			vst1q_u32(d + o, r);
+			i += n;
+			o += 4;
+			continue;
+		}
+#endif
+		d[o++] = _utf8_take(s, &i);
 	}
+	*pi = i;
+	*po = o;
 }
 
-//
-size_t qn_u32to8(char* dest, size_t destsize, const uchar4* src, const size_t srclen)
+// UTF-16 -> UTF-8 본체
+static void _utf16_to8_bulk(char* d, const size_t dsize, const uchar2* s, const size_t len, size_t* pi, size_t* po)
 {
-	qn_return_when_fail(src, 0);
-
-	const nint slen = (nint)srclen;
-	size_t n, size;
-	intptr_t i;
-	uchar4 uc;
-
-	if (destsize > 0)
+#if defined STR_X86
+	if (str_impl.ssse3)
 	{
-		destsize--;
-		for (size = 0, i = 0; slen == 0 || i < slen; i++)
-		{
-			uc = src[i];
-
-			if (!uc)
-				break;
-
-			if ((uc & 0x80000000) != 0)	// if (uc >= 0x80000000)
-			{
-				// 변경할 수 없는 문자가 포함됨..
-				// 일단 그냥 못한다고 보내자
-				return 0;
-			}
-
-			n = (uc < 0x80) ? 1 :
-				(uc < 0x0800) ? 2 :
-				(uc < 0x010000) ? 3 :
-				(uc < 0x200000) ? 4 :
-				(uc < 0x04000000) ? 5 :
-				6;
-
-			const size_t z = size + n;
-
-			if (z > destsize)
-				break;
-
-			size = z;
-		}
+		_utf16_to8_ssse3(d, dsize, s, len, pi, po);
+		return;
 	}
-	else
+#endif
+	size_t i = *pi, o = *po;
+	while (i + 16 <= len && o + 16 <= dsize)
 	{
-		for (size = 0, i = 0; slen == 0 || i < slen; i++)
+		const size_t a = _utf16_ascii_to8(d + o, s + i);
+		if (a)
 		{
-			uc = src[i];
-
-			if (!uc)
-				break;
-
-			if ((uc & 0x80000000) != 0)	// if (uc >= 0x80000000)
-			{
-				// 변경할 수 없는 문자가 포함됨..
-				// 일단 그냥 못한다고 보내자
-				return 0;
-			}
-
-			n = (uc < 0x80) ? 1 :
-				(uc < 0x0800) ? 2 :
-				(uc < 0x010000) ? 3 :
-				(uc < 0x200000) ? 4 :
-				(uc < 0x04000000) ? 5 :
-				6;
-
-			size += n;
+			i += a;
+			o += a;
+			continue;
+		}
+#if defined _QN_NEON_
+		const uint16x4_t v = vld1_u16(s + i);
+		if (vmaxv_u16(vceq_u16(vand_u16(v, vdup_n_u16(0xF800)), vdup_n_u16(0xD800))) == 0)
+		{
+			o += _utf16_encode4_neon(s + i, d + o);
+			i += 4;
+			continue;
 		}
+#endif
+		if ((s[i] & 0xF800) == 0xD800)
+		{
+			_utf8_put(d, SIZE_MAX, &o, _utf16_surrogate(s[i], s[i + 1]));
+			i += 2;
+		}
+		else
+			_utf8_put(d, SIZE_MAX, &o, s[i++]);
 	}
+	*pi = i;
+	*po = o;
+}
+#endif
 
-	if (dest && destsize > 0)
+// 검사한 UTF-8을 UTF-16으로. 대상에 다 들어가는 글자까지만 넣고 넣은 길이를 반환
+static size_t _utf8_to16(uchar2* d, const size_t dsize, const byte* s, const size_t len)
+{
+	size_t i = 0, o = 0;
+#if defined STR_SIMD
+	_utf8_to16_bulk(d, dsize, s, len, &i, &o);
+#endif
+	while (i < len)
 	{
-		char* p = dest;
-
-		for (i = 0; p < (dest + size); i++)
-			p += qn_u32ucb(src[i], p);
-
-		*p = '\0';
+		size_t n = i;
+		if (!_utf16_put(d, dsize, &o, _utf8_take(s, &n)))
+			break;
+		i = n;
 	}
-
-	return size;
+	return o;
 }
 
-//
-size_t qn_u16to8(char* dest, size_t destsize, const uchar2* src, const size_t srclen)
+// 검사한 UTF-8을 UCS-4로
+static size_t _utf8_to32(uchar4* d, const size_t dsize, const byte* s, const size_t len)
 {
-	qn_return_when_fail(src, 0);
+	size_t i = 0, o = 0;
+#if defined STR_SIMD
+	_utf8_to32_bulk(d, dsize, s, len, &i, &o);
+#endif
+	while (i < len && o < dsize)
+		d[o++] = _utf8_take(s, &i);
+	return o;
+}
 
-	const uchar2* cp = src;
-	uchar4 hsg = 0;
-	size_t size = 0;
-	uchar4 uc;
-	uchar2 ch;
-	size_t n;
+// 검사한 UTF-16을 UTF-8로
+static size_t _utf16_to8(char* d, const size_t dsize, const uchar2* s, const size_t len)
+{
+	size_t i = 0, o = 0;
+#if defined STR_SIMD
+	_utf16_to8_bulk(d, dsize, s, len, &i, &o);
+#endif
+	while (i < len)
+	{
+		const uchar2 c = s[i];
+		const bool pair = (c & 0xF800) == 0xD800;
+		if (!_utf8_put(d, dsize, &o, pair ? _utf16_surrogate(c, s[i + 1]) : c))
+			break;
+		i += pair ? 2 : 1;
+	}
+	return o;
+}
 
-	if (destsize > 0)
+// 검사한 UTF-16을 UCS-4로
+static size_t _utf16_to32(uchar4* d, const size_t dsize, const uchar2* s, const size_t len)
+{
+	size_t i = 0, o = 0;
+	while (i < len)
 	{
-		destsize--;
-		for (; (srclen == 0 || (size_t)(cp - src) < srclen) && *cp; cp++)
+		size_t end = len;
+#if defined STR_SIMD
+		if (i + 8 <= len)
 		{
-			ch = *cp;
-
-			if (ch >= 0xDC00 && ch < 0xE000)
-			{
-				// 하위 서로게이트
-				if (hsg)
-				{
-					uc = _utf16_surrogate((uchar2)hsg, ch);
-					hsg = 0;
-				}
-				else
-				{
-					// 음... 변경할 수 없는 문자가 있네...
-					// 일단 못한다고 보내자
-					return 0;
-				}
-			}
-			else
+			if (o + 8 <= dsize && _utf16_bmp_to32(d + o, s + i))
 			{
-				// 일반
-				if (hsg)
-				{
-					// 상위 서로게이트가 있네?
-					// 일단.. 문제가 있다고 판단
-					return 0;
-				}
-
-				if (ch >= 0xD800 && ch < 0xDC00)
-				{
-					// 상위 서로게이트
-					hsg = ch;
-					continue;
-				}
-
-				uc = ch;
+				i += 8;
+				o += 8;
+				continue;
 			}
-
-			n = (uc < 0x80) ? 1 :
-				(uc < 0x0800) ? 2 :
-				(uc < 0x010000) ? 3 :
-				(uc < 0x200000) ? 4 :
-				(uc < 0x04000000) ? 5 :
-				6;
-
-			const size_t z = size + n;
-			if (z > destsize)
-				break;
-			size = z;
+			end = i + 8;
 		}
-	}
-	else
-	{
-		for (; (srclen == 0 || (size_t)(cp - src) < srclen) && *cp; cp++)
+#endif
+		do
 		{
-			ch = *cp;
-
-			if (ch >= 0xDC00 && ch < 0xE000)
+			if (o >= dsize)
+				return o;
+			const uchar2 c = s[i];
+			if ((c & 0xF800) != 0xD800)
 			{
-				// 하위 서로게이트
-				if (hsg)
-				{
-					uc = _utf16_surrogate((uchar2)hsg, ch);
-					hsg = 0;
-				}
-				else
-				{
-					// 음... 변경할 수 없는 문자가 있네...
-					// 일단 못한다고 보내자
-					return 0;
-				}
+				d[o++] = c;
+				i++;
 			}
 			else
 			{
-				// 일반
-				if (hsg)
-				{
-					// 상위 서로게이트가 있네?
-					// 일단.. 문제가 있다고 판단
-					return 0;
-				}
-
-				if (ch >= 0xD800 && ch < 0xDC00)
-				{
-					// 상위 서로게이트
-					hsg = ch;
-					continue;
-				}
-
-				uc = ch;
+				d[o++] = _utf16_surrogate(c, s[i + 1]);
+				i += 2;
 			}
-
-			n = (uc < 0x80) ? 1 :
-				(uc < 0x0800) ? 2 :
-				(uc < 0x010000) ? 3 :
-				(uc < 0x200000) ? 4 :
-				(uc < 0x04000000) ? 5 :
-				6;
-
-			size += n;
-		}
+		} while (i < end);
 	}
+	return o;
+}
 
-	if (hsg)
+// 검사한 UCS-4를 UTF-8로
+static size_t _utf32_to8(char* d, const size_t dsize, const uchar4* s, const size_t len)
+{
+	size_t i = 0, o = 0;
+	while (i < len)
 	{
-		// 하위 서로게이트가 남음...
-		// 못함
-		return 0;
+		size_t end = len;
+#if defined STR_SIMD
+		if (i + 16 <= len)
+		{
+			if (o + 16 <= dsize && _utf32_ascii_to8(d + o, s + i))
+			{
+				i += 16;
+				o += 16;
+				continue;
+			}
+			end = i + 16;
+		}
+#endif
+		for (; i < end; i++)
+		{
+			if (!_utf8_put(d, dsize, &o, s[i]))
+				return o;
+		}
 	}
+	return o;
+}
 
-	if (destsize > 0 && dest)
+// 검사한 UCS-4를 UTF-16으로
+static size_t _utf32_to16(uchar2* d, const size_t dsize, const uchar4* s, const size_t len)
+{
+	size_t i = 0, o = 0;
+	while (i < len)
 	{
-		char* p = dest;
-		hsg = 0;
-		cp = src;
-
-		for (; p < dest + size; cp++)
+		size_t end = len;
+#if defined STR_SIMD
+		if (i + 8 <= len)
 		{
-			ch = *cp;
-
-			if (ch >= 0xDC00 && ch < 0xE000)
-			{
-				// 하위 서로게이트
-				uc = _utf16_surrogate((uchar2)hsg, ch);
-				hsg = 0;
-			}
-			else if (ch >= 0xD800 && ch < 0xDC00)
+			if (o + 8 <= dsize && _utf32_bmp_to16(d + o, s + i))
 			{
-				// 상위 서로게이트
-				hsg = ch;
+				i += 8;
+				o += 8;
 				continue;
 			}
-			else
-			{
-				// 일반 글자
-				uc = ch;
-			}
-
-			p += qn_u32ucb(uc, p);
+			end = i + 8;
+		}
+#endif
+		for (; i < end; i++)
+		{
+			if (!_utf16_put(d, dsize, &o, s[i]))
+				return o;
 		}
-
-		*p = '\0';
 	}
-
-	return size;
+	return o;
 }
 
 //
-size_t qn_u16to32(uchar4* dest, size_t destsize, const uchar2* src, const size_t srclen)
+size_t qn_u8to32(uchar4* dest, const size_t destsize, const char* src, const size_t srclen)
 {
 	qn_return_when_fail(src, 0);
 
-	uchar4 hsg = 0;
-	size_t size = 0;
-
-	if (destsize > 0)
-	{
-		destsize--;
-		for (const uchar2* cp = src; (srclen == 0 || (size_t)(cp - src) < srclen) && *cp; cp++)
-		{
-			const uchar2 ch = *cp;
-
-			if (ch >= 0xDC00 && ch < 0xE000)
-			{
-				// 하위 서로게이트
-				if (hsg)
-				{
-					_utf16_surrogate((uchar2)hsg, ch);
-					hsg = 0;
-				}
-				else
-				{
-					// 음... 변경할 수 없는 문자가 있네...
-					// 일단 못한다고 보내자
-					return 0;
-				}
-			}
-			else
-			{
-				// 일반
-				if (hsg)
-				{
-					// 상위 서로게이트가 있네?
-					// 일단.. 문제가 있다고 판단
-					return 0;
-				}
-
-				if (ch >= 0xD800 && ch < 0xDC00)
-				{
-					// 상위 서로게이트
-					hsg = ch;
-					continue;
-				}
-			}
+	const byte* s = (const byte*)src;
+	const size_t len = _utf8_nlen(src, srclen);
+	if (_utf8_check(s, len) != len)
+		return 0;
 
-			const size_t z = size + 1;
+	if (dest == NULL || destsize == 0)
+		return _utf8_count(s, len, false);
 
-			if (z > destsize)
-				break;
+	const size_t size = _utf8_to32(dest, destsize - 1, s, len);
+	dest[size] = (uchar4)'\0';
+	return size;
+}
 
-			size = z;
-		}
-	}
-	else
-	{
-		for (const uchar2* cp = src; (srclen == 0 || (size_t)(cp - src) < srclen) && *cp; cp++)
-		{
-			const uchar2 ch = *cp;
+//
+size_t qn_u8to16(uchar2* dest, const size_t destsize, const char* src, const size_t srclen)
+{
+	qn_return_when_fail(src, 0);
 
-			if (ch >= 0xDC00 && ch < 0xE000)
-			{
-				// 하위 서로게이트
-				if (hsg)
-				{
-					_utf16_surrogate((uchar2)hsg, ch);
-					hsg = 0;
-				}
-				else
-				{
-					// 음... 변경할 수 없는 문자가 있네...
-					// 일단 못한다고 보내자
-					return 0;
-				}
-			}
-			else
-			{
-				// 일반
-				if (hsg)
-				{
-					// 상위 서로게이트가 있네?
-					// 일단.. 문제가 있다고 판단
-					return 0;
-				}
+	const byte* s = (const byte*)src;
+	const size_t len = _utf8_nlen(src, srclen);
+	if (_utf8_check(s, len) != len)
+		return 0;
 
-				if (ch >= 0xD800 && ch < 0xDC00)
-				{
-					// 상위 서로게이트
-					hsg = ch;
-					continue;
-				}
-			}
+	if (dest == NULL || destsize == 0)
+		return _utf8_count(s, len, true);
 
+	const size_t size = _utf8_to16(dest, destsize - 1, s, len);
+	dest[size] = (uchar2)'\0';
+	return size;
+}
 
-			size++;
-		}
-	}
+//
+size_t qn_u32to8(char* dest, size_t destsize, const uchar4* src, const size_t srclen)
+{
+	qn_return_when_fail(src, 0);
 
-	if (hsg)
-	{
-		// 하위 서로게이트가 남음...
-		// 못함
+	const size_t len = _utf32_nlen(src, srclen);
+	if (_utf32_check(src, len) != len)
 		return 0;
-	}
 
-	if (destsize > 0 && dest)
+	if (dest == NULL || destsize == 0)
 	{
-		uchar4* p = dest;
-		uchar4 uc;
-
-		hsg = 0;
-
-		for (const uchar2* cp = src; p < dest + size; cp++)
+		size_t size = 0;
+		for (size_t i = 0; i < len; i++)
 		{
-			const uchar2 ch = *cp;
-
-			if (ch >= 0xDC00 && ch < 0xE000)
-			{
-				// 하위 서로게이트
-				uc = _utf16_surrogate((uchar2)hsg, ch);
-				hsg = 0;
-			}
-			else if (ch >= 0xD800 && ch < 0xDC00)
-			{
-				// 상위 서로게이트
-				hsg = ch;
-				continue;
-			}
-			else
-			{
-				// 일반 글자
-				uc = ch;
-			}
-
-			*p = uc;
-			p++;
+			const uchar4 c = src[i];
+			size += c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
 		}
-
-		*p = '\0';
+		return size;
 	}
 
+	const size_t size = _utf32_to8(dest, destsize - 1, src, len);
+	dest[size] = '\0';
 	return size;
 }
 
 //
-size_t qn_u32to16(uchar2* dest, size_t destsize, const uchar4* src, const size_t srclen)
+size_t qn_u16to8(char* dest, size_t destsize, const uchar2* src, const size_t srclen)
 {
 	qn_return_when_fail(src, 0);
 
-	size_t size = 0;
-	const intptr_t slen = (intptr_t)srclen;
-	size_t z;
-	intptr_t i;
+	const size_t len = _utf16_nlen(src, srclen);
+	if (_utf16_check(src, len) != len)
+		return 0;
 
-	if (destsize > 0)
-	{
-		destsize--;
-		for (i = 0; (slen == 0 || i < slen) && src[i]; i++)
-		{
-			const uchar4 uc = src[i];
+	if (dest == NULL || destsize == 0)
+		return _utf16_count8(src, len);
 
-			if (uc < 0xD800)
-				z = 1;		// NOLINT(bugprone-branch-clone)
-			else if (uc < 0xE000)
-				return 0;	// NOLINT(bugprone-branch-clone)
-			else if (uc < 0x010000)
-				z = 1;
-			else if (uc < 0x110000)
-				z = 2;
-			else
-				return 0;
+	const size_t size = _utf16_to8(dest, destsize - 1, src, len);
+	dest[size] = '\0';
+	return size;
+}
 
-			z += size;
-			if (z > destsize)
-				break;
-			size = z;
-		}
-	}
-	else
-	{
-		for (i = 0; (slen == 0 || i < slen) && src[i]; i++)
-		{
-			const uchar4 uc = src[i];
+//
+size_t qn_u16to32(uchar4* dest, size_t destsize, const uchar2* src, const size_t srclen)
+{
+	qn_return_when_fail(src, 0);
 
-			if (uc < 0xD800)
-				size++;		// NOLINT(bugprone-branch-clone)
-			else if (uc < 0xE000)
-				return 0;	// NOLINT(bugprone-branch-clone)
-			else if (uc < 0x010000)
-				size++;
-			else if (uc < 0x110000)
-				size += 2;
-			else
-				return 0;
-		}
-	}
+	const size_t len = _utf16_nlen(src, srclen);
+	if (_utf16_check(src, len) != len)
+		return 0;
 
-	if (destsize > 0 && dest)
+	if (dest == NULL || destsize == 0)
 	{
-		uchar2* p;
-		for (p = dest, i = 0, z = 0; z < size; i++)
-		{
-			const uchar4 uc = src[i];
+		// 하위 서로게이트는 글자가 아님
+		size_t size = len;
+		for (size_t i = 0; i < len; i++)
+			size -= (src[i] & 0xFC00) == 0xDC00;
+		return size;
+	}
 
-			if (uc < 0x010000)
-				p[z++] = (uchar2)uc;
-			else
-			{
-				p[z++] = (uchar2)((uc - 0x010000) / 0x0400 + 0xD800);
-				p[z++] = (uchar2)((uc - 0x010000) % 0x0400 + 0xDC00);
-			}
-		}
+	const size_t size = _utf16_to32(dest, destsize - 1, src, len);
+	dest[size] = (uchar4)'\0';
+	return size;
+}
+
+//
+size_t qn_u32to16(uchar2* dest, size_t destsize, const uchar4* src, const size_t srclen)
+{
+	qn_return_when_fail(src, 0);
+
+	const size_t len = _utf32_nlen(src, srclen);
+	if (_utf32_check(src, len) != len)
+		return 0;
 
-		p[z] = (uchar2)'\0';
+	if (dest == NULL || destsize == 0)
+	{
+		size_t size = len;
+		for (size_t i = 0; i < len; i++)
+			size += src[i] >= 0x10000;
+		return size;
 	}
 
+	const size_t size = _utf32_to16(dest, destsize - 1, src, len);
+	dest[size] = (uchar2)'\0';
 	return size;
 }
 
@@ -400,6 +400,10 @@ static struct THREADIMPL
 } thread_impl = { 0, };
 
 static void _qn_thd_free(QnRealThread* self, uint tls_count, bool force);
+#ifndef QS_NO_MEMORY_PROFILE
+extern void qn_mpf_thread_exit(void);
+#endif
+extern void qn_log_thread_exit(void);
 #ifndef _QN_WINDOWS_
 static void _qn_pthread_key_destroyer(void* p) {}
 #endif
@@ -448,7 +452,7 @@ void qn_thread_down(void)
 //
 static bool _qn_pthread_is_null(pthread_t* p)
 {
-	return memcpy(p, &thread_impl.null_pthread, sizeof(pthread_t)) == 0;
+	return memcmp(p, &thread_impl.null_pthread, sizeof(pthread_t)) == 0;
 }
 
 //
@@ -616,6 +620,10 @@ static void _qn_thd_exit(QnRealThread* self, const bool call_exit)
 #else
 	pthread_setspecific(thread_impl.self_tls, NULL);
 #endif
+	qn_log_thread_exit();
+#ifndef QS_NO_MEMORY_PROFILE
+	qn_mpf_thread_exit();
+#endif
 
 	if (call_exit)
 #ifdef _QN_WINDOWS_
@@ -805,7 +813,7 @@ bool qn_thread_start(QnThread* self)
 	if (real->handle == NULL || real->handle == INVALID_HANDLE_VALUE)
 		qn_halt("THREAD", "cannot start thread");
 #else
-	qn_return_on_ok(_qn_pthread_is_null(&real->handle), false);
+	qn_return_when_fail(_qn_pthread_is_null(&real->handle), false);
 
 	pthread_attr_t attr;
 	pthread_attr_init(&attr);
@@ -1232,3 +1240,713 @@ bool qn_sem_post(QnSem* self)
 #endif
 	return false;
 }
+
+
+//////////////////////////////////////////////////////////////////////////
+// 작업 시스템
+
+#define JOB_DEQUE_SIZE		4096			// 일꾼 별 작업 덱 크기, 2의 제곱
+#define JOB_SPIN_COUNT		64				// 잠들기 전에 일을 찾아보는 횟수
+#define JOB_SLEEP_TIME		100				// 잠든 일꾼이 깨어나서 다시 찾아보는 간격
+
+// 작업
+typedef struct JOB
+{
+	QnJobFunc			func;
+	void*				data;
+	QnJobCounter*		counter;
+	struct JOB*			next;			// 넣기 큐와 메인 큐에서만
+} Job;
+
+// Chase-Lev 작업 덱. 주인은 bottom에서 넣고 빼고, 다른 스레드는 top에서 훔친다
+typedef struct JOBDEQUE
+{
+	volatile nint		top;
+	byte				pad1[64 - sizeof(nint)];
+	volatile nint		bottom;
+	byte				pad2[64 - sizeof(nint)];
+	volatile nint		slots[JOB_DEQUE_SIZE];
+} JobDeque;
+
+// 일꾼, 0번은 작업 시스템을 만든 스레드
+typedef struct JOBWORKER
+{
+	JobDeque			deque;
+	QnJobSystem*		system;
+	QnThread*			thread;
+	uint				index;
+	uint				seed;
+} JobWorker;
+
+// 작업 시스템
+struct QNJOBSYSTEM
+{
+	JobWorker*			workers;
+	uint				count;			// 만든 스레드 포함 일꾼 갯수
+
+	QnPool*				pool;
+	QnSem*				sleep;
+	volatile nint		idle;
+	volatile nint		quit;
+
+	// 일꾼이 아닌 스레드가 넣은 작업과 메인 스레드 전용 작업
+	QnMutex*			lock;
+	Job*				inject_head;
+	Job*				inject_tail;
+	volatile nint		inject_count;
+	Job*				main_head;
+	Job*				main_tail;
+
+	QnJobSystem*		retired;		// 물러난 공용 작업 시스템 사슬
+};
+
+// 공용 작업 시스템
+static struct JOBIMPL
+{
+	QnJobSystem*		shared;
+	QnJobSystem*		retired;		// 바꾼 공용 작업 시스템, 들고 있는 쪽이 있을 수 있어 내림 때 지운다
+	uint				want;			// 병렬 처리 스레드 갯수, 0이면 코어 갯수
+} job_impl = { NULL, };
+
+// 현재 스레드의 일꾼
+static THREADLOCAL JobWorker* job_self = NULL;
+
+//
+uint qn_cpu_count(void)
+{
+	static uint count = 0;
+	if (count != 0)
+		return count;
+#if defined _QN_WINDOWS_
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	const long n = (long)si.dwNumberOfProcessors;
+#elif defined _QN_EMSCRIPTEN_ && !defined __EMSCRIPTEN_PTHREADS__
+	const long n = 1;
+#elif defined _SC_NPROCESSORS_ONLN
+	const long n = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+	const long n = 1;
+#endif
+	count = n < 1 ? 1 : (uint)n;
+	return count;
+}
+
+// 주인만 부른다. 꽉 찼으면 거짓
+static bool _job_deque_push(JobDeque* dq, Job* job)
+{
+	const nint b = dq->bottom;
+	const nint t = qn_atomic_load(&dq->top);
+	if (b - t >= JOB_DEQUE_SIZE)
+		return false;
+	qn_atomic_store(&dq->slots[b & (JOB_DEQUE_SIZE - 1)], (nint)job);
+	qn_atomic_store(&dq->bottom, b + 1);
+	return true;
+}
+
+// 주인만 부른다
+static Job* _job_deque_pop(JobDeque* dq)
+{
+	const nint b = dq->bottom - 1;
+	qn_atomic_exchange(&dq->bottom, b);
+	const nint t = qn_atomic_load(&dq->top);
+	if (t > b)
+	{
+		qn_atomic_store(&dq->bottom, b + 1);
+		return NULL;
+	}
+	Job* job = (Job*)qn_atomic_load(&dq->slots[b & (JOB_DEQUE_SIZE - 1)]);
+	if (t == b)
+	{
+		// 마지막 하나는 훔치는 쪽과 겨룬다
+		if (qn_atomic_cas(&dq->top, t, t + 1) == false)
+			job = NULL;
+		qn_atomic_store(&dq->bottom, b + 1);
+	}
+	return job;
+}
+
+// 아무나 부른다
+static Job* _job_deque_steal(JobDeque* dq)
+{
+	const nint t = qn_atomic_load(&dq->top);
+	qn_atomic_fence();
+	const nint b = qn_atomic_load(&dq->bottom);
+	if (t >= b)
+		return NULL;
+	Job* job = (Job*)qn_atomic_load(&dq->slots[t & (JOB_DEQUE_SIZE - 1)]);
+	return qn_atomic_cas(&dq->top, t, t + 1) ? job : NULL;
+}
+
+// 큐에 넣기, lock 안에서
+static void _job_queue_push(Job** head, Job** tail, Job* job)
+{
+	job->next = NULL;
+	if (*tail)
+		(*tail)->next = job;
+	else
+		*head = job;
+	*tail = job;
+}
+
+// 큐에서 빼기, lock 안에서
+static Job* _job_queue_pop(Job** head, Job** tail)
+{
+	Job* job = *head;
+	if (job != NULL)
+	{
+		*head = job->next;
+		if (*head == NULL)
+			*tail = NULL;
+	}
+	return job;
+}
+
+// 작업 실행
+static void _job_execute(QnJobSystem* self, Job* job)
+{
+	const QnJobFunc func = job->func;
+	void* data = job->data;
+	QnJobCounter* counter = job->counter;
+	qn_pool_free(self->pool, job);
+	func(data);
+	if (counter != NULL)
+		qn_atomic_add(&counter->value, -1);
+}
+
+// 할 일 찾기. 내 덱, 넣기 큐, 다른 일꾼 덱 순서
+static Job* _job_find(QnJobSystem* self, JobWorker* worker)
+{
+	Job* job;
+	if (worker != NULL && (job = _job_deque_pop(&worker->deque)) != NULL)
+		return job;
+
+	if (qn_atomic_load(&self->inject_count) > 0)
+	{
+		qn_mutex_enter(self->lock);
+		job = _job_queue_pop(&self->inject_head, &self->inject_tail);
+		if (job != NULL)
+			qn_atomic_add(&self->inject_count, -1);
+		qn_mutex_leave(self->lock);
+		if (job != NULL)
+			return job;
+	}
+
+	// 아무 곳에서나 시작해서 한바퀴
+	uint seed = worker != NULL ? worker->seed : (uint)(nuint)&job;
+	seed = seed * 1103515245U + 12345U;
+	if (worker != NULL)
+		worker->seed = seed;
+	const uint start = (seed >> 16) % self->count;
+	for (uint i = 0; i < self->count; i++)
+	{
+		JobWorker* victim = &self->workers[(start + i) % self->count];
+		if (victim == worker)
+			continue;
+		if ((job = _job_deque_steal(&victim->deque)) != NULL)
+			return job;
+	}
+	return NULL;
+}
+
+// 잠든 일꾼 깨우기
+static void _job_wake(QnJobSystem* self)
+{
+	qn_atomic_fence();
+	if (qn_atomic_load(&self->idle) > 0)
+		qn_sem_post(self->sleep);
+}
+
+// 일꾼 스레드
+static void* _job_worker(void* data)
+{
+	JobWorker* worker = (JobWorker*)data;
+	QnJobSystem* self = worker->system;
+	job_self = worker;
+
+	uint spins = 0;
+	while (qn_atomic_load(&self->quit) == 0)
+	{
+		Job* job = _job_find(self, worker);
+		if (job != NULL)
+		{
+			_job_execute(self, job);
+			spins = 0;
+			continue;
+		}
+		if (++spins < JOB_SPIN_COUNT)
+		{
+			qn_sleep(0);
+			continue;
+		}
+
+		// 잠들기 전에 한번 더 본다. 넣는 쪽은 넣은 다음 idle을 보므로 놓치지 않는다
+		qn_atomic_add(&self->idle, 1);
+		job = _job_find(self, worker);
+		if (job == NULL && qn_atomic_load(&self->quit) == 0)
+			qn_sem_wait_for(self->sleep, JOB_SLEEP_TIME);
+		qn_atomic_add(&self->idle, -1);
+		if (job != NULL)
+			_job_execute(self, job);
+		spins = 0;
+	}
+
+	job_self = NULL;
+	return NULL;
+}
+
+// 지금 스레드의 일꾼, 일꾼 스레드가 아니면 0번(메인 스레드)인지 본다
+static JobWorker* _job_worker_self(QnJobSystem* self)
+{
+	JobWorker* worker = job_self;
+	if (worker != NULL && worker->system == self)
+		return worker;
+	return self->workers[0].thread == qn_thread_self() ? &self->workers[0] : NULL;
+}
+
+// 작업 시스템 만들기, 0번 일꾼은 main 스레드
+static QnJobSystem* _job_system_create(int workers, const int busy, QnThread* main)
+{
+	if (workers < 0)
+		workers = (int)qn_cpu_count() - 1;
+
+	QnJobSystem* self = qn_alloc_zero_1(QnJobSystem);
+	self->count = (uint)workers + 1;
+	self->workers = qn_alloc_zero(self->count, JobWorker);
+	self->pool = qn_new_pool(sizeof(Job), 256, true);
+	self->sleep = qn_new_sem(0);
+	self->lock = qn_new_mutex();
+
+	for (uint i = 0; i < self->count; i++)
+	{
+		JobWorker* worker = &self->workers[i];
+		worker->system = self;
+		worker->index = i;
+		worker->seed = i * 2654435761U + 1;
+	}
+
+	self->workers[0].thread = main;
+
+	for (uint i = 1; i < self->count; i++)
+	{
+		char name[32];
+		qn_snprintf(name, QN_COUNTOF(name), "QN JOB %u", i);
+		JobWorker* worker = &self->workers[i];
+		worker->thread = qn_new_thread(name, _job_worker, worker, 0, busy);
+		qn_thread_start(worker->thread);
+	}
+	return self;
+}
+
+//
+QnJobSystem* qn_new_job_system(int workers, const int busy)
+{
+	// 0번은 만든 스레드
+	return _job_system_create(workers, busy, qn_thread_self());
+}
+
+//
+void qn_delete_job_system(QnJobSystem* self)
+{
+	qn_return_when_fail(self != NULL,/*void*/);
+
+	qn_atomic_store(&self->quit, 1);
+	for (uint i = 1; i < self->count; i++)
+		qn_sem_post(self->sleep);
+	for (uint i = 1; i < self->count; i++)
+		qn_delete_thread(self->workers[i].thread);
+
+	// 남은 작업은 여기서 처리
+	for (Job* job; (job = _job_find(self, &self->workers[0])) != NULL;)
+		_job_execute(self, job);
+	for (Job* job; (job = _job_queue_pop(&self->main_head, &self->main_tail)) != NULL;)
+		_job_execute(self, job);
+
+	qn_delete_mutex(self->lock);
+	qn_delete_sem(self->sleep);
+	qn_delete_pool(self->pool);
+	qn_free(self->workers);
+	qn_free(self);
+}
+
+//
+uint qn_job_system_workers(const QnJobSystem* self)
+{
+	return self->count - 1;
+}
+
+//
+QnJobSystem* qn_job_system(void)
+{
+	QnJobSystem* js = (QnJobSystem*)qn_atomic_load((volatile nint*)&job_impl.shared);
+	if (js != NULL)
+		return js;
+
+	// 동시에 만들면 하나만 남긴다. 어느 스레드가 먼저 불러도 0번은 런타임을 올린 메인 스레드
+	const uint want = job_impl.want != 0 ? job_impl.want : qn_cpu_count();
+	js = _job_system_create((int)want - 1, 0, (QnThread*)thread_impl.self);
+	if (qn_atomic_cas((volatile nint*)&job_impl.shared, 0, (nint)js) == false)
+	{
+		qn_delete_job_system(js);
+		js = (QnJobSystem*)qn_atomic_load((volatile nint*)&job_impl.shared);
+	}
+	return js;
+}
+
+// 런타임 내림에서 부른다
+void qn_job_down(void)
+{
+	if (job_impl.shared != NULL)
+	{
+		qn_delete_job_system(job_impl.shared);
+		job_impl.shared = NULL;
+	}
+	for (QnJobSystem *next, *js = job_impl.retired; js != NULL; js = next)
+	{
+		next = js->retired;
+		qn_delete_job_system(js);
+	}
+	job_impl.retired = NULL;
+}
+
+//
+void qn_job_run(QnJobSystem* self, const QnJobFunc func, void* data, QnJobCounter* counter)
+{
+	qn_return_when_fail(func != NULL,/*void*/);
+	if (counter != NULL)
+		qn_atomic_add(&counter->value, 1);
+
+	Job* job = (Job*)qn_pool_alloc(self->pool, false);
+	job->func = func;
+	job->data = data;
+	job->counter = counter;
+
+	JobWorker* worker = _job_worker_self(self);
+	if (worker != NULL)
+	{
+		if (_job_deque_push(&worker->deque, job) == false)
+		{
+			// 덱이 꽉 차면 바로 처리
+			_job_execute(self, job);
+			return;
+		}
+	}
+	else
+	{
+		qn_mutex_enter(self->lock);
+		_job_queue_push(&self->inject_head, &self->inject_tail, job);
+		qn_atomic_add(&self->inject_count, 1);
+		qn_mutex_leave(self->lock);
+	}
+	_job_wake(self);
+}
+
+//
+void qn_job_run_main(QnJobSystem* self, const QnJobFunc func, void* data, QnJobCounter* counter)
+{
+	qn_return_when_fail(func != NULL,/*void*/);
+	if (counter != NULL)
+		qn_atomic_add(&counter->value, 1);
+
+	Job* job = (Job*)qn_pool_alloc(self->pool, false);
+	job->func = func;
+	job->data = data;
+	job->counter = counter;
+
+	qn_mutex_enter(self->lock);
+	_job_queue_push(&self->main_head, &self->main_tail, job);
+	qn_mutex_leave(self->lock);
+}
+
+//
+int qn_job_update_main(QnJobSystem* self)
+{
+	qn_return_when_fail(self->workers[0].thread == qn_thread_self(), 0);
+	int count = 0;
+	for (;;)
+	{
+		qn_mutex_enter(self->lock);
+		Job* job = _job_queue_pop(&self->main_head, &self->main_tail);
+		qn_mutex_leave(self->lock);
+		if (job == NULL)
+			break;
+		_job_execute(self, job);
+		count++;
+	}
+	return count;
+}
+
+//
+void qn_job_wait(QnJobSystem* self, QnJobCounter* counter)
+{
+	qn_return_when_fail(counter != NULL,/*void*/);
+	JobWorker* worker = _job_worker_self(self);
+	const bool main = worker == &self->workers[0];
+	uint spins = 0;
+	while (qn_atomic_load(&counter->value) > 0)
+	{
+		// 기다리는 동안 일을 돕는다
+		Job* job = _job_find(self, worker);
+		if (job != NULL)
+		{
+			_job_execute(self, job);
+			spins = 0;
+			continue;
+		}
+		if (main && self->main_head != NULL && qn_job_update_main(self) > 0)
+			continue;
+		if (++spins < JOB_SPIN_COUNT)
+		{
+#if defined __GNUC__ && (defined __i386__ || defined __amd64__ || defined __x86_64__)
+			__asm__ __volatile__("pause\n");
+#elif defined __GNUC__ && defined __aarch64__
+			__asm__ __volatile__("yield" ::: "memory");
+#elif defined _MSC_VER && (defined _M_IX86 || defined _M_X64)
+			_mm_pause();
+#endif
+		}
+		else
+			qn_sleep(0);
+	}
+}
+
+//
+bool qn_job_is_done(const QnJobCounter* counter)
+{
+	return qn_atomic_load(&counter->value) <= 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// 병렬 처리
+
+// 병렬 작업
+typedef struct PARALLELJOB
+{
+	QnParallelFunc		func;
+	void*				context;
+	size_t				count;
+	size_t				grain;
+	nint				chunks;
+	volatile nint		next;			// 다음 처리할 덩어리
+} ParallelJob;
+
+// 덩어리를 가져다 처리
+static void _parallel_job_run(void* data)
+{
+	ParallelJob* job = (ParallelJob*)data;
+	for (;;)
+	{
+		const nint chunk = qn_atomic_add(&job->next, 1);
+		if (chunk >= job->chunks)
+			break;
+		const size_t begin = (size_t)chunk * job->grain;
+		job->func(job->context, begin, QN_MIN(begin + job->grain, job->count));
+	}
+}
+
+//
+void qn_parallel_threads(uint count)
+{
+	job_impl.want = count;
+	const uint want = count != 0 ? count : qn_cpu_count();
+	QnJobSystem* js = (QnJobSystem*)qn_atomic_load((volatile nint*)&job_impl.shared);
+	if (js == NULL || js->count == want)
+		return;
+	js = (QnJobSystem*)qn_atomic_exchange((volatile nint*)&job_impl.shared, 0);
+	if (js == NULL)
+		return;
+	// qn_job_system으로 얻은 포인터를 들고 있는 쪽이 있으므로 지우지 않고 런타임 내림까지 둔다
+	do js->retired = (QnJobSystem*)qn_atomic_load((volatile nint*)&job_impl.retired);
+	while (qn_atomic_cas((volatile nint*)&job_impl.retired, (nint)js->retired, (nint)js) == false);
+}
+
+//
+uint qn_parallel_count(void)
+{
+	const QnJobSystem* js = (const QnJobSystem*)qn_atomic_load((volatile nint*)&job_impl.shared);
+	if (js != NULL)
+		return js->count;
+	return job_impl.want != 0 ? job_impl.want : qn_cpu_count();
+}
+
+//
+void qn_parallel_for(const size_t count, size_t grain, const QnParallelFunc func, void* context)
+{
+	qn_return_when_fail(func != NULL,/*void*/);
+	qn_return_on_ok(count == 0,/*void*/);
+
+	const uint threads = qn_parallel_count();
+	if (grain == 0)
+		grain = QN_MAX(count / ((size_t)threads * 4), 1);
+	if (threads == 1 || grain >= count)
+	{
+		// 차례대로
+		for (size_t begin = 0; begin < count; begin += grain)
+			func(context, begin, QN_MIN(begin + grain, count));
+		return;
+	}
+
+	// 일꾼마다 덩어리를 가져가는 작업을 하나씩 넣고, 부른 스레드도 같이 한다
+	QnJobSystem* js = qn_job_system();
+	ParallelJob job =
+	{
+		.func = func,
+		.context = context,
+		.count = count,
+		.grain = grain,
+		.chunks = (nint)((count + grain - 1) / grain),
+		.next = 0,
+	};
+	QnJobCounter counter = { 0 };
+	const nint helpers = QN_MIN(job.chunks - 1, (nint)js->count - 1);
+	for (nint i = 0; i < helpers; i++)
+		qn_job_run(js, _parallel_job_run, &job, &counter);
+	_parallel_job_run(&job);
+	qn_job_wait(js, &counter);
+}
+
+// 병렬 정렬
+typedef struct PARALLELSORT
+{
+	byte*				data;
+	byte*				buffer;
+	size_t				stride;
+	cmpcfunc_t			func;
+	void*				context;
+	size_t*				bounds;			// 구간 경계, runs + 1개
+	size_t				runs;
+	size_t				parts;			// 병합 하나를 나눌 갯수
+	const byte*			src;
+	byte*				dst;
+} ParallelSort;
+
+// 콘텍스트 없는 비교 함수를 콘텍스트 비교로
+static int _parallel_sort_cmp(void* context, const void* left, const void* right)
+{
+	const cmpfunc_t* func = (const cmpfunc_t*)context;
+	return (*func)(left, right);
+}
+
+// 구간 정렬
+static void _parallel_sort_run(void* context, size_t begin, size_t end)
+{
+	const ParallelSort* ps = (const ParallelSort*)context;
+	for (size_t r = begin; r < end; r++)
+	{
+		const size_t lo = ps->bounds[r], hi = ps->bounds[r + 1];
+		qn_qsortc(ps->data + lo * ps->stride, hi - lo, ps->stride, ps->func, ps->context);
+	}
+}
+
+// a와 b를 병합했을 때 앞에서 k개 안에 a가 몇개 들어가나 (같으면 a가 먼저)
+static size_t _parallel_sort_corank(const ParallelSort* ps, const byte* a, size_t na, const byte* b, size_t nb, size_t k)
+{
+	size_t lo = k > nb ? k - nb : 0;
+	size_t hi = QN_MIN(k, na);
+	while (lo < hi)
+	{
+		const size_t i = lo + (hi - lo) / 2;
+		if (ps->func(ps->context, a + i * ps->stride, b + (k - i - 1) * ps->stride) <= 0)
+			lo = i + 1;
+		else
+			hi = i;
+	}
+	return lo;
+}
+
+// 병합 조각, 한 병합을 parts개로 나눠서 처리한다
+static void _parallel_sort_merge(void* context, size_t begin, size_t end)
+{
+	const ParallelSort* ps = (const ParallelSort*)context;
+	const size_t stride = ps->stride;
+	for (size_t task = begin; task < end; task++)
+	{
+		const size_t pair = task / ps->parts, part = task % ps->parts;
+		const size_t lo = ps->bounds[pair * 2];
+		const size_t mid = ps->bounds[QN_MIN(pair * 2 + 1, ps->runs)];
+		const size_t hi = ps->bounds[QN_MIN(pair * 2 + 2, ps->runs)];
+		const byte* a = ps->src + lo * stride;
+		const byte* b = ps->src + mid * stride;
+		const size_t na = mid - lo, nb = hi - mid, total = na + nb;
+		const size_t k0 = total * part / ps->parts, k1 = total * (part + 1) / ps->parts;
+
+		size_t i = _parallel_sort_corank(ps, a, na, b, nb, k0);
+		size_t j = k0 - i;
+		const size_t ie = _parallel_sort_corank(ps, a, na, b, nb, k1);
+		const size_t je = k1 - ie;
+		byte* out = ps->dst + (lo + k0) * stride;
+		while (i < ie && j < je)
+		{
+			const byte* pick = ps->func(ps->context, b + j * stride, a + i * stride) < 0 ? b + j++ * stride : a + i++ * stride;
+			memcpy(out, pick, stride);
+			out += stride;
+		}
+		if (i < ie)
+		{
+			memcpy(out, a + i * stride, (ie - i) * stride);
+			out += (ie - i) * stride;
+		}
+		if (j < je)
+			memcpy(out, b + j * stride, (je - j) * stride);
+	}
+}
+
+//
+void qn_parallel_sortc(void* ptr, size_t count, size_t stride, cmpcfunc_t compfunc, void* context)
+{
+	qn_return_when_fail(ptr,/*void*/);
+	qn_return_when_fail(stride,/*void*/);
+	qn_return_when_fail(compfunc,/*void*/);
+
+	const size_t threads = qn_parallel_count();
+	if (threads == 1 || count < 8192)
+	{
+		qn_qsortc(ptr, count, stride, compfunc, context);
+		return;
+	}
+
+	ParallelSort ps =
+	{
+		.data = (byte*)ptr,
+		.buffer = qn_alloc(count * stride, byte),
+		.stride = stride,
+		.func = compfunc,
+		.context = context,
+		.bounds = qn_alloc(threads + 1, size_t),
+		.runs = threads,
+	};
+	for (size_t r = 0; r <= ps.runs; r++)
+		ps.bounds[r] = count * r / ps.runs;
+	qn_parallel_for(ps.runs, 1, _parallel_sort_run, &ps);
+
+	// 두 구간씩 병합, 병합 갯수가 스레드보다 적으면 병합 하나를 나눈다
+	ps.src = ps.data;
+	ps.dst = ps.buffer;
+	while (ps.runs > 1)
+	{
+		const size_t pairs = (ps.runs + 1) / 2;
+		ps.parts = QN_MAX(threads / pairs, 1);
+		qn_parallel_for(pairs * ps.parts, 1, _parallel_sort_merge, &ps);
+
+		for (size_t r = 0; r < pairs; r++)
+			ps.bounds[r] = ps.bounds[r * 2];
+		ps.bounds[pairs] = count;
+		ps.runs = pairs;
+		byte* t = (byte*)ps.src;
+		ps.src = ps.dst;
+		ps.dst = t;
+	}
+	if (ps.src != ps.data)
+		memcpy(ps.data, ps.src, count * stride);
+
+	qn_free(ps.bounds);
+	qn_free(ps.buffer);
+}
+
+//
+void qn_parallel_sort(void* ptr, size_t count, size_t stride, cmpfunc_t compfunc)
+{
+	qn_return_when_fail(compfunc,/*void*/);
+	qn_parallel_sortc(ptr, count, stride, _parallel_sort_cmp, &compfunc);
+}
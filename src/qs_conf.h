@@ -32,6 +32,27 @@ static_assert(MAX_DEBUG_LENGTH >= 256 && MAX_DEBUG_LENGTH <= 4096, "256 <= MAX_D
 #define MAX_TLS	64
 #endif
 
+// 메모리 프로파일러 스레드 캐시에 넣을 최대 블럭 크기
+#ifndef MAX_MPF_CACHE_BLOCK
+#define MAX_MPF_CACHE_BLOCK	1024
+#endif
+static_assert(MAX_MPF_CACHE_BLOCK % 16 == 0, "MAX_MPF_CACHE_BLOCK must be multiple of 16");
+
+// 메모리 프로파일러 매거진 당 블럭 개수
+#ifndef MAX_MPF_MAGAZINE
+#define MAX_MPF_MAGAZINE	32
+#endif
+
+// 메모리 프로파일러 크기 별 저장소 최대 매거진 개수
+#ifndef MAX_MPF_DEPOT
+#define MAX_MPF_DEPOT		16
+#endif
+
+// 스레드 별 메모리 테이블 스택 깊이
+#ifndef MAX_MEMTBL_STACK
+#define MAX_MEMTBL_STACK	8
+#endif
+
 // 컨트롤러 데드존
 #ifndef CTRL_DEAD_ZONE
 #define CTRL_DEAD_ZONE		(int)(0.24f*((float)INT16_MAX))
@@ -122,12 +122,14 @@ extern "C" {
 
 struct sinfl {
   const unsigned char *bitptr;
+  const unsigned char *bitend;
   unsigned long long bitbuf;
   int bitcnt;
 
   unsigned lits[SINFL_LIT_TBL_SIZE];
   unsigned dsts[SINFL_OFF_TBL_SIZE];
 };
+/* returns bytes written, or -1 if the output would pass cap */
 extern int sinflate(void *out, int cap, const void *in, int size);
 extern int zsinflate(void *out, int cap, const void *in, int size);
 
@@ -217,7 +219,15 @@ sinfl_copy128(unsigned char **dst, unsigned char **src) {
 #endif
 static void
 sinfl_refill(struct sinfl *s) {
-  s->bitbuf |= sinfl_read64(s->bitptr) << s->bitcnt;
+  if (sinfl_likely(s->bitend - s->bitptr >= 8))
+    s->bitbuf |= sinfl_read64(s->bitptr) << s->bitcnt;
+  else {
+    /* near the end of input: never read past it, feed zeros instead */
+    unsigned char tail[8] = {0};
+    if (s->bitptr < s->bitend)
+      memcpy(tail, s->bitptr, (size_t)(s->bitend - s->bitptr));
+    s->bitbuf |= sinfl_read64(tail) << s->bitcnt;
+  }
   s->bitptr += (63 - s->bitcnt) >> 3;
   s->bitcnt |= 56; /* bitcount in range [56,63] */
 }
@@ -391,11 +401,14 @@ sinfl_decompress(unsigned char *out, int cap, const unsigned char *in, int size)
   int last = 0;
 
   s.bitptr = in;
+  s.bitend = e;
   while (1) {
     switch (state) {
     case hdr: {
       /* block header */
       int type = 0;
+      if (s.bitptr > e)
+        return (int)(out-o);
       sinfl_refill(&s);
       last = sinfl__get(&s,1);
       type = sinfl__get(&s,2);
@@ -416,8 +429,12 @@ sinfl_decompress(unsigned char *out, int cap, const unsigned char *in, int size)
 
       if ((unsigned short)len != (unsigned short)~nlen)
         return (int)(out-o);
-      if (len > (unsigned)(e - s.bitptr) || !len)
+      if (s.bitptr > e || len > (unsigned)(e - s.bitptr) || !len)
         return (int)(out-o);
+      if (sinfl_unlikely(len > (unsigned)(oe - out))) {
+        /* output full, -1 so the caller can grow */
+        return -1;
+      }
 
       memcpy(out, s.bitptr, (size_t)len);
       s.bitptr += len, out += len;
@@ -476,11 +493,14 @@ sinfl_decompress(unsigned char *out, int cap, const unsigned char *in, int size)
         if (sym < 256) {
           /* literal */
           if (sinfl_unlikely(out >= oe)) {
-            return (int)(out-o);
+            return -1;
           }
           *out++ = (unsigned char)sym;
           sym = sinfl_decode(&s, s.lits, 10);
           if (sym < 256) {
+            if (sinfl_unlikely(out >= oe)) {
+              return -1;
+            }
             *out++ = (unsigned char)sym;
             continue;
           }
@@ -504,6 +524,10 @@ sinfl_decompress(unsigned char *out, int cap, const unsigned char *in, int size)
         if (sinfl_unlikely(offs > (int)(out-o))) {
           return (int)(out-o);
         }
+        if (sinfl_unlikely(len > (int)(oe-out))) {
+          /* output full, -1 so the caller can grow */
+          return -1;
+        }
         out = out + len;
 
 #ifndef SINFL_NO_SIMD
@@ -609,8 +633,10 @@ zsinflate(void *out, int cap, const void *mem, int size) {
   if (size >= 6) {
     const unsigned char *eob = in + size - 4;
     int n = sinfl_decompress((unsigned char*)out, cap, in + 2u, size);
-    unsigned a = sinfl_adler32(1u, (unsigned char*)out, n);
-    unsigned h = eob[0] << 24 | eob[1] << 16 | eob[2] << 8 | eob[3] << 0;
+    unsigned a, h;
+    if (n < 0) return -1;
+    a = sinfl_adler32(1u, (unsigned char*)out, n);
+    h = eob[0] << 24 | eob[1] << 16 | eob[2] << 8 | eob[3] << 0;
     return a == h ? n : -1;
   } else {
     return -1;
@@ -0,0 +1,94 @@
+﻿// 아레나 할당 벤치마크
+#include <qs.h>
+
+#define FRAME_COUNT		2000
+#define ALLOC_COUNT		512
+
+// 보통 할당, 하나씩 해제
+static void bench_mpf(void)
+{
+	void* ptrs[ALLOC_COUNT];
+	for (int frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		for (int i = 0; i < ALLOC_COUNT; i++)
+		{
+			ptrs[i] = qn_alloc(16 + (i * 7) % 240, byte);
+			((byte*)ptrs[i])[0] = (byte)i;
+		}
+		for (int i = 0; i < ALLOC_COUNT; i++)
+			qn_free(ptrs[i]);
+	}
+}
+
+// 아레나 직접 할당, 프레임마다 한꺼번에 해제
+static void bench_arena(QnArena* arena)
+{
+	for (int frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		for (int i = 0; i < ALLOC_COUNT; i++)
+		{
+			byte* ptr = (byte*)qn_arena_alloc(arena, 16 + (i * 7) % 240, false);
+			ptr[0] = (byte)i;
+		}
+		qn_arena_reset(arena);
+	}
+}
+
+// qn_alloc을 아레나로 보냄
+static void bench_arena_push(QnArena* arena)
+{
+	for (int frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		qn_arena_push(arena);
+		for (int i = 0; i < ALLOC_COUNT; i++)
+		{
+			byte* ptr = qn_alloc(16 + (i * 7) % 240, byte);
+			ptr[0] = (byte)i;
+		}
+		qn_memtbl_pop();
+		qn_arena_reset(arena);
+	}
+}
+
+static void report(const char* name, double elapsed, double base)
+{
+	const double ops = (double)FRAME_COUNT * ALLOC_COUNT / elapsed;
+	qn_outputf("%-12s time: %.3f sec, %.2f Mallocs/sec, %.2fx", name, elapsed, ops / 1000000.0, base / elapsed);
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+
+	double start = qn_elapsed();
+	bench_mpf();
+	const double base = qn_elapsed() - start;
+	report("qn_alloc", base, base);
+
+	QnArena* arena = qn_new_arena(0);
+
+	start = qn_elapsed();
+	bench_arena(arena);
+	report("arena", qn_elapsed() - start, base);
+
+	start = qn_elapsed();
+	bench_arena_push(arena);
+	report("arena push", qn_elapsed() - start, base);
+
+	// 위치 표시와 되돌리기
+	const QnArenaMark mark = qn_arena_mark(arena);
+	char* str = qn_strdup("arena string");
+	qn_arena_push(arena);
+	char* dup = qn_strdup(str);
+	dup = qn_realloc(dup, 64, char);
+	qn_strcat(dup, " + more");
+	qn_free(str);
+	qn_memtbl_pop();
+	qn_outputf("string: %s, size: %d", dup, (int)qn_arena_size(arena));
+	qn_arena_rewind(arena, mark);
+	qn_outputf("after rewind: %d", (int)qn_arena_size(arena));
+
+	qn_delete_arena(arena);
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return 0;
+}
@@ -0,0 +1,248 @@
+﻿// 비동기 읽기 테스트, 순서대로 읽기와 비교하고 메인 루프는 매 프레임 완료만 받는다
+#include <qs.h>
+
+#define MAX_FILES		256
+#define READ_ROUND		8
+
+typedef struct SAMPLE
+{
+	char*			name;
+	char*			rooted;			// 퓨즈는 '/'로 시작하는 전체 경로로 찾는다
+	uint			crc;
+	size_t			size;
+} Sample;
+
+typedef struct COUNTER
+{
+	size_t			done;
+	size_t			bytes;
+	size_t			fails;
+	size_t			cancels;
+} Counter;
+
+static Sample samples[MAX_FILES];
+static size_t sample_count;
+
+// 파일 이름과 crc를 모은다
+static void collect(QnMount* mnt, const char* path)
+{
+	QnDir* dir = qn_open_dir(mnt, path, NULL);
+	if (dir == NULL)
+		return;
+	QnFileInfo fi;
+	while (qn_dir_read_info(dir, &fi))
+	{
+		if (fi.name[0] == '.')
+			continue;
+		char* full = qn_strdupcat(path, fi.name, QN_TMASK(fi.attr, QNFATTR_DIR) ? "/" : NULL, NULL);
+		if (QN_TMASK(fi.attr, QNFATTR_DIR))
+		{
+			collect(mnt, full);
+			qn_free(full);
+			continue;
+		}
+		size_t size;
+		void* data = sample_count < MAX_FILES ? qn_file_alloc64(mnt, full, &size) : NULL;
+		if (data == NULL)
+		{
+			qn_free(full);
+			continue;
+		}
+		samples[sample_count++] = (Sample){ full, qn_strdupcat("/", full, NULL), qn_crc32(0, data, size), size };
+		qn_free(data);
+	}
+	qn_unload(dir);
+}
+
+// 완료 콜백, 메인 스레드에서 불린다
+static void on_read(QnAsyncRead* req, void* data)
+{
+	Counter* c = (Counter*)data;
+	c->done++;
+	const QnAsyncState state = qn_async_state(req);
+	if (state == QNASYNC_CANCEL)
+	{
+		c->cancels++;
+		return;
+	}
+	const char* name = qn_async_filename(req);
+	name += name[0] == '/' ? 1 : 0;
+	size_t size;
+	const void* buf = qn_async_data(req, &size);
+	for (size_t i = 0; i < sample_count; i++)
+	{
+		if (strcmp(samples[i].name, name) != 0)
+			continue;
+		if (buf == NULL || size != samples[i].size || qn_crc32(0, buf, size) != samples[i].crc)
+			c->fails++;
+		else
+			c->bytes += size;
+		return;
+	}
+	c->fails++;
+}
+
+// 순서대로 읽기와 비동기 읽기
+static bool bench(const char* name, QnMount* mnt, bool rooted)
+{
+	const size_t total = sample_count * READ_ROUND;
+	bool ok = true;
+
+	double start = qn_elapsed();
+	for (size_t i = 0; i < total; i++)
+	{
+		const Sample* s = &samples[i % sample_count];
+		size_t size;
+		void* data = qn_file_alloc64(mnt, rooted ? s->rooted : s->name, &size);
+		if (data == NULL || size != s->size || qn_crc32(0, data, size) != s->crc)
+			ok = false;
+		qn_free(data);
+	}
+	const double sync_time = qn_elapsed() - start;
+
+	// 다 넣고 프레임마다 완료만 받는다. 메인 스레드는 넣기와 콜백 처리에만 시간을 쓴다
+	Counter c = { 0, };
+	start = qn_elapsed();
+	for (size_t i = 0; i < total; i++)
+	{
+		// 기다릴 일이 없으니 바로 놓는다. qn_unload 는 인수를 두번 쓰므로 따로 받는다
+		const Sample* s = &samples[i % sample_count];
+		QnAsyncRead* req = qn_async_read(mnt, rooted ? s->rooted : s->name, on_read, &c);
+		qn_unload(req);
+	}
+	const double submit_time = qn_elapsed() - start;
+	int frames = 0;
+	double busy = submit_time;
+	while (c.done < total)
+	{
+		const double frame = qn_elapsed();
+		qn_async_update();
+		busy += qn_elapsed() - frame;
+		frames++;
+		qn_sleep(1);
+	}
+	const double async_time = qn_elapsed() - start;
+	ok = c.fails == 0 && ok;
+
+	qn_outputf("%-6s sync: %8.3f ms, async: %8.3f ms in %3d frames, main thread busy: %8.3f ms  %s",
+		name, sync_time * 1000.0, async_time * 1000.0, frames, busy * 1000.0, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 부분 읽기, 기다리기, 취소, 실패
+static bool check_misc(QnMount* mnt)
+{
+	const Sample* s = &samples[0];
+	for (size_t i = 1; i < sample_count; i++)
+		if (samples[i].size > s->size)
+			s = &samples[i];
+	size_t full_size;
+	byte* full = qn_file_alloc64(mnt, s->name, &full_size);
+
+	// 가운데, 끝을 넘어서, 끝까지
+	QnAsyncRead* mid = qn_async_read_range(mnt, s->name, (llong)full_size / 3, 1000, NULL, NULL);
+	QnAsyncRead* over = qn_async_read_range(mnt, s->name, (llong)full_size - 10, 1000, NULL, NULL);
+	QnAsyncRead* tail = qn_async_read_range(mnt, s->name, (llong)full_size / 2, 0, NULL, NULL);
+	size_t size;
+	bool ok = qn_async_wait(mid) && qn_async_data(mid, &size) != NULL && size == 1000 &&
+		memcmp(qn_async_data(mid, NULL), full + full_size / 3, 1000) == 0;
+	ok = qn_async_wait(over) && qn_async_data(over, &size) != NULL && size == 10 && ok;
+	ok = qn_async_wait(tail) && ok;
+	byte* taken = qn_async_take(tail, &size);
+	ok = taken != NULL && size == full_size - full_size / 2 && memcmp(taken, full + full_size / 2, size) == 0 &&
+		qn_async_take(tail, NULL) == NULL && ok;
+	qn_free(taken);
+	qn_unload(mid);
+	qn_unload(over);
+	qn_unload(tail);
+	qn_free(full);
+
+	// 없는 파일
+	QnAsyncRead* bad = qn_async_read(mnt, "no/such/file.bin", NULL, NULL);
+	ok = qn_async_wait(bad) == false && qn_async_state(bad) == QNASYNC_FAIL && qn_async_error(bad) != 0 &&
+		qn_async_data(bad, NULL) == NULL && ok;
+	qn_unload(bad);
+
+	// 잔뜩 넣고 뒤에서부터 취소하면 콜백은 모두 불린다
+	Counter c = { 0, };
+	QnAsyncRead* reqs[64];
+	for (size_t i = 0; i < QN_COUNTOF(reqs); i++)
+		reqs[i] = qn_async_read(mnt, samples[i % sample_count].name, on_read, &c);
+	size_t cancels = 0;
+	for (size_t i = QN_COUNTOF(reqs); i > 0; i--)
+		cancels += qn_async_cancel(reqs[i - 1]) ? 1 : 0;
+	for (size_t i = 0; i < QN_COUNTOF(reqs); i++)
+	{
+		qn_async_wait(reqs[i]);
+		qn_unload(reqs[i]);
+	}
+	while (c.done < QN_COUNTOF(reqs))
+	{
+		qn_async_update();
+		qn_sleep(1);
+	}
+	ok = c.cancels == cancels && c.fails == 0 && ok;
+	qn_outputf("misc: %zu canceled, %s", cancels, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+int main(int argc, char* argv[])
+{
+	qn_runtime(NULL);
+
+	const char* path = argc > 1 ? argv[1] : "builds/res";
+	QnMount* disk = qn_open_mount(path, NULL);
+	if (disk == NULL)
+	{
+		qn_outputf("cannot open %s", path);
+		return 1;
+	}
+	collect(disk, "");
+	if (sample_count == 0)
+		return 1;
+
+	// 같은 파일로 압축한 HFS를 만든다
+	const HfsBatchItem item = { .filename = "", .srcfile = path, .codec = QNCODEC_LZ };
+	HfsBatchParam param = { .filename = "test_async.hfs" };
+	bool ok = qn_hfs_store_batch(&item, 1, &param);
+	qn_outputf("%s: %zu files, %llu bytes, hfs %llu bytes", path, sample_count, param.size, param.written);
+	// 압축하지 않은 HFS, 리눅스에서는 io_uring으로 바로 읽는다
+	const HfsBatchItem store_item = { .filename = "", .srcfile = path, .codec = QNCODEC_STORE };
+	HfsBatchParam store_param = { .filename = "test_async_store.hfs" };
+	ok = qn_hfs_store_batch(&store_item, 1, &store_param) && ok;
+	qn_outputf("backend: %s", qn_async_uring() ? "io_uring" : "threads");
+
+
+	QnMount* hfs = qn_open_mount("test_async.hfs", "h");
+	QnMount* store = qn_open_mount("test_async_store.hfs", "h");
+	QnMount* mapped = qn_open_mount("test_async.hfs", "hv");
+	QnMount* fuse = qn_create_fuse(NULL, false, false);
+	ok = hfs != NULL && store != NULL && mapped != NULL && qn_fuse_add_hfs(fuse, "test_async_store.hfs") && ok;
+	if (ok)
+	{
+		ok = bench("disk", disk, false) && ok;
+		ok = bench("hfs", hfs, false) && ok;
+		ok = bench("store", store, false) && ok;
+		ok = bench("mapped", mapped, true) && ok;
+		ok = bench("fuse", fuse, true) && ok;
+		ok = check_misc(disk) && ok;
+		ok = check_misc(hfs) && ok;
+		ok = check_misc(store) && ok;
+	}
+	qn_unload(fuse);
+	qn_unload(mapped);
+	qn_unload(store);
+	qn_unload(hfs);
+	qn_unload(disk);
+	qn_remove_file(NULL, "test_async.hfs");
+	qn_remove_file(NULL, "test_async_store.hfs");
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+
+	for (size_t i = 0; i < sample_count; i++)
+	{
+		qn_free(samples[i].name);
+		qn_free(samples[i].rooted);
+	}
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,254 @@
+﻿// 아톰 검사와 벤치마크, 여러 스레드에서 같은 문자열을 넣고 문자열 키 해시와 아톰 키 해시 찾기를 비교
+#include <qs.h>
+
+#define MAX_THREADS		4
+#define KEY_COUNT		20000
+#define LOOKUP_ROUND	200
+#define KEY_LENGTH		24
+
+// 문자열 키 해시 (키를 갖지 않는다)
+QN_DECLIMPL_HASH(StrHash, char*, int, qn_strphash, qn_strpcmp, (void), (void), _str_hash);
+// 아톰 키 해시
+QN_DECLIMPL_HASH_ATOM_AND_INT_TYPE(AtomHash, int, _atom_hash);
+// 아톰 키 묶음
+QN_DECLIMPL_MUKUM_ATOM_AND_INT_TYPE(AtomMukum, int, _atom_mukum);
+// 아톰 키 평평 해시
+QN_DECLIMPL_FLATHASH_ATOM_AND_INT_TYPE(AtomFlat, int, _atom_flat);
+
+static char keys[KEY_COUNT][KEY_LENGTH];
+static char copies[KEY_COUNT][KEY_LENGTH];			// 같은 내용 다른 포인터
+static QnAtom atoms[MAX_THREADS][KEY_COUNT];
+
+static void make_keys(void)
+{
+	for (int i = 0; i < KEY_COUNT; i++)
+	{
+		qn_snprintf(keys[i], KEY_LENGTH, "shader.uniform.%d", i);
+		qn_strcpy(copies[i], keys[i]);
+	}
+}
+
+// 스레드마다 다른 순서로 넣는다
+static void* intern_thread(void* data)
+{
+	const nint t = (nint)data;
+	for (int n = 0; n < KEY_COUNT; n++)
+	{
+		const int i = (int)((n * 7919 + t * 131) % KEY_COUNT);
+		atoms[t][i] = qn_atom(keys[i]);
+	}
+	return NULL;
+}
+
+// 검사용 노드
+static void node_dispose(QnGam g)
+{
+	qn_free(g);
+}
+
+static QnNodeGam* node_new(const char* name)
+{
+	static const QnVtableGam vt_node = { "NODE", node_dispose };
+	QnNodeGam* self = qn_alloc_zero_1(QnNodeGam);
+	qn_node_set_name(self, name);
+	return qn_gam_init(self, vt_node);
+}
+
+// 노드 이름은 묶음에 넣을 때만 아톰이 된다
+static bool check_nodes(void)
+{
+	bool ok = true;
+	QnNodeMukum mukum = { 0, };
+	qn_node_mukum_init(&mukum);
+
+	const size_t count = qn_atom_count();
+	QnNodeGam* loose = node_new("node.test.loose");
+	ok = loose->ATOM == NULL && loose->HASH == qn_strhash("node.test.loose") && ok;
+	ok = qn_atom_find("node.test.loose") == NULL && qn_atom_count() == count && ok;
+	qn_node_set_name(loose, "node.test.renamed");
+	ok = qn_atom_find("node.test.renamed") == NULL && qn_atom_count() == count && ok;
+	qn_unload(loose);
+
+	QnNodeGam* node = node_new("node.test.kept");
+	qn_node_mukum_add(&mukum, node);
+	ok = node->ATOM != NULL && node->ATOM == qn_atom_find("node.test.kept") && ok;
+	ok = node->HASH == qn_atom_hash(node->ATOM) && ok;
+	ok = qn_node_mukum_get(&mukum, "node.test.kept") == node && ok;
+	ok = qn_node_mukum_get(&mukum, "node.test.none") == NULL && ok;
+
+	// 이름을 바꾼 뒤에 넣어도 새 이름으로 찾는다
+	QnNodeGam* plain = node_new("node.test.before");
+	qn_node_set_name(plain, "node.test.plain");
+	qn_node_mukum_set(&mukum, plain);
+	ok = qn_atom_find("node.test.before") == NULL && ok;
+	ok = qn_node_mukum_get(&mukum, "node.test.plain") == plain && qn_node_mukum_count(&mukum) == 2 && ok;
+	qn_node_mukum_remove(&mukum, "node.test.plain");
+	ok = qn_node_mukum_get(&mukum, "node.test.plain") == NULL && qn_node_mukum_count(&mukum) == 1 && ok;
+	qn_node_mukum_unlink(&mukum, node);
+	ok = qn_node_mukum_get(&mukum, "node.test.kept") == NULL && qn_node_mukum_count(&mukum) == 0 && ok;
+	qn_unload(node);
+
+	qn_node_mukum_dispose(&mukum);
+	qn_outputf("nodes: %s", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 기본 동작
+static bool check_basic(void)
+{
+	bool ok = true;
+	const size_t count = qn_atom_count();
+
+	ok = qn_atom_find("atom.test.basic") == NULL && ok;
+	const QnAtom a = qn_atom("atom.test.basic");
+	char buf[32];
+	qn_strcpy(buf, "atom.test.basic");
+	ok = a != NULL && a == qn_atom(buf) && a != buf && ok;
+	ok = a == qn_atomn("atom.test.basic.more", 15) && ok;
+	ok = a == qn_atom_find(buf) && ok;
+	ok = qn_streqv(a, buf) && qn_atom_len(a) == 15 && qn_atom_hash(a) == qn_strhash(buf) && ok;
+	ok = qn_atom_from_id(qn_atom_id(a)) == a && ok;
+	ok = qn_atom_count() == count + 1 && ok;
+
+	// 빈 문자열과 NULL
+	const QnAtom e = qn_atom("");
+	ok = e != NULL && *e == '\0' && qn_atom_len(e) == 0 && e == qn_atomn("xyz", 0) && ok;
+	ok = qn_atom(NULL) == NULL && qn_atom_from_id(0) == NULL && qn_atom_from_id(UINT_MAX) == NULL && ok;
+
+	// 심볼은 아톰 번호, 예전처럼 63 글자 제한이 없다
+	const nint s = qn_sym("atom.test.basic");
+	ok = s == (nint)qn_atom_id(a) && qn_symstr(s) == a && ok;
+	char lng[128];
+	memset(lng, 'L', sizeof(lng) - 1);
+	lng[sizeof(lng) - 1] = '\0';
+	ok = qn_sym(lng) != 0 && qn_streqv(qn_symstr(qn_sym(lng)), lng) && ok;
+
+	// 없는 프로퍼티를 물어도 아톰이 늘지 않는다
+	const size_t before = qn_atom_count();
+	ok = qn_get_prop("atom.test.no.such.prop") == NULL && qn_atom_count() == before && ok;
+	qn_set_prop("atom.test.prop", "value");
+	ok = qn_streqv(qn_get_prop("atom.test.prop"), "value") && ok;
+	ok = qn_streqv(qn_get_prop("QSLIB"), qn_version()) && ok;
+
+	qn_outputf("basic: %s", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 여러 스레드에서 같은 키를 넣으면 모두 같은 아톰
+static bool check_threads(void)
+{
+	const size_t count = qn_atom_count();
+	QnThread* threads[MAX_THREADS];
+	for (nint t = 0; t < MAX_THREADS; t++)
+		threads[t] = qn_new_thread("atom", intern_thread, (void*)t, 0, 0);
+	const double start = qn_elapsed();
+	for (int t = 0; t < MAX_THREADS; t++)
+		qn_thread_start(threads[t]);
+	for (int t = 0; t < MAX_THREADS; t++)
+		qn_thread_wait(threads[t]);
+	const double elapsed = qn_elapsed() - start;
+	for (int t = 0; t < MAX_THREADS; t++)
+		qn_delete_thread(threads[t]);
+
+	bool ok = qn_atom_count() == count + KEY_COUNT;
+	for (int i = 0; i < KEY_COUNT && ok; i++)
+	{
+		const QnAtom a = atoms[0][i];
+		for (int t = 1; t < MAX_THREADS; t++)
+			ok = atoms[t][i] == a && ok;
+		ok = a != NULL && qn_streqv(a, keys[i]) && qn_atom(copies[i]) == a && qn_atom_from_id(qn_atom_id(a)) == a && ok;
+	}
+	qn_outputf("threads: %d x %d keys, %.3f ms, atoms %zu, %s", MAX_THREADS, KEY_COUNT, elapsed * 1000.0, qn_atom_count(), ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 아톰 키 컨테이너
+static bool check_containers(void)
+{
+	AtomHash hash;
+	AtomMukum mukum;
+	AtomFlat flat;
+	_atom_hash_init(&hash);
+	_atom_mukum_init(&mukum);
+	_atom_flat_init(&flat);
+	for (int i = 0; i < KEY_COUNT; i++)
+	{
+		_atom_hash_set(&hash, atoms[0][i], i);
+		_atom_mukum_set(&mukum, atoms[0][i], i);
+		_atom_flat_set(&flat, atoms[0][i], i);
+	}
+	bool ok = _atom_hash_count(&hash) == KEY_COUNT && _atom_mukum_count(&mukum) == KEY_COUNT && _atom_flat_count(&flat) == KEY_COUNT;
+	for (int i = 0; i < KEY_COUNT && ok; i++)
+	{
+		const QnAtom a = qn_atom_find(copies[i]);
+		const int* h = _atom_hash_get(&hash, a);
+		const int* m = _atom_mukum_get(&mukum, a);
+		const int* f = _atom_flat_get(&flat, a);
+		ok = h != NULL && *h == i && m != NULL && *m == i && f != NULL && *f == i && ok;
+	}
+	ok = _atom_hash_get(&hash, qn_atom("atom.test.basic")) == NULL && ok;
+	_atom_hash_dispose(&hash);
+	_atom_mukum_dispose(&mukum);
+	_atom_flat_dispose(&flat);
+	qn_outputf("containers: %s", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 찾기 벤치마크, 문자열 키는 매번 해시하고 strcmp로 비교하고 아톰 키는 해시를 읽고 포인터로 비교한다
+static void bench(void)
+{
+	StrHash shash;
+	AtomHash ahash;
+	_str_hash_init(&shash);
+	_atom_hash_init(&ahash);
+	for (int i = 0; i < KEY_COUNT; i++)
+	{
+		_str_hash_set(&shash, keys[i], i);
+		_atom_hash_set(&ahash, atoms[0][i], i);
+	}
+
+	size_t sum = 0;
+	double start = qn_elapsed();
+	for (int r = 0; r < LOOKUP_ROUND; r++)
+		for (int i = 0; i < KEY_COUNT; i++)
+			sum += (size_t)*_str_hash_get(&shash, copies[i]);
+	const double str_time = qn_elapsed() - start;
+
+	start = qn_elapsed();
+	for (int r = 0; r < LOOKUP_ROUND; r++)
+		for (int i = 0; i < KEY_COUNT; i++)
+			sum += (size_t)*_atom_hash_get(&ahash, atoms[0][i]);
+	const double atom_time = qn_elapsed() - start;
+
+	// 문자열에서 아톰을 얻어 찾는 경우 (한번 더 해시한다)
+	start = qn_elapsed();
+	for (int r = 0; r < LOOKUP_ROUND; r++)
+		for (int i = 0; i < KEY_COUNT; i++)
+			sum += (size_t)*_atom_hash_get(&ahash, qn_atom_find(copies[i]));
+	const double find_time = qn_elapsed() - start;
+
+	const double lookups = (double)KEY_COUNT * LOOKUP_ROUND;
+	qn_outputf("%-12s %10s %12s", "lookup", "ms", "Mlookup/s");
+	qn_outputf("%-12s %10.3f %12.2f", "pchar", str_time * 1000.0, lookups / str_time / 1000000.0);
+	qn_outputf("%-12s %10.3f %12.2f", "atom", atom_time * 1000.0, lookups / atom_time / 1000000.0);
+	qn_outputf("%-12s %10.3f %12.2f  (%zx)", "find+atom", find_time * 1000.0, lookups / find_time / 1000000.0, sum & 0xFF);
+
+	_str_hash_dispose(&shash);
+	_atom_hash_dispose(&ahash);
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+
+	make_keys();
+	bool ok = check_basic();
+	ok = check_threads() && ok;
+	ok = check_containers() && ok;
+	ok = check_nodes() && ok;
+	bench();
+
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,215 @@
+﻿// 압축 코덱 벤치마크, builds/res 파일들로
+#include <qs.h>
+
+#define MAX_FILES		256
+#define BENCH_BYTES		(64 * 1024 * 1024)	// 이만큼은 돌려야 시간이 잴만하다
+
+typedef struct SAMPLE
+{
+	char*			name;
+	byte*			data;
+	size_t			size;
+} Sample;
+
+static Sample samples[MAX_FILES];
+static size_t sample_count;
+static size_t sample_bytes;
+static int bench_round;
+
+// 파일을 모두 읽는다
+static void collect(QnMount* mnt, const char* path)
+{
+	QnDir* dir = qn_open_dir(mnt, path, NULL);
+	if (dir == NULL)
+		return;
+	QnFileInfo fi;
+	while (qn_dir_read_info(dir, &fi))
+	{
+		if (fi.name[0] == '.')
+			continue;
+		char* full = qn_strdupcat(path, fi.name, QN_TMASK(fi.attr, QNFATTR_DIR) ? "/" : NULL, NULL);
+		if (QN_TMASK(fi.attr, QNFATTR_DIR))
+		{
+			collect(mnt, full);
+			qn_free(full);
+			continue;
+		}
+		int size;
+		byte* data = sample_count < MAX_FILES ? qn_file_alloc(mnt, full, &size) : NULL;
+		if (data == NULL || size <= 0)
+		{
+			qn_free(data);
+			qn_free(full);
+			continue;
+		}
+		samples[sample_count++] = (Sample){ full, data, (size_t)size };
+		sample_bytes += (size_t)size;
+	}
+	qn_unload(dir);
+}
+
+// 압축하고 풀어서 시간을 잰다
+static bool bench(const char* name, QnCodec codec, int level)
+{
+	size_t cmpr_bytes = 0;
+	double cmpr_time = 0.0, ucp_time = 0.0;
+	bool ok = true;
+	for (size_t i = 0; i < sample_count; i++)
+	{
+		const Sample* s = &samples[i];
+		byte* buf = qn_alloc(qn_memcpr_bound(codec, s->size), byte);
+		byte* out = qn_alloc(s->size + 16, byte);
+		size_t size = 0;
+
+		double start = qn_elapsed();
+		for (int r = 0; r < bench_round; r++)
+			size = qn_memcpr_raw(codec, level, buf, s->data, s->size);
+		cmpr_time += qn_elapsed() - start;
+		cmpr_bytes += size;
+
+		start = qn_elapsed();
+		for (int r = 0; r < bench_round; r++)
+			if (qn_memucp_raw(codec, out, s->size, buf, size) == false)
+				ok = false;
+		ucp_time += qn_elapsed() - start;
+		if (memcmp(out, s->data, s->size) != 0)
+			ok = false;
+
+		qn_free(buf);
+		qn_free(out);
+	}
+	const double mb = (double)sample_bytes * bench_round / (1024.0 * 1024.0);
+	qn_outputf("%-10s %5d %10zu %7.2f%% %10.2f %10.2f  %s", name, level, cmpr_bytes,
+		(double)cmpr_bytes * 100.0 / (double)sample_bytes, mb / cmpr_time, mb / ucp_time, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 예전 방식, 크기를 모르고 해제
+static void bench_legacy(void)
+{
+	double ucp_time = 0.0;
+	for (size_t i = 0; i < sample_count; i++)
+	{
+		const Sample* s = &samples[i];
+		size_t size;
+		byte* buf = qn_memzcpr(s->data, s->size, &size);
+		const double start = qn_elapsed();
+		for (int r = 0; r < bench_round; r++)
+		{
+			size_t out_size;
+			qn_free(qn_memzucp(buf, size, &out_size));
+		}
+		ucp_time += qn_elapsed() - start;
+		qn_free(buf);
+	}
+	const double mb = (double)sample_bytes * bench_round / (1024.0 * 1024.0);
+	qn_outputf("%-10s %5s %10s %8s %10s %10.2f", "zucp", "-", "-", "-", "-", mb / ucp_time);
+}
+
+// 헤더 붙은 압축과 엉터리 입력
+static bool check_frame(void)
+{
+	bool ok = true;
+	for (size_t i = 0; i < sample_count; i++)
+	{
+		const Sample* s = &samples[i];
+		for (QnCodec c = QNCODEC_STORE; c < QNCODEC_MAX_VALUE; c++)
+		{
+			size_t size, out_size;
+			byte* buf = qn_memcpr(c, 0, s->data, s->size, &size);
+			byte* out = qn_memucp(buf, size, &out_size);
+			if (out == NULL || out_size != s->size || memcmp(out, s->data, s->size) != 0)
+				ok = false;
+			qn_free(out);
+			// 잘린 입력은 실패해야 한다
+			if (size > 16)
+			{
+				out = qn_memucp(buf, size - 7, &out_size);
+				if (out != NULL && c != QNCODEC_DEFLATE)
+					ok = false;
+				qn_free(out);
+			}
+			qn_free(buf);
+		}
+	}
+	qn_outputf("frame: %s", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 출력이 모자라면 버퍼 밖에 쓰지 않고 실패해야 한다 (ASan 빌드에서 본다)
+static bool check_short_output(void)
+{
+	bool ok = true;
+	for (size_t i = 0; i < sample_count; i++)
+	{
+		const Sample* s = &samples[i];
+		if (s->size < 2)
+			continue;
+		byte* buf = qn_alloc(qn_memcpr_bound(QNCODEC_DEFLATE, s->size), byte);
+		const size_t size = qn_memcpr_raw(QNCODEC_DEFLATE, 0, buf, s->data, s->size);
+		const size_t cap = s->size / 2;
+		byte* out = (byte*)malloc(cap);
+		if (qn_memucp_raw(QNCODEC_DEFLATE, out, cap, buf, size))
+			ok = false;
+		free(out);
+		qn_free(buf);
+	}
+
+	// 저장 블럭: 마지막 블럭, 길이 1000
+	byte stored[5 + 1000];
+	stored[0] = 0x01;
+	stored[1] = 1000 & 0xFF, stored[2] = 1000 >> 8;
+	stored[3] = (byte)~stored[1], stored[4] = (byte)~stored[2];
+	memset(stored + 5, 'S', 1000);
+	byte* out = (byte*)malloc(10);
+	if (qn_memucp_raw(QNCODEC_DEFLATE, out, 10, stored, sizeof(stored)))
+		ok = false;
+	free(out);
+	out = (byte*)malloc(1000);
+	if (qn_memucp_raw(QNCODEC_DEFLATE, out, 1000, stored, sizeof(stored)) == false || out[999] != 'S')
+		ok = false;
+	free(out);
+
+	qn_outputf("short output: %s", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+int main(int argc, char* argv[])
+{
+	qn_runtime(NULL);
+
+	const char* path = argc > 1 ? argv[1] : "builds/res";
+	QnMount* mnt = qn_open_mount(path, NULL);
+	if (mnt == NULL)
+	{
+		qn_outputf("cannot open %s", path);
+		return 1;
+	}
+	collect(mnt, "");
+	qn_unload(mnt);
+	qn_outputf("%s: %zu files, %zu bytes", path, sample_count, sample_bytes);
+	if (sample_count == 0)
+		return 1;
+	bench_round = (int)QN_MAX(BENCH_BYTES / sample_bytes, 1);
+
+	bool ok = check_frame();
+	ok = check_short_output() && ok;
+	qn_outputf("%-10s %5s %10s %8s %10s %10s  (MB/sec)", "codec", "level", "size", "ratio", "compress", "decompress");
+	ok = bench("deflate", QNCODEC_DEFLATE, 1) && ok;
+	ok = bench("deflate", QNCODEC_DEFLATE, 5) && ok;
+	ok = bench("deflate", QNCODEC_DEFLATE, 8) && ok;
+	bench_legacy();
+	ok = bench("lz", QNCODEC_LZ, 1) && ok;
+	ok = bench("lz", QNCODEC_LZ, 3) && ok;
+	ok = bench("lz", QNCODEC_LZ, 6) && ok;
+	ok = bench("lz", QNCODEC_LZ, 9) && ok;
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+
+	for (size_t i = 0; i < sample_count; i++)
+	{
+		qn_free(samples[i].name);
+		qn_free(samples[i].data);
+	}
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+﻿// CRC 검사 및 벤치마크
+#include <qs.h>
+
+#define BENCH_SIZE		(16 * 1024 * 1024)
+#define BENCH_ROUND		8
+
+// 비트 단위 기준 구현
+static ullong ref_crc(const ullong poly, const int width, const byte* p, size_t size)
+{
+	const ullong mask = width == 64 ? ~0ULL : (1ULL << width) - 1;
+	ullong crc = mask;
+	for (; size; p++, size--)
+	{
+		crc ^= *p;
+		for (int b = 0; b < 8; b++)
+			crc = (crc >> 1) ^ (poly & (0ULL - (crc & 1)));
+	}
+	return ~crc & mask;
+}
+
+static ullong ref_crc32(const byte* p, size_t size) { return ref_crc(0xEDB88320U, 32, p, size); }
+static ullong ref_crc32c(const byte* p, size_t size) { return ref_crc(0x82F63B78U, 32, p, size); }
+static ullong ref_crc64(const byte* p, size_t size) { return ref_crc(0x95AC9329AC4BC9B5ULL, 64, p, size); }
+
+static ullong new_crc32(const byte* p, size_t size) { return qn_crc32(0, p, size); }
+static ullong new_crc32c(const byte* p, size_t size) { return qn_crc32c(0, p, size); }
+static ullong new_crc64(const byte* p, size_t size) { return qn_crc64(0, p, size); }
+
+typedef ullong(*crc_func)(const byte*, size_t);
+
+// 길이와 정렬을 바꿔가며 기준 구현과 비교
+static int check(const char* name, QnCrcType type, crc_func ref, crc_func func, const byte* data)
+{
+	int fails = 0;
+	for (size_t size = 0; size < 1200; size += size < 300 ? 1 : 37)
+	{
+		for (size_t offset = 0; offset < 4; offset++)
+		{
+			const ullong r = ref(data + offset, size);
+			if (func(data + offset, size) != r)
+				fails++;
+			// 나눠서 계산
+			QnCrc crc;
+			qn_crc_init(&crc, type);
+			for (size_t i = 0, step = 1; i < size; i += step, step = step * 3 + 1)
+				qn_crc_update(&crc, data + offset + i, QN_MIN(step, size - i));
+			if (qn_crc_final(&crc) != r)
+				fails++;
+		}
+	}
+	qn_outputf("%-8s %s", name, fails == 0 ? "ok" : "FAIL");
+	return fails;
+}
+
+static void bench(const char* name, crc_func func, const byte* data)
+{
+	ullong sum = 0;
+	double start = qn_elapsed();
+	for (int r = 0; r < BENCH_ROUND; r++)
+		sum += func(data, BENCH_SIZE);
+	double elapsed = qn_elapsed() - start;
+	qn_outputf("%-8s %.3f sec, %.2f MB/sec (%llx)", name, elapsed,
+		(double)BENCH_SIZE * BENCH_ROUND / elapsed / (1024.0 * 1024.0), sum & 0xFF);
+}
+
+// 예전 방식, 한 바이트씩 테이블
+static ullong byte_table[256];
+static ullong byte_crc64(const byte* p, size_t size)
+{
+	ullong crc = ~0ULL;
+	for (; size; p++, size--)
+		crc = byte_table[(crc ^ *p) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+
+	const byte check_data[] = "123456789";
+	qn_outputf("check crc32=%08X, crc32c=%08X, crc64=%016llX",
+		qn_crc32(0, check_data, 9), qn_crc32c(0, check_data, 9), qn_crc64(0, check_data, 9));
+
+	byte* data = qn_alloc(BENCH_SIZE, byte);
+	QnRandom rnd;
+	qn_srand(&rnd, 1234);
+	for (size_t i = 0; i < BENCH_SIZE; i++)
+		data[i] = (byte)qn_rand(&rnd);
+
+	int fails = 0;
+	fails += check("crc32", QNCRC_32, ref_crc32, new_crc32, data);
+	fails += check("crc32c", QNCRC_32C, ref_crc32c, new_crc32c, data);
+	fails += check("crc64", QNCRC_64, ref_crc64, new_crc64, data);
+
+	for (uint i = 0; i < 256; i++)
+	{
+		ullong c = i;
+		for (int b = 0; b < 8; b++)
+			c = (c >> 1) ^ (0x95AC9329AC4BC9B5ULL & (0ULL - (c & 1)));
+		byte_table[i] = c;
+	}
+	bench("byte64", byte_crc64, data);
+	bench("crc32", new_crc32, data);
+	bench("crc32c", new_crc32c, data);
+	bench("crc64", new_crc64, data);
+
+	qn_free(data);
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return fails;
+}
@@ -0,0 +1,94 @@
+﻿// 평평 해시 대 묶음 벤치마크
+#include <qs.h>
+
+#define KEY_COUNT		100000
+#define LOOKUP_ROUND	10
+
+QN_DECLIMPL_MUKUM_INT_AND_INT_TYPE(IntMukum, int, int, int_mukum);
+QN_DECLIMPL_FLATHASH_INT_AND_INT_TYPE(IntFlat, int, int, int_flat);
+QN_DECLIMPL_MUKUM(StrMukum, char*, int, qn_strphash, qn_strpcmp, (void), (void), str_mukum);
+QN_DECLIMPL_FLATHASH(StrFlat, char*, int, qn_strphash, qn_strpcmp, (void), (void), str_flat);
+
+// 넣은 순서와 다르게 찾는다
+#define LOOKUP_ORDER(i)	((int)(((size_t)(i) * 7919) % KEY_COUNT))
+
+static char* str_keys[KEY_COUNT];
+
+static void report(const char* name, const char* what, double elapsed, double ops)
+{
+	qn_outputf("%-8s %-8s %.3f sec, %.2f Mops/sec", name, what, elapsed, ops / elapsed / 1000000.0);
+}
+
+// 같은 함수를 묶음과 평평 해시에 쓰려고 매크로로
+#define BENCH_INT(TYPE, PFX)																		\
+	static void bench_##PFX(void)																	\
+	{																								\
+		TYPE hash;																					\
+		PFX##_init(&hash);																			\
+		double start = qn_elapsed();																\
+		for (int i = 0; i < KEY_COUNT; i++)															\
+			PFX##_set(&hash, i * 2654435761U, i);													\
+		report(#PFX, "insert", qn_elapsed() - start, KEY_COUNT);									\
+		ullong sum = 0;																				\
+		start = qn_elapsed();																		\
+		for (int r = 0; r < LOOKUP_ROUND; r++)														\
+			for (int i = 0; i < KEY_COUNT; i++)														\
+				sum += (ullong)*PFX##_get(&hash, LOOKUP_ORDER(i) * 2654435761U);											\
+		report(#PFX, "hit", qn_elapsed() - start, (double)KEY_COUNT * LOOKUP_ROUND);				\
+		start = qn_elapsed();																		\
+		for (int r = 0; r < LOOKUP_ROUND; r++)														\
+			for (int i = 0; i < KEY_COUNT; i++)														\
+				sum += PFX##_get(&hash, LOOKUP_ORDER(i) * 2654435761U + 1) != NULL;								\
+		report(#PFX, "miss", qn_elapsed() - start, (double)KEY_COUNT * LOOKUP_ROUND);				\
+		start = qn_elapsed();																		\
+		for (int i = 0; i < KEY_COUNT; i++)															\
+			PFX##_remove(&hash, i * 2654435761U);													\
+		report(#PFX, "remove", qn_elapsed() - start, KEY_COUNT);									\
+		qn_outputf("%-8s left: %d, sum: %llu", #PFX, (int)PFX##_count(&hash), sum);					\
+		PFX##_dispose(&hash);																		\
+	}
+BENCH_INT(IntMukum, int_mukum)
+BENCH_INT(IntFlat, int_flat)
+
+#define BENCH_STR(TYPE, PFX)																		\
+	static void bench_##PFX(void)																	\
+	{																								\
+		TYPE hash;																					\
+		PFX##_init(&hash);																			\
+		double start = qn_elapsed();																\
+		for (int i = 0; i < KEY_COUNT; i++)															\
+			PFX##_set(&hash, str_keys[i], i);														\
+		report(#PFX, "insert", qn_elapsed() - start, KEY_COUNT);									\
+		ullong sum = 0;																				\
+		start = qn_elapsed();																		\
+		for (int r = 0; r < LOOKUP_ROUND; r++)														\
+			for (int i = 0; i < KEY_COUNT; i++)														\
+				sum += (ullong)*PFX##_get(&hash, str_keys[LOOKUP_ORDER(i)]);												\
+		report(#PFX, "hit", qn_elapsed() - start, (double)KEY_COUNT * LOOKUP_ROUND);				\
+		start = qn_elapsed();																		\
+		for (int i = 0; i < KEY_COUNT; i++)															\
+			PFX##_remove(&hash, str_keys[i]);														\
+		report(#PFX, "remove", qn_elapsed() - start, KEY_COUNT);									\
+		qn_outputf("%-8s left: %d, sum: %llu", #PFX, (int)PFX##_count(&hash), sum);					\
+		PFX##_dispose(&hash);																		\
+	}
+BENCH_STR(StrMukum, str_mukum)
+BENCH_STR(StrFlat, str_flat)
+
+int main(void)
+{
+	qn_runtime(NULL);
+
+	bench_int_mukum();
+	bench_int_flat();
+
+	for (int i = 0; i < KEY_COUNT; i++)
+		str_keys[i] = qn_apsprintf("symbol_%d_name", i);
+	bench_str_mukum();
+	bench_str_flat();
+	for (int i = 0; i < KEY_COUNT; i++)
+		qn_free(str_keys[i]);
+
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return 0;
+}
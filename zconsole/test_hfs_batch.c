@@ -0,0 +1,179 @@
+﻿// HFS 묶음 저장 벤치마크, 하나씩 넣기와 스레드 갯수에 따른 묶음 저장 속도
+#include <qs.h>
+#include <errno.h>
+
+#define MAX_FILES		4096
+#define STAMP			((QnTimeStamp)0x1234567890ULL)
+
+static char* names[MAX_FILES];
+static size_t name_count;
+static size_t total_bytes;
+
+// 디스크 파일 이름을 모은다
+static void collect(QnMount* mnt, const char* path)
+{
+	QnDir* dir = qn_open_dir(mnt, path, NULL);
+	if (dir == NULL)
+		return;
+	QnFileInfo fi;
+	while (qn_dir_read_info(dir, &fi))
+	{
+		if (fi.name[0] == '.')
+			continue;
+		char* full = qn_strdupcat(path, fi.name, QN_TMASK(fi.attr, QNFATTR_DIR) ? "/" : NULL, NULL);
+		if (QN_TMASK(fi.attr, QNFATTR_DIR))
+		{
+			collect(mnt, full);
+			qn_free(full);
+		}
+		else if (fi.size > 0 && name_count < MAX_FILES)
+		{
+			names[name_count++] = full;
+			total_bytes += (size_t)fi.size;
+		}
+		else
+			qn_free(full);
+	}
+	qn_unload(dir);
+}
+
+// 예전 방식, 하나씩 넣는다
+static double store_serial(const char* path)
+{
+	const double start = qn_elapsed();
+	QnMount* hfs = qn_open_mount("test_batch_serial.hfs", "hc");
+	if (hfs == NULL)
+		return 0.0;
+	for (size_t i = 0; i < name_count; i++)
+	{
+		char dir[QN_MAX_PATH];
+		qn_divpath(names[i], dir, NULL);
+		// 디렉토리는 한 단계씩 만든다
+		for (char* p = strchr(dir, '/'); p != NULL; p = strchr(p + 1, '/'))
+		{
+			*p = '\0';
+			qn_mkdir(hfs, dir);
+			*p = '/';
+		}
+		char* src = qn_strdupcat(path, "/", names[i], NULL);
+		qn_hfs_store_file(hfs, names[i], src, QNCODEC_DEFLATE, QNFTYPE_UNKNOWN);
+		qn_free(src);
+	}
+	qn_unload(hfs);
+	return qn_elapsed() - start;
+}
+
+// 만든 HFS를 디스크 파일과 비교
+static bool verify(const char* filename, const char* mode, const char* path)
+{
+	QnMount* hfs = qn_open_mount(filename, mode);
+	if (hfs == NULL)
+		return false;
+	bool ok = true;
+	for (size_t i = 0; i < name_count; i++)
+	{
+		char* src = qn_strdupcat(path, "/", names[i], NULL);
+		int size, src_size;
+		byte* data = qn_file_alloc(hfs, names[i], &size);
+		byte* expect = qn_file_alloc(NULL, src, &src_size);
+		if (data == NULL || expect == NULL || size != src_size || memcmp(data, expect, (size_t)size) != 0)
+			ok = false;
+		qn_free(data);
+		qn_free(expect);
+		qn_free(src);
+	}
+	if (qn_get_file_attr(hfs, "/extra/memory.txt") == QNFATTR_NONE)
+		ok = false;
+	qn_unload(hfs);
+	return ok;
+}
+
+int main(int argc, char* argv[])
+{
+	qn_runtime(NULL);
+
+	const char* path = argc > 1 ? argv[1] : "builds/res";
+	QnMount* mnt = qn_open_mount(path, NULL);
+	if (mnt == NULL)
+	{
+		qn_outputf("cannot open %s", path);
+		return 1;
+	}
+	collect(mnt, "");
+	qn_unload(mnt);
+	qn_outputf("%s: %zu files, %zu bytes, cores: %u", path, name_count, total_bytes, qn_cpu_count());
+	if (name_count == 0)
+		return 1;
+
+	const double serial = store_serial(path);
+	qn_outputf("%-8s %10.3f ms %10.2f MB/sec", "serial", serial * 1000.0, (double)total_bytes / serial / (1024.0 * 1024.0));
+
+	static const char memory[] = "batch item from memory";
+	const HfsBatchItem items[] =
+	{
+		{ .filename = "/", .srcfile = path, .codec = QNCODEC_DEFLATE },
+		{ .filename = "extra/memory.txt", .data = memory, .size = sizeof(memory), .codec = QNCODEC_LZ },
+		{ .filename = "extra/empty" },
+	};
+	HfsBatchParam param = { .filename = "test_batch.hfs", .desc = "batch test", .stamp = STAMP };
+
+	bool ok = true;
+	byte* first = NULL;
+	int first_size = 0;
+	const uint max_threads = QN_MAX(qn_cpu_count(), 4);
+	double base = 0.0;
+	qn_outputf("%7s %10s %10s %8s %6s %6s %10s", "threads", "ms", "MB/sec", "speedup", "files", "dirs", "size");
+	for (uint threads = 1; threads <= max_threads; threads *= 2)
+	{
+		qn_parallel_threads(threads);
+		if (qn_hfs_store_batch(items, QN_COUNTOF(items), &param) == false)
+		{
+			qn_outputf("batch failed: %d", errno);
+			ok = false;
+			break;
+		}
+		if (threads == 1)
+			base = param.elapsed;
+		qn_outputf("%7u %10.3f %10.2f %7.2fx %6u %6u %10llu", threads, param.elapsed * 1000.0, param.mbps,
+			base / param.elapsed, param.files, param.dirs, param.written);
+
+		// 스레드 갯수와 상관없이 바이트까지 같아야 한다
+		int size;
+		byte* data = qn_file_alloc(NULL, "test_batch.hfs", &size);
+		if (first == NULL)
+		{
+			first = data;
+			first_size = size;
+		}
+		else
+		{
+			if (data == NULL || size != first_size || memcmp(data, first, (size_t)size) != 0)
+				ok = false;
+			qn_free(data);
+		}
+	}
+	qn_free(first);
+	qn_outputf("reproducible: %s", ok ? "ok" : "FAIL");
+
+	const bool read_ok = verify("test_batch.hfs", "h", path) && verify("test_batch.hfs", "hv", path) &&
+		verify("test_batch.hfs", "hf", path);
+	qn_outputf("read back: %s", read_ok ? "ok" : "FAIL");
+	ok = read_ok && ok;
+
+	// 같은 이름은 실패해야 한다
+	const HfsBatchItem dups[] =
+	{
+		{ .filename = "a/b.txt", .data = memory, .size = sizeof(memory) },
+		{ .filename = "A/B.TXT", .data = memory, .size = sizeof(memory) },
+	};
+	HfsBatchParam dup_param = { .filename = "test_batch_dup.hfs" };
+	const bool dup_ok = qn_hfs_store_batch(dups, QN_COUNTOF(dups), &dup_param) == false && errno == EEXIST;
+	qn_outputf("duplicate: %s", dup_ok ? "ok" : "FAIL");
+	ok = dup_ok && ok;
+
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+	for (size_t i = 0; i < name_count; i++)
+		qn_free(names[i]);
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
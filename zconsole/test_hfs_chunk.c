@@ -0,0 +1,165 @@
+﻿// HFS 조각 압축 스트림 테스트, 큰 파일을 열어서 첫 바이트까지 시간과 탐색
+#include <qs.h>
+
+#define DATA_SIZE		(16 * 1024 * 1024 + 12345)
+#define SEEK_COUNT		2000
+#define HFS_CHUNK_TEST_SHIFT	16			// HFS 조각 크기
+
+// 압축은 되지만 너무 잘 되지는 않는 데이터
+static byte* make_data(void)
+{
+	byte* data = qn_alloc(DATA_SIZE, byte);
+	QnRandom rnd;
+	qn_srand(&rnd, 1234);
+	for (size_t i = 0; i < DATA_SIZE; i++)
+		data[i] = (byte)(i % 251 < 200 ? 'a' + (i / 97) % 26 : qn_rand(&rnd));
+	return data;
+}
+
+static bool check(QnMount* mnt, const char* name, const byte* data)
+{
+	bool ok = true;
+	double start = qn_elapsed();
+	QnStream* stream = qn_open_stream(mnt, name, NULL);
+	byte first[256];
+	if (stream == NULL || qn_stream_read(stream, first, 0, (int)sizeof(first)) != (int)sizeof(first) ||
+		memcmp(first, data, sizeof(first)) != 0)
+		ok = false;
+	const double first_time = qn_elapsed() - start;
+
+	// 아무데나 읽기
+	QnRandom rnd;
+	qn_srand(&rnd, 5678);
+	byte buf[3000];
+	start = qn_elapsed();
+	for (int i = 0; stream != NULL && i < SEEK_COUNT; i++)
+	{
+		const llong pos = (llong)(qn_rand(&rnd) % DATA_SIZE);
+		const int want = (int)(qn_rand(&rnd) % sizeof(buf));
+		qn_stream_seek(stream, pos, QNSEEK_BEGIN);
+		const int got = qn_stream_read(stream, buf, 0, want);
+		const int expect = (int)QN_MIN((llong)want, DATA_SIZE - pos);
+		if (got != expect || memcmp(buf, data + pos, (size_t)got) != 0)
+			ok = false;
+	}
+	const double seek_time = qn_elapsed() - start;
+	if (stream != NULL && (qn_stream_seek(stream, -10, QNSEEK_END) != DATA_SIZE - 10 || qn_stream_read(stream, buf, 0, 100) != 10))
+		ok = false;
+	qn_unload(stream);
+
+	// 통째로 읽기
+	start = qn_elapsed();
+	int size;
+	byte* all = qn_file_alloc(mnt, name, &size);
+	const double all_time = qn_elapsed() - start;
+	if (all == NULL || size != DATA_SIZE || memcmp(all, data, DATA_SIZE) != 0)
+		ok = false;
+	qn_free(all);
+
+	qn_outputf("%-10s first byte: %8.3f ms, %d seeks: %8.3f ms, whole: %8.3f ms  %s", name,
+		first_time * 1000.0, SEEK_COUNT, seek_time * 1000.0, all_time * 1000.0, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 첫 조각을 조각 크기보다 길게 풀리는 데이터로 바꿔도 슬롯 밖에 쓰지 않고 읽기가 실패해야 한다 (ASAN으로 확인)
+static bool check_corrupt(const byte* data, QnCodec codec, const char* mode)
+{
+	QnMount* mnt = qn_open_mount("test_chunk_bad.hfs", "hc");
+	if (mnt == NULL)
+		return false;
+	bool ok = qn_hfs_store_data(mnt, "bad.bin", data, DATA_SIZE, codec, QNFTYPE_UNKNOWN);
+	qn_unload(mnt);
+
+	size_t size;
+	byte* file = qn_file_alloc64(NULL, "test_chunk_bad.hfs", &size);
+	if (file == NULL)
+		return false;
+	// 조각 헤더 'HFSC' 찾기, 헤더 12바이트 다음 32비트 위치 표
+	const uint magic = QN_FOURCC('H', 'F', 'S', 'C');
+	size_t at = 0;
+	while (at + 12 < size && memcmp(file + at, &magic, sizeof(uint)) != 0)
+		at++;
+	uint count, first[2];
+	memcpy(&count, file + at + 8, sizeof(uint));
+	memcpy(first, file + at + 12, sizeof(first));
+	const size_t chunk0 = at + 12 + sizeof(uint) * ((size_t)count + 1) + first[0];
+
+	// 0으로 된 256KB를 압축하면 첫 조각 자리에 들어간다
+	const size_t zero_size = 256 * 1024;
+	byte* zero = qn_alloc_zero(zero_size, byte);
+	byte* cmpr = qn_alloc(qn_memcpr_bound(codec, zero_size), byte);
+	const size_t cmpr_size = qn_memcpr_raw(codec, 0, cmpr, zero, zero_size);
+	ok = at + 12 < size && cmpr_size > 0 && cmpr_size < first[1] - first[0] && ok;
+	if (ok)
+		memcpy(file + chunk0, cmpr, cmpr_size);
+	qn_free(zero);
+	qn_free(cmpr);
+	QnStream* out = qn_open_stream(NULL, "test_chunk_bad.hfs", "wb");
+	ok = out != NULL && qn_stream_write64(out, file, (llong)size) == (llong)size && ok;
+	qn_unload(out);
+	qn_free(file);
+
+	// 첫 조각은 못 읽고 다음 조각은 읽는다
+	mnt = qn_open_mount("test_chunk_bad.hfs", mode);
+	QnStream* stream = mnt != NULL ? qn_open_stream(mnt, "bad.bin", NULL) : NULL;
+	byte buf[3000];
+	ok = stream != NULL && qn_stream_read(stream, buf, 0, (int)sizeof(buf)) <= 0 && ok;
+	const llong next = 1LL << HFS_CHUNK_TEST_SHIFT;
+	ok = stream != NULL && qn_stream_seek(stream, next, QNSEEK_BEGIN) == next &&
+		qn_stream_read(stream, buf, 0, (int)sizeof(buf)) == (int)sizeof(buf) && memcmp(buf, data + next, sizeof(buf)) == 0 && ok;
+	qn_unload(stream);
+	// 통째로 읽기도 실패
+	size_t all_size;
+	byte* all = mnt != NULL ? qn_file_alloc64(mnt, "bad.bin", &all_size) : NULL;
+	ok = mnt != NULL && all == NULL && ok;
+	qn_free(all);
+	qn_unload(mnt);
+	qn_remove_file(NULL, "test_chunk_bad.hfs");
+
+	qn_outputf("corrupt %s [mode %s]: %s", codec == QNCODEC_LZ ? "lz" : "deflate", mode, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+	byte* data = make_data();
+
+	QnMount* mnt = qn_open_mount("test_chunk.hfs", "hc");
+	if (mnt == NULL)
+	{
+		qn_outputs("cannot create test_chunk.hfs");
+		return 1;
+	}
+	qn_hfs_store_data(mnt, "deflate.bin", data, DATA_SIZE, QNCODEC_DEFLATE, QNFTYPE_UNKNOWN);
+	qn_hfs_store_data(mnt, "lz.bin", data, DATA_SIZE, QNCODEC_LZ, QNFTYPE_UNKNOWN);
+	qn_hfs_store_data(mnt, "store.bin", data, DATA_SIZE, QNCODEC_STORE, QNFTYPE_UNKNOWN);
+	qn_unload(mnt);
+
+	bool ok = true;
+	static const char* modes[] = { "h", "hv", "hm" };
+	for (size_t m = 0; m < QN_COUNTOF(modes); m++)
+	{
+		mnt = qn_open_mount("test_chunk.hfs", modes[m]);
+		if (mnt == NULL)
+		{
+			ok = false;
+			continue;
+		}
+		qn_outputf("[mode %s]", modes[m]);
+		ok = check(mnt, "deflate.bin", data) && ok;
+		ok = check(mnt, "lz.bin", data) && ok;
+		ok = check(mnt, "store.bin", data) && ok;
+		qn_unload(mnt);
+	}
+	qn_remove_file(NULL, "test_chunk.hfs");
+
+	ok = check_corrupt(data, QNCODEC_DEFLATE, "h") && ok;
+	ok = check_corrupt(data, QNCODEC_DEFLATE, "hm") && ok;
+	ok = check_corrupt(data, QNCODEC_LZ, "h") && ok;
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+
+	qn_free(data);
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,247 @@
+﻿// HFS 중복 제거 테스트, 같은 내용은 한번만 쓰고 링크로 읽는다
+#include <qs.h>
+
+#define SMALL_SIZE		(100 * 1024 + 13)
+#define BIG_SIZE		(3 * 1024 * 1024 + 77)		// 조각 압축 크기
+#define STAMP			((QnTimeStamp)0x1234567890ULL)
+
+// 압축은 되지만 너무 잘 되지는 않는 데이터
+static byte* make_data(size_t size, uint seed)
+{
+	byte* data = qn_alloc(size, byte);
+	QnRandom rnd;
+	qn_srand(&rnd, seed);
+	for (size_t i = 0; i < size; i++)
+		data[i] = (byte)(i % 251 < 200 ? 'a' + (i / 97 + seed) % 26 : qn_rand(&rnd));
+	return data;
+}
+
+static llong disk_size(const char* filename)
+{
+	QnStream* stream = qn_open_stream(NULL, filename, NULL);
+	const llong size = stream != NULL ? qn_stream_size(stream) : -1;
+	qn_unload(stream);
+	return size;
+}
+
+// 통째로 읽기와 스트림 읽기
+static bool check_file(QnMount* mnt, const char* name, const byte* data, size_t size)
+{
+	size_t got;
+	byte* all = qn_file_alloc64(mnt, name, &got);
+	bool ok = all != NULL && got == size && memcmp(all, data, size) == 0;
+	qn_free(all);
+
+	QnStream* stream = qn_open_stream(mnt, name, NULL);
+	byte buf[1000];
+	const llong pos = (llong)size / 2;
+	ok = stream != NULL && qn_stream_seek(stream, pos, QNSEEK_BEGIN) == pos &&
+		qn_stream_read(stream, buf, 0, (int)sizeof(buf)) == (int)sizeof(buf) &&
+		memcmp(buf, data + pos, sizeof(buf)) == 0 && ok;
+	qn_unload(stream);
+	return ok;
+}
+
+// 링크인가
+static bool is_link(QnMount* mnt, const char* name)
+{
+	return QN_TMASK(qn_get_file_attr(mnt, name), QNFATTR_LINK);
+}
+
+// 하나씩 넣기, 덧붙이기, 지우기, 최적화
+static bool test_store(const char* mode, const byte* small, const byte* big)
+{
+	QnMount* mnt = qn_open_mount("test_dedup.hfs", mode);
+	if (mnt == NULL)
+		return false;
+	bool ok = qn_mkdir(mnt, "sub");
+	ok = qn_hfs_store_data(mnt, "a.bin", small, SMALL_SIZE, QNCODEC_LZ, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "b.bin", small, SMALL_SIZE, QNCODEC_LZ, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "sub/c.bin", small, SMALL_SIZE, QNCODEC_LZ, QNFTYPE_ARCHIVE) && ok;
+	ok = qn_hfs_store_data(mnt, "deflate.bin", small, SMALL_SIZE, QNCODEC_DEFLATE, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "store1.bin", small, SMALL_SIZE, QNCODEC_STORE, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "sub/store2.bin", small, SMALL_SIZE, QNCODEC_STORE, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "big1.bin", big, BIG_SIZE, QNCODEC_LZ, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "sub/big2.bin", big, BIG_SIZE, QNCODEC_LZ, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "half.bin", small, SMALL_SIZE / 2, QNCODEC_LZ, QNFTYPE_UNKNOWN) && ok;
+	// 링크는 같은 코덱으로 넣은 같은 내용만
+	ok = is_link(mnt, "a.bin") == false && is_link(mnt, "b.bin") && is_link(mnt, "sub/c.bin") && ok;
+	ok = is_link(mnt, "deflate.bin") == false && is_link(mnt, "store1.bin") == false && is_link(mnt, "sub/store2.bin") && ok;
+	ok = is_link(mnt, "sub/big2.bin") && is_link(mnt, "half.bin") == false && ok;
+	qn_unload(mnt);
+	const llong created = disk_size("test_dedup.hfs");
+	// 중복 네 개 (작은 것 셋, 큰 것 하나)는 몸통이 없다
+	ok = created > 0 && created < SMALL_SIZE * 3 + BIG_SIZE && ok;
+	qn_outputf("[%s] create %lld bytes: %s", mode, created, ok ? "ok" : "FAIL");
+
+	// 덧붙이면 열 때 있던 파일과도 나눠 쓴다. 몸통을 가진 파일을 지워도 링크는 남는다
+	mnt = qn_open_mount("test_dedup.hfs", "h+");
+	if (mnt == NULL)
+		return false;
+	ok = qn_hfs_store_data(mnt, "sub/d.bin", small, SMALL_SIZE, QNCODEC_LZ, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "big3.bin", big, BIG_SIZE, QNCODEC_LZ, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "store3.bin", small, SMALL_SIZE, QNCODEC_STORE, QNFTYPE_UNKNOWN) && ok;
+	ok = is_link(mnt, "sub/d.bin") && is_link(mnt, "big3.bin") && is_link(mnt, "store3.bin") && ok;
+	ok = qn_remove_file(mnt, "a.bin") && qn_remove_file(mnt, "big1.bin") && ok;
+	qn_unload(mnt);
+	const llong appended = disk_size("test_dedup.hfs");
+	ok = appended - created < 4096 && ok;
+
+	static const char* modes[] = { "h", "hv", "hm", "hf" };
+	for (size_t m = 0; m < QN_COUNTOF(modes); m++)
+	{
+		mnt = qn_open_mount("test_dedup.hfs", modes[m]);
+		if (mnt == NULL)
+			return false;
+		bool mode_ok = qn_get_file_attr(mnt, "a.bin") == QNFATTR_NONE;
+		mode_ok = check_file(mnt, "b.bin", small, SMALL_SIZE) && mode_ok;
+		mode_ok = check_file(mnt, "sub/c.bin", small, SMALL_SIZE) && mode_ok;
+		mode_ok = check_file(mnt, "sub/d.bin", small, SMALL_SIZE) && mode_ok;
+		mode_ok = check_file(mnt, "deflate.bin", small, SMALL_SIZE) && mode_ok;
+		mode_ok = check_file(mnt, "sub/store2.bin", small, SMALL_SIZE) && mode_ok;
+		mode_ok = check_file(mnt, "store3.bin", small, SMALL_SIZE) && mode_ok;
+		mode_ok = check_file(mnt, "sub/big2.bin", big, BIG_SIZE) && mode_ok;
+		mode_ok = check_file(mnt, "big3.bin", big, BIG_SIZE) && mode_ok;
+		mode_ok = check_file(mnt, "half.bin", small, SMALL_SIZE / 2) && mode_ok;
+		qn_outputf("[%s] read %s: %s", mode, modes[m], mode_ok ? "ok" : "FAIL");
+		ok = mode_ok && ok;
+		qn_unload(mnt);
+	}
+
+	// 최적화하면 지운 파일이 빠지고 남은 링크는 몸통 하나를 나눠 쓴다
+	mnt = qn_open_mount("test_dedup.hfs", "h");
+	HfsOptimizeParam op = { .filename = "test_dedup_opt.hfs" };
+	ok = mnt != NULL && qn_hfs_optimize(mnt, &op) && ok;
+	qn_unload(mnt);
+	const llong optimized = disk_size("test_dedup_opt.hfs");
+	ok = optimized > 0 && optimized < appended && ok;
+	mnt = qn_open_mount("test_dedup_opt.hfs", "hv");
+	ok = mnt != NULL && check_file(mnt, "b.bin", small, SMALL_SIZE) && check_file(mnt, "sub/d.bin", small, SMALL_SIZE) &&
+		check_file(mnt, "store3.bin", small, SMALL_SIZE) && check_file(mnt, "big3.bin", big, BIG_SIZE) &&
+		is_link(mnt, "b.bin") != is_link(mnt, "sub/c.bin") && is_link(mnt, "sub/big2.bin") != is_link(mnt, "big3.bin") && ok;
+	qn_unload(mnt);
+
+	// 퓨즈로 읽기
+	QnMount* fuse = qn_create_fuse(NULL, false, false);
+	ok = fuse != NULL && qn_fuse_add_hfs(fuse, "test_dedup_opt.hfs") &&
+		check_file(fuse, "/sub/c.bin", small, SMALL_SIZE) && check_file(fuse, "/big3.bin", big, BIG_SIZE) && ok;
+	qn_unload(fuse);
+	qn_outputf("[%s] append %lld, optimize %lld bytes, fuse: %s", mode, appended, optimized, ok ? "ok" : "FAIL");
+
+	qn_remove_file(NULL, "test_dedup.hfs");
+	qn_remove_file(NULL, "test_dedup_opt.hfs");
+	return ok;
+}
+
+// 묶음 저장, 같은 입력이면 같은 파일이 나와야 한다
+static bool test_batch(const byte* small, const byte* big)
+{
+	const HfsBatchItem items[] =
+	{
+		{ .filename = "one.bin", .data = small, .size = SMALL_SIZE, .codec = QNCODEC_LZ },
+		{ .filename = "x/two.bin", .data = small, .size = SMALL_SIZE, .codec = QNCODEC_LZ },
+		{ .filename = "x/y/three.bin", .data = small, .size = SMALL_SIZE, .codec = QNCODEC_DEFLATE },
+		{ .filename = "x/y/four.bin", .data = small, .size = SMALL_SIZE, .codec = QNCODEC_DEFLATE },
+		{ .filename = "big1.bin", .data = big, .size = BIG_SIZE, .codec = QNCODEC_STORE },
+		{ .filename = "z/big2.bin", .data = big, .size = BIG_SIZE, .codec = QNCODEC_STORE },
+		{ .filename = "z/half.bin", .data = small, .size = SMALL_SIZE / 2, .codec = QNCODEC_LZ },
+	};
+	uint crc[2] = { 0, 0 };
+	bool ok = true;
+	for (int r = 0; r < 2; r++)
+	{
+		HfsBatchParam param = { .filename = "test_dedup_batch.hfs", .stamp = STAMP, .large = r != 0 };
+		ok = qn_hfs_store_batch(items, QN_COUNTOF(items), &param) && param.files == QN_COUNTOF(items) && param.links == 3 && ok;
+		ok = (ullong)disk_size("test_dedup_batch.hfs") == param.written && param.written < SMALL_SIZE * 2 + BIG_SIZE && ok;
+
+		QnMount* mnt = qn_open_mount("test_dedup_batch.hfs", r == 0 ? "h" : "hv");
+		for (size_t i = 0; mnt != NULL && i < QN_COUNTOF(items); i++)
+			ok = check_file(mnt, items[i].filename, items[i].data, items[i].size) && ok;
+		// 경로 순서로 넣으니까 four가 먼저다
+		ok = mnt != NULL && is_link(mnt, "x/two.bin") && is_link(mnt, "x/y/four.bin") == false && is_link(mnt, "x/y/three.bin") &&
+			is_link(mnt, "z/big2.bin") && is_link(mnt, "z/half.bin") == false && ok;
+		qn_unload(mnt);
+
+		// 한번 더 만들어서 비교
+		size_t size;
+		byte* first = qn_file_alloc64(NULL, "test_dedup_batch.hfs", &size);
+		ok = qn_hfs_store_batch(items, QN_COUNTOF(items), &param) && ok;
+		byte* second = qn_file_alloc64(NULL, "test_dedup_batch.hfs", &size);
+		crc[0] = first != NULL ? qn_crc32(0, first, size) : 0;
+		crc[1] = second != NULL ? qn_crc32(0, second, size) : 1;
+		ok = crc[0] == crc[1] && ok;
+		qn_free(first);
+		qn_free(second);
+		qn_outputf("batch [%s]: %u links, %llu bytes, crc %08X: %s", r == 0 ? "small" : "large", param.links, param.written,
+			crc[0], ok ? "ok" : "FAIL");
+	}
+	qn_remove_file(NULL, "test_dedup_batch.hfs");
+	return ok;
+}
+
+// v16 전 HFS에 덧붙이면 링크 없이 몸통을 모두 쓴다
+static bool test_legacy(const byte* small, const byte* big)
+{
+	QnMount* mnt = qn_open_mount("test_dedup_old.hfs", "hc");
+	if (mnt == NULL)
+		return false;
+	bool ok = qn_hfs_store_data(mnt, "first.bin", small, SMALL_SIZE, QNCODEC_LZ, QNFTYPE_UNKNOWN);
+	qn_unload(mnt);
+
+	// 헤더 버전 (4번째 바이트부터 ushort)을 15로
+	size_t size;
+	byte* file = qn_file_alloc64(NULL, "test_dedup_old.hfs", &size);
+	if (file == NULL)
+		return false;
+	const ushort old_version = 15;
+	memcpy(file + 4, &old_version, sizeof(ushort));
+	QnStream* out = qn_open_stream(NULL, "test_dedup_old.hfs", "wb");
+	ok = out != NULL && qn_stream_write64(out, file, (llong)size) == (llong)size && ok;
+	qn_unload(out);
+	qn_free(file);
+
+	mnt = qn_open_mount("test_dedup_old.hfs", "h+");
+	if (mnt == NULL)
+		return false;
+	ok = qn_hfs_store_data(mnt, "a.bin", small, SMALL_SIZE, QNCODEC_LZ, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "b.bin", small, SMALL_SIZE, QNCODEC_LZ, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "big1.bin", big, BIG_SIZE, QNCODEC_LZ, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "big2.bin", big, BIG_SIZE, QNCODEC_LZ, QNFTYPE_UNKNOWN) && ok;
+	ok = is_link(mnt, "a.bin") == false && is_link(mnt, "b.bin") == false && is_link(mnt, "first.bin") == false &&
+		is_link(mnt, "big1.bin") == false && is_link(mnt, "big2.bin") == false && ok;
+	qn_unload(mnt);
+
+	// 버전은 그대로
+	ushort version = 0;
+	QnStream* stream = qn_open_stream(NULL, "test_dedup_old.hfs", NULL);
+	ok = stream != NULL && qn_stream_seek(stream, 4, QNSEEK_BEGIN) == 4 &&
+		qn_stream_read(stream, &version, 0, (int)sizeof(ushort)) == (int)sizeof(ushort) && version == old_version && ok;
+	qn_unload(stream);
+
+	mnt = qn_open_mount("test_dedup_old.hfs", "h");
+	ok = mnt != NULL && check_file(mnt, "first.bin", small, SMALL_SIZE) && check_file(mnt, "b.bin", small, SMALL_SIZE) &&
+		check_file(mnt, "big1.bin", big, BIG_SIZE) && check_file(mnt, "big2.bin", big, BIG_SIZE) && ok;
+	qn_unload(mnt);
+	qn_outputf("legacy v%d append %lld bytes: %s", (int)version, disk_size("test_dedup_old.hfs"), ok ? "ok" : "FAIL");
+
+	qn_remove_file(NULL, "test_dedup_old.hfs");
+	return ok;
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+	byte* small = make_data(SMALL_SIZE, 11);
+	byte* big = make_data(BIG_SIZE, 22);
+
+	bool ok = test_store("hc", small, big);
+	ok = test_store("hcl", small, big) && ok;
+	ok = test_batch(small, big) && ok;
+	ok = test_legacy(small, big) && ok;
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+
+	qn_free(small);
+	qn_free(big);
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+﻿// HFS 전체 경로 색인 테스트, 파일이 많을 때 찾기 속도
+#include <qs.h>
+
+#define DIR_COUNT		100
+#define FILE_COUNT		200				// 디렉토리 당
+#define LOOKUP_COUNT	100000
+#define REWRITE_COUNT	10
+
+// 파일 크기
+static llong file_size(const char* filename)
+{
+	QnStream* stream = qn_open_stream(NULL, filename, "rb");
+	if (stream == NULL)
+		return -1;
+	const llong size = qn_stream_size(stream);
+	qn_unload(stream);
+	return size;
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+	bool ok = true;
+	char path[64], data[64];
+
+	// 만들기
+	double start = qn_elapsed();
+	QnMount* mnt = qn_open_mount("test_index.hfs", "hc");
+	if (mnt == NULL)
+	{
+		qn_outputs("cannot create test_index.hfs");
+		return 1;
+	}
+	for (int d = 0; d < DIR_COUNT; d++)
+	{
+		qn_snprintf(path, QN_COUNTOF(path), "/dir%03d", d);
+		qn_mkdir(mnt, path);
+		for (int f = 0; f < FILE_COUNT; f++)
+		{
+			qn_snprintf(path, QN_COUNTOF(path), "/dir%03d/file%04d.txt", d, f);
+			const int len = qn_snprintf(data, QN_COUNTOF(data), "%d:%d", d, f);
+			qn_hfs_store_data(mnt, path, data, (uint)len, QNCODEC_STORE, QNFTYPE_TEXT);
+		}
+	}
+	qn_unload(mnt);
+	qn_outputf("store %d files: %.3f sec", DIR_COUNT * FILE_COUNT, qn_elapsed() - start);
+
+	// 열어서 찾기
+	start = qn_elapsed();
+	mnt = qn_open_mount("test_index.hfs", "h");
+	qn_outputf("open: %.3f ms", (qn_elapsed() - start) * 1000.0);
+
+	QnRandom rnd;
+	qn_srand(&rnd, 1234);
+	start = qn_elapsed();
+	for (int i = 0; i < LOOKUP_COUNT; i++)
+	{
+		const int d = (int)(qn_rand(&rnd) % DIR_COUNT), f = (int)(qn_rand(&rnd) % FILE_COUNT);
+		qn_snprintf(path, QN_COUNTOF(path), "/DIR%03d/File%04d.TXT", d, f);
+		if (qn_get_file_attr(mnt, path) != QNFATTR_FILE)
+			ok = false;
+	}
+	const double elapsed = qn_elapsed() - start;
+	qn_outputf("lookup: %.3f sec, %.2f Mlookup/sec", elapsed, LOOKUP_COUNT / elapsed / 1000000.0);
+
+	// 내용과 상대 경로
+	qn_chdir(mnt, "/dir042");
+	int size;
+	char* read = qn_file_alloc(mnt, "../dir007/./file0123.txt", &size);
+	if (read == NULL || size != 5 || memcmp(read, "7:123", 5) != 0)
+		ok = false;
+	qn_free(read);
+	if (qn_get_file_attr(mnt, "file0000.txt") != QNFATTR_FILE || qn_get_file_attr(mnt, "/dir042") != QNFATTR_DIR ||
+		qn_get_file_attr(mnt, "/") != QNFATTR_DIR || qn_get_file_attr(mnt, "/dir042/none.txt") != QNFATTR_NONE)
+		ok = false;
+	qn_unload(mnt);
+
+	// 고치면 색인도 바뀐다
+	mnt = qn_open_mount("test_index.hfs", "h+");
+	qn_remove_file(mnt, "/dir001");
+	qn_hfs_store_data(mnt, "/dir002/new.txt", "new", 3, QNCODEC_STORE, QNFTYPE_TEXT);
+	if (qn_get_file_attr(mnt, "/dir001/file0000.txt") != QNFATTR_NONE || qn_get_file_attr(mnt, "/dir002/new.txt") != QNFATTR_FILE)
+		ok = false;
+	qn_unload(mnt);
+	mnt = qn_open_mount("test_index.hfs", "h");
+	if (qn_get_file_attr(mnt, "/dir001/file0000.txt") != QNFATTR_NONE || qn_get_file_attr(mnt, "/dir002/new.txt") != QNFATTR_FILE)
+		ok = false;
+	qn_unload(mnt);
+
+	// 고쳐서 닫을 때마다 색인을 덧붙이면 파일이 색인 크기만큼 커진다
+	const llong before = file_size("test_index.hfs");
+	mnt = qn_open_mount("test_index.hfs", "h+");
+	qn_hfs_set_desc(mnt, "desc only");
+	qn_unload(mnt);
+	if (file_size("test_index.hfs") != before)
+		ok = false;
+	for (int i = 0; i < REWRITE_COUNT; i++)
+	{
+		mnt = qn_open_mount("test_index.hfs", "h+");
+		qn_snprintf(path, QN_COUNTOF(path), "/dir003/again%d.txt", i);
+		const int len = qn_snprintf(data, QN_COUNTOF(data), "again:%d", i);
+		qn_hfs_store_data(mnt, path, data, (uint)len, QNCODEC_STORE, QNFTYPE_TEXT);
+		qn_unload(mnt);
+	}
+	const llong after = file_size("test_index.hfs");
+	mnt = qn_open_mount("test_index.hfs", "h");
+	for (int i = 0; i < REWRITE_COUNT; i++)
+	{
+		qn_snprintf(path, QN_COUNTOF(path), "/dir003/again%d.txt", i);
+		if (qn_get_file_attr(mnt, path) != QNFATTR_FILE)
+			ok = false;
+	}
+	read = qn_file_alloc(mnt, "/dir099/file0199.txt", &size);
+	if (read == NULL || size != 6 || memcmp(read, "99:199", 6) != 0)
+		ok = false;
+	qn_free(read);
+	qn_unload(mnt);
+	qn_outputf("rewrite %d times: %lld -> %lld bytes", REWRITE_COUNT, before, after);
+	if (after - before > REWRITE_COUNT * 1024)
+		ok = false;
+
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
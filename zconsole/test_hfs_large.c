@@ -0,0 +1,243 @@
+﻿// HFS 큰 파일 테스트, 64비트 위치로 만들고 읽기
+// 인수로 big을 주면 실제로 4GB 넘게 써서 확인한다 (디스크 9GB 정도 필요)
+#include <qs.h>
+#include <errno.h>
+
+#define SMALL_SIZE		(3 * 1024 * 1024 + 777)
+#define BIG_PIECE		(256 * 1024 * 1024)
+#define BIG_TOTAL		(4608ULL * 1024 * 1024)		// 4.5GB
+
+// 압축은 되지만 너무 잘 되지는 않는 데이터
+static void fill_data(byte* data, size_t size, uint seed)
+{
+	QnRandom rnd;
+	qn_srand(&rnd, seed);
+	for (size_t i = 0; i < size; i++)
+		data[i] = (byte)(i % 251 < 200 ? 'a' + (i / 97 + seed) % 26 : qn_rand(&rnd));
+}
+
+// 통째로 읽기와 스트림 읽기를 비교
+static bool check_file(QnMount* mnt, const char* name, const byte* data, size_t size)
+{
+	size_t got;
+	byte* all = qn_file_alloc64(mnt, name, &got);
+	bool ok = all != NULL && got == size && memcmp(all, data, size) == 0;
+	qn_free(all);
+
+	QnStream* stream = qn_open_stream(mnt, name, NULL);
+	if (stream == NULL || qn_stream_size(stream) != (llong)size)
+		ok = false;
+	else
+	{
+		byte buf[4096];
+		const llong pos = (llong)size / 3;
+		if (qn_stream_seek(stream, pos, QNSEEK_BEGIN) != pos ||
+			qn_stream_read(stream, buf, 0, (int)sizeof(buf)) != (int)sizeof(buf) ||
+			memcmp(buf, data + pos, sizeof(buf)) != 0)
+			ok = false;
+	}
+	qn_unload(stream);
+	return ok;
+}
+
+// 'l' 모드로 만든 HFS에 넣고 읽기
+static bool test_create(const byte* data)
+{
+	QnMount* mnt = qn_open_mount("test_large.hfs", "hcl");
+	if (mnt == NULL)
+		return false;
+	bool ok = qn_mkdir(mnt, "sub");
+	ok = qn_hfs_store_data(mnt, "deflate.bin", data, SMALL_SIZE, QNCODEC_DEFLATE, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "sub/lz.bin", data, SMALL_SIZE, QNCODEC_LZ, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "sub/store.bin", data, SMALL_SIZE, QNCODEC_STORE, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_hfs_store_data(mnt, "small.txt", "hello", 5, QNCODEC_STORE, QNFTYPE_TEXT) && ok;
+	qn_unload(mnt);
+
+	// 덧붙이고 지우기
+	mnt = qn_open_mount("test_large.hfs", "h+");
+	if (mnt == NULL)
+		return false;
+	ok = qn_hfs_store_data(mnt, "sub/added.bin", data + 100, SMALL_SIZE - 100, QNCODEC_LZ, QNFTYPE_UNKNOWN) && ok;
+	ok = qn_remove_file(mnt, "small.txt") && ok;
+	qn_unload(mnt);
+
+	static const char* modes[] = { "h", "hv", "hm", "hf" };
+	for (size_t m = 0; m < QN_COUNTOF(modes); m++)
+	{
+		mnt = qn_open_mount("test_large.hfs", modes[m]);
+		if (mnt == NULL)
+			return false;
+		bool mode_ok = check_file(mnt, "deflate.bin", data, SMALL_SIZE);
+		mode_ok = check_file(mnt, "sub/lz.bin", data, SMALL_SIZE) && mode_ok;
+		mode_ok = check_file(mnt, "sub/store.bin", data, SMALL_SIZE) && mode_ok;
+		mode_ok = check_file(mnt, "/sub/added.bin", data + 100, SMALL_SIZE - 100) && mode_ok;
+		mode_ok = qn_get_file_attr(mnt, "small.txt") == QNFATTR_NONE && mode_ok;
+		qn_outputf("create [%s]: %s", modes[m], mode_ok ? "ok" : "FAIL");
+		ok = mode_ok && ok;
+		qn_unload(mnt);
+	}
+
+	// 최적화하면 큰 HFS로 나온다
+	mnt = qn_open_mount("test_large.hfs", "h");
+	HfsOptimizeParam op = { .filename = "test_large_opt.hfs" };
+	ok = qn_hfs_optimize(mnt, &op) && ok;
+	qn_unload(mnt);
+	mnt = qn_open_mount("test_large_opt.hfs", "h");
+	ok = mnt != NULL && check_file(mnt, "sub/lz.bin", data, SMALL_SIZE) && ok;
+	qn_unload(mnt);
+
+	// 퓨즈로 읽기
+	QnMount* fuse = qn_create_fuse(NULL, false, false);
+	ok = fuse != NULL && qn_fuse_add_hfs(fuse, "test_large.hfs") &&
+		check_file(fuse, "/sub/store.bin", data, SMALL_SIZE) && ok;
+	qn_unload(fuse);
+	qn_outputf("optimize, fuse: %s", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 묶음 저장
+static bool test_batch(const byte* data)
+{
+	const HfsBatchItem items[] =
+	{
+		{ .filename = "a/one.bin", .data = data, .size = SMALL_SIZE, .codec = QNCODEC_LZ },
+		{ .filename = "a/b/two.bin", .data = data, .size = SMALL_SIZE, .codec = QNCODEC_DEFLATE },
+		{ .filename = "three.bin", .data = data, .size = SMALL_SIZE, .codec = QNCODEC_STORE },
+	};
+	HfsBatchParam param = { .filename = "test_large_batch.hfs", .large = true };
+	bool ok = qn_hfs_store_batch(items, QN_COUNTOF(items), &param) && param.large;
+
+	static const char* modes[] = { "h", "hv" };
+	for (size_t m = 0; m < QN_COUNTOF(modes); m++)
+	{
+		QnMount* mnt = qn_open_mount("test_large_batch.hfs", modes[m]);
+		ok = mnt != NULL && check_file(mnt, "a/one.bin", data, SMALL_SIZE) &&
+			check_file(mnt, "a/b/two.bin", data, SMALL_SIZE) &&
+			check_file(mnt, "three.bin", data, SMALL_SIZE) && ok;
+		qn_unload(mnt);
+	}
+
+	// 작으면 알아서 켜지지 않는다
+	HfsBatchParam small = { .filename = "test_large_batch.hfs" };
+	ok = qn_hfs_store_batch(items, 1, &small) && small.large == false && ok;
+	qn_outputf("batch: %s", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 스트림 64비트 읽고 쓰기, 32비트 HFS 크기 제한
+static bool test_misc(const byte* data)
+{
+	QnStream* mem = qn_create_mem_stream("mem", 0);
+	bool ok = qn_stream_write64(mem, data, SMALL_SIZE) == SMALL_SIZE;
+	byte* buf = qn_alloc(SMALL_SIZE + 10, byte);
+	qn_stream_seek(mem, 0, QNSEEK_BEGIN);
+	ok = qn_stream_read64(mem, buf, SMALL_SIZE + 10) == SMALL_SIZE && memcmp(buf, data, SMALL_SIZE) == 0 && ok;
+	qn_free(buf);
+	qn_unload(mem);
+
+	// 원래 HFS는 2040MB가 넘는 파일을 받지 않는다. 데이터는 읽기 전에 거른다
+	QnMount* mnt = qn_open_mount("test_large_v16.hfs", "hc");
+	errno = 0;
+	ok = mnt != NULL && qn_hfs_store_data(mnt, "huge.bin", data, 2041ULL * 1024 * 1024, QNCODEC_STORE, QNFTYPE_UNKNOWN) == false &&
+		errno == EINVAL && ok;
+	qn_unload(mnt);
+	qn_outputf("stream64, limit: %s", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 조각마다 앞에 번호를 찍어서 내용이 다르게 한다. 같으면 링크로 들어간다
+static void stamp_piece(byte* data, int piece)
+{
+	memcpy(data, &piece, sizeof(int));
+}
+
+// 실제로 4GB 넘게 쓴다
+static bool test_big(void)
+{
+	byte* data = qn_alloc(BIG_PIECE, byte);
+	fill_data(data, BIG_PIECE, 99);
+	char name[64];
+
+	// 32비트 HFS는 4GB 앞에서 EFBIG으로 멈춘다
+	double start = qn_elapsed();
+	QnMount* mnt = qn_open_mount("test_large_big16.hfs", "hc");
+	bool ok = mnt != NULL;
+	int stored = 0;
+	for (ullong total = 0; ok && total < BIG_TOTAL; total += BIG_PIECE, stored++)
+	{
+		qn_snprintf(name, QN_COUNTOF(name), "piece%02d.bin", stored);
+		stamp_piece(data, stored);
+		errno = 0;
+		if (qn_hfs_store_data(mnt, name, data, BIG_PIECE, QNCODEC_STORE, QNFTYPE_UNKNOWN) == false)
+			break;
+	}
+	ok = ok && errno == EFBIG && stored == 15;
+	qn_unload(mnt);
+	mnt = qn_open_mount("test_large_big16.hfs", "h");
+	ok = mnt != NULL && qn_get_file_attr(mnt, "piece14.bin") == QNFATTR_FILE && ok;
+	qn_unload(mnt);
+	qn_outputf("big v16: %d pieces, %.3f sec %s", stored, qn_elapsed() - start, ok ? "ok" : "FAIL");
+
+	// 64비트 HFS는 넘어간다
+	start = qn_elapsed();
+	mnt = qn_open_mount("test_large_big.hfs", "hcl");
+	ok = mnt != NULL && ok;
+	stored = 0;
+	for (ullong total = 0; ok && total < BIG_TOTAL; total += BIG_PIECE, stored++)
+	{
+		qn_snprintf(name, QN_COUNTOF(name), "piece%02d.bin", stored);
+		stamp_piece(data, stored);
+		ok = qn_hfs_store_data(mnt, name, data, BIG_PIECE, QNCODEC_STORE, QNFTYPE_UNKNOWN);
+	}
+	qn_unload(mnt);
+
+	// 4GB 뒤에 있는 파일을 파일 읽기와 매핑으로 읽는다
+	static const char* modes[] = { "h", "hv" };
+	for (size_t m = 0; ok && m < QN_COUNTOF(modes); m++)
+	{
+		mnt = qn_open_mount("test_large_big.hfs", modes[m]);
+		for (int i = stored - 2; mnt != NULL && i < stored; i++)
+		{
+			qn_snprintf(name, QN_COUNTOF(name), "piece%02d.bin", i);
+			stamp_piece(data, i);
+			const uint crc = qn_crc32(0, data, BIG_PIECE);
+			size_t size;
+			byte* all = qn_file_alloc64(mnt, name, &size);
+			ok = all != NULL && size == BIG_PIECE && qn_crc32(0, all, size) == crc && ok;
+			qn_free(all);
+		}
+		ok = mnt != NULL && ok;
+		qn_unload(mnt);
+	}
+	QnFileInfo fi;
+	QnMount* list = qn_open_mount("test_large_big.hfs", "h");
+	QnDir* dir = list != NULL ? qn_open_dir(list, "/", NULL) : NULL;
+	llong total = 0;
+	while (dir != NULL && qn_dir_read_info(dir, &fi))
+		total += QN_TMASK(fi.attr, QNFATTR_DIR) ? 0 : fi.size;
+	ok = total == (llong)BIG_TOTAL && ok;
+	qn_unload(dir);
+	qn_unload(list);
+	qn_outputf("big v17: %d pieces, %lld bytes, %.3f sec %s", stored, total, qn_elapsed() - start, ok ? "ok" : "FAIL");
+
+	qn_free(data);
+	return ok;
+}
+
+int main(int argc, char* argv[])
+{
+	qn_runtime(NULL);
+	byte* data = qn_alloc(SMALL_SIZE, byte);
+	fill_data(data, SMALL_SIZE, 1234);
+
+	bool ok = test_create(data);
+	ok = test_batch(data) && ok;
+	ok = test_misc(data) && ok;
+	if (argc > 1 && qn_streqv(argv[1], "big"))
+		ok = test_big() && ok;
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+
+	qn_free(data);
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
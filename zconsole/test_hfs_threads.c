@@ -0,0 +1,195 @@
+﻿// HFS 여러 스레드 읽기 벤치마크, 스레드 갯수에 따른 속도
+#include <qs.h>
+
+#define MAX_FILES		4096
+#define READ_ROUND		8
+#define CHURN_COUNT		32
+
+typedef struct READER
+{
+	QnMount*		mount;
+	char**			names;
+	uint*			crcs;
+	size_t			count;
+	volatile nint	bytes;
+	volatile nint	fails;
+} Reader;
+
+static char* names[MAX_FILES];
+static uint crcs[MAX_FILES];
+static size_t name_count;
+
+// 파일 이름을 모두 모은다
+static void collect(QnMount* mnt, const char* path)
+{
+	QnDir* dir = qn_open_dir(mnt, path, NULL);
+	if (dir == NULL)
+		return;
+	QnFileInfo fi;
+	while (qn_dir_read_info(dir, &fi))
+	{
+		if (fi.name[0] == '.')
+			continue;
+		char* full = qn_strdupcat(path, fi.name, QN_TMASK(fi.attr, QNFATTR_DIR) ? "/" : NULL, NULL);
+		if (QN_TMASK(fi.attr, QNFATTR_DIR))
+		{
+			collect(mnt, full);
+			qn_free(full);
+		}
+		else if (name_count < MAX_FILES)
+			names[name_count++] = full;
+		else
+			qn_free(full);
+	}
+	qn_unload(dir);
+}
+
+// 읽고 내용 확인
+static void read_range(void* context, size_t begin, size_t end)
+{
+	Reader* r = (Reader*)context;
+	nint bytes = 0, fails = 0;
+	for (size_t i = begin; i < end; i++)
+	{
+		const size_t n = i % r->count;
+		int size;
+		void* data = qn_file_alloc(r->mount, r->names[n], &size);
+		if (data == NULL || qn_crc32(0, data, (size_t)size) != r->crcs[n])
+			fails++;
+		else
+			bytes += size;
+		qn_free(data);
+	}
+	qn_atomic_add(&r->bytes, bytes);
+	qn_atomic_add(&r->fails, fails);
+}
+
+static volatile nint churn_fails;
+
+// 읽는 동안 퓨즈에 HFS를 계속 더한다, 더할 때마다 색인을 새로 게시하고 지난 색인은 치운다
+static void* churn(void* data)
+{
+	QnMount* fuse = (QnMount*)data;
+	for (int i = 0; i < CHURN_COUNT; i++)
+	{
+		char name[64];
+		qn_snprintf(name, QN_COUNTOF(name), "test_churn_%d.hfs", i);
+		if (qn_fuse_add_hfs(fuse, name) == false)
+			qn_atomic_add(&churn_fails, 1);
+		qn_sleep(1);
+	}
+	return NULL;
+}
+
+// 더할 HFS 만들기, 파일 하나씩
+static bool make_churn(bool remove)
+{
+	bool ok = true;
+	for (int i = 0; i < CHURN_COUNT; i++)
+	{
+		char name[64];
+		qn_snprintf(name, QN_COUNTOF(name), "test_churn_%d.hfs", i);
+		if (remove)
+		{
+			qn_remove_file(NULL, name);
+			continue;
+		}
+		QnMount* mnt = qn_open_mount(name, "hc");
+		char file[64];
+		qn_snprintf(file, QN_COUNTOF(file), "churn%d.txt", i);
+		ok = mnt != NULL && qn_hfs_store_data(mnt, file, name, strlen(name), QNCODEC_STORE, QNFTYPE_TEXT) && ok;
+		qn_unload(mnt);
+	}
+	return ok;
+}
+
+static bool bench(const char* name, QnMount* mount)
+{
+	qn_outputf("[%s]", name);
+	qn_outputf("%7s %10s %10s %8s", "threads", "ms", "MB/sec", "speedup");
+
+	Reader r = { .mount = mount, .names = names, .crcs = crcs, .count = name_count };
+	const uint max_threads = QN_MAX(qn_cpu_count(), 4);
+	double base = 0.0;
+	bool ok = true;
+	for (uint threads = 1; threads <= max_threads; threads *= 2)
+	{
+		qn_parallel_threads(threads);
+		r.bytes = r.fails = 0;
+		const double start = qn_elapsed();
+		qn_parallel_for(name_count * READ_ROUND, 1, read_range, &r);
+		const double elapsed = qn_elapsed() - start;
+		if (r.fails != 0)
+			ok = false;
+		if (threads == 1)
+			base = elapsed;
+		qn_outputf("%7u %10.3f %10.2f %7.2fx", threads, elapsed * 1000.0,
+			(double)r.bytes / elapsed / (1024.0 * 1024.0), base / elapsed);
+	}
+	return ok;
+}
+
+int main(int argc, char* argv[])
+{
+	qn_runtime(NULL);
+
+	const char* filename = argc > 1 ? argv[1] : "res.hfs";
+	QnMount* hfs = qn_open_mount(filename, "h");
+	if (hfs == NULL)
+	{
+		qn_outputf("cannot open %s", filename);
+		return 1;
+	}
+
+	// 기준 내용은 한 스레드로 읽어둔다
+	collect(hfs, "/");
+	llong total = 0;
+	for (size_t i = 0; i < name_count; i++)
+	{
+		int size;
+		void* data = qn_file_alloc(hfs, names[i], &size);
+		crcs[i] = data == NULL ? 0 : qn_crc32(0, data, (size_t)size);
+		total += data == NULL ? 0 : size;
+		qn_free(data);
+	}
+	qn_outputf("%s: %zu files, %lld bytes, cores: %u", filename, name_count, total, qn_cpu_count());
+
+	bool ok = bench("hfs", hfs);
+	qn_unload(hfs);
+
+	QnMount* mapped = qn_open_mount(filename, "hv");
+	if (mapped != NULL)
+	{
+		ok = bench("hfs mapped", mapped) && ok;
+		qn_unload(mapped);
+	}
+
+	QnMount* fuse = qn_create_fuse(NULL, false, false);
+	if (fuse != NULL && qn_fuse_add_hfs(fuse, filename))
+	{
+		ok = bench("fuse", fuse) && ok;
+
+		// 읽는 중에 색인 바꾸기
+		ok = make_churn(false) && ok;
+		QnThread* thread = qn_new_thread("churn", churn, fuse, 0, 0);
+		qn_thread_start(thread);
+		ok = bench("fuse churn", fuse) && ok;
+		qn_thread_wait(thread);
+		qn_delete_thread(thread);
+		for (int i = 0; i < CHURN_COUNT; i++)
+		{
+			char file[64];
+			qn_snprintf(file, QN_COUNTOF(file), "/churn%d.txt", i);
+			ok = qn_get_file_attr(fuse, file) != QNFATTR_NONE && ok;
+		}
+		ok = churn_fails == 0 && qn_fuse_get_hfs_count(fuse) == CHURN_COUNT + 1 && ok;
+	}
+	qn_unload(fuse);
+	make_churn(true);
+
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+	for (size_t i = 0; i < name_count; i++)
+		qn_free(names[i]);
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
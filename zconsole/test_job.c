@@ -0,0 +1,176 @@
+﻿// 작업 시스템 벤치마크, 포크/조인과 작은 작업 처리량
+#include <qs.h>
+
+#define FIB_N			35
+#define FIB_CUTOFF		16
+#define TINY_COUNT		(1024 * 1024)
+
+static QnJobSystem* js;
+
+static ullong fib_serial(int n)
+{
+	return n < 2 ? (ullong)n : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+typedef struct FIBJOB
+{
+	int				n;
+	ullong			result;
+} FibJob;
+
+// 반은 작업으로 넣고 반은 직접, 끝날 때까지 도우며 기다린다
+static void fib_job(void* data)
+{
+	FibJob* f = (FibJob*)data;
+	if (f->n < FIB_CUTOFF)
+	{
+		f->result = fib_serial(f->n);
+		return;
+	}
+	FibJob left = { f->n - 1, 0 }, right = { f->n - 2, 0 };
+	QnJobCounter counter = { 0 };
+	qn_job_run(js, fib_job, &left, &counter);
+	fib_job(&right);
+	qn_job_wait(js, &counter);
+	f->result = left.result + right.result;
+}
+
+static volatile nint tiny_sum;
+
+static void tiny_job(void* data)
+{
+	qn_atomic_add(&tiny_sum, (nint)data);
+}
+
+typedef struct SPAWNJOB
+{
+	size_t			begin, end;
+	QnJobCounter*	counter;
+} SpawnJob;
+
+// 일꾼 안에서 작은 작업을 잔뜩 넣는다
+static void spawn_job(void* data)
+{
+	const SpawnJob* s = (const SpawnJob*)data;
+	for (size_t i = s->begin; i < s->end; i++)
+		qn_job_run(js, tiny_job, (void*)(nint)1, s->counter);
+}
+
+static int main_hits;
+
+static void main_job(void* data)
+{
+	QnThread* main = (QnThread*)data;
+	if (qn_thread_self() == main)
+		main_hits++;
+}
+
+static QnThread* main_thread;
+
+// 다른 스레드가 공용 작업 시스템을 먼저 만든다
+static void* shared_first(void* data)
+{
+	QnJobSystem* shared = qn_job_system();
+	for (int i = 0; i < 10; i++)
+		qn_job_run_main(shared, main_job, main_thread, (QnJobCounter*)data);
+	return NULL;
+}
+
+// 공용 작업 시스템의 메인 스레드는 누가 먼저 불렀든 런타임을 올린 스레드
+static bool check_shared_main(void)
+{
+	main_hits = 0;
+	main_thread = qn_thread_self();
+	QnJobCounter counter = { 0 };
+	QnThread* thread = qn_new_thread("shared", shared_first, &counter, 0, 0);
+	qn_thread_start(thread);
+	qn_thread_wait(thread);
+	qn_delete_thread(thread);
+	const int count = qn_job_update_main(qn_job_system());
+	const bool ok = count == 10 && main_hits == 10 && qn_job_is_done(&counter);
+	qn_outputf("shared main thread: %s", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 스레드 갯수를 바꿔도 먼저 얻은 공용 작업 시스템을 계속 쓸 수 있다
+static bool check_retired(void)
+{
+	QnJobSystem* cached = qn_job_system();
+	js = cached;
+	const uint before = qn_parallel_count();
+	qn_parallel_threads(before == 2 ? 3 : 2);
+	const bool changed = qn_job_system() != cached && qn_parallel_count() != before;
+	qn_parallel_threads(before);
+
+	tiny_sum = 0;
+	QnJobCounter counter = { 0 };
+	SpawnJob spawn = { 0, TINY_COUNT / 10, &counter };
+	qn_job_run(cached, spawn_job, &spawn, &counter);
+	qn_job_wait(cached, &counter);
+
+	const bool ok = changed && tiny_sum == TINY_COUNT / 10 && qn_parallel_count() == before;
+	qn_outputf("retired shared system: %s", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+	bool ok = true;
+
+	double start = qn_elapsed();
+	const ullong expect = fib_serial(FIB_N);
+	const double time_serial = (qn_elapsed() - start) * 1000.0;
+	qn_outputf("cores: %u", qn_cpu_count());
+	qn_outputf("%7s %12s %8s %14s", "workers", "fib (ms)", "speedup", "tiny (Mjob/s)");
+	qn_outputf("%7s %12.3f %7.2fx", "serial", time_serial, 1.0);
+
+	const int max_workers = (int)QN_MAX(qn_cpu_count(), 4) - 1;
+	for (int workers = 0; workers <= max_workers; workers = workers == 0 ? 1 : workers * 2 + 1)
+	{
+		js = qn_new_job_system(workers, 0);
+
+		// 포크/조인
+		FibJob f = { FIB_N, 0 };
+		start = qn_elapsed();
+		fib_job(&f);
+		const double time_fib = (qn_elapsed() - start) * 1000.0;
+		if (f.result != expect)
+			ok = false;
+
+		// 작은 작업, 일꾼마다 나눠서 넣는다
+		tiny_sum = 0;
+		QnJobCounter counter = { 0 };
+		SpawnJob spawns[16];
+		const size_t parts = QN_MIN((size_t)workers + 1, QN_COUNTOF(spawns));
+		start = qn_elapsed();
+		for (size_t i = 0; i < parts; i++)
+		{
+			spawns[i] = (SpawnJob){ TINY_COUNT * i / parts, TINY_COUNT * (i + 1) / parts, &counter };
+			qn_job_run(js, spawn_job, &spawns[i], &counter);
+		}
+		qn_job_wait(js, &counter);
+		const double time_tiny = qn_elapsed() - start;
+		if (tiny_sum != TINY_COUNT)
+			ok = false;
+
+		qn_outputf("%7d %12.3f %7.2fx %14.2f", workers, time_fib, time_serial / time_fib, TINY_COUNT / time_tiny / 1000000.0);
+
+		// 메인 스레드 전용 작업
+		main_hits = 0;
+		QnJobCounter main_counter = { 0 };
+		for (int i = 0; i < 100; i++)
+			qn_job_run_main(js, main_job, qn_thread_self(), &main_counter);
+		qn_job_wait(js, &main_counter);
+		if (main_hits != 100)
+			ok = false;
+
+		qn_delete_job_system(js);
+	}
+	ok = check_shared_main() && ok;
+	ok = check_retired() && ok;
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+﻿// 로그 벤치마크, 바로 쓰기와 비동기 쓰기의 처리량과 호출 지연
+#include <qs.h>
+
+#define MAX_THREADS		4
+#define LINE_COUNT		50000
+#define BLOCK_COUNT		1000				// 시간은 이만큼 묶어서 잰다 (유닉스 qn_elapsed는 밀리초 단위)
+#define LOG_FILE		"test_log.txt"
+#define TOGGLE_COUNT	40					// 쓰는 중에 비동기를 껐다 켜는 횟수
+
+typedef struct BENCH
+{
+	int				id;
+	double			total;				// 로그 호출에 쓴 시간
+	double			worst;				// 가장 오래 걸린 묶음
+} Bench;
+
+static void* bench_thread(void* data)
+{
+	Bench* b = (Bench*)data;
+	for (int i = 0; i < LINE_COUNT; i += BLOCK_COUNT)
+	{
+		const double start = qn_elapsed();
+		for (int n = i; n < i + BLOCK_COUNT; n++)
+			qn_logf(QNLOG_INFO, "BENCH", "t%d n%d value=%.3f", b->id, n, (double)n * 0.25);
+		const double t = qn_elapsed() - start;
+		b->total += t;
+		if (t > b->worst)
+			b->worst = t;
+	}
+	return NULL;
+}
+
+// 스레드마다 순서대로 다 나왔나
+static bool verify(int count)
+{
+	size_t size;
+	char* text = qn_file_alloc64(NULL, LOG_FILE, &size);
+	if (text == NULL)
+		return false;
+	text[size] = '\0';
+	int next[MAX_THREADS] = { 0 };
+	int lines = 0;
+	bool ok = true;
+	for (char* p = text; *p != '\0';)
+	{
+		char* end = strchr(p, '\n');
+		if (end == NULL)
+		{
+			ok = false;
+			break;
+		}
+		*end = '\0';
+		int t, n;
+		if (sscanf(p, "INFO [BENCH] t%d n%d", &t, &n) != 2 || t < 0 || t >= count || n != next[t]++)
+			ok = false;
+		lines++;
+		p = end + 1;
+	}
+	qn_free(text);
+	return ok && lines == count * LINE_COUNT;
+}
+
+static bool bench(bool async, int count)
+{
+	if (qn_output_redirect(LOG_FILE) == false)
+		return false;
+	bool ok = qn_log_async(async);
+
+	Bench benches[MAX_THREADS];
+	QnThread* threads[MAX_THREADS];
+	for (int i = 0; i < count; i++)
+	{
+		benches[i] = (Bench){ .id = i };
+		threads[i] = qn_new_thread("bench", bench_thread, &benches[i], 0, 0);
+	}
+	const double start = qn_elapsed();
+	for (int i = 0; i < count; i++)
+		qn_thread_start(threads[i]);
+	for (int i = 0; i < count; i++)
+		qn_thread_wait(threads[i]);
+	const double logged = qn_elapsed() - start;
+	qn_log_flush();
+	const double written = qn_elapsed() - start;
+	for (int i = 0; i < count; i++)
+		qn_delete_thread(threads[i]);
+
+	ok = qn_log_async(false) && ok;
+	qn_output_redirect(NULL);
+	ok = verify(count) && ok;
+
+	double total = 0.0, worst = 0.0;
+	for (int i = 0; i < count; i++)
+	{
+		total += benches[i].total;
+		worst = QN_MAX(worst, benches[i].worst);
+	}
+	const double lines = (double)count * LINE_COUNT;
+	qn_outputf("%-6s %7d %12.3f %12.3f %10.2f %10.2f %10.1f  %s", async ? "async" : "sync", count,
+		logged * 1000.0, written * 1000.0, lines / written / 1000.0, total / lines * 1000000.0, worst * 1000.0, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 쓰는 중에 비동기를 껐다 켰다 해도 빠지거나 순서가 바뀌는 줄이 없다
+static bool check_toggle(void)
+{
+	if (qn_output_redirect(LOG_FILE) == false)
+		return false;
+	bool ok = qn_log_async(true);
+	Bench benches[MAX_THREADS];
+	QnThread* threads[MAX_THREADS];
+	for (int i = 0; i < MAX_THREADS; i++)
+	{
+		benches[i] = (Bench){ .id = i };
+		threads[i] = qn_new_thread("toggle", bench_thread, &benches[i], 0, 0);
+		qn_thread_start(threads[i]);
+	}
+	int toggles = 0;
+	for (; toggles < TOGGLE_COUNT; toggles++)
+	{
+		ok = qn_log_async(toggles % 2 == 1) && ok;
+		qn_sleep(1);
+	}
+	for (int i = 0; i < MAX_THREADS; i++)
+	{
+		qn_thread_wait(threads[i]);
+		qn_delete_thread(threads[i]);
+	}
+	ok = qn_log_async(false) && ok;
+	qn_output_redirect(NULL);
+	ok = verify(MAX_THREADS) && ok;
+	qn_outputf("toggle: %d times, %s", toggles, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 수준 거르기
+static bool check_level(void)
+{
+	qn_output_redirect(LOG_FILE);
+	qn_log_set_level(QNLOG_WARN);
+	bool ok = qn_logs(QNLOG_INFO, "LEVEL", "dropped") == 0;
+	ok = qn_logs(QNLOG_ERROR, "LEVEL", "kept") > 0 && ok;
+	ok = qn_logs(QNLOG_OFF, "LEVEL", "never") == 0 && ok;
+	qn_log_set_level(QNLOG_TRACE);
+	qn_log_debug("LEVEL", "debug %d", 1);
+	qn_output_redirect(NULL);
+
+	size_t size;
+	char* text = qn_file_alloc64(NULL, LOG_FILE, &size);
+	if (text != NULL)
+		text[size] = '\0';
+	ok = text != NULL && strstr(text, "dropped") == NULL && strstr(text, "ERROR [LEVEL] kept\n") != NULL && ok;
+#ifdef _DEBUG
+	ok = text != NULL && strstr(text, "DEBUG [LEVEL] debug 1\n") != NULL && ok;
+#endif
+	qn_free(text);
+	qn_outputf("level: %s", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+
+	bool ok = check_level();
+	qn_outputf("%-6s %7s %12s %12s %10s %10s %10s", "mode", "threads", "logged (ms)", "written (ms)", "Klines/s", "avg (us)", "worst/1k (ms)");
+	for (int count = 1; count <= MAX_THREADS; count <<= 1)
+	{
+		ok = bench(false, count) && ok;
+		ok = bench(true, count) && ok;
+	}
+	ok = check_toggle() && ok;
+	qn_remove_file(NULL, LOG_FILE);
+
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
@@ -132,12 +132,13 @@ int main(void)
 		qn_chdir(mnt, "/test/456");
 
 		qn_chdir(mnt, "/test");
-		qn_hfs_store_data(mnt, "one summer night.txt", one_summer_night, (uint)QN_COUNTOF(one_summer_night) - 1, false, QNFTYPE_TEXT);
-		qn_hfs_store_data(mnt, "one summer night.txt", one_summer_night, (uint)QN_COUNTOF(one_summer_night) - 1, false, QNFTYPE_TEXT);
-		qn_hfs_store_data(mnt, "one summer night.cmpr", one_summer_night, (uint)QN_COUNTOF(one_summer_night) - 1, true, QNFTYPE_TEXT);
-		qn_hfs_store_file(mnt, NULL, "QsLib.vcxproj", true, QNFTYPE_MARKUP);
-		qn_hfs_store_file(mnt, "qlem.html", "QsLibEm.html", true, QNFTYPE_MARKUP);
-		qn_hfs_store_file(mnt, "qlem.cmd", "QsLibEm.cmd", true, QNFTYPE_SCRIPT);
+		qn_hfs_store_data(mnt, "one summer night.txt", one_summer_night, (uint)QN_COUNTOF(one_summer_night) - 1, QNCODEC_STORE, QNFTYPE_TEXT);
+		qn_hfs_store_data(mnt, "one summer night.txt", one_summer_night, (uint)QN_COUNTOF(one_summer_night) - 1, QNCODEC_STORE, QNFTYPE_TEXT);
+		qn_hfs_store_data(mnt, "one summer night.cmpr", one_summer_night, (uint)QN_COUNTOF(one_summer_night) - 1, QNCODEC_DEFLATE, QNFTYPE_TEXT);
+		qn_hfs_store_data(mnt, "one summer night.lz", one_summer_night, (uint)QN_COUNTOF(one_summer_night) - 1, QNCODEC_LZ, QNFTYPE_TEXT);
+		qn_hfs_store_file(mnt, NULL, "QsLib.vcxproj", QNCODEC_DEFLATE, QNFTYPE_MARKUP);
+		qn_hfs_store_file(mnt, "qlem.html", "QsLibEm.html", QNCODEC_DEFLATE, QNFTYPE_MARKUP);
+		qn_hfs_store_file(mnt, "qlem.cmd", "QsLibEm.cmd", QNCODEC_DEFLATE, QNFTYPE_SCRIPT);
 		qn_remove_file(mnt, "qlem.html");
 		qn_chdir(mnt, "/");
 		qn_chdir(mnt, "test");
@@ -175,6 +176,11 @@ int main(void)
 		qn_outputs(psz);
 		qn_free(psz);
 
+		psz = qn_file_alloc(mnt, "one summer night.lz", &size);
+		qn_outputf("lz: %s", psz != NULL && size == (int)QN_COUNTOF(one_summer_night) - 1 &&
+			memcmp(psz, one_summer_night, (size_t)size) == 0 ? "same" : "FAIL");
+		qn_free(psz);
+
 		psz = qn_file_alloc_text(mnt, "/test/qlem.cmd", NULL, NULL);
 		qn_outputs(psz);
 		qn_free(psz);
@@ -231,6 +237,32 @@ int main(void)
 		qn_unload(mnt);
 	}
 
+	// 메모리 매핑으로 열기, 압축 안한 파일은 복사하지 않는다
+	mnt = qn_open_mount("test_opt.hfs", "hfv");
+	if (mnt)
+	{
+		qn_outputf("mapped: %s", QN_TMASK(mnt->flags, QNMFT_MAPPED) ? "yes" : "no");
+		QnStream* stream = qn_open_stream(mnt, "/test/one summer night.txt", NULL);
+		if (stream)
+		{
+			const char* view = qn_mem_stream_get_data(stream);
+			const int size = (int)qn_stream_size(stream);
+			qn_outputf("view: %s, same: %s", QN_TMASK(stream->flags, QNFFT_VIEW) ? "yes" : "no",
+				view != NULL && size == (int)QN_COUNTOF(one_summer_night) - 1 && memcmp(view, one_summer_night, size) == 0 ? "yes" : "no");
+			qn_unload(stream);
+		}
+
+		int size;
+		char* psz = qn_file_alloc(mnt, "/test/one summer night.cmpr", &size);
+		if (psz)
+		{
+			qn_outputf("cmpr same: %s", size == (int)QN_COUNTOF(one_summer_night) - 1 && memcmp(psz, one_summer_night, size) == 0 ? "yes" : "no");
+			qn_free(psz);
+		}
+
+		qn_unload(mnt);
+	}
+
 	return 0;
 }
 
@@ -0,0 +1,56 @@
+﻿// 메모리 프로파일러 스레드 할당 벤치마크
+#include <qs.h>
+
+#define MAX_THREADS		8
+#define LOOP_COUNT		20000
+#define BATCH_COUNT		64
+
+static void* bench_thread(void* data)
+{
+	const nuint seed = (nuint)data;
+	void* ptrs[BATCH_COUNT];
+	for (int loop = 0; loop < LOOP_COUNT; loop++)
+	{
+		for (int i = 0; i < BATCH_COUNT; i++)
+		{
+			const size_t size = 8 + ((seed + (nuint)loop * 31 + (nuint)i * 17) % 500);
+			ptrs[i] = qn_alloc(size, byte);
+			((byte*)ptrs[i])[0] = (byte)i;
+		}
+		for (int i = 0; i < BATCH_COUNT; i++)
+			qn_free(ptrs[i]);
+	}
+	return NULL;
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+
+	double base = 0.0;
+	for (int count = 1; count <= MAX_THREADS; count <<= 1)
+	{
+		QnThread* threads[MAX_THREADS];
+		for (int i = 0; i < count; i++)
+			threads[i] = qn_new_thread("bench", bench_thread, (void*)(nuint)i, 0, 0);
+
+		const double start = qn_elapsed();
+		for (int i = 0; i < count; i++)
+			qn_thread_start(threads[i]);
+		for (int i = 0; i < count; i++)
+			qn_thread_wait(threads[i]);
+		const double elapsed = qn_elapsed() - start;
+
+		for (int i = 0; i < count; i++)
+			qn_delete_thread(threads[i]);
+
+		const double ops = (double)count * LOOP_COUNT * BATCH_COUNT * 2.0 / elapsed;
+		if (count == 1)
+			base = ops;
+		qn_outputf("threads: %d, time: %.3f sec, %.2f Mops/sec, scale: %.2fx",
+			count, elapsed, ops / 1000000.0, ops / base);
+	}
+
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return 0;
+}
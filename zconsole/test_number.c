@@ -0,0 +1,348 @@
+﻿// 숫자 변환 테스트, CRT와 결과를 맞춰 보고 속도를 비교
+#include <qs.h>
+#include <stdio.h>
+
+#define CHECK_COUNT		200000
+#define SHORT_COUNT		20000				// 가장 짧은지 CRT로 하나씩 찾아 보는 수
+#define BENCH_COUNT		1000000
+
+static ullong rand64(QnRandom* rnd)
+{
+	return ((ullong)(uint)qn_rand(rnd) << 32) | (uint)qn_rand(rnd);
+}
+
+// 아무 비트나 만든 유한한 double
+static double rand_double(QnRandom* rnd)
+{
+	for (;;)
+	{
+		const ullong bits = rand64(rnd);
+		if ((bits & 0x7FF0000000000000ULL) != 0x7FF0000000000000ULL)
+		{
+			double d;
+			memcpy(&d, &bits, sizeof(double));
+			return d;
+		}
+	}
+}
+
+// 가끔은 보통 크기 값
+static double rand_value(QnRandom* rnd)
+{
+	switch (qn_rand(rnd) % 4)
+	{
+		case 0:
+			return rand_double(rnd);
+		case 1:
+			return (double)(qn_rand(rnd) % 100000) / 100.0;
+		case 2:
+			return ((double)rand64(rnd) / 18446744073709551616.0 - 0.5) * 1e6;
+		default:
+			return (double)(int)qn_rand(rnd) * 1e-3;
+	}
+}
+
+static bool same_bits(double a, double b)
+{
+	return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+// 짧은 문자열이 다시 같은 값으로 읽히고, CRT가 찾은 가장 짧은 자릿수와 같은지
+static bool check_shortest(void)
+{
+	QnRandom rnd;
+	qn_srand(&rnd, 1234);
+	char buf[64], ref[64];
+	int fails = 0;
+	for (int i = 0; i < CHECK_COUNT && fails < 10; i++)
+	{
+		const double d = rand_value(&rnd);
+		const int len = qn_dtoa(buf, d);
+		if (len != (int)strlen(buf) || len != qn_dtoa(NULL, d) || same_bits(strtod(buf, NULL), d) == false ||
+			same_bits(qn_strtod(buf), d) == false)
+		{
+			qn_outputf("  dtoa round trip: %.17g -> %s", d, buf);
+			fails++;
+			continue;
+		}
+		if (i >= SHORT_COUNT)
+			continue;
+		// 부호, 앞뒤의 0, 소수점, 지수를 뺀 유효 숫자 수
+		int digits = 0, zeros = 0;
+		for (const char* p = buf; *p && *p != 'e'; p++)
+		{
+			if (*p < '0' || *p > '9' || (digits == 0 && *p == '0'))
+				continue;
+			zeros = *p == '0' ? zeros + 1 : 0;
+			digits++;
+		}
+		digits = QN_MAX(digits - zeros, 1);
+		int need = 1;
+		for (; need < 17; need++)
+		{
+			snprintf(ref, sizeof(ref), "%.*e", need - 1, d);
+			if (same_bits(strtod(ref, NULL), d))
+				break;
+		}
+		if (digits != need)
+		{
+			qn_outputf("  dtoa not shortest: %s (%d digits, crt %d)", buf, digits, need);
+			fails++;
+		}
+	}
+
+	for (int i = 0; i < CHECK_COUNT && fails < 10; i++)
+	{
+		uint bits = (uint)qn_rand(&rnd);
+		if ((bits & 0x7F800000U) == 0x7F800000U)
+			continue;
+		float f;
+		memcpy(&f, &bits, sizeof(float));
+		qn_ftoa(buf, f);
+		const float back = strtof(buf, NULL), mine = qn_strtof(buf);
+		if (memcmp(&back, &f, sizeof(float)) != 0 || memcmp(&mine, &f, sizeof(float)) != 0)
+		{
+			qn_outputf("  ftoa round trip: %.9g -> %s", (double)f, buf);
+			fails++;
+		}
+	}
+
+	static const struct { double value; const char* text; } fixed[] =
+	{
+		{ 0.0, "0" }, { -0.0, "-0" }, { 1.0, "1" }, { 0.1, "0.1" }, { 1e21, "1e+21" }, { 1e20, "100000000000000000000" },
+		{ 123456.789, "123456.789" }, { 1e-7, "1e-7" }, { 0.000001, "0.000001" }, { 5e-324, "5e-324" },
+		{ 1.7976931348623157e308, "1.7976931348623157e+308" }, { 2.2250738585072014e-308, "2.2250738585072014e-308" },
+		{ 9007199254740993.0, "9007199254740992" }, { -2.5, "-2.5" },
+	};
+	for (size_t i = 0; i < QN_COUNTOF(fixed); i++)
+	{
+		qn_dtoa(buf, fixed[i].value);
+		if (strcmp(buf, fixed[i].text) != 0)
+		{
+			qn_outputf("  dtoa: %s, expect %s", buf, fixed[i].text);
+			fails++;
+		}
+	}
+	qn_ftoa(buf, 0.1f);
+	fails += strcmp(buf, "0.1") != 0;
+	qn_ftoa(buf, 16777216.0f);
+	fails += strcmp(buf, "16777216") != 0;
+
+	qn_outputf("shortest: %s", fails == 0 ? "ok" : "FAIL");
+	return fails == 0;
+}
+
+// 읽기를 CRT strtod, strtof와 비트까지 맞춰 본다
+static bool check_parse(void)
+{
+	static const char* hard[] =
+	{
+		"0", "-0", "1", "0.1", "1e23", "8.5e-324", "2.4703282292062327e-324", "2.4703282292062328e-324",
+		"9007199254740993", "9007199254740992.999999999999999999999", "2.2250738585072011e-308",
+		"2.2250738585072012e-308", "1.7976931348623158e308", "1.7976931348623159e308", "4.9406564584124654e-324",
+		"179769313486231580793728971405301e276", "0.000000000000000000000000000000000000000000001e300",
+		"123456789012345678901234567890", "1.00000000000000011102230246251565404236316680908203125",
+		"1.00000000000000011102230246251565404236316680908203124", "1.00000000000000011102230246251565404236316680908203126",
+		"7.038531e-26", "3.4028235677973366e38", "1.1754943508222875e-38", "16777217", "33554435", "1e-400", "1e400",
+		"  +12.5e+3", "-.5", "5.", "1e", "1e+", "00000000000000000000000000000012345", ".000000000000000000000000000000000000001",
+		"1234567890123456789", "12345678901234567890", "123456789012345678901e-21",
+	};
+	int fails = 0;
+	for (size_t i = 0; i < QN_COUNTOF(hard); i++)
+	{
+		const double crt = strtod(hard[i], NULL), mine = qn_strtod(hard[i]);
+		const float crtf = strtof(hard[i], NULL), minef = qn_strtof(hard[i]);
+		if (same_bits(crt, mine) == false || memcmp(&crtf, &minef, sizeof(float)) != 0)
+		{
+			qn_outputf("  parse: %s -> %.17g / %.9g, crt %.17g / %.9g", hard[i], mine, (double)minef, crt, (double)crtf);
+			fails++;
+		}
+	}
+	fails += qn_strtod("inf") != HUGE_VAL || qn_strtod("-Infinity") != -HUGE_VAL || qn_strtod("nan") == qn_strtod("nan");
+
+	// 아무 값을 여러 모양으로 찍어서 읽기
+	QnRandom rnd;
+	qn_srand(&rnd, 5678);
+	char buf[128];
+	for (int i = 0; i < CHECK_COUNT && fails < 10; i++)
+	{
+		const double d = rand_value(&rnd);
+		switch (i % 4)
+		{
+			case 0:
+				snprintf(buf, sizeof(buf), "%.17g", d);
+				break;
+			case 1:
+				snprintf(buf, sizeof(buf), "%.*e", (int)(qn_rand(&rnd) % 25), d);
+				break;
+			case 2:
+				snprintf(buf, sizeof(buf), "%.*f", (int)(qn_rand(&rnd) % 8), d > 1e30 || d < -1e30 ? d * 1e-280 : d);
+				break;
+			default:
+			{
+				// 긴 숫자, 지수
+				int len = 0;
+				const int digits = 1 + (int)(qn_rand(&rnd) % 40);
+				for (int n = 0; n < digits; n++)
+					buf[len++] = (char)('0' + qn_rand(&rnd) % 10);
+				snprintf(buf + len, sizeof(buf) - (size_t)len, "e%d", (int)(qn_rand(&rnd) % 700) - 350);
+				break;
+			}
+		}
+		const double crt = strtod(buf, NULL), mine = qn_strtod(buf);
+		const float crtf = strtof(buf, NULL), minef = qn_strtof(buf);
+		if (same_bits(crt, mine) == false || memcmp(&crtf, &minef, sizeof(float)) != 0)
+		{
+			qn_outputf("  parse: %s -> %.17g / %.9g, crt %.17g / %.9g", buf, mine, (double)minef, crt, (double)crtf);
+			fails++;
+		}
+	}
+	qn_outputf("parse: %s", fails == 0 ? "ok" : "FAIL");
+	return fails == 0;
+}
+
+// printf 실수, 정수를 CRT와 글자까지 맞춰 본다
+static bool check_printf(void)
+{
+	static const char* formats[] =
+	{
+		"%f", "%.0f", "%.1f", "%.3f", "%.10f", "%.20f", "%e", "%.0e", "%.3e", "%.16e", "%.20e", "%g", "%.1g", "%.3g",
+		"%.10g", "%.15g", "%.17g", "%.20g", "%#g", "%#.0f", "%G", "%E", "%12.4f", "%-12.3e|", "%+.2f", "% .3g", "%012.3f",
+	};
+	static const double specials[] =
+	{
+		0.0, -0.0, 0.5, 1.5, 2.5, -0.5, 0.05, 0.15, 0.25, 0.35, 1e-5, 1e-4, 123456.0, 1e15, 1e16, 1e17, 1e20, 1e21, 1e22,
+		1e23, 1e100, 1e300, 1e-300, 5e-324, 1.7976931348623157e308, 2.2250738585072014e-308, 9.5, 99.5, 0.1,
+		1.0 / 3.0, 2.0 / 3.0, 9.999999999999999e22, 0.000123456789, 4503599627370497.5,
+	};
+	QnRandom rnd;
+	qn_srand(&rnd, 9012);
+	char mine[2048], crt[2048];
+	int fails = 0;
+	for (int i = 0; i < (int)QN_COUNTOF(specials) + CHECK_COUNT / 4 && fails < 10; i++)
+	{
+		const double d = i < (int)QN_COUNTOF(specials) ? specials[i] : rand_value(&rnd);
+		for (size_t f = 0; f < QN_COUNTOF(formats); f++)
+		{
+			qn_snprintf(mine, sizeof(mine), formats[f], d);
+			snprintf(crt, sizeof(crt), formats[f], d);
+			if (strcmp(mine, crt) != 0)
+			{
+				qn_outputf("  printf \"%s\" %.17g: [%s] crt [%s]", formats[f], d, mine, crt);
+				fails++;
+				break;
+			}
+		}
+	}
+
+	// 무한대, NaN, 정수
+	qn_snprintf(mine, sizeof(mine), "%f %F %e %g", HUGE_VAL, -HUGE_VAL, HUGE_VAL, HUGE_VAL);
+	fails += strcmp(mine, "inf -INF inf inf") != 0;
+	static const llong ints[] = { 0, 1, -1, 9, 10, 99, 100, 12345, -12345, 2147483647, -2147483647 - 1, 4294967295LL,
+		9223372036854775807LL, -9223372036854775807LL - 1, 1000000000000LL };
+	char buf[80];
+	for (size_t i = 0; i < QN_COUNTOF(ints); i++)
+	{
+		const int n = (int)ints[i];
+		const long long ll = ints[i];
+		snprintf(crt, sizeof(crt), "%d %lld %x %llX %o %5d|%-6lld|%08d", n, ll, (uint)n, (unsigned long long)ll, (uint)n, n, ll, n);
+		qn_snprintf(mine, sizeof(mine), "%d %lld %x %llX %o %5d|%-6lld|%08d", n, ll, (uint)n, (unsigned long long)ll, (uint)n, n, ll, n);
+		fails += strcmp(mine, crt) != 0;
+		snprintf(crt, sizeof(crt), "%d", n);
+		fails += qn_itoa(buf, n, 10, false) != (int)strlen(crt) || strcmp(buf, crt) != 0;
+		snprintf(crt, sizeof(crt), "%lld", ll);
+		fails += qn_lltoa(buf, ints[i], 10, false) != (int)strlen(crt) || strcmp(buf, crt) != 0;
+		snprintf(crt, sizeof(crt), "%llx", (unsigned long long)ll);
+		fails += qn_lltoa(buf, ints[i], 16, false) != (int)strlen(crt) || strcmp(buf, crt) != 0;
+	}
+	qn_itoa(buf, 5, 2, false);
+	fails += strcmp(buf, "101") != 0;
+
+	qn_outputf("printf: %s", fails == 0 ? "ok" : "FAIL");
+	return fails == 0;
+}
+
+// 같은 값들로 CRT와 속도 비교
+static void bench(void)
+{
+	QnRandom rnd;
+	qn_srand(&rnd, 3456);
+	double* values = qn_alloc(BENCH_COUNT, double);
+	char* texts = qn_alloc(BENCH_COUNT * 32, char);
+	for (int i = 0; i < BENCH_COUNT; i++)
+	{
+		values[i] = rand_value(&rnd);
+		snprintf(texts + i * 32, 32, "%.17g", values[i]);
+	}
+
+	char buf[64];
+	volatile size_t sink = 0;
+	double start, mine, crt;
+	qn_outputf("%-18s %12s %12s %10s", "test", "qn (ms)", "crt (ms)", "speedup");
+
+	start = qn_elapsed();
+	for (int i = 0; i < BENCH_COUNT; i++)
+		sink += (size_t)qn_dtoa(buf, values[i]);
+	mine = qn_elapsed() - start;
+	start = qn_elapsed();
+	for (int i = 0; i < BENCH_COUNT; i++)
+		sink += (size_t)snprintf(buf, sizeof(buf), "%.17g", values[i]);
+	crt = qn_elapsed() - start;
+	qn_outputf("%-18s %12.3f %12.3f %9.1fx", "dtoa / %.17g", mine * 1000.0, crt * 1000.0, crt / mine);
+
+	start = qn_elapsed();
+	for (int i = 0; i < BENCH_COUNT; i++)
+		sink += (size_t)qn_strtod(texts + i * 32);
+	mine = qn_elapsed() - start;
+	start = qn_elapsed();
+	for (int i = 0; i < BENCH_COUNT; i++)
+		sink += (size_t)strtod(texts + i * 32, NULL);
+	crt = qn_elapsed() - start;
+	qn_outputf("%-18s %12.3f %12.3f %9.1fx", "strtod", mine * 1000.0, crt * 1000.0, crt / mine);
+
+	start = qn_elapsed();
+	for (int i = 0; i < BENCH_COUNT; i++)
+		sink += (size_t)qn_snprintf(buf, sizeof(buf), "%.3f", values[i] * 1e-290);
+	mine = qn_elapsed() - start;
+	start = qn_elapsed();
+	for (int i = 0; i < BENCH_COUNT; i++)
+		sink += (size_t)snprintf(buf, sizeof(buf), "%.3f", values[i] * 1e-290);
+	crt = qn_elapsed() - start;
+	qn_outputf("%-18s %12.3f %12.3f %9.1fx", "printf %.3f", mine * 1000.0, crt * 1000.0, crt / mine);
+
+	start = qn_elapsed();
+	for (int i = 0; i < BENCH_COUNT; i++)
+		sink += (size_t)qn_snprintf(buf, sizeof(buf), "%g", values[i]);
+	mine = qn_elapsed() - start;
+	start = qn_elapsed();
+	for (int i = 0; i < BENCH_COUNT; i++)
+		sink += (size_t)snprintf(buf, sizeof(buf), "%g", values[i]);
+	crt = qn_elapsed() - start;
+	qn_outputf("%-18s %12.3f %12.3f %9.1fx", "printf %g", mine * 1000.0, crt * 1000.0, crt / mine);
+
+	start = qn_elapsed();
+	for (int i = 0; i < BENCH_COUNT; i++)
+		sink += (size_t)qn_lltoa(buf, (llong)rand64(&rnd) >> (i & 63), 10, false);
+	mine = qn_elapsed() - start;
+	start = qn_elapsed();
+	for (int i = 0; i < BENCH_COUNT; i++)
+		sink += (size_t)snprintf(buf, sizeof(buf), "%lld", (long long)rand64(&rnd) >> (i & 63));
+	crt = qn_elapsed() - start;
+	qn_outputf("%-18s %12.3f %12.3f %9.1fx", "lltoa / %lld", mine * 1000.0, crt * 1000.0, crt / mine);
+
+	qn_free(texts);
+	qn_free(values);
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+
+	bool ok = check_shortest();
+	ok = check_parse() && ok;
+	ok = check_printf() && ok;
+	bench();
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+﻿// 병렬 처리 벤치마크, 스레드 갯수에 따른 속도
+#include <qs.h>
+#include <math.h>
+
+#define FOR_COUNT		(4 * 1024 * 1024)
+#define SORT_COUNT		(4 * 1024 * 1024)
+
+typedef struct VERTEX
+{
+	float			x, y, z, w;
+} Vertex;
+
+typedef struct TRANSFORM
+{
+	const Vertex*	src;
+	Vertex*			dst;
+	float			m[16];
+} Transform;
+
+// 정점 변환, 메시 처리 흉내
+static void transform_range(void* context, size_t begin, size_t end)
+{
+	const Transform* t = (const Transform*)context;
+	for (size_t i = begin; i < end; i++)
+	{
+		const Vertex* v = &t->src[i];
+		Vertex* o = &t->dst[i];
+		o->x = v->x * t->m[0] + v->y * t->m[4] + v->z * t->m[8] + t->m[12];
+		o->y = v->x * t->m[1] + v->y * t->m[5] + v->z * t->m[9] + t->m[13];
+		o->z = v->x * t->m[2] + v->y * t->m[6] + v->z * t->m[10] + t->m[14];
+		o->w = sqrtf(o->x * o->x + o->y * o->y + o->z * o->z);
+	}
+}
+
+static int uint_cmp(const void* l, const void* r)
+{
+	const uint a = *(const uint*)l, b = *(const uint*)r;
+	return a < b ? -1 : a > b ? 1 : 0;
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+
+	Transform t = { .m = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 3, 4, 5, 1 } };
+	Vertex* src = qn_alloc(FOR_COUNT, Vertex);
+	Vertex* dst = qn_alloc(FOR_COUNT, Vertex);
+	for (size_t i = 0; i < FOR_COUNT; i++)
+		src[i] = (Vertex){ (float)i, (float)(i % 100), (float)(i % 7), 1.0f };
+	t.src = src;
+	t.dst = dst;
+	transform_range(&t, 0, FOR_COUNT);		// 처음 쓰는 메모리 비용을 미리
+
+	uint* source = qn_alloc(SORT_COUNT, uint);
+	uint* data = qn_alloc(SORT_COUNT, uint);
+	QnRandom rnd;
+	qn_srand(&rnd, 1234);
+	for (size_t i = 0; i < SORT_COUNT; i++)
+		source[i] = (uint)qn_rand(&rnd);
+
+	const uint cores = qn_cpu_count();
+	qn_outputf("cores: %u", cores);
+	qn_outputf("%7s %12s %8s %12s %8s", "threads", "for (ms)", "speedup", "sort (ms)", "speedup");
+
+	double base_for = 0.0, base_sort = 0.0;
+	bool ok = true;
+	const uint max_threads = QN_MAX(cores, 4);
+	for (uint threads = 1; threads <= max_threads; threads *= 2)
+	{
+		qn_parallel_threads(threads);
+
+		double start = qn_elapsed();
+		for (int r = 0; r < 4; r++)
+			qn_parallel_for(FOR_COUNT, 0, transform_range, &t);
+		const double time_for = (qn_elapsed() - start) / 4 * 1000.0;
+		if (dst[FOR_COUNT - 1].x != src[FOR_COUNT - 1].x + 3.0f)
+			ok = false;
+
+		memcpy(data, source, SORT_COUNT * sizeof(uint));
+		start = qn_elapsed();
+		qn_parallel_sort(data, SORT_COUNT, sizeof(uint), uint_cmp);
+		const double time_sort = (qn_elapsed() - start) * 1000.0;
+		for (size_t i = 1; i < SORT_COUNT; i++)
+			if (data[i - 1] > data[i])
+			{
+				ok = false;
+				break;
+			}
+
+		if (threads == 1)
+		{
+			base_for = time_for;
+			base_sort = time_sort;
+		}
+		qn_outputf("%7u %12.3f %7.2fx %12.3f %7.2fx", threads, time_for, base_for / time_for, time_sort, base_sort / time_sort);
+	}
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+
+	qn_free(src);
+	qn_free(dst);
+	qn_free(source);
+	qn_free(data);
+	// 일꾼 스레드와 동기화 개체는 런타임이 내려갈 때 정리된다
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
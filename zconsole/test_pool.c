@@ -0,0 +1,207 @@
+﻿// 메모리 풀 벤치마크
+#include <qs.h>
+
+#define ROUND_COUNT		200
+#define KEY_COUNT		4096
+
+QN_DECLIMPL_HASH_INT_AND_INT_TYPE(IntHash, int, int, int_hash);
+QN_DECLIMPL_HASH_POOLED(PoolHash, int, int, qn_int_type_phash, qn_int_type_pcmp, (void), (void), pool_hash);
+QN_DECLIMPL_MUKUM_INT_AND_INT_TYPE(IntMukum, int, int, int_mukum);
+QN_DECLIMPL_MUKUM_POOLED(PoolMukum, int, int, qn_int_type_phash, qn_int_type_pcmp, (void), (void), pool_mukum);
+QN_DECLIMPL_LIST(IntList, int, int_list);
+QN_DECLIMPL_LIST_POOLED(PoolList, int, pool_list);
+
+typedef struct INTNODE IntNode;
+struct INTNODE
+{
+	IntNode* PREV;
+	IntNode* NEXT;
+	int value;
+};
+QN_DECLIMPL_LNODE(IntNodeList, IntNode, int_lnode);
+QN_DECLIMPL_LNODE_POOLED(PoolNodeList, IntNode, pool_lnode);
+
+// 해시 넣고 빼기
+static double bench_hash(void)
+{
+	IntHash hash;
+	int_hash_init(&hash);
+	const double start = qn_elapsed();
+	for (int round = 0; round < ROUND_COUNT; round++)
+	{
+		for (int i = 0; i < KEY_COUNT; i++)
+			int_hash_set(&hash, i * 7 + round, i);
+		for (int i = 0; i < KEY_COUNT; i++)
+			int_hash_remove(&hash, i * 7 + round);
+	}
+	const double elapsed = qn_elapsed() - start;
+	int_hash_dispose(&hash);
+	return elapsed;
+}
+
+// 풀 해시 넣고 빼기
+static double bench_pool_hash(void)
+{
+	PoolHash hash;
+	pool_hash_init(&hash);
+	const double start = qn_elapsed();
+	for (int round = 0; round < ROUND_COUNT; round++)
+	{
+		for (int i = 0; i < KEY_COUNT; i++)
+			pool_hash_set(&hash, i * 7 + round, i);
+		for (int i = 0; i < KEY_COUNT; i++)
+			pool_hash_remove(&hash, i * 7 + round);
+	}
+	const double elapsed = qn_elapsed() - start;
+	pool_hash_dispose(&hash);
+	return elapsed;
+}
+
+// 묶음 넣고 빼기
+#define BENCH_MUKUM(NAME, PFX)												\
+	static double bench_##PFX(void)											\
+	{																		\
+		NAME mukum;															\
+		PFX##_init(&mukum);													\
+		const double start = qn_elapsed();									\
+		for (int round = 0; round < ROUND_COUNT; round++)					\
+		{																	\
+			for (int i = 0; i < KEY_COUNT; i++)								\
+				PFX##_set(&mukum, i * 7 + round, i);						\
+			for (int i = 0; i < KEY_COUNT; i++)								\
+				PFX##_remove(&mukum, i * 7 + round);						\
+		}																	\
+		const double elapsed = qn_elapsed() - start;						\
+		PFX##_dispose(&mukum);												\
+		return elapsed;														\
+	}
+BENCH_MUKUM(IntMukum, int_mukum)
+BENCH_MUKUM(PoolMukum, pool_mukum)
+
+// 리스트 뒤에 넣고 앞에서 빼기
+#define BENCH_LIST(NAME, PFX)												\
+	static double bench_##PFX(void)											\
+	{																		\
+		NAME list;															\
+		PFX##_init(&list);													\
+		const double start = qn_elapsed();									\
+		for (int round = 0; round < ROUND_COUNT; round++)					\
+		{																	\
+			for (int i = 0; i < KEY_COUNT; i++)								\
+				PFX##_append(&list, i);										\
+			for (int i = 0; i < KEY_COUNT; i++)								\
+				PFX##_remove_head(&list);									\
+		}																	\
+		const double elapsed = qn_elapsed() - start;						\
+		PFX##_dispose(&list);												\
+		return elapsed;														\
+	}
+BENCH_LIST(IntList, int_list)
+BENCH_LIST(PoolList, pool_list)
+
+// 노드 리스트, 노드를 만들어 넣고 앞에서 빼면서 해제
+#define BENCH_LNODE(NAME, PFX)												\
+	static double bench_##PFX(void)											\
+	{																		\
+		NAME list;															\
+		PFX##_init(&list);													\
+		const double start = qn_elapsed();									\
+		for (int round = 0; round < ROUND_COUNT; round++)					\
+		{																	\
+			for (int i = 0; i < KEY_COUNT; i++)								\
+			{																\
+				IntNode* node = PFX##_new_node(&list);						\
+				node->value = i;											\
+				PFX##_append(&list, node);									\
+			}																\
+			for (int i = 0; i < KEY_COUNT; i++)								\
+				PFX##_remove_head(&list, true);								\
+		}																	\
+		const double elapsed = qn_elapsed() - start;						\
+		PFX##_dispose(&list);												\
+		return elapsed;														\
+	}
+BENCH_LNODE(IntNodeList, int_lnode)
+BENCH_LNODE(PoolNodeList, pool_lnode)
+
+// 메모리 스트림 열고 닫기, 스트림 개체는 스트림 풀에서 온다
+static double bench_stream(void)
+{
+	QnStream* streams[KEY_COUNT / 16];
+	const double start = qn_elapsed();
+	for (int round = 0; round < ROUND_COUNT; round++)
+	{
+		for (size_t i = 0; i < QN_COUNTOF(streams); i++)
+			streams[i] = qn_create_mem_stream("bench", 0);
+		for (size_t i = 0; i < QN_COUNTOF(streams); i++)
+			qn_unload(streams[i]);
+	}
+	return qn_elapsed() - start;
+}
+
+// 노드 할당만
+static double bench_node(QnPool* pool)
+{
+	void* ptrs[KEY_COUNT];
+	const double start = qn_elapsed();
+	for (int round = 0; round < ROUND_COUNT; round++)
+	{
+		for (int i = 0; i < KEY_COUNT; i++)
+			ptrs[i] = pool ? qn_pool_alloc(pool, false) : qn_alloc_1(IntHashNode);
+		for (int i = 0; i < KEY_COUNT; i++)
+		{
+			if (pool)
+				qn_pool_free(pool, ptrs[i]);
+			else
+				qn_free(ptrs[i]);
+		}
+	}
+	return qn_elapsed() - start;
+}
+
+static void report_count(const char* name, double elapsed, double base, double count)
+{
+	const double ops = (double)ROUND_COUNT * count * 2.0 / elapsed;
+	qn_outputf("%-16s time: %.3f sec, %.2f Mops/sec, %.2fx", name, elapsed, ops / 1000000.0, base / elapsed);
+}
+
+static void report(const char* name, double elapsed, double base)
+{
+	report_count(name, elapsed, base, KEY_COUNT);
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+
+	const double node = bench_node(NULL);
+	report("qn_alloc node", node, node);
+	QnPool* pool = qn_new_pool(sizeof(IntHashNode), 0, false);
+	report("pool node", bench_node(pool), node);
+	qn_delete_pool(pool);
+	pool = qn_new_pool(sizeof(IntHashNode), 0, true);
+	report("pool node (lock)", bench_node(pool), node);
+	qn_delete_pool(pool);
+
+	const double hash = bench_hash();
+	report("hash", hash, hash);
+	report("pooled hash", bench_pool_hash(), hash);
+
+	const double mukum = bench_int_mukum();
+	report("mukum", mukum, mukum);
+	report("pooled mukum", bench_pool_mukum(), mukum);
+
+	const double list = bench_int_list();
+	report("list", list, list);
+	report("pooled list", bench_pool_list(), list);
+
+	const double lnode = bench_int_lnode();
+	report("lnode", lnode, lnode);
+	report("pooled lnode", bench_pool_lnode(), lnode);
+
+	const double stream = bench_stream();
+	report_count("mem stream", stream, stream, KEY_COUNT / 16);
+
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return 0;
+}
@@ -0,0 +1,136 @@
+﻿// 정렬 벤치마크
+#include <qs.h>
+
+QN_DECLIMPL_SORT(uint_sort, uint, qn_sort_less);
+
+// 안정 정렬 확인용, 키가 같으면 순서가 유지되어야 한다
+typedef struct PAIR
+{
+	uint			key;
+	uint			order;
+} Pair;
+#define PAIR_LESS(l,r)		((l)->key < (r)->key)
+#define PAIR_KEY(p)			((p)->key)
+QN_DECLIMPL_SORT(pair_sort, Pair, PAIR_LESS);
+QN_DECLIMPL_RADIX_SORT(pair_sort, Pair, uint, PAIR_KEY);
+
+static int uint_cmp(const void* l, const void* r)
+{
+	const uint a = *(const uint*)l, b = *(const uint*)r;
+	return a < b ? -1 : a > b ? 1 : 0;
+}
+
+typedef enum PATTERN
+{
+	PATTERN_RANDOM,
+	PATTERN_SORTED,
+	PATTERN_REVERSED,
+	PATTERN_FEW,
+	PATTERN_MAX_VALUE,
+} Pattern;
+static const char* pattern_names[] = { "random", "sorted", "reverse", "few" };
+
+static void fill(uint* data, size_t count, Pattern pattern, QnRandom* rnd)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		switch (pattern)
+		{
+			case PATTERN_RANDOM: data[i] = (uint)qn_rand(rnd); break;
+			case PATTERN_SORTED: data[i] = (uint)i; break;
+			case PATTERN_REVERSED: data[i] = (uint)(count - i); break;
+			case PATTERN_FEW: data[i] = (uint)qn_rand(rnd) % 16; break;
+			default: break;
+		}
+	}
+}
+
+static bool is_sorted(const uint* data, size_t count)
+{
+	for (size_t i = 1; i < count; i++)
+		if (data[i - 1] > data[i])
+			return false;
+	return true;
+}
+
+typedef void(*sort_func)(uint*, size_t);
+static void sort_qsort(uint* data, size_t count) { qn_qsort(data, count, sizeof(uint), uint_cmp); }
+
+static double bench(sort_func func, uint* data, const uint* source, size_t count, int round, bool* ok)
+{
+	double total = 0.0;
+	for (int r = 0; r < round; r++)
+	{
+		memcpy(data, source, count * sizeof(uint));
+		const double start = qn_elapsed();
+		func(data, count);
+		total += qn_elapsed() - start;
+		if (!is_sorted(data, count))
+			*ok = false;
+	}
+	return total / round * 1000.0;
+}
+
+// 같은 키의 처음 순서가 유지되는지
+static bool check_stable(void)
+{
+	const size_t count = 10000;
+	Pair* pairs = qn_alloc(count, Pair);
+	Pair* radix = qn_alloc(count, Pair);
+	for (size_t i = 0; i < count; i++)
+	{
+		pairs[i].key = (uint)((i * 7919) % 97);
+		pairs[i].order = (uint)i;
+	}
+	memcpy(radix, pairs, count * sizeof(Pair));
+	pair_sort_sort_stable(pairs, count);
+	pair_sort_radix_sort(radix, count);
+	bool ok = true;
+	for (size_t i = 1; i < count; i++)
+	{
+		if (pairs[i - 1].key > pairs[i].key || (pairs[i - 1].key == pairs[i].key && pairs[i - 1].order > pairs[i].order))
+			ok = false;
+		if (radix[i].key != pairs[i].key || radix[i].order != pairs[i].order)
+			ok = false;
+	}
+	qn_free(pairs);
+	qn_free(radix);
+	return ok;
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+
+	qn_outputf("stable: %s", check_stable() ? "ok" : "FAIL");
+
+	static const size_t counts[] = { 1000, 10000, 100000, 1000000, 10000000 };
+	const size_t max_count = counts[QN_COUNTOF(counts) - 1];
+	uint* source = qn_alloc(max_count, uint);
+	uint* data = qn_alloc(max_count, uint);
+	QnRandom rnd;
+	qn_srand(&rnd, 1234);
+
+	bool ok = true;
+	qn_outputf("%-8s %9s %10s %10s %10s %10s  (ms)", "pattern", "count", "qn_qsort", "pdq", "stable", "radix");
+	for (Pattern p = 0; p < PATTERN_MAX_VALUE; p++)
+	{
+		for (size_t c = 0; c < QN_COUNTOF(counts); c++)
+		{
+			const size_t count = counts[c];
+			const int round = count <= 10000 ? 20 : count <= 1000000 ? 3 : 1;
+			fill(source, count, p, &rnd);
+			const double q = bench(sort_qsort, data, source, count, round, &ok);
+			const double s = bench(uint_sort_sort, data, source, count, round, &ok);
+			const double t = bench(uint_sort_sort_stable, data, source, count, round, &ok);
+			const double r = bench(qn_radix_sort32, data, source, count, round, &ok);
+			qn_outputf("%-8s %9zu %10.3f %10.3f %10.3f %10.3f", pattern_names[p], count, q, s, t, r);
+		}
+	}
+	qn_outputf("sorted: %s", ok ? "ok" : "FAIL");
+
+	qn_free(source);
+	qn_free(data);
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,346 @@
+﻿// 문자열 검색/변환 테스트, 한 바이트씩 보는 스칼라 구현과 결과를 맞춰 보고 CRT와 속도를 비교
+#include <qs.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#if defined _MSC_VER
+#define crt_stricmp		_stricmp
+#else
+#include <strings.h>
+#define crt_stricmp		strcasecmp
+#endif
+
+#define FUZZ_COUNT		100000
+#define CORPUS_SIZE		(1024 * 1024)
+#define BENCH_LOOP		500
+
+//////////////////////////////////////////////////////////////////////////
+// 한 바이트씩 보는 스칼라 기준
+
+static const char* ref_chr(const char* p, size_t len, char ch)
+{
+	for (size_t i = 0; i < len; i++)
+		if (p[i] == ch)
+			return p + i;
+	return NULL;
+}
+
+static const char* ref_rchr(const char* p, size_t len, char ch)
+{
+	while (len--)
+		if (p[len] == ch)
+			return p + len;
+	return NULL;
+}
+
+static const char* ref_brk(const char* p, size_t len, const char* c)
+{
+	for (size_t i = 0; i < len; i++)
+		if (p[i] != '\0' && strchr(c, p[i]) != NULL)
+			return p + i;
+	return NULL;
+}
+
+static const char* ref_str(const char* p, size_t len, const char* find, size_t findlen)
+{
+	if (findlen > len)
+		return NULL;
+	for (size_t i = 0; i + findlen <= len; i++)
+		if (memcmp(p + i, find, findlen) == 0)
+			return p + i;
+	return NULL;
+}
+
+static int ref_lower(int c)
+{
+	return c >= 'A' && c <= 'Z' ? c + 'a' - 'A' : c;
+}
+
+static int ref_icmp(const char* p1, const char* p2, size_t len)
+{
+	for (size_t i = 0; i < len; i++)
+	{
+		const int f = ref_lower((byte)p1[i]), l = ref_lower((byte)p2[i]);
+		if (f != l || f == 0)
+			return f - l;
+	}
+	return 0;
+}
+
+static char* crt_upr(char* p)
+{
+	for (char* s = p; *s; s++)
+		*s = (char)toupper((byte)*s);
+	return p;
+}
+
+static void ref_upr(char* p, size_t len)
+{
+	for (size_t i = 0; i < len; i++)
+		if (p[i] >= 'a' && p[i] <= 'z')
+			p[i] -= 'a' - 'A';
+}
+
+static bool ref_space(char c)
+{
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static size_t ref_trm(char* p, size_t len)
+{
+	size_t h = 0;
+	while (h < len && ref_space(p[h]))
+		h++;
+	while (len > h && ref_space(p[len - 1]))
+		len--;
+	memmove(p, p + h, len - h);
+	return len - h;
+}
+
+static size_t ref_rem(char* p, size_t len, const char* rmlist)
+{
+	size_t o = 0;
+	for (size_t i = 0; i < len; i++)
+		if (p[i] == '\0' || strchr(rmlist, p[i]) == NULL)
+			p[o++] = p[i];
+	return o;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 검사
+
+// 적은 글자로 채워야 찾는 글자가 자주 나온다
+static void rand_text(QnRandom* rnd, char* buf, size_t len)
+{
+	static const char alpha[] = "abcxyzABCXYZ \t\r\n=#;[]\x80\xC0\xFF";
+	for (size_t i = 0; i < len; i++)
+		buf[i] = alpha[qn_rand(rnd) % (sizeof(alpha) - 1)];
+}
+
+#define CHECK(cond, what)	do { if (!(cond)) { if (fails++ < 10) qn_outputf("FAIL %s: len=%d off=%d", what, (int)len, (int)off); } } while (0)
+
+static bool check(void)
+{
+	QnRandom rnd;
+	qn_srand(&rnd, 1234);
+	char* buf = qn_alloc(1024, char);
+	char* a = qn_alloc(1024, char);
+	char* b = qn_alloc(1024, char);
+	int fails = 0;
+
+	for (int n = 0; n < FUZZ_COUNT; n++)
+	{
+		const size_t off = qn_rand(&rnd) % 64;
+		const size_t len = qn_rand(&rnd) % 300;
+		char* p = buf + off;
+		rand_text(&rnd, p, len);
+		p[len] = '\0';
+
+		static const char chs[] = "az=#\n\x80\xFF!";
+		const char ch = chs[qn_rand(&rnd) % (sizeof(chs) - 1)];
+		CHECK(qn_strchr(p, ch) == ref_chr(p, len, ch), "strchr");
+		CHECK(qn_strnchr(p, len, ch) == ref_chr(p, len, ch), "strnchr");
+		CHECK(qn_strrchr(p, ch) == ref_rchr(p, len, ch), "strrchr");
+		CHECK(qn_strnrchr(p, len, ch) == ref_rchr(p, len, ch), "strnrchr");
+		CHECK(qn_strchr(p, 0) == p + len && qn_strrchr(p, 0) == p + len, "strchr nul");
+
+		static const char* sets[] = { "=", "#;", "[]=\n", "\x80\xFF", "!", "ABCXYZ\t" };
+		const char* set = sets[qn_rand(&rnd) % QN_COUNTOF(sets)];
+		CHECK(qn_strbrk(p, set) == ref_brk(p, len, set), "strbrk");
+		CHECK(qn_strnbrk(p, len, set) == ref_brk(p, len, set), "strnbrk");
+
+		// 찾을 문자열은 대상에서 잘라 오거나 아무렇게나
+		char find[16];
+		const size_t fl = qn_rand(&rnd) % 12;
+		if (len > fl && qn_rand(&rnd) % 2)
+			memcpy(find, p + qn_rand(&rnd) % (len - fl), fl);
+		else
+			rand_text(&rnd, find, fl);
+		find[fl] = '\0';
+		CHECK(qn_strnstr(p, len, find, fl) == ref_str(p, len, find, fl), "strnstr");
+		const char* fs = ref_str(p, len, find, fl);
+		CHECK(qn_strfnd(p, find, 0) == (fs ? (int)(fs - p) : -1), "strfnd");
+
+		// 대소문자 바꾼 사본과 비교, 가끔 한 글자 바꾸기
+		memcpy(a + off, p, len + 1);
+		memcpy(b, p, len + 1);
+		ref_upr(b, len);
+		qn_strupr(a + off);
+		CHECK(memcmp(a + off, b, len + 1) == 0, "strupr");
+		qn_strlwr(a + off);
+		for (size_t i = 0; i < len; i++)
+			b[i] = (char)ref_lower((byte)b[i]);
+		CHECK(memcmp(a + off, b, len + 1) == 0, "strlwr");
+		memcpy(a + off, p, len + 1);
+		ref_upr(b, len);
+		if (len && qn_rand(&rnd) % 2)
+			b[qn_rand(&rnd) % len] = (char)qn_rand(&rnd);
+		CHECK(qn_stricmp(a + off, b) == ref_icmp(a + off, b, len + 1), "stricmp");
+		const size_t cl = qn_rand(&rnd) % (len + 2);
+		CHECK(qn_strnicmp(a + off, b, cl) == ref_icmp(a + off, b, cl), "strnicmp");
+
+		memcpy(a + off, p, len + 1);
+		memcpy(b, p, len + 1);
+		const size_t tl = ref_trm(b, len);
+		CHECK(qn_strntrm(a + off, len) == tl && memcmp(a + off, b, tl) == 0, "strntrm");
+		memcpy(a + off, p, len + 1);
+		b[tl] = '\0';
+		CHECK(strcmp(qn_strtrm(a + off), b) == 0, "strtrm");
+
+		memcpy(a + off, p, len + 1);
+		memcpy(b, p, len + 1);
+		const size_t rl = ref_rem(b, len, set);
+		CHECK(qn_strnrem(a + off, len, set) == rl && memcmp(a + off, b, rl) == 0, "strnrem");
+		memcpy(a + off, p, len + 1);
+		b[rl] = '\0';
+		CHECK(strcmp(qn_strrem(a + off, set), b) == 0, "strrem");
+	}
+
+	qn_free(b);
+	qn_free(a);
+	qn_free(buf);
+	qn_outputf("check: %s", fails == 0 ? "ok" : "FAIL");
+	return fails == 0;
+}
+
+// 페이지 경계에 걸친 문자열, 벡터로 읽는 범위가 경계에서 나뉜다
+static bool check_page(void)
+{
+	QnRandom rnd;
+	qn_srand(&rnd, 4321);
+	char* mem = qn_alloc(4096 * 4, char);
+	char* edge = (char*)(((nuint)mem + 4096 * 2) & ~(nuint)4095);
+	int fails = 0;
+
+	for (int n = 0; n < 20000; n++)
+	{
+		const size_t len = qn_rand(&rnd) % 120;
+		const size_t off = qn_rand(&rnd) % 100;
+		char* p = edge - off;
+		char* q = edge - 4096 + 64 - qn_rand(&rnd) % 128;
+		rand_text(&rnd, p, len);
+		p[len] = '\0';
+		memcpy(q, p, len + 1);
+		ref_upr(q, len);
+		if (len && qn_rand(&rnd) % 2)
+			q[qn_rand(&rnd) % len] = 'Q';
+		CHECK(qn_stricmp(p, q) == ref_icmp(p, q, len + 1), "page stricmp");
+		CHECK(qn_stricmp(q, p) == ref_icmp(q, p, len + 1), "page stricmp");
+		const size_t cl = qn_rand(&rnd) % (len + 2);
+		CHECK(qn_strnicmp(p, q, cl) == ref_icmp(p, q, cl), "page strnicmp");
+		CHECK(qn_strchr(p, '#') == ref_chr(p, len, '#'), "page strchr");
+		CHECK(qn_strbrk(p, "=;") == ref_brk(p, len, "=;"), "page strbrk");
+		CHECK(qn_strbrk(p, "=;[]#\r\nxyzQ") == ref_brk(p, len, "=;[]#\r\nxyzQ"), "page strbrk");
+	}
+
+	qn_free(mem);
+	qn_outputf("page: %s", fails == 0 ? "ok" : "FAIL");
+	return fails == 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 속도
+
+// 설정 파일 같은 글
+static char* make_corpus(QnRandom* rnd, size_t* size)
+{
+	static const char* lines[] =
+	{
+		"[section]\n", "name = some value\n", "# comment line with words\n", "path = data/textures/stone_01.png\n",
+		"  indent = 4   \n", "width=1280;height=720\n", "Title = The Quick Brown Fox\n", "\n",
+	};
+	char* buf = qn_alloc(CORPUS_SIZE + 128, char);
+	size_t n = 0;
+	while (n < CORPUS_SIZE)
+	{
+		const char* w = lines[qn_rand(rnd) % QN_COUNTOF(lines)];
+		const size_t l = strlen(w);
+		memcpy(buf + n, w, l);
+		n += l;
+	}
+	buf[n] = '\0';
+	*size = n;
+	return buf;
+}
+
+// 구분자마다 끊어 세기
+static size_t count_qn(const char* p, size_t len, const char* set)
+{
+	size_t count = 0;
+	for (const char* e = p + len;; p++, count++)
+	{
+		p = qn_strnbrk(p, (size_t)(e - p), set);
+		if (p == NULL)
+			return count;
+	}
+}
+
+static size_t count_crt(const char* p, const char* set)
+{
+	size_t count = 0;
+	for (;; p++, count++)
+	{
+		p = strpbrk(p, set);
+		if (p == NULL)
+			return count;
+	}
+}
+
+static size_t count_ref(const char* p, size_t len, const char* set)
+{
+	size_t count = 0;
+	for (const char* e = p + len;; p++, count++)
+	{
+		p = ref_brk(p, (size_t)(e - p), set);
+		if (p == NULL)
+			return count;
+	}
+}
+
+#define BENCH(name, qn, crt, ref)\
+	do {\
+		double t0 = qn_elapsed();\
+		for (int i = 0; i < BENCH_LOOP; i++) sink += (size_t)(qn);\
+		double t1 = qn_elapsed();\
+		for (int i = 0; i < BENCH_LOOP; i++) sink += (size_t)(crt);\
+		double t2 = qn_elapsed();\
+		for (int i = 0; i < BENCH_LOOP; i++) sink += (size_t)(ref);\
+		double t3 = qn_elapsed();\
+		qn_outputf("%-12s %10.3f %10.3f %10.3f %10.0f", name, (t1 - t0) * 1000.0, (t2 - t1) * 1000.0, (t3 - t2) * 1000.0, mb / (t1 - t0));\
+	} while (0)
+
+static void bench(void)
+{
+	QnRandom rnd;
+	qn_srand(&rnd, 5678);
+	size_t size;
+	char* text = make_corpus(&rnd, &size);
+	char* copy = qn_alloc(CORPUS_SIZE + 128, char);
+	memcpy(copy, text, size + 1);
+	qn_strupr(copy);
+	const double mb = (double)size * BENCH_LOOP / (1024.0 * 1024.0);
+	volatile size_t sink = 0;
+
+	qn_outputf("%-12s %10s %10s %10s %10s", "test", "qn (ms)", "crt (ms)", "ref (ms)", "qn MB/s");
+	BENCH("strchr", qn_strchr(text, '@'), strchr(text, '@'), ref_chr(text, size, '@'));
+	BENCH("strrchr", qn_strrchr(text, '@'), strrchr(text, '@'), ref_rchr(text, size, '@'));
+	BENCH("strnstr", qn_strnstr(text, size, "stone_02", 8), strstr(text, "stone_02"), ref_str(text, size, "stone_02", 8));
+	BENCH("strbrk", count_qn(text, size, "=#;["), count_crt(text, "=#;["), count_ref(text, size, "=#;["));
+	BENCH("stricmp", qn_stricmp(text, copy), crt_stricmp(text, copy), ref_icmp(text, copy, size + 1));
+	BENCH("strupr", qn_strupr(copy), crt_upr(copy), (ref_upr(copy, size), copy));
+
+	qn_free(copy);
+	qn_free(text);
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+
+	bool ok = check();
+	ok = check_page() && ok;
+	bench();
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
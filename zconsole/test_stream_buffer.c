@@ -0,0 +1,170 @@
+﻿// 버퍼 스트림 벤치마크, 작은 레코드 읽고 쓰기를 그냥 파일 스트림과 비교
+#include <qs.h>
+
+#define RECORD_COUNT	(256 * 1024)
+#define LINE_COUNT		(128 * 1024)
+
+typedef struct RECORD
+{
+	uint			id;
+	uint			crc;
+	float			x, y;
+} Record;
+
+static QnStream* open_file(const char* mode, bool buffered)
+{
+	QnStream* file = qn_open_stream(NULL, "test_stream_buffer.bin", mode);
+	if (file == NULL || buffered == false)
+		return file;
+	QnStream* stream = qn_create_buffered_stream(file, 0);
+	qn_unload(file);
+	return stream;
+}
+
+// 레코드 쓰고 읽기
+static bool bench_record(bool buffered, double* write_time, double* read_time)
+{
+	double start = qn_elapsed();
+	QnStream* stream = open_file("wb", buffered);
+	if (stream == NULL)
+		return false;
+	for (uint i = 0; i < RECORD_COUNT; i++)
+	{
+		const Record r = { i, i * 2654435761U, (float)i, (float)i * 0.5f };
+		qn_stream_write(stream, &r, 0, (int)sizeof(Record));
+	}
+	qn_unload(stream);
+	*write_time = qn_elapsed() - start;
+
+	bool ok = true;
+	start = qn_elapsed();
+	stream = open_file("rb", buffered);
+	if (stream == NULL)
+		return false;
+	for (uint i = 0; i < RECORD_COUNT; i++)
+	{
+		Record r;
+		if (qn_stream_read(stream, &r, 0, (int)sizeof(Record)) != (int)sizeof(Record) || r.id != i || r.crc != i * 2654435761U)
+		{
+			ok = false;
+			break;
+		}
+	}
+	qn_unload(stream);
+	*read_time = qn_elapsed() - start;
+	return ok;
+}
+
+// 글자 줄 쓰고 읽기
+static bool bench_line(bool buffered, double* write_time, double* read_time)
+{
+	double start = qn_elapsed();
+	QnStream* stream = open_file("wb", buffered);
+	if (stream == NULL)
+		return false;
+	for (int i = 0; i < LINE_COUNT; i++)
+		qn_stream_printf(stream, i % 3 == 0 ? "line %d, value %d\r\n" : "line %d, value %d\n", i, i * 7);
+	qn_unload(stream);
+	*write_time = qn_elapsed() - start;
+
+	bool ok = true;
+	start = qn_elapsed();
+	stream = open_file("rb", buffered);
+	if (stream == NULL)
+		return false;
+	char line[64], expect[64];
+	for (int i = 0; i < LINE_COUNT; i++)
+	{
+		const int len = qn_stream_read_line(stream, line, (int)sizeof(line));
+		qn_snprintf(expect, sizeof(expect), "line %d, value %d", i, i * 7);
+		if (len < 0 || strcmp(line, expect) != 0)
+		{
+			ok = false;
+			break;
+		}
+	}
+	ok = qn_stream_read_line(stream, line, (int)sizeof(line)) == -1 && ok;
+	qn_unload(stream);
+	*read_time = qn_elapsed() - start;
+	return ok;
+}
+
+// 들여다보기, 버퍼 안에서 찾기, 읽다가 쓰기
+static bool check_misc(void)
+{
+	QnStream* mem = qn_create_mem_stream("mem", 0);
+	for (int i = 0; i < 1000; i++)
+		qn_stream_printf(mem, "%04d", i);
+	qn_stream_seek(mem, 0, QNSEEK_BEGIN);
+
+	QnStream* stream = qn_create_buffered_stream(mem, 100);
+	char buf[16] = { 0 };
+	bool ok = qn_stream_peek(stream, buf, 8) == 8 && memcmp(buf, "00000001", 8) == 0;
+	ok = qn_stream_read(stream, buf, 0, 4) == 4 && memcmp(buf, "0000", 4) == 0 && ok;
+	// 버퍼 안에서 뒤로, 버퍼 밖으로
+	ok = qn_stream_seek(stream, 2, QNSEEK_BEGIN) == 2 && qn_stream_read(stream, buf, 0, 4) == 4 && memcmp(buf, "0000", 4) == 0 && ok;
+	ok = qn_stream_seek(stream, 2000, QNSEEK_BEGIN) == 2000 && qn_stream_read(stream, buf, 0, 4) == 4 && memcmp(buf, "0500", 4) == 0 && ok;
+	ok = qn_stream_tell(stream) == 2004 && ok;
+	// 읽다가 덮어쓰고 다시 읽기
+	ok = qn_stream_write(stream, "abcd", 0, 4) == 4 && ok;
+	ok = qn_stream_seek(stream, -8, QNSEEK_CUR) == 2000 && qn_stream_read(stream, buf, 0, 12) == 12 &&
+		memcmp(buf, "0500abcd0502", 12) == 0 && ok;
+	// 구분자
+	qn_stream_seek(stream, 0, QNSEEK_BEGIN);
+	ok = qn_stream_read_until(stream, buf, 16, '2') == 12 && memcmp(buf, "000000010002", 12) == 0 && ok;
+	ok = qn_stream_seek(stream, 0, QNSEEK_END) == 4000 && qn_stream_size(stream) == 4000 && ok;
+	qn_unload(stream);
+	qn_unload(mem);
+
+	// 버퍼 없는 스트림에서도 된다
+	QnStream* view = qn_create_view_stream("view", "a\r\nbb\n\nccc", 10);
+	char line[8];
+	ok = qn_stream_peek(view, line, 1) == 1 && line[0] == 'a' && ok;
+	ok = qn_stream_read_line(view, line, 8) == 1 && strcmp(line, "a") == 0 && ok;
+	ok = qn_stream_read_line(view, line, 8) == 2 && strcmp(line, "bb") == 0 && ok;
+	ok = qn_stream_read_line(view, line, 8) == 0 && ok;
+	ok = qn_stream_read_line(view, line, 3) == 2 && strcmp(line, "cc") == 0 && ok;	// 긴 줄은 나눠서
+	ok = qn_stream_read_line(view, line, 8) == 1 && strcmp(line, "c") == 0 && ok;
+	ok = qn_stream_read_line(view, line, 8) == -1 && ok;
+	qn_unload(view);
+
+	qn_outputf("misc: %s", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+
+	bool ok = check_misc();
+	qn_outputf("%-10s %8s %12s %12s %10s", "test", "stream", "write (ms)", "read (ms)", "speedup");
+	double base_write = 0.0, base_read = 0.0;
+	for (int b = 0; b < 2; b++)
+	{
+		double w = 0.0, r = 0.0;
+		ok = bench_record(b != 0, &w, &r) && ok;
+		if (b == 0)
+		{
+			base_write = w;
+			base_read = r;
+		}
+		qn_outputf("%-10s %8s %12.3f %12.3f %5.1fx/%.1fx", "record", b ? "buffer" : "file", w * 1000.0, r * 1000.0,
+			base_write / w, base_read / r);
+	}
+	for (int b = 0; b < 2; b++)
+	{
+		double w = 0.0, r = 0.0;
+		ok = bench_line(b != 0, &w, &r) && ok;
+		if (b == 0)
+		{
+			base_write = w;
+			base_read = r;
+		}
+		qn_outputf("%-10s %8s %12.3f %12.3f %5.1fx/%.1fx", "line", b ? "buffer" : "file", w * 1000.0, r * 1000.0,
+			base_write / w, base_read / r);
+	}
+	qn_remove_file(NULL, "test_stream_buffer.bin");
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+﻿// 문자열 해시 벤치마크
+#include <qs.h>
+
+#define KEY_COUNT		4096
+#define HASH_ROUND		200
+
+// 예전 문자열 해시
+static size_t legacy_hash(const char* p, size_t len)
+{
+	size_t h = 0;
+	for (size_t i = 0; i < len; i++)
+		h = h * 31 + (size_t)p[i];
+	return h;
+}
+
+static size_t legacy_ihash(const char* p, size_t len)
+{
+	size_t h = 0;
+	for (size_t i = 0; i < len; i++)
+		h = h * 31 + (size_t)(p[i] >= 'A' && p[i] <= 'Z' ? p[i] | 0x20 : p[i]);
+	return h;
+}
+
+static size_t new_hash(const char* p, size_t len)
+{
+	return qn_strnhash(p, len);
+}
+
+static size_t new_ihash(const char* p, size_t len)
+{
+	return qn_strnihash(p, len);
+}
+
+static char* keys[KEY_COUNT];
+static size_t lens[KEY_COUNT];
+
+static void bench(const char* name, const char* what, size_t(*func)(const char*, size_t))
+{
+	size_t sum = 0, bytes = 0;
+	double start = qn_elapsed();
+	for (int r = 0; r < HASH_ROUND; r++)
+		for (int i = 0; i < KEY_COUNT; i++)
+		{
+			sum += func(keys[i], lens[i]);
+			bytes += lens[i];
+		}
+	double elapsed = qn_elapsed() - start;
+	qn_outputf("%-8s %-8s %.3f sec, %.2f Mhash/sec, %.2f MB/sec (%zx)", name, what, elapsed,
+		(double)KEY_COUNT * HASH_ROUND / elapsed / 1000000.0, (double)bytes / elapsed / (1024.0 * 1024.0), sum & 0xFF);
+}
+
+// 같은 해시 버킷에 얼마나 몰리나
+static void collide(const char* name, size_t(*func)(const char*, size_t))
+{
+	static int buckets[KEY_COUNT];
+	memset(buckets, 0, sizeof(buckets));
+	for (int i = 0; i < KEY_COUNT; i++)
+		buckets[func(keys[i], lens[i]) & (KEY_COUNT - 1)]++;
+	int worst = 0, empty = 0;
+	for (int i = 0; i < KEY_COUNT; i++)
+	{
+		if (buckets[i] > worst)
+			worst = buckets[i];
+		if (buckets[i] == 0)
+			empty++;
+	}
+	qn_outputf("%-8s worst bucket: %d, empty: %d", name, worst, empty);
+}
+
+static void make_keys(size_t length)
+{
+	for (int i = 0; i < KEY_COUNT; i++)
+	{
+		keys[i] = qn_alloc(length + 1, char);
+		for (size_t n = 0; n < length; n++)
+			keys[i][n] = (char)('A' + (i + n * 7) % 26);
+		keys[i][length] = '\0';
+		// 앞 부분만 다른 키
+		char prefix[16];
+		const int len = qn_snprintf(prefix, QN_COUNTOF(prefix), "k%d_", i);
+		memcpy(keys[i], prefix, QN_MIN((size_t)len, length));
+		lens[i] = length;
+	}
+}
+
+static void free_keys(void)
+{
+	for (int i = 0; i < KEY_COUNT; i++)
+		qn_free(keys[i]);
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+
+	static const size_t lengths[] = { 8, 16, 32, 128, 1024 };
+	for (size_t l = 0; l < QN_COUNTOF(lengths); l++)
+	{
+		char what[32];
+		qn_snprintf(what, QN_COUNTOF(what), "%zu", lengths[l]);
+		make_keys(lengths[l]);
+		bench("legacy", what, legacy_hash);
+		bench("hash64", what, new_hash);
+		bench("legacy_i", what, legacy_ihash);
+		bench("hash64_i", what, new_ihash);
+		if (l == 0)
+		{
+			collide("legacy", legacy_hash);
+			collide("hash64", new_hash);
+		}
+		free_keys();
+	}
+
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return 0;
+}
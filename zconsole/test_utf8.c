@@ -0,0 +1,528 @@
+﻿// UTF 검사와 변환 테스트, 한 글자씩 보는 스칼라 구현과 결과를 맞춰 보고 속도를 비교
+#include <qs.h>
+#include <stdio.h>
+
+#define FUZZ_COUNT		200000
+#define ROUND_COUNT		20000
+#define CORPUS_SIZE		(1024 * 1024)
+#define BENCH_LOOP		50
+
+//////////////////////////////////////////////////////////////////////////
+// 한 글자씩 보는 스칼라 기준
+
+// 글자 하나 읽기. 틀리면 0
+static size_t ref_decode(const byte* s, size_t len, size_t i, uchar4* out)
+{
+	const byte c = s[i];
+	size_t n;
+	uchar4 cp, min;
+	if (c < 0x80)
+	{
+		*out = c;
+		return 1;
+	}
+	if (c >= 0xC2 && c < 0xE0)
+		n = 2, cp = c & 0x1F, min = 0x80;
+	else if (c >= 0xE0 && c < 0xF0)
+		n = 3, cp = c & 0x0F, min = 0x800;
+	else if (c >= 0xF0 && c < 0xF5)
+		n = 4, cp = c & 0x07, min = 0x10000;
+	else
+		return 0;
+	if (i + n > len)
+		return 0;
+	for (size_t k = 1; k < n; k++)
+	{
+		if ((s[i + k] & 0xC0) != 0x80)
+			return 0;
+		cp = (cp << 6) | (s[i + k] & 0x3F);
+	}
+	if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000))
+		return 0;
+	*out = cp;
+	return n;
+}
+
+static size_t ref_valid(const byte* s, size_t len)
+{
+	uchar4 cp;
+	for (size_t i = 0, n; i < len; i += n)
+		if ((n = ref_decode(s, len, i, &cp)) == 0)
+			return i;
+	return len;
+}
+
+static size_t ref_u8to16(uchar2* dest, size_t destsize, const char* src, size_t len)
+{
+	const byte* s = (const byte*)src;
+	size_t need = 0, n;
+	uchar4 cp;
+	for (size_t i = 0; i < len; i += n)
+	{
+		if ((n = ref_decode(s, len, i, &cp)) == 0)
+			return 0;
+		need += cp >= 0x10000 ? 2 : 1;
+	}
+	if (dest == NULL)
+		return need;
+	size_t o = 0;
+	for (size_t i = 0; i < len; i += n)
+	{
+		n = ref_decode(s, len, i, &cp);
+		if (cp < 0x10000)
+		{
+			if (o + 1 > destsize - 1)
+				break;
+			dest[o++] = (uchar2)cp;
+		}
+		else
+		{
+			if (o + 2 > destsize - 1)
+				break;
+			dest[o++] = (uchar2)(0xD800 + ((cp - 0x10000) >> 10));
+			dest[o++] = (uchar2)(0xDC00 + ((cp - 0x10000) & 0x3FF));
+		}
+	}
+	dest[o] = 0;
+	return o;
+}
+
+static size_t ref_u8to32(uchar4* dest, size_t destsize, const char* src, size_t len)
+{
+	const byte* s = (const byte*)src;
+	size_t o = 0, n;
+	uchar4 cp;
+	for (size_t i = 0; i < len; i += n)
+	{
+		if ((n = ref_decode(s, len, i, &cp)) == 0)
+			return 0;
+		if (dest && o < destsize - 1)
+			dest[o] = cp;
+		o++;
+	}
+	if (dest)
+	{
+		o = QN_MIN(o, destsize - 1);
+		dest[o] = 0;
+	}
+	return o;
+}
+
+static size_t ref_u16to8(char* dest, size_t destsize, const uchar2* src, size_t len)
+{
+	size_t o = 0;
+	for (size_t i = 0; i < len; i++)
+	{
+		uchar4 cp = src[i];
+		if (cp >= 0xDC00 && cp < 0xE000)
+			return 0;
+		if (cp >= 0xD800 && cp < 0xDC00)
+		{
+			if (i + 1 >= len || src[i + 1] < 0xDC00 || src[i + 1] >= 0xE000)
+				return 0;
+			cp = 0x10000 + ((cp - 0xD800) << 10) + (src[i + 1] - 0xDC00);
+			i++;
+		}
+		char tmp[8];
+		const int n = qn_u32ucb(cp, tmp);
+		if (dest)
+		{
+			if (o + (size_t)n > destsize - 1)
+				break;
+			memcpy(dest + o, tmp, (size_t)n);
+		}
+		o += (size_t)n;
+	}
+	if (dest)
+		dest[o] = '\0';
+	return o;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 검사
+
+// 아무 글자 하나
+static uchar4 rand_code(QnRandom* rnd)
+{
+	switch (qn_rand(rnd) % 5)
+	{
+		case 0:
+			return 0x20 + qn_rand(rnd) % 0x5F;
+		case 1:
+			return 0x80 + qn_rand(rnd) % 0x780;
+		case 2:
+			return 0xAC00 + qn_rand(rnd) % 11172;
+		case 3:
+			return 0x10000 + qn_rand(rnd) % 0x100000;
+		default:
+		{
+			const uchar4 c = 1 + qn_rand(rnd) % 0x10FFFF;
+			return c >= 0xD800 && c < 0xE000 ? 0xFFFD : c;
+		}
+	}
+}
+
+// 올바른 글자들 사이에 가끔 잘못된 바이트를 섞는다
+static size_t rand_bytes(QnRandom* rnd, byte* buf, size_t max)
+{
+	static const byte bad[] = { 0x80, 0xBF, 0xC0, 0xC1, 0xC2, 0xE0, 0xED, 0xF0, 0xF4, 0xF5, 0xFF };
+	size_t n = 0;
+	const size_t want = qn_rand(rnd) % max;
+	while (n + 4 < want)
+	{
+		const nuint r = qn_rand(rnd) % 100;
+		if (r < 2)
+			buf[n++] = bad[qn_rand(rnd) % QN_COUNTOF(bad)];
+		else if (r < 3)
+			buf[n++] = (byte)qn_rand(rnd);
+		else
+			n += (size_t)qn_u32ucb(rand_code(rnd), (char*)buf + n);
+	}
+	return n;
+}
+
+static bool check_valid(void)
+{
+	static const struct { const char* text; size_t len; size_t offset; } cases[] =
+	{
+		{ "abc", 3, 3 },
+		{ "abc\x80", 4, 3 },
+		{ "\xC0\xAF", 2, 0 },					// 오버롱
+		{ "\xC1\xBF", 2, 0 },
+		{ "\xE0\x80\xAF", 3, 0 },
+		{ "\xE0\x9F\xBF", 3, 0 },
+		{ "\xF0\x8F\xBF\xBF", 4, 0 },
+		{ "\xED\xA0\x80", 3, 0 },				// 서로게이트
+		{ "\xED\xBF\xBF", 3, 0 },
+		{ "\xED\x9F\xBF", 3, 3 },
+		{ "\xF4\x8F\xBF\xBF", 4, 4 },			// U+10FFFF
+		{ "\xF4\x90\x80\x80", 4, 0 },
+		{ "\xF5\x80\x80\x80", 4, 0 },
+		{ "\xF8\x88\x80\x80\x80", 5, 0 },		// 예전 5바이트
+		{ "\xFE", 1, 0 },
+		{ "\xEA\xB0\x80\xEA\xB0", 5, 3 },		// 잘린 글자
+		{ "\xC3", 1, 0 },
+		{ "\xC3\x28", 2, 0 },
+		{ "a\x80\x80", 3, 1 },
+		{ "\xF0\x9F\x98\x80\x80", 5, 4 },		// 연속 바이트가 남음
+		{ "\xF0\x9F\x98\x80", 4, 4 },
+		{ "\xEA\xB0\x80\x00\xEA\xB0\x80", 7, 7 },	// 길이를 주면 널도 글자
+	};
+	byte buf[256];
+	int fails = 0;
+
+	// 여러 위치에 두어 벡터 블럭 경계에 걸치게 한다
+	for (size_t c = 0; c < QN_COUNTOF(cases); c++)
+	{
+		for (size_t pad = 0; pad < 80; pad++)
+		{
+			for (int korean = 0; korean < 2; korean++)
+			{
+				size_t n = 0;
+				if (korean)
+					for (; n + 3 <= pad; n += 3)
+						memcpy(buf + n, "\xED\x95\x9C", 3);
+				for (; n < pad; n++)
+					buf[n] = (byte)('a' + n % 26);
+				memcpy(buf + n, cases[c].text, cases[c].len);
+				n += cases[c].len;
+				const size_t tail = cases[c].offset == cases[c].len ? 40 : 0;
+				for (size_t k = 0; k < tail; k++)
+					buf[n++] = 'z';
+
+				size_t off = 0;
+				const bool ok = qn_u8valid((const char*)buf, n, &off);
+				const size_t expect = cases[c].offset == cases[c].len ? n : pad + cases[c].offset;
+				if (off != expect || ok != (expect == n))
+				{
+					if (fails++ < 10)
+						qn_outputf("  valid case %d pad %d: %d, expect %d", (int)c, (int)pad, (int)off, (int)expect);
+				}
+			}
+		}
+	}
+
+	// 기준 구현과 맞춰 본다
+	QnRandom rnd;
+	qn_srand(&rnd, 2345);
+	for (int i = 0; i < FUZZ_COUNT; i++)
+	{
+		const size_t n = rand_bytes(&rnd, buf, sizeof(buf));
+		if (n == 0)
+			continue;	// 길이 0은 널까지라는 뜻
+		size_t off = 0;
+		qn_u8valid((const char*)buf, n, &off);
+		const size_t expect = ref_valid(buf, n);
+		if (off != expect)
+		{
+			if (fails++ < 10)
+				qn_outputf("  valid fuzz %d: %d, expect %d (len %d)", i, (int)off, (int)expect, (int)n);
+		}
+		// 틀린 입력은 변환하지 않는다 (변환은 널에서 멈추므로 널이 없을 때만)
+		if (expect != n && memchr(buf, 0, n) == NULL)
+		{
+			uchar2 w[300];
+			if (qn_u8to16(w, QN_COUNTOF(w), (const char*)buf, n) != 0 || qn_u8to16(NULL, 0, (const char*)buf, n) != 0)
+			{
+				if (fails++ < 10)
+					qn_outputf("  invalid converted %d", i);
+			}
+		}
+	}
+
+	// UTF-16, UCS-4
+	static const uchar2 w1[] = { 'a', 0xD83D, 0xDE00, 'b', 0 };
+	static const uchar2 w2[] = { 'a', 0xDE00, 'b', 0 };
+	static const uchar2 w3[] = { 'a', 'b', 'c', 'd', 'e', 'f', 'g', 0xD83D, 'x', 0 };
+	static const uchar2 w4[] = { 'a', 0xD83D, 0 };
+	static const uchar4 u1[] = { 'a', 0x10FFFF, 0xD7FF, 0xE000, 0 };
+	static const uchar4 u2[] = { 'a', 0x110000, 0 };
+	static const uchar4 u3[] = { 'a', 'b', 0xDFFF, 0 };
+	size_t o1, o2, o3, o4, o5, o6, o7;
+	const bool b1 = qn_u16valid(w1, 0, &o1), b2 = qn_u16valid(w2, 0, &o2), b3 = qn_u16valid(w3, 0, &o3), b4 = qn_u16valid(w4, 0, &o4);
+	const bool b5 = qn_u32valid(u1, 0, &o5), b6 = qn_u32valid(u2, 0, &o6), b7 = qn_u32valid(u3, 0, &o7);
+	if (!b1 || o1 != 4 || b2 || o2 != 1 || b3 || o3 != 7 || b4 || o4 != 1 || !b5 || o5 != 4 || b6 || o6 != 1 || b7 || o7 != 2)
+	{
+		fails++;
+		qn_outputf("  utf16/ucs4 valid: %d %d %d %d %d %d %d", (int)o1, (int)o2, (int)o3, (int)o4, (int)o5, (int)o6, (int)o7);
+	}
+
+	qn_outputf("valid: %s", fails == 0 ? "ok" : "FAIL");
+	return fails == 0;
+}
+
+// 올바른 문자열을 이리저리 바꿔 보고 기준 구현과 같은지
+static bool check_convert(void)
+{
+	QnRandom rnd;
+	qn_srand(&rnd, 4567);
+	uchar4 u32[200], r32[200], b32[200];
+	char u8[900], r8[900], t8[900];
+	uchar2 u16[400], r16[400], b16[400];
+	int fails = 0;
+
+	for (int i = 0; i < ROUND_COUNT && fails < 10; i++)
+	{
+		// 가끔 ASCII만 길게 넣어 벡터 경로를 탄다
+		const size_t count = qn_rand(&rnd) % 199;
+		const bool ascii = qn_rand(&rnd) % 3 == 0;
+		for (size_t k = 0; k < count; k++)
+			u32[k] = ascii && qn_rand(&rnd) % 20 ? 0x20 + qn_rand(&rnd) % 0x5F : rand_code(&rnd);
+		u32[count] = 0;
+
+		const size_t n8 = qn_u32to8(NULL, 0, u32, 0);
+		const size_t w8 = qn_u32to8(u8, sizeof(u8), u32, 0);
+		size_t r8n = 0;
+		r8[0] = '\0';
+		for (size_t k = 0; k < count; k++)
+			r8n += (size_t)qn_u32ucb(u32[k], r8 + r8n);
+		if (n8 != r8n || w8 != r8n || memcmp(u8, r8, r8n + 1) != 0)
+		{
+			fails++;
+			qn_outputf("  u32to8 %d: %d %d, expect %d", i, (int)n8, (int)w8, (int)r8n);
+			continue;
+		}
+
+		const size_t n16 = qn_u8to16(NULL, 0, u8, 0);
+		const size_t w16 = qn_u8to16(u16, QN_COUNTOF(u16), u8, 0);
+		const size_t e16 = ref_u8to16(r16, QN_COUNTOF(r16), u8, r8n);
+		if (n16 != e16 || w16 != e16 || memcmp(u16, r16, (e16 + 1) * sizeof(uchar2)) != 0)
+		{
+			fails++;
+			qn_outputf("  u8to16 %d: %d %d, expect %d", i, (int)n16, (int)w16, (int)e16);
+			continue;
+		}
+
+		const size_t n32 = qn_u8to32(NULL, 0, u8, 0);
+		const size_t w32 = qn_u8to32(r32, QN_COUNTOF(r32), u8, 0);
+		if (n32 != count || w32 != count || memcmp(r32, u32, (count + 1) * sizeof(uchar4)) != 0)
+		{
+			fails++;
+			qn_outputf("  u8to32 %d: %d %d, expect %d", i, (int)n32, (int)w32, (int)count);
+			continue;
+		}
+
+		const size_t m8 = qn_u16to8(NULL, 0, u16, 0);
+		const size_t x8 = qn_u16to8(r8, sizeof(r8), u16, 0);
+		if (m8 != r8n || x8 != r8n || memcmp(u8, r8, r8n + 1) != 0)
+		{
+			fails++;
+			qn_outputf("  u16to8 %d: %d %d, expect %d", i, (int)m8, (int)x8, (int)r8n);
+			continue;
+		}
+
+		const size_t m32 = qn_u16to32(NULL, 0, u16, 0);
+		const size_t x32 = qn_u16to32(b32, QN_COUNTOF(b32), u16, 0);
+		const size_t m16 = qn_u32to16(NULL, 0, u32, 0);
+		const size_t x16 = qn_u32to16(b16, QN_COUNTOF(b16), u32, 0);
+		if (m32 != count || x32 != count || memcmp(b32, u32, (count + 1) * sizeof(uchar4)) != 0 ||
+			m16 != e16 || x16 != e16 || memcmp(b16, u16, (e16 + 1) * sizeof(uchar2)) != 0)
+		{
+			fails++;
+			qn_outputf("  u16to32/u32to16 %d: %d %d %d %d", i, (int)m32, (int)x32, (int)m16, (int)x16);
+			continue;
+		}
+
+		// 버퍼가 모자라면 글자 경계에서 자르고, 기준 구현과 같은 곳에서 끝난다
+		const size_t cut = 1 + qn_rand(&rnd) % (r8n + 2);
+		const size_t c16 = qn_u8to16(u16, cut, u8, 0);
+		const size_t e16c = ref_u8to16(r16, cut, u8, r8n);
+		const size_t c8 = qn_u16to8(r8, cut, b16, 0);
+		const size_t e8c = ref_u16to8(t8, cut, b16, e16);
+		const size_t c32 = qn_u8to32(b32, QN_MIN(cut, QN_COUNTOF(b32)), u8, 0);
+		const size_t e32c = ref_u8to32(r32, QN_MIN(cut, QN_COUNTOF(r32)), u8, r8n);
+		if (c16 != e16c || memcmp(u16, r16, (c16 + 1) * sizeof(uchar2)) != 0 ||
+			c8 != e8c || memcmp(r8, t8, c8 + 1) != 0 ||
+			c32 != e32c || memcmp(b32, r32, (c32 + 1) * sizeof(uchar4)) != 0)
+		{
+			fails++;
+			qn_outputf("  truncate %d (%d): %d/%d %d/%d %d/%d", i, (int)cut, (int)c16, (int)e16c, (int)c8, (int)e8c, (int)c32, (int)e32c);
+		}
+	}
+
+	// UTF-8 원본 길이는 바이트, 그 안에 널이 있으면 거기까지
+	uchar4 w[8];
+	if (qn_u8to32(w, QN_COUNTOF(w), "\xEA\xB0\x80\xEB\x82\x98", 3) != 1 || w[0] != 0xAC00 || w[1] != 0 ||
+		qn_u8to32(NULL, 0, "ab\0cd", 5) != 2 || qn_u8to32(NULL, 0, "\xEA\xB0\x80\xEB\x82", 5) != 0)
+	{
+		fails++;
+		qn_outputf("  srclen bytes");
+	}
+
+	// 틀린 입력은 0, 할당 버전은 널
+	static const uchar2 lone[] = { 'a', 0xDC00, 0 };
+	static const uchar4 large[] = { 'a', 0x110000, 0 };
+	char* dup = qn_u16to8_dup(lone, 0);
+	uchar2* dup16 = qn_u8to16_dup("a\xC0\xAF", 0);
+	if (dup != NULL || dup16 != NULL || qn_u32to8(NULL, 0, large, 0) != 0 || qn_u32to16(NULL, 0, large, 0) != 0)
+	{
+		fails++;
+		qn_outputf("  invalid input converted");
+	}
+	qn_free(dup);
+	qn_free(dup16);
+
+	qn_outputf("convert: %s", fails == 0 ? "ok" : "FAIL");
+	return fails == 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 속도
+
+static const char* corpus_words[3][8] =
+{
+	{
+		"The quick brown fox jumps over the lazy dog. ", "Lorem ipsum dolor sit amet, consectetur adipiscing elit. ",
+		"int main(void) { return 0; }\n", "Hello, world! ", "path/to/some/file.txt ", "0123456789 ",
+		"Performance matters when text is converted constantly. ", "ASCII only line.\n",
+	},
+	{
+		"다람쥐 헌 쳇바퀴에 타고파. ", "키스의 고유조건은 입술끼리 만나야 하고 특별한 기술은 필요치 않다. ",
+		"동해 물과 백두산이 마르고 닳도록 ", "하느님이 보우하사 우리나라 만세.\n", "가나다라마바사아자차카타파하 ",
+		"한글 글꼴을 그리는 중입니다. ", "파일 경로를 바꿉니다 ", "안녕하세요 세계\n",
+	},
+	{
+		"파일: data/텍스처_01.png ", "Score 점수 = 1234 ", "HP ❤️ 100/100 ", "이모지 😀😁😂 emoji ",
+		"Привет, мир! ", "日本語のテキスト ", "café naïve résumé ", "문장 mixed with English words.\n",
+	},
+};
+
+static char* make_corpus(QnRandom* rnd, const char* const* words, size_t* size)
+{
+	char* buf = qn_alloc(CORPUS_SIZE + 128, char);
+	size_t n = 0;
+	while (n < CORPUS_SIZE)
+	{
+		const char* w = words[qn_rand(rnd) % 8];
+		const size_t l = strlen(w);
+		memcpy(buf + n, w, l);
+		n += l;
+	}
+	buf[n] = '\0';
+	*size = n;
+	return buf;
+}
+
+static void bench(void)
+{
+	static const char* names[3] = { "ascii", "korean", "mixed" };
+	QnRandom rnd;
+	qn_srand(&rnd, 5678);
+	uchar2* w16 = qn_alloc(CORPUS_SIZE + 128, uchar2);
+	uchar4* w32 = qn_alloc(CORPUS_SIZE + 128, uchar4);
+	char* w8 = qn_alloc(CORPUS_SIZE + 128, char);
+	volatile size_t sink = 0;
+
+	qn_outputf("%-18s %12s %12s %10s %10s", "test", "qn (ms)", "scalar (ms)", "speedup", "qn MB/s");
+	for (int c = 0; c < 3; c++)
+	{
+		size_t size;
+		char* text = make_corpus(&rnd, corpus_words[c], &size);
+		const size_t n16 = qn_u8to16(w16, CORPUS_SIZE + 128, text, size);
+		const double mb = (double)size * BENCH_LOOP / (1024.0 * 1024.0);
+		double start, mine, ref;
+		char name[64];
+
+		start = qn_elapsed();
+		for (int i = 0; i < BENCH_LOOP; i++)
+			sink += qn_u8valid(text, size, NULL);
+		mine = qn_elapsed() - start;
+		start = qn_elapsed();
+		for (int i = 0; i < BENCH_LOOP; i++)
+			sink += ref_valid((const byte*)text, size);
+		ref = qn_elapsed() - start;
+		qn_snprintf(name, sizeof(name), "valid %s", names[c]);
+		qn_outputf("%-18s %12.3f %12.3f %9.1fx %10.0f", name, mine * 1000.0, ref * 1000.0, ref / mine, mb / mine);
+
+		start = qn_elapsed();
+		for (int i = 0; i < BENCH_LOOP; i++)
+			sink += qn_u8to16(w16, CORPUS_SIZE + 128, text, size);
+		mine = qn_elapsed() - start;
+		start = qn_elapsed();
+		for (int i = 0; i < BENCH_LOOP; i++)
+			sink += ref_u8to16(w16, CORPUS_SIZE + 128, text, size);
+		ref = qn_elapsed() - start;
+		qn_snprintf(name, sizeof(name), "u8to16 %s", names[c]);
+		qn_outputf("%-18s %12.3f %12.3f %9.1fx %10.0f", name, mine * 1000.0, ref * 1000.0, ref / mine, mb / mine);
+
+		start = qn_elapsed();
+		for (int i = 0; i < BENCH_LOOP; i++)
+			sink += qn_u8to32(w32, CORPUS_SIZE + 128, text, size);
+		mine = qn_elapsed() - start;
+		start = qn_elapsed();
+		for (int i = 0; i < BENCH_LOOP; i++)
+			sink += ref_u8to32(w32, CORPUS_SIZE + 128, text, size);
+		ref = qn_elapsed() - start;
+		qn_snprintf(name, sizeof(name), "u8to32 %s", names[c]);
+		qn_outputf("%-18s %12.3f %12.3f %9.1fx %10.0f", name, mine * 1000.0, ref * 1000.0, ref / mine, mb / mine);
+
+		start = qn_elapsed();
+		for (int i = 0; i < BENCH_LOOP; i++)
+			sink += qn_u16to8(w8, CORPUS_SIZE + 128, w16, n16);
+		mine = qn_elapsed() - start;
+		start = qn_elapsed();
+		for (int i = 0; i < BENCH_LOOP; i++)
+			sink += ref_u16to8(w8, CORPUS_SIZE + 128, w16, n16);
+		ref = qn_elapsed() - start;
+		qn_snprintf(name, sizeof(name), "u16to8 %s", names[c]);
+		qn_outputf("%-18s %12.3f %12.3f %9.1fx %10.0f", name, mine * 1000.0, ref * 1000.0, ref / mine, mb / mine);
+
+		qn_free(text);
+	}
+
+	qn_free(w8);
+	qn_free(w32);
+	qn_free(w16);
+}
+
+int main(void)
+{
+	qn_runtime(NULL);
+
+	bool ok = check_valid();
+	ok = check_convert() && ok;
+	bench();
+	qn_outputf("result: %s", ok ? "ok" : "FAIL");
+	qn_outputf("left allocation: %d", (int)qn_mpf_count());
+	return ok ? 0 : 1;
+}